@@ -278,6 +278,9 @@ public:
   virtual int  cell_cfg(const std::vector<sched_interface::cell_cfg_t>& cell_cfg) = 0;
   virtual void reset()                                                            = 0;
 
+  /* Updates the length of a SI message after the RRC has replaced its content */
+  virtual int set_sib_len(uint32_t enb_cc_idx, uint32_t sib_idx, uint32_t len) = 0;
+
   /* Manages UE configuration context */
   virtual int ue_cfg(uint16_t rnti, sched_interface::ue_cfg_t* cfg) = 0;
   virtual int ue_rem(uint16_t rnti)                                 = 0;
@@ -405,7 +408,7 @@ public:
   virtual bool is_paging_opportunity(uint32_t tti, uint32_t* payload_len)            = 0;
 
   ///< Provide packed SIB to MAC (buffer is managed by RRC)
-  virtual uint8_t* read_pdu_bcch_dlsch(const uint8_t enb_cc_idx, const uint32_t sib_index) = 0;
+  virtual uint8_t* read_pdu_bcch_dlsch(const uint8_t enb_cc_idx, const uint32_t sib_index, const uint32_t tti) = 0;
 };
 
 // RRC interface for PDCP
@@ -427,6 +430,27 @@ public:
   virtual bool release_erabs(uint32_t rnti)                                                      = 0;
   virtual void add_paging_id(uint32_t ueid, const asn1::s1ap::ue_paging_id_c& ue_paging_id)      = 0;
 
+  /**
+   * Starts or replaces the broadcast of a public warning message (ETWS or CMAS) in all the cells of the eNB.
+   *
+   * @param msg S1AP WriteReplaceWarningRequest
+   * @param cell_ids cell identities (8 LSBs of the ECGI) of the cells broadcasting the warning message
+   * @return true if the warning SIBs are being broadcast
+   */
+  virtual bool write_replace_warning(const asn1::s1ap::write_replace_warning_request_s& msg,
+                                     std::vector<uint32_t>*                              cell_ids) = 0;
+
+  /**
+   * Stops the broadcast of a public warning message.
+   *
+   * @param msg_id messageIdentifier of the warning message
+   * @param serial_num serialNumber of the warning message
+   * @param kill_all if true, all the warning messages are stopped regardless of their identifiers
+   * @param cell_ids cell identities (8 LSBs of the ECGI) of the cells where the broadcast was stopped
+   * @return true if a warning message was being broadcast
+   */
+  virtual bool kill_warning(uint16_t msg_id, uint16_t serial_num, bool kill_all, std::vector<uint32_t>* cell_ids) = 0;
+
   /**
    * Reports the reception of S1 HandoverCommand / HandoverPreparationFailure or abnormal conditions during
    * S1 Handover preparation back to RRC.
@@ -532,6 +556,7 @@ typedef struct {
   uint32_t                      nof_prb; ///< Needed to dimension MAC softbuffers for all cells
   sched_interface::sched_args_t sched;
   int                           link_failure_nof_err;
+  uint32_t                      rx_softbuffer_pool_size; ///< Max Rx code block buffers shared by all UEs (0 disables it)
 } mac_args_t;
 
 class stack_interface_s1ap_lte
@@ -473,6 +473,7 @@ typedef struct {
   uint32_t pdsch_max_its   = 8;
   bool     meas_evm        = false;
   int      nof_phy_threads = 3;
+  uint32_t nof_cb_workers  = 0;
 
   int worker_cpu_mask   = -1;
   int sync_cpu_affinity = -1;
@@ -510,6 +511,7 @@ typedef struct {
   uint32_t    intra_freq_meas_len_ms       = 20;
   uint32_t    intra_freq_meas_period_ms    = 200;
   float       force_ul_amplitude           = 0.0f;
+  std::string simd_isa                     = "auto";
 
   float    in_sync_rsrp_dbm_th    = -130.0f;
   float    in_sync_snr_db_th      = 1.0f;
@@ -616,6 +618,17 @@ class gw_interface_stack : public gw_interface_nas, public gw_interface_rrc, pub
 {
 };
 
+// Public warning message acquired by the RRC from SIB10, SIB11 or SIB12
+struct rrc_warning_msg_t {
+  enum class type_t { etws_primary, etws_secondary, cmas } type;
+  uint16_t             msg_id;
+  uint16_t             serial_num;
+  uint16_t             warning_type;       ///< ETWS primary notification only
+  uint8_t              data_coding_scheme; ///< ETWS secondary and CMAS notifications only
+  std::vector<uint8_t> contents;           ///< Empty for the ETWS primary notification
+  int32_t              latency_ms;         ///< Time since the paging indication, or -1 if there was none
+};
+
 // STACK interface for RRC
 class stack_interface_rrc : public srslte::task_handler_interface
 {
@@ -623,6 +636,7 @@ public:
   virtual void              start_cell_search()                                              = 0;
   virtual void              start_cell_select(const phy_interface_rrc_lte::phy_cell_t* cell) = 0;
   virtual srslte::tti_point get_current_tti()                                                = 0;
+  virtual void              warning_msg_received(const rrc_warning_msg_t& msg)               = 0;
 };
 
 // Combined interface for PHY to access stack (MAC and RRC)
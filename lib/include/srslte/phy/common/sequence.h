@@ -44,6 +44,21 @@ typedef struct SRSLTE_API {
   uint32_t max_len;
 } srslte_sequence_t;
 
+/* Cache of packed sequences, indexed by their seed. The seed of the PDSCH and PUSCH sequences identifies the RNTI,
+ * codeword, slot and cell, so a single cache serves all users */
+typedef struct SRSLTE_API {
+  srslte_sequence_t seq;
+  uint32_t          seed;
+  uint64_t          last_used;
+  bool              valid;
+} srslte_sequence_cache_entry_t;
+
+typedef struct SRSLTE_API {
+  srslte_sequence_cache_entry_t* entries;
+  uint32_t                       nof_entries;
+  uint64_t                       count;
+} srslte_sequence_cache_t;
+
 SRSLTE_API int srslte_sequence_init(srslte_sequence_t* q, uint32_t len);
 
 SRSLTE_API void srslte_sequence_free(srslte_sequence_t* q);
@@ -52,12 +67,22 @@ SRSLTE_API int srslte_sequence_LTE_pr(srslte_sequence_t* q, uint32_t len, uint32
 
 SRSLTE_API int srslte_sequence_set_LTE_pr(srslte_sequence_t* q, uint32_t len, uint32_t seed);
 
+/* Generates only the packed sequence (c_bytes), 64 bits at a time */
+SRSLTE_API int srslte_sequence_LTE_pr_packed(srslte_sequence_t* q, uint32_t len, uint32_t seed);
+
+SRSLTE_API int srslte_sequence_cache_init(srslte_sequence_cache_t* q, uint32_t nof_entries);
+
+SRSLTE_API void srslte_sequence_cache_free(srslte_sequence_cache_t* q);
+
+/* Returns the packed sequence of a seed with at least len bits, generating it if it is not in the cache. The entries are
+ * replaced in least recently used order, so the sequence stays valid across the next call. Not thread-safe */
+SRSLTE_API srslte_sequence_t* srslte_sequence_cache_get(srslte_sequence_cache_t* q, uint32_t seed, uint32_t len);
+
 SRSLTE_API void srslte_sequence_apply_f(const float* in, float* out, uint32_t length, uint32_t seed);
 
 SRSLTE_API void srslte_sequence_apply_s(const int16_t* in, int16_t* out, uint32_t length, uint32_t seed);
 
 SRSLTE_API void srslte_sequence_apply_c(const int8_t* in, int8_t* out, uint32_t length, uint32_t seed);
-
 SRSLTE_API int srslte_sequence_pbch(srslte_sequence_t* seq, srslte_cp_t cp, uint32_t cell_id);
 
 SRSLTE_API int srslte_sequence_pcfich(srslte_sequence_t* seq, uint32_t nslot, uint32_t cell_id);
@@ -69,9 +94,13 @@ SRSLTE_API int srslte_sequence_pdcch(srslte_sequence_t* seq, uint32_t nslot, uin
 SRSLTE_API int
 srslte_sequence_pdsch(srslte_sequence_t* seq, uint16_t rnti, int q, uint32_t nslot, uint32_t cell_id, uint32_t len);
 
+SRSLTE_API uint32_t srslte_sequence_pdsch_seed(uint16_t rnti, int q, uint32_t nslot, uint32_t cell_id);
+
 SRSLTE_API int
 srslte_sequence_pusch(srslte_sequence_t* seq, uint16_t rnti, uint32_t nslot, uint32_t cell_id, uint32_t len);
 
+SRSLTE_API uint32_t srslte_sequence_pusch_seed(uint16_t rnti, uint32_t nslot, uint32_t cell_id);
+
 SRSLTE_API int srslte_sequence_pucch(srslte_sequence_t* seq, uint16_t rnti, uint32_t nslot, uint32_t cell_id);
 
 SRSLTE_API int srslte_sequence_pmch(srslte_sequence_t* seq, uint32_t nslot, uint32_t mbsfn_id, uint32_t len);
@@ -24,6 +24,7 @@
 
 #include "srslte/config.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 /**********************************************************************************************
  *  File:         dft.h
@@ -47,6 +48,8 @@ typedef enum { SRSLTE_DFT_COMPLEX, SRSLTE_REAL } srslte_dft_mode_t;
 
 typedef enum { SRSLTE_DFT_FORWARD, SRSLTE_DFT_BACKWARD } srslte_dft_dir_t;
 
+#define SRSLTE_DFT_MAX_HOW_MANY_RANK 3
+
 typedef struct SRSLTE_API {
   int               init_size; // DFT length used in the first initialization
   int               size;      // DFT length
@@ -78,6 +81,23 @@ SRSLTE_API int srslte_dft_plan_guru_c(srslte_dft_plan_t* plan,
                                       int                idist,
                                       int                odist);
 
+/**
+ * Creates a guru plan that runs several sets of DFTs in a single call. The sets are nested in how_many_rank
+ * dimensions, the i-th one has how_many[i] sets at a distance of idist[i] input and odist[i] output samples. The plan
+ * is not shared with other objects.
+ *
+ * @param how_many_rank Number of dimensions of the sets, up to SRSLTE_DFT_MAX_HOW_MANY_RANK
+ */
+SRSLTE_API int srslte_dft_plan_guru_batch_c(srslte_dft_plan_t* plan,
+                                            int                dft_points,
+                                            srslte_dft_dir_t   dir,
+                                            cf_t*              in_buffer,
+                                            cf_t*              out_buffer,
+                                            int                how_many_rank,
+                                            const int*         how_many,
+                                            const int*         idist,
+                                            const int*         odist);
+
 SRSLTE_API int srslte_dft_plan_r(srslte_dft_plan_t* plan, int dft_points, srslte_dft_dir_t dir);
 
 SRSLTE_API int srslte_dft_replan(srslte_dft_plan_t* plan, const int new_dft_points);
@@ -120,4 +140,14 @@ SRSLTE_API void srslte_dft_run_guru_c(srslte_dft_plan_t* plan);
 
 SRSLTE_API void srslte_dft_run_r(srslte_dft_plan_t* plan, const float* in, float* out);
 
+/* Plan sharing and wisdom. The plans of the same size, direction and data layout are shared by all the objects in the
+ * process. The wisdom is loaded at startup from the file given by the SRSLTE_FFTW_WISDOM environment variable, or
+ * $HOME/.srslte_fftwisdom by default, and saved to the last loaded file at exit. NULL selects the default file */
+
+SRSLTE_API uint32_t srslte_dft_nof_shared_plans();
+
+SRSLTE_API int srslte_dft_load_wisdom(const char* filename);
+
+SRSLTE_API int srslte_dft_save_wisdom(const char* filename);
+
 #endif // SRSLTE_DFT_H
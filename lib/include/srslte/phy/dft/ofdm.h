@@ -82,8 +82,27 @@ typedef struct SRSLTE_API {
   uint32_t          window_offset_n;
   cf_t*             shift_buffer;
   cf_t*             window_offset_buffer;
+  float             scale; // Gain applied to the resource elements in the same pass as the FFT shift
 } srslte_ofdm_t;
 
+#define SRSLTE_OFDM_GROUP_MAX_SIZE SRSLTE_MAX_CHANNELS
+
+/**
+ * @struct srslte_ofdm_group_t
+ * Group of OFDM objects with the same direction and configuration, such as the antenna ports of one or more carriers,
+ * which are modulated or demodulated together. When the time domain buffers of the objects are one block at a fixed
+ * stride, a single DFT plan transforms all the symbols of the subframe of all the objects. Otherwise, or in MBSFN,
+ * the objects are processed one after the other.
+ */
+typedef struct SRSLTE_API {
+  srslte_ofdm_t*    ofdm[SRSLTE_OFDM_GROUP_MAX_SIZE];
+  uint32_t          nof_ofdm;
+  srslte_dft_plan_t plan;       // DFT of all the symbols of all the objects, not planned if they can't share it
+  cf_t*             tmp;        // Frequency domain symbols of all the objects, with the guard subcarriers
+  uint32_t          tmp_len;    // Allocated length of tmp
+  uint32_t          tmp_stride; // Distance between the frequency domain symbols of two objects
+} srslte_ofdm_group_t;
+
 SRSLTE_API int srslte_ofdm_rx_init_cfg(srslte_ofdm_t* q, srslte_ofdm_cfg_t* cfg);
 
 SRSLTE_API int srslte_ofdm_tx_init_cfg(srslte_ofdm_t* q, srslte_ofdm_cfg_t* cfg);
@@ -118,6 +137,42 @@ SRSLTE_API int srslte_ofdm_set_freq_shift(srslte_ofdm_t* q, float freq_shift);
 
 SRSLTE_API void srslte_ofdm_set_normalize(srslte_ofdm_t* q, bool normalize_enable);
 
+/**
+ * Sets a gain for the modulated or demodulated signal. It is applied to the resource elements while they are copied
+ * to or from the DFT buffer, so it saves a pass over the time domain subframe. Default is 1.
+ *
+ * @param q OFDM object
+ * @param scale Linear gain
+ */
+SRSLTE_API void srslte_ofdm_set_scale(srslte_ofdm_t* q, float scale);
+
 SRSLTE_API void srslte_ofdm_set_non_mbsfn_region(srslte_ofdm_t* q, uint8_t non_mbsfn_region);
 
+/**
+ * Groups OFDM objects to process their subframes in a single call. It must be called again after resizing any of the
+ * objects, and the group must be initialised to all zeros before its first call.
+ *
+ * @param q OFDM group
+ * @param ofdm Array of pointers to the OFDM objects, all of them Tx or Rx
+ * @param nof_ofdm Number of OFDM objects
+ * @return SRSLTE_SUCCESS, or SRSLTE_ERROR if the objects can't be grouped
+ */
+SRSLTE_API int srslte_ofdm_group_init(srslte_ofdm_group_t* q, srslte_ofdm_t* const* ofdm, uint32_t nof_ofdm);
+
+SRSLTE_API void srslte_ofdm_group_free(srslte_ofdm_group_t* q);
+
+/**
+ * Modulates a subframe of all the OFDM objects of a group.
+ *
+ * @param q OFDM group of Tx objects
+ */
+SRSLTE_API void srslte_ofdm_tx_sf_batch(srslte_ofdm_group_t* q);
+
+/**
+ * Demodulates a subframe of all the OFDM objects of a group.
+ *
+ * @param q OFDM group of Rx objects
+ */
+SRSLTE_API void srslte_ofdm_rx_sf_batch(srslte_ofdm_group_t* q);
+
 #endif // SRSLTE_OFDM_H
@@ -66,8 +66,9 @@ typedef struct SRSLTE_API {
 
   cf_t* sf_symbols[SRSLTE_MAX_PORTS];
 
-  srslte_ofdm_t ifft[SRSLTE_MAX_PORTS];
-  srslte_ofdm_t ifft_mbsfn;
+  srslte_ofdm_t       ifft[SRSLTE_MAX_PORTS];
+  srslte_ofdm_t       ifft_mbsfn;
+  srslte_ofdm_group_t ifft_group;
 
   srslte_pbch_t   pbch;
   srslte_pcfich_t pcfich;
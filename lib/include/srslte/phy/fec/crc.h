@@ -33,10 +33,14 @@
 #define SRSLTE_CRC_H
 
 #include "srslte/config.h"
+#include <stdbool.h>
 #include <stdint.h>
 
 typedef struct SRSLTE_API {
   uint64_t table[256];
+  uint32_t slice_table[8][256]; // Slicing-by-8 tables, with the CRC aligned to the MSB of 32 bits
+  uint64_t fold_k[4];           // x^192, x^128, x^576 and x^512 modulo the polynomial, for carry-less multiply folding
+  bool     pclmul;              // Whether the carry-less multiply (PCLMULQDQ) kernel is used
   int      polynom;
   int      order;
   uint64_t crcinit;
@@ -69,8 +73,14 @@ static inline uint64_t srslte_crc_checksum_get(srslte_crc_t* h)
   return (h->crcinit & h->crcmask);
 }
 
+/* CRC of len bits packed in bytes, len must be a multiple of 8. It uses the carry-less multiply kernel if the CPU
+ * supports it and slicing-by-8 otherwise */
 SRSLTE_API uint32_t srslte_crc_checksum_byte(srslte_crc_t* h, uint8_t* data, int len);
 
+/* CRC of len unpacked bits (one bit per byte). The bits are packed in small chunks and fed to the byte CRC */
 SRSLTE_API uint32_t srslte_crc_checksum(srslte_crc_t* h, uint8_t* data, int len);
 
+/* Name of the CRC kernel in use */
+SRSLTE_API const char* srslte_crc_kernel_string(srslte_crc_t* h);
+
 #endif // SRSLTE_CRC_H
@@ -73,17 +73,30 @@ SRSLTE_API int srslte_rm_turbo_rx(float*   w_buff,
                                   uint32_t rv_idx,
                                   uint32_t nof_filler_bits);
 
-SRSLTE_API int
-srslte_rm_turbo_rx_lut(int16_t* input, int16_t* output, uint32_t in_len, uint32_t cb_idx, uint32_t rv_idx);
+/* Soft bits of the scratch buffer of the RX rate dematching. The dematching of a code block uses all of it, so each
+ * thread dematching code blocks needs its own */
+#define SRSLTE_RM_TURBO_RX_SCRATCH_LEN (3 * 6176 + 1 + 3 * (6176 + 1))
+
+SRSLTE_API int srslte_rm_turbo_rx_lut(int16_t* input,
+                                      int16_t* output,
+                                      uint32_t in_len,
+                                      uint32_t cb_idx,
+                                      uint32_t rv_idx,
+                                      int16_t* scratch);
 
 SRSLTE_API int srslte_rm_turbo_rx_lut_(int16_t* input,
                                        int16_t* output,
                                        uint32_t in_len,
                                        uint32_t cb_idx,
                                        uint32_t rv_idx,
-                                       bool     enable_input_tdec);
+                                       bool     enable_input_tdec,
+                                       int16_t* scratch);
 
-SRSLTE_API int
-srslte_rm_turbo_rx_lut_8bit(int8_t* input, int8_t* output, uint32_t in_len, uint32_t cb_idx, uint32_t rv_idx);
+SRSLTE_API int srslte_rm_turbo_rx_lut_8bit(int8_t*  input,
+                                           int8_t*  output,
+                                           uint32_t in_len,
+                                           uint32_t cb_idx,
+                                           uint32_t rv_idx,
+                                           int16_t* scratch);
 
 #endif // SRSLTE_RM_TURBO_H
@@ -33,13 +33,26 @@
 
 #include "srslte/config.h"
 #include "srslte/phy/common/phy_common.h"
+#include <pthread.h>
 
+/* Pool of code block slabs shared by many Rx softbuffers. A slab holds the saturated 8-bit soft bits and the decoded
+ * bits of one code block. Slabs are allocated the first time they are needed and never returned to the system until
+ * the pool is freed */
 typedef struct SRSLTE_API {
-  uint32_t  max_cb;
-  int16_t** buffer_f;
-  uint8_t** data;
-  bool*     cb_crc;
-  bool      tb_crc;
+  uint32_t        max_slabs;
+  uint32_t        nof_slabs; // Slabs allocated so far
+  uint32_t        nof_free;
+  uint8_t**       free_slabs;
+  pthread_mutex_t mutex;
+} srslte_softbuffer_pool_t;
+
+typedef struct SRSLTE_API {
+  uint32_t                  max_cb;
+  int16_t**                 buffer_f; // int8_t soft bits if the buffers come from a pool
+  uint8_t**                 data;
+  bool*                     cb_crc;
+  bool                      tb_crc;
+  srslte_softbuffer_pool_t* pool; // NULL if all the code block buffers are allocated at init
 } srslte_softbuffer_rx_t;
 
 typedef struct SRSLTE_API {
@@ -48,9 +61,21 @@ typedef struct SRSLTE_API {
 } srslte_softbuffer_tx_t;
 
 #define SOFTBUFFER_SIZE 18600
+#define SOFTBUFFER_SLAB_SIZE (SOFTBUFFER_SIZE + 6144 / 8)
+
+SRSLTE_API int srslte_softbuffer_pool_init(srslte_softbuffer_pool_t* pool, uint32_t max_slabs);
+
+SRSLTE_API void srslte_softbuffer_pool_free(srslte_softbuffer_pool_t* pool);
 
 SRSLTE_API int srslte_softbuffer_rx_init(srslte_softbuffer_rx_t* q, uint32_t nof_prb);
 
+SRSLTE_API int
+srslte_softbuffer_rx_init_pool(srslte_softbuffer_rx_t* q, uint32_t nof_prb, srslte_softbuffer_pool_t* pool);
+
+SRSLTE_API int srslte_softbuffer_rx_alloc_cb(srslte_softbuffer_rx_t* q, uint32_t cb_idx);
+
+SRSLTE_API void srslte_softbuffer_rx_release(srslte_softbuffer_rx_t* q);
+
 SRSLTE_API void srslte_softbuffer_rx_reset(srslte_softbuffer_rx_t* p);
 
 SRSLTE_API void srslte_softbuffer_rx_reset_tbs(srslte_softbuffer_rx_t* q, uint32_t tbs);
@@ -46,6 +46,9 @@
 // Expect the input to be aligned for sub-block window processing.
 #define SRSLTE_TDEC_EXPECT_INPUT_SB 1
 
+// Trellis steps used by the window decoders to estimate the initial state of each sub-block
+#define SRSLTE_TDEC_WIN_OVERLAP_LEN 40
+
 // Include interfaces for 8 and 16 bit decoder implementations
 #define LLR_IS_8BIT
 #include "srslte/phy/fec/turbodecoder_impl.h"
@@ -55,8 +58,11 @@
 #include "srslte/phy/fec/turbodecoder_impl.h"
 #undef LLR_IS_16BIT
 
-#define SRSLTE_TDEC_NOF_AUTO_MODES_8 2
-#define SRSLTE_TDEC_NOF_AUTO_MODES_16 3
+#define SRSLTE_TDEC_NOF_AUTO_MODES_8 3
+#define SRSLTE_TDEC_NOF_AUTO_MODES_16 4
+
+// Number of interleavers, one for each possible nof_subblocks (1, 8, 16, 32 or 64)
+#define SRSLTE_TDEC_NOF_INTERLEAVERS 5
 
 typedef enum { SRSLTE_TDEC_8, SRSLTE_TDEC_16 } srslte_tdec_llr_type_t;
 
@@ -90,8 +96,14 @@ typedef struct SRSLTE_API {
   uint32_t               current_long_cb;
   uint32_t               current_inter_idx;
   int                    current_cbidx;
-  srslte_tc_interl_t     interleaver[4][SRSLTE_NOF_TC_CB_SIZES];
+  srslte_tc_interl_t     interleaver[SRSLTE_TDEC_NOF_INTERLEAVERS][SRSLTE_NOF_TC_CB_SIZES];
   int                    n_iter;
+
+  // Hard decision of the previous half-iteration, fewest bits it has changed in a half-iteration and number of
+  // consecutive half-iterations that have not changed fewer bits
+  uint8_t* prev_output;
+  uint32_t min_changes;
+  uint32_t nof_stalled;
 } srslte_tdec_t;
 
 SRSLTE_API int srslte_tdec_init(srslte_tdec_t* h, uint32_t max_long_cb);
@@ -106,6 +118,8 @@ SRSLTE_API int srslte_tdec_new_cb(srslte_tdec_t* h, uint32_t long_cb);
 
 SRSLTE_API int srslte_tdec_get_nof_iterations(srslte_tdec_t* h);
 
+SRSLTE_API uint32_t srslte_tdec_update_stalled(srslte_tdec_t* h, uint8_t* output);
+
 SRSLTE_API uint32_t srslte_tdec_autoimp_get_subblocks(uint32_t long_cb);
 
 SRSLTE_API uint32_t srslte_tdec_autoimp_get_subblocks_8bit(uint32_t long_cb);
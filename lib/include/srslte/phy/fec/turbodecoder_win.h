@@ -51,7 +51,7 @@
 #define simd_rb_shift _mm_srai_epi16
 
 #define normalize_period 2
-#define win_overlap_len 40
+#define win_overlap_len SRSLTE_TDEC_WIN_OVERLAP_LEN
 
 #define INF 10000
 
@@ -146,7 +146,7 @@
                   0)
 
 #define normalize_period 2
-#define win_overlap_len 40
+#define win_overlap_len SRSLTE_TDEC_WIN_OVERLAP_LEN
 
 #define INF 10000
 #else
@@ -179,11 +179,13 @@
 
 #define normalize_max
 #define normalize_period 1
-#define win_overlap_len 40
+#define win_overlap_len SRSLTE_TDEC_WIN_OVERLAP_LEN
 #define use_saturated_add
 #define divide_output 1
 
-#define INF 0
+/* Metric of the states other than the known first and last ones. With 0 the decoder does not know them and the first
+ * bit of the code block fails at any SNR */
+#define INF 64
 
 inline static simd_type_t simd_rb_shift_128(simd_type_t v, const int l)
 {
@@ -284,11 +286,11 @@ inline static simd_type_t simd_rb_shift_128(simd_type_t v, const int l)
                   0)
 #define simd_rb_shift simd_rb_shift_256
 
-#define INF 0
+#define INF 64
 
 #define normalize_max
 #define normalize_period 1
-#define win_overlap_len 40
+#define win_overlap_len SRSLTE_TDEC_WIN_OVERLAP_LEN
 #define use_saturated_add
 #define divide_output 1
 
@@ -299,6 +301,118 @@ inline static simd_type_t simd_rb_shift_256(simd_type_t v, const int l)
   return _mm256_blendv_epi8(hi, low, _mm256_set1_epi32(0x00FF00FF));
 }
 
+#else
+#ifdef WINIMP_IS_AVX512_16
+
+#ifndef LV_HAVE_AVX512
+#error "Selected AVX512 window decoder but instruction set not supported"
+#endif
+
+#include <immintrin.h>
+
+#define WINIMP avx512_16
+#define nof_blocks 32
+
+#define llr_t int16_t
+
+/* The input and parity pointers are only 32-byte aligned, use unaligned loads and stores */
+#define simd_type_t __m512i
+#define simd_load _mm512_loadu_si512
+#define simd_store _mm512_storeu_si512
+#define simd_add _mm512_adds_epi16
+#define simd_sub _mm512_subs_epi16
+#define simd_max _mm512_max_epi16
+#define simd_set1 _mm512_set1_epi16
+#define simd_insert simd_insert_512_16
+#define simd_shuffle(v, move) move(v)
+#define move_right simd_move_right_512_16
+#define move_left simd_move_left_512_16
+#define simd_rb_shift _mm512_srai_epi16
+
+#define normalize_period 2
+#define win_overlap_len SRSLTE_TDEC_WIN_OVERLAP_LEN
+
+#define INF 10000
+
+inline static __m512i simd_insert_512_16(__m512i v, int16_t x, const int pos)
+{
+  return _mm512_mask_set1_epi16(v, (__mmask32)1 << pos, x);
+}
+
+/* Moves each sub-block state to the previous sub-block, across the 128-bit lanes. The last one is overwritten later */
+inline static __m512i simd_move_right_512_16(__m512i v)
+{
+  __m512i next = _mm512_shuffle_i64x2(v, v, _MM_SHUFFLE(3, 3, 2, 1));
+  return _mm512_alignr_epi8(next, v, 2);
+}
+
+/* Moves each sub-block state to the next sub-block, across the 128-bit lanes. The first one is overwritten later */
+inline static __m512i simd_move_left_512_16(__m512i v)
+{
+  __m512i prev = _mm512_shuffle_i64x2(v, v, _MM_SHUFFLE(2, 1, 0, 0));
+  return _mm512_alignr_epi8(v, prev, 14);
+}
+
+#else
+#ifdef WINIMP_IS_AVX512_8
+
+#ifndef LV_HAVE_AVX512
+#error "Selected AVX512 window decoder but instruction set not supported"
+#endif
+
+#include <immintrin.h>
+
+#define WINIMP avx512_8
+#define nof_blocks 64
+
+#define llr_t int8_t
+
+/* The input and parity pointers are only 32-byte aligned, use unaligned loads and stores */
+#define simd_type_t __m512i
+#define simd_load _mm512_loadu_si512
+#define simd_store _mm512_storeu_si512
+#define simd_add _mm512_adds_epi8
+#define simd_sub _mm512_subs_epi8
+#define simd_max _mm512_max_epi8
+#define simd_set1 _mm512_set1_epi8
+#define simd_insert simd_insert_512_8
+#define simd_shuffle(v, move) move(v)
+#define move_right simd_move_right_512_8
+#define move_left simd_move_left_512_8
+#define simd_rb_shift simd_rb_shift_512
+
+#define INF 64
+
+#define normalize_max
+#define normalize_period 1
+#define win_overlap_len SRSLTE_TDEC_WIN_OVERLAP_LEN
+#define use_saturated_add
+#define divide_output 1
+
+inline static __m512i simd_insert_512_8(__m512i v, int8_t x, const int pos)
+{
+  return _mm512_mask_set1_epi8(v, (__mmask64)1 << pos, x);
+}
+
+inline static __m512i simd_move_right_512_8(__m512i v)
+{
+  __m512i next = _mm512_shuffle_i64x2(v, v, _MM_SHUFFLE(3, 3, 2, 1));
+  return _mm512_alignr_epi8(next, v, 1);
+}
+
+inline static __m512i simd_move_left_512_8(__m512i v)
+{
+  __m512i prev = _mm512_shuffle_i64x2(v, v, _MM_SHUFFLE(2, 1, 0, 0));
+  return _mm512_alignr_epi8(v, prev, 15);
+}
+
+inline static simd_type_t simd_rb_shift_512(simd_type_t v, const int l)
+{
+  __m512i low = _mm512_srai_epi16(_mm512_slli_epi16(v, 8), l + 8);
+  __m512i hi  = _mm512_srai_epi16(v, l);
+  return _mm512_mask_blend_epi8(0x5555555555555555, hi, low);
+}
+
 #else
 #ifdef WINIMP_IS_NEON16
 #include <arm_neon.h>
@@ -395,7 +509,7 @@ inline static uint8x16_t v_load_s8(int i15,
 #define simd_rb_shift v_srai_s16
 
 #define normalize_period 2
-#define win_overlap_len 40
+#define win_overlap_len SRSLTE_TDEC_WIN_OVERLAP_LEN
 
 #define INF 10000
 
@@ -407,6 +521,8 @@ inline static uint8x16_t v_load_s8(int i15,
 #endif
 #endif
 #endif
+#endif
+#endif
 
 typedef struct SRSLTE_API {
   uint32_t max_long_cb;
@@ -908,6 +1024,21 @@ void MAKE_FUNC(
     INSERT8_INPUT(parity1, 24, 2);
 #endif
 
+#if nof_blocks >= 64
+    INSERT8_INPUT(syst, 32, 0);
+    INSERT8_INPUT(parity0, 32, 1);
+    INSERT8_INPUT(parity1, 32, 2);
+    INSERT8_INPUT(syst, 40, 0);
+    INSERT8_INPUT(parity0, 40, 1);
+    INSERT8_INPUT(parity1, 40, 2);
+    INSERT8_INPUT(syst, 48, 0);
+    INSERT8_INPUT(parity0, 48, 1);
+    INSERT8_INPUT(parity1, 48, 2);
+    INSERT8_INPUT(syst, 56, 0);
+    INSERT8_INPUT(parity0, 56, 1);
+    INSERT8_INPUT(parity1, 56, 2);
+#endif
+
     simd_store(systPtr++, syst);
     simd_store(parity0Ptr++, parity0);
     simd_store(parity1Ptr++, parity1);
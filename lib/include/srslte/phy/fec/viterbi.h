@@ -36,6 +36,10 @@
 
 typedef enum { SRSLTE_VITERBI_27 = 0, SRSLTE_VITERBI_29, SRSLTE_VITERBI_37, SRSLTE_VITERBI_39 } srslte_viterbi_type_t;
 
+/* Maximum number of frames decoded in one pass by srslte_viterbi_decode_batch_f(), e.g. all the PDCCH candidates of a
+ * DCI format in the UE-specific search space */
+#define SRSLTE_VITERBI_MAX_BATCH 16
+
 typedef struct SRSLTE_API {
   void*    ptr;
   uint32_t R;
@@ -52,6 +56,12 @@ typedef struct SRSLTE_API {
   uint16_t* tmp_s;
   uint8_t*  symbols_uc;
   uint16_t* symbols_us;
+  void*     batch_ptr;
+  uint16_t* batch_symbols;
+  int (*batch_init)(void*, int);
+  void (*batch_update)(void*, const uint16_t*, uint32_t, uint32_t*);
+  int (*batch_chainback)(void*, uint8_t**, uint32_t, uint32_t, const uint32_t*, uint32_t, uint32_t);
+  void (*batch_free)(void*);
 } srslte_viterbi_t;
 
 SRSLTE_API int srslte_viterbi_init(srslte_viterbi_t*     q,
@@ -60,6 +70,12 @@ SRSLTE_API int srslte_viterbi_init(srslte_viterbi_t*     q,
                                    uint32_t              max_frame_length,
                                    bool                  tail_bitting);
 
+SRSLTE_API int srslte_viterbi_init_batch(srslte_viterbi_t*     q,
+                                         srslte_viterbi_type_t type,
+                                         int                   poly[3],
+                                         uint32_t              max_frame_length,
+                                         bool                  tail_bitting);
+
 SRSLTE_API void srslte_viterbi_set_gain_quant(srslte_viterbi_t* q, float gain_quant);
 
 SRSLTE_API void srslte_viterbi_set_gain_quant_s(srslte_viterbi_t* q, int16_t gain_quant);
@@ -68,6 +84,12 @@ SRSLTE_API void srslte_viterbi_free(srslte_viterbi_t* q);
 
 SRSLTE_API int srslte_viterbi_decode_f(srslte_viterbi_t* q, float* symbols, uint8_t* data, uint32_t frame_length);
 
+SRSLTE_API int srslte_viterbi_decode_batch_f(srslte_viterbi_t* q,
+                                             float*            symbols[SRSLTE_VITERBI_MAX_BATCH],
+                                             uint8_t*          data[SRSLTE_VITERBI_MAX_BATCH],
+                                             uint32_t          nof_frames,
+                                             uint32_t          frame_length);
+
 SRSLTE_API int srslte_viterbi_decode_s(srslte_viterbi_t* q, int16_t* symbols, uint8_t* data, uint32_t frame_length);
 
 SRSLTE_API int srslte_viterbi_decode_us(srslte_viterbi_t* q, uint16_t* symbols, uint8_t* data, uint32_t frame_length);
@@ -92,4 +114,10 @@ SRSLTE_API int srslte_viterbi_init_avx2(srslte_viterbi_t*     q,
                                         uint32_t              max_frame_length,
                                         bool                  tail_bitting);
 
+SRSLTE_API int srslte_viterbi_init_avx512(srslte_viterbi_t*     q,
+                                          srslte_viterbi_type_t type,
+                                          int                   poly[3],
+                                          uint32_t              max_frame_length,
+                                          bool                  tail_bitting);
+
 #endif // SRSLTE_VITERBI_H
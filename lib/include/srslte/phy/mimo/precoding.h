@@ -123,4 +123,18 @@ SRSLTE_API int srslte_precoding_cn(cf_t*    h[SRSLTE_MAX_PORTS][SRSLTE_MAX_PORTS
                                    uint32_t nof_symbols,
                                    float*   cn);
 
+/* Number of codebooks of 4 antenna port Spatial Multiplexing, for any number of layers (36.211 Table 6.3.4.2.3-2) */
+#define SRSLTE_PRECODING_4P_NOF_CODEBOOKS 16
+
+/* Estimates the linear SINR of every layer after MMSE detection of spatial multiplexing with the given codebook, so
+ * the rank and CQI can be chosen from it. Only 4 antenna ports are supported */
+SRSLTE_API int srslte_precoding_multiplex_sinr(cf_t*    h[SRSLTE_MAX_PORTS][SRSLTE_MAX_PORTS],
+                                               uint32_t nof_rxant,
+                                               uint32_t nof_ports,
+                                               uint32_t nof_layers,
+                                               uint32_t codebook_idx,
+                                               uint32_t nof_symbols,
+                                               float    noise_estimate,
+                                               float    sinr[SRSLTE_MAX_LAYERS]);
+
 #endif // SRSLTE_PRECODING_H
@@ -47,6 +47,9 @@
 
 typedef enum SRSLTE_API { SEARCH_UE, SEARCH_COMMON } srslte_pdcch_search_mode_t;
 
+/* Maximum number of candidates decoded at once by srslte_pdcch_decode_msg_batch() */
+#define SRSLTE_PDCCH_MAX_BATCH SRSLTE_VITERBI_MAX_BATCH
+
 /* PDCCH object */
 typedef struct SRSLTE_API {
   srslte_cell_t cell;
@@ -65,6 +68,7 @@ typedef struct SRSLTE_API {
   cf_t*    d;
   uint8_t* e;
   float    rm_f[3 * (SRSLTE_DCI_MAX_BITS + 16)];
+  float*   rm_f_batch[SRSLTE_PDCCH_MAX_BATCH];
   float*   llr;
 
   /* tx & rx objects */
@@ -104,6 +108,13 @@ SRSLTE_API int srslte_pdcch_extract_llr(srslte_pdcch_t*        q,
 SRSLTE_API int
 srslte_pdcch_decode_msg(srslte_pdcch_t* q, srslte_dl_sf_cfg_t* sf, srslte_dci_cfg_t* dci_cfg, srslte_dci_msg_t* msg);
 
+/* Decoding functions: Try to decode nof_msg candidates of the same DCI format at once */
+SRSLTE_API int srslte_pdcch_decode_msg_batch(srslte_pdcch_t*     q,
+                                             srslte_dl_sf_cfg_t* sf,
+                                             srslte_dci_cfg_t*   dci_cfg,
+                                             srslte_dci_msg_t*   msg,
+                                             uint32_t            nof_msg);
+
 SRSLTE_API int
 srslte_pdcch_dci_decode(srslte_pdcch_t* q, float* e, uint8_t* data, uint32_t E, uint32_t nof_bits, uint16_t* crc);
 
@@ -44,11 +44,10 @@
 #include "srslte/phy/phch/sch.h"
 #include "srslte/phy/scrambling/scrambling.h"
 
-typedef struct {
-  srslte_sequence_t seq[SRSLTE_MAX_CODEWORDS][SRSLTE_NOF_SF_X_FRAME];
-  uint32_t          cell_id;
-  bool              sequence_generated;
-} srslte_pdsch_user_t;
+/* Number of scrambling sequences kept, each identifies an RNTI, codeword and subframe. The UE needs its C-RNTI and the
+ * common RNTIs, the eNodeB those of all the active users */
+#define SRSLTE_PDSCH_SEQ_CACHE_UE 64
+#define SRSLTE_PDSCH_SEQ_CACHE_ENB 1024
 
 /* PDSCH object */
 typedef struct SRSLTE_API {
@@ -78,10 +77,8 @@ typedef struct SRSLTE_API {
   // EVM buffers, one for each codeword (avoid concurrency issue with coworker)
   srslte_evm_buffer_t* evm_buffer[SRSLTE_MAX_CODEWORDS];
 
-  // This is to generate the scrambling seq for multiple CRNTIs
-  srslte_pdsch_user_t** users;
-
-  srslte_sequence_t tmp_seq;
+  // Scrambling sequences of all RNTIs, generated on their first use
+  srslte_sequence_cache_t seq_cache;
 
   srslte_sch_t dl_sch;
 
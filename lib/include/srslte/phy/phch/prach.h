@@ -40,6 +40,9 @@
 
 #define SRSLTE_PRACH_MAX_LEN (2 * 24576 + 21024) // Maximum Tcp + Tseq
 
+// Distance between the correlations of consecutive roots, 839 rounded up so that every row is 64-byte aligned
+#define SRSLTE_PRACH_CORR_STRIDE 848
+
 /** Generation and detection of RACH signals for uplink.
  *  Currently only supports preamble formats 0-3.
  *  Does not currently support high speed flag.
@@ -76,14 +79,14 @@ typedef struct SRSLTE_API {
   cf_t*  ifft_in;
   cf_t*  ifft_out;
   cf_t*  prach_bins;
-  cf_t*  corr_spec;
-  float* corr;
+  cf_t*  corr_spec; // Correlation spectra of all the root sequences, one row of SRSLTE_PRACH_CORR_STRIDE each
+  float* corr;      // Correlation power of all the root sequences, same layout
 
   // PRACH IFFT
   srslte_dft_plan_t fft;
   srslte_dft_plan_t ifft;
 
-  // ZC-sequence FFT and IFFT
+  // ZC-sequence FFT and batched IFFT of the correlation spectra of all the roots
   srslte_dft_plan_t zc_fft;
   srslte_dft_plan_t zc_ifft;
 
@@ -97,6 +100,12 @@ typedef struct SRSLTE_API {
   srslte_tdd_config_t tdd_config;
   uint32_t            current_prach_idx;
 
+  // Detection latency of the last srslte_prach_detect_offset() call, its average and maximum since set_cell
+  float    detect_latency_us;
+  float    detect_latency_avg_us;
+  float    detect_latency_max_us;
+  uint32_t nof_detect;
+
 } srslte_prach_t;
 
 typedef struct SRSLTE_API {
@@ -186,6 +195,8 @@ SRSLTE_API int srslte_prach_detect(srslte_prach_t* p,
                                    uint32_t*       indices,
                                    uint32_t*       ind_len);
 
+/* Correlates the received preamble with all the root sequences of the cell in a batch, which share the FFT of the
+ * signal and a single IFFT call, and updates the detection latency statistics */
 SRSLTE_API int srslte_prach_detect_offset(srslte_prach_t* p,
                                           uint32_t        freq_offset,
                                           cf_t*           signal,
@@ -45,11 +45,9 @@
 #include "srslte/phy/phch/sch.h"
 #include "srslte/phy/scrambling/scrambling.h"
 
-typedef struct {
-  srslte_sequence_t seq[SRSLTE_NOF_SF_X_FRAME];
-  uint32_t          cell_id;
-  bool              sequence_generated;
-} srslte_pusch_user_t;
+/* Number of scrambling sequences kept, each identifies an RNTI and subframe */
+#define SRSLTE_PUSCH_SEQ_CACHE_UE 16
+#define SRSLTE_PUSCH_SEQ_CACHE_ENB 512
 
 /* PUSCH object */
 typedef struct SRSLTE_API {
@@ -76,9 +74,8 @@ typedef struct SRSLTE_API {
   srslte_modem_table_t mod[SRSLTE_MOD_NITEMS];
   srslte_sch_t         ul_sch;
 
-  // This is to generate the scrambling seq for multiple CRNTIs
-  srslte_pusch_user_t** users;
-  srslte_sequence_t     tmp_seq;
+  // Scrambling sequences of all RNTIs, generated on their first use
+  srslte_sequence_cache_t seq_cache;
 
   // EVM buffer
   srslte_evm_buffer_t* evm_buffer;
@@ -54,6 +54,13 @@ typedef struct SRSLTE_API {
   uint32_t max_iterations;
   float    avg_iterations;
 
+  // Adaptive decoding: average half iterations per code block, 0 if disabled
+  uint32_t adaptive_iterations;
+
+  // Iterations left and code blocks not started yet since the budget was reset, usually once per subframe
+  uint32_t budget_iterations;
+  uint32_t budget_nof_cb;
+
   bool llr_is_8bit;
 
   /* buffers */
@@ -62,6 +69,7 @@ typedef struct SRSLTE_API {
   void*            e;
   uint8_t*         temp_g_bits;
   uint32_t*        ul_interleaver;
+  int16_t*         rm_scratch; // Scratch of the rate dematching, SRSLTE_RM_TURBO_RX_SCRATCH_LEN soft bits
   srslte_uci_bit_t ack_ri_bits[57600]; // 4*M_sc*Qm_max for RI and ACK
 
   srslte_tcod_t encoder;
@@ -71,6 +79,10 @@ typedef struct SRSLTE_API {
 
   srslte_uci_cqi_pusch_t uci_cqi;
 
+  // Decode the code blocks across the code block workers of the process, see srslte_sch_cb_workers_init()
+  bool     cb_workers;
+  uint8_t* cb_workers_data; // Code block decoded by the calling thread, including its CRC
+
 } srslte_sch_t;
 
 SRSLTE_API int srslte_sch_init(srslte_sch_t* q);
@@ -79,8 +91,18 @@ SRSLTE_API void srslte_sch_free(srslte_sch_t* q);
 
 SRSLTE_API void srslte_sch_set_max_noi(srslte_sch_t* q, uint32_t max_iterations);
 
+SRSLTE_API void srslte_sch_set_adaptive_noi(srslte_sch_t* q, uint32_t avg_iterations);
+
+SRSLTE_API void srslte_sch_reset_adaptive_budget(srslte_sch_t* q);
+
 SRSLTE_API float srslte_sch_last_noi(srslte_sch_t* q);
 
+SRSLTE_API int srslte_sch_cb_workers_init(uint32_t nof_workers, int prio_offset);
+
+SRSLTE_API void srslte_sch_cb_workers_free();
+
+SRSLTE_API void srslte_sch_enable_cb_workers(srslte_sch_t* q, bool enable);
+
 SRSLTE_API int srslte_dlsch_encode(srslte_sch_t* q, srslte_pdsch_cfg_t* cfg, uint8_t* data, uint8_t* e_bits);
 
 SRSLTE_API int srslte_dlsch_encode2(srslte_sch_t*       q,
@@ -41,6 +41,11 @@ SRSLTE_API void srslte_scrambling_b_offset(srslte_sequence_t* s, uint8_t* data,
 
 SRSLTE_API void srslte_scrambling_bytes(srslte_sequence_t* s, uint8_t* data, int len);
 
+/* Scrambling of soft bits with the packed sequence (c_bytes), such as the one of srslte_sequence_LTE_pr_packed() */
+SRSLTE_API void srslte_scrambling_bytes_s(srslte_sequence_t* s, short* data, int len);
+
+SRSLTE_API void srslte_scrambling_bytes_sb(srslte_sequence_t* s, int8_t* data, int len);
+
 SRSLTE_API void srslte_scrambling_f(srslte_sequence_t* s, float* data);
 
 SRSLTE_API void srslte_scrambling_f_offset(srslte_sequence_t* s, float* data, int offset, int len);
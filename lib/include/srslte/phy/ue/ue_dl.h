@@ -95,6 +95,7 @@ typedef struct SRSLTE_API {
   srslte_chest_dl_res_t chest_res;
   srslte_ofdm_t         fft[SRSLTE_MAX_PORTS];
   srslte_ofdm_t         fft_mbsfn;
+  srslte_ofdm_group_t   fft_group;
 
   // Buffers to store channel symbols after demodulation
   cf_t* sf_symbols[SRSLTE_MAX_PORTS];
@@ -67,6 +67,17 @@ SRSLTE_API void srslte_mat_2x2_mmse_csi_gen(cf_t   y0,
 
 SRSLTE_API float srslte_mat_2x2_cn(cf_t h00, cf_t h01, cf_t h10, cf_t h11);
 
+/* Generic implementation for Minimum Mean Squared Error (MMSE) solver of up to 4 layers (columns of h) and 4 receive
+ * antennas (rows of h). It becomes a Zero Forcing (ZF) solver when noise_estimate is 0 */
+SRSLTE_API void srslte_mat_4x4_mmse_csi_gen(const cf_t y[4],
+                                            const cf_t h[4][4],
+                                            uint32_t   nof_rxant,
+                                            uint32_t   nof_layers,
+                                            cf_t       x[4],
+                                            float      csi[4],
+                                            float      noise_estimate,
+                                            float      norm);
+
 #ifdef LV_HAVE_SSE
 
 /* SSE implementation for complex reciprocal */
@@ -203,6 +214,96 @@ static inline void srslte_mat_2x2_mmse_simd(simd_cf_t  y0,
   srslte_mat_2x2_mmse_csi_simd(y0, y1, h00, h01, h10, h11, x0, x1, &csi0, &csi1, noise_estimate, norm);
 }
 
+/* Generic SIMD implementation for Minimum Mean Squared Error (MMSE) solver of up to 4 layers (columns of h) and 4
+ * receive antennas (rows of h). It becomes a Zero Forcing (ZF) solver when noise_estimate is 0.
+ *
+ * Instead of inverting A = H' x H + No, it is decomposed as A = L x D x L', with L unit lower triangular and D real
+ * diagonal, so the only divisions are the reciprocals of D */
+static inline void srslte_mat_4x4_mmse_csi_simd(simd_cf_t y[4],
+                                                simd_cf_t h[4][4],
+                                                uint32_t  nof_rxant,
+                                                uint32_t  nof_layers,
+                                                simd_cf_t x[4],
+                                                simd_f_t  csi[4],
+                                                float     noise_estimate,
+                                                float     norm)
+{
+  simd_cf_t z[4], a[4][4], p[4][4], l[4][4], m[4][4];
+  simd_f_t  d[4], d_rcp[4];
+  simd_f_t  _noise_estimate = srslte_simd_f_set1(noise_estimate);
+  simd_f_t  _norm           = srslte_simd_f_set1(norm);
+  simd_f_t  _two            = srslte_simd_f_set1(2.0f);
+
+  /* 1. A = H' x H + No (lower triangle) and Z = H' x Y */
+  for (uint32_t i = 0; i < nof_layers; i++) {
+    z[i] = srslte_simd_cf_zero();
+    for (uint32_t j = 0; j <= i; j++) {
+      a[i][j] = srslte_simd_cf_zero();
+    }
+    for (uint32_t r = 0; r < nof_rxant; r++) {
+      z[i] = srslte_simd_cf_add(z[i], srslte_simd_cf_conjprod(y[r], h[r][i]));
+      for (uint32_t j = 0; j <= i; j++) {
+        a[i][j] = srslte_simd_cf_add(a[i][j], srslte_simd_cf_conjprod(h[r][j], h[r][i]));
+      }
+    }
+  }
+
+  /* 2. A = L x D x L', with P = L x D */
+  for (uint32_t j = 0; j < nof_layers; j++) {
+    d[j] = srslte_simd_f_add(srslte_simd_cf_re(a[j][j]), _noise_estimate);
+    for (uint32_t k = 0; k < j; k++) {
+      d[j] = srslte_simd_f_sub(d[j], srslte_simd_cf_re(srslte_simd_cf_conjprod(p[j][k], l[j][k])));
+    }
+
+    /* Refine the reciprocal estimate with a Newton-Raphson iteration */
+    d_rcp[j] = srslte_simd_f_rcp(d[j]);
+    d_rcp[j] = srslte_simd_f_mul(d_rcp[j], srslte_simd_f_sub(_two, srslte_simd_f_mul(d[j], d_rcp[j])));
+
+    for (uint32_t i = j + 1; i < nof_layers; i++) {
+      p[i][j] = a[i][j];
+      for (uint32_t k = 0; k < j; k++) {
+        p[i][j] = srslte_simd_cf_sub(p[i][j], srslte_simd_cf_conjprod(p[i][k], l[j][k]));
+      }
+      l[i][j] = srslte_simd_cf_mul(p[i][j], d_rcp[j]);
+    }
+  }
+
+  /* 3. M = inv(L), also unit lower triangular */
+  for (uint32_t j = 0; j < nof_layers; j++) {
+    for (uint32_t i = j + 1; i < nof_layers; i++) {
+      m[i][j] = l[i][j];
+      for (uint32_t k = j + 1; k < i; k++) {
+        m[i][j] = srslte_simd_cf_add(m[i][j], srslte_simd_cf_prod(l[i][k], m[k][j]));
+      }
+      m[i][j] = srslte_simd_cf_neg(m[i][j]);
+    }
+  }
+
+  /* 4. X = norm x inv(A) x Z = norm x M' x inv(D) x M x Z */
+  for (uint32_t i = 0; i < nof_layers; i++) {
+    x[i] = z[i];
+    for (uint32_t j = 0; j < i; j++) {
+      x[i] = srslte_simd_cf_add(x[i], srslte_simd_cf_prod(m[i][j], z[j]));
+    }
+    x[i] = srslte_simd_cf_mul(x[i], srslte_simd_f_mul(d_rcp[i], _norm));
+  }
+  for (uint32_t i = 0; i < nof_layers; i++) {
+    for (uint32_t j = i + 1; j < nof_layers; j++) {
+      x[i] = srslte_simd_cf_add(x[i], srslte_simd_cf_conjprod(x[j], m[j][i]));
+    }
+  }
+
+  /* 5. Extract CSI, the reciprocal of the diagonal of norm x inv(A) */
+  for (uint32_t i = 0; i < nof_layers; i++) {
+    simd_f_t b = d_rcp[i];
+    for (uint32_t j = i + 1; j < nof_layers; j++) {
+      simd_f_t m2 = srslte_simd_cf_re(srslte_simd_cf_conjprod(m[j][i], m[j][i]));
+      b           = srslte_simd_f_add(b, srslte_simd_f_mul(m2, d_rcp[j]));
+    }
+    csi[i] = srslte_simd_f_rcp(srslte_simd_f_mul(b, _norm));
+  }
+}
+
 #endif /* SRSLTE_SIMD_CF_SIZE != 0 */
 
 typedef struct {
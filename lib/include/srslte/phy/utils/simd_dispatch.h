@@ -0,0 +1,90 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ *  File:         simd_dispatch.h
+ *
+ *  Description:  Runtime selection of the instruction set of the SIMD kernels.
+ *                The vector library, the turbo and Viterbi decoders use the
+ *                kernels of the highest instruction set that is both built and
+ *                supported by the CPU, unless it is limited by the
+ *                SRSLTE_SIMD_ISA environment variable or srslte_simd_isa_set().
+ *                The selection is made once, the first time a kernel is chosen.
+ *
+ *                With the ENABLE_SIMD_DISPATCH build option the library is
+ *                compiled for a SSE4.1 baseline and the AVX2 and AVX512
+ *                kernels are built in their own translation units, so a
+ *                single binary runs the best kernels on every x86 CPU.
+ *****************************************************************************/
+
+#ifndef SRSLTE_SIMD_DISPATCH_H
+#define SRSLTE_SIMD_DISPATCH_H
+
+#include "srslte/config.h"
+#include <stdint.h>
+
+/* Instruction sets of the kernels in this build, either from the global flags or built as ENABLE_SIMD_DISPATCH
+ * variants */
+#if defined(LV_HAVE_AVX2) || defined(SRSLTE_SIMD_DISPATCH_AVX2)
+#define SRSLTE_SIMD_KERNELS_AVX2
+#endif /* LV_HAVE_AVX2 || SRSLTE_SIMD_DISPATCH_AVX2 */
+
+#if defined(LV_HAVE_AVX512) || defined(SRSLTE_SIMD_DISPATCH_AVX512)
+#define SRSLTE_SIMD_KERNELS_AVX512
+#endif /* LV_HAVE_AVX512 || SRSLTE_SIMD_DISPATCH_AVX512 */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Ordered instruction sets, every one of an architecture includes the ones below it */
+typedef enum SRSLTE_API {
+  SRSLTE_SIMD_ISA_GENERIC = 0,
+  SRSLTE_SIMD_ISA_NEON,
+  SRSLTE_SIMD_ISA_SSE,
+  SRSLTE_SIMD_ISA_AVX2,
+  SRSLTE_SIMD_ISA_AVX512,
+} srslte_simd_isa_t;
+
+/* Highest instruction set of the kernels in this build */
+SRSLTE_API srslte_simd_isa_t srslte_simd_isa_built();
+
+/* Highest instruction set supported by the CPU */
+SRSLTE_API srslte_simd_isa_t srslte_simd_isa_cpu();
+
+/* Instruction set of the kernels in use. The first call selects it */
+SRSLTE_API srslte_simd_isa_t srslte_simd_isa();
+
+/* Limits the instruction set of the kernels to the one named (generic, neon, sse, avx2 or avx512), "auto" removes the
+ * limit. It overrides the SRSLTE_SIMD_ISA environment variable and must be called before any PHY object is
+ * initialized: it fails once the instruction set has been selected */
+SRSLTE_API int srslte_simd_isa_set(const char* name);
+
+SRSLTE_API const char* srslte_simd_isa_string(srslte_simd_isa_t isa);
+
+/* Writes a line with the instruction set selected, built and supported by the CPU in str */
+SRSLTE_API int srslte_simd_isa_info(char* str, uint32_t str_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SRSLTE_SIMD_DISPATCH_H
@@ -39,6 +39,7 @@ extern "C" {
 #include "srslte/phy/utils/convolution.h"
 #include "srslte/phy/utils/debug.h"
 #include "srslte/phy/utils/ringbuffer.h"
+#include "srslte/phy/utils/simd_dispatch.h"
 #include "srslte/phy/utils/vector.h"
 
 #include "srslte/phy/common/phy_common.h"
@@ -35,6 +35,7 @@ public:
   void                                start_cell_search() override {}
   void                                start_cell_select(const phy_interface_rrc_lte::phy_cell_t* cell) override {}
   srslte::tti_point get_current_tti() override { return srslte::tti_point{timers.get_cur_time() % 10240}; }
+  void              warning_msg_received(const rrc_warning_msg_t& msg) override { warning_msgs.push_back(msg); }
   srslte::task_multiqueue::queue_handler make_task_queue() final { return pending_tasks.get_queue_handler(); }
   void                                   enqueue_background_task(std::function<void(uint32_t)> f) override { f(0); }
   void                                   notify_background_task_result(srslte::move_task_t task) override { task(); }
@@ -66,6 +67,7 @@ public:
   srslte::timer_handler            timers{100};
   srslte::task_multiqueue          pending_tasks;
   std::vector<srslte::move_task_t> tti_callbacks;
+  std::vector<rrc_warning_msg_t>   warning_msgs;
   int                              stack_queue_id = -1;
 };
 
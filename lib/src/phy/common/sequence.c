@@ -146,6 +146,33 @@ static inline uint32_t sequence_gen_LTE_pr_memless_step_x2(uint32_t state)
 static uint32_t sequence_x1_init                    = 0;
 static uint32_t sequence_x2_init[SEQUENCE_SEED_LEN] = {};
 
+/**
+ * Packed 64-bit generation
+ * ------------------------
+ *
+ * Raising the characteristic polynomials to the 4th power over GF(2) gives recurrences whose taps are at least 112
+ * chips away:
+ *     x1: D^124 + D^12 + 1                 -> x1(n) = x1(n-112) ^ x1(n-124)
+ *     x2: D^124 + D^12 + D^8 + D^4 + 1     -> x2(n) = x2(n-112) ^ x2(n-116) ^ x2(n-120) ^ x2(n-124)
+ *
+ * So a window with the last 128 chips of each sequence gives the next 64 chips with a few shifts and XORs. The
+ * windows after Nc are pre-computed like the states above, one for x1 and one for each bit of the seed for x2.
+ */
+#define SEQUENCE_WINDOW_LEN (128)
+
+static uint64_t sequence_x1_init_window[2]                    = {};
+static uint64_t sequence_x2_init_window[SEQUENCE_SEED_LEN][2] = {};
+
+static void sequence_gen_window(uint32_t state, uint32_t (*step)(uint32_t), uint64_t window[2])
+{
+  window[0] = 0;
+  window[1] = 0;
+  for (uint32_t n = 0; n < SEQUENCE_WINDOW_LEN; n++) {
+    window[n / 64] |= (uint64_t)(state & 1U) << (n % 64);
+    state = step(state);
+  }
+}
+
 /**
  * C constructor, pre-computes X1 and X2 initial states
  */
@@ -166,6 +193,12 @@ __attribute__((constructor)) __attribute__((unused)) static void srslte_lte_pr_p
       sequence_x2_init[i] = sequence_gen_LTE_pr_memless_step_x2(sequence_x2_init[i]);
     }
   }
+
+  // Compute the windows of the packed generation
+  sequence_gen_window(sequence_x1_init, sequence_gen_LTE_pr_memless_step_x1, sequence_x1_init_window);
+  for (uint32_t i = 0; i < SEQUENCE_SEED_LEN; i++) {
+    sequence_gen_window(sequence_x2_init[i], sequence_gen_LTE_pr_memless_step_x2, sequence_x2_init_window[i]);
+  }
 }
 
 static uint32_t sequence_get_x2_init(uint32_t seed)
@@ -215,6 +248,59 @@ static void sequence_gen_LTE_pr(uint8_t* pr, uint32_t len, uint32_t seed)
   }
 }
 
+/**
+ * Reverses the bit order within each byte, so that the first chip of every byte goes to its MSB
+ */
+static inline uint64_t sequence_reverse_bytes(uint64_t v)
+{
+  v = ((v >> 1U) & 0x5555555555555555ULL) | ((v & 0x5555555555555555ULL) << 1U);
+  v = ((v >> 2U) & 0x3333333333333333ULL) | ((v & 0x3333333333333333ULL) << 2U);
+  v = ((v >> 4U) & 0x0F0F0F0F0F0F0F0FULL) | ((v & 0x0F0F0F0F0F0F0F0FULL) << 4U);
+  return v;
+}
+
+/**
+ * Generates the sequence packed MSB first, as srslte_bit_pack_vector() does, 64 chips per step
+ */
+static void sequence_gen_LTE_pr_packed(uint8_t* c_bytes, uint32_t len, uint32_t seed)
+{
+  uint64_t x1_0 = sequence_x1_init_window[0];
+  uint64_t x1_1 = sequence_x1_init_window[1];
+  uint64_t x2_0 = 0;
+  uint64_t x2_1 = 0;
+
+  for (uint32_t i = 0; i < SEQUENCE_SEED_LEN; i++) {
+    if ((seed >> i) & 1U) {
+      x2_0 ^= sequence_x2_init_window[i][0];
+      x2_1 ^= sequence_x2_init_window[i][1];
+    }
+  }
+
+  for (uint32_t n = 0; n < len; n += 64) {
+    uint64_t c = sequence_reverse_bytes(x1_0 ^ x2_0);
+
+    if (len - n >= 64) {
+      memcpy(&c_bytes[n / 8], &c, sizeof(uint64_t));
+    } else {
+      // Write the bytes left and clear the chips past the end
+      uint32_t nof_bytes = (len - n + 7) / 8;
+      memcpy(&c_bytes[n / 8], &c, nof_bytes);
+      if (len % 8) {
+        c_bytes[len / 8] &= (uint8_t)(0xffU << (8 - len % 8));
+      }
+    }
+
+    // Step sequences
+    uint64_t x1_2 = ((x1_0 >> 16U) | (x1_1 << 48U)) ^ ((x1_0 >> 4U) | (x1_1 << 60U));
+    uint64_t x2_2 = ((x2_0 >> 16U) | (x2_1 << 48U)) ^ ((x2_0 >> 12U) | (x2_1 << 52U)) ^
+                    ((x2_0 >> 8U) | (x2_1 << 56U)) ^ ((x2_0 >> 4U) | (x2_1 << 60U));
+    x1_0 = x1_1;
+    x1_1 = x1_2;
+    x2_0 = x2_1;
+    x2_1 = x2_2;
+  }
+}
+
 // static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
 int srslte_sequence_set_LTE_pr(srslte_sequence_t* q, uint32_t len, uint32_t seed)
 {
@@ -302,8 +388,8 @@ int srslte_sequence_LTE_pr(srslte_sequence_t* q, uint32_t len, uint32_t seed)
   // Generate sequence
   srslte_sequence_set_LTE_pr(q, len, seed);
 
-  // Pack PR sequence
-  srslte_bit_pack_vector(q->c, q->c_bytes, len);
+  // Generate packed PR sequence
+  sequence_gen_LTE_pr_packed(q->c_bytes, len, seed);
 
   // Generate signed type values
   sequence_generate_signed(q->c, q->c_char, q->c_short, q->c_float, len);
@@ -311,6 +397,26 @@ int srslte_sequence_LTE_pr(srslte_sequence_t* q, uint32_t len, uint32_t seed)
   return SRSLTE_SUCCESS;
 }
 
+int srslte_sequence_LTE_pr_packed(srslte_sequence_t* q, uint32_t len, uint32_t seed)
+{
+  if (q->c_bytes && len > q->max_len) {
+    srslte_sequence_free(q);
+  }
+  if (!q->c_bytes) {
+    // Room for the last 64-bit store
+    q->c_bytes = srslte_vec_u8_malloc(len / 8 + 8);
+    if (!q->c_bytes) {
+      return SRSLTE_ERROR;
+    }
+    q->max_len = len;
+  }
+  q->cur_len = len;
+
+  sequence_gen_LTE_pr_packed(q->c_bytes, len, seed);
+
+  return SRSLTE_SUCCESS;
+}
+
 int srslte_sequence_init(srslte_sequence_t* q, uint32_t len)
 {
   if (q->c && len > q->max_len) {
@@ -362,6 +468,74 @@ void srslte_sequence_free(srslte_sequence_t* q)
   bzero(q, sizeof(srslte_sequence_t));
 }
 
+/* Number of entries probed for a seed, the least recently used one is replaced on a miss */
+#define SEQUENCE_CACHE_WAYS 8
+
+int srslte_sequence_cache_init(srslte_sequence_cache_t* q, uint32_t nof_entries)
+{
+  if (q == NULL || nof_entries == 0) {
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+
+  bzero(q, sizeof(srslte_sequence_cache_t));
+
+  // Sequences are allocated on their first use
+  q->entries = calloc(nof_entries, sizeof(srslte_sequence_cache_entry_t));
+  if (!q->entries) {
+    ERROR("Error allocating sequence cache\n");
+    return SRSLTE_ERROR;
+  }
+  q->nof_entries = nof_entries;
+
+  return SRSLTE_SUCCESS;
+}
+
+void srslte_sequence_cache_free(srslte_sequence_cache_t* q)
+{
+  if (q->entries) {
+    for (uint32_t i = 0; i < q->nof_entries; i++) {
+      srslte_sequence_free(&q->entries[i].seq);
+    }
+    free(q->entries);
+  }
+  bzero(q, sizeof(srslte_sequence_cache_t));
+}
+
+srslte_sequence_t* srslte_sequence_cache_get(srslte_sequence_cache_t* q, uint32_t seed, uint32_t len)
+{
+  if (q == NULL || q->entries == NULL) {
+    return NULL;
+  }
+
+  // Fibonacci hashing spreads the seeds, which only differ in a few bit fields
+  uint32_t idx      = (uint32_t)(((uint64_t)(seed * 2654435769U) * q->nof_entries) >> 32U);
+  uint32_t nof_ways = SRSLTE_MIN(SEQUENCE_CACHE_WAYS, q->nof_entries);
+
+  srslte_sequence_cache_entry_t* victim = NULL;
+  for (uint32_t i = 0; i < nof_ways; i++) {
+    srslte_sequence_cache_entry_t* e = &q->entries[(idx + i) % q->nof_entries];
+    if (e->valid && e->seed == seed && e->seq.cur_len >= len) {
+      e->last_used = ++q->count;
+      return &e->seq;
+    }
+    // Prefer an empty entry, or the least recently used one otherwise
+    if (victim == NULL || (victim->valid && (!e->valid || e->last_used < victim->last_used))) {
+      victim = e;
+    }
+  }
+
+  victim->valid = false;
+  if (srslte_sequence_LTE_pr_packed(&victim->seq, len, seed)) {
+    ERROR("Error generating cached sequence\n");
+    return NULL;
+  }
+  victim->seed      = seed;
+  victim->last_used = ++q->count;
+  victim->valid     = true;
+
+  return &victim->seq;
+}
+
 void srslte_sequence_apply_f(const float* in, float* out, uint32_t length, uint32_t seed)
 {
   uint32_t x1 = sequence_x1_init;           // X1 initial state is fix
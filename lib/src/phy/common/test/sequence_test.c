@@ -33,21 +33,26 @@ static uint8_t c[Nc + MAX_SEQ_LEN + 31];
 static float   c_float[Nc + MAX_SEQ_LEN + 31];
 static int16_t c_short[Nc + MAX_SEQ_LEN + 31];
 static int8_t  c_char[Nc + MAX_SEQ_LEN + 31];
-static uint8_t c_packed[MAX_SEQ_LEN / 8];
+static uint8_t c_packed[MAX_SEQ_LEN / 8 + 1];
 
 static float   ones_float[Nc + MAX_SEQ_LEN + 31];
 static int16_t ones_short[Nc + MAX_SEQ_LEN + 31];
 static int8_t  ones_char[Nc + MAX_SEQ_LEN + 31];
 static uint8_t ones_packed[MAX_SEQ_LEN / 8];
 
-static int test_sequence(srslte_sequence_t* sequence, uint32_t seed, uint32_t length, uint32_t repetitions)
+static int test_sequence(srslte_sequence_t* sequence,
+                         srslte_sequence_t* packed,
+                         uint32_t           seed,
+                         uint32_t           length,
+                         uint32_t           repetitions)
 {
-  int            ret                   = SRSLTE_SUCCESS;
-  struct timeval t[3]                  = {};
-  uint64_t       interval_gen_us       = 0;
-  uint64_t       interval_xor_float_us = 0;
-  uint64_t       interval_xor_short_us = 0;
-  uint64_t       interval_xor_char_us  = 0;
+  int            ret                    = SRSLTE_SUCCESS;
+  struct timeval t[3]                   = {};
+  uint64_t       interval_gen_us        = 0;
+  uint64_t       interval_gen_packed_us = 0;
+  uint64_t       interval_xor_float_us  = 0;
+  uint64_t       interval_xor_short_us  = 0;
+  uint64_t       interval_xor_char_us   = 0;
 
   gettimeofday(&t[1], NULL);
 
@@ -60,6 +65,17 @@ static int test_sequence(srslte_sequence_t* sequence, uint32_t seed, uint32_t le
   get_time_interval(t);
   interval_gen_us = t->tv_sec * 1000000UL + t->tv_usec;
 
+  gettimeofday(&t[1], NULL);
+
+  // Generate packed sequence
+  for (uint32_t r = 0; r < repetitions; r++) {
+    srslte_sequence_LTE_pr_packed(packed, length, seed);
+  }
+
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  interval_gen_packed_us = t->tv_sec * 1000000UL + t->tv_usec;
+
   // Generate gold sequence
   for (uint32_t n = 0; n < 31; n++) {
     x2[n] = (seed >> n) & 0x1;
@@ -145,16 +161,23 @@ static int test_sequence(srslte_sequence_t* sequence, uint32_t seed, uint32_t le
     ret = SRSLTE_ERROR;
   }
 
-  printf("%08x; %8d; %8.1f; %8.1f; %8.1f; %8.1f; %8c\n",
+  // The packed generation also clears the bits past the end
+  if (memcmp(c_packed, packed->c_bytes, (length + 7) / 8) != 0) {
+    ERROR("Unmatched packed c_bytes");
+    ret = SRSLTE_ERROR;
+  }
+
+  printf("%08x; %8d; %8.1f; %8.1f; %8.1f; %8.1f; %8.1f; %8c\n",
          seed,
          length,
          (double)(length * repetitions) / (double)interval_gen_us,
+         (double)(length * repetitions) / (double)interval_gen_packed_us,
          (double)(length * repetitions) / (double)interval_xor_float_us,
          (double)(length * repetitions) / (double)interval_xor_short_us,
          (double)(length * repetitions) / (double)interval_xor_char_us,
          ret == SRSLTE_SUCCESS ? 'y' : 'n');
 
-  return SRSLTE_SUCCESS;
+  return ret;
 }
 
 int main(int argc, char** argv)
@@ -162,8 +185,10 @@ int main(int argc, char** argv)
   uint32_t repetitions = 1;
   uint32_t min_length  = 16;
   uint32_t max_length  = MAX_SEQ_LEN;
+  int      ret         = SRSLTE_SUCCESS;
 
   srslte_sequence_t sequence   = {};
+  srslte_sequence_t packed     = {};
   srslte_random_t   random_gen = srslte_random_init(0);
 
   // Initialise vectors with ones
@@ -182,15 +207,27 @@ int main(int argc, char** argv)
     return SRSLTE_ERROR;
   }
 
-  printf("%8s; %8s; %8s; %8s; %8s; %8s; %8s\n", "seed", "length", "GEN", "XOR PS", "XOR 16", "XOR 8", "Passed");
+  printf("%8s; %8s; %8s; %8s; %8s; %8s; %8s; %8s\n",
+         "seed",
+         "length",
+         "GEN",
+         "GEN PACK",
+         "XOR PS",
+         "XOR 16",
+         "XOR 8",
+         "Passed");
 
   for (uint32_t length = min_length; length <= max_length; length = (length * 5) / 4) {
-    test_sequence(&sequence, (uint32_t)srslte_random_uniform_int_dist(random_gen, 1, INT32_MAX), length, repetitions);
+    uint32_t seed = (uint32_t)srslte_random_uniform_int_dist(random_gen, 1, INT32_MAX);
+    if (test_sequence(&sequence, &packed, seed, length, repetitions)) {
+      ret = SRSLTE_ERROR;
+    }
   }
 
   // Free sequence object
   srslte_sequence_free(&sequence);
+  srslte_sequence_free(&packed);
   srslte_random_free(random_gen);
 
-  return SRSLTE_SUCCESS;
+  return ret;
 }
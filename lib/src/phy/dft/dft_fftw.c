@@ -35,8 +35,16 @@
 
 #define FFTW_WISDOM_FILE "%s/.srslte_fftwisdom"
 
+// Environment variable that overrides the default wisdom file, an empty value disables the wisdom file
+#define FFTW_WISDOM_ENV "SRSLTE_FFTW_WISDOM"
+
 static int get_fftw_wisdom_file(char* full_path, uint32_t n)
 {
+  const char* env = getenv(FFTW_WISDOM_ENV);
+  if (env != NULL) {
+    return snprintf(full_path, n, "%s", env);
+  }
+
   const char* homedir = NULL;
   if ((homedir = getenv("HOME")) == NULL) {
     homedir = getpwuid(getuid())->pw_dir;
@@ -53,13 +61,178 @@ static int get_fftw_wisdom_file(char* full_path, uint32_t n)
 
 static pthread_mutex_t fft_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+// Wisdom file saved when the executable ends
+static char fftw_wisdom_path[256] = {};
+
+/**
+ * Shared plans
+ * ------------
+ *
+ * FFTW plans can be executed concurrently on arrays other than the planned ones with the new-array execute functions,
+ * provided these have the same alignment and in-placeness. So all the objects of the process share their plans, which
+ * are created once for each transform size, direction and data layout, and destroyed when the last object that uses
+ * them is freed. All the registry accesses are protected by fft_mutex.
+ */
+#define DFT_MAX_SHARED_PLANS 256
+
+typedef struct {
+  int  size;
+  int  sign; // FFTW sign for complex plans, r2r kind for real plans
+  bool is_real;
+  bool in_place;
+  int  in_alignment;
+  int  out_alignment;
+  int  istride;
+  int  ostride;
+  int  how_many;
+  int  idist;
+  int  odist;
+} dft_plan_key_t;
+
+typedef struct {
+  dft_plan_key_t key;
+  fftwf_plan     p;
+  uint32_t       count;
+} dft_plan_entry_t;
+
+static dft_plan_entry_t dft_plans[DFT_MAX_SHARED_PLANS] = {};
+
+static dft_plan_key_t
+dft_plan_key(int size, int sign, bool is_real, void* in, void* out, int istride, int ostride, int how_many, int idist, int odist)
+{
+  dft_plan_key_t key = {};
+  key.size           = size;
+  key.sign           = sign;
+  key.is_real        = is_real;
+  key.in_place       = (in == out);
+  key.in_alignment   = fftwf_alignment_of((float*)in);
+  key.out_alignment  = fftwf_alignment_of((float*)out);
+  key.istride        = istride;
+  key.ostride        = ostride;
+  key.how_many       = how_many;
+  key.idist          = idist;
+  key.odist          = odist;
+  return key;
+}
+
+static bool dft_plan_key_equal(const dft_plan_key_t* a, const dft_plan_key_t* b)
+{
+  return a->size == b->size && a->sign == b->sign && a->is_real == b->is_real && a->in_place == b->in_place &&
+         a->in_alignment == b->in_alignment && a->out_alignment == b->out_alignment && a->istride == b->istride &&
+         a->ostride == b->ostride && a->how_many == b->how_many && a->idist == b->idist && a->odist == b->odist;
+}
+
+/* Returns a plan for the key, creating it on the given arrays if no other object uses it. Must be called with
+ * fft_mutex locked */
+static fftwf_plan dft_plan_acquire(const dft_plan_key_t* key, void* in, void* out)
+{
+  dft_plan_entry_t* free_entry = NULL;
+  for (uint32_t i = 0; i < DFT_MAX_SHARED_PLANS; i++) {
+    if (dft_plans[i].count && dft_plan_key_equal(&dft_plans[i].key, key)) {
+      dft_plans[i].count++;
+      return dft_plans[i].p;
+    }
+    if (!dft_plans[i].count && free_entry == NULL) {
+      free_entry = &dft_plans[i];
+    }
+  }
+
+  fftwf_plan p = NULL;
+  if (key->is_real) {
+    p = fftwf_plan_r2r_1d(key->size, in, out, key->sign, FFTW_TYPE);
+  } else if (key->how_many == 1 && key->istride == 1 && key->ostride == 1) {
+    p = fftwf_plan_dft_1d(key->size, in, out, key->sign, FFTW_TYPE);
+  } else {
+    const fftwf_iodim iodim        = {key->size, key->istride, key->ostride};
+    const fftwf_iodim howmany_dims = {key->how_many, key->idist, key->odist};
+    p = fftwf_plan_guru_dft(1, &iodim, 1, &howmany_dims, in, out, key->sign, FFTW_TYPE);
+  }
+
+  // If the registry is full the plan is owned by the object alone
+  if (p && free_entry) {
+    free_entry->key   = *key;
+    free_entry->p     = p;
+    free_entry->count = 1;
+  }
+
+  return p;
+}
+
+/* Releases a plan, which is destroyed when no object uses it. Must be called with fft_mutex locked */
+static void dft_plan_release(fftwf_plan p)
+{
+  if (p == NULL) {
+    return;
+  }
+
+  for (uint32_t i = 0; i < DFT_MAX_SHARED_PLANS; i++) {
+    if (dft_plans[i].count && dft_plans[i].p == p) {
+      dft_plans[i].count--;
+      if (!dft_plans[i].count) {
+        fftwf_destroy_plan(p);
+        bzero(&dft_plans[i], sizeof(dft_plan_entry_t));
+      }
+      return;
+    }
+  }
+
+  fftwf_destroy_plan(p);
+}
+
+uint32_t srslte_dft_nof_shared_plans()
+{
+  uint32_t count = 0;
+
+  pthread_mutex_lock(&fft_mutex);
+  for (uint32_t i = 0; i < DFT_MAX_SHARED_PLANS; i++) {
+    if (dft_plans[i].count) {
+      count++;
+    }
+  }
+  pthread_mutex_unlock(&fft_mutex);
+
+  return count;
+}
+
+int srslte_dft_load_wisdom(const char* filename)
+{
+  int ret = SRSLTE_SUCCESS;
+
+  pthread_mutex_lock(&fft_mutex);
+  if (filename == NULL) {
+    get_fftw_wisdom_file(fftw_wisdom_path, sizeof(fftw_wisdom_path));
+  } else {
+    snprintf(fftw_wisdom_path, sizeof(fftw_wisdom_path), "%s", filename);
+  }
+  if (strlen(fftw_wisdom_path) && !fftwf_import_wisdom_from_filename(fftw_wisdom_path)) {
+    ret = SRSLTE_ERROR;
+  }
+  pthread_mutex_unlock(&fft_mutex);
+
+  return ret;
+}
+
+int srslte_dft_save_wisdom(const char* filename)
+{
+  int ret = SRSLTE_SUCCESS;
+
+  pthread_mutex_lock(&fft_mutex);
+  if (filename == NULL) {
+    filename = fftw_wisdom_path;
+  }
+  if (strlen(filename) && !fftwf_export_wisdom_to_filename(filename)) {
+    ret = SRSLTE_ERROR;
+  }
+  pthread_mutex_unlock(&fft_mutex);
+
+  return ret;
+}
+
 // This function is called in the beggining of any executable where it is linked
 __attribute__((constructor)) static void srslte_dft_load()
 {
 #ifdef FFTW_WISDOM_FILE
-  char full_path[256];
-  get_fftw_wisdom_file(full_path, sizeof(full_path));
-  fftwf_import_wisdom_from_filename(full_path);
+  srslte_dft_load_wisdom(NULL);
 #else
   printf("Warning: FFTW Wisdom file not defined\n");
 #endif
@@ -69,9 +242,7 @@ __attribute__((constructor)) static void srslte_dft_load()
 __attribute__((destructor)) static void srslte_dft_exit()
 {
 #ifdef FFTW_WISDOM_FILE
-  char full_path[256];
-  get_fftw_wisdom_file(full_path, sizeof(full_path));
-  fftwf_export_wisdom_to_filename(full_path);
+  srslte_dft_save_wisdom(NULL);
 #endif
   fftwf_cleanup();
 }
@@ -122,21 +293,23 @@ int srslte_dft_replan_guru_c(srslte_dft_plan_t* plan,
 {
   int sign = (plan->forward) ? FFTW_FORWARD : FFTW_BACKWARD;
 
-  const fftwf_iodim iodim        = {new_dft_points, istride, ostride};
-  const fftwf_iodim howmany_dims = {how_many, idist, odist};
+  dft_plan_key_t key =
+      dft_plan_key(new_dft_points, sign, false, in_buffer, out_buffer, istride, ostride, how_many, idist, odist);
 
   pthread_mutex_lock(&fft_mutex);
 
-  /* Destroy current plan */
-  fftwf_destroy_plan(plan->p);
+  /* Release current plan */
+  dft_plan_release(plan->p);
 
-  plan->p = fftwf_plan_guru_dft(1, &iodim, 1, &howmany_dims, in_buffer, out_buffer, sign, FFTW_TYPE);
+  plan->p = dft_plan_acquire(&key, in_buffer, out_buffer);
 
   pthread_mutex_unlock(&fft_mutex);
 
   if (!plan->p) {
     return -1;
   }
+  plan->in        = in_buffer;
+  plan->out       = out_buffer;
   plan->size      = new_dft_points;
   plan->init_size = plan->size;
 
@@ -147,12 +320,11 @@ int srslte_dft_replan_c(srslte_dft_plan_t* plan, const int new_dft_points)
 {
   int sign = (plan->dir == SRSLTE_DFT_FORWARD) ? FFTW_FORWARD : FFTW_BACKWARD;
 
+  dft_plan_key_t key = dft_plan_key(new_dft_points, sign, false, plan->in, plan->out, 1, 1, 1, 0, 0);
+
   pthread_mutex_lock(&fft_mutex);
-  if (plan->p) {
-    fftwf_destroy_plan(plan->p);
-    plan->p = NULL;
-  }
-  plan->p = fftwf_plan_dft_1d(new_dft_points, plan->in, plan->out, sign, FFTW_TYPE);
+  dft_plan_release(plan->p);
+  plan->p = dft_plan_acquire(&key, plan->in, plan->out);
   pthread_mutex_unlock(&fft_mutex);
 
   if (!plan->p) {
@@ -175,17 +347,68 @@ int srslte_dft_plan_guru_c(srslte_dft_plan_t* plan,
 {
   int sign = (dir == SRSLTE_DFT_FORWARD) ? FFTW_FORWARD : FFTW_BACKWARD;
 
-  const fftwf_iodim iodim        = {dft_points, istride, ostride};
-  const fftwf_iodim howmany_dims = {how_many, idist, odist};
+  dft_plan_key_t key =
+      dft_plan_key(dft_points, sign, false, in_buffer, out_buffer, istride, ostride, how_many, idist, odist);
 
   pthread_mutex_lock(&fft_mutex);
+  plan->p = dft_plan_acquire(&key, in_buffer, out_buffer);
+  pthread_mutex_unlock(&fft_mutex);
 
-  plan->p = fftwf_plan_guru_dft(1, &iodim, 1, &howmany_dims, in_buffer, out_buffer, sign, FFTW_TYPE);
   if (!plan->p) {
     return -1;
   }
+
+  plan->in        = in_buffer;
+  plan->out       = out_buffer;
+  plan->size      = dft_points;
+  plan->init_size = plan->size;
+  plan->mode      = SRSLTE_DFT_COMPLEX;
+  plan->dir       = dir;
+  plan->forward   = (dir == SRSLTE_DFT_FORWARD) ? true : false;
+  plan->mirror    = false;
+  plan->db        = false;
+  plan->norm      = false;
+  plan->dc        = false;
+  plan->is_guru   = true;
+
+  return 0;
+}
+
+int srslte_dft_plan_guru_batch_c(srslte_dft_plan_t* plan,
+                                 const int          dft_points,
+                                 srslte_dft_dir_t   dir,
+                                 cf_t*              in_buffer,
+                                 cf_t*              out_buffer,
+                                 int                how_many_rank,
+                                 const int*         how_many,
+                                 const int*         idist,
+                                 const int*         odist)
+{
+  if (how_many_rank < 1 || how_many_rank > SRSLTE_DFT_MAX_HOW_MANY_RANK) {
+    ERROR("Invalid number of DFT set dimensions %d\n", how_many_rank);
+    return -1;
+  }
+
+  int               sign  = (dir == SRSLTE_DFT_FORWARD) ? FFTW_FORWARD : FFTW_BACKWARD;
+  const fftwf_iodim iodim = {dft_points, 1, 1};
+  fftwf_iodim       howmany_dims[SRSLTE_DFT_MAX_HOW_MANY_RANK];
+  for (int i = 0; i < how_many_rank; i++) {
+    howmany_dims[i].n  = how_many[i];
+    howmany_dims[i].is = idist[i];
+    howmany_dims[i].os = odist[i];
+  }
+
+  // The plan is owned by the object alone, it is destroyed by srslte_dft_plan_free() as it is not in the registry
+  pthread_mutex_lock(&fft_mutex);
+  plan->p = fftwf_plan_guru_dft(1, &iodim, how_many_rank, howmany_dims, in_buffer, out_buffer, sign, FFTW_TYPE);
   pthread_mutex_unlock(&fft_mutex);
 
+  if (!plan->p) {
+    return -1;
+  }
+
+  plan->in        = in_buffer;
+  plan->out       = out_buffer;
   plan->size      = dft_points;
   plan->init_size = plan->size;
   plan->mode      = SRSLTE_DFT_COMPLEX;
@@ -204,11 +427,11 @@ int srslte_dft_plan_c(srslte_dft_plan_t* plan, const int dft_points, srslte_dft_
 {
   allocate(plan, sizeof(fftwf_complex), sizeof(fftwf_complex), dft_points);
 
-  pthread_mutex_lock(&fft_mutex);
-
-  int sign = (dir == SRSLTE_DFT_FORWARD) ? FFTW_FORWARD : FFTW_BACKWARD;
-  plan->p  = fftwf_plan_dft_1d(dft_points, plan->in, plan->out, sign, FFTW_TYPE);
+  int            sign = (dir == SRSLTE_DFT_FORWARD) ? FFTW_FORWARD : FFTW_BACKWARD;
+  dft_plan_key_t key  = dft_plan_key(dft_points, sign, false, plan->in, plan->out, 1, 1, 1, 0, 0);
 
+  pthread_mutex_lock(&fft_mutex);
+  plan->p = dft_plan_acquire(&key, plan->in, plan->out);
   pthread_mutex_unlock(&fft_mutex);
 
   if (!plan->p) {
@@ -232,12 +455,11 @@ int srslte_dft_replan_r(srslte_dft_plan_t* plan, const int new_dft_points)
 {
   int sign = (plan->dir == SRSLTE_DFT_FORWARD) ? FFTW_R2HC : FFTW_HC2R;
 
+  dft_plan_key_t key = dft_plan_key(new_dft_points, sign, true, plan->in, plan->out, 1, 1, 1, 0, 0);
+
   pthread_mutex_lock(&fft_mutex);
-  if (plan->p) {
-    fftwf_destroy_plan(plan->p);
-    plan->p = NULL;
-  }
-  plan->p = fftwf_plan_r2r_1d(new_dft_points, plan->in, plan->out, sign, FFTW_TYPE);
+  dft_plan_release(plan->p);
+  plan->p = dft_plan_acquire(&key, plan->in, plan->out);
   pthread_mutex_unlock(&fft_mutex);
 
   if (!plan->p) {
@@ -250,10 +472,11 @@ int srslte_dft_replan_r(srslte_dft_plan_t* plan, const int new_dft_points)
 int srslte_dft_plan_r(srslte_dft_plan_t* plan, const int dft_points, srslte_dft_dir_t dir)
 {
   allocate(plan, sizeof(float), sizeof(float), dft_points);
-  int sign = (dir == SRSLTE_DFT_FORWARD) ? FFTW_R2HC : FFTW_HC2R;
+  int            sign = (dir == SRSLTE_DFT_FORWARD) ? FFTW_R2HC : FFTW_HC2R;
+  dft_plan_key_t key  = dft_plan_key(dft_points, sign, true, plan->in, plan->out, 1, 1, 1, 0, 0);
 
   pthread_mutex_lock(&fft_mutex);
-  plan->p = fftwf_plan_r2r_1d(dft_points, plan->in, plan->out, sign, FFTW_TYPE);
+  plan->p = dft_plan_acquire(&key, plan->in, plan->out);
   pthread_mutex_unlock(&fft_mutex);
 
   if (!plan->p) {
@@ -335,7 +558,7 @@ void srslte_dft_run_c(srslte_dft_plan_t* plan, const cf_t* in, cf_t* out)
   fftwf_complex* f_out = plan->out;
 
   copy_pre((uint8_t*)plan->in, (uint8_t*)in, sizeof(cf_t), plan->size, plan->forward, plan->mirror, plan->dc);
-  fftwf_execute(plan->p);
+  fftwf_execute_dft(plan->p, plan->in, plan->out);
   if (plan->norm) {
     norm = 1.0 / sqrtf(plan->size);
     srslte_vec_sc_prod_cfc(f_out, norm, f_out, plan->size);
@@ -351,7 +574,7 @@ void srslte_dft_run_c(srslte_dft_plan_t* plan, const cf_t* in, cf_t* out)
 void srslte_dft_run_guru_c(srslte_dft_plan_t* plan)
 {
   if (plan->is_guru == true) {
-    fftwf_execute(plan->p);
+    fftwf_execute_dft(plan->p, plan->in, plan->out);
   } else {
     ERROR("srslte_dft_run_guru_c: the selected plan is not guru!\n");
   }
@@ -365,7 +588,7 @@ void srslte_dft_run_r(srslte_dft_plan_t* plan, const float* in, float* out)
   float* f_out = plan->out;
 
   memcpy(plan->in, in, sizeof(float) * plan->size);
-  fftwf_execute(plan->p);
+  fftwf_execute_r2r(plan->p, plan->in, plan->out);
   if (plan->norm) {
     norm = 1.0 / plan->size;
     srslte_vec_sc_prod_fff(f_out, norm, f_out, plan->size);
@@ -392,8 +615,7 @@ void srslte_dft_plan_free(srslte_dft_plan_t* plan)
     if (plan->out)
       fftwf_free(plan->out);
   }
-  if (plan->p)
-    fftwf_destroy_plan(plan->p);
+  dft_plan_release(plan->p);
   pthread_mutex_unlock(&fft_mutex);
   bzero(plan, sizeof(srslte_dft_plan_t));
 }
@@ -22,6 +22,7 @@
 #include "srslte/srslte.h"
 #include <complex.h>
 #include <math.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
@@ -35,6 +36,22 @@
 /* Uncomment next line for avoiding Guru DFT call */
 //#define AVOID_GURU
 
+/* Gain of the resource elements, the normalization of the guru plans is done by the OFDM object */
+static inline float ofdm_gain(const srslte_ofdm_t* q)
+{
+  return (q->fft_plan.norm) ? q->scale / sqrtf(q->cfg.symbol_sz) : q->scale;
+}
+
+/* Copies resource elements to or from the DFT buffer applying a gain */
+static inline void ofdm_copy_re(const cf_t* src, cf_t* dst, float gain, uint32_t nof_re)
+{
+  if (gain != 1.0f) {
+    srslte_vec_sc_prod_cfc(src, gain, dst, nof_re);
+  } else {
+    memcpy(dst, src, sizeof(cf_t) * nof_re);
+  }
+}
+
 static int ofdm_init_mbsfn_(srslte_ofdm_t* q, srslte_ofdm_cfg_t* cfg, srslte_dft_dir_t dir)
 {
 
@@ -55,7 +72,8 @@ static int ofdm_init_mbsfn_(srslte_ofdm_t* q, srslte_ofdm_cfg_t* cfg, srslte_dft
     q->cfg.symbol_sz = cfg->symbol_sz;
   } else {
     // Otherwise copy all parameters
-    q->cfg = *cfg;
+    q->cfg   = *cfg;
+    q->scale = 1.0f;
   }
 
   uint32_t    symbol_sz = q->cfg.symbol_sz;
@@ -380,12 +398,43 @@ void srslte_ofdm_rx_slot_ng(srslte_ofdm_t* q, cf_t* input, cf_t* output)
     input += SRSLTE_CP_ISNORM(cp) ? SRSLTE_CP_LEN_NORM(i, symbol_sz) : SRSLTE_CP_LEN_EXT(symbol_sz);
     input -= q->window_offset_n;
     srslte_dft_run_c(&q->fft_plan, input, q->tmp);
-    memcpy(output, &q->tmp[q->nof_guards], q->nof_re * sizeof(cf_t));
+    ofdm_copy_re(&q->tmp[q->nof_guards], output, q->scale, q->nof_re);
     input += symbol_sz;
     output += q->nof_re;
   }
 }
 
+#ifndef AVOID_GURU
+/* Copies the resource elements of a slot from the symbols transformed by the DFT, performing the FFT shift */
+static void ofdm_rx_slot_demap(srslte_ofdm_t* q, int slot_in_sf, const cf_t* tmp)
+{
+  uint32_t nof_symbols = q->nof_symbols;
+  uint32_t nof_re      = q->nof_re;
+  cf_t*    output      = q->cfg.out_buffer + slot_in_sf * nof_re * nof_symbols;
+  uint32_t symbol_sz   = q->cfg.symbol_sz;
+  float    gain        = ofdm_gain(q);
+  uint32_t dc          = (q->fft_plan.dc) ? 1 : 0;
+
+  for (int i = 0; i < nof_symbols; i++) {
+    // Perform FFT shift, applying the frequency domain window offset and the gain on the copied subcarriers only
+    if (q->window_offset_n) {
+      srslte_vec_prod_ccc(
+          &tmp[symbol_sz - nof_re / 2], &q->window_offset_buffer[symbol_sz - nof_re / 2], output, nof_re / 2);
+      srslte_vec_prod_ccc(&tmp[dc], &q->window_offset_buffer[dc], &output[nof_re / 2], nof_re / 2);
+      if (gain != 1.0f) {
+        srslte_vec_sc_prod_cfc(output, gain, output, nof_re);
+      }
+    } else {
+      ofdm_copy_re(&tmp[symbol_sz - nof_re / 2], output, gain, nof_re / 2);
+      ofdm_copy_re(&tmp[dc], &output[nof_re / 2], gain, nof_re / 2);
+    }
+
+    tmp += symbol_sz;
+    output += nof_re;
+  }
+}
+#endif /* AVOID_GURU */
+
 /* Transforms input samples into output OFDM symbols.
  * Performs FFT on a each symbol and removes CP.
  */
@@ -395,34 +444,8 @@ static void ofdm_rx_slot(srslte_ofdm_t* q, int slot_in_sf)
   srslte_ofdm_rx_slot_ng(
       q, q->cfg.in_buffer + slot_in_sf * q->slot_sz, q->cfg.out_buffer + slot_in_sf * q->nof_re * q->nof_symbols);
 #else
-  uint32_t nof_symbols = q->nof_symbols;
-  uint32_t nof_re = q->nof_re;
-  cf_t* output = q->cfg.out_buffer + slot_in_sf * nof_re * nof_symbols;
-  uint32_t symbol_sz = q->cfg.symbol_sz;
-  float norm = 1.0f / sqrtf(q->fft_plan.size);
-  cf_t* tmp = q->tmp;
-  uint32_t dc = (q->fft_plan.dc) ? 1 : 0;
-
   srslte_dft_run_guru_c(&q->fft_plan_sf[slot_in_sf]);
-
-  for (int i = 0; i < q->nof_symbols; i++) {
-    // Apply frequency domain window offset
-    if (q->window_offset_n) {
-      srslte_vec_prod_ccc(tmp, q->window_offset_buffer, tmp, symbol_sz);
-    }
-
-    // Perform FFT shift
-    memcpy(output, tmp + symbol_sz - nof_re / 2, sizeof(cf_t) * nof_re / 2);
-    memcpy(output + nof_re / 2, &tmp[dc], sizeof(cf_t) * nof_re / 2);
-
-    // Normalize output
-    if (q->fft_plan.norm) {
-      srslte_vec_sc_prod_cfc(output, norm, output, nof_re);
-    }
-
-    tmp += symbol_sz;
-    output += nof_re;
-  }
+  ofdm_rx_slot_demap(q, slot_in_sf, q->tmp);
 #endif
 }
 
@@ -435,7 +458,7 @@ static void ofdm_rx_slot_mbsfn(srslte_ofdm_t* q, cf_t* input, cf_t* output)
     }
     input += (i >= q->non_mbsfn_region) ? SRSLTE_CP_LEN_EXT(q->cfg.symbol_sz) : SRSLTE_CP_LEN_NORM(i, q->cfg.symbol_sz);
     srslte_dft_run_c(&q->fft_plan, input, q->tmp);
-    memcpy(output, &q->tmp[q->nof_guards], q->nof_re * sizeof(cf_t));
+    ofdm_copy_re(&q->tmp[q->nof_guards], output, q->scale, q->nof_re);
     input += q->cfg.symbol_sz;
     output += q->nof_re;
   }
@@ -448,8 +471,8 @@ void srslte_ofdm_rx_slot_zerocopy(srslte_ofdm_t* q, cf_t* input, cf_t* output)
     input +=
         SRSLTE_CP_ISNORM(q->cfg.cp) ? SRSLTE_CP_LEN_NORM(i, q->cfg.symbol_sz) : SRSLTE_CP_LEN_EXT(q->cfg.symbol_sz);
     srslte_dft_run_c_zerocopy(&q->fft_plan, input, q->tmp);
-    memcpy(output, &q->tmp[q->cfg.symbol_sz / 2 + q->nof_guards], sizeof(cf_t) * q->nof_re / 2);
-    memcpy(&output[q->nof_re / 2], &q->tmp[1], sizeof(cf_t) * q->nof_re / 2);
+    ofdm_copy_re(&q->tmp[q->cfg.symbol_sz / 2 + q->nof_guards], output, q->scale, q->nof_re / 2);
+    ofdm_copy_re(&q->tmp[1], &output[q->nof_re / 2], q->scale, q->nof_re / 2);
     input += q->cfg.symbol_sz;
     output += q->nof_re;
   }
@@ -486,57 +509,84 @@ void srslte_ofdm_rx_sf_ng(srslte_ofdm_t* q, cf_t* input, cf_t* output)
   }
 }
 
+#ifndef AVOID_GURU
+/* Copies the resource elements of a slot to the symbols transformed by the iDFT, performing the FFT shift. The guard
+ * subcarriers of the symbols are always zero, the gain is applied to the copied subcarriers only */
+static void ofdm_tx_slot_map(srslte_ofdm_t* q, int slot_in_sf, cf_t* tmp)
+{
+  uint32_t nof_symbols = q->nof_symbols;
+  uint32_t nof_re      = q->nof_re;
+  cf_t*    input       = q->cfg.in_buffer + slot_in_sf * nof_re * nof_symbols;
+  uint32_t symbol_sz   = q->cfg.symbol_sz;
+  float    gain        = ofdm_gain(q);
+  uint32_t dc          = (q->fft_plan.dc) ? 1 : 0;
+
+  for (int i = 0; i < nof_symbols; i++) {
+    ofdm_copy_re(&input[nof_re / 2], &tmp[dc], gain, nof_re / 2);
+    ofdm_copy_re(&input[0], &tmp[symbol_sz - nof_re / 2], gain, nof_re / 2);
+
+    input += nof_re;
+    tmp += symbol_sz;
+  }
+}
+
+/* Adds the CP to the symbols of a slot transformed by the iDFT */
+static void ofdm_tx_slot_cp(srslte_ofdm_t* q, int slot_in_sf)
+{
+  uint32_t    symbol_sz  = q->cfg.symbol_sz;
+  srslte_cp_t cp         = q->cfg.cp;
+  cf_t*       output     = q->cfg.out_buffer + slot_in_sf * q->slot_sz;
+  cf_t*       shift      = q->shift_buffer + slot_in_sf * q->slot_sz;
+  bool        freq_shift = isnormal(q->cfg.freq_shift_f);
+
+  for (int i = 0; i < q->nof_symbols; i++) {
+    int cp_len = SRSLTE_CP_ISNORM(cp) ? SRSLTE_CP_LEN_NORM(i, symbol_sz) : SRSLTE_CP_LEN_EXT(symbol_sz);
+
+    if (freq_shift) {
+      /* add CP and shift the frequency in the same pass, the CP is taken from the symbol before shifting it */
+      srslte_vec_prod_ccc(&output[symbol_sz], shift, output, cp_len);
+      srslte_vec_prod_ccc(&output[cp_len], &shift[cp_len], &output[cp_len], symbol_sz);
+      shift += symbol_sz + cp_len;
+    } else {
+      /* add CP */
+      memcpy(output, &output[symbol_sz], cp_len * sizeof(cf_t));
+    }
+    output += symbol_sz + cp_len;
+  }
+}
+#endif /* AVOID_GURU */
+
 /* Transforms input OFDM symbols into output samples.
  * Performs FFT on a each symbol and adds CP.
  */
 static void ofdm_tx_slot(srslte_ofdm_t* q, int slot_in_sf)
 {
+#ifdef AVOID_GURU
   uint32_t    symbol_sz = q->cfg.symbol_sz;
   srslte_cp_t cp        = q->cfg.cp;
 
-  cf_t* input  = q->cfg.in_buffer + slot_in_sf * q->nof_re * q->nof_symbols;
-  cf_t* output = q->cfg.out_buffer + slot_in_sf * q->slot_sz;
+  cf_t* input      = q->cfg.in_buffer + slot_in_sf * q->nof_re * q->nof_symbols;
+  cf_t* output     = q->cfg.out_buffer + slot_in_sf * q->slot_sz;
+  cf_t* shift      = q->shift_buffer + slot_in_sf * q->slot_sz;
+  bool  freq_shift = isnormal(q->cfg.freq_shift_f);
 
-#ifdef AVOID_GURU
   for (int i = 0; i < q->nof_symbols; i++) {
     int cp_len = SRSLTE_CP_ISNORM(cp) ? SRSLTE_CP_LEN_NORM(i, symbol_sz) : SRSLTE_CP_LEN_EXT(symbol_sz);
-    memcpy(&q->tmp[q->nof_guards], input, q->nof_re * sizeof(cf_t));
+    ofdm_copy_re(input, &q->tmp[q->nof_guards], q->scale, q->nof_re);
     srslte_dft_run_c(&q->fft_plan, q->tmp, &output[cp_len]);
     input += q->nof_re;
     /* add CP */
     memcpy(output, &output[symbol_sz], cp_len * sizeof(cf_t));
+    if (freq_shift) {
+      srslte_vec_prod_ccc(output, shift, output, symbol_sz + cp_len);
+      shift += symbol_sz + cp_len;
+    }
     output += symbol_sz + cp_len;
   }
 #else
-  uint32_t nof_symbols = q->nof_symbols;
-  uint32_t nof_re = q->nof_re;
-  float norm = 1.0f / sqrtf(symbol_sz);
-  cf_t* tmp = q->tmp;
-
-  bzero(tmp, q->slot_sz);
-  uint32_t dc = (q->fft_plan.dc) ? 1 : 0;
-
-  for (int i = 0; i < nof_symbols; i++) {
-    memcpy(&tmp[dc], &input[nof_re / 2], nof_re / 2 * sizeof(cf_t));
-    memcpy(&tmp[symbol_sz - nof_re / 2], &input[0], nof_re / 2 * sizeof(cf_t));
-
-    input += nof_re;
-    tmp += symbol_sz;
-  }
-
+  ofdm_tx_slot_map(q, slot_in_sf, q->tmp);
   srslte_dft_run_guru_c(&q->fft_plan_sf[slot_in_sf]);
-
-  for (int i = 0; i < nof_symbols; i++) {
-    int cp_len = SRSLTE_CP_ISNORM(cp) ? SRSLTE_CP_LEN_NORM(i, symbol_sz) : SRSLTE_CP_LEN_EXT(symbol_sz);
-
-    if (q->fft_plan.norm) {
-      srslte_vec_sc_prod_cfc(&output[cp_len], norm, &output[cp_len], symbol_sz);
-    }
-
-    /* add CP */
-    memcpy(output, &output[symbol_sz], cp_len * sizeof(cf_t));
-    output += symbol_sz + cp_len;
-  }
+  ofdm_tx_slot_cp(q, slot_in_sf);
 #endif
 }
 
@@ -546,7 +596,7 @@ void ofdm_tx_slot_mbsfn(srslte_ofdm_t* q, cf_t* input, cf_t* output)
 
   for (uint32_t i = 0; i < q->nof_symbols_mbsfn; i++) {
     int cp_len = (i > (q->non_mbsfn_region - 1)) ? SRSLTE_CP_LEN_EXT(symbol_sz) : SRSLTE_CP_LEN_NORM(i, symbol_sz);
-    memcpy(&q->tmp[q->nof_guards], input, q->nof_re * sizeof(cf_t));
+    ofdm_copy_re(input, &q->tmp[q->nof_guards], q->scale, q->nof_re);
     srslte_dft_run_c(&q->fft_plan, q->tmp, &output[cp_len]);
     input += q->nof_re;
     /* add CP */
@@ -557,6 +607,9 @@ void ofdm_tx_slot_mbsfn(srslte_ofdm_t* q, cf_t* input, cf_t* output)
     if (i == (q->non_mbsfn_region - 1))
       output += SRSLTE_NON_MBSFN_REGION_GUARD_LENGTH(q->non_mbsfn_region, symbol_sz);
   }
+
+  /* The guru iDFT expects zeros in the guard subcarriers of the temporal buffer */
+  srslte_vec_cf_zero(&q->tmp[q->nof_guards], q->nof_re);
 }
 
 void srslte_ofdm_set_normalize(srslte_ofdm_t* q, bool normalize_enable)
@@ -564,6 +617,11 @@ void srslte_ofdm_set_normalize(srslte_ofdm_t* q, bool normalize_enable)
   srslte_dft_plan_set_norm(&q->fft_plan, normalize_enable);
 }
 
+void srslte_ofdm_set_scale(srslte_ofdm_t* q, float scale)
+{
+  q->scale = scale;
+}
+
 void srslte_ofdm_tx_sf(srslte_ofdm_t* q)
 {
   uint32_t n;
@@ -574,8 +632,165 @@ void srslte_ofdm_tx_sf(srslte_ofdm_t* q)
   } else {
     ofdm_tx_slot_mbsfn(q, q->cfg.in_buffer, q->cfg.out_buffer);
     ofdm_tx_slot(q, 1);
+
+    // The frequency shift of the second slot is applied with its CP
+    if (isnormal(q->cfg.freq_shift_f)) {
+      srslte_vec_prod_ccc(q->cfg.out_buffer, q->shift_buffer, q->cfg.out_buffer, q->slot_sz);
+    }
   }
-  if (isnormal(q->cfg.freq_shift_f)) {
-    srslte_vec_prod_ccc(q->cfg.out_buffer, q->shift_buffer, q->cfg.out_buffer, q->sf_sz);
+}
+
+#ifndef AVOID_GURU
+/* Time domain buffer of an OFDM object, the output of Tx objects and the input of Rx objects */
+static cf_t* ofdm_time_buffer(const srslte_ofdm_t* q)
+{
+  return (q->fft_plan.dir == SRSLTE_DFT_BACKWARD) ? q->cfg.out_buffer : q->cfg.in_buffer;
+}
+#endif /* AVOID_GURU */
+
+int srslte_ofdm_group_init(srslte_ofdm_group_t* q, srslte_ofdm_t* const* ofdm, uint32_t nof_ofdm)
+{
+  if (q == NULL || ofdm == NULL || nof_ofdm == 0 || nof_ofdm > SRSLTE_OFDM_GROUP_MAX_SIZE) {
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+
+  srslte_dft_plan_free(&q->plan);
+  for (uint32_t i = 0; i < nof_ofdm; i++) {
+    q->ofdm[i] = ofdm[i];
+  }
+  q->nof_ofdm = nof_ofdm;
+
+#ifndef AVOID_GURU
+  // The objects share a plan if they have the same DFT configuration and their time domain buffers are one block
+  const srslte_ofdm_t* first  = ofdm[0];
+  cf_t*                buffer = ofdm_time_buffer(first);
+  ptrdiff_t            stride = (nof_ofdm > 1) ? ofdm_time_buffer(ofdm[1]) - buffer : (ptrdiff_t)first->sf_sz;
+  bool                 batch  = !first->mbsfn_subframe && stride >= (ptrdiff_t)first->sf_sz;
+  for (uint32_t i = 1; i < nof_ofdm && batch; i++) {
+    const srslte_ofdm_t* o = ofdm[i];
+    batch = o->fft_plan.dir == first->fft_plan.dir && o->cfg.symbol_sz == first->cfg.symbol_sz &&
+            o->cfg.cp == first->cfg.cp && o->window_offset_n == first->window_offset_n && !o->mbsfn_subframe &&
+            ofdm_time_buffer(o) == buffer + i * stride;
+  }
+  if (!batch) {
+    DEBUG("The %d OFDM objects of the group are processed one after the other\n", nof_ofdm);
+    return SRSLTE_SUCCESS;
+  }
+
+  uint32_t    symbol_sz   = first->cfg.symbol_sz;
+  uint32_t    nof_symbols = first->nof_symbols;
+  srslte_cp_t cp          = first->cfg.cp;
+  int         cp1         = SRSLTE_CP_ISNORM(cp) ? SRSLTE_CP_LEN_NORM(0, symbol_sz) : SRSLTE_CP_LEN_EXT(symbol_sz);
+  int         cp2         = SRSLTE_CP_ISNORM(cp) ? SRSLTE_CP_LEN_NORM(1, symbol_sz) : SRSLTE_CP_LEN_EXT(symbol_sz);
+
+  q->tmp_stride = SRSLTE_NOF_SLOTS_PER_SF * nof_symbols * symbol_sz;
+  if (nof_ofdm * q->tmp_stride > q->tmp_len) {
+    if (q->tmp) {
+      free(q->tmp);
+    }
+    q->tmp_len = nof_ofdm * q->tmp_stride;
+    q->tmp     = srslte_vec_cf_malloc(q->tmp_len);
+    if (!q->tmp) {
+      perror("malloc");
+      q->tmp_len = 0;
+      return SRSLTE_ERROR;
+    }
+  }
+
+  // Objects, slots and symbols of a subframe, from the outermost to the innermost set of DFTs
+  int how_many[3]  = {(int)nof_ofdm, SRSLTE_NOF_SLOTS_PER_SF, (int)nof_symbols};
+  int freq_dist[3] = {(int)q->tmp_stride, (int)(nof_symbols * symbol_sz), (int)symbol_sz};
+  int time_dist[3] = {(int)stride, (int)first->slot_sz, (int)symbol_sz + cp2};
+  int ret          = SRSLTE_ERROR;
+  if (first->fft_plan.dir == SRSLTE_DFT_BACKWARD) {
+    ret = srslte_dft_plan_guru_batch_c(
+        &q->plan, symbol_sz, SRSLTE_DFT_BACKWARD, q->tmp, buffer + cp1, 3, how_many, freq_dist, time_dist);
+  } else {
+    ret = srslte_dft_plan_guru_batch_c(&q->plan,
+                                       symbol_sz,
+                                       SRSLTE_DFT_FORWARD,
+                                       buffer + cp1 - first->window_offset_n,
+                                       q->tmp,
+                                       3,
+                                       how_many,
+                                       time_dist,
+                                       freq_dist);
+  }
+  if (ret) {
+    ERROR("Creating the DFT plan of %d OFDM objects\n", nof_ofdm);
+    return SRSLTE_ERROR;
+  }
+
+  // The guard subcarriers of the Tx symbols are never written
+  srslte_vec_cf_zero(q->tmp, q->tmp_len);
+#endif /* AVOID_GURU */
+
+  return SRSLTE_SUCCESS;
+}
+
+void srslte_ofdm_group_free(srslte_ofdm_group_t* q)
+{
+  if (q == NULL) {
+    return;
+  }
+  srslte_dft_plan_free(&q->plan);
+  if (q->tmp) {
+    free(q->tmp);
+  }
+  bzero(q, sizeof(srslte_ofdm_group_t));
+}
+
+void srslte_ofdm_tx_sf_batch(srslte_ofdm_group_t* q)
+{
+  if (!q->plan.size) {
+    for (uint32_t i = 0; i < q->nof_ofdm; i++) {
+      srslte_ofdm_tx_sf(q->ofdm[i]);
+    }
+    return;
+  }
+
+#ifndef AVOID_GURU
+  for (uint32_t i = 0; i < q->nof_ofdm; i++) {
+    srslte_ofdm_t* ofdm = q->ofdm[i];
+    for (uint32_t n = 0; n < SRSLTE_NOF_SLOTS_PER_SF; n++) {
+      ofdm_tx_slot_map(ofdm, n, q->tmp + i * q->tmp_stride + n * ofdm->nof_symbols * ofdm->cfg.symbol_sz);
+    }
+  }
+
+  srslte_dft_run_guru_c(&q->plan);
+
+  for (uint32_t i = 0; i < q->nof_ofdm; i++) {
+    for (uint32_t n = 0; n < SRSLTE_NOF_SLOTS_PER_SF; n++) {
+      ofdm_tx_slot_cp(q->ofdm[i], n);
+    }
+  }
+#endif /* AVOID_GURU */
+}
+
+void srslte_ofdm_rx_sf_batch(srslte_ofdm_group_t* q)
+{
+  if (!q->plan.size) {
+    for (uint32_t i = 0; i < q->nof_ofdm; i++) {
+      srslte_ofdm_rx_sf(q->ofdm[i]);
+    }
+    return;
   }
+
+#ifndef AVOID_GURU
+  for (uint32_t i = 0; i < q->nof_ofdm; i++) {
+    srslte_ofdm_t* ofdm = q->ofdm[i];
+    if (isnormal(ofdm->cfg.freq_shift_f)) {
+      srslte_vec_prod_ccc(ofdm->cfg.in_buffer, ofdm->shift_buffer, ofdm->cfg.in_buffer, ofdm->sf_sz);
+    }
+  }
+
+  srslte_dft_run_guru_c(&q->plan);
+
+  for (uint32_t i = 0; i < q->nof_ofdm; i++) {
+    srslte_ofdm_t* ofdm = q->ofdm[i];
+    for (uint32_t n = 0; n < SRSLTE_NOF_SLOTS_PER_SF; n++) {
+      ofdm_rx_slot_demap(ofdm, n, q->tmp + i * q->tmp_stride + n * ofdm->nof_symbols * ofdm->cfg.symbol_sz);
+    }
+  }
+#endif /* AVOID_GURU */
 }
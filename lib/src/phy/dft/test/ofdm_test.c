@@ -35,6 +35,8 @@ static int         nof_repetitions  = 1;
 static float       rx_window_offset = 0.5f;
 static float       freq_shift_f     = 0.0f;
 static uint32_t    force_symbol_sz  = 0;
+static uint32_t    nof_ports        = 1;
+static bool        separate_buffers = false;
 static double      elapsed_us(struct timeval* ts_start, struct timeval* ts_end)
 {
   if (ts_end->tv_usec > ts_start->tv_usec) {
@@ -55,12 +57,27 @@ static void usage(char* prog)
   printf("\t-r nof_repetitions [Default %d]\n", nof_repetitions);
   printf("\t-o rx window offset (portion of CP length) [Default %.1f]\n", rx_window_offset);
   printf("\t-s frequency shift (normalised with sampling rate) [Default %.1f]\n", freq_shift_f);
+  printf("\t-p number of ports, modulated with a different gain each [Default %d]\n", nof_ports);
+  printf("\t-i allocate the time domain buffers of the ports separately, instead of in one block\n");
+}
+
+/* Energy of the useful part of the OFDM symbols of a subframe, without the cyclic prefixes */
+static float symbols_energy(const cf_t* x, uint32_t symbol_sz)
+{
+  float energy = 0.0f;
+  for (uint32_t i = 0; i < SRSLTE_CP_NSYMB(cp) * SRSLTE_NOF_SLOTS_PER_SF; i++) {
+    uint32_t l = i % SRSLTE_CP_NSYMB(cp);
+    x += SRSLTE_CP_ISNORM(cp) ? SRSLTE_CP_LEN_NORM(l, symbol_sz) : SRSLTE_CP_LEN_EXT(symbol_sz);
+    energy += srslte_vec_avg_power_cf(x, symbol_sz) * symbol_sz;
+    x += symbol_sz;
+  }
+  return energy;
 }
 
 static void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "Nneros")) != -1) {
+  while ((opt = getopt(argc, argv, "Nnerospi")) != -1) {
     switch (opt) {
       case 'n':
         nof_prb = (int)strtol(argv[optind], NULL, 10);
@@ -80,6 +97,12 @@ static void parse_args(int argc, char** argv)
       case 's':
         freq_shift_f = SRSLTE_MIN(1.0f, SRSLTE_MAX(0.0f, strtof(argv[optind], NULL)));
         break;
+      case 'p':
+        nof_ports = SRSLTE_MIN(SRSLTE_MAX_PORTS, SRSLTE_MAX(1, (uint32_t)strtol(argv[optind], NULL, 10)));
+        break;
+      case 'i':
+        separate_buffers = true;
+        break;
       default:
         usage(argv[0]);
         exit(-1);
@@ -89,12 +112,14 @@ static void parse_args(int argc, char** argv)
 
 int main(int argc, char** argv)
 {
-  srslte_random_t random_gen = srslte_random_init(0);
-  struct timeval  start, end;
-  srslte_ofdm_t   fft = {}, ifft = {};
-  cf_t *          input, *outfft, *outifft;
-  float           mse;
-  uint32_t        n_prb, max_prb;
+  srslte_random_t     random_gen = srslte_random_init(0);
+  struct timeval      start, end;
+  srslte_ofdm_t       fft[SRSLTE_MAX_PORTS] = {}, ifft[SRSLTE_MAX_PORTS] = {};
+  srslte_ofdm_t *     fft_ptr[SRSLTE_MAX_PORTS], *ifft_ptr[SRSLTE_MAX_PORTS];
+  srslte_ofdm_group_t fft_group = {}, ifft_group = {};
+  cf_t *              input[SRSLTE_MAX_PORTS], *outfft[SRSLTE_MAX_PORTS], *outifft[SRSLTE_MAX_PORTS];
+  float               mse, gain_error;
+  uint32_t            n_prb, max_prb;
 
   parse_args(argc, argv);
 
@@ -113,34 +138,64 @@ int main(int argc, char** argv)
     printf("Running test for %d PRB, %d RE... ", n_prb, n_re);
     fflush(stdout);
 
-    input   = srslte_vec_cf_malloc(n_re);
-    outfft  = srslte_vec_cf_malloc(n_re);
-    outifft = srslte_vec_cf_malloc(sf_len);
-    if (!input || !outfft || !outifft) {
-      perror("malloc");
-      exit(-1);
+    // The time domain buffers of all the ports are one block, so that a single DFT plan transforms all of them
+    outifft[0] = srslte_vec_cf_malloc(sf_len * nof_ports);
+    for (uint32_t p = 0; p < nof_ports; p++) {
+      input[p]   = srslte_vec_cf_malloc(n_re);
+      outfft[p]  = srslte_vec_cf_malloc(n_re);
+      if (p > 0) {
+        outifft[p] = separate_buffers ? srslte_vec_cf_malloc(sf_len) : outifft[0] + p * sf_len;
+      }
+      if (!input[p] || !outfft[p] || !outifft[p]) {
+        perror("malloc");
+        exit(-1);
+      }
+      srslte_vec_cf_zero(outifft[p], sf_len);
+
+      srslte_ofdm_cfg_t ofdm_cfg = {};
+      ofdm_cfg.cp                = cp;
+      ofdm_cfg.in_buffer         = input[p];
+      ofdm_cfg.out_buffer        = outifft[p];
+      ofdm_cfg.nof_prb           = n_prb;
+      ofdm_cfg.symbol_sz         = symbol_sz;
+      ofdm_cfg.freq_shift_f      = freq_shift_f;
+      ofdm_cfg.normalize         = true;
+      if (srslte_ofdm_tx_init_cfg(&ifft[p], &ofdm_cfg)) {
+        ERROR("Error initializing iFFT\n");
+        exit(-1);
+      }
+
+      ofdm_cfg.in_buffer        = outifft[p];
+      ofdm_cfg.out_buffer       = outfft[p];
+      ofdm_cfg.rx_window_offset = rx_window_offset;
+      ofdm_cfg.freq_shift_f     = -freq_shift_f;
+      if (srslte_ofdm_rx_init_cfg(&fft[p], &ofdm_cfg)) {
+        ERROR("Error initializing FFT\n");
+        exit(-1);
+      }
+
+      // Every port but the first one has a gain, which is compensated in reception
+      if (p > 0) {
+        srslte_ofdm_set_scale(&ifft[p], (float)(p + 1));
+        srslte_ofdm_set_scale(&fft[p], 1.0f / (float)(p + 1));
+      }
+
+      // Generate Random data
+      srslte_random_uniform_complex_dist_vector(random_gen, input[p], n_re, -1.0f, +1.0f);
+
+      ifft_ptr[p] = &ifft[p];
+      fft_ptr[p]  = &fft[p];
     }
-    srslte_vec_cf_zero(outifft, sf_len);
-
-    srslte_ofdm_cfg_t ofdm_cfg = {};
-    ofdm_cfg.cp                = cp;
-    ofdm_cfg.in_buffer         = input;
-    ofdm_cfg.out_buffer        = outifft;
-    ofdm_cfg.nof_prb           = n_prb;
-    ofdm_cfg.symbol_sz         = symbol_sz;
-    ofdm_cfg.freq_shift_f      = freq_shift_f;
-    ofdm_cfg.normalize         = true;
-    if (srslte_ofdm_tx_init_cfg(&ifft, &ofdm_cfg)) {
-      ERROR("Error initializing iFFT\n");
+
+    if (srslte_ofdm_group_init(&ifft_group, ifft_ptr, nof_ports) ||
+        srslte_ofdm_group_init(&fft_group, fft_ptr, nof_ports)) {
+      ERROR("Error initializing OFDM groups\n");
       exit(-1);
     }
 
-    ofdm_cfg.in_buffer        = outifft;
-    ofdm_cfg.out_buffer       = outfft;
-    ofdm_cfg.rx_window_offset = rx_window_offset;
-    ofdm_cfg.freq_shift_f     = -freq_shift_f;
-    if (srslte_ofdm_rx_init_cfg(&fft, &ofdm_cfg)) {
-      ERROR("Error initializing FFT\n");
+    // Ports in one block share the DFT plan of their group
+    if ((ifft_group.plan.size != 0) == separate_buffers || (fft_group.plan.size != 0) == separate_buffers) {
+      printf("The DFT plan of the OFDM groups was %screated\n", separate_buffers ? "" : "not ");
       exit(-1);
     }
 
@@ -148,42 +203,62 @@ int main(int argc, char** argv)
       nof_repetitions = 1;
     }
 
-    // Generate Random data
-    srslte_random_uniform_complex_dist_vector(random_gen, input, n_re, -1.0f, +1.0f);
-
     // Execute Tx
     gettimeofday(&start, NULL);
     for (uint32_t i = 0; i < nof_repetitions; i++) {
-      srslte_ofdm_tx_sf(&ifft);
+      srslte_ofdm_tx_sf_batch(&ifft_group);
     }
     gettimeofday(&end, NULL);
-    printf(" Tx@%.1fMsps", (float)(sf_len * nof_repetitions) / elapsed_us(&start, &end));
+    printf(" Tx@%.1fMsps", (float)(sf_len * nof_ports * nof_repetitions) / elapsed_us(&start, &end));
 
     // Execute Rx
     gettimeofday(&start, NULL);
     for (uint32_t i = 0; i < nof_repetitions; i++) {
-      srslte_ofdm_rx_sf(&fft);
+      srslte_ofdm_rx_sf_batch(&fft_group);
     }
     gettimeofday(&end, NULL);
-    printf(" Rx@%.1fMsps", (double)(sf_len * nof_repetitions) / elapsed_us(&start, &end));
+    printf(" Rx@%.1fMsps", (double)(sf_len * nof_ports * nof_repetitions) / elapsed_us(&start, &end));
+
+    // The normalized iFFT keeps the energy of the resource elements, so the transmitted energy only depends on the gain
+    gain_error = 0.0f;
+    for (uint32_t p = 0; p < nof_ports; p++) {
+      float gain      = (float)(p + 1);
+      float re_energy = gain * gain * srslte_vec_avg_power_cf(input[p], n_re) * n_re;
+      float ratio     = symbols_energy(outifft[p], symbol_sz) / re_energy;
+      gain_error = SRSLTE_MAX(gain_error, fabsf(ratio - 1.0f));
+    }
 
     // compute Mean Square Error
-    srslte_vec_sub_ccc(input, outfft, outfft, n_re);
-    mse = sqrtf(srslte_vec_avg_power_cf(outfft, n_re));
+    mse = 0.0f;
+    for (uint32_t p = 0; p < nof_ports; p++) {
+      srslte_vec_sub_ccc(input[p], outfft[p], outfft[p], n_re);
+      mse = SRSLTE_MAX(mse, sqrtf(srslte_vec_avg_power_cf(outfft[p], n_re)));
+    }
 
-    printf(" MSE=%.6f\n", mse);
+    printf(" MSE=%.6f Tx gain error=%.6f\n", mse, gain_error);
 
     if (mse >= 0.0001) {
       printf("MSE too large\n");
       exit(-1);
     }
 
-    srslte_ofdm_rx_free(&fft);
-    srslte_ofdm_tx_free(&ifft);
+    if (gain_error >= 0.001) {
+      printf("Tx gain error too large\n");
+      exit(-1);
+    }
+
+    srslte_ofdm_group_free(&fft_group);
+    srslte_ofdm_group_free(&ifft_group);
+    for (uint32_t p = 0; p < nof_ports; p++) {
+      srslte_ofdm_rx_free(&fft[p]);
+      srslte_ofdm_tx_free(&ifft[p]);
 
-    free(input);
-    free(outfft);
-    free(outifft);
+      free(input[p]);
+      free(outfft[p]);
+      if (p == 0 || separate_buffers) {
+        free(outifft[p]);
+      }
+    }
 
     n_prb++;
   }
@@ -131,6 +131,7 @@ void srslte_enb_dl_free(srslte_enb_dl_t* q)
       srslte_ofdm_tx_free(&q->ifft[i]);
     }
     srslte_ofdm_tx_free(&q->ifft_mbsfn);
+    srslte_ofdm_group_free(&q->ifft_group);
     srslte_regs_free(&q->regs);
     srslte_pbch_free(&q->pbch);
     srslte_pcfich_free(&q->pcfich);
@@ -163,17 +164,29 @@ int srslte_enb_dl_set_cell(srslte_enb_dl_t* q, srslte_cell_t cell)
         ERROR("Error resizing REGs\n");
         return SRSLTE_ERROR;
       }
+      // TODO: PAPR control
+      float norm_factor = 0.05f / sqrtf(q->cell.nof_prb);
+
+      // The output gain is applied by the iFFT, while copying the resource elements
+      srslte_ofdm_t* ifft[SRSLTE_MAX_PORTS] = {};
       for (int i = 0; i < q->cell.nof_ports; i++) {
         if (srslte_ofdm_tx_set_prb(&q->ifft[i], q->cell.cp, q->cell.nof_prb)) {
           ERROR("Error re-planning iFFT (%d)\n", i);
           return SRSLTE_ERROR;
         }
+        srslte_ofdm_set_scale(&q->ifft[i], norm_factor);
+        ifft[i] = &q->ifft[i];
+      }
+      if (srslte_ofdm_group_init(&q->ifft_group, ifft, q->cell.nof_ports)) {
+        ERROR("Error grouping the iFFT of %d ports\n", q->cell.nof_ports);
+        return SRSLTE_ERROR;
       }
 
       if (srslte_ofdm_tx_set_prb(&q->ifft_mbsfn, SRSLTE_CP_EXT, q->cell.nof_prb)) {
         ERROR("Error re-planning ifft_mbsfn\n");
         return SRSLTE_ERROR;
       }
+      srslte_ofdm_set_scale(&q->ifft_mbsfn, norm_factor);
 
       srslte_ofdm_set_non_mbsfn_region(&q->ifft_mbsfn, 2);
 
@@ -407,23 +420,10 @@ int srslte_enb_dl_put_pmch(srslte_enb_dl_t* q, srslte_pmch_cfg_t* pmch_cfg, uint
 
 void srslte_enb_dl_gen_signal(srslte_enb_dl_t* q)
 {
-  // TODO: PAPR control
-  float norm_factor = 0.05f / sqrtf(q->cell.nof_prb);
-
   if (q->dl_sf.sf_type == SRSLTE_SF_MBSFN) {
     srslte_ofdm_tx_sf(&q->ifft_mbsfn);
-    srslte_vec_sc_prod_cfc(q->ifft_mbsfn.cfg.out_buffer,
-                           norm_factor,
-                           q->ifft_mbsfn.cfg.out_buffer,
-                           (uint32_t)SRSLTE_SF_LEN_PRB(q->cell.nof_prb));
   } else {
-    for (int i = 0; i < q->cell.nof_ports; i++) {
-      srslte_ofdm_tx_sf(&q->ifft[i]);
-      srslte_vec_sc_prod_cfc(q->ifft[i].cfg.out_buffer,
-                             norm_factor,
-                             q->ifft[i].cfg.out_buffer,
-                             (uint32_t)SRSLTE_SF_LEN_PRB(q->cell.nof_prb));
-    }
+    srslte_ofdm_tx_sf_batch(&q->ifft_group);
   }
 }
 
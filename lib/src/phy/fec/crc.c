@@ -23,9 +23,18 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "crc_pclmul.h"
 #include "srslte/phy/fec/crc.h"
 #include "srslte/phy/utils/bit.h"
 #include "srslte/phy/utils/debug.h"
+#include "srslte/phy/utils/simd_dispatch.h"
+#include "srslte/phy/utils/vector.h"
+
+// Shortest message, in bytes, for the carry-less multiply kernel, shorter ones are faster with slicing-by-8
+#define CRC_PCLMUL_MIN_LEN 64
+
+// Unpacked bits are packed and fed to the CRC in chunks of this number of bytes
+#define CRC_PACK_CHUNK 256
 
 void gen_crc_table(srslte_crc_t* h)
 {
@@ -45,6 +54,74 @@ void gen_crc_table(srslte_crc_t* h)
   }
 }
 
+/* Slicing-by-8 tables: slice_table[k][i] is i x^(32 + 8k) modulo the polynomial aligned to the MSB of 32 bits, so
+ * 8 bytes take 8 lookups */
+static void gen_crc_slice_table(srslte_crc_t* h)
+{
+  int shift = 32 - h->order;
+
+  for (int i = 0; i < 256; i++) {
+    h->slice_table[0][i] = (uint32_t)(h->table[i] << shift);
+  }
+  for (int k = 1; k < 8; k++) {
+    for (int i = 0; i < 256; i++) {
+      uint32_t crc         = h->slice_table[k - 1][i];
+      h->slice_table[k][i] = (crc << 8) ^ h->slice_table[0][crc >> 24];
+    }
+  }
+}
+
+/* x^n modulo the polynomial */
+static uint64_t crc_xpow_mod(srslte_crc_t* h, uint32_t n)
+{
+  uint64_t crc = 1;
+
+  for (uint32_t i = 0; i < n; i++) {
+    uint64_t bit = crc & h->crchighbit;
+    crc          = (crc << 1) & h->crcmask;
+    if (bit) {
+      crc ^= (uint64_t)h->polynom & h->crcmask;
+    }
+  }
+  return crc;
+}
+
+/* Adds len bytes to the CRC register crc, aligned to the MSB of 32 bits */
+static uint32_t crc_slice8(srslte_crc_t* h, uint32_t crc, const uint8_t* data, uint32_t len)
+{
+  const uint32_t(*t)[256] = h->slice_table;
+
+  for (; len >= 8; len -= 8, data += 8) {
+    uint32_t w0 = crc ^ ((uint32_t)data[0] << 24 | (uint32_t)data[1] << 16 | (uint32_t)data[2] << 8 | data[3]);
+    uint32_t w1 = (uint32_t)data[4] << 24 | (uint32_t)data[5] << 16 | (uint32_t)data[6] << 8 | data[7];
+
+    crc = t[7][w0 >> 24] ^ t[6][(w0 >> 16) & 0xff] ^ t[5][(w0 >> 8) & 0xff] ^ t[4][w0 & 0xff] ^ t[3][w1 >> 24] ^
+          t[2][(w1 >> 16) & 0xff] ^ t[1][(w1 >> 8) & 0xff] ^ t[0][w1 & 0xff];
+  }
+  for (; len > 0; len--, data++) {
+    crc = (crc << 8) ^ t[0][(crc >> 24) ^ *data];
+  }
+  return crc;
+}
+
+/* Adds len bytes to the CRC register crc, aligned to the MSB of 32 bits */
+static uint32_t crc_bytes(srslte_crc_t* h, uint32_t crc, const uint8_t* data, uint32_t len)
+{
+#ifdef SRSLTE_CRC_PCLMUL
+  if (h->pclmul && len >= CRC_PCLMUL_MIN_LEN) {
+    uint8_t  remainder[16];
+    uint32_t nof_blocks = len / 16;
+
+    srslte_crc_pclmul_fold(h->fold_k, crc, data, nof_blocks, remainder);
+
+    // The remainder block and the bytes left finish with the tables
+    crc = crc_slice8(h, 0, remainder, 16);
+    return crc_slice8(h, crc, data + 16 * nof_blocks, len % 16);
+  }
+#endif /* SRSLTE_CRC_PCLMUL */
+  return crc_slice8(h, crc, data, len);
+}
+
 uint64_t reversecrcbit(uint32_t crc, int nbits, srslte_crc_t* h)
 {
 
@@ -95,43 +172,56 @@ int srslte_crc_init(srslte_crc_t* h, uint32_t crc_poly, int crc_order)
 
   // generate lookup table
   gen_crc_table(h);
+  gen_crc_slice_table(h);
+
+  // Folding constants of the carry-less multiply kernel, for 1 and 4 blocks of 128 bits
+  h->fold_k[0] = crc_xpow_mod(h, 192);
+  h->fold_k[1] = crc_xpow_mod(h, 128);
+  h->fold_k[2] = crc_xpow_mod(h, 576);
+  h->fold_k[3] = crc_xpow_mod(h, 512);
+
+  h->pclmul = false;
+#ifdef SRSLTE_CRC_PCLMUL
+  __builtin_cpu_init();
+  h->pclmul = srslte_simd_isa() >= SRSLTE_SIMD_ISA_SSE && __builtin_cpu_supports("pclmul");
+#endif /* SRSLTE_CRC_PCLMUL */
 
   return 0;
 }
 
-uint32_t srslte_crc_checksum(srslte_crc_t* h, uint8_t* data, int len)
+const char* srslte_crc_kernel_string(srslte_crc_t* h)
 {
-  int      i, k, len8, res8, a = 0;
-  uint32_t crc = 0;
-  uint8_t* pter;
+  return h->pclmul ? "pclmul" : "slicing-by-8";
+}
 
-  srslte_crc_set_init(h, 0);
+uint32_t srslte_crc_checksum(srslte_crc_t* h, uint8_t* data, int len)
+{
+  uint8_t  packed[CRC_PACK_CHUNK];
+  int      shift = 32 - h->order;
+  int      len8  = len / 8;
+  int      res8  = len % 8;
+  uint32_t crc   = 0;
 
-  // Pack bits into bytes
-  len8 = (len >> 3);
-  res8 = (len - (len8 << 3));
-  if (res8 > 0) {
-    a = 1;
+  // Pack the bits in chunks that stay in cache and add them to the CRC
+  for (int i = 0; i < len8; i += CRC_PACK_CHUNK) {
+    int n = SRSLTE_MIN(len8 - i, CRC_PACK_CHUNK);
+    srslte_bit_pack_vector(&data[8 * i], packed, 8 * n);
+    crc = crc_bytes(h, crc, packed, (uint32_t)n);
   }
 
-  // Calculate CRC
-  for (i = 0; i < len8 + a; i++) {
-    pter = (uint8_t*)(data + 8 * i);
-    uint8_t byte;
-    if (i == len8) {
-      byte = 0x00;
-      for (k = 0; k < res8; k++) {
-        byte |= ((uint8_t) * (pter + k)) << (7 - k);
-      }
-    } else {
-      byte = (uint8_t)(srslte_bit_pack(&pter, 8) & 0xFF);
+  // The last bits are padded with zeros
+  if (res8 > 0) {
+    uint8_t byte = 0x00;
+    for (int k = 0; k < res8; k++) {
+      byte |= (uint8_t)(data[8 * len8 + k] << (7 - k));
     }
-    srslte_crc_checksum_put_byte(h, byte);
+    crc = crc_bytes(h, crc, &byte, 1);
   }
-  crc = (uint32_t)srslte_crc_checksum_get(h);
+  h->crcinit = (crc >> shift) & h->crcmask;
+  crc        = (uint32_t)srslte_crc_checksum_get(h);
 
   // Reverse CRC res8 positions
-  if (a == 1) {
+  if (res8 > 0) {
     crc = reversecrcbit(crc, 8 - res8, h);
   }
 
@@ -142,18 +232,11 @@ uint32_t srslte_crc_checksum(srslte_crc_t* h, uint8_t* data, int len)
 // len is multiple of 8
 uint32_t srslte_crc_checksum_byte(srslte_crc_t* h, uint8_t* data, int len)
 {
-  int      i;
-  uint32_t crc = 0;
+  uint32_t crc = crc_bytes(h, 0, data, (uint32_t)len / 8);
 
-  srslte_crc_set_init(h, 0);
+  h->crcinit = (crc >> (32 - h->order)) & h->crcmask;
 
-  // Calculate CRC
-  for (i = 0; i < len / 8; i++) {
-    srslte_crc_checksum_put_byte(h, data[i]);
-  }
-  crc = (uint32_t)srslte_crc_checksum_get(h);
-
-  return crc;
+  return (uint32_t)srslte_crc_checksum_get(h);
 }
 
 uint32_t srslte_crc_attach_byte(srslte_crc_t* h, uint8_t* data, int len)
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "crc_pclmul.h"
+
+#ifdef __PCLMUL__
+#include <immintrin.h>
+
+/* Multiplies the high and low halves of x by the high and low halves of k and adds them, which moves x forward by the
+ * distance k was computed for */
+static inline __m128i crc_pclmul_fold_128(__m128i x, __m128i k)
+{
+  return _mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x11), _mm_clmulepi64_si128(x, k, 0x00));
+}
+
+void srslte_crc_pclmul_fold(const uint64_t k[4],
+                            uint32_t       crc,
+                            const uint8_t* data,
+                            uint32_t       nof_blocks,
+                            uint8_t        remainder[16])
+{
+  // The first bit of the block is the MSB of the register, as the polynomials of the CRC are MSB first
+  const __m128i bswap = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+  const __m128i k1    = _mm_set_epi64x((long long)k[0], (long long)k[1]);
+  const __m128i k4    = _mm_set_epi64x((long long)k[2], (long long)k[3]);
+
+  __m128i x0 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i*)data), bswap);
+  x0         = _mm_xor_si128(x0, _mm_set_epi32((int)crc, 0, 0, 0));
+  data += 16;
+  nof_blocks--;
+
+  // Four independent accumulators hide the latency of the multiplier
+  if (nof_blocks >= 7) {
+    __m128i x1 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i*)(data + 0)), bswap);
+    __m128i x2 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i*)(data + 16)), bswap);
+    __m128i x3 = _mm_shuffle_epi8(_mm_loadu_si128((__m128i*)(data + 32)), bswap);
+    data += 48;
+    nof_blocks -= 3;
+
+    for (; nof_blocks >= 4; nof_blocks -= 4, data += 64) {
+      x0 = _mm_xor_si128(crc_pclmul_fold_128(x0, k4), _mm_shuffle_epi8(_mm_loadu_si128((__m128i*)(data + 0)), bswap));
+      x1 = _mm_xor_si128(crc_pclmul_fold_128(x1, k4), _mm_shuffle_epi8(_mm_loadu_si128((__m128i*)(data + 16)), bswap));
+      x2 = _mm_xor_si128(crc_pclmul_fold_128(x2, k4), _mm_shuffle_epi8(_mm_loadu_si128((__m128i*)(data + 32)), bswap));
+      x3 = _mm_xor_si128(crc_pclmul_fold_128(x3, k4), _mm_shuffle_epi8(_mm_loadu_si128((__m128i*)(data + 48)), bswap));
+    }
+
+    x0 = _mm_xor_si128(crc_pclmul_fold_128(x0, k1), x1);
+    x0 = _mm_xor_si128(crc_pclmul_fold_128(x0, k1), x2);
+    x0 = _mm_xor_si128(crc_pclmul_fold_128(x0, k1), x3);
+  }
+
+  for (; nof_blocks > 0; nof_blocks--, data += 16) {
+    x0 = _mm_xor_si128(crc_pclmul_fold_128(x0, k1), _mm_shuffle_epi8(_mm_loadu_si128((__m128i*)data), bswap));
+  }
+
+  _mm_storeu_si128((__m128i*)remainder, _mm_shuffle_epi8(x0, bswap));
+}
+
+#endif /* __PCLMUL__ */
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSLTE_CRC_PCLMUL_H
+#define SRSLTE_CRC_PCLMUL_H
+
+#include <stdint.h>
+
+#include "srslte/config.h"
+
+/* The carry-less multiply kernel is built if the compiler targets PCLMULQDQ. With ENABLE_SIMD_DISPATCH it is built in
+ * its own translation unit and only used if the CPU supports it */
+#if defined(__PCLMUL__) || (defined(SRSLTE_SIMD_DISPATCH) && defined(LV_HAVE_SSE))
+#define SRSLTE_CRC_PCLMUL
+#endif /* __PCLMUL__ || SRSLTE_SIMD_DISPATCH */
+
+/* Folds nof_blocks (at least 1) blocks of 16 bytes into a 16 byte block with the same remainder, which is written in
+ * remainder. The CRC register, aligned to the MSB, is added to the first bytes. k holds x^192, x^128, x^576 and x^512
+ * modulo the polynomial */
+void srslte_crc_pclmul_fold(const uint64_t k[4],
+                            uint32_t       crc,
+                            const uint8_t* data,
+                            uint32_t       nof_blocks,
+                            uint8_t        remainder[16]);
+
+#endif // SRSLTE_CRC_PCLMUL_H
@@ -30,8 +30,16 @@
 #include "srslte/phy/fec/rm_turbo.h"
 #include "srslte/phy/utils/bit.h"
 #include "srslte/phy/utils/debug.h"
+#include "srslte/phy/utils/simd_dispatch.h"
 #include "srslte/phy/utils/vector.h"
 
+/* 8-bit soft combining saturates, so that a retransmission can not flip the sign of the accumulated soft bits */
+static inline int8_t rm_turbo_sat_add_8(int8_t a, int16_t b)
+{
+  int32_t s = (int32_t)a + b;
+  return (int8_t)(s > 127 ? 127 : (s < -127 ? -127 : s));
+}
+
 #ifdef LV_HAVE_SSE
 #include <x86intrin.h>
 int srslte_rm_turbo_rx_lut_sse(int16_t*  input,
@@ -82,9 +90,15 @@ static bool                     rm_turbo_tables_generated = false;
 
 // Store deinterleaver version for sub-block turbo decoder
 #if SRSLTE_TDEC_EXPECT_INPUT_SB == 1
-// Prepare bit for sub-block decoder processing. These are the nof subblock sizes
+// Prepare bit for sub-block decoder processing. These are the nof subblock sizes, the AVX512 decoders may be selected
+// at runtime even if this file is not built for AVX512
+#ifdef SRSLTE_SIMD_KERNELS_AVX512
+#define NOF_DEINTER_TABLE_SB_IDX 4
+const static int deinter_table_sb_idx[NOF_DEINTER_TABLE_SB_IDX] = {8, 16, 32, 64};
+#else  /* SRSLTE_SIMD_KERNELS_AVX512 */
 #define NOF_DEINTER_TABLE_SB_IDX 3
 const static int deinter_table_sb_idx[NOF_DEINTER_TABLE_SB_IDX] = {8, 16, 32};
+#endif /* SRSLTE_SIMD_KERNELS_AVX512 */
 int              deinter_table_idx_from_sb_len(uint32_t nof_subblocks)
 {
   for (int i = 0; i < NOF_DEINTER_TABLE_SB_IDX; i++) {
@@ -97,11 +111,16 @@ int              deinter_table_idx_from_sb_len(uint32_t nof_subblocks)
   }
   return -1;
 }
-static uint16_t deinterleaver_sb[NOF_DEINTER_TABLE_SB_IDX][192][4][18448];
+// Generated on the first decoding of each code block length, see deinterleaver_sb_get()
+static uint16_t* deinterleaver_sb[NOF_DEINTER_TABLE_SB_IDX][SRSLTE_NOF_TC_CB_SIZES];
 #endif
 
 static uint16_t temp_table1[3 * 6176], temp_table2[3 * 6176];
 
+// Sorted positions of the dummy bits in the circular buffer
+static uint16_t rx_dummy_pos[SRSLTE_NOF_TC_CB_SIZES][3 * NCOLS];
+static uint32_t rx_nof_dummy[SRSLTE_NOF_TC_CB_SIZES];
+
 static void srslte_rm_turbo_gentable_systematic(uint16_t* table_bits, int k0_vec_[4][2], uint32_t nrows, int ndummy)
 {
 
@@ -174,6 +193,59 @@ srslte_rm_turbo_gentable_parity(uint16_t* table_parity, int k0_vec_[4][2], int o
   }
 }
 
+/* Tells whether position jp of the circular buffer holds a dummy bit */
+static bool srslte_rm_turbo_is_dummy(int jp, int nrows, int ndummy)
+{
+  int  K_p = nrows * NCOLS;
+  int  kidx;
+  int  d_i, d_j;
+  bool isdummy = false;
+
+  if (jp < K_p || !(jp % 2)) {
+    if (jp >= K_p) {
+      d_i = ((jp - K_p) / 2) / nrows;
+      d_j = ((jp - K_p) / 2) % nrows;
+    } else {
+      d_i = jp / nrows;
+      d_j = jp % nrows;
+    }
+    if (d_j * NCOLS + RM_PERM_TC[d_i] >= ndummy) {
+      isdummy = false;
+      if (d_j * NCOLS + RM_PERM_TC[d_i] - ndummy < 0) {
+        isdummy = true;
+      }
+    } else {
+      isdummy = true;
+    }
+
+  } else {
+    uint32_t jpp = (jp - K_p - 1) / 2;
+    kidx         = (RM_PERM_TC[jpp / nrows] + NCOLS * (jpp % nrows) + 1) % K_p;
+    if ((kidx - ndummy) < 0) {
+      isdummy = true;
+    } else {
+      isdummy = false;
+    }
+  }
+  return isdummy;
+}
+
+static void srslte_rm_turbo_gentable_dummy(uint16_t* dummy_pos, uint32_t* nof_dummy, uint32_t cb_len)
+{
+  int nrows  = (uint32_t)(cb_len / 3 - 1) / NCOLS + 1;
+  int ndummy = nrows * NCOLS - cb_len / 3;
+  if (ndummy < 0) {
+    ndummy = 0;
+  }
+
+  *nof_dummy = 0;
+  for (int jp = 0; jp < 3 * nrows * NCOLS; jp++) {
+    if (srslte_rm_turbo_is_dummy(jp, nrows, ndummy)) {
+      dummy_pos[(*nof_dummy)++] = (uint16_t)jp;
+    }
+  }
+}
+
 static void srslte_rm_turbo_gentable_receive(uint16_t* table, uint32_t cb_len, uint32_t rv_idx)
 {
 
@@ -187,42 +259,14 @@ static void srslte_rm_turbo_gentable_receive(uint16_t* table, uint32_t cb_len, u
   int N_cb = 3 * nrows * NCOLS;
   int k0   = nrows * (2 * (uint16_t)ceilf((float)N_cb / (float)(8 * nrows)) * rv_idx + 2);
 
-  int  kidx;
-  int  K_p = nrows * NCOLS;
-  int  k = 0, jp = 0, j = 0;
-  bool isdummy = false;
-  int  d_i, d_j;
+  int kidx;
+  int K_p = nrows * NCOLS;
+  int k = 0, jp = 0, j = 0;
+  int d_i, d_j;
   while (k < cb_len) {
     jp = (k0 + j) % N_cb;
 
-    if (jp < K_p || !(jp % 2)) {
-      if (jp >= K_p) {
-        d_i = ((jp - K_p) / 2) / nrows;
-        d_j = ((jp - K_p) / 2) % nrows;
-      } else {
-        d_i = jp / nrows;
-        d_j = jp % nrows;
-      }
-      if (d_j * NCOLS + RM_PERM_TC[d_i] >= ndummy) {
-        isdummy = false;
-        if (d_j * NCOLS + RM_PERM_TC[d_i] - ndummy < 0) {
-          isdummy = true;
-        }
-      } else {
-        isdummy = true;
-      }
-
-    } else {
-      uint32_t jpp = (jp - K_p - 1) / 2;
-      kidx         = (RM_PERM_TC[jpp / nrows] + NCOLS * (jpp % nrows) + 1) % K_p;
-      if ((kidx - ndummy) < 0) {
-        isdummy = true;
-      } else {
-        isdummy = false;
-      }
-    }
-
-    if (!isdummy) {
+    if (!srslte_rm_turbo_is_dummy(jp, nrows, ndummy)) {
       temp_table1[k] = jp % (3 * nrows * NCOLS);
       k++;
     }
@@ -264,6 +308,10 @@ static void interleave_table_sb(uint16_t* in, uint16_t* out, uint32_t cb_idx, ui
 {
   int long_cb = srslte_cbsegm_cbsize(cb_idx);
   int out_len = 3 * long_cb + 12;
+  if (long_cb < nof_sb) {
+    // Too short to be decoded by sub-blocks, the table is never used
+    return;
+  }
   for (int i = 0; i < out_len; i++) {
     // Do not change tail bit order
     if (in[i] < 3 * long_cb) {
@@ -306,26 +354,59 @@ void srslte_rm_turbo_gentables()
                                   interleaver_parity_bits[cb_idx],
                                   (uint32_t)(srslte_cbsegm_cbsize(cb_idx) + 4) * 2);
 
+      srslte_rm_turbo_gentable_dummy(rx_dummy_pos[cb_idx], &rx_nof_dummy[cb_idx], in_len);
       for (int i = 0; i < 4; i++) {
         srslte_rm_turbo_gentable_receive(deinterleaver[cb_idx][i], in_len, i);
 
-#if SRSLTE_TDEC_EXPECT_INPUT_SB == 1
-        for (uint32_t s = 0; s < NOF_DEINTER_TABLE_SB_IDX; s++) {
-          interleave_table_sb(
-              deinterleaver[cb_idx][i], deinterleaver_sb[s][cb_idx][i], cb_idx, deinter_table_sb_idx[s]);
-        }
-#endif
       }
     }
   }
 }
 
+#if SRSLTE_TDEC_EXPECT_INPUT_SB == 1
+/* Returns the sub-block deinterleaver of a code block length and redundancy version. A table for every sub-block size,
+ * code block length and redundancy version would take more than 28 MB per sub-block size, but a cell only decodes a
+ * few code block lengths with the sub-block sizes of one instruction set. The tables of a code block length are thus
+ * generated the first time it is decoded by sub-blocks and published with a compare-and-swap, so that the workers
+ * decoding in parallel never lock */
+static uint16_t* deinterleaver_sb_get(uint32_t idx, uint32_t cb_idx, uint32_t rv_idx)
+{
+  uint16_t* table = __atomic_load_n(&deinterleaver_sb[idx][cb_idx], __ATOMIC_ACQUIRE);
+  if (table == NULL) {
+    uint16_t* new_table = srslte_vec_u16_malloc(4 * 18448);
+    if (new_table == NULL) {
+      ERROR("Error allocating sub-block deinterleaver\n");
+      return NULL;
+    }
+    for (int i = 0; i < 4; i++) {
+      interleave_table_sb(deinterleaver[cb_idx][i], &new_table[i * 18448], cb_idx, deinter_table_sb_idx[idx]);
+    }
+    if (__atomic_compare_exchange_n(
+            &deinterleaver_sb[idx][cb_idx], &table, new_table, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+      table = new_table;
+    } else {
+      // Another worker published the same table first
+      free(new_table);
+    }
+  }
+  return &table[rv_idx * 18448];
+}
+#endif
+
 void srslte_rm_turbo_free_tables()
 {
   if (rm_turbo_tables_generated) {
     for (int i = 0; i < SRSLTE_NOF_TC_CB_SIZES; i++) {
       srslte_bit_interleaver_free(&bit_interleavers_systematic_bits[i]);
       srslte_bit_interleaver_free(&bit_interleavers_parity_bits[i]);
+#if SRSLTE_TDEC_EXPECT_INPUT_SB == 1
+      for (int s = 0; s < NOF_DEINTER_TABLE_SB_IDX; s++) {
+        if (deinterleaver_sb[s][i]) {
+          free(deinterleaver_sb[s][i]);
+          deinterleaver_sb[s][i] = NULL;
+        }
+      }
+#endif
     }
     rm_turbo_tables_generated = false;
   }
@@ -394,9 +475,381 @@ int srslte_rm_turbo_tx_lut(uint8_t* w_buff,
   }
 }
 
-int srslte_rm_turbo_rx_lut(int16_t* input, int16_t* output, uint32_t in_len, uint32_t cb_idx, uint32_t rv_idx)
+/*
+ * Rate dematching by transpositions.
+ *
+ * The received soft bits are first expanded into the circular buffer, adding up the repeated periods and leaving the
+ * dummy bits at zero. The sub-block interleaver of each stream is a 32-column matrix written by rows and read by
+ * columns, so it is undone by transposing 8x8 blocks. Then the soft bits are added to the output in the order the turbo
+ * decoder expects, which for the windowed decoders is another transposition. All the accesses are to contiguous rows
+ * and there is no scatter or gather per soft bit.
+ */
+
+/* Minimum number of received soft bits for which the transpositions are faster than scattering the soft bits, given
+ * the number of coded bits. The 8-bit scatter is slower, so the threshold is lower */
+#define RM_TURBO_RX_TRANSPOSE_MIN_LEN(out_len) ((3 * (out_len)) / 4)
+#define RM_TURBO_RX_TRANSPOSE_MIN_LEN_8BIT(out_len) ((out_len) / 2)
+
+#ifdef LV_HAVE_SSE
+static inline void rm_turbo_transpose_8x8(__m128i* m)
+{
+  __m128i a0 = _mm_unpacklo_epi16(m[0], m[1]);
+  __m128i a1 = _mm_unpackhi_epi16(m[0], m[1]);
+  __m128i a2 = _mm_unpacklo_epi16(m[2], m[3]);
+  __m128i a3 = _mm_unpackhi_epi16(m[2], m[3]);
+  __m128i a4 = _mm_unpacklo_epi16(m[4], m[5]);
+  __m128i a5 = _mm_unpackhi_epi16(m[4], m[5]);
+  __m128i a6 = _mm_unpacklo_epi16(m[6], m[7]);
+  __m128i a7 = _mm_unpackhi_epi16(m[6], m[7]);
+
+  __m128i b0 = _mm_unpacklo_epi32(a0, a2);
+  __m128i b1 = _mm_unpackhi_epi32(a0, a2);
+  __m128i b2 = _mm_unpacklo_epi32(a1, a3);
+  __m128i b3 = _mm_unpackhi_epi32(a1, a3);
+  __m128i b4 = _mm_unpacklo_epi32(a4, a6);
+  __m128i b5 = _mm_unpackhi_epi32(a4, a6);
+  __m128i b6 = _mm_unpacklo_epi32(a5, a7);
+  __m128i b7 = _mm_unpackhi_epi32(a5, a7);
+
+  m[0] = _mm_unpacklo_epi64(b0, b4);
+  m[1] = _mm_unpackhi_epi64(b0, b4);
+  m[2] = _mm_unpacklo_epi64(b1, b5);
+  m[3] = _mm_unpackhi_epi64(b1, b5);
+  m[4] = _mm_unpacklo_epi64(b2, b6);
+  m[5] = _mm_unpackhi_epi64(b2, b6);
+  m[6] = _mm_unpacklo_epi64(b3, b7);
+  m[7] = _mm_unpackhi_epi64(b3, b7);
+}
+
+// Splits 16 soft bits of the interlaced parity streams into 8 soft bits of each stream
+static inline void rm_turbo_load_parity(const int16_t* ptr, __m128i* v1, __m128i* v2)
+{
+  __m128i a = _mm_loadu_si128((__m128i*)ptr);
+  __m128i b = _mm_loadu_si128((__m128i*)&ptr[8]);
+  *v1       = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16), _mm_srai_epi32(_mm_slli_epi32(b, 16), 16));
+  *v2       = _mm_packs_epi32(_mm_srai_epi32(a, 16), _mm_srai_epi32(b, 16));
+}
+#endif /* LV_HAVE_SSE */
+
+/* Adds up the repetitions of the circular buffer into tmp, so that each coded bit is received once. Returns the folded
+ * soft bits, which are the input itself if there is nothing to fold */
+static const int16_t* rm_turbo_rx_fold(int16_t*       tmp,
+                                       const int16_t* input,
+                                       const int8_t*  input_8,
+                                       uint32_t       in_len,
+                                       uint32_t       out_len)
 {
-  return srslte_rm_turbo_rx_lut_(input, output, in_len, cb_idx, rv_idx, true);
+  if (input) {
+    if (in_len <= out_len) {
+      return input;
+    }
+    memcpy(tmp, input, sizeof(int16_t) * out_len);
+    for (uint32_t p = out_len; p < in_len; p += out_len) {
+      srslte_vec_sum_sss(tmp, &input[p], tmp, SRSLTE_MIN(out_len, in_len - p));
+    }
+  } else {
+    for (uint32_t p = 0; p < in_len; p += out_len) {
+      uint32_t n = SRSLTE_MIN(out_len, in_len - p);
+      uint32_t i = 0;
+#ifdef LV_HAVE_SSE
+      for (; i + 8 <= n; i += 8) {
+        __m128i x = _mm_cvtepi8_epi16(_mm_loadl_epi64((__m128i*)&input_8[p + i]));
+        if (p) {
+          x = _mm_add_epi16(_mm_loadu_si128((__m128i*)&tmp[i]), x);
+        }
+        _mm_storeu_si128((__m128i*)&tmp[i], x);
+      }
+#endif /* LV_HAVE_SSE */
+      for (; i < n; i++) {
+        tmp[i] = (p ? tmp[i] : 0) + input_8[p + i];
+      }
+    }
+  }
+  return tmp;
+}
+
+// Writes the folded soft bits into the circular buffer w, from k0 on and skipping the dummy bits, which are zero
+static void rm_turbo_rx_expand(int16_t* w, const int16_t* x, uint32_t len, uint32_t cb_idx, uint32_t rv_idx)
+{
+  uint32_t  nrows     = (srslte_cbsegm_cbsize(cb_idx) + 4 - 1) / NCOLS + 1;
+  uint32_t  N_cb      = 3 * nrows * NCOLS;
+  uint16_t* dummy_pos = rx_dummy_pos[cb_idx];
+  uint32_t  nof_dummy = rx_nof_dummy[cb_idx];
+
+  bzero(w, sizeof(int16_t) * N_cb);
+
+  uint32_t pos = k0_vec[cb_idx][rv_idx][0] % N_cb;
+  uint32_t d   = 0;
+  while (d < nof_dummy && dummy_pos[d] < pos) {
+    d++;
+  }
+
+  // Copy the soft bits in runs between dummy bits
+  uint32_t p = 0;
+  while (p < len) {
+    uint32_t end = d < nof_dummy ? dummy_pos[d] : N_cb;
+    uint32_t n   = SRSLTE_MIN(end - pos, len - p);
+    memcpy(&w[pos], &x[p], sizeof(int16_t) * n);
+    p += n;
+    pos += n;
+    if (pos == end && d < nof_dummy) {
+      pos++;
+      d++;
+    }
+    if (pos == N_cb) {
+      pos = 0;
+      d   = 0;
+    }
+  }
+}
+
+// Undoes the sub-block interleaver of the systematic stream, leaving the soft bits in y preceded by the dummy bits
+static void rm_turbo_rx_deinterleave_systematic(const int16_t* w, int16_t* y, uint32_t nrows)
+{
+  uint32_t r = 0;
+#ifdef LV_HAVE_SSE
+  __m128i m[8];
+  for (; r + 8 <= nrows; r += 8) {
+    for (uint32_t c = 0; c < NCOLS; c += 8) {
+      for (uint32_t k = 0; k < 8; k++) {
+        m[k] = _mm_loadu_si128((__m128i*)&w[RM_PERM_TC[c + k] * nrows + r]);
+      }
+      rm_turbo_transpose_8x8(m);
+      for (uint32_t k = 0; k < 8; k++) {
+        _mm_storeu_si128((__m128i*)&y[(r + k) * NCOLS + c], m[k]);
+      }
+    }
+  }
+#endif /* LV_HAVE_SSE */
+  for (; r < nrows; r++) {
+    for (uint32_t c = 0; c < NCOLS; c++) {
+      y[r * NCOLS + c] = w[RM_PERM_TC[c] * nrows + r];
+    }
+  }
+}
+
+/* Undoes the sub-block interleaver of the two parity streams, which are interlaced in the circular buffer. The second
+ * parity stream is permuted one bit later than the others */
+static void rm_turbo_rx_deinterleave_parity(const int16_t* w, int16_t* y1, int16_t* y2, uint32_t nrows)
+{
+  uint32_t       K_p = nrows * NCOLS;
+  const int16_t* v   = &w[K_p];
+
+  uint32_t r = 0;
+#ifdef LV_HAVE_SSE
+  __m128i m1[8], m2[8];
+  for (; r + 8 <= nrows; r += 8) {
+    for (uint32_t c = 0; c < NCOLS; c += 8) {
+      for (uint32_t k = 0; k < 8; k++) {
+        rm_turbo_load_parity(&v[2 * (RM_PERM_TC[c + k] * nrows + r)], &m1[k], &m2[k]);
+      }
+      rm_turbo_transpose_8x8(m1);
+      rm_turbo_transpose_8x8(m2);
+      for (uint32_t k = 0; k < 8; k++) {
+        _mm_storeu_si128((__m128i*)&y1[(r + k) * NCOLS + c], m1[k]);
+        _mm_storeu_si128((__m128i*)&y2[(r + k) * NCOLS + c + 1], m2[k]);
+      }
+    }
+  }
+#endif /* LV_HAVE_SSE */
+  for (; r < nrows; r++) {
+    for (uint32_t c = 0; c < NCOLS; c++) {
+      y1[r * NCOLS + c]     = v[2 * (RM_PERM_TC[c] * nrows + r)];
+      y2[r * NCOLS + c + 1] = v[2 * (RM_PERM_TC[c] * nrows + r) + 1];
+    }
+  }
+  y2[0] = y2[K_p];
+}
+
+/* Adds stream s to the output of the windowed decoders, which interleaves nof_sb sub-blocks of the code block. The
+ * four tail bits of every stream follow the three streams */
+static void rm_turbo_rx_add_sb(const int16_t* x, int16_t* output, uint32_t long_cb, uint32_t nof_sb, uint32_t s)
+{
+  uint32_t sb_len = long_cb / nof_sb;
+  int16_t* out    = &output[s * (long_cb + 32)];
+
+  uint32_t r = 0;
+#ifdef LV_HAVE_SSE
+  __m128i m[8];
+  for (; r + 8 <= sb_len; r += 8) {
+    for (uint32_t q = 0; q < nof_sb; q += 8) {
+      for (uint32_t k = 0; k < 8; k++) {
+        m[k] = _mm_loadu_si128((__m128i*)&x[(q + k) * sb_len + r]);
+      }
+      rm_turbo_transpose_8x8(m);
+      for (uint32_t k = 0; k < 8; k++) {
+        __m128i* ptr = (__m128i*)&out[(r + k) * nof_sb + q];
+        _mm_storeu_si128(ptr, _mm_add_epi16(_mm_loadu_si128(ptr), m[k]));
+      }
+    }
+  }
+#endif /* LV_HAVE_SSE */
+  for (; r < sb_len; r++) {
+    for (uint32_t q = 0; q < nof_sb; q++) {
+      out[r * nof_sb + q] += x[q * sb_len + r];
+    }
+  }
+
+  for (uint32_t i = 0; i < 4; i++) {
+    output[3 * (long_cb + 32) + 3 * i + s] += x[long_cb + i];
+  }
+}
+
+static void rm_turbo_rx_add_sb_8bit(const int16_t* x, int8_t* output, uint32_t long_cb, uint32_t nof_sb, uint32_t s)
+{
+  uint32_t sb_len = long_cb / nof_sb;
+  int8_t*  out    = &output[s * (long_cb + 32)];
+
+  uint32_t r = 0;
+#ifdef LV_HAVE_SSE
+  __m128i m[8];
+  __m128i min = _mm_set1_epi8(-127);
+  for (; r + 8 <= sb_len; r += 8) {
+    for (uint32_t q = 0; q < nof_sb; q += 8) {
+      for (uint32_t k = 0; k < 8; k++) {
+        m[k] = _mm_loadu_si128((__m128i*)&x[(q + k) * sb_len + r]);
+      }
+      rm_turbo_transpose_8x8(m);
+      for (uint32_t k = 0; k < 8; k++) {
+        __m128i* ptr = (__m128i*)&out[(r + k) * nof_sb + q];
+        __m128i  y   = _mm_adds_epi16(_mm_cvtepi8_epi16(_mm_loadl_epi64(ptr)), m[k]);
+        _mm_storel_epi64(ptr, _mm_max_epi8(_mm_packs_epi16(y, y), min));
+      }
+    }
+  }
+#endif /* LV_HAVE_SSE */
+  for (; r < sb_len; r++) {
+    for (uint32_t q = 0; q < nof_sb; q++) {
+      out[r * nof_sb + q] = rm_turbo_sat_add_8(out[r * nof_sb + q], x[q * sb_len + r]);
+    }
+  }
+
+  for (uint32_t i = 0; i < 4; i++) {
+    uint32_t idx = 3 * (long_cb + 32) + 3 * i + s;
+    output[idx]  = rm_turbo_sat_add_8(output[idx], x[long_cb + i]);
+  }
+}
+
+#ifdef LV_HAVE_SSE
+// Interleaves 8 soft bits of each stream into 24 consecutive soft bits
+static inline void rm_turbo_interleave_3x8(__m128i a, __m128i b, __m128i c, __m128i* out)
+{
+  const __m128i shuf0 = _mm_setr_epi8(0, 1, 0, 1, 0, 1, 2, 3, 2, 3, 2, 3, 4, 5, 4, 5);
+  const __m128i shuf1 = _mm_setr_epi8(4, 5, 6, 7, 6, 7, 6, 7, 8, 9, 8, 9, 8, 9, 10, 11);
+  const __m128i shuf2 = _mm_setr_epi8(10, 11, 10, 11, 12, 13, 12, 13, 12, 13, 14, 15, 14, 15, 14, 15);
+
+  out[0] = _mm_blend_epi16(_mm_blend_epi16(_mm_shuffle_epi8(a, shuf0), _mm_shuffle_epi8(b, shuf0), 0x92),
+                           _mm_shuffle_epi8(c, shuf0),
+                           0x24);
+  out[1] = _mm_blend_epi16(_mm_blend_epi16(_mm_shuffle_epi8(a, shuf1), _mm_shuffle_epi8(b, shuf1), 0x24),
+                           _mm_shuffle_epi8(c, shuf1),
+                           0x49);
+  out[2] = _mm_blend_epi16(_mm_blend_epi16(_mm_shuffle_epi8(a, shuf2), _mm_shuffle_epi8(b, shuf2), 0x49),
+                           _mm_shuffle_epi8(c, shuf2),
+                           0x92);
+}
+#endif /* LV_HAVE_SSE */
+
+// Adds the three streams to the output of the decoders that take them interleaved bit by bit
+static void rm_turbo_rx_add(int16_t* y[3], int16_t* output, uint32_t long_cb)
+{
+  uint32_t i = 0;
+#ifdef LV_HAVE_SSE
+  __m128i m[3];
+  for (; i + 8 <= long_cb + 4; i += 8) {
+    rm_turbo_interleave_3x8(_mm_loadu_si128((__m128i*)&y[0][i]),
+                            _mm_loadu_si128((__m128i*)&y[1][i]),
+                            _mm_loadu_si128((__m128i*)&y[2][i]),
+                            m);
+    for (uint32_t k = 0; k < 3; k++) {
+      __m128i* ptr = (__m128i*)&output[3 * i + 8 * k];
+      _mm_storeu_si128(ptr, _mm_add_epi16(_mm_loadu_si128(ptr), m[k]));
+    }
+  }
+#endif /* LV_HAVE_SSE */
+  for (; i < long_cb + 4; i++) {
+    output[3 * i] += y[0][i];
+    output[3 * i + 1] += y[1][i];
+    output[3 * i + 2] += y[2][i];
+  }
+}
+
+static void rm_turbo_rx_add_8bit(int16_t* y[3], int8_t* output, uint32_t long_cb)
+{
+  uint32_t i = 0;
+#ifdef LV_HAVE_SSE
+  __m128i m[3];
+  __m128i min = _mm_set1_epi8(-127);
+  for (; i + 8 <= long_cb + 4; i += 8) {
+    rm_turbo_interleave_3x8(_mm_loadu_si128((__m128i*)&y[0][i]),
+                            _mm_loadu_si128((__m128i*)&y[1][i]),
+                            _mm_loadu_si128((__m128i*)&y[2][i]),
+                            m);
+    for (uint32_t k = 0; k < 3; k++) {
+      __m128i* ptr = (__m128i*)&output[3 * i + 8 * k];
+      __m128i  z   = _mm_adds_epi16(_mm_cvtepi8_epi16(_mm_loadl_epi64(ptr)), m[k]);
+      _mm_storel_epi64(ptr, _mm_max_epi8(_mm_packs_epi16(z, z), min));
+    }
+  }
+#endif /* LV_HAVE_SSE */
+  for (; i < long_cb + 4; i++) {
+    output[3 * i]     = rm_turbo_sat_add_8(output[3 * i], y[0][i]);
+    output[3 * i + 1] = rm_turbo_sat_add_8(output[3 * i + 1], y[1][i]);
+    output[3 * i + 2] = rm_turbo_sat_add_8(output[3 * i + 2], y[2][i]);
+  }
+}
+
+/* Rate dematching of 16-bit (input, output) or 8-bit (input_8, output_8) soft bits. If nof_sb is not zero, the output
+ * is arranged for the windowed decoders of nof_sb sub-blocks */
+static void rm_turbo_rx_transpose(const int16_t* input,
+                                  const int8_t*  input_8,
+                                  int16_t*       output,
+                                  int8_t*        output_8,
+                                  uint32_t       in_len,
+                                  uint32_t       cb_idx,
+                                  uint32_t       rv_idx,
+                                  uint32_t       nof_sb,
+                                  int16_t*       scratch)
+{
+  // The reading of the parity streams may overflow the circular buffer by one soft bit
+  int16_t* w      = scratch;
+  int16_t* y_buff = &scratch[3 * 6176 + 1];
+
+  uint32_t long_cb = srslte_cbsegm_cbsize(cb_idx);
+  uint32_t out_len = 3 * long_cb + 12;
+  uint32_t nrows   = (long_cb + 4 - 1) / NCOLS + 1;
+  uint32_t ndummy  = nrows * NCOLS - (long_cb + 4);
+
+  // The folded soft bits are not needed after the expansion, so they share the buffer of the streams
+  const int16_t* x = rm_turbo_rx_fold(y_buff, input, input_8, in_len, out_len);
+  rm_turbo_rx_expand(w, x, SRSLTE_MIN(in_len, out_len), cb_idx, rv_idx);
+  rm_turbo_rx_deinterleave_systematic(w, y_buff, nrows);
+  rm_turbo_rx_deinterleave_parity(w, &y_buff[6176 + 1], &y_buff[2 * (6176 + 1)], nrows);
+
+  int16_t* y[3] = {&y_buff[ndummy], &y_buff[6176 + 1 + ndummy], &y_buff[2 * (6176 + 1) + ndummy]};
+  if (nof_sb) {
+    for (uint32_t s = 0; s < 3; s++) {
+      if (output) {
+        rm_turbo_rx_add_sb(y[s], output, long_cb, nof_sb, s);
+      } else {
+        rm_turbo_rx_add_sb_8bit(y[s], output_8, long_cb, nof_sb, s);
+      }
+    }
+  } else if (output) {
+    rm_turbo_rx_add(y, output, long_cb);
+  } else {
+    rm_turbo_rx_add_8bit(y, output_8, long_cb);
+  }
+}
+
+int srslte_rm_turbo_rx_lut(int16_t* input,
+                           int16_t* output,
+                           uint32_t in_len,
+                           uint32_t cb_idx,
+                           uint32_t rv_idx,
+                           int16_t* scratch)
+{
+  return srslte_rm_turbo_rx_lut_(input, output, in_len, cb_idx, rv_idx, true, scratch);
 }
 /**
  * Undoes rate matching for LTE Turbo Coder. Expands rate matched buffer to full size buffer.
@@ -405,6 +858,7 @@ int srslte_rm_turbo_rx_lut(int16_t* input, int16_t* output, uint32_t in_len, uin
  * @param[out] output Output buffer of size 3*srslte_cbsegm_cbsize(cb_idx)+12
  * @param[in] cb_idx Code block table index
  * @param[in] rv_idx Redundancy Version from DCI control message
+ * @param[in] scratch Buffer of SRSLTE_RM_TURBO_RX_SCRATCH_LEN soft bits for the transpositions, or NULL to scatter
  * @return Error code
  */
 int srslte_rm_turbo_rx_lut_(int16_t* input,
@@ -412,11 +866,13 @@ int srslte_rm_turbo_rx_lut_(int16_t* input,
                             uint32_t in_len,
                             uint32_t cb_idx,
                             uint32_t rv_idx,
-                            bool     enable_input_tdec)
+                            bool     enable_input_tdec,
+                            int16_t* scratch)
 {
 
   if (rv_idx < 4 && cb_idx < SRSLTE_NOF_TC_CB_SIZES) {
 
+    uint32_t nof_sb = 0;
 #if SRSLTE_TDEC_EXPECT_INPUT_SB == 1
     int       cb_len  = srslte_cbsegm_cbsize(cb_idx);
     int       idx     = deinter_table_idx_from_sb_len(srslte_tdec_autoimp_get_subblocks(cb_len));
@@ -424,7 +880,11 @@ int srslte_rm_turbo_rx_lut_(int16_t* input,
     if (idx < 0 || !enable_input_tdec) {
       deinter = deinterleaver[cb_idx][rv_idx];
     } else if (idx < NOF_DEINTER_TABLE_SB_IDX) {
-      deinter = deinterleaver_sb[idx][cb_idx][rv_idx];
+      deinter = deinterleaver_sb_get(idx, cb_idx, rv_idx);
+      nof_sb  = deinter_table_sb_idx[idx];
+      if (deinter == NULL) {
+        return SRSLTE_ERROR;
+      }
     } else {
       ERROR("Sub-block size index %d not supported in srslte_rm_turbo_rx_lut()\n", idx);
       return -1;
@@ -433,6 +893,13 @@ int srslte_rm_turbo_rx_lut_(int16_t* input,
     uint16_t* deinter = deinterleaver[cb_idx][rv_idx];
 #endif
 
+#ifdef LV_HAVE_SSE
+    if (scratch && in_len >= RM_TURBO_RX_TRANSPOSE_MIN_LEN(3 * srslte_cbsegm_cbsize(cb_idx) + 12)) {
+      rm_turbo_rx_transpose(input, NULL, output, NULL, in_len, cb_idx, rv_idx, nof_sb, scratch);
+      return 0;
+    }
+#endif
+
 #ifdef LV_HAVE_AVX
     return srslte_rm_turbo_rx_lut_avx(input, output, deinter, in_len, cb_idx, rv_idx);
 #else
@@ -453,10 +920,16 @@ int srslte_rm_turbo_rx_lut_(int16_t* input,
   }
 }
 
-int srslte_rm_turbo_rx_lut_8bit(int8_t* input, int8_t* output, uint32_t in_len, uint32_t cb_idx, uint32_t rv_idx)
+int srslte_rm_turbo_rx_lut_8bit(int8_t*  input,
+                                int8_t*  output,
+                                uint32_t in_len,
+                                uint32_t cb_idx,
+                                uint32_t rv_idx,
+                                int16_t* scratch)
 {
   if (rv_idx < 4 && cb_idx < SRSLTE_NOF_TC_CB_SIZES) {
 
+    uint32_t nof_sb = 0;
 #if SRSLTE_TDEC_EXPECT_INPUT_SB == 1
     int       cb_len  = srslte_cbsegm_cbsize(cb_idx);
     int       idx     = deinter_table_idx_from_sb_len(srslte_tdec_autoimp_get_subblocks_8bit(cb_len));
@@ -464,7 +937,11 @@ int srslte_rm_turbo_rx_lut_8bit(int8_t* input, int8_t* output, uint32_t in_len,
     if (idx < 0) {
       deinter = deinterleaver[cb_idx][rv_idx];
     } else if (idx < NOF_DEINTER_TABLE_SB_IDX) {
-      deinter = deinterleaver_sb[idx][cb_idx][rv_idx];
+      deinter = deinterleaver_sb_get(idx, cb_idx, rv_idx);
+      nof_sb  = deinter_table_sb_idx[idx];
+      if (deinter == NULL) {
+        return SRSLTE_ERROR;
+      }
     } else {
       ERROR("Sub-block size index %d not supported in srslte_rm_turbo_rx_lut()\n", idx);
       return -1;
@@ -477,12 +954,16 @@ int srslte_rm_turbo_rx_lut_8bit(int8_t* input, int8_t* output, uint32_t in_len,
     // Warning: Need to check if 8-bit sse version is correct
 
 #ifdef LV_HAVE_SSE
+    if (scratch && in_len >= RM_TURBO_RX_TRANSPOSE_MIN_LEN_8BIT(3 * srslte_cbsegm_cbsize(cb_idx) + 12)) {
+      rm_turbo_rx_transpose(NULL, input, NULL, output, in_len, cb_idx, rv_idx, nof_sb, scratch);
+      return 0;
+    }
     return srslte_rm_turbo_rx_lut_sse_8bit(input, output, deinter, in_len, cb_idx, rv_idx);
 #else
     uint32_t  out_len = 3 * srslte_cbsegm_cbsize(cb_idx) + 12;
 
     for (int i = 0; i < in_len; i++) {
-      output[deinter[i % out_len]] += input[i];
+      output[deinter[i % out_len]] = rm_turbo_sat_add_8(output[deinter[i % out_len]], input[i]);
     }
     return 0;
 #endif
@@ -586,12 +1067,12 @@ int srslte_rm_turbo_rx_lut_sse(int16_t*  input,
 #define SAVE_OUTPUT_SSE_8(j)                                                                                           \
   x = (int8_t)_mm_extract_epi8(xVal, j);                                                                               \
   l = (uint16_t)_mm_extract_epi16(lutVal1, j);                                                                         \
-  output[l] += x;
+  output[l] = rm_turbo_sat_add_8(output[l], x);
 
 #define SAVE_OUTPUT_SSE_8_2(j)                                                                                         \
   x = (int8_t)_mm_extract_epi8(xVal, j + 8);                                                                           \
   l = (uint16_t)_mm_extract_epi16(lutVal2, j);                                                                         \
-  output[l] += x;
+  output[l] = rm_turbo_sat_add_8(output[l], x);
 
 int srslte_rm_turbo_rx_lut_sse_8bit(int8_t*   input,
                                     int8_t*   output,
@@ -639,7 +1120,7 @@ int srslte_rm_turbo_rx_lut_sse_8bit(int8_t*   input,
         SAVE_OUTPUT_SSE_8_2(7);
       }
       for (int i = 16 * (in_len / 16); i < in_len; i++) {
-        output[deinter[i % out_len]] += input[i];
+        output[deinter[i % out_len]] = rm_turbo_sat_add_8(output[deinter[i % out_len]], input[i]);
       }
     } else {
       int intCnt   = 16;
@@ -677,12 +1158,12 @@ int srslte_rm_turbo_rx_lut_sse_8bit(int8_t*   input,
           /* Copy last elements */
           if ((out_len % 16) == 12) {
             for (int j = (nwrapps + 1) * out_len - 12; j < (nwrapps + 1) * out_len; j++) {
-              output[deinter[j % out_len]] += input[j];
+              output[deinter[j % out_len]] = rm_turbo_sat_add_8(output[deinter[j % out_len]], input[j]);
               inputCnt++;
             }
           } else {
             for (int j = (nwrapps + 1) * out_len - 4; j < (nwrapps + 1) * out_len; j++) {
-              output[deinter[j % out_len]] += input[j];
+              output[deinter[j % out_len]] = rm_turbo_sat_add_8(output[deinter[j % out_len]], input[j]);
               inputCnt++;
             }
           }
@@ -694,7 +1175,7 @@ int srslte_rm_turbo_rx_lut_sse_8bit(int8_t*   input,
         }
       }
       for (int i = inputCnt; i < in_len; i++) {
-        output[deinter[i % out_len]] += input[i];
+        output[deinter[i % out_len]] = rm_turbo_sat_add_8(output[deinter[i % out_len]], input[i]);
       }
     }
 
@@ -823,12 +1304,12 @@ int srslte_rm_turbo_rx_lut_avx(int16_t*  input,
 #define SAVE_OUTPUT8(j)                                                                                                \
   x = (int8_t)_mm256_extract_epi8(xVal, j);                                                                            \
   l = (uint16_t)_mm256_extract_epi16(lutVal1, j);                                                                      \
-  output[l] += x;
+  output[l] = rm_turbo_sat_add_8(output[l], x);
 
 #define SAVE_OUTPUT8_2(j)                                                                                              \
   x = (int8_t)_mm256_extract_epi8(xVal, j + 8);                                                                        \
   l = (uint16_t)_mm256_extract_epi16(lutVal2, j);                                                                      \
-  output[l] += x;
+  output[l] = rm_turbo_sat_add_8(output[l], x);
 
 int srslte_rm_turbo_rx_lut_avx_8bit(int8_t*   input,
                                     int8_t*   output,
@@ -894,7 +1375,7 @@ int srslte_rm_turbo_rx_lut_avx_8bit(int8_t*   input,
         SAVE_OUTPUT8_2(15);
       }
       for (int i = 32 * (in_len / 32); i < in_len; i++) {
-        output[deinter[i % out_len]] += input[i];
+        output[deinter[i % out_len]] = rm_turbo_sat_add_8(output[deinter[i % out_len]], input[i]);
       }
     } else {
       printf("wraps not implemented!\n");
@@ -952,7 +1433,7 @@ int srslte_rm_turbo_rx_lut_avx_8bit(int8_t*   input,
           printf("warning rate matching wrapping remainder %d\n", out_len % 32);
           /* Copy last elements */
           for (int j = (nwrapps + 1) * out_len - (out_len % 32); j < (nwrapps + 1) * out_len; j++) {
-            output[deinter[j % out_len]] += input[j];
+            output[deinter[j % out_len]] = rm_turbo_sat_add_8(output[deinter[j % out_len]], input[j]);
             inputCnt++;
           }
           /* And wrap pointers */
@@ -963,7 +1444,7 @@ int srslte_rm_turbo_rx_lut_avx_8bit(int8_t*   input,
         }
       }
       for (int i = inputCnt; i < in_len; i++) {
-        output[deinter[i % out_len]] += input[i];
+        output[deinter[i % out_len]] = rm_turbo_sat_add_8(output[deinter[i % out_len]], input[i]);
       }
 #endif
     }
@@ -38,7 +38,67 @@
 
 #define MAX_PDSCH_RE(cp) (2 * SRSLTE_CP_NSYMB(cp) * 12)
 
-int srslte_softbuffer_rx_init(srslte_softbuffer_rx_t* q, uint32_t nof_prb)
+int srslte_softbuffer_pool_init(srslte_softbuffer_pool_t* pool, uint32_t max_slabs)
+{
+  if (pool == NULL || max_slabs == 0) {
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+  bzero(pool, sizeof(srslte_softbuffer_pool_t));
+
+  pool->free_slabs = srslte_vec_malloc(sizeof(uint8_t*) * max_slabs);
+  if (!pool->free_slabs) {
+    perror("malloc");
+    return SRSLTE_ERROR;
+  }
+  pool->max_slabs = max_slabs;
+  pthread_mutex_init(&pool->mutex, NULL);
+
+  return SRSLTE_SUCCESS;
+}
+
+/* All the softbuffers using the pool must be freed before */
+void srslte_softbuffer_pool_free(srslte_softbuffer_pool_t* pool)
+{
+  if (pool && pool->free_slabs) {
+    if (pool->nof_free != pool->nof_slabs) {
+      ERROR("Freeing softbuffer pool with %d slabs in use\n", pool->nof_slabs - pool->nof_free);
+    }
+    for (uint32_t i = 0; i < pool->nof_free; i++) {
+      free(pool->free_slabs[i]);
+    }
+    free(pool->free_slabs);
+    pthread_mutex_destroy(&pool->mutex);
+    bzero(pool, sizeof(srslte_softbuffer_pool_t));
+  }
+}
+
+static uint8_t* softbuffer_pool_get(srslte_softbuffer_pool_t* pool)
+{
+  uint8_t* slab = NULL;
+
+  pthread_mutex_lock(&pool->mutex);
+  if (pool->nof_free > 0) {
+    pool->nof_free--;
+    slab = pool->free_slabs[pool->nof_free];
+  } else if (pool->nof_slabs < pool->max_slabs) {
+    slab = srslte_vec_u8_malloc(SOFTBUFFER_SLAB_SIZE);
+    if (slab) {
+      pool->nof_slabs++;
+    }
+  }
+  pthread_mutex_unlock(&pool->mutex);
+
+  return slab;
+}
+
+static void softbuffer_pool_put(srslte_softbuffer_pool_t* pool, uint8_t* slab)
+{
+  pthread_mutex_lock(&pool->mutex);
+  pool->free_slabs[pool->nof_free++] = slab;
+  pthread_mutex_unlock(&pool->mutex);
+}
+
+static int softbuffer_rx_init(srslte_softbuffer_rx_t* q, uint32_t nof_prb, srslte_softbuffer_pool_t* pool)
 {
   int ret = SRSLTE_ERROR_INVALID_INPUTS;
 
@@ -48,6 +108,7 @@ int srslte_softbuffer_rx_init(srslte_softbuffer_rx_t* q, uint32_t nof_prb)
     ret = srslte_ra_tbs_from_idx(SRSLTE_RA_NOF_TBS_IDX - 1, nof_prb);
     if (ret != SRSLTE_ERROR) {
       q->max_cb = (uint32_t)ret / (SRSLTE_TCOD_MAX_LEN_CB - 24) + 1;
+      q->pool   = pool;
       ret       = SRSLTE_ERROR;
 
       q->buffer_f = srslte_vec_malloc(sizeof(int16_t*) * q->max_cb);
@@ -55,12 +116,14 @@ int srslte_softbuffer_rx_init(srslte_softbuffer_rx_t* q, uint32_t nof_prb)
         perror("malloc");
         goto clean_exit;
       }
+      bzero(q->buffer_f, sizeof(int16_t*) * q->max_cb);
 
       q->data = srslte_vec_malloc(sizeof(uint8_t*) * q->max_cb);
       if (!q->data) {
         perror("malloc");
         goto clean_exit;
       }
+      bzero(q->data, sizeof(uint8_t*) * q->max_cb);
 
       q->cb_crc = srslte_vec_malloc(sizeof(bool) * q->max_cb);
       if (!q->cb_crc) {
@@ -70,7 +133,7 @@ int srslte_softbuffer_rx_init(srslte_softbuffer_rx_t* q, uint32_t nof_prb)
       bzero(q->cb_crc, sizeof(bool) * q->max_cb);
 
       // TODO: Use HARQ buffer limitation based on UE category
-      for (uint32_t i = 0; i < q->max_cb; i++) {
+      for (uint32_t i = 0; i < q->max_cb && !pool; i++) {
         q->buffer_f[i] = srslte_vec_i16_malloc(SOFTBUFFER_SIZE);
         if (!q->buffer_f[i]) {
           perror("malloc");
@@ -96,9 +159,69 @@ clean_exit:
   return ret;
 }
 
+int srslte_softbuffer_rx_init(srslte_softbuffer_rx_t* q, uint32_t nof_prb)
+{
+  return softbuffer_rx_init(q, nof_prb, NULL);
+}
+
+/* The code block buffers are taken from the pool the first time they are used, and given back on reset or release.
+ * They hold 8-bit soft bits, so they can only be decoded with an 8-bit decoder */
+int srslte_softbuffer_rx_init_pool(srslte_softbuffer_rx_t* q, uint32_t nof_prb, srslte_softbuffer_pool_t* pool)
+{
+  if (pool == NULL) {
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+  return softbuffer_rx_init(q, nof_prb, pool);
+}
+
+/* Makes sure the buffers of a code block exist. Returns error if the pool has run out of slabs */
+int srslte_softbuffer_rx_alloc_cb(srslte_softbuffer_rx_t* q, uint32_t cb_idx)
+{
+  if (cb_idx >= q->max_cb) {
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+  if (q->buffer_f[cb_idx]) {
+    return SRSLTE_SUCCESS;
+  }
+  if (!q->pool) {
+    return SRSLTE_ERROR;
+  }
+
+  uint8_t* slab = softbuffer_pool_get(q->pool);
+  if (!slab) {
+    ERROR("Softbuffer pool has run out of slabs (%d)\n", q->pool->max_slabs);
+    return SRSLTE_ERROR;
+  }
+  bzero(slab, SOFTBUFFER_SIZE * sizeof(int8_t));
+  q->buffer_f[cb_idx] = (int16_t*)slab;
+  q->data[cb_idx]     = &slab[SOFTBUFFER_SIZE];
+  q->cb_crc[cb_idx]   = false;
+
+  return SRSLTE_SUCCESS;
+}
+
+/* Gives the code block buffers back to the pool, e.g. once the transport block has been acknowledged. It does nothing
+ * if the buffers were allocated at init */
+void srslte_softbuffer_rx_release(srslte_softbuffer_rx_t* q)
+{
+  if (q->pool && q->buffer_f) {
+    for (uint32_t i = 0; i < q->max_cb; i++) {
+      if (q->buffer_f[i]) {
+        softbuffer_pool_put(q->pool, (uint8_t*)q->buffer_f[i]);
+        q->buffer_f[i] = NULL;
+        q->data[i]     = NULL;
+        q->cb_crc[i]   = false;
+      }
+    }
+  }
+}
+
 void srslte_softbuffer_rx_free(srslte_softbuffer_rx_t* q)
 {
   if (q) {
+    if (q->pool) {
+      srslte_softbuffer_rx_release(q);
+    }
     if (q->buffer_f) {
       for (uint32_t i = 0; i < q->max_cb; i++) {
         if (q->buffer_f[i]) {
@@ -135,7 +258,10 @@ void srslte_softbuffer_rx_reset(srslte_softbuffer_rx_t* q)
 
 void srslte_softbuffer_rx_reset_cb(srslte_softbuffer_rx_t* q, uint32_t nof_cb)
 {
-  if (q->buffer_f) {
+  if (q->pool) {
+    // The slabs are cleared when they are taken from the pool again
+    srslte_softbuffer_rx_release(q);
+  } else if (q->buffer_f) {
     if (nof_cb > q->max_cb) {
       nof_cb = q->max_cb;
     }
@@ -24,6 +24,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include <sys/time.h>
 #include <time.h>
 #include <unistd.h>
 
@@ -67,6 +68,73 @@ void parse_args(int argc, char** argv)
   }
 }
 
+/* Bit serial CRC of unpacked bits, the reference for the table and carry-less multiply kernels */
+static uint32_t crc_bitwise(const uint8_t* bits, int len)
+{
+  uint64_t mask = ((uint64_t)1 << crc_length) - 1;
+  uint64_t crc  = 0;
+
+  for (int i = 0; i < len; i++) {
+    uint64_t feedback = ((crc >> (crc_length - 1)) & 1) ^ bits[i];
+    crc               = (crc << 1) & mask;
+    if (feedback) {
+      crc ^= crc_poly & mask;
+    }
+  }
+  return (uint32_t)crc;
+}
+
+/* Checks the packed and unpacked CRC against the bit serial one for every length up to num_bits */
+static int test_lengths(srslte_crc_t* crc_p, uint8_t* data, uint8_t* packed)
+{
+  srslte_bit_pack_vector(data, packed, num_bits);
+
+  for (int len = 1; len <= num_bits; len += (len < 300) ? 1 : 37) {
+    uint32_t gold = crc_bitwise(data, len);
+    if (srslte_crc_checksum(crc_p, data, len) != gold) {
+      ERROR("Unpacked CRC of %d bits does not match\n", len);
+      return SRSLTE_ERROR;
+    }
+    if (len % 8 == 0 && srslte_crc_checksum_byte(crc_p, packed, len) != gold) {
+      ERROR("Packed CRC of %d bits does not match\n", len);
+      return SRSLTE_ERROR;
+    }
+  }
+  return SRSLTE_SUCCESS;
+}
+
+/* Measures the throughput of the packed and unpacked CRC of num_bits */
+static void benchmark(srslte_crc_t* crc_p, uint8_t* data, uint8_t* packed)
+{
+  struct timeval t[3];
+  uint32_t       nof_reps = 1 + 100000000 / num_bits;
+  int            len      = num_bits - num_bits % 8;
+
+  gettimeofday(&t[1], NULL);
+  for (uint32_t i = 0; i < nof_reps; i++) {
+    srslte_crc_checksum_byte(crc_p, packed, len);
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  double packed_gbps = (double)len / 8 * nof_reps / (t[0].tv_sec * 1e9 + t[0].tv_usec * 1e3);
+
+  nof_reps /= 8;
+  gettimeofday(&t[1], NULL);
+  for (uint32_t i = 0; i < nof_reps; i++) {
+    srslte_crc_checksum(crc_p, data, len);
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  double unpacked_gbps = (double)len / 8 * nof_reps / (t[0].tv_sec * 1e9 + t[0].tv_usec * 1e3);
+
+  printf("CRC%d 0x%x (%s): packed %.2f GB/s, unpacked %.2f GB/s\n",
+         crc_length,
+         crc_poly,
+         srslte_crc_kernel_string(crc_p),
+         packed_gbps,
+         unpacked_gbps);
+}
+
 int main(int argc, char** argv)
 {
   int          i;
@@ -100,6 +168,26 @@ int main(int argc, char** argv)
   // generate CRC word
   crc_word = srslte_crc_checksum(&crc_p, data, num_bits);
 
+  uint8_t* packed = srslte_vec_u8_malloc(num_bits / 8 + 1);
+  if (!packed) {
+    perror("malloc");
+    exit(-1);
+  }
+  if (test_lengths(&crc_p, data, packed)) {
+    exit(-1);
+  }
+  benchmark(&crc_p, data, packed);
+
+  // The tables are the fallback of the carry-less multiply kernel, test them too
+  if (crc_p.pclmul) {
+    crc_p.pclmul = false;
+    if (test_lengths(&crc_p, data, packed)) {
+      exit(-1);
+    }
+    benchmark(&crc_p, data, packed);
+  }
+
+  free(packed);
   free(data);
 
   // check if generated word is as expected
@@ -25,14 +25,16 @@
 #include <stdlib.h>
 #include <string.h>
 #include <strings.h>
+#include <sys/time.h>
 #include <time.h>
 #include <unistd.h>
 
 #include "srslte/srslte.h"
 
-uint32_t nof_e_bits = 0;
-uint32_t rv_idx     = 0;
-uint32_t cb_idx     = 0;
+uint32_t nof_e_bits      = 0;
+uint32_t rv_idx          = 0;
+uint32_t cb_idx          = 0;
+int      nof_repetitions = 100;
 
 uint8_t systematic[6148], parity[2 * 6148];
 uint8_t systematic_bytes[6148 / 8 + 1], parity_bytes[2 * 6148 / 8 + 1];
@@ -45,15 +47,22 @@ float   buff_f[BUFFSZ];
 float   bits_f[3 * 6144 + 12];
 short   bits2_s[3 * 6144 + 12];
 
+// Large enough for the output arranged for the windowed turbo decoders
+#define BITS3_SZ (3 * 6176 + 12)
+short  bits3_s[BITS3_SZ], bits4_s[BITS3_SZ];
+int8_t bits3_c[BITS3_SZ], bits4_c[BITS3_SZ];
+
+int16_t rm_scratch[SRSLTE_RM_TURBO_RX_SCRATCH_LEN];
+
 void usage(char* prog)
 {
-  printf("Usage: %s -c cb_idx -e nof_e_bits [-i rv_idx]\n", prog);
+  printf("Usage: %s -c cb_idx -e nof_e_bits [-i rv_idx] [-N nof_repetitions]\n", prog);
 }
 
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "cei")) != -1) {
+  while ((opt = getopt(argc, argv, "ceiN")) != -1) {
     switch (opt) {
       case 'c':
         cb_idx = (uint32_t)strtol(argv[optind], NULL, 10);
@@ -64,6 +73,9 @@ void parse_args(int argc, char** argv)
       case 'i':
         rv_idx = (uint32_t)strtol(argv[optind], NULL, 10);
         break;
+      case 'N':
+        nof_repetitions = (int)strtol(argv[optind], NULL, 10);
+        break;
       default:
         usage(argv[0]);
         exit(-1);
@@ -80,6 +92,7 @@ int main(int argc, char** argv)
   int      i;
   uint8_t *rm_bits, *rm_bits2, *rm_bits2_bytes;
   short*   rm_bits_s;
+  int8_t*  rm_bits_c;
   float*   rm_bits_f;
 
   parse_args(argc, argv);
@@ -91,6 +104,11 @@ int main(int argc, char** argv)
     perror("malloc");
     exit(-1);
   }
+  rm_bits_c = srslte_vec_i8_malloc(nof_e_bits);
+  if (!rm_bits_c) {
+    perror("malloc");
+    exit(-1);
+  }
   rm_bits_f = srslte_vec_f_malloc(nof_e_bits);
   if (!rm_bits_f) {
     perror("malloc");
@@ -170,30 +188,80 @@ int main(int argc, char** argv)
 
       printf("OK TX...");
 
+      // The transposed 8-bit path saturates once all the repetitions are added, so they must not saturate
+      int max_c = SRSLTE_MIN(5, 127 / ((nof_e_bits + long_cb_enc - 1) / long_cb_enc));
       for (int i = 0; i < nof_e_bits; i++) {
         rm_bits_f[i] = rand() % 10 - 5;
         rm_bits_s[i] = (short)rm_bits_f[i];
+        rm_bits_c[i] = (int8_t)(rand() % (2 * max_c + 1) - max_c);
       }
 
       srslte_vec_f_zero(buff_f, BUFFSZ);
       srslte_rm_turbo_rx(buff_f, BUFFSZ, rm_bits_f, nof_e_bits, bits_f, long_cb_enc, rv_idx, 0);
 
-      bzero(bits2_s, long_cb_enc * sizeof(short));
-      srslte_rm_turbo_rx_lut_(rm_bits_s, bits2_s, nof_e_bits, cb_idx, rv_idx, false);
+      // Without scratch the soft bits are scattered, with it they are transposed if enough of them are received
+      for (int k = 0; k < 2; k++) {
+        bzero(bits2_s, long_cb_enc * sizeof(short));
+        srslte_rm_turbo_rx_lut_(rm_bits_s, bits2_s, nof_e_bits, cb_idx, rv_idx, false, k ? rm_scratch : NULL);
 
-      for (int i = 0; i < long_cb_enc; i++) {
-        if (bits_f[i] != bits2_s[i]) {
-          printf("error RX in bit %d %f!=%d\n", i, bits_f[i], bits2_s[i]);
-          exit(-1);
+        for (int i = 0; i < long_cb_enc; i++) {
+          if (bits_f[i] != bits2_s[i]) {
+            printf("error RX %s in bit %d %f!=%d\n", k ? "transposed" : "scattered", i, bits_f[i], bits2_s[i]);
+            exit(-1);
+          }
         }
       }
 
-      printf("OK RX\n");
+      // Output arranged for the turbo decoder, which interleaves the sub-blocks of the windowed decoders
+      bzero(bits3_s, sizeof(bits3_s));
+      bzero(bits4_s, sizeof(bits4_s));
+      srslte_rm_turbo_rx_lut(rm_bits_s, bits3_s, nof_e_bits, cb_idx, rv_idx, NULL);
+      srslte_rm_turbo_rx_lut(rm_bits_s, bits4_s, nof_e_bits, cb_idx, rv_idx, rm_scratch);
+      if (memcmp(bits3_s, bits4_s, sizeof(bits3_s))) {
+        printf("error RX transposed for the turbo decoder\n");
+        exit(-1);
+      }
+
+      bzero(bits3_c, sizeof(bits3_c));
+      bzero(bits4_c, sizeof(bits4_c));
+      srslte_rm_turbo_rx_lut_8bit(rm_bits_c, bits3_c, nof_e_bits, cb_idx, rv_idx, NULL);
+      srslte_rm_turbo_rx_lut_8bit(rm_bits_c, bits4_c, nof_e_bits, cb_idx, rv_idx, rm_scratch);
+      if (memcmp(bits3_c, bits4_c, sizeof(bits3_c))) {
+        printf("error RX 8-bit transposed for the turbo decoder\n");
+        exit(-1);
+      }
+
+      printf("OK RX");
+
+      // Rate dematching speed, with the output arranged for the turbo decoder
+      if (nof_repetitions > 0) {
+        struct timeval t[3];
+
+        gettimeofday(&t[1], NULL);
+        for (int k = 0; k < nof_repetitions; k++) {
+          srslte_rm_turbo_rx_lut(rm_bits_s, bits3_s, nof_e_bits, cb_idx, rv_idx, rm_scratch);
+        }
+        gettimeofday(&t[2], NULL);
+        get_time_interval(t);
+        double ns_16bit = (t[0].tv_sec * 1e9 + t[0].tv_usec * 1e3) / nof_repetitions / nof_e_bits;
+
+        gettimeofday(&t[1], NULL);
+        for (int k = 0; k < nof_repetitions; k++) {
+          srslte_rm_turbo_rx_lut_8bit(rm_bits_c, bits3_c, nof_e_bits, cb_idx, rv_idx, rm_scratch);
+        }
+        gettimeofday(&t[2], NULL);
+        get_time_interval(t);
+        double ns_8bit = (t[0].tv_sec * 1e9 + t[0].tv_usec * 1e3) / nof_repetitions / nof_e_bits;
+
+        printf(" (16-bit: %.2f ns/bit, 8-bit: %.2f ns/bit)", ns_16bit, ns_8bit);
+      }
+      printf("\n");
     }
   }
 
   srslte_rm_turbo_free_tables();
   free(rm_bits_s);
+  free(rm_bits_c);
   free(rm_bits_f);
   free(rm_bits);
   free(rm_bits2);
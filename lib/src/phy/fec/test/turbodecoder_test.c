@@ -45,16 +45,51 @@ int nof_iterations  = MAX_ITERATIONS;
 int test_known_data = 0;
 int test_errors     = 0;
 int nof_repetitions = 1;
+int bench_all       = 0;
 
 srslte_tdec_impl_type_t tdec_type;
 
+typedef struct {
+  srslte_tdec_impl_type_t type;
+  const char*             name;
+} tdec_variant_t;
+
+// Decoder implementations available in this build
+static const tdec_variant_t tdec_variants[] = {{SRSLTE_TDEC_AUTO, "auto"},
+#ifdef HAVE_NEON
+                                               {SRSLTE_TDEC_NEON_WINDOW, "neon-window"},
+#else  /* HAVE_NEON */
+                                               {SRSLTE_TDEC_GENERIC, "generic"},
+#endif /* HAVE_NEON */
+#ifdef LV_HAVE_SSE
+                                               {SRSLTE_TDEC_SSE, "sse"},
+                                               {SRSLTE_TDEC_SSE_WINDOW, "sse-window"},
+                                               {SRSLTE_TDEC_SSE8_WINDOW, "sse8-window"},
+#endif /* LV_HAVE_SSE */
+#ifdef SRSLTE_SIMD_KERNELS_AVX2
+                                               {SRSLTE_TDEC_AVX_WINDOW, "avx-window"},
+                                               {SRSLTE_TDEC_AVX8_WINDOW, "avx8-window"},
+#endif /* SRSLTE_SIMD_KERNELS_AVX2 */
+#ifdef SRSLTE_SIMD_KERNELS_AVX512
+                                               {SRSLTE_TDEC_AVX512_WINDOW, "avx512-window"},
+                                               {SRSLTE_TDEC_AVX512_8_WINDOW, "avx512-8-window"},
+#endif /* SRSLTE_SIMD_KERNELS_AVX512 */
+};
+
+#define NOF_TDEC_VARIANTS (sizeof(tdec_variants) / sizeof(tdec_variant_t))
+
+static bool tdec_type_is_8bit(srslte_tdec_impl_type_t type)
+{
+  return type == SRSLTE_TDEC_SSE8_WINDOW || type == SRSLTE_TDEC_AVX8_WINDOW || type == SRSLTE_TDEC_AVX512_8_WINDOW;
+}
+
 #define SNR_POINTS 4
 #define SNR_MIN 1.0
 #define SNR_MAX 8.0
 
 void usage(char* prog)
 {
-  printf("Usage: %s [kcinNledts]\n", prog);
+  printf("Usage: %s [kcinNledtsa]\n", prog);
   printf("\t-k Test with known data (ignores frame_length) [Default disabled]\n");
   printf("\t-c nof_cb in parallel [Default %d]\n", nof_cb);
   printf("\t-i nof_iterations [Default %d]\n", nof_iterations);
@@ -62,15 +97,16 @@ void usage(char* prog)
   printf("\t-N nof_repetitions [Default %d]\n", nof_repetitions);
   printf("\t-l frame_length [Default %d]\n", frame_length);
   printf("\t-e ebno in dB [Default scan]\n");
-  printf("\t-d Decoder implementation type: 0: Generic, 1: SSE, 2: SSE-window\n");
-  printf("\t-t test: check errors on exit [Default disabled]\n");
+  printf("\t-d Decoder implementation type (srslte_tdec_impl_type_t) [Default 0: auto]\n");
+  printf("\t-t test: fail if any decoder has errors at the given ebno [Default disabled]\n");
   printf("\t-s seed [Default 0=time]\n");
+  printf("\t-a benchmark all decoder implementations (ignores -d) [Default disabled]\n");
 }
 
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "kcinNledts")) != -1) {
+  while ((opt = getopt(argc, argv, "kcinNledtsa")) != -1) {
     switch (opt) {
       case 'c':
         nof_cb = (int)strtol(argv[optind], NULL, 10);
@@ -105,6 +141,9 @@ void parse_args(int argc, char** argv)
       case 'v':
         srslte_verbose++;
         break;
+      case 'a':
+        bench_all = 1;
+        break;
       default:
         usage(argv[0]);
         exit(-1);
@@ -118,7 +157,7 @@ int main(int argc, char** argv)
   uint32_t        frame_cnt;
   float*          llr;
   short*          llr_s;
-  uint8_t*        llr_c;
+  int8_t*         llr_c;
   uint8_t *       data_tx, *data_rx, *data_rx_bytes, *symbols;
   uint32_t        i, j;
   float           var[SNR_POINTS];
@@ -182,7 +221,7 @@ int main(int argc, char** argv)
     perror("malloc");
     exit(-1);
   }
-  llr_c = srslte_vec_u8_malloc(coded_length);
+  llr_c = srslte_vec_i8_malloc(coded_length);
   if (!llr_c) {
     perror("malloc");
     exit(-1);
@@ -198,12 +237,6 @@ int main(int argc, char** argv)
 #else
   // tdec_type = SRSLTE_TDEC_SSE_WINDOW;
 #endif
-  if (srslte_tdec_init_manual(&tdec, frame_length, tdec_type)) {
-    ERROR("Error initiating Turbo decoder\n");
-    exit(-1);
-  }
-
-  srslte_tdec_force_not_sb(&tdec);
 
   float ebno_inc, esno_db;
   ebno_inc = (SNR_MAX - SNR_MIN) / SNR_POINTS;
@@ -219,70 +252,123 @@ int main(int argc, char** argv)
     var[0]     = srslte_convert_dB_to_amplitude(-esno_db);
     snr_points = 1;
   }
-  for (i = 0; i < snr_points; i++) {
-
-    mean_usec = 0;
-    errors    = 0;
-    frame_cnt = 0;
-    while (frame_cnt < nof_frames) {
-      /* generate data_tx */
-      for (j = 0; j < frame_length; j++) {
+  uint32_t nof_variants = bench_all ? NOF_TDEC_VARIANTS : 1;
+  uint32_t nof_failed   = 0;
+  for (uint32_t v = 0; v < nof_variants; v++) {
+    srslte_tdec_impl_type_t type       = bench_all ? tdec_variants[v].type : tdec_type;
+    bool                    is_8bit    = tdec_type_is_8bit(type);
+    double                  total_usec = 0;
+    uint32_t                total_bits = 0;
+
+    if (srslte_tdec_init_manual(&tdec, frame_length, type)) {
+      if (!bench_all) {
+        ERROR("Error initiating Turbo decoder\n");
+        exit(-1);
+      }
+      // The implementations built may need a higher instruction set than the one selected at runtime
+      printf("%-16s not supported by the %s instruction set\n",
+             tdec_variants[v].name,
+             srslte_simd_isa_string(srslte_simd_isa()));
+      continue;
+    }
+
+    srslte_tdec_force_not_sb(&tdec);
+
+    if (srslte_tdec_new_cb(&tdec, frame_length)) {
+      if (!bench_all) {
+        exit(-1);
+      }
+      printf("%-16s not supported for frame length %d\n", tdec_variants[v].name, frame_length);
+      srslte_tdec_free(&tdec);
+      continue;
+    }
+
+    for (i = 0; i < snr_points; i++) {
+
+      mean_usec = 0;
+      errors    = 0;
+      frame_cnt = 0;
+      while (frame_cnt < nof_frames) {
+        /* generate data_tx */
+        for (j = 0; j < frame_length; j++) {
+          if (test_known_data) {
+            data_tx[j] = known_data[j];
+          } else {
+            data_tx[j] = srslte_random_uniform_int_dist(random_gen, 0, 1);
+          }
+        }
+
+        /* coded BER */
         if (test_known_data) {
-          data_tx[j] = known_data[j];
+          for (j = 0; j < coded_length; j++) {
+            symbols[j] = known_data_encoded[j];
+          }
         } else {
-          data_tx[j] = srslte_random_uniform_int_dist(random_gen, 0, 1);
+          srslte_tcod_encode(&tcod, data_tx, symbols, frame_length);
         }
-      }
 
-      /* coded BER */
-      if (test_known_data) {
         for (j = 0; j < coded_length; j++) {
-          symbols[j] = known_data_encoded[j];
+          llr[j] = symbols[j] ? 1 : -1;
         }
-      } else {
-        srslte_tcod_encode(&tcod, data_tx, symbols, frame_length);
-      }
+        srslte_ch_awgn_f(llr, llr, var[i], coded_length);
 
-      for (j = 0; j < coded_length; j++) {
-        llr[j] = symbols[j] ? 1 : -1;
-      }
-      srslte_ch_awgn_f(llr, llr, var[i], coded_length);
+        for (j = 0; j < coded_length; j++) {
+          llr_s[j] = (int16_t)(100 * llr[j]);
+        }
+        // 8-bit decoders take saturated LLRs. Half the QPSK demodulator scale leaves headroom for the high SNR LLRs,
+        // which the decoders saturate on otherwise
+        srslte_vec_convert_fb(llr, 8, llr_c, coded_length);
 
-      for (j = 0; j < coded_length; j++) {
-        llr_s[j] = (int16_t)(100 * llr[j]);
-      }
+        /* decoder */
+        srslte_tdec_new_cb(&tdec, frame_length);
 
-      /* decoder */
-      srslte_tdec_new_cb(&tdec, frame_length);
+        uint32_t t;
+        if (nof_iterations == -1) {
+          t = MAX_ITERATIONS;
+        } else {
+          t = nof_iterations;
+        }
 
-      uint32_t t;
-      if (nof_iterations == -1) {
-        t = MAX_ITERATIONS;
-      } else {
-        t = nof_iterations;
+        gettimeofday(&tdata[1], NULL);
+        for (int k = 0; k < nof_repetitions; k++) {
+          if (is_8bit) {
+            srslte_tdec_run_all_8bit(&tdec, llr_c, data_rx_bytes, t, frame_length);
+          } else {
+            srslte_tdec_run_all(&tdec, llr_s, data_rx_bytes, t, frame_length);
+          }
+        }
+        gettimeofday(&tdata[2], NULL);
+        get_time_interval(tdata);
+        mean_usec = (tdata[0].tv_sec * 1e6 + tdata[0].tv_usec) / nof_repetitions;
+        total_usec += mean_usec;
+        total_bits += nof_cb * frame_length;
+
+        frame_cnt++;
+        uint32_t errors_this = 0;
+        srslte_bit_unpack_vector(data_rx_bytes, data_rx, frame_length);
+
+        errors_this = srslte_bit_diff(data_tx, data_rx, frame_length);
+        // printf("error[%d]=%d\n", cb, errors_this);
+        errors += errors_this;
+        printf("Eb/No: %2.2f %10d/%d   ", SNR_MIN + i * ebno_inc, frame_cnt, nof_frames);
+        printf("BER: %.2e  ", (float)errors / (nof_cb * frame_cnt * frame_length));
+        printf("%3.1f Mbps (%6.2f usec)", (float)(nof_cb * frame_length) / mean_usec, mean_usec);
+        printf("\r");
       }
+      printf("\n");
+    }
 
-      gettimeofday(&tdata[1], NULL);
-      for (int k = 0; k < nof_repetitions; k++) {
-        srslte_tdec_run_all(&tdec, llr_s, data_rx_bytes, t, frame_length);
-      }
-      gettimeofday(&tdata[2], NULL);
-      get_time_interval(tdata);
-      mean_usec = (tdata[0].tv_sec * 1e6 + tdata[0].tv_usec) / nof_repetitions;
-
-      frame_cnt++;
-      uint32_t errors_this = 0;
-      srslte_bit_unpack_vector(data_rx_bytes, data_rx, frame_length);
-
-      errors_this = srslte_bit_diff(data_tx, data_rx, frame_length);
-      // printf("error[%d]=%d\n", cb, errors_this);
-      errors += errors_this;
-      printf("Eb/No: %2.2f %10d/%d   ", SNR_MIN + i * ebno_inc, frame_cnt, nof_frames);
-      printf("BER: %.2e  ", (float)errors / (nof_cb * frame_cnt * frame_length));
-      printf("%3.1f Mbps (%6.2f usec)", (float)(nof_cb * frame_length) / mean_usec, mean_usec);
-      printf("\r");
+    if (bench_all) {
+      printf("%-16s %6.1f Mbps  BER: %.2e\n",
+             tdec_variants[v].name,
+             total_bits / total_usec,
+             (float)errors / (nof_cb * frame_cnt * frame_length));
+    }
+    if (test_errors && snr_points == 1 && errors) {
+      printf("%s: %d errors at Eb/No %.2f\n", bench_all ? tdec_variants[v].name : "decoder", errors / nof_cb, ebno_db);
+      nof_failed++;
     }
-    printf("\n");
+    srslte_tdec_free(&tdec);
   }
 
   printf("\n");
@@ -300,11 +386,14 @@ int main(int argc, char** argv)
   free(llr_s);
   free(data_rx);
 
-  srslte_tdec_free(&tdec);
   srslte_tcod_free(&tcod);
   srslte_random_free(random_gen);
 
   printf("\n");
+  if (nof_failed) {
+    printf("%d decoders failed\n", nof_failed);
+    exit(-1);
+  }
   printf("Done\n");
   exit(0);
 }
@@ -109,11 +109,18 @@ int main(int argc, char** argv)
   uint8_t * data_tx, *data_rx, *symbols;
   float     var[SNR_POINTS], varunc[SNR_POINTS];
   int       snr_points;
-  int       errors_s   = 0;
-  int       errors_us  = 0;
-  int       errors_c   = 0;
-  int       errors_f   = 0;
-  int       errors_sse = 0;
+  int       errors_s     = 0;
+  int       errors_us    = 0;
+  int       errors_c     = 0;
+  int       errors_f     = 0;
+  int       errors_sse   = 0;
+  int       errors_batch = 0;
+  float*    llr_batch[SRSLTE_VITERBI_MAX_BATCH]   = {};
+  uint8_t*  data_batch[SRSLTE_VITERBI_MAX_BATCH]  = {};
+  uint8_t*  data_single[SRSLTE_VITERBI_MAX_BATCH] = {};
+  double    t_single_us = 0, t_batch_us = 0;
+  uint32_t  nof_candidates = 0;
+  uint32_t  nof_mismatches = 0;
 #ifdef TEST_SSE
   srslte_viterbi_t dec_sse;
 #endif
@@ -136,7 +143,7 @@ int main(int argc, char** argv)
 
   cod.R        = 3;
   coded_length = cod.R * (frame_length + ((cod.tail_biting) ? 0 : cod.K - 1));
-  srslte_viterbi_init(&dec, SRSLTE_VITERBI_37, cod.poly, frame_length, cod.tail_biting);
+  srslte_viterbi_init_batch(&dec, SRSLTE_VITERBI_37, cod.poly, frame_length, cod.tail_biting);
   printf("Convolutional Code 1/3 K=%d Tail bitting: %s\n", cod.K, cod.tail_biting ? "yes" : "no");
 
 #ifdef TEST_SSE
@@ -185,6 +192,17 @@ int main(int argc, char** argv)
     perror("malloc");
     exit(-1);
   }
+  for (int b = 0; b < SRSLTE_VITERBI_MAX_BATCH; b++) {
+    llr_batch[b]   = srslte_vec_f_malloc(coded_length);
+    data_batch[b]  = srslte_vec_u8_malloc(frame_length);
+    data_single[b] = srslte_vec_u8_malloc(frame_length);
+    if (!llr_batch[b] || !data_batch[b] || !data_single[b]) {
+      perror("malloc");
+      exit(-1);
+    }
+  }
+  /* The noise of the batch has its own generator, so that the other decoders see the same frames as without it */
+  srslte_random_t random_batch = srslte_random_init(seed);
 
   float ebno_inc, esno_db;
   ebno_inc = (SNR_MAX - SNR_MIN) / SNR_POINTS;
@@ -204,11 +222,12 @@ int main(int argc, char** argv)
   }
 
   for (uint32_t i = 0; i < snr_points; i++) {
-    frame_cnt = 0;
-    errors_s   = 0;
-    errors_c   = 0;
-    errors_f   = 0;
-    errors_sse = 0;
+    frame_cnt    = 0;
+    errors_s     = 0;
+    errors_c     = 0;
+    errors_f     = 0;
+    errors_sse   = 0;
+    errors_batch = 0;
     while (frame_cnt < nof_frames) {
 
       /* generate data_tx */
@@ -245,6 +264,45 @@ int main(int argc, char** argv)
 #ifdef TEST_SSE
       VITERBI_TEST(srslte_viterbi_decode_uc, dec_sse, llr_c, errors_sse);
 #endif
+
+      /* Batch of candidates, like the PDCCH candidates of a DCI format: the first one is the frame decoded above, the
+       * others are other noise realizations. They are decoded one by one and in a batch, which must give the same bits.
+       * The batch size cycles through all the partial batches */
+      uint32_t nof_batch = SRSLTE_VITERBI_MAX_BATCH - frame_cnt % SRSLTE_VITERBI_MAX_BATCH;
+      srslte_vec_f_copy(llr_batch[0], llr, coded_length);
+      for (int b = 1; b < nof_batch; b++) {
+        for (int j = 0; j < coded_length; j++) {
+          llr_batch[b][j] = (symbols[j] ? M_SQRT2 : -M_SQRT2) + srslte_random_gauss_dist(random_batch, var[i]);
+        }
+      }
+      struct timeval t[3] = {};
+      gettimeofday(&t[1], NULL);
+      for (int b = 0; b < nof_batch; b++) {
+        srslte_viterbi_decode_f(&dec, llr_batch[b], data_single[b], frame_length);
+      }
+      gettimeofday(&t[2], NULL);
+      get_time_interval(t);
+      t_single_us += t[0].tv_sec * 1e6 + t[0].tv_usec;
+
+      gettimeofday(&t[1], NULL);
+      int ret = srslte_viterbi_decode_batch_f(&dec, llr_batch, data_batch, nof_batch, frame_length);
+      gettimeofday(&t[2], NULL);
+      get_time_interval(t);
+      t_batch_us += t[0].tv_sec * 1e6 + t[0].tv_usec;
+      nof_candidates += nof_batch;
+      if (ret < SRSLTE_SUCCESS) {
+        errors_batch = ret;
+      } else {
+        if (errors_batch >= 0) {
+          errors_batch += srslte_bit_diff(data_tx, data_batch[0], frame_length);
+        }
+        for (int b = 0; b < nof_batch; b++) {
+          if (memcmp(data_batch[b], data_single[b], frame_length) != 0) {
+            nof_mismatches++;
+          }
+        }
+      }
+
       frame_cnt++;
       printf("     Eb/No: %3.2f %10d/%d   ", SNR_MIN + i * ebno_inc, frame_cnt, nof_frames);
       if (errors_s >= 0)
@@ -258,6 +316,8 @@ int main(int argc, char** argv)
 #ifdef TEST_SSE
       printf("sse    BER: %.2e  ", (float)errors_sse / (frame_cnt * frame_length));
 #endif
+      if (errors_batch >= 0)
+        printf("batch  BER: %.2e  ", (float)errors_batch / (frame_cnt * frame_length));
       printf("\r\n");
     }
     printf("\n");
@@ -274,8 +334,16 @@ int main(int argc, char** argv)
 #ifdef TEST_SSE
       printf("sse    BER    :    %g\t%u errors\n", (float)errors_sse / (frame_cnt * frame_length), errors_sse);
 #endif
+      if (errors_batch >= 0)
+        printf("batch  BER    :    %g\t%u errors\n", (float)errors_batch / (frame_cnt * frame_length), errors_batch);
     }
   }
+  printf("Decoded %d candidates: %.1f candidates/ms one by one, %.1f candidates/ms in batches of up to %d\n",
+         nof_candidates,
+         nof_candidates * 1e3 / t_single_us,
+         nof_candidates * 1e3 / t_batch_us,
+         SRSLTE_VITERBI_MAX_BATCH);
+  printf("%d candidates decoded in a batch differ from the one by one decoder\n", nof_mismatches);
   srslte_viterbi_free(&dec);
 #ifdef TEST_SSE
   srslte_viterbi_free(&dec_sse);
@@ -288,6 +356,17 @@ int main(int argc, char** argv)
   free(llr_s);
   free(llr_us);
   free(data_rx);
+  for (int b = 0; b < SRSLTE_VITERBI_MAX_BATCH; b++) {
+    free(llr_batch[b]);
+    free(data_batch[b]);
+    free(data_single[b]);
+  }
+  srslte_random_free(random_batch);
+
+  if (nof_mismatches) {
+    ERROR("The batch decoder does not match srslte_viterbi_decode_f()\n");
+    exit(-1);
+  }
 
   if (snr_points == 1) {
     int expected_e = get_expected_errors(nof_frames, seed, frame_length, tail_biting, ebno_db);
@@ -295,14 +374,21 @@ int main(int argc, char** argv)
       ERROR("Test parameters not defined in test_results.h\n");
       exit(-1);
     } else {
-      printf(
-          "errors =(%d,%d,%d,%d,%d), expected =%d\n", errors_s, errors_us, errors_c, errors_f, errors_sse, expected_e);
+      printf("errors =(%d,%d,%d,%d,%d,%d), expected =%d\n",
+             errors_s,
+             errors_us,
+             errors_c,
+             errors_f,
+             errors_sse,
+             errors_batch,
+             expected_e);
       bool passed = true;
       passed &= (bool)(errors_us <= expected_e);
       passed &= (bool)(errors_s <= expected_e);
       passed &= (bool)(errors_c <= expected_e);
       passed &= (bool)(errors_f <= expected_e);
       passed &= (bool)(errors_sse <= expected_e);
+      passed &= (bool)(errors_batch <= expected_e);
       exit(!passed);
     }
   } else {
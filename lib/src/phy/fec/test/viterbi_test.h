@@ -48,6 +48,13 @@ static expected_errors_t expected_errors[] = {{1000, 1, 40, true, 0.0, 7282},
                                               {100, 1, 1000, true, 3.0, 110},
                                               {100, 1, 1000, true, 4.5, 5},
 
+                                              /* Terminated codes, bounded like the tail-biting ones */
+                                              {1000, 1, 40, false, 2.0, 725},
+                                              {1000, 1, 40, false, 4.5, 24},
+
+                                              {100, 1, 1000, false, 2.0, 939},
+                                              {100, 1, 1000, false, 4.5, 5},
+
                                               {-1, -1, -1, true, -1.0, -1}};
 
 #elif HAVE_NEON
@@ -67,6 +74,13 @@ static expected_errors_t expected_errors[] = {{1000, 1, 40, true, 0.0, 7282},
                                               {100, 1, 1000, true, 3.0, 110},
                                               {100, 1, 1000, true, 4.5, 5},
 
+                                              /* Terminated codes, bounded like the tail-biting ones */
+                                              {1000, 1, 40, false, 2.0, 725},
+                                              {1000, 1, 40, false, 4.5, 24},
+
+                                              {100, 1, 1000, false, 2.0, 939},
+                                              {100, 1, 1000, false, 4.5, 5},
+
                                               {-1, -1, -1, true, -1.0, -1}};
 
 #else
@@ -81,6 +95,13 @@ static expected_errors_t expected_errors[] = {{1000, 1, 40, true, 0.0, 5363},
                                               {100, 1, 1000, true, 3.0, 33},
                                               {100, 1, 1000, true, 4.5, 0},
 
+                                              /* Terminated codes, bounded like the tail-biting ones */
+                                              {1000, 1, 40, false, 2.0, 356},
+                                              {1000, 1, 40, false, 4.5, 0},
+
+                                              {100, 1, 1000, false, 2.0, 350},
+                                              {100, 1, 1000, false, 4.5, 0},
+
                                               {-1, -1, -1, true, -1.0, -1}};
 
 #endif
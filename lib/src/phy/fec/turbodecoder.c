@@ -22,9 +22,11 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <strings.h>
 
 #include "srslte/phy/fec/turbodecoder.h"
+#include "srslte/phy/utils/simd_dispatch.h"
 #include "srslte/phy/utils/vector.h"
 #include "srslte/srslte.h"
 
@@ -60,18 +62,6 @@ srslte_tdec_16bit_impl_t sse16_win_impl = {tdec_winsse16_init,
                                            tdec_winsse16_decision_byte};
 #endif
 
-/* AVX window implementation */
-#ifdef LV_HAVE_AVX2
-#define WINIMP_IS_AVX16
-#include "srslte/phy/fec/turbodecoder_win.h"
-#undef WINIMP_IS_AVX16
-srslte_tdec_16bit_impl_t avx16_win_impl = {tdec_winavx16_init,
-                                           tdec_winavx16_free,
-                                           tdec_winavx16_dec,
-                                           tdec_winavx16_extract_input,
-                                           tdec_winavx16_decision_byte};
-#endif
-
 /* SSE window implementation */
 #ifdef LV_HAVE_SSE
 #define WINIMP_IS_SSE8
@@ -85,17 +75,16 @@ srslte_tdec_8bit_impl_t sse8_win_impl = {tdec_winsse8_init,
                                          tdec_winsse8_decision_byte};
 #endif
 
-/* AVX window implementation */
-#ifdef LV_HAVE_AVX2
-#define WINIMP_IS_AVX8
-#include "srslte/phy/fec/turbodecoder_win.h"
-#undef WINIMP_IS_AVX8
-srslte_tdec_8bit_impl_t avx8_win_impl = {tdec_winavx8_init,
-                                         tdec_winavx8_free,
-                                         tdec_winavx8_dec,
-                                         tdec_winavx8_extract_input,
-                                         tdec_winavx8_decision_byte};
-#endif
+/* AVX2 and AVX512 window implementations, in turbodecoder_win_avx2.c and turbodecoder_win_avx512.c */
+#ifdef SRSLTE_SIMD_KERNELS_AVX2
+extern srslte_tdec_16bit_impl_t avx16_win_impl;
+extern srslte_tdec_8bit_impl_t  avx8_win_impl;
+#endif /* SRSLTE_SIMD_KERNELS_AVX2 */
+
+#ifdef SRSLTE_SIMD_KERNELS_AVX512
+extern srslte_tdec_16bit_impl_t avx512_16_win_impl;
+extern srslte_tdec_8bit_impl_t  avx512_8_win_impl;
+#endif /* SRSLTE_SIMD_KERNELS_AVX512 */
 
 #ifdef HAVE_NEON
 #define WINIMP_IS_NEON16
@@ -112,8 +101,10 @@ srslte_tdec_16bit_impl_t arm16_win_impl = {tdec_winarm16_init,
 #define AUTO_16_SSE 0
 #define AUTO_16_SSEWIN 1
 #define AUTO_16_AVXWIN 2
+#define AUTO_16_AVX512WIN 3
 #define AUTO_8_SSEWIN 0
 #define AUTO_8_AVXWIN 1
+#define AUTO_8_AVX512WIN 2
 #define AUTO_16_GEN 0
 #define AUTO_16_NEONWIN 1
 
@@ -126,6 +117,21 @@ srslte_tdec_16bit_impl_t arm16_win_impl = {tdec_winarm16_init,
 #include "srslte/phy/fec/turbodecoder_iter.h"
 #undef LLR_IS_16BIT
 
+/* Instruction set needed by a manual implementation */
+static srslte_simd_isa_t tdec_impl_isa(srslte_tdec_impl_type_t dec_type)
+{
+  switch (dec_type) {
+    case SRSLTE_TDEC_AVX512_WINDOW:
+    case SRSLTE_TDEC_AVX512_8_WINDOW:
+      return SRSLTE_SIMD_ISA_AVX512;
+    case SRSLTE_TDEC_AVX_WINDOW:
+    case SRSLTE_TDEC_AVX8_WINDOW:
+      return SRSLTE_SIMD_ISA_AVX2;
+    default:
+      return SRSLTE_SIMD_ISA_GENERIC;
+  }
+}
+
 int srslte_tdec_init(srslte_tdec_t* h, uint32_t max_long_cb)
 {
   return srslte_tdec_init_manual(h, max_long_cb, SRSLTE_TDEC_AUTO);
@@ -134,6 +140,8 @@ int srslte_tdec_init(srslte_tdec_t* h, uint32_t max_long_cb)
 uint32_t interleaver_idx(uint32_t nof_subblocks)
 {
   switch (nof_subblocks) {
+    case 64:
+      return 4;
     case 32:
       return 3;
     case 16:
@@ -185,7 +193,7 @@ int srslte_tdec_init_manual(srslte_tdec_t* h, uint32_t max_long_cb, srslte_tdec_
       h->current_llr_type = SRSLTE_TDEC_16;
       break;
 #endif /* HAVE_NEON */
-#ifdef LV_HAVE_AVX2
+#ifdef SRSLTE_SIMD_KERNELS_AVX2
     case SRSLTE_TDEC_AVX_WINDOW:
       h->dec16[0]         = &avx16_win_impl;
       h->current_llr_type = SRSLTE_TDEC_16;
@@ -194,12 +202,30 @@ int srslte_tdec_init_manual(srslte_tdec_t* h, uint32_t max_long_cb, srslte_tdec_
       h->dec8[0]          = &avx8_win_impl;
       h->current_llr_type = SRSLTE_TDEC_8;
       break;
-#endif /* LV_HAVE_AVX2 */
+#endif /* SRSLTE_SIMD_KERNELS_AVX2 */
+#ifdef SRSLTE_SIMD_KERNELS_AVX512
+    case SRSLTE_TDEC_AVX512_WINDOW:
+      h->dec16[0]         = &avx512_16_win_impl;
+      h->current_llr_type = SRSLTE_TDEC_16;
+      break;
+    case SRSLTE_TDEC_AVX512_8_WINDOW:
+      h->dec8[0]          = &avx512_8_win_impl;
+      h->current_llr_type = SRSLTE_TDEC_8;
+      break;
+#endif /* SRSLTE_SIMD_KERNELS_AVX512 */
     default:
       ERROR("Error decoder %d not supported\n", dec_type);
       goto clean_and_exit;
   }
 
+  // A manual implementation is built in but the CPU, or the instruction set selected at runtime, may not allow it
+  if (tdec_impl_isa(dec_type) > srslte_simd_isa()) {
+    ERROR("Error decoder %d not supported by the %s instruction set\n",
+          dec_type,
+          srslte_simd_isa_string(srslte_simd_isa()));
+    goto clean_and_exit;
+  }
+
   h->max_long_cb = max_long_cb;
 
   h->app1 = srslte_vec_i16_malloc(len);
@@ -242,6 +268,11 @@ int srslte_tdec_init_manual(srslte_tdec_t* h, uint32_t max_long_cb, srslte_tdec_
     perror("srslte_vec_malloc");
     goto clean_and_exit;
   }
+  h->prev_output = srslte_vec_u8_malloc(max_long_cb / 8 + 1);
+  if (!h->prev_output) {
+    perror("srslte_vec_malloc");
+    goto clean_and_exit;
+  }
 
   if (dec_type == SRSLTE_TDEC_AUTO) {
 #ifdef HAVE_NEON
@@ -251,10 +282,18 @@ int srslte_tdec_init_manual(srslte_tdec_t* h, uint32_t max_long_cb, srslte_tdec_
     h->dec16[AUTO_16_SSE]    = &gen_impl;
     h->dec16[AUTO_16_SSEWIN] = &sse16_win_impl;
     h->dec8[AUTO_8_SSEWIN]   = &sse8_win_impl;
-#ifdef LV_HAVE_AVX2
-    h->dec16[AUTO_16_AVXWIN] = &avx16_win_impl;
-    h->dec8[AUTO_8_AVXWIN]   = &avx8_win_impl;
-#endif /* LV_HAVE_AVX2 */
+#ifdef SRSLTE_SIMD_KERNELS_AVX2
+    if (srslte_simd_isa() >= SRSLTE_SIMD_ISA_AVX2) {
+      h->dec16[AUTO_16_AVXWIN] = &avx16_win_impl;
+      h->dec8[AUTO_8_AVXWIN]   = &avx8_win_impl;
+    }
+#endif /* SRSLTE_SIMD_KERNELS_AVX2 */
+#ifdef SRSLTE_SIMD_KERNELS_AVX512
+    if (srslte_simd_isa() >= SRSLTE_SIMD_ISA_AVX512) {
+      h->dec16[AUTO_16_AVX512WIN] = &avx512_16_win_impl;
+      h->dec8[AUTO_8_AVX512WIN]   = &avx512_8_win_impl;
+    }
+#endif /* SRSLTE_SIMD_KERNELS_AVX512 */
 #else  /* HAVE_NEON | LV_HAVE_SSE */
     h->dec16[AUTO_16_SSE]    = &gen_impl;
     h->dec16[AUTO_16_SSEWIN] = &gen_impl;
@@ -275,8 +314,8 @@ int srslte_tdec_init_manual(srslte_tdec_t* h, uint32_t max_long_cb, srslte_tdec_
       }
     }
 
-    // Compute 1 interleaver for each possible nof_subblocks (1, 8, 16 or 32)
-    for (int s = 0; s < 4; s++) {
+    // Compute 1 interleaver for each possible nof_subblocks (1, 8, 16, 32 or 64)
+    for (int s = 0; s < SRSLTE_TDEC_NOF_INTERLEAVERS; s++) {
       for (int i = 0; i < SRSLTE_NOF_TC_CB_SIZES; i++) {
         if (srslte_tc_interl_init(&h->interleaver[s][i], srslte_cbsegm_cbsize(i)) < 0) {
           goto clean_and_exit;
@@ -286,7 +325,7 @@ int srslte_tdec_init_manual(srslte_tdec_t* h, uint32_t max_long_cb, srslte_tdec_
     }
   } else {
     uint32_t nof_subblocks;
-    if (dec_type < SRSLTE_TDEC_SSE8_WINDOW) {
+    if (h->current_llr_type == SRSLTE_TDEC_16) {
       if ((h->nof_blocks16[0] = h->dec16[0]->tdec_init(&h->dec16_hdlr[0], h->max_long_cb)) < 0) {
         goto clean_and_exit;
       }
@@ -342,6 +381,9 @@ void srslte_tdec_free(srslte_tdec_t* h)
   if (h->input_conv) {
     free(h->input_conv);
   }
+  if (h->prev_output) {
+    free(h->prev_output);
+  }
 
   for (int td = 0; td < SRSLTE_TDEC_NOF_AUTO_MODES_8; td++) {
     if (h->dec8[td] && h->dec8_hdlr[td]) {
@@ -353,7 +395,7 @@ void srslte_tdec_free(srslte_tdec_t* h)
       h->dec16[td]->tdec_free(h->dec16_hdlr[td]);
     }
   }
-  for (int s = 0; s < 4; s++) {
+  for (int s = 0; s < SRSLTE_TDEC_NOF_INTERLEAVERS; s++) {
     for (int i = 0; i < SRSLTE_NOF_TC_CB_SIZES; i++) {
       srslte_tc_interl_free(&h->interleaver[s][i]);
     }
@@ -377,15 +419,51 @@ static void tdec_decision_byte(srslte_tdec_t* h, uint8_t* output)
   }
 }
 
+static uint32_t tdec_nof_changes(const uint8_t* x, const uint8_t* y, uint32_t len)
+{
+  uint32_t n = 0;
+  uint32_t i = 0;
+  for (; i + 8 <= len; i += 8) {
+    uint64_t a, b;
+    memcpy(&a, &x[i], sizeof(uint64_t));
+    memcpy(&b, &y[i], sizeof(uint64_t));
+    n += __builtin_popcountll(a ^ b);
+  }
+  for (; i < len; i++) {
+    n += __builtin_popcount(x[i] ^ y[i]);
+  }
+  return n;
+}
+
+/* Counts the consecutive half-iterations that have not changed fewer bits of the hard decision than any half-iteration
+ * before, given the hard decision output of the last one. While the decoder converges the changes decrease steadily;
+ * otherwise they stall, and so does a decision that does not change anymore. It must be called after every
+ * half-iteration of the code block to track it, so only the callers that give up code blocks pay for it */
+uint32_t srslte_tdec_update_stalled(srslte_tdec_t* h, uint8_t* output)
+{
+  uint32_t len = h->current_long_cb / 8;
+  if (h->n_iter > 1) {
+    uint32_t n = tdec_nof_changes(output, h->prev_output, len);
+    if (n < h->min_changes) {
+      h->min_changes = n;
+      h->nof_stalled = 0;
+    } else {
+      h->nof_stalled++;
+    }
+  }
+  memcpy(h->prev_output, output, len);
+  return h->nof_stalled;
+}
+
 /* Returns number of subblocks in automatic mode for this long_cb */
 uint32_t srslte_tdec_autoimp_get_subblocks(uint32_t long_cb)
 {
-#ifdef LV_HAVE_AVX2
-  if (!(long_cb % 16) && long_cb > 800) {
+  srslte_simd_isa_t isa = srslte_simd_isa();
+  if (isa >= SRSLTE_SIMD_ISA_AVX512 && !(long_cb % 32) && long_cb > 2048) {
+    return 32;
+  } else if (isa >= SRSLTE_SIMD_ISA_AVX2 && !(long_cb % 16) && long_cb > 800) {
     return 16;
-  } else
-#endif
-      if (!(long_cb % 8) && long_cb > 400) {
+  } else if (!(long_cb % 8) && long_cb > 400) {
     return 8;
   } else {
     return 0;
@@ -396,6 +474,8 @@ static int tdec_sb_idx(uint32_t long_cb)
 {
   uint32_t nof_sb = srslte_tdec_autoimp_get_subblocks(long_cb);
   switch (nof_sb) {
+    case 32:
+      return AUTO_16_AVX512WIN;
     case 16:
       return AUTO_16_AVXWIN;
     case 8:
@@ -409,12 +489,12 @@ static int tdec_sb_idx(uint32_t long_cb)
 
 uint32_t srslte_tdec_autoimp_get_subblocks_8bit(uint32_t long_cb)
 {
-#ifdef LV_HAVE_AVX2
-  if (!(long_cb % 32) && long_cb > 2048) {
+  srslte_simd_isa_t isa = srslte_simd_isa();
+  if (isa >= SRSLTE_SIMD_ISA_AVX512 && !(long_cb % 64) && long_cb > 4096) {
+    return 64;
+  } else if (isa >= SRSLTE_SIMD_ISA_AVX2 && !(long_cb % 32) && long_cb > 2048) {
     return 32;
-  } else
-#endif
-      if (!(long_cb % 16) && long_cb > 800) {
+  } else if (!(long_cb % 16) && long_cb > 800) {
     return 16;
   } else if (!(long_cb % 8) && long_cb > 400) {
     return 8;
@@ -427,6 +507,8 @@ static int tdec_sb_idx_8(uint32_t long_cb)
 {
   uint32_t nof_sb = srslte_tdec_autoimp_get_subblocks_8bit(long_cb);
   switch (nof_sb) {
+    case 64:
+      return AUTO_8_AVX512WIN;
     case 32:
       return AUTO_8_AVXWIN;
     case 16:
@@ -470,7 +552,8 @@ static void tdec_iteration_8(srslte_tdec_t* h, int8_t* input)
       h->current_inter_idx = interleaver_idx(h->nof_blocks16[h->current_dec]);
     }
   } else {
-    h->current_dec = 0;
+    h->current_dec       = 0;
+    h->current_inter_idx = interleaver_idx(h->nof_blocks8[0]);
   }
 
   if (h->current_llr_type == SRSLTE_TDEC_16) {
@@ -515,7 +598,18 @@ int srslte_tdec_new_cb(srslte_tdec_t* h, uint32_t long_cb)
     return -1;
   }
 
+  // Window decoders need sub-blocks longer than the window overlap
+  if (h->dec_type != SRSLTE_TDEC_AUTO) {
+    int nof_sb = h->current_llr_type == SRSLTE_TDEC_16 ? h->nof_blocks16[0] : h->nof_blocks8[0];
+    if (nof_sb > 1 && (long_cb % nof_sb || long_cb / nof_sb <= SRSLTE_TDEC_WIN_OVERLAP_LEN)) {
+      ERROR("TDEC with %d sub-blocks does not support CB length %d\n", nof_sb, long_cb);
+      return -1;
+    }
+  }
+
   h->n_iter          = 0;
+  h->min_changes     = UINT32_MAX;
+  h->nof_stalled     = 0;
   h->current_long_cb = long_cb;
   h->current_cbidx   = srslte_cbsegm_cbindex(long_cb);
   if (h->current_cbidx < 0) {
@@ -49,6 +49,13 @@
 #define debug_state
 #endif
 
+/* The metrics are computed with 32 bits and saturated when stored, as the SIMD decoders saturate, so that the extrinsic
+ * information growing over the iterations at high SNR does not wrap around */
+static inline int16_t sat_s(int x)
+{
+  return (int16_t)(x > INT16_MAX ? INT16_MAX : (x < INT16_MIN ? INT16_MIN : x));
+}
+
 /************************************************
  *
  *  MAP_GEN is the MAX-LOG-MAP generic implementation of the
@@ -57,8 +64,8 @@
  ************************************************/
 static void map_gen_beta(tdec_gen_t* s, int16_t* input, int16_t* app, int16_t* parity, uint32_t long_cb)
 {
-  int16_t  m_b[8], new[8], old[8];
-  int16_t  x, y, xy;
+  int      m_b[8], new[8], old[8];
+  int      x, y, xy;
   int      k;
   uint32_t end  = long_cb + SRSLTE_TCOD_RATE;
   int16_t* beta = s->beta;
@@ -99,7 +106,7 @@ static void map_gen_beta(tdec_gen_t* s, int16_t* input, int16_t* app, int16_t* p
       if (m_b[i] > new[i])
         new[i] = m_b[i];
       old[i]          = new[i];
-      beta[8 * k + i] = old[i];
+      beta[8 * k + i] = sat_s(old[i]);
     }
 
     if ((k % 4) == 0 && k < long_cb) {
@@ -114,9 +121,9 @@ static void map_gen_beta(tdec_gen_t* s, int16_t* input, int16_t* app, int16_t* p
 static void
 map_gen_alpha(tdec_gen_t* s, int16_t* input, int16_t* app, int16_t* parity, int16_t* output, uint32_t long_cb)
 {
-  int16_t  m_b[8], new[8], old[8], max1[8], max0[8];
-  int16_t  m1, m0;
-  int16_t  x, y, xy;
+  int      m_b[8], new[8], old[8], max1[8], max0[8];
+  int      m1, m0;
+  int      x, y, xy;
   int16_t  out;
   uint32_t k;
   uint32_t end  = long_cb;
@@ -142,7 +149,9 @@ map_gen_alpha(tdec_gen_t* s, int16_t* input, int16_t* app, int16_t* parity, int1
     xy = x + y;
 
 #if debug_enabled
-    memcpy(alpha, old, sizeof(int16_t) * 8);
+    for (i = 0; i < 8; i++) {
+      alpha[i] = sat_s(old[i]);
+    }
 #endif
 
     m_b[0] = old[0];
@@ -190,7 +199,7 @@ map_gen_alpha(tdec_gen_t* s, int16_t* input, int16_t* app, int16_t* parity, int1
       old[0] = 0;
     }
 
-    out           = m1 - m0;
+    out           = sat_s(m1 - m0);
     output[k - 1] = out;
 
     debug_state;
@@ -29,6 +29,7 @@
 #include "parity.h"
 #include "srslte/phy/fec/viterbi.h"
 #include "srslte/phy/utils/debug.h"
+#include "srslte/phy/utils/simd_dispatch.h"
 #include "srslte/phy/utils/vector.h"
 #include "viterbi37.h"
 
@@ -41,9 +42,8 @@
 #define DEFAULT_GAIN_16 1000
 #define VITERBI_16
 
-#ifndef LV_HAVE_AVX2
-#undef VITERBI_16
-#endif
+/* Below this number of frames, decoding them one by one is faster than in the lanes of the batched decoder */
+#define VITERBI_BATCH_MIN_FRAMES 2
 
 //#undef LV_HAVE_SSE
 
@@ -125,7 +125,7 @@ void free37_sse(void* o)
 
 #endif
 
-#ifdef LV_HAVE_AVX2
+#ifdef SRSLTE_SIMD_KERNELS_AVX2
 int decode37_avx2_16bit(void* o, uint16_t* symbols, uint8_t* data, uint32_t frame_length)
 {
   srslte_viterbi_t* q = o;
@@ -217,6 +217,57 @@ void free37_avx2(void* o)
 
 #endif
 
+#ifdef SRSLTE_SIMD_KERNELS_AVX512
+int decode37_avx512_16bit(void* o, uint16_t* symbols, uint8_t* data, uint32_t frame_length)
+{
+  srslte_viterbi_t* q = o;
+
+  uint32_t best_state;
+
+  if (frame_length > q->framebits) {
+    ERROR("Initialized decoder for max frame length %d bits\n", q->framebits);
+    return -1;
+  }
+
+  /* Initialize Viterbi decoder */
+  init_viterbi37_avx512_16bit(q->ptr, q->tail_biting ? -1 : 0);
+
+  /* Decode block */
+  if (q->tail_biting) {
+    for (int i = 0; i < TB_ITER; i++) {
+      memcpy(&q->tmp_s[i * 3 * frame_length], symbols, 3 * frame_length * sizeof(uint16_t));
+    }
+    update_viterbi37_blk_avx512_16bit(q->ptr, q->tmp_s, TB_ITER * frame_length, &best_state);
+    chainback_viterbi37_avx512_16bit(q->ptr, q->tmp, TB_ITER * frame_length, best_state);
+    memcpy(data, &q->tmp[((int)(TB_ITER / 2)) * frame_length], frame_length * sizeof(uint8_t));
+  } else {
+    update_viterbi37_blk_avx512_16bit(q->ptr, symbols, frame_length + q->K - 1, NULL);
+    chainback_viterbi37_avx512_16bit(q->ptr, data, frame_length, 0);
+  }
+
+  return q->framebits;
+}
+
+void free37_avx512_16bit(void* o)
+{
+  srslte_viterbi_t* q = o;
+
+  if (q->symbols_uc) {
+    free(q->symbols_uc);
+  }
+  if (q->symbols_us) {
+    free(q->symbols_us);
+  }
+  if (q->tmp) {
+    free(q->tmp);
+  }
+  if (q->tmp_s) {
+    free(q->tmp_s);
+  }
+  delete_viterbi37_avx512_16bit(q->ptr);
+}
+#endif
+
 #ifdef HAVE_NEON
 int decode37_neon(void* o, uint8_t* symbols, uint8_t* data, uint32_t frame_length)
 {
@@ -394,7 +445,7 @@ int init37_neon(srslte_viterbi_t* q, int poly[3], uint32_t framebits, bool tail_
 }
 #endif
 
-#ifdef LV_HAVE_AVX2
+#ifdef SRSLTE_SIMD_KERNELS_AVX2
 int init37_avx2(srslte_viterbi_t* q, int poly[3], uint32_t framebits, bool tail_biting)
 {
   q->K            = 7;
@@ -471,6 +522,45 @@ int init37_avx2_16bit(srslte_viterbi_t* q, int poly[3], uint32_t framebits, bool
 
 #endif
 
+#ifdef SRSLTE_SIMD_KERNELS_AVX512
+int init37_avx512_16bit(srslte_viterbi_t* q, int poly[3], uint32_t framebits, bool tail_biting)
+{
+  q->K            = 7;
+  q->R            = 3;
+  q->framebits    = framebits;
+  q->gain_quant_s = 4;
+  q->gain_quant   = DEFAULT_GAIN_16;
+  q->tail_biting  = tail_biting;
+  q->decode_s     = decode37_avx512_16bit;
+  q->free         = free37_avx512_16bit;
+  q->decode_f     = NULL;
+  q->symbols_uc   = srslte_vec_u8_malloc(3 * (q->framebits + q->K - 1));
+  q->symbols_us   = srslte_vec_u16_malloc(3 * (q->framebits + q->K - 1));
+  if (!q->symbols_uc || !q->symbols_us) {
+    perror("malloc");
+    free37_avx512_16bit(q);
+    return -1;
+  }
+  if (q->tail_biting) {
+    q->tmp   = srslte_vec_u8_malloc(TB_ITER * 3 * (q->framebits + q->K - 1));
+    q->tmp_s = srslte_vec_u16_malloc(TB_ITER * 3 * (q->framebits + q->K - 1));
+    if (!q->tmp || !q->tmp_s) {
+      perror("malloc");
+      free37_avx512_16bit(q);
+      return -1;
+    }
+  }
+
+  if ((q->ptr = create_viterbi37_avx512_16bit(poly, TB_ITER * framebits)) == NULL) {
+    ERROR("create_viterbi37 failed\n");
+    free37_avx512_16bit(q);
+    return -1;
+  } else {
+    return 0;
+  }
+}
+#endif
+
 void srslte_viterbi_set_gain_quant(srslte_viterbi_t* q, float gain_quant)
 {
   q->gain_quant = gain_quant;
@@ -490,17 +580,23 @@ int srslte_viterbi_init(srslte_viterbi_t*     q,
   bzero(q, sizeof(srslte_viterbi_t));
   switch (type) {
     case SRSLTE_VITERBI_37:
-#ifdef LV_HAVE_SSE
-
-#ifdef LV_HAVE_AVX2
+      // Highest instruction set selected at runtime among the kernels built
+#ifdef SRSLTE_SIMD_KERNELS_AVX512
+      if (srslte_simd_isa() >= SRSLTE_SIMD_ISA_AVX512) {
+        return init37_avx512_16bit(q, poly, max_frame_length, tail_bitting);
+      }
+#endif /* SRSLTE_SIMD_KERNELS_AVX512 */
+#ifdef SRSLTE_SIMD_KERNELS_AVX2
+      if (srslte_simd_isa() >= SRSLTE_SIMD_ISA_AVX2) {
 #ifdef VITERBI_16
-      return init37_avx2_16bit(q, poly, max_frame_length, tail_bitting);
+        return init37_avx2_16bit(q, poly, max_frame_length, tail_bitting);
 #else
-      return init37_avx2(q, poly, max_frame_length, tail_bitting);
+        return init37_avx2(q, poly, max_frame_length, tail_bitting);
 #endif
-#else
+      }
+#endif /* SRSLTE_SIMD_KERNELS_AVX2 */
+#ifdef LV_HAVE_SSE
       return init37_sse(q, poly, max_frame_length, tail_bitting);
-#endif
 #else
 #ifdef HAVE_NEON
       return init37_neon(q, poly, max_frame_length, tail_bitting);
@@ -525,7 +621,7 @@ int srslte_viterbi_init_sse(srslte_viterbi_t*     q,
 }
 #endif
 
-#ifdef LV_HAVE_AVX2
+#ifdef SRSLTE_SIMD_KERNELS_AVX2
 int srslte_viterbi_init_avx2(srslte_viterbi_t*     q,
                              srslte_viterbi_type_t type,
                              int                   poly[3],
@@ -536,11 +632,75 @@ int srslte_viterbi_init_avx2(srslte_viterbi_t*     q,
 }
 #endif
 
+#ifdef SRSLTE_SIMD_KERNELS_AVX512
+int srslte_viterbi_init_avx512(srslte_viterbi_t*     q,
+                               srslte_viterbi_type_t type,
+                               int                   poly[3],
+                               uint32_t              max_frame_length,
+                               bool                  tail_bitting)
+{
+  return init37_avx512_16bit(q, poly, max_frame_length, tail_bitting);
+}
+#endif
+
+/* Initializes the decoder like srslte_viterbi_init() and, if the instruction set allows it, the buffers of the batched
+ * decoder used by srslte_viterbi_decode_batch_f() */
+int srslte_viterbi_init_batch(srslte_viterbi_t*     q,
+                              srslte_viterbi_type_t type,
+                              int                   poly[3],
+                              uint32_t              max_frame_length,
+                              bool                  tail_bitting)
+{
+  if (srslte_viterbi_init(q, type, poly, max_frame_length, tail_bitting)) {
+    return SRSLTE_ERROR;
+  }
+  // Batched decoder of the instruction set selected at runtime, without it the frames are decoded one by one
+#ifdef SRSLTE_SIMD_KERNELS_AVX512
+  if (srslte_simd_isa() >= SRSLTE_SIMD_ISA_AVX512) {
+    q->batch_ptr       = create_viterbi37_avx512_batch(poly, TB_ITER * max_frame_length);
+    q->batch_init      = init_viterbi37_avx512_batch;
+    q->batch_update    = update_viterbi37_blk_avx512_batch;
+    q->batch_chainback = chainback_viterbi37_avx512_batch;
+    q->batch_free      = delete_viterbi37_avx512_batch;
+  }
+#endif /* SRSLTE_SIMD_KERNELS_AVX512 */
+#ifdef SRSLTE_SIMD_KERNELS_AVX2
+  if (!q->batch_free && srslte_simd_isa() >= SRSLTE_SIMD_ISA_AVX2) {
+    q->batch_ptr       = create_viterbi37_avx2_batch(poly, TB_ITER * max_frame_length);
+    q->batch_init      = init_viterbi37_avx2_batch;
+    q->batch_update    = update_viterbi37_blk_avx2_batch;
+    q->batch_chainback = chainback_viterbi37_avx2_batch;
+    q->batch_free      = delete_viterbi37_avx2_batch;
+  }
+#endif /* SRSLTE_SIMD_KERNELS_AVX2 */
+  if (!q->batch_free) {
+    return SRSLTE_SUCCESS;
+  }
+  if (!q->batch_ptr) {
+    ERROR("create_viterbi37 failed\n");
+    srslte_viterbi_free(q);
+    return SRSLTE_ERROR;
+  }
+  q->batch_symbols = srslte_vec_u16_malloc(TB_ITER * 3 * (q->framebits + q->K - 1) * VITERBI37_BATCH_LANES);
+  if (!q->batch_symbols) {
+    perror("malloc");
+    srslte_viterbi_free(q);
+    return SRSLTE_ERROR;
+  }
+  return SRSLTE_SUCCESS;
+}
+
 void srslte_viterbi_free(srslte_viterbi_t* q)
 {
   if (q->free) {
     q->free(q);
   }
+  if (q->batch_ptr) {
+    q->batch_free(q->batch_ptr);
+  }
+  if (q->batch_symbols) {
+    free(q->batch_symbols);
+  }
   bzero(q, sizeof(srslte_viterbi_t));
 }
 
@@ -564,18 +724,95 @@ int srslte_viterbi_decode_f(srslte_viterbi_t* q, float* symbols, uint8_t* data,
         max = fabs(symbols[i]);
       }
     }
-#ifdef VITERBI_16
-    srslte_vec_quant_fus(symbols, q->symbols_us, q->gain_quant / max, 32767.5, 65535, len);
-    return srslte_viterbi_decode_us(q, q->symbols_us, data, frame_length);
-#else
-    srslte_vec_quant_fuc(symbols, q->symbols_uc, q->gain_quant / max, 127.5, 255, len);
-    return srslte_viterbi_decode_uc(q, q->symbols_uc, data, frame_length);
-#endif
+    if (q->decode_s) {
+      srslte_vec_quant_fus(symbols, q->symbols_us, q->gain_quant / max, 32767.5, 65535, len);
+      return srslte_viterbi_decode_us(q, q->symbols_us, data, frame_length);
+    } else {
+      srslte_vec_quant_fuc(symbols, q->symbols_uc, q->gain_quant / max, 127.5, 255, len);
+      return srslte_viterbi_decode_uc(q, q->symbols_uc, data, frame_length);
+    }
   } else {
     return q->decode_f(q, symbols, data, frame_length);
   }
 }
 
+/* Quantizes every frame as srslte_viterbi_decode_f() does and decodes them all in the lanes of the batched decoder. The
+ * lanes without frame get erasures */
+static void decode37_batch_f(srslte_viterbi_t* q,
+                             float*            symbols[SRSLTE_VITERBI_MAX_BATCH],
+                             uint8_t*          data[SRSLTE_VITERBI_MAX_BATCH],
+                             uint32_t          nof_frames,
+                             uint32_t          frame_length)
+{
+  uint32_t best_state[VITERBI37_BATCH_LANES];
+  uint32_t len = 3 * (q->tail_biting ? frame_length : frame_length + q->K - 1);
+
+  for (uint32_t f = 0; f < VITERBI37_BATCH_LANES; f++) {
+    if (f < nof_frames) {
+      float max = SRSLTE_MAX(fabsf(symbols[f][srslte_vec_max_abs_fi(symbols[f], len)]), 1e-9);
+      srslte_vec_quant_fus(symbols[f], q->symbols_us, q->gain_quant / max, 32767.5, 65535, len);
+      for (uint32_t i = 0; i < len; i++) {
+        q->batch_symbols[i * VITERBI37_BATCH_LANES + f] = q->symbols_us[i];
+      }
+    } else {
+      for (uint32_t i = 0; i < len; i++) {
+        q->batch_symbols[i * VITERBI37_BATCH_LANES + f] = 32767;
+      }
+    }
+  }
+
+  if (q->tail_biting) {
+    for (int i = 1; i < TB_ITER; i++) {
+      memcpy(&q->batch_symbols[i * len * VITERBI37_BATCH_LANES],
+             q->batch_symbols,
+             len * VITERBI37_BATCH_LANES * sizeof(uint16_t));
+    }
+    /* Only the middle copy of the frames is traced back and written */
+    q->batch_init(q->batch_ptr, -1);
+    q->batch_update(q->batch_ptr, q->batch_symbols, TB_ITER * frame_length, best_state);
+    q->batch_chainback(q->batch_ptr,
+                       data,
+                       nof_frames,
+                       TB_ITER * frame_length,
+                       best_state,
+                       ((int)(TB_ITER / 2)) * frame_length,
+                       frame_length);
+  } else {
+    q->batch_init(q->batch_ptr, 0);
+    q->batch_update(q->batch_ptr, q->batch_symbols, frame_length + q->K - 1, NULL);
+    for (uint32_t f = 0; f < nof_frames; f++) {
+      best_state[f] = 0;
+    }
+    q->batch_chainback(q->batch_ptr, data, nof_frames, frame_length, best_state, 0, frame_length);
+  }
+}
+
+/* Decodes nof_frames frames of the same length, with real-valued symbols. If the decoder was initialized with
+ * srslte_viterbi_init_batch() they are decoded at once, with the same result as srslte_viterbi_decode_f() */
+int srslte_viterbi_decode_batch_f(srslte_viterbi_t* q,
+                                  float*            symbols[SRSLTE_VITERBI_MAX_BATCH],
+                                  uint8_t*          data[SRSLTE_VITERBI_MAX_BATCH],
+                                  uint32_t          nof_frames,
+                                  uint32_t          frame_length)
+{
+  if (nof_frames > SRSLTE_VITERBI_MAX_BATCH || frame_length > q->framebits) {
+    ERROR("Invalid batch of %d frames of %d bits\n", nof_frames, frame_length);
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+
+  if (q->batch_ptr && nof_frames >= VITERBI_BATCH_MIN_FRAMES) {
+    decode37_batch_f(q, symbols, data, nof_frames, frame_length);
+    return SRSLTE_SUCCESS;
+  }
+
+  for (uint32_t f = 0; f < nof_frames; f++) {
+    if (srslte_viterbi_decode_f(q, symbols[f], data[f], frame_length) < 0) {
+      return SRSLTE_ERROR;
+    }
+  }
+  return SRSLTE_SUCCESS;
+}
+
 /* symbols are int16 */
 int srslte_viterbi_decode_s(srslte_viterbi_t* q, int16_t* symbols, uint8_t* data, uint32_t frame_length)
 {
@@ -596,13 +833,13 @@ int srslte_viterbi_decode_s(srslte_viterbi_t* q, int16_t* symbols, uint8_t* data
       max = abs(symbols[i]);
     }
   }
-#ifdef VITERBI_16
-  srslte_vec_quant_sus(symbols, q->symbols_us, 1, (float)INT16_MAX, UINT16_MAX, len);
-  return srslte_viterbi_decode_us(q, q->symbols_us, data, frame_length);
-#else
-  srslte_vec_quant_suc(symbols, q->symbols_uc, (float)q->gain_quant / max, 127, 255, len);
-  return srslte_viterbi_decode_uc(q, q->symbols_uc, data, frame_length);
-#endif
+  if (q->decode_s) {
+    srslte_vec_quant_sus(symbols, q->symbols_us, 1, (float)INT16_MAX, UINT16_MAX, len);
+    return srslte_viterbi_decode_us(q, q->symbols_us, data, frame_length);
+  } else {
+    srslte_vec_quant_suc(symbols, q->symbols_uc, (float)q->gain_quant / max, 127, 255, len);
+    return srslte_viterbi_decode_uc(q, q->symbols_uc, data, frame_length);
+  }
 }
 
 int srslte_viterbi_decode_us(srslte_viterbi_t* q, uint16_t* symbols, uint8_t* data, uint32_t frame_length)
@@ -23,6 +23,7 @@
 #define SRSLTE_VITERBI37_H_
 
 #include <stdbool.h>
+#include <stdint.h>
 
 void* create_viterbi37_port(int polys[3], uint32_t len);
 
@@ -82,4 +83,49 @@ void delete_viterbi37_avx2_16bit(void* p);
 
 int update_viterbi37_blk_avx2_16bit(void* p, uint16_t* syms, uint32_t nbits, uint32_t* best_state);
 
+void* create_viterbi37_avx512_16bit(int polys[3], uint32_t len);
+
+int init_viterbi37_avx512_16bit(void* p, int starting_state);
+
+int chainback_viterbi37_avx512_16bit(void* p, uint8_t* data, uint32_t nbits, uint32_t endstate);
+
+void delete_viterbi37_avx512_16bit(void* p);
+
+void update_viterbi37_blk_avx512_16bit(void* p, uint16_t* syms, uint32_t nbits, uint32_t* best_state);
+
+/* Number of frames decoded at once by the batch decoders, one per 16-bit lane */
+#define VITERBI37_BATCH_LANES 16
+
+void* create_viterbi37_avx2_batch(int polys[3], uint32_t len);
+
+int init_viterbi37_avx2_batch(void* p, int starting_state);
+
+int chainback_viterbi37_avx2_batch(void*           p,
+                                   uint8_t*        data[VITERBI37_BATCH_LANES],
+                                   uint32_t        nof_frames,
+                                   uint32_t        nbits,
+                                   const uint32_t* endstate,
+                                   uint32_t        first,
+                                   uint32_t        len);
+
+void delete_viterbi37_avx2_batch(void* p);
+
+void update_viterbi37_blk_avx2_batch(void* p, const uint16_t* syms, uint32_t nbits, uint32_t* best_state);
+
+void* create_viterbi37_avx512_batch(int polys[3], uint32_t len);
+
+int init_viterbi37_avx512_batch(void* p, int starting_state);
+
+int chainback_viterbi37_avx512_batch(void*           p,
+                                     uint8_t*        data[VITERBI37_BATCH_LANES],
+                                     uint32_t        nof_frames,
+                                     uint32_t        nbits,
+                                     const uint32_t* endstate,
+                                     uint32_t        first,
+                                     uint32_t        len);
+
+void delete_viterbi37_avx512_batch(void* p);
+
+void update_viterbi37_blk_avx512_batch(void* p, const uint16_t* syms, uint32_t nbits, uint32_t* best_state);
+
 #endif /* SRSLTE_VITERBI37_H_ */
@@ -0,0 +1,228 @@
+/* Adapted Phil Karn's r=1/3 k=9 viterbi decoder to r=1/3 k=7
+ *
+ * K=15 r=1/6 Viterbi decoder for x86 SSE2
+ * Copyright Mar 2004, Phil Karn, KA9Q
+ * May be used under the terms of the GNU Lesser General Public License (LGPL)
+ */
+
+#include "parity.h"
+#include "viterbi37.h"
+#include <memory.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+
+#ifdef LV_HAVE_AVX2
+
+#include <immintrin.h>
+
+/* Decisions of a bit: for every butterfly, the decisions of its two states for all the frames */
+typedef struct {
+  uint32_t w[32];
+} decision_t;
+
+/* State info for instance of batched Viterbi decoder. Every 16-bit lane runs the trellis of a different frame, so the
+ * 64 states are processed one after the other with plain vertical operations and no shuffles */
+struct v37_batch {
+  __m256i     metrics1[64];              /* path metric buffer 1, a vector of frames per state */
+  __m256i     metrics2[64];              /* path metric buffer 2 */
+  __m256i *   old_metrics, *new_metrics; /* Pointers to path metrics, swapped on every bit */
+  decision_t* dp;                        /* Pointer to current decision */
+  decision_t* decisions;                 /* Beginning of decisions for block */
+  uint32_t    len;
+  uint8_t     branch[32]; /* Encoder output of the transitions leaving every state, as index of its branch metric */
+};
+
+/* Initialize Viterbi decoder for start of new frames */
+int init_viterbi37_avx2_batch(void* p, int starting_state)
+{
+  struct v37_batch* vp = p;
+
+  /* The single frame decoders clear the metrics after biasing the start state, so every state starts with the same
+   * metric. Do the same to get their decisions */
+  (void)starting_state;
+  bzero(vp->metrics1, sizeof(vp->metrics1));
+
+  vp->old_metrics = vp->metrics1;
+  vp->new_metrics = vp->metrics2;
+  vp->dp          = vp->decisions;
+  return 0;
+}
+
+/* Create a new instance of a batched Viterbi decoder */
+void* create_viterbi37_avx2_batch(int polys[3], uint32_t len)
+{
+  void*             p;
+  struct v37_batch* vp;
+
+  if (posix_memalign(&p, sizeof(__m256i), sizeof(struct v37_batch)))
+    return NULL;
+
+  vp = (struct v37_batch*)p;
+  if (posix_memalign(&p, sizeof(__m256i), (len + 6) * sizeof(decision_t))) {
+    free(vp);
+    return NULL;
+  }
+  vp->decisions = (decision_t*)p;
+  vp->len       = len + 6;
+
+  for (int state = 0; state < 32; state++) {
+    vp->branch[state] = (((polys[0] < 0) ^ parity((2 * state) & polys[0])) << 2) |
+                        (((polys[1] < 0) ^ parity((2 * state) & polys[1])) << 1) |
+                        ((polys[2] < 0) ^ parity((2 * state) & polys[2]));
+  }
+  return vp;
+}
+
+/* Viterbi chainback of nof_frames frames at once, from the bit nbits - 1 down to the bit first. The bits first to
+ * first + len - 1 are written in data */
+int chainback_viterbi37_avx2_batch(void*           p,
+                                   uint8_t*        data[VITERBI37_BATCH_LANES],
+                                   uint32_t        nof_frames,
+                                   uint32_t        nbits,
+                                   const uint32_t* endstate,
+                                   uint32_t        first,
+                                   uint32_t        len)
+{
+  struct v37_batch* vp = p;
+  uint32_t          state[VITERBI37_BATCH_LANES];
+
+  if (p == NULL || nof_frames > VITERBI37_BATCH_LANES)
+    return -1;
+
+  decision_t* d = vp->decisions;
+
+  for (uint32_t f = 0; f < nof_frames; f++) {
+    state[f] = (endstate[f] % 64) << 2;
+  }
+
+  /* The decision of the frame f for the even state of a butterfly is at the bit (f % 8) + 16 * (f / 8) of its word, as
+   * packed by update_viterbi37_blk_avx2_batch(). The decision of the odd state follows 8 bits later. The chains of the
+   * frames are independent, running them together hides the latency of each step */
+  d += 6; /* Look past tail */
+  while (nbits-- > first) {
+    for (uint32_t f = 0; f < nof_frames; f++) {
+      uint32_t s = state[f] >> 2;
+      uint32_t k = (d[nbits].w[s / 2] >> ((f % 8) + 16 * (f / 8) + 8 * (s % 2))) & 1;
+      state[f]   = (state[f] >> 1) | (k << 7);
+      if (nbits < first + len) {
+        data[f][nbits - first] = k;
+      }
+    }
+  }
+  return 0;
+}
+
+/* Delete instance of a batched Viterbi decoder */
+void delete_viterbi37_avx2_batch(void* p)
+{
+  struct v37_batch* vp = p;
+
+  if (vp != NULL) {
+    free(vp->decisions);
+    free(vp);
+  }
+}
+
+/* Runs the trellis of up to 16 frames at once. syms holds, for every bit, the 3 symbols of every frame: the symbol i of
+ * the bit n of the frame f is at syms[(3 * n + i) * 16 + f]. With 16-bit symbols quantized around 32767 the path
+ * metrics are normalized before they can overflow, so the compare-select does not need modulo arithmetic. The
+ * decisions are the same as those of the single frame decoders. best_state, if not NULL, returns the final state with
+ * the lowest metric of every frame */
+void update_viterbi37_blk_avx2_batch(void* p, const uint16_t* syms, uint32_t nbits, uint32_t* best_state)
+{
+  struct v37_batch* vp = p;
+  decision_t*       d;
+
+  if (p == NULL)
+    return;
+
+  const __m256i ones = _mm256_set1_epi16(-1);
+  const __m256i max  = _mm256_set1_epi16(8191);
+  const __m256i th   = _mm256_set1_epi16(16384);
+
+  d = vp->dp;
+
+  for (uint32_t n = 0; n < nbits; n++) {
+    __m256i  sym[3][2], avg[4], metric[8], m_metric[8];
+    __m256i* tmp;
+
+    sym[0][0] = _mm256_loadu_si256((__m256i*)&syms[0]);
+    sym[1][0] = _mm256_loadu_si256((__m256i*)&syms[16]);
+    sym[2][0] = _mm256_loadu_si256((__m256i*)&syms[32]);
+    sym[0][1] = _mm256_xor_si256(sym[0][0], ones);
+    sym[1][1] = _mm256_xor_si256(sym[1][0], ones);
+    sym[2][1] = _mm256_xor_si256(sym[2][0], ones);
+
+    syms += 3 * VITERBI37_BATCH_LANES;
+
+    /* Form the 8 possible branch metrics */
+    for (uint32_t i = 0; i < 4; i++) {
+      avg[i] = _mm256_avg_epu16(sym[0][i >> 1], sym[1][i & 1]);
+    }
+    for (uint32_t i = 0; i < 8; i++) {
+      metric[i]   = _mm256_srli_epi16(_mm256_avg_epu16(sym[2][i & 1], avg[i >> 1]), 3);
+      m_metric[i] = _mm256_sub_epi16(max, metric[i]);
+    }
+
+    /* Butterflies: the states j and j + 32 go to the states 2j and 2j + 1 */
+    for (uint32_t j = 0; j < 32; j++) {
+      __m256i m0, m1, m2, m3, decision0, decision1;
+
+      uint32_t b = vp->branch[j];
+
+      m0 = _mm256_add_epi16(vp->old_metrics[j], metric[b]);
+      m1 = _mm256_add_epi16(vp->old_metrics[j + 32], m_metric[b]);
+      m2 = _mm256_add_epi16(vp->old_metrics[j], m_metric[b]);
+      m3 = _mm256_add_epi16(vp->old_metrics[j + 32], metric[b]);
+
+      decision0 = _mm256_cmpgt_epi16(m0, m1);
+      decision1 = _mm256_cmpgt_epi16(m2, m3);
+
+      vp->new_metrics[2 * j]     = _mm256_min_epi16(m0, m1);
+      vp->new_metrics[2 * j + 1] = _mm256_min_epi16(m2, m3);
+
+      d->w[j] = (uint32_t)_mm256_movemask_epi8(_mm256_packs_epi16(decision0, decision1));
+    }
+
+    // See if we need to normalize. The metrics of a frame stay close to each other, those of state 0 are subtracted
+    if (_mm256_movemask_epi8(_mm256_cmpgt_epi16(vp->new_metrics[0], th))) {
+      __m256i adjustv = vp->new_metrics[0];
+      for (uint32_t i = 0; i < 64; i++) {
+        vp->new_metrics[i] = _mm256_sub_epi16(vp->new_metrics[i], adjustv);
+      }
+    }
+
+    d++;
+    /* Swap pointers to old and new metrics */
+    tmp             = vp->old_metrics;
+    vp->old_metrics = vp->new_metrics;
+    vp->new_metrics = tmp;
+  }
+
+  /* The chainback looks past the tail */
+  bzero(d, 6 * sizeof(decision_t));
+
+  if (best_state) {
+    int16_t metrics[64][VITERBI37_BATCH_LANES];
+    for (uint32_t i = 0; i < 64; i++) {
+      _mm256_storeu_si256((__m256i*)metrics[i], vp->old_metrics[i]);
+    }
+    for (uint32_t f = 0; f < VITERBI37_BATCH_LANES; f++) {
+      uint32_t bst       = 0;
+      int16_t  minmetric = INT16_MAX;
+      for (uint32_t i = 0; i < 64; i++) {
+        if (metrics[i][f] <= minmetric) {
+          bst       = i;
+          minmetric = metrics[i][f];
+        }
+      }
+      best_state[f] = bst;
+    }
+  }
+
+  vp->dp = d;
+}
+
+#endif
@@ -0,0 +1,242 @@
+/* Adapted Phil Karn's r=1/3 k=9 viterbi decoder to r=1/3 k=7
+ *
+ * K=15 r=1/6 Viterbi decoder for x86 SSE2
+ * Copyright Mar 2004, Phil Karn, KA9Q
+ * May be used under the terms of the GNU Lesser General Public License (LGPL)
+ */
+
+#include "parity.h"
+#include "viterbi37.h"
+#include <memory.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+
+#ifdef LV_HAVE_AVX512
+
+#include <immintrin.h>
+
+typedef union {
+  unsigned short c[64];
+  __m512i        v[2];
+} metric_t;
+
+typedef union {
+  uint64_t      w;
+  unsigned char c[8];
+} decision_t;
+
+static union branchtab37_avx512 {
+  unsigned short c[32];
+  __m512i        v;
+} Branchtab37_avx512[3];
+
+/* State info for instance of Viterbi decoder */
+struct v37 {
+  metric_t    metrics1;                  /* path metric buffer 1 */
+  metric_t    metrics2;                  /* path metric buffer 2 */
+  decision_t* dp;                        /* Pointer to current decision */
+  metric_t *  old_metrics, *new_metrics; /* Pointers to path metrics, swapped on every bit */
+  decision_t* decisions;                 /* Beginning of decisions for block */
+  uint32_t    len;
+};
+
+void set_viterbi37_polynomial_avx512_16bit(int polys[3])
+{
+  int state;
+  for (state = 0; state < 32; state++) {
+    Branchtab37_avx512[0].c[state] = (polys[0] < 0) ^ parity((2 * state) & polys[0]) ? 65535 : 0;
+    Branchtab37_avx512[1].c[state] = (polys[1] < 0) ^ parity((2 * state) & polys[1]) ? 65535 : 0;
+    Branchtab37_avx512[2].c[state] = (polys[2] < 0) ^ parity((2 * state) & polys[2]) ? 65535 : 0;
+  }
+}
+
+void clear_v37_avx512_16bit(struct v37* vp)
+{
+  bzero(vp->decisions, sizeof(decision_t) * vp->len);
+  vp->dp = NULL;
+  bzero(&vp->metrics1, sizeof(metric_t));
+  bzero(&vp->metrics2, sizeof(metric_t));
+  vp->old_metrics = NULL;
+  vp->new_metrics = NULL;
+}
+
+/* Initialize Viterbi decoder for start of new frame */
+int init_viterbi37_avx512_16bit(void* p, int starting_state)
+{
+  struct v37* vp = p;
+  uint32_t    i;
+
+  for (i = 0; i < 64; i++)
+    vp->metrics1.c[i] = 63;
+
+  clear_v37_avx512_16bit(vp);
+  vp->old_metrics = &vp->metrics1;
+  vp->new_metrics = &vp->metrics2;
+  vp->dp          = vp->decisions;
+  if (starting_state != -1) {
+    vp->old_metrics->c[starting_state & 63] = 0; /* Bias known start state */
+  }
+  return 0;
+}
+
+/* Create a new instance of a Viterbi decoder */
+void* create_viterbi37_avx512_16bit(int polys[3], uint32_t len)
+{
+  void*       p;
+  struct v37* vp;
+
+  set_viterbi37_polynomial_avx512_16bit(polys);
+
+  if (posix_memalign(&p, sizeof(__m512i), sizeof(struct v37)))
+    return NULL;
+
+  vp = (struct v37*)p;
+  if (posix_memalign(&p, sizeof(__m512i), (len + 6) * sizeof(decision_t))) {
+    free(vp);
+    return NULL;
+  }
+  vp->decisions = (decision_t*)p;
+  vp->len       = len + 6;
+  return vp;
+}
+
+/* Viterbi chainback */
+int chainback_viterbi37_avx512_16bit(void*    p,
+                                     uint8_t* data,  /* Decoded output data */
+                                     uint32_t nbits, /* Number of data bits */
+                                     uint32_t endstate)
+{ /* Terminal encoder state */
+  struct v37* vp = p;
+
+  if (p == NULL)
+    return -1;
+
+  decision_t* d = (decision_t*)vp->decisions;
+
+  /* Make room beyond the end of the encoder register so we can
+   * accumulate a full byte of decoded data
+   */
+  endstate %= 64;
+  endstate <<= 2;
+
+  d += 6; /* Look past tail */
+  while (nbits--) {
+    int k;
+
+    k           = (d[nbits].c[(endstate >> 2) / 8] >> ((endstate >> 2) % 8)) & 1;
+    endstate    = (endstate >> 1) | (k << 7);
+    data[nbits] = k;
+  }
+  return 0;
+}
+
+/* Delete instance of a Viterbi decoder */
+void delete_viterbi37_avx512_16bit(void* p)
+{
+  struct v37* vp = p;
+
+  if (vp != NULL) {
+    free(vp->decisions);
+    free(vp);
+  }
+}
+
+/* The 64 path metrics fit in two registers, so every bit takes a single pass. The survivors of the states 2j and 2j+1
+ * both come from the states j and j+32: the candidate metrics are interleaved in state order before the
+ * compare-select, which gives the decisions of 32 states in a mask register and needs no packing */
+void update_viterbi37_blk_avx512_16bit(void* p, uint16_t* syms, uint32_t nbits, uint32_t* best_state)
+{
+  struct v37* vp = p;
+  decision_t* d;
+
+  if (p == NULL)
+    return;
+
+  const __m512i idx_lo = _mm512_set_epi16(47, 15, 46, 14, 45, 13, 44, 12, 43, 11, 42, 10, 41, 9, 40, 8,
+                                          39, 7, 38, 6, 37, 5, 36, 4, 35, 3, 34, 2, 33, 1, 32, 0);
+  const __m512i idx_hi = _mm512_set_epi16(63, 31, 62, 30, 61, 29, 60, 28, 59, 27, 58, 26, 57, 25, 56, 24,
+                                          55, 23, 54, 22, 53, 21, 52, 20, 51, 19, 50, 18, 49, 17, 48, 16);
+
+  d = (decision_t*)vp->dp;
+
+  while (nbits--) {
+    __m512i sym0v, sym1v, sym2v;
+    void*   tmp;
+
+    /* Splat the 0th symbol across sym0v, the 1st symbol across sym1v, etc */
+    sym0v = _mm512_set1_epi16(syms[0]);
+    sym1v = _mm512_set1_epi16(syms[1]);
+    sym2v = _mm512_set1_epi16(syms[2]);
+
+    syms += 3;
+
+    __m512i   metric, m_metric, m0, m1, m2, m3, a, b;
+    __mmask32 decision;
+
+    /* Form branch metrics */
+    m0     = _mm512_avg_epu16(_mm512_xor_si512(Branchtab37_avx512[0].v, sym0v),
+                          _mm512_xor_si512(Branchtab37_avx512[1].v, sym1v));
+    metric = _mm512_avg_epu16(_mm512_xor_si512(Branchtab37_avx512[2].v, sym2v), m0);
+
+    metric   = _mm512_srli_epi16(metric, 3);
+    m_metric = _mm512_sub_epi16(_mm512_set1_epi16(8191), metric);
+
+    /* Add branch metrics to path metrics */
+    m0 = _mm512_add_epi16(vp->old_metrics->v[0], metric);
+    m3 = _mm512_add_epi16(vp->old_metrics->v[1], metric);
+    m1 = _mm512_add_epi16(vp->old_metrics->v[1], m_metric);
+    m2 = _mm512_add_epi16(vp->old_metrics->v[0], m_metric);
+
+    /* Compare and select, using modulo arithmetic, the states 0 to 31 */
+    a                     = _mm512_permutex2var_epi16(m0, idx_lo, m2);
+    b                     = _mm512_permutex2var_epi16(m1, idx_lo, m3);
+    decision              = _mm512_cmpgt_epi16_mask(_mm512_sub_epi16(a, b), _mm512_setzero_si512());
+    vp->new_metrics->v[0] = _mm512_mask_blend_epi16(decision, a, b);
+    d->w                  = decision;
+
+    /* And the states 32 to 63 */
+    a                     = _mm512_permutex2var_epi16(m0, idx_hi, m2);
+    b                     = _mm512_permutex2var_epi16(m1, idx_hi, m3);
+    decision              = _mm512_cmpgt_epi16_mask(_mm512_sub_epi16(a, b), _mm512_setzero_si512());
+    vp->new_metrics->v[1] = _mm512_mask_blend_epi16(decision, a, b);
+    d->w |= (uint64_t)decision << 32;
+
+    // See if we need to normalize
+    if (vp->new_metrics->c[0] > 12288) {
+      __m512i adjust512 = _mm512_min_epu16(vp->new_metrics->v[0], vp->new_metrics->v[1]);
+      __m256i adjust256 =
+          _mm256_min_epu16(_mm512_castsi512_si256(adjust512), _mm512_extracti64x4_epi64(adjust512, 1));
+      __m128i adjust128 =
+          _mm_minpos_epu16(_mm_min_epu16(_mm256_castsi256_si128(adjust256), _mm256_extracti128_si256(adjust256, 1)));
+      __m512i adjustv = _mm512_set1_epi16((short)_mm_extract_epi16(adjust128, 0));
+
+      vp->new_metrics->v[0] = _mm512_sub_epi16(vp->new_metrics->v[0], adjustv);
+      vp->new_metrics->v[1] = _mm512_sub_epi16(vp->new_metrics->v[1], adjustv);
+    }
+
+    d++;
+    /* Swap pointers to old and new metrics */
+    tmp             = vp->old_metrics;
+    vp->old_metrics = vp->new_metrics;
+    vp->new_metrics = tmp;
+  }
+
+  if (best_state) {
+    uint32_t i, bst = 0;
+
+    uint16_t minmetric = UINT16_MAX;
+    for (i = 0; i < 64; i++) {
+      if (vp->old_metrics->c[i] <= minmetric) {
+        bst       = i;
+        minmetric = vp->old_metrics->c[i];
+      }
+    }
+    *best_state = bst;
+  }
+
+  vp->dp = d;
+}
+
+#endif
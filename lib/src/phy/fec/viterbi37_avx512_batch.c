@@ -0,0 +1,231 @@
+/* Adapted Phil Karn's r=1/3 k=9 viterbi decoder to r=1/3 k=7
+ *
+ * K=15 r=1/6 Viterbi decoder for x86 SSE2
+ * Copyright Mar 2004, Phil Karn, KA9Q
+ * May be used under the terms of the GNU Lesser General Public License (LGPL)
+ */
+
+#include "parity.h"
+#include "viterbi37.h"
+#include <memory.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+
+#ifdef LV_HAVE_AVX512
+
+#include <immintrin.h>
+
+/* Decisions of a bit. The word s holds the decisions of the state s for all the frames in the 16 lower bits, and those
+ * of the state s + 32 in the 16 upper bits */
+typedef struct {
+  uint32_t w[32];
+} decision_t;
+
+/* State info for instance of batched Viterbi decoder. Every 16-bit lane runs the trellis of a different frame: the
+ * metrics of the states s and s + 32 of the 16 frames share a register */
+struct v37_batch {
+  __m512i     metrics1[32];              /* path metric buffer 1 */
+  __m512i     metrics2[32];              /* path metric buffer 2 */
+  __m512i *   old_metrics, *new_metrics; /* Pointers to path metrics, swapped on every bit */
+  decision_t* dp;                        /* Pointer to current decision */
+  decision_t* decisions;                 /* Beginning of decisions for block */
+  uint32_t    len;
+  uint8_t     branch[16]; /* Encoder output of the transitions leaving every state, as index of its branch metric */
+  __m512i     flip[3];    /* Symbol inversion that gives the branch metrics of the state j + 16 from those of j */
+};
+
+/* Initialize Viterbi decoder for start of new frames */
+int init_viterbi37_avx512_batch(void* p, int starting_state)
+{
+  struct v37_batch* vp = p;
+
+  /* The single frame decoders clear the metrics after biasing the start state, so every state starts with the same
+   * metric. Do the same to get their decisions */
+  (void)starting_state;
+  bzero(vp->metrics1, sizeof(vp->metrics1));
+
+  vp->old_metrics = vp->metrics1;
+  vp->new_metrics = vp->metrics2;
+  vp->dp          = vp->decisions;
+  return 0;
+}
+
+/* Create a new instance of a batched Viterbi decoder */
+void* create_viterbi37_avx512_batch(int polys[3], uint32_t len)
+{
+  void*             p;
+  struct v37_batch* vp;
+
+  if (posix_memalign(&p, sizeof(__m512i), sizeof(struct v37_batch)))
+    return NULL;
+
+  vp = (struct v37_batch*)p;
+  if (posix_memalign(&p, sizeof(__m512i), (len + 6) * sizeof(decision_t))) {
+    free(vp);
+    return NULL;
+  }
+  vp->decisions = (decision_t*)p;
+  vp->len       = len + 6;
+
+  for (int state = 0; state < 16; state++) {
+    vp->branch[state] = (((polys[0] < 0) ^ parity((2 * state) & polys[0])) << 2) |
+                        (((polys[1] < 0) ^ parity((2 * state) & polys[1])) << 1) |
+                        ((polys[2] < 0) ^ parity((2 * state) & polys[2]));
+  }
+  /* The parity is linear: the encoder output of the state j + 16 is that of j, inverted if the polynomial has bit 5 */
+  for (int i = 0; i < 3; i++) {
+    vp->flip[i] = _mm512_maskz_set1_epi16(parity(32 & polys[i]) ? 0xffff0000 : 0, -1);
+  }
+  return vp;
+}
+
+/* Viterbi chainback of nof_frames frames at once, from the bit nbits - 1 down to the bit first. The bits first to
+ * first + len - 1 are written in data */
+int chainback_viterbi37_avx512_batch(void*           p,
+                                     uint8_t*        data[VITERBI37_BATCH_LANES],
+                                     uint32_t        nof_frames,
+                                     uint32_t        nbits,
+                                     const uint32_t* endstate,
+                                     uint32_t        first,
+                                     uint32_t        len)
+{
+  struct v37_batch* vp = p;
+  uint32_t          state[VITERBI37_BATCH_LANES];
+
+  if (p == NULL || nof_frames > VITERBI37_BATCH_LANES)
+    return -1;
+
+  decision_t* d = vp->decisions;
+
+  for (uint32_t f = 0; f < nof_frames; f++) {
+    state[f] = (endstate[f] % 64) << 2;
+  }
+
+  /* The chains of the frames are independent, running them together hides the latency of each step */
+  d += 6; /* Look past tail */
+  while (nbits-- > first) {
+    for (uint32_t f = 0; f < nof_frames; f++) {
+      uint32_t s = state[f] >> 2;
+      uint32_t k = (d[nbits].w[s % 32] >> (f + 16 * (s / 32))) & 1;
+      state[f]   = (state[f] >> 1) | (k << 7);
+      if (nbits < first + len) {
+        data[f][nbits - first] = k;
+      }
+    }
+  }
+  return 0;
+}
+
+/* Delete instance of a batched Viterbi decoder */
+void delete_viterbi37_avx512_batch(void* p)
+{
+  struct v37_batch* vp = p;
+
+  if (vp != NULL) {
+    free(vp->decisions);
+    free(vp);
+  }
+}
+
+/* Runs the trellis of up to 16 frames at once, with the symbol layout of update_viterbi37_blk_avx2_batch(). The states
+ * j, j + 16, j + 32 and j + 48 go to the states 2j, 2j + 1, 2j + 32 and 2j + 33, which are the two registers of the new
+ * metrics 2j and 2j + 1, so every register of old metrics is combined with another one and every compare gives the
+ * decision word of two states directly */
+void update_viterbi37_blk_avx512_batch(void* p, const uint16_t* syms, uint32_t nbits, uint32_t* best_state)
+{
+  struct v37_batch* vp = p;
+  decision_t*       d;
+
+  if (p == NULL)
+    return;
+
+  const __m512i ones = _mm512_set1_epi16(-1);
+  const __m512i max  = _mm512_set1_epi16(8191);
+  const __m512i th   = _mm512_set1_epi16(16384);
+
+  d = vp->dp;
+
+  for (uint32_t n = 0; n < nbits; n++) {
+    __m512i  sym[3][2], avg[4], metric[8], m_metric[8];
+    __m512i* tmp;
+
+    /* The upper half of the registers gets the symbols of the states j + 16 */
+    for (uint32_t i = 0; i < 3; i++) {
+      sym[i][0] = _mm512_xor_si512(_mm512_broadcast_i64x4(_mm256_loadu_si256((__m256i*)&syms[16 * i])), vp->flip[i]);
+      sym[i][1] = _mm512_xor_si512(sym[i][0], ones);
+    }
+
+    syms += 3 * VITERBI37_BATCH_LANES;
+
+    /* Form the 8 possible branch metrics */
+    for (uint32_t i = 0; i < 4; i++) {
+      avg[i] = _mm512_avg_epu16(sym[0][i >> 1], sym[1][i & 1]);
+    }
+    for (uint32_t i = 0; i < 8; i++) {
+      metric[i]   = _mm512_srli_epi16(_mm512_avg_epu16(sym[2][i & 1], avg[i >> 1]), 3);
+      m_metric[i] = _mm512_sub_epi16(max, metric[i]);
+    }
+
+    for (uint32_t j = 0; j < 16; j++) {
+      __m512i m0, m1, m2, m3, a, b;
+
+      uint32_t br = vp->branch[j];
+
+      /* States j and j + 16 in a, states j + 32 and j + 48 in b */
+      a = _mm512_shuffle_i64x2(vp->old_metrics[j], vp->old_metrics[j + 16], 0x44);
+      b = _mm512_shuffle_i64x2(vp->old_metrics[j], vp->old_metrics[j + 16], 0xee);
+
+      m0 = _mm512_add_epi16(a, metric[br]);
+      m1 = _mm512_add_epi16(b, m_metric[br]);
+      m2 = _mm512_add_epi16(a, m_metric[br]);
+      m3 = _mm512_add_epi16(b, metric[br]);
+
+      d->w[2 * j]     = _mm512_cmpgt_epi16_mask(m0, m1);
+      d->w[2 * j + 1] = _mm512_cmpgt_epi16_mask(m2, m3);
+
+      vp->new_metrics[2 * j]     = _mm512_min_epi16(m0, m1);
+      vp->new_metrics[2 * j + 1] = _mm512_min_epi16(m2, m3);
+    }
+
+    // See if we need to normalize. The metrics of a frame stay close to each other, those of state 0 are subtracted
+    if (_mm512_cmpgt_epi16_mask(vp->new_metrics[0], th)) {
+      __m512i adjustv = _mm512_shuffle_i64x2(vp->new_metrics[0], vp->new_metrics[0], 0x44);
+      for (uint32_t i = 0; i < 32; i++) {
+        vp->new_metrics[i] = _mm512_sub_epi16(vp->new_metrics[i], adjustv);
+      }
+    }
+
+    d++;
+    /* Swap pointers to old and new metrics */
+    tmp             = vp->old_metrics;
+    vp->old_metrics = vp->new_metrics;
+    vp->new_metrics = tmp;
+  }
+
+  /* The chainback looks past the tail */
+  bzero(d, 6 * sizeof(decision_t));
+
+  if (best_state) {
+    int16_t metrics[32][2 * VITERBI37_BATCH_LANES];
+    for (uint32_t i = 0; i < 32; i++) {
+      _mm512_storeu_si512(metrics[i], vp->old_metrics[i]);
+    }
+    for (uint32_t f = 0; f < VITERBI37_BATCH_LANES; f++) {
+      uint32_t bst       = 0;
+      int16_t  minmetric = INT16_MAX;
+      for (uint32_t i = 0; i < 64; i++) {
+        if (metrics[i % 32][f + VITERBI37_BATCH_LANES * (i / 32)] <= minmetric) {
+          bst       = i;
+          minmetric = metrics[i % 32][f + VITERBI37_BATCH_LANES * (i / 32)];
+        }
+      }
+      best_state[f] = bst;
+    }
+  }
+
+  vp->dp = d;
+}
+
+#endif
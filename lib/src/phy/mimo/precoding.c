@@ -1821,6 +1821,203 @@ static int srslte_predecoding_multiplex_2x1_mrc_csi(cf_t*  y[SRSLTE_MAX_PORTS],
   return SRSLTE_SUCCESS;
 }
 
+/* 36.211 Table 6.3.4.2.3-2: generator vectors u_n of the 4 antenna port codebook, W_n = I - 2 u_n u_n' / (u_n' u_n) */
+static const cf_t precoding_4p_u[SRSLTE_PRECODING_4P_NOF_CODEBOOKS][4] = {
+    {1.0f, -1.0f, -1.0f, -1.0f},
+    {1.0f, -_Complex_I, 1.0f, _Complex_I},
+    {1.0f, 1.0f, -1.0f, 1.0f},
+    {1.0f, _Complex_I, 1.0f, -_Complex_I},
+    {1.0f, (-1.0f - _Complex_I) * (float)M_SQRT1_2, -_Complex_I, (1.0f - _Complex_I) * (float)M_SQRT1_2},
+    {1.0f, (1.0f - _Complex_I) * (float)M_SQRT1_2, _Complex_I, (-1.0f - _Complex_I) * (float)M_SQRT1_2},
+    {1.0f, (1.0f + _Complex_I) * (float)M_SQRT1_2, -_Complex_I, (-1.0f + _Complex_I) * (float)M_SQRT1_2},
+    {1.0f, (-1.0f + _Complex_I) * (float)M_SQRT1_2, _Complex_I, (1.0f + _Complex_I) * (float)M_SQRT1_2},
+    {1.0f, -1.0f, 1.0f, 1.0f},
+    {1.0f, -_Complex_I, -1.0f, -_Complex_I},
+    {1.0f, 1.0f, 1.0f, -1.0f},
+    {1.0f, _Complex_I, -1.0f, _Complex_I},
+    {1.0f, -1.0f, -1.0f, 1.0f},
+    {1.0f, -1.0f, 1.0f, -1.0f},
+    {1.0f, 1.0f, -1.0f, -1.0f},
+    {1.0f, 1.0f, 1.0f, 1.0f},
+};
+
+/* 36.211 Table 6.3.4.2.3-2: columns of W_n taken by each layer, for 1, 2, 3 and 4 layers */
+static const uint8_t precoding_4p_columns[SRSLTE_PRECODING_4P_NOF_CODEBOOKS][4][4] = {
+    {{0}, {0, 3}, {0, 1, 3}, {0, 1, 2, 3}}, {{0}, {0, 1}, {0, 1, 2}, {0, 1, 2, 3}},
+    {{0}, {0, 1}, {0, 1, 2}, {2, 1, 0, 3}}, {{0}, {0, 1}, {0, 1, 2}, {2, 1, 0, 3}},
+    {{0}, {0, 3}, {0, 1, 3}, {0, 1, 2, 3}}, {{0}, {0, 3}, {0, 1, 3}, {0, 1, 2, 3}},
+    {{0}, {0, 2}, {0, 2, 3}, {0, 2, 1, 3}}, {{0}, {0, 2}, {0, 2, 3}, {0, 2, 1, 3}},
+    {{0}, {0, 1}, {0, 1, 3}, {0, 1, 2, 3}}, {{0}, {0, 3}, {0, 2, 3}, {0, 1, 2, 3}},
+    {{0}, {0, 2}, {0, 1, 2}, {0, 2, 1, 3}}, {{0}, {0, 2}, {0, 2, 3}, {0, 2, 1, 3}},
+    {{0}, {0, 1}, {0, 1, 2}, {0, 1, 2, 3}}, {{0}, {0, 2}, {0, 1, 2}, {0, 2, 1, 3}},
+    {{0}, {0, 2}, {0, 1, 2}, {2, 1, 0, 3}}, {{0}, {0, 1}, {0, 1, 2}, {0, 1, 2, 3}},
+};
+
+/* Precoding matrix W[port][layer] of the 4 antenna port codebook, without the 1/sqrt(nof_layers) normalization */
+static int precoding_4p_matrix(int codebook_idx, int nof_layers, cf_t w[4][4])
+{
+  if (codebook_idx < 0 || codebook_idx >= SRSLTE_PRECODING_4P_NOF_CODEBOOKS || nof_layers < 1 || nof_layers > 4) {
+    ERROR("Invalid 4 port codebook_idx=%d for %d layers\n", codebook_idx, nof_layers);
+    return SRSLTE_ERROR;
+  }
+
+  const cf_t* u = precoding_4p_u[codebook_idx];
+  for (int l = 0; l < nof_layers; l++) {
+    int c = precoding_4p_columns[codebook_idx][nof_layers - 1][l];
+    for (int p = 0; p < 4; p++) {
+      w[p][l] = ((p == c) ? 1.0f : 0.0f) - u[p] * conjf(u[c]) / 2.0f;
+    }
+  }
+  return SRSLTE_SUCCESS;
+}
+
+/* Effective channel H x W of the resource element i, as H[rx][layer]. Since W is a Householder matrix, the column c
+ * of H x W is the column c of H minus (H x u) x conj(u_c) / 2 */
+static void precoding_4p_channel_gen(cf_t* h[SRSLTE_MAX_PORTS][SRSLTE_MAX_PORTS],
+                                     int   i,
+                                     int   nof_rxant,
+                                     int   nof_layers,
+                                     int   codebook_idx,
+                                     cf_t  heff[4][4])
+{
+  const cf_t*    u    = precoding_4p_u[codebook_idx];
+  const uint8_t* cols = precoding_4p_columns[codebook_idx][nof_layers - 1];
+
+  for (int r = 0; r < nof_rxant; r++) {
+    cf_t g = h[0][r][i] + h[1][r][i] * u[1] + h[2][r][i] * u[2] + h[3][r][i] * u[3];
+    for (int l = 0; l < nof_layers; l++) {
+      heff[r][l] = h[cols[l]][r][i] - g * conjf(u[cols[l]]) / 2.0f;
+    }
+  }
+}
+
+/* Number of layers mapped onto the first codeword (36.211 Table 6.3.3.2-1), the rest go to the second one */
+static inline int precoding_cw0_layers(int nof_layers)
+{
+  return (nof_layers < 2) ? 1 : nof_layers / 2;
+}
+
+#if SRSLTE_SIMD_CF_SIZE != 0
+/* Stores the CSI of the layers of a codeword interleaved, as in the layer demapper */
+static inline void precoding_4p_csi_simd(float* csi, simd_f_t* c, int nof_layers_cw, int i)
+{
+  if (nof_layers_cw == 1) {
+    srslte_simd_f_storeu(&csi[i], c[0]);
+  } else if (nof_layers_cw == 2) {
+    simd_cf_t c01;
+#if HAVE_NEON
+    c01.val[0] = c[0];
+    c01.val[1] = c[1];
+#else  /* HAVE_NEON */
+    c01.re = c[0];
+    c01.im = c[1];
+#endif /* HAVE_NEON */
+    srslte_simd_cfi_storeu((cf_t*)&csi[2 * i], c01);
+  }
+}
+#endif /* SRSLTE_SIMD_CF_SIZE != 0 */
+
+// MMSE/ZF equalizer of 4 antenna port Spatial Multiplexing, for up to 4 layers and 4 receive antennas
+static int srslte_predecoding_multiplex_4p(cf_t*  y[SRSLTE_MAX_PORTS],
+                                           cf_t*  h[SRSLTE_MAX_PORTS][SRSLTE_MAX_PORTS],
+                                           cf_t*  x[SRSLTE_MAX_LAYERS],
+                                           float* csi[SRSLTE_MAX_CODEWORDS],
+                                           int    nof_rxant,
+                                           int    nof_layers,
+                                           int    codebook_idx,
+                                           int    nof_symbols,
+                                           float  scaling,
+                                           float  noise_estimate)
+{
+  cf_t w[4][4];
+  int  i = 0;
+
+  if (precoding_4p_matrix(codebook_idx, nof_layers, w)) {
+    return SRSLTE_ERROR;
+  }
+  if (nof_rxant < nof_layers || nof_rxant > 4) {
+    ERROR("Error predecoding multiplex: %d layers can not be separated with %d rx antennas\n", nof_layers, nof_rxant);
+    return SRSLTE_ERROR;
+  }
+
+  /* The transmitter scales every layer by scaling / sqrt(nof_layers), as the other decoders the noise estimate is
+   * relative to the scaling */
+  float norm  = sqrtf((float)nof_layers) / scaling;
+  float noise = (mimo_decoder == SRSLTE_MIMO_DECODER_MMSE) ? noise_estimate * nof_layers : 0.0f;
+
+  int nof_layers_cw0 = precoding_cw0_layers(nof_layers);
+  int nof_layers_cw1 = nof_layers - nof_layers_cw0;
+
+#if SRSLTE_SIMD_CF_SIZE != 0
+  const cf_t*    u    = precoding_4p_u[codebook_idx];
+  const uint8_t* cols = precoding_4p_columns[codebook_idx][nof_layers - 1];
+
+  simd_cf_t _u[4], _uc[4];
+  for (int p = 0; p < 4; p++) {
+    _u[p] = srslte_simd_cf_set1(u[p]);
+  }
+  for (int l = 0; l < nof_layers; l++) {
+    _uc[l] = srslte_simd_cf_set1(conjf(u[cols[l]]) / 2.0f);
+  }
+
+  for (; i < nof_symbols - SRSLTE_SIMD_CF_SIZE + 1; i += SRSLTE_SIMD_CF_SIZE) {
+    simd_cf_t _y[4], _h[4][4], _x[4];
+    simd_f_t  _csi[4];
+
+    for (int r = 0; r < nof_rxant; r++) {
+      simd_cf_t hp[4];
+      for (int p = 0; p < 4; p++) {
+        hp[p] = srslte_simd_cfi_load(&h[p][r][i]);
+      }
+      simd_cf_t g = hp[0];
+      for (int p = 1; p < 4; p++) {
+        g = srslte_simd_cf_add(g, srslte_simd_cf_prod(hp[p], _u[p]));
+      }
+      for (int l = 0; l < nof_layers; l++) {
+        _h[r][l] = srslte_simd_cf_sub(hp[cols[l]], srslte_simd_cf_prod(g, _uc[l]));
+      }
+      _y[r] = srslte_simd_cfi_load(&y[r][i]);
+    }
+
+    srslte_mat_4x4_mmse_csi_simd(_y, _h, nof_rxant, nof_layers, _x, _csi, noise, norm);
+
+    for (int l = 0; l < nof_layers; l++) {
+      srslte_simd_cfi_store(&x[l][i], _x[l]);
+    }
+
+    if (csi && csi[0]) {
+      precoding_4p_csi_simd(csi[0], &_csi[0], nof_layers_cw0, i);
+      precoding_4p_csi_simd(csi[1], &_csi[nof_layers_cw0], nof_layers_cw1, i);
+    }
+  }
+#endif /* SRSLTE_SIMD_CF_SIZE */
+
+  for (; i < nof_symbols; i++) {
+    cf_t  _y[4], _h[4][4], _x[4];
+    float _csi[4];
+
+    for (int r = 0; r < nof_rxant; r++) {
+      _y[r] = y[r][i];
+    }
+    precoding_4p_channel_gen(h, i, nof_rxant, nof_layers, codebook_idx, _h);
+
+    srslte_mat_4x4_mmse_csi_gen(_y, _h, nof_rxant, nof_layers, _x, _csi, noise, norm);
+
+    for (int l = 0; l < nof_layers; l++) {
+      x[l][i] = _x[l];
+    }
+    if (csi && csi[0]) {
+      for (int l = 0; l < nof_layers_cw0; l++) {
+        csi[0][nof_layers_cw0 * i + l] = _csi[l];
+      }
+      for (int l = 0; l < nof_layers_cw1; l++) {
+        csi[1][nof_layers_cw1 * i + l] = _csi[nof_layers_cw0 + l];
+      }
+    }
+  }
+  return SRSLTE_SUCCESS;
+}
+
 static int srslte_predecoding_multiplex(cf_t*  y[SRSLTE_MAX_PORTS],
                                         cf_t*  h[SRSLTE_MAX_PORTS][SRSLTE_MAX_PORTS],
                                         cf_t*  x[SRSLTE_MAX_LAYERS],
@@ -1860,7 +2057,8 @@ static int srslte_predecoding_multiplex(cf_t*  y[SRSLTE_MAX_PORTS],
       }
     }
   } else if (nof_ports == 4) {
-    ERROR("Error predecoding multiplex: not implemented for %d Tx ports", nof_ports);
+    return srslte_predecoding_multiplex_4p(
+        y, h, x, csi, nof_rxant, nof_layers, codebook_idx, nof_symbols, scaling, noise_estimate);
   } else {
     ERROR("Error predecoding multiplex: Invalid combination of ports %d and rx antennas %d\n", nof_ports, nof_rxant);
   }
@@ -2095,6 +2293,61 @@ int srslte_precoding_cdd(cf_t* x[SRSLTE_MAX_LAYERS],
   }
 }
 
+static int srslte_precoding_multiplex_4p(cf_t*    x[SRSLTE_MAX_LAYERS],
+                                         cf_t*    y[SRSLTE_MAX_PORTS],
+                                         int      nof_layers,
+                                         int      codebook_idx,
+                                         uint32_t nof_symbols,
+                                         float    scaling)
+{
+  cf_t     w[4][4];
+  uint32_t i = 0;
+
+  if (precoding_4p_matrix(codebook_idx, nof_layers, w)) {
+    return SRSLTE_ERROR;
+  }
+
+  scaling /= sqrtf((float)nof_layers);
+  for (int p = 0; p < 4; p++) {
+    for (int l = 0; l < nof_layers; l++) {
+      w[p][l] *= scaling;
+    }
+  }
+
+#if SRSLTE_SIMD_CF_SIZE != 0
+  simd_cf_t _w[4][4];
+  for (int p = 0; p < 4; p++) {
+    for (int l = 0; l < nof_layers; l++) {
+      _w[p][l] = srslte_simd_cf_set1(w[p][l]);
+    }
+  }
+
+  for (; i + SRSLTE_SIMD_CF_SIZE <= nof_symbols; i += SRSLTE_SIMD_CF_SIZE) {
+    simd_cf_t _x[4];
+    for (int l = 0; l < nof_layers; l++) {
+      _x[l] = srslte_simd_cfi_load(&x[l][i]);
+    }
+    for (int p = 0; p < 4; p++) {
+      simd_cf_t _y = srslte_simd_cf_prod(_x[0], _w[p][0]);
+      for (int l = 1; l < nof_layers; l++) {
+        _y = srslte_simd_cf_add(_y, srslte_simd_cf_prod(_x[l], _w[p][l]));
+      }
+      srslte_simd_cfi_store(&y[p][i], _y);
+    }
+  }
+#endif /* SRSLTE_SIMD_CF_SIZE != 0 */
+
+  for (; i < nof_symbols; i++) {
+    for (int p = 0; p < 4; p++) {
+      y[p][i] = 0;
+      for (int l = 0; l < nof_layers; l++) {
+        y[p][i] += x[l][i] * w[p][l];
+      }
+    }
+  }
+  return SRSLTE_SUCCESS;
+}
+
 int srslte_precoding_multiplex(cf_t*    x[SRSLTE_MAX_LAYERS],
                                cf_t*    y[SRSLTE_MAX_PORTS],
                                int      nof_layers,
@@ -2215,6 +2468,8 @@ int srslte_precoding_multiplex(cf_t*    x[SRSLTE_MAX_LAYERS],
     } else {
       ERROR("Not implemented");
     }
+  } else if (nof_ports == 4) {
+    return srslte_precoding_multiplex_4p(x, y, nof_layers, codebook_idx, nof_symbols, scaling);
   } else {
     ERROR("Not implemented");
   }
@@ -2850,3 +3105,66 @@ int srslte_precoding_cn(cf_t*    h[SRSLTE_MAX_PORTS][SRSLTE_MAX_PORTS],
     return SRSLTE_ERROR;
   }
 }
+
+/* Post-detection MMSE SINR of every layer of 4 antenna port Spatial Multiplexing, averaged over the resource elements
+ * every PMI_SEL_PRECISION */
+int srslte_precoding_multiplex_sinr(cf_t*    h[SRSLTE_MAX_PORTS][SRSLTE_MAX_PORTS],
+                                    uint32_t nof_rxant,
+                                    uint32_t nof_ports,
+                                    uint32_t nof_layers,
+                                    uint32_t codebook_idx,
+                                    uint32_t nof_symbols,
+                                    float    noise_estimate,
+                                    float    sinr[SRSLTE_MAX_LAYERS])
+{
+  cf_t  w[4][4];
+  float count = 0.0f;
+
+  if (nof_ports != 4 || nof_rxant < nof_layers || nof_rxant > 4) {
+    ERROR("MIMO SINR estimation not implemented for %d ports, %d layers and %d rx antennas\n",
+          nof_ports,
+          nof_layers,
+          nof_rxant);
+    return SRSLTE_ERROR;
+  }
+  if (precoding_4p_matrix(codebook_idx, nof_layers, w)) {
+    return SRSLTE_ERROR;
+  }
+
+  // Bound noise estimate value
+  if (!isnormal(noise_estimate) || noise_estimate < 1e-9f) {
+    noise_estimate = 1e-9f;
+  }
+
+  /* Every layer gets 1 / nof_layers of the power */
+  float noise = noise_estimate * nof_layers;
+
+  for (uint32_t l = 0; l < nof_layers; l++) {
+    sinr[l] = 0.0f;
+  }
+
+  for (uint32_t i = 0; i < nof_symbols; i += PMI_SEL_PRECISION) {
+    cf_t  y[4] = {}, x[4], heff[4][4];
+    float csi[4];
+
+    precoding_4p_channel_gen(h, i, nof_rxant, nof_layers, codebook_idx, heff);
+    srslte_mat_4x4_mmse_csi_gen(y, heff, nof_rxant, nof_layers, x, csi, noise, 1.0f);
+
+    /* The MMSE SINR is 1 / (noise x inv(H' x H + No)_kk) - 1 */
+    for (uint32_t l = 0; l < nof_layers; l++) {
+      float gamma = csi[l] / noise - 1.0f;
+      sinr[l] += isnormal(gamma) && gamma > 1e-9f ? gamma : 1e-9f;
+    }
+    count += 1.0f;
+  }
+
+  for (uint32_t l = 0; l < nof_layers; l++) {
+    if (isnormal(count)) {
+      sinr[l] /= count;
+    } else {
+      sinr[l] = 1e+9f;
+    }
+  }
+
+  return SRSLTE_SUCCESS;
+}
@@ -33,6 +33,7 @@
 #include "srslte/srslte.h"
 
 #define MSE_THRESHOLD 0.0005
+#define SINR_ERROR_THRESHOLD 0.1
 
 int                    nof_symbols  = 1000;
 uint32_t               codebook_idx = 0;
@@ -170,6 +171,54 @@ static void awgn(cf_t* y[SRSLTE_MAX_PORTS], uint32_t n, float snr)
   }
 }
 
+/* Compares the error power of every layer after MMSE detection with the one predicted by the SINR estimate of each
+ * resource element */
+static int test_multiplex_sinr(cf_t* x[SRSLTE_MAX_LAYERS],
+                              cf_t* xr[SRSLTE_MAX_LAYERS],
+                              cf_t* h[SRSLTE_MAX_PORTS][SRSLTE_MAX_PORTS])
+{
+  float expected[SRSLTE_MAX_LAYERS] = {};
+  float measured[SRSLTE_MAX_LAYERS] = {};
+
+  for (int k = 0; k < nof_re; k++) {
+    cf_t* h_re[SRSLTE_MAX_PORTS][SRSLTE_MAX_PORTS] = {};
+    float sinr[SRSLTE_MAX_LAYERS]                  = {};
+    for (int p = 0; p < nof_tx_ports; p++) {
+      for (int r = 0; r < nof_rx_ports; r++) {
+        h_re[p][r] = &h[p][r][k];
+      }
+    }
+    if (srslte_precoding_multiplex_sinr(h_re,
+                                        nof_rx_ports,
+                                        nof_tx_ports,
+                                        nof_layers,
+                                        codebook_idx,
+                                        1,
+                                        srslte_convert_dB_to_power(-snr_db),
+                                        sinr)) {
+      return SRSLTE_ERROR;
+    }
+    for (int l = 0; l < nof_layers; l++) {
+      cf_t e = xr[l][k] - x[l][k];
+      expected[l] += 1.0f / (1.0f + sinr[l]);
+      measured[l] += crealf(e) * crealf(e) + cimagf(e) * cimagf(e);
+    }
+  }
+
+  for (int l = 0; l < nof_layers; l++) {
+    float error = measured[l] / expected[l] - 1.0f;
+    printf("Layer %d error power: measured %.1fdB, expected %.1fdB\n",
+           l,
+           srslte_convert_power_to_dB(measured[l] / nof_re),
+           srslte_convert_power_to_dB(expected[l] / nof_re));
+    if (fabsf(error) > SINR_ERROR_THRESHOLD) {
+      ERROR("The SINR of layer %d does not match the measured error (%+.1f%%)\n", l, 100.0f * error);
+      return SRSLTE_ERROR;
+    }
+  }
+  return SRSLTE_SUCCESS;
+}
+
 int main(int argc, char** argv)
 {
   int   i, j, k, nof_errors = 0, ret = SRSLTE_SUCCESS;
@@ -192,6 +241,10 @@ int main(int argc, char** argv)
     exit(-1);
   }
 
+  /* The SINR estimate predicts the MMSE error when the noise is above the 1e-9 bound of the estimators */
+  bool check_sinr = type == SRSLTE_TXSCHEME_SPATIALMUX && nof_tx_ports == 4 &&
+                    strncmp(decoder_type_name, "mmse", 16) == 0 && snr_db < 90.0f;
+
   /* Check scenario conditions are OK */
   switch (type) {
     case SRSLTE_TXSCHEME_DIVERSITY:
@@ -335,10 +388,38 @@ int main(int argc, char** argv)
          t[0].tv_usec,
          mse / nof_layers / nof_symbols,
          (float)nof_errors / (4.0f * nof_re));
-  if (mse / nof_layers / nof_symbols > MSE_THRESHOLD) {
+  if (t[0].tv_sec == 0 && t[0].tv_usec > 0) {
+    printf("Predecoding throughput: %.1f RE/us\n", (float)nof_re / t[0].tv_usec);
+  }
+  if (!check_sinr && mse / nof_layers / nof_symbols > MSE_THRESHOLD) {
     ret = SRSLTE_ERROR;
   }
 
+  /* Post-detection SINR of every layer, from which the rank and CQI are chosen */
+  if (type == SRSLTE_TXSCHEME_SPATIALMUX && nof_tx_ports == 4) {
+    float sinr[SRSLTE_MAX_LAYERS] = {};
+    if (srslte_precoding_multiplex_sinr(h,
+                                        nof_rx_ports,
+                                        nof_tx_ports,
+                                        nof_layers,
+                                        codebook_idx,
+                                        nof_re,
+                                        srslte_convert_dB_to_power(-snr_db),
+                                        sinr)) {
+      ret = SRSLTE_ERROR;
+    }
+    printf("Layer SINR:");
+    for (i = 0; i < nof_layers; i++) {
+      printf(" %.1fdB", srslte_convert_power_to_dB(sinr[i]));
+    }
+    printf("\n");
+
+    /* The MMSE error of a resource element is 1 / (1 + SINR), it must match the measured one */
+    if (check_sinr && test_multiplex_sinr(x, xr, h) != SRSLTE_SUCCESS) {
+      ret = SRSLTE_ERROR;
+    }
+  }
+
 quit:
   srslte_random_free(random_gen);
 
@@ -23,9 +23,11 @@
 #include <stdlib.h>
 #include <strings.h>
 
+#include "demod_soft_256qam.h"
 #include "srslte/phy/modem/demod_soft.h"
 #include "srslte/phy/utils/bit.h"
 #include "srslte/phy/utils/debug.h"
+#include "srslte/phy/utils/simd_dispatch.h"
 #include "srslte/phy/utils/vector.h"
 
 #ifdef HAVE_NEONv8
@@ -101,12 +103,10 @@ void demod_16qam_lte_s_sse(const cf_t* symbols, short* llr, int nsymbols);
 #define SCALE_SHORT_CONV_QPSK 100
 #define SCALE_SHORT_CONV_QAM16 400
 #define SCALE_SHORT_CONV_QAM64 700
-#define SCALE_SHORT_CONV_QAM256 1000
 
 #define SCALE_BYTE_CONV_QPSK 20
 #define SCALE_BYTE_CONV_QAM16 30
 #define SCALE_BYTE_CONV_QAM64 40
-#define SCALE_BYTE_CONV_QAM256 50
 
 void demod_bpsk_lte_b(const cf_t* symbols, int8_t* llr, int nsymbols)
 {
@@ -824,7 +824,7 @@ void demod_256qam_lte(const cf_t* symbols, float* llr, int nsymbols)
   }
 }
 
-void demod_256qam_lte_b(const cf_t* symbols, int8_t* llr, int nsymbols)
+void demod_256qam_lte_b_generic(const cf_t* symbols, int8_t* llr, int nsymbols)
 {
   for (int i = 0; i < nsymbols; i++) {
     float real = -__real__ symbols[i];
@@ -846,7 +846,7 @@ void demod_256qam_lte_b(const cf_t* symbols, int8_t* llr, int nsymbols)
   }
 }
 
-void demod_256qam_lte_s(const cf_t* symbols, short* llr, int nsymbols)
+void demod_256qam_lte_s_generic(const cf_t* symbols, short* llr, int nsymbols)
 {
   for (int i = 0; i < nsymbols; i++) {
     float real = -__real__ symbols[i];
@@ -868,6 +868,143 @@ void demod_256qam_lte_s(const cf_t* symbols, short* llr, int nsymbols)
   }
 }
 
+#ifdef LV_HAVE_SSE
+
+/* Folds 2 symbols over the decision thresholds in floating point and truncates the scaled LLRs, like the scalar
+ * demapper, so that the LLRs of every kernel are the same */
+static inline void demod_256qam_fold_sse(const float* symbols_ptr, __m128 scale, __m128i llr[4])
+{
+  __m128 sign = _mm_set1_ps(-0.0f);
+  __m128 llr0 = _mm_xor_ps(_mm_loadu_ps(symbols_ptr), sign);
+  __m128 llr1 = _mm_sub_ps(_mm_andnot_ps(sign, llr0), _mm_set1_ps(8.0f / sqrtf(170.0f)));
+  __m128 llr2 = _mm_sub_ps(_mm_andnot_ps(sign, llr1), _mm_set1_ps(4.0f / sqrtf(170.0f)));
+  __m128 llr3 = _mm_sub_ps(_mm_andnot_ps(sign, llr2), _mm_set1_ps(2.0f / sqrtf(170.0f)));
+  llr[0]      = _mm_cvttps_epi32(_mm_mul_ps(llr0, scale));
+  llr[1]      = _mm_cvttps_epi32(_mm_mul_ps(llr1, scale));
+  llr[2]      = _mm_cvttps_epi32(_mm_mul_ps(llr2, scale));
+  llr[3]      = _mm_cvttps_epi32(_mm_mul_ps(llr3, scale));
+}
+
+int demod_256qam_lte_s_sse(const cf_t* symbols, int16_t* llr, int nsymbols)
+{
+  const float* symbols_ptr = (const float*)symbols;
+  __m128i*     llr_ptr     = (__m128i*)llr;
+  __m128       scale       = _mm_set1_ps(SCALE_SHORT_CONV_QAM256);
+  __m128i      min_llr     = _mm_set1_epi16(-INT16_MAX);
+  __m128i      llr_1[4], llr_2[4];
+
+  int i = 0;
+  for (; i < nsymbols - 3; i += 4) {
+    demod_256qam_fold_sse(symbols_ptr, scale, llr_1);
+    demod_256qam_fold_sse(symbols_ptr + 4, scale, llr_2);
+    symbols_ptr += 8;
+
+    // Every 32-bit element holds the real and imaginary LLR of a symbol for each pair of bits. The LLRs of the lower
+    // bits are the distance to the decision boundaries, folded over the previous ones
+    __m128i llr0 = _mm_max_epi16(_mm_packs_epi32(llr_1[0], llr_2[0]), min_llr);
+    __m128i llr1 = _mm_packs_epi32(llr_1[1], llr_2[1]);
+    __m128i llr2 = _mm_packs_epi32(llr_1[2], llr_2[2]);
+    __m128i llr3 = _mm_packs_epi32(llr_1[3], llr_2[3]);
+
+    // Transpose so that the 8 LLRs of every symbol are consecutive
+    __m128i llr01_lo = _mm_unpacklo_epi32(llr0, llr1);
+    __m128i llr23_lo = _mm_unpacklo_epi32(llr2, llr3);
+    __m128i llr01_hi = _mm_unpackhi_epi32(llr0, llr1);
+    __m128i llr23_hi = _mm_unpackhi_epi32(llr2, llr3);
+    _mm_storeu_si128(llr_ptr++, _mm_unpacklo_epi64(llr01_lo, llr23_lo));
+    _mm_storeu_si128(llr_ptr++, _mm_unpackhi_epi64(llr01_lo, llr23_lo));
+    _mm_storeu_si128(llr_ptr++, _mm_unpacklo_epi64(llr01_hi, llr23_hi));
+    _mm_storeu_si128(llr_ptr++, _mm_unpackhi_epi64(llr01_hi, llr23_hi));
+  }
+
+  return i;
+}
+
+int demod_256qam_lte_b_sse(const cf_t* symbols, int8_t* llr, int nsymbols)
+{
+  const float* symbols_ptr = (const float*)symbols;
+  __m128i*     llr_ptr     = (__m128i*)llr;
+  __m128       scale       = _mm_set1_ps(SCALE_BYTE_CONV_QAM256);
+  __m128i      min_llr     = _mm_set1_epi8(-INT8_MAX);
+  __m128i      llr_1[4], llr_2[4], llr_3[4], llr_4[4], llr_k[4];
+
+  int i = 0;
+  for (; i < nsymbols - 7; i += 8) {
+    demod_256qam_fold_sse(symbols_ptr, scale, llr_1);
+    demod_256qam_fold_sse(symbols_ptr + 4, scale, llr_2);
+    demod_256qam_fold_sse(symbols_ptr + 8, scale, llr_3);
+    demod_256qam_fold_sse(symbols_ptr + 12, scale, llr_4);
+    symbols_ptr += 16;
+
+    // Every 16-bit element holds the real and imaginary LLR of a symbol for each pair of bits
+    for (int k = 0; k < 4; k++) {
+      llr_k[k] = _mm_packs_epi16(_mm_packs_epi32(llr_1[k], llr_2[k]), _mm_packs_epi32(llr_3[k], llr_4[k]));
+    }
+    __m128i llr0 = _mm_max_epi8(llr_k[0], min_llr);
+    __m128i llr1 = llr_k[1];
+    __m128i llr2 = llr_k[2];
+    __m128i llr3 = llr_k[3];
+
+    // Transpose so that the 8 LLRs of every symbol are consecutive
+    __m128i llr01_lo = _mm_unpacklo_epi16(llr0, llr1);
+    __m128i llr23_lo = _mm_unpacklo_epi16(llr2, llr3);
+    __m128i llr01_hi = _mm_unpackhi_epi16(llr0, llr1);
+    __m128i llr23_hi = _mm_unpackhi_epi16(llr2, llr3);
+    _mm_storeu_si128(llr_ptr++, _mm_unpacklo_epi32(llr01_lo, llr23_lo));
+    _mm_storeu_si128(llr_ptr++, _mm_unpackhi_epi32(llr01_lo, llr23_lo));
+    _mm_storeu_si128(llr_ptr++, _mm_unpacklo_epi32(llr01_hi, llr23_hi));
+    _mm_storeu_si128(llr_ptr++, _mm_unpackhi_epi32(llr01_hi, llr23_hi));
+  }
+
+  return i;
+}
+
+#endif
+
+void demod_256qam_lte_b(const cf_t* symbols, int8_t* llr, int nsymbols)
+{
+  int i = 0;
+
+  // Every kernel leaves the symbols that do not fill its vectors to the narrower ones
+#ifdef SRSLTE_SIMD_KERNELS_AVX512
+  if (srslte_simd_isa() >= SRSLTE_SIMD_ISA_AVX512) {
+    i += demod_256qam_lte_b_avx512(&symbols[i], &llr[8 * i], nsymbols - i);
+  }
+#endif /* SRSLTE_SIMD_KERNELS_AVX512 */
+#ifdef SRSLTE_SIMD_KERNELS_AVX2
+  if (srslte_simd_isa() >= SRSLTE_SIMD_ISA_AVX2) {
+    i += demod_256qam_lte_b_avx2(&symbols[i], &llr[8 * i], nsymbols - i);
+  }
+#endif /* SRSLTE_SIMD_KERNELS_AVX2 */
+#ifdef LV_HAVE_SSE
+  i += demod_256qam_lte_b_sse(&symbols[i], &llr[8 * i], nsymbols - i);
+#endif /* LV_HAVE_SSE */
+
+  demod_256qam_lte_b_generic(&symbols[i], &llr[8 * i], nsymbols - i);
+}
+
+void demod_256qam_lte_s(const cf_t* symbols, short* llr, int nsymbols)
+{
+  int i = 0;
+
+  // Every kernel leaves the symbols that do not fill its vectors to the narrower ones
+#ifdef SRSLTE_SIMD_KERNELS_AVX512
+  if (srslte_simd_isa() >= SRSLTE_SIMD_ISA_AVX512) {
+    i += demod_256qam_lte_s_avx512(&symbols[i], &llr[8 * i], nsymbols - i);
+  }
+#endif /* SRSLTE_SIMD_KERNELS_AVX512 */
+#ifdef SRSLTE_SIMD_KERNELS_AVX2
+  if (srslte_simd_isa() >= SRSLTE_SIMD_ISA_AVX2) {
+    i += demod_256qam_lte_s_avx2(&symbols[i], &llr[8 * i], nsymbols - i);
+  }
+#endif /* SRSLTE_SIMD_KERNELS_AVX2 */
+#ifdef LV_HAVE_SSE
+  i += demod_256qam_lte_s_sse(&symbols[i], &llr[8 * i], nsymbols - i);
+#endif /* LV_HAVE_SSE */
+
+  demod_256qam_lte_s_generic(&symbols[i], &llr[8 * i], nsymbols - i);
+}
+
 int srslte_demod_soft_demodulate(srslte_mod_t modulation, const cf_t* symbols, float* llr, int nsymbols)
 {
   switch (modulation) {
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+
+#ifndef SRSLTE_DEMOD_SOFT_256QAM_H_
+#define SRSLTE_DEMOD_SOFT_256QAM_H_
+
+#include <stdint.h>
+
+#include "srslte/config.h"
+
+#define SCALE_SHORT_CONV_QAM256 1000
+#define SCALE_BYTE_CONV_QAM256 50
+
+/* Scalar max-log 256QAM demappers, the reference of the vector kernels */
+void demod_256qam_lte_s_generic(const cf_t* symbols, short* llr, int nsymbols);
+
+void demod_256qam_lte_b_generic(const cf_t* symbols, int8_t* llr, int nsymbols);
+
+/* Max-log 256QAM demappers. Every one demodulates the largest multiple of its vector width that fits in nsymbols and
+ * returns the number of symbols demodulated, the caller demodulates the rest */
+int demod_256qam_lte_s_sse(const cf_t* symbols, int16_t* llr, int nsymbols);
+
+int demod_256qam_lte_b_sse(const cf_t* symbols, int8_t* llr, int nsymbols);
+
+int demod_256qam_lte_s_avx2(const cf_t* symbols, int16_t* llr, int nsymbols);
+
+int demod_256qam_lte_b_avx2(const cf_t* symbols, int8_t* llr, int nsymbols);
+
+int demod_256qam_lte_s_avx512(const cf_t* symbols, int16_t* llr, int nsymbols);
+
+int demod_256qam_lte_b_avx512(const cf_t* symbols, int8_t* llr, int nsymbols);
+
+#endif // SRSLTE_DEMOD_SOFT_256QAM_H_
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+
+#include <math.h>
+
+#include "demod_soft_256qam.h"
+
+/* AVX512 256QAM demappers. They are built in their own translation unit so that, with ENABLE_SIMD_DISPATCH, this is the
+ * only code compiled for AVX512 and the demodulator selects it at runtime */
+#ifdef LV_HAVE_AVX512
+#include <immintrin.h>
+
+/* Folds the symbols over the decision thresholds in floating point and truncates the scaled LLRs, like the scalar
+ * demapper, so that the LLRs of every kernel are the same */
+static inline void demod_256qam_fold_avx512(const float* symbols_ptr, __m512 scale, __m512i llr[4])
+{
+  __m512 sign = _mm512_set1_ps(-0.0f);
+  __m512 llr0 = _mm512_xor_ps(_mm512_loadu_ps(symbols_ptr), sign);
+  __m512 llr1 = _mm512_sub_ps(_mm512_andnot_ps(sign, llr0), _mm512_set1_ps(8.0f / sqrtf(170.0f)));
+  __m512 llr2 = _mm512_sub_ps(_mm512_andnot_ps(sign, llr1), _mm512_set1_ps(4.0f / sqrtf(170.0f)));
+  __m512 llr3 = _mm512_sub_ps(_mm512_andnot_ps(sign, llr2), _mm512_set1_ps(2.0f / sqrtf(170.0f)));
+  llr[0]      = _mm512_cvttps_epi32(_mm512_mul_ps(llr0, scale));
+  llr[1]      = _mm512_cvttps_epi32(_mm512_mul_ps(llr1, scale));
+  llr[2]      = _mm512_cvttps_epi32(_mm512_mul_ps(llr2, scale));
+  llr[3]      = _mm512_cvttps_epi32(_mm512_mul_ps(llr3, scale));
+}
+
+int demod_256qam_lte_s_avx512(const cf_t* symbols, int16_t* llr, int nsymbols)
+{
+  const float* symbols_ptr = (const float*)symbols;
+  __m512i*     llr_ptr     = (__m512i*)llr;
+  __m512       scale       = _mm512_set1_ps(SCALE_SHORT_CONV_QAM256);
+  __m512i      min_llr     = _mm512_set1_epi16(-INT16_MAX);
+  __m512i      llr_1[4], llr_2[4], llr_k[4];
+
+  // The packing leaves symbols 2k, 2k + 1, 2k + 8 and 2k + 9 in the lane k. Reorder them so that the lane k holds
+  // symbols k, k + 4, k + 8 and k + 12 and the transpose below stores them in order
+  __m512i symbol_order = _mm512_setr_epi32(0, 8, 2, 10, 1, 9, 3, 11, 4, 12, 6, 14, 5, 13, 7, 15);
+
+  int i = 0;
+  for (; i < nsymbols - 15; i += 16) {
+    demod_256qam_fold_avx512(symbols_ptr, scale, llr_1);
+    demod_256qam_fold_avx512(symbols_ptr + 16, scale, llr_2);
+    symbols_ptr += 32;
+
+    // Every 32-bit element holds the real and imaginary LLR of a symbol for each pair of bits
+    for (int k = 0; k < 4; k++) {
+      llr_k[k] = _mm512_permutexvar_epi32(symbol_order, _mm512_packs_epi32(llr_1[k], llr_2[k]));
+    }
+    __m512i llr0 = _mm512_max_epi16(llr_k[0], min_llr);
+    __m512i llr1 = llr_k[1];
+    __m512i llr2 = llr_k[2];
+    __m512i llr3 = llr_k[3];
+
+    // Transpose so that the 8 LLRs of every symbol are consecutive
+    __m512i llr01_lo = _mm512_unpacklo_epi32(llr0, llr1);
+    __m512i llr23_lo = _mm512_unpacklo_epi32(llr2, llr3);
+    __m512i llr01_hi = _mm512_unpackhi_epi32(llr0, llr1);
+    __m512i llr23_hi = _mm512_unpackhi_epi32(llr2, llr3);
+    _mm512_storeu_si512(llr_ptr++, _mm512_unpacklo_epi64(llr01_lo, llr23_lo));
+    _mm512_storeu_si512(llr_ptr++, _mm512_unpackhi_epi64(llr01_lo, llr23_lo));
+    _mm512_storeu_si512(llr_ptr++, _mm512_unpacklo_epi64(llr01_hi, llr23_hi));
+    _mm512_storeu_si512(llr_ptr++, _mm512_unpackhi_epi64(llr01_hi, llr23_hi));
+  }
+
+  return i;
+}
+
+int demod_256qam_lte_b_avx512(const cf_t* symbols, int8_t* llr, int nsymbols)
+{
+  const float* symbols_ptr = (const float*)symbols;
+  __m512i*     llr_ptr     = (__m512i*)llr;
+  __m512       scale       = _mm512_set1_ps(SCALE_BYTE_CONV_QAM256);
+  __m512i      min_llr     = _mm512_set1_epi8(-INT8_MAX);
+  __m512i      llr_1[4], llr_2[4], llr_3[4], llr_4[4], llr_k[4];
+
+  int i = 0;
+  for (; i < nsymbols - 31; i += 32) {
+    demod_256qam_fold_avx512(symbols_ptr, scale, llr_1);
+    demod_256qam_fold_avx512(symbols_ptr + 16, scale, llr_2);
+    demod_256qam_fold_avx512(symbols_ptr + 32, scale, llr_3);
+    demod_256qam_fold_avx512(symbols_ptr + 48, scale, llr_4);
+    symbols_ptr += 64;
+
+    // Every 16-bit element holds the real and imaginary LLR of a symbol for each pair of bits. The packing leaves
+    // symbols 2k, 2k + 1, 2k + 8, 2k + 9, 2k + 16, 2k + 17, 2k + 24 and 2k + 25 in the lane k, so the transpose below
+    // stores them in order
+    for (int k = 0; k < 4; k++) {
+      llr_k[k] = _mm512_packs_epi16(_mm512_packs_epi32(llr_1[k], llr_2[k]), _mm512_packs_epi32(llr_3[k], llr_4[k]));
+    }
+    __m512i llr0 = _mm512_max_epi8(llr_k[0], min_llr);
+    __m512i llr1 = llr_k[1];
+    __m512i llr2 = llr_k[2];
+    __m512i llr3 = llr_k[3];
+
+    // Transpose so that the 8 LLRs of every symbol are consecutive
+    __m512i llr01_lo = _mm512_unpacklo_epi16(llr0, llr1);
+    __m512i llr23_lo = _mm512_unpacklo_epi16(llr2, llr3);
+    __m512i llr01_hi = _mm512_unpackhi_epi16(llr0, llr1);
+    __m512i llr23_hi = _mm512_unpackhi_epi16(llr2, llr3);
+    _mm512_storeu_si512(llr_ptr++, _mm512_unpacklo_epi32(llr01_lo, llr23_lo));
+    _mm512_storeu_si512(llr_ptr++, _mm512_unpackhi_epi32(llr01_lo, llr23_lo));
+    _mm512_storeu_si512(llr_ptr++, _mm512_unpacklo_epi32(llr01_hi, llr23_hi));
+    _mm512_storeu_si512(llr_ptr++, _mm512_unpackhi_epi32(llr01_hi, llr23_hi));
+  }
+
+  return i;
+}
+
+#endif /* LV_HAVE_AVX512 */
@@ -30,8 +30,9 @@
 
 #include "srslte/srslte.h"
 
+#include "../demod_soft_256qam.h"
+
 time_t         start, finish;
-struct timeval x, y;
 
 static uint32_t     num_bits   = 1000;
 static srslte_mod_t modulation = SRSLTE_MOD_BPSK;
@@ -43,6 +44,55 @@ void usage(char* prog)
   printf("\t-m modulation (1: BPSK, 2: QPSK, 4: QAM16, 6: QAM64, 8: QAM256) [Default BPSK]\n");
 }
 
+/* Compares the 256QAM LLRs of the vector kernels against the scalar demapper within 1 LSB, for every number of symbols
+ * up to max_len, so that all the tails that cascade to the narrower kernels are covered */
+static int test_256qam_kernels(const cf_t* symbols, uint32_t nof_symbols)
+{
+  int      ret       = SRSLTE_SUCCESS;
+  uint32_t max_len   = SRSLTE_MIN(nof_symbols, 160);
+  cf_t*    noisy     = srslte_vec_cf_malloc(nof_symbols);
+  int16_t* llr_s     = srslte_vec_i16_malloc(8 * nof_symbols);
+  int16_t* llr_s_ref = srslte_vec_i16_malloc(8 * nof_symbols);
+  int8_t*  llr_b     = srslte_vec_i8_malloc(8 * nof_symbols);
+  int8_t*  llr_b_ref = srslte_vec_i8_malloc(8 * nof_symbols);
+  if (!noisy || !llr_s || !llr_s_ref || !llr_b || !llr_b_ref) {
+    perror("malloc");
+    exit(-1);
+  }
+
+  // The noise moves the symbols away from the constellation points, where the rounding of the LLRs differs
+  srslte_ch_awgn_c(symbols, noisy, 0.05f, nof_symbols);
+
+  // The last pass demodulates all the symbols
+  for (uint32_t k = 1; k <= max_len + 1 && ret == SRSLTE_SUCCESS; k++) {
+    uint32_t len = (k > max_len) ? nof_symbols : k;
+    srslte_demod_soft_demodulate_s(SRSLTE_MOD_256QAM, noisy, llr_s, len);
+    srslte_demod_soft_demodulate_b(SRSLTE_MOD_256QAM, noisy, llr_b, len);
+    demod_256qam_lte_s_generic(noisy, llr_s_ref, len);
+    demod_256qam_lte_b_generic(noisy, llr_b_ref, len);
+
+    for (uint32_t i = 0; i < 8 * len && ret == SRSLTE_SUCCESS; i++) {
+      if (abs(llr_s[i] - llr_s_ref[i]) > 1 || abs(llr_b[i] - llr_b_ref[i]) > 1) {
+        ERROR("256QAM LLR %d of %d symbols: 16-bit %d (expected %d), 8-bit %d (expected %d)\n",
+              i,
+              len,
+              llr_s[i],
+              llr_s_ref[i],
+              llr_b[i],
+              llr_b_ref[i]);
+        ret = SRSLTE_ERROR;
+      }
+    }
+  }
+
+  free(noisy);
+  free(llr_s);
+  free(llr_s_ref);
+  free(llr_b);
+  free(llr_b_ref);
+  return ret;
+}
+
 void parse_args(int argc, char** argv)
 {
   int opt;
@@ -90,6 +140,8 @@ int main(int argc, char** argv)
   uint8_t *            input, *input_bytes, *output;
   cf_t *               symbols, *symbols_bytes;
   float*               llr;
+  short*               llr_s;
+  int8_t*              llr_b;
 
   parse_args(argc, argv);
 
@@ -140,6 +192,18 @@ int main(int argc, char** argv)
     exit(-1);
   }
 
+  llr_s = srslte_vec_i16_malloc(num_bits);
+  if (!llr_s) {
+    perror("malloc");
+    exit(-1);
+  }
+
+  llr_b = srslte_vec_i8_malloc(num_bits);
+  if (!llr_b) {
+    perror("malloc");
+    exit(-1);
+  }
+
   /* generate random data */
   for (i = 0; i < num_bits; i++) {
     input[i] = rand() % 2;
@@ -178,10 +242,40 @@ int main(int argc, char** argv)
 
   printf("Symbols OK\n");
   /* demodulate */
-  gettimeofday(&x, NULL);
-  srslte_demod_soft_demodulate(modulation, symbols, llr, num_bits / mod.nbits_x_symbol);
-  gettimeofday(&y, NULL);
-  printf("\nElapsed time [us]: %ld\n", y.tv_usec - x.tv_usec);
+  uint32_t nof_symbols = num_bits / mod.nbits_x_symbol;
+  float    symbols_us[3];
+
+  gettimeofday(&t[1], NULL);
+  for (int i = 0; i < ntrials; i++) {
+    srslte_demod_soft_demodulate(modulation, symbols, llr, nof_symbols);
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  symbols_us[0] = (float)(nof_symbols * ntrials) / (t[0].tv_sec * 1e6f + t[0].tv_usec);
+
+  gettimeofday(&t[1], NULL);
+  for (int i = 0; i < ntrials; i++) {
+    srslte_demod_soft_demodulate_s(modulation, symbols, llr_s, nof_symbols);
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  symbols_us[1] = (float)(nof_symbols * ntrials) / (t[0].tv_sec * 1e6f + t[0].tv_usec);
+
+  gettimeofday(&t[1], NULL);
+  for (int i = 0; i < ntrials; i++) {
+    srslte_demod_soft_demodulate_b(modulation, symbols, llr_b, nof_symbols);
+  }
+  gettimeofday(&t[2], NULL);
+  get_time_interval(t);
+  symbols_us[2] = (float)(nof_symbols * ntrials) / (t[0].tv_sec * 1e6f + t[0].tv_usec);
+
+  printf("\nSoft demodulation of %s (%s kernels): %.1f/%.1f/%.1f symbols/us (float/16-bit/8-bit)\n",
+         srslte_mod_string(modulation),
+         srslte_simd_isa_string(srslte_simd_isa()),
+         symbols_us[0],
+         symbols_us[1],
+         symbols_us[2]);
+
   for (i = 0; i < num_bits; i++) {
     output[i] = llr[i] >= 0 ? 1 : 0;
   }
@@ -194,6 +288,20 @@ int main(int argc, char** argv)
     }
   }
 
+  /* The fixed point LLRs of noiseless symbols must give the same hard decisions */
+  for (i = 0; i < num_bits && ret == SRSLTE_SUCCESS; i++) {
+    if (input[i] != (llr_s[i] > 0 ? 1 : 0) || input[i] != (llr_b[i] > 0 ? 1 : 0)) {
+      ERROR("Error in 16-bit or 8-bit LLR of bit %d (%d, %d)\n", i, llr_s[i], llr_b[i]);
+      ret = SRSLTE_ERROR;
+    }
+  }
+
+  if (ret == SRSLTE_SUCCESS && modulation == SRSLTE_MOD_256QAM) {
+    ret = test_256qam_kernels(symbols, nof_symbols);
+  }
+
+  free(llr_b);
+  free(llr_s);
   free(llr);
   free(symbols);
   free(symbols_bytes);
@@ -71,8 +71,21 @@ static int pdcch_init(srslte_pdcch_t* q, uint32_t max_prb, uint32_t nof_rx_anten
     }
 
     int poly[3] = {0x6D, 0x4F, 0x57};
-    if (srslte_viterbi_init(&q->decoder, SRSLTE_VITERBI_37, poly, SRSLTE_DCI_MAX_BITS + 16, true)) {
-      goto clean;
+    if (q->is_ue) {
+      /* The UE decodes the candidates of the blind search in batches */
+      if (srslte_viterbi_init_batch(&q->decoder, SRSLTE_VITERBI_37, poly, SRSLTE_DCI_MAX_BITS + 16, true)) {
+        goto clean;
+      }
+      for (int i = 0; i < SRSLTE_PDCCH_MAX_BATCH; i++) {
+        q->rm_f_batch[i] = srslte_vec_f_malloc(3 * (SRSLTE_DCI_MAX_BITS + 16));
+        if (!q->rm_f_batch[i]) {
+          goto clean;
+        }
+      }
+    } else {
+      if (srslte_viterbi_init(&q->decoder, SRSLTE_VITERBI_37, poly, SRSLTE_DCI_MAX_BITS + 16, true)) {
+        goto clean;
+      }
     }
 
     q->e = srslte_vec_u8_malloc(q->max_bits);
@@ -142,6 +155,11 @@ void srslte_pdcch_free(srslte_pdcch_t* q)
   if (q->d) {
     free(q->d);
   }
+  for (int i = 0; i < SRSLTE_PDCCH_MAX_BATCH; i++) {
+    if (q->rm_f_batch[i]) {
+      free(q->rm_f_batch[i]);
+    }
+  }
   for (int i = 0; i < SRSLTE_MAX_PORTS; i++) {
     if (q->x[i]) {
       free(q->x[i]);
@@ -329,6 +347,16 @@ uint32_t srslte_pdcch_common_locations_ncce(uint32_t nof_cce, srslte_dci_locatio
   return k;
 }
 
+/* XOR between the parity bits that follow the nof_bits decoded bits in data and the CRC of these */
+static uint16_t dci_crc_remainder(srslte_pdcch_t* q, uint8_t* data, uint32_t nof_bits)
+{
+  uint8_t* x       = &data[nof_bits];
+  uint16_t p_bits  = (uint16_t)srslte_bit_pack(&x, 16);
+  uint16_t crc_res = ((uint16_t)srslte_crc_checksum(&q->crc, data, nof_bits) & 0xffff);
+
+  return p_bits ^ crc_res;
+}
+
 /** 36.212 5.3.3.2 to 5.3.3.4
  *
  * Returns XOR between parity and remainder bits
@@ -337,10 +365,6 @@ uint32_t srslte_pdcch_common_locations_ncce(uint32_t nof_cce, srslte_dci_locatio
  */
 int srslte_pdcch_dci_decode(srslte_pdcch_t* q, float* e, uint8_t* data, uint32_t E, uint32_t nof_bits, uint16_t* crc)
 {
-
-  uint16_t p_bits, crc_res;
-  uint8_t* x;
-
   if (q != NULL) {
     if (data != NULL && E <= q->max_bits && nof_bits <= SRSLTE_DCI_MAX_BITS) {
       srslte_vec_f_zero(q->rm_f, 3 * (SRSLTE_DCI_MAX_BITS + 16));
@@ -353,12 +377,8 @@ int srslte_pdcch_dci_decode(srslte_pdcch_t* q, float* e, uint8_t* data, uint32_t
       /* viterbi decoder */
       srslte_viterbi_decode_f(&q->decoder, q->rm_f, data, nof_bits + 16);
 
-      x       = &data[nof_bits];
-      p_bits  = (uint16_t)srslte_bit_pack(&x, 16);
-      crc_res = ((uint16_t)srslte_crc_checksum(&q->crc, data, nof_bits) & 0xffff);
-
       if (crc) {
-        *crc = p_bits ^ crc_res;
+        *crc = dci_crc_remainder(q, data, nof_bits);
       }
 
       return SRSLTE_SUCCESS;
@@ -371,6 +391,49 @@ int srslte_pdcch_dci_decode(srslte_pdcch_t* q, float* e, uint8_t* data, uint32_t
   }
 }
 
+/* Checks that the location of msg fits in the control region */
+static bool pdcch_msg_location_isvalid(srslte_pdcch_t* q, srslte_dl_sf_cfg_t* sf, srslte_dci_msg_t* msg)
+{
+  if (!srslte_dci_location_isvalid(&msg->location)) {
+    ERROR("Invalid parameters, location=%d,%d\n", msg->location.ncce, msg->location.L);
+    return false;
+  }
+  if (msg->location.ncce * 72 + PDCCH_FORMAT_NOF_BITS(msg->location.L) > NOF_CCE(sf->cfi) * 72) {
+    ERROR("Invalid location: nCCE: %d, L: %d, NofCCE: %d\n", msg->location.ncce, msg->location.L, NOF_CCE(sf->cfi));
+    return false;
+  }
+  return true;
+}
+
+/* Mean magnitude of the LLRs of the location of msg. Locations without a transmission are not decoded */
+static double pdcch_msg_llr_mean(srslte_pdcch_t* q, srslte_dci_msg_t* msg)
+{
+  uint32_t e_bits = PDCCH_FORMAT_NOF_BITS(msg->location.L);
+
+  double mean = 0;
+  for (int i = 0; i < e_bits; i++) {
+    mean += fabsf(q->llr[msg->location.ncce * 72 + i]);
+  }
+  return mean / e_bits;
+}
+
+/* Sets the size and, for formats 0 and 1A which have the same size, the format of a decoded message */
+static void pdcch_msg_set_format(srslte_dci_cfg_t* dci_cfg, srslte_dci_msg_t* msg, uint32_t nof_bits, double mean)
+{
+  msg->nof_bits = nof_bits;
+  // Check format differentiation
+  if (msg->format == SRSLTE_DCI_FORMAT0 || msg->format == SRSLTE_DCI_FORMAT1A) {
+    msg->format = (msg->payload[dci_cfg->cif_enabled ? 3 : 0] == 0) ? SRSLTE_DCI_FORMAT0 : SRSLTE_DCI_FORMAT1A;
+  }
+  DEBUG("Decoded DCI: nCCE=%d, L=%d, format=%s, msg_len=%d, mean=%f, crc_rem=0x%x\n",
+        msg->location.ncce,
+        msg->location.L,
+        srslte_dci_format_string(msg->format),
+        nof_bits,
+        mean,
+        msg->rnti);
+}
+
 /** Tries to decode a DCI message from the LLRs stored in the srslte_pdcch_t structure by the function
  * srslte_pdcch_extract_llr(). This function can be called multiple times.
  * The location to search for is obtained from msg.
@@ -380,49 +443,96 @@ int srslte_pdcch_dci_decode(srslte_pdcch_t* q, float* e, uint8_t* data, uint32_t
 int srslte_pdcch_decode_msg(srslte_pdcch_t* q, srslte_dl_sf_cfg_t* sf, srslte_dci_cfg_t* dci_cfg, srslte_dci_msg_t* msg)
 {
   int ret = SRSLTE_ERROR_INVALID_INPUTS;
-  if (q != NULL && msg != NULL && srslte_dci_location_isvalid(&msg->location)) {
-    if (msg->location.ncce * 72 + PDCCH_FORMAT_NOF_BITS(msg->location.L) > NOF_CCE(sf->cfi) * 72) {
-      ERROR("Invalid location: nCCE: %d, L: %d, NofCCE: %d\n", msg->location.ncce, msg->location.L, NOF_CCE(sf->cfi));
-    } else {
-      ret = SRSLTE_SUCCESS;
+  if (q != NULL && msg != NULL && pdcch_msg_location_isvalid(q, sf, msg)) {
+    ret = SRSLTE_SUCCESS;
 
-      uint32_t nof_bits = srslte_dci_format_sizeof(&q->cell, sf, dci_cfg, msg->format);
-      uint32_t e_bits   = PDCCH_FORMAT_NOF_BITS(msg->location.L);
+    uint32_t nof_bits = srslte_dci_format_sizeof(&q->cell, sf, dci_cfg, msg->format);
+    uint32_t e_bits   = PDCCH_FORMAT_NOF_BITS(msg->location.L);
 
-      double mean = 0;
-      for (int i = 0; i < e_bits; i++) {
-        mean += fabsf(q->llr[msg->location.ncce * 72 + i]);
-      }
-      mean /= e_bits;
-      if (mean > 0.3) {
-        ret = srslte_pdcch_dci_decode(q, &q->llr[msg->location.ncce * 72], msg->payload, e_bits, nof_bits, &msg->rnti);
-        if (ret == SRSLTE_SUCCESS) {
-          msg->nof_bits = nof_bits;
-          // Check format differentiation
-          if (msg->format == SRSLTE_DCI_FORMAT0 || msg->format == SRSLTE_DCI_FORMAT1A) {
-            msg->format = (msg->payload[dci_cfg->cif_enabled ? 3 : 0] == 0) ? SRSLTE_DCI_FORMAT0 : SRSLTE_DCI_FORMAT1A;
-          }
-        } else {
-          ERROR("Error calling pdcch_dci_decode\n");
-        }
-        DEBUG("Decoded DCI: nCCE=%d, L=%d, format=%s, msg_len=%d, mean=%f, crc_rem=0x%x\n",
-              msg->location.ncce,
-              msg->location.L,
-              srslte_dci_format_string(msg->format),
-              nof_bits,
-              mean,
-              msg->rnti);
+    double mean = pdcch_msg_llr_mean(q, msg);
+    if (mean > 0.3) {
+      ret = srslte_pdcch_dci_decode(q, &q->llr[msg->location.ncce * 72], msg->payload, e_bits, nof_bits, &msg->rnti);
+      if (ret == SRSLTE_SUCCESS) {
+        pdcch_msg_set_format(dci_cfg, msg, nof_bits, mean);
       } else {
-        DEBUG(
-            "Skipping DCI:  nCCE=%d, L=%d, msg_len=%d, mean=%f\n", msg->location.ncce, msg->location.L, nof_bits, mean);
+        ERROR("Error calling pdcch_dci_decode\n");
       }
+    } else {
+      DEBUG("Skipping DCI:  nCCE=%d, L=%d, msg_len=%d, mean=%f\n", msg->location.ncce, msg->location.L, nof_bits, mean);
     }
-  } else {
-    ERROR("Invalid parameters, location=%d,%d\n", msg->location.ncce, msg->location.L);
   }
   return ret;
 }
 
+/** Like srslte_pdcch_decode_msg() for the nof_msg messages in msg, which must have the same format. All the candidates
+ * have the same coded length, so their Viterbi decoding runs at once. The result of every message is the same as with
+ * srslte_pdcch_decode_msg()
+ */
+int srslte_pdcch_decode_msg_batch(srslte_pdcch_t*     q,
+                                  srslte_dl_sf_cfg_t* sf,
+                                  srslte_dci_cfg_t*   dci_cfg,
+                                  srslte_dci_msg_t*   msg,
+                                  uint32_t            nof_msg)
+{
+  float*            symbols[SRSLTE_PDCCH_MAX_BATCH];
+  uint8_t*          data[SRSLTE_PDCCH_MAX_BATCH];
+  srslte_dci_msg_t* decoded[SRSLTE_PDCCH_MAX_BATCH];
+  double            mean[SRSLTE_PDCCH_MAX_BATCH];
+  uint32_t          nof_decoded = 0;
+
+  if (q == NULL || msg == NULL || !q->is_ue || nof_msg > SRSLTE_PDCCH_MAX_BATCH) {
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+
+  for (uint32_t i = 0; i < nof_msg; i++) {
+    if (!pdcch_msg_location_isvalid(q, sf, &msg[i]) || msg[i].format != msg[0].format) {
+      return SRSLTE_ERROR_INVALID_INPUTS;
+    }
+  }
+  if (nof_msg == 0) {
+    return SRSLTE_SUCCESS;
+  }
+
+  uint32_t nof_bits = srslte_dci_format_sizeof(&q->cell, sf, dci_cfg, msg[0].format);
+  if (nof_bits > SRSLTE_DCI_MAX_BITS) {
+    ERROR("Invalid parameters: nof_bits: %d\n", nof_bits);
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+  uint32_t coded_len = 3 * (nof_bits + 16);
+
+  /* Unrate matching of the candidates with a transmission */
+  for (uint32_t i = 0; i < nof_msg; i++) {
+    double m = pdcch_msg_llr_mean(q, &msg[i]);
+    if (m > 0.3) {
+      srslte_vec_f_zero(q->rm_f_batch[nof_decoded], coded_len);
+      srslte_rm_conv_rx(&q->llr[msg[i].location.ncce * 72],
+                        PDCCH_FORMAT_NOF_BITS(msg[i].location.L),
+                        q->rm_f_batch[nof_decoded],
+                        coded_len);
+      symbols[nof_decoded] = q->rm_f_batch[nof_decoded];
+      data[nof_decoded]    = msg[i].payload;
+      decoded[nof_decoded] = &msg[i];
+      mean[nof_decoded]    = m;
+      nof_decoded++;
+    } else {
+      DEBUG("Skipping DCI:  nCCE=%d, L=%d, msg_len=%d, mean=%f\n", msg[i].location.ncce, msg[i].location.L, nof_bits, m);
+    }
+  }
+
+  /* viterbi decoder */
+  if (srslte_viterbi_decode_batch_f(&q->decoder, symbols, data, nof_decoded, nof_bits + 16)) {
+    ERROR("Error calling pdcch_dci_decode\n");
+    return SRSLTE_ERROR;
+  }
+
+  for (uint32_t i = 0; i < nof_decoded; i++) {
+    decoded[i]->rnti = dci_crc_remainder(q, decoded[i]->payload, nof_bits);
+    pdcch_msg_set_format(dci_cfg, decoded[i], nof_bits, mean[i]);
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
 /** Performs PDCCH receiver processing to extract LLR for all control region. LLR bits are stored in srslte_pdcch_t
  * object. DCI can be decoded from given locations in successive calls to srslte_pdcch_decode_msg()
  */
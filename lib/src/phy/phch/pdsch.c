@@ -58,6 +58,9 @@ typedef struct {
   void*     pdsch_ptr;
   bool*     ack;
 
+  /* Scrambling sequence, obtained by the caller as the sequence cache is not thread-safe */
+  srslte_sequence_t* seq;
+
   /* Configuration Encoder/Decoder: they must be set before posting start semaphore */
   srslte_dl_sf_cfg_t* sf;
   srslte_pdsch_cfg_t* cfg;
@@ -323,13 +326,7 @@ static int pdsch_init(srslte_pdsch_t* q, uint32_t max_prb, bool is_ue, uint32_t
       }
     }
 
-    q->users = calloc(sizeof(srslte_pdsch_user_t*), q->is_ue ? 1 : (1 + SRSLTE_SIRNTI));
-    if (!q->users) {
-      ERROR("malloc");
-      goto clean;
-    }
-
-    if (srslte_sequence_init(&q->tmp_seq, q->max_re * srslte_mod_bits_x_symbol(SRSLTE_MOD_256QAM))) {
+    if (srslte_sequence_cache_init(&q->seq_cache, q->is_ue ? SRSLTE_PDSCH_SEQ_CACHE_UE : SRSLTE_PDSCH_SEQ_CACHE_ENB)) {
       goto clean;
     }
 
@@ -462,20 +459,7 @@ void srslte_pdsch_free(srslte_pdsch_t* q)
       }
     }
   }
-  if (q->users) {
-    if (q->is_ue) {
-      srslte_pdsch_free_rnti(q, 0);
-    } else {
-      for (int u = 0; u <= SRSLTE_SIRNTI; u++) {
-        if (q->users[u]) {
-          srslte_pdsch_free_rnti(q, u);
-        }
-      }
-    }
-    free(q->users);
-  }
-
-  srslte_sequence_free(&q->tmp_seq);
+  srslte_sequence_cache_free(&q->seq_cache);
 
   for (int i = 0; i < SRSLTE_MOD_NITEMS; i++) {
     srslte_modem_table_free(&q->mod[i]);
@@ -510,60 +494,24 @@ int srslte_pdsch_set_cell(srslte_pdsch_t* q, srslte_cell_t cell)
   return ret;
 }
 
-/* Precalculate the PDSCH scramble sequences for a given RNTI. This function takes a while
- * to execute, so shall be called once the final C-RNTI has been allocated for the session.
+/* The scrambling sequences are generated on their first use and kept in a cache shared by all RNTIs, so there is no
+ * per-RNTI state besides the UE C-RNTI. The cache is only accessed from the thread that encodes or decodes.
  */
 int srslte_pdsch_set_rnti(srslte_pdsch_t* q, uint16_t rnti)
 {
-  uint32_t rnti_idx = q->is_ue ? 0 : rnti;
-
-  if (!q->users[rnti_idx] || q->is_ue) {
-    if (!q->users[rnti_idx]) {
-      q->users[rnti_idx] = calloc(1, sizeof(srslte_pdsch_user_t));
-      if (!q->users[rnti_idx]) {
-        ERROR("calloc");
-        return -1;
-      }
-    }
-    q->users[rnti_idx]->sequence_generated = false;
-
-    for (int i = 0; i < SRSLTE_NOF_SF_X_FRAME; i++) {
-      for (int j = 0; j < SRSLTE_MAX_CODEWORDS; j++) {
-        if (srslte_sequence_pdsch(&q->users[rnti_idx]->seq[j][i],
-                                  rnti,
-                                  j,
-                                  2 * i,
-                                  q->cell.id,
-                                  q->max_re * srslte_mod_bits_x_symbol(SRSLTE_MOD_256QAM))) {
-          ERROR("Error initializing PDSCH scrambling sequence\n");
-          srslte_pdsch_free_rnti(q, rnti);
-          return SRSLTE_ERROR;
-        }
-      }
-    }
-    q->ue_rnti                             = rnti;
-    q->users[rnti_idx]->cell_id            = q->cell.id;
-    q->users[rnti_idx]->sequence_generated = true;
-  } else {
-    ERROR("Error generating PDSCH sequence: rnti=0x%x already generated\n", rnti);
+  if (q->is_ue) {
+    q->ue_rnti = rnti;
   }
   return SRSLTE_SUCCESS;
 }
 
 void srslte_pdsch_free_rnti(srslte_pdsch_t* q, uint16_t rnti)
 {
-  uint32_t rnti_idx = q->is_ue ? 0 : rnti;
-  if (q->users[rnti_idx]) {
-    for (int i = 0; i < SRSLTE_NOF_SF_X_FRAME; i++) {
-      for (int j = 0; j < SRSLTE_MAX_CODEWORDS; j++) {
-        srslte_sequence_free(&q->users[rnti_idx]->seq[j][i]);
-      }
-    }
-    free(q->users[rnti_idx]);
-    q->users[rnti_idx] = NULL;
-    q->ue_rnti         = 0;
+  if (q->is_ue && q->ue_rnti == rnti) {
+    q->ue_rnti = 0;
   }
 }
+
 static float apply_power_allocation(srslte_pdsch_t* q, srslte_pdsch_cfg_t* cfg, cf_t* sf_symbols_m[SRSLTE_MAX_PORTS])
 {
 
@@ -605,16 +553,10 @@ static float apply_power_allocation(srslte_pdsch_t* q, srslte_pdsch_cfg_t* cfg,
 static srslte_sequence_t*
 get_user_sequence(srslte_pdsch_t* q, uint16_t rnti, uint32_t codeword_idx, uint32_t sf_idx, uint32_t len)
 {
-  uint32_t rnti_idx = q->is_ue ? 0 : rnti;
-
-  // The scrambling sequence is pregenerated for all RNTIs in the eNodeB but only for C-RNTI in the UE
-  if (q->users[rnti_idx] && q->users[rnti_idx]->sequence_generated && q->users[rnti_idx]->cell_id == q->cell.id &&
-      (!q->is_ue || q->ue_rnti == rnti)) {
-    return &q->users[rnti_idx]->seq[codeword_idx][sf_idx];
-  } else {
-    srslte_sequence_pdsch(&q->tmp_seq, rnti, codeword_idx, 2 * sf_idx, q->cell.id, len);
-    return &q->tmp_seq;
-  }
+  // The whole sequence of the cell is generated, so that it serves any later grant of the RNTI in the subframe
+  uint32_t seed = srslte_sequence_pdsch_seed(rnti, codeword_idx, 2 * sf_idx, q->cell.id);
+  return srslte_sequence_cache_get(
+      &q->seq_cache, seed, SRSLTE_MAX(len, q->max_re * srslte_mod_bits_x_symbol(SRSLTE_MOD_256QAM)));
 }
 
 static void csi_correction(srslte_pdsch_t* q, srslte_pdsch_cfg_t* cfg, uint32_t codeword_idx, uint32_t tb_idx, void* e)
@@ -780,6 +722,7 @@ static int srslte_pdsch_codeword_decode(srslte_pdsch_t*     q,
                                         srslte_sch_t*       dl_sch,
                                         srslte_pdsch_res_t* data,
                                         uint32_t            tb_idx,
+                                        srslte_sequence_t*  seq,
                                         bool*               ack)
 {
   srslte_ra_tb_t*         mcs          = &cfg->grant.tb[tb_idx];
@@ -790,7 +733,7 @@ static int srslte_pdsch_codeword_decode(srslte_pdsch_t*     q,
 
   int ret = SRSLTE_ERROR_INVALID_INPUTS;
 
-  if (softbuffer && data && ack && cfg->grant.tb[tb_idx].nof_bits && cfg->grant.nof_re) {
+  if (softbuffer && data && seq && ack && cfg->grant.tb[tb_idx].nof_bits && cfg->grant.nof_re) {
     INFO("Decoding PDSCH SF: %d (CW%d -> TB%d), Mod %s, NofBits: %d, NofSymbols: %d, NofBitsE: %d, rv_idx: %d\n",
          sf->tti % 10,
          codeword_idx,
@@ -828,19 +771,11 @@ static int srslte_pdsch_codeword_decode(srslte_pdsch_t*     q,
       data[tb_idx].evm = NAN;
     }
 
-    /* Select scrambling sequence */
-    srslte_sequence_t* seq =
-        get_user_sequence(q, cfg->rnti, codeword_idx, sf->tti % 10, cfg->grant.tb[tb_idx].nof_bits);
-    if (!seq) {
-      ERROR("Error getting user sequence for rnti=0x%x\n", cfg->rnti);
-      return -1;
-    }
-
     /* Bit scrambling */
     if (q->llr_is_8bit) {
-      srslte_scrambling_sb_offset(seq, q->e[codeword_idx], 0, cfg->grant.tb[tb_idx].nof_bits);
+      srslte_scrambling_bytes_sb(seq, q->e[codeword_idx], cfg->grant.tb[tb_idx].nof_bits);
     } else {
-      srslte_scrambling_s_offset(seq, q->e[codeword_idx], 0, cfg->grant.tb[tb_idx].nof_bits);
+      srslte_scrambling_bytes_s(seq, q->e[codeword_idx], cfg->grant.tb[tb_idx].nof_bits);
     }
 
     if (cfg->csi_enable) {
@@ -880,7 +815,8 @@ static void* srslte_pdsch_decode_thread(void* arg)
 
   sem_wait(&q->start);
   while (!q->quit) {
-    q->ret_status = srslte_pdsch_codeword_decode(q->pdsch_ptr, q->sf, q->cfg, &q->dl_sch, q->data, q->tb_idx, q->ack);
+    q->ret_status =
+        srslte_pdsch_codeword_decode(q->pdsch_ptr, q->sf, q->cfg, &q->dl_sch, q->data, q->tb_idx, q->seq, q->ack);
 
     /* Post finish semaphore */
     sem_post(&q->finish);
@@ -1006,6 +942,15 @@ int srslte_pdsch_decode(srslte_pdsch_t*        q,
       if (cfg->grant.tb[tb_idx].enabled) {
         if (!data[tb_idx].crc) {
           int ret = SRSLTE_SUCCESS;
+
+          /* Select scrambling sequence */
+          srslte_sequence_t* seq = get_user_sequence(
+              q, cfg->rnti, cfg->grant.tb[tb_idx].cw_idx, sf->tti % 10, cfg->grant.tb[tb_idx].nof_bits);
+          if (!seq) {
+            ERROR("Error getting user sequence for rnti=0x%x\n", cfg->rnti);
+            return SRSLTE_ERROR;
+          }
+
           if (cfg->grant.nof_tb > 1 && tb_idx == 0 && q->coworker_ptr) {
             srslte_pdsch_coworker_t* h = (srslte_pdsch_coworker_t*)q->coworker_ptr;
 
@@ -1014,13 +959,14 @@ int srslte_pdsch_decode(srslte_pdsch_t*        q,
             h->sf                    = sf;
             h->data                  = &data[tb_idx];
             h->tb_idx                = tb_idx;
+            h->seq                   = seq;
             h->ack                   = &data[tb_idx].crc;
             h->dl_sch.max_iterations = q->dl_sch.max_iterations;
             h->started               = true;
             sem_post(&h->start);
 
           } else {
-            ret = srslte_pdsch_codeword_decode(q, sf, cfg, &q->dl_sch, data, tb_idx, &data[tb_idx].crc);
+            ret = srslte_pdsch_codeword_decode(q, sf, cfg, &q->dl_sch, data, tb_idx, seq, &data[tb_idx].crc);
 
             data[tb_idx].avg_iterations_block = srslte_sch_last_noi(&q->dl_sch);
           }
@@ -1249,6 +1195,54 @@ int srslte_pdsch_encode(srslte_pdsch_t*     q,
   return ret;
 }
 
+/* Selects the 4 port codebook with the highest sum of the post-detection SINR of the layers. The codebooks share the
+ * SRSLTE_MAX_CODEBOOKS entries of sinr, so that sinr[pmi % SRSLTE_MAX_CODEBOOKS] is the one of the selected codebook */
+static int pdsch_select_pmi_4p(srslte_pdsch_t*        q,
+                               srslte_chest_dl_res_t* channel,
+                               uint32_t               nof_layers,
+                               uint32_t*              best_pmi,
+                               float                  sinr[SRSLTE_MAX_CODEBOOKS])
+{
+  uint32_t pmi       = 0;
+  float    best_sinr = -INFINITY;
+
+  for (uint32_t i = 0; i < SRSLTE_MAX_CODEBOOKS; i++) {
+    sinr[i] = 0.0f;
+  }
+
+  for (uint32_t cb = 0; cb < SRSLTE_PRECODING_4P_NOF_CODEBOOKS; cb++) {
+    float layer_sinr[SRSLTE_MAX_LAYERS] = {};
+    if (srslte_precoding_multiplex_sinr(channel->ce,
+                                        q->nof_rx_antennas,
+                                        q->cell.nof_ports,
+                                        nof_layers,
+                                        cb,
+                                        SRSLTE_NOF_RE(q->cell),
+                                        channel->noise_estimate,
+                                        layer_sinr)) {
+      ERROR("PMI Select for %d layers", nof_layers);
+      return SRSLTE_ERROR;
+    }
+
+    float this_sinr = 0.0f;
+    for (uint32_t l = 0; l < nof_layers; l++) {
+      this_sinr += layer_sinr[l];
+    }
+
+    sinr[cb % SRSLTE_MAX_CODEBOOKS] = SRSLTE_MAX(sinr[cb % SRSLTE_MAX_CODEBOOKS], this_sinr);
+    if (this_sinr > best_sinr) {
+      best_sinr = this_sinr;
+      pmi       = cb;
+    }
+  }
+
+  if (best_pmi) {
+    *best_pmi = pmi;
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
 int srslte_pdsch_select_pmi(srslte_pdsch_t*        q,
                             srslte_chest_dl_res_t* channel,
                             uint32_t               nof_layers,
@@ -1258,6 +1252,10 @@ int srslte_pdsch_select_pmi(srslte_pdsch_t*        q,
   uint32_t nof_ce = SRSLTE_NOF_RE(q->cell);
   uint32_t pmi    = 0;
 
+  if (q->cell.nof_ports == 4) {
+    return pdsch_select_pmi_4p(q, channel, nof_layers, best_pmi, sinr);
+  }
+
   if (srslte_precoding_pmi_select(channel->ce, nof_ce, channel->noise_estimate, nof_layers, &pmi, sinr) < 0) {
     ERROR("PMI Select for %d layers", nof_layers);
     return SRSLTE_ERROR;
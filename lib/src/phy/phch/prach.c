@@ -22,6 +22,7 @@
 #include "srslte/srslte.h"
 #include <math.h>
 #include <string.h>
+#include <sys/time.h>
 
 #include "srslte/phy/common/phy_common.h"
 #include "srslte/phy/phch/prach.h"
@@ -347,10 +348,15 @@ int srslte_prach_init(srslte_prach_t* p, uint32_t max_N_ifft_ul)
 
     p->max_N_ifft_ul = max_N_ifft_ul;
 
-    // Set up containers
+    // Set up containers, the correlation rows are large enough for all the roots
     p->prach_bins = srslte_vec_cf_malloc(MAX_N_zc);
-    p->corr_spec  = srslte_vec_cf_malloc(MAX_N_zc);
-    p->corr       = srslte_vec_f_malloc(MAX_N_zc);
+    p->corr_spec  = srslte_vec_cf_malloc(N_SEQS * SRSLTE_PRACH_CORR_STRIDE);
+    p->corr       = srslte_vec_f_malloc(N_SEQS * SRSLTE_PRACH_CORR_STRIDE);
+    if (!p->prach_bins || !p->corr_spec || !p->corr) {
+      ERROR("Error allocating memory\n");
+      return SRSLTE_ERROR;
+    }
+    srslte_vec_cf_zero(p->corr_spec, N_SEQS * SRSLTE_PRACH_CORR_STRIDE);
 
     // Set up ZC FFTS
     if (srslte_dft_plan(&p->zc_fft, MAX_N_zc, SRSLTE_DFT_FORWARD, SRSLTE_DFT_COMPLEX)) {
@@ -359,11 +365,19 @@ int srslte_prach_init(srslte_prach_t* p, uint32_t max_N_ifft_ul)
     srslte_dft_plan_set_mirror(&p->zc_fft, false);
     srslte_dft_plan_set_norm(&p->zc_fft, true);
 
-    if (srslte_dft_plan(&p->zc_ifft, MAX_N_zc, SRSLTE_DFT_BACKWARD, SRSLTE_DFT_COMPLEX)) {
+    // The IFFT of the correlations is planned for one root, set_cell replans it for all the roots of the cell
+    if (srslte_dft_plan_guru_c(&p->zc_ifft,
+                               MAX_N_zc,
+                               SRSLTE_DFT_BACKWARD,
+                               p->corr_spec,
+                               p->corr_spec,
+                               1,
+                               1,
+                               1,
+                               SRSLTE_PRACH_CORR_STRIDE,
+                               SRSLTE_PRACH_CORR_STRIDE)) {
       return SRSLTE_ERROR;
     }
-    srslte_dft_plan_set_mirror(&p->zc_ifft, false);
-    srslte_dft_plan_set_norm(&p->zc_ifft, false);
 
     uint32_t fft_size_alloc = max_N_ifft_ul * DELTA_F / DELTA_F_RA;
 
@@ -459,9 +473,6 @@ int srslte_prach_set_cell_(srslte_prach_t*      p,
       if (srslte_dft_replan(&p->zc_fft, p->N_zc)) {
         return SRSLTE_ERROR;
       }
-      if (srslte_dft_replan(&p->zc_ifft, p->N_zc)) {
-        return SRSLTE_ERROR;
-      }
     }
 
     // Generate our 64 sequences
@@ -476,6 +487,25 @@ int srslte_prach_set_cell_(srslte_prach_t*      p,
       srslte_dft_run(&p->zc_fft, p->seqs[i], p->dft_seqs[i]);
     }
 
+    // A single IFFT call transforms the correlations with all the roots searched by the detector
+    if (srslte_dft_replan_guru_c(&p->zc_ifft,
+                                 p->N_zc,
+                                 p->corr_spec,
+                                 p->corr_spec,
+                                 1,
+                                 1,
+                                 p->num_ra_preambles,
+                                 SRSLTE_PRACH_CORR_STRIDE,
+                                 SRSLTE_PRACH_CORR_STRIDE)) {
+      ERROR("Error creating DFT plan\n");
+      return SRSLTE_ERROR;
+    }
+
+    p->detect_latency_us     = 0;
+    p->detect_latency_avg_us = 0;
+    p->detect_latency_max_us = 0;
+    p->nof_detect            = 0;
+
     // Create our FFT objects and buffers
     p->N_ifft_ul = N_ifft_ul;
     if (4 == preamble_format) {
@@ -574,6 +604,67 @@ int srslte_prach_detect(srslte_prach_t* p,
   return srslte_prach_detect_offset(p, freq_offset, signal, sig_len, indices, NULL, NULL, n_indices);
 }
 
+/* Searches the peaks of the correlation with one root in each cyclic shift window and reports the preambles above the
+ * detection threshold */
+static void prach_detect_root(srslte_prach_t* p,
+                              uint32_t        root,
+                              const float*    corr,
+                              uint32_t*       indices,
+                              float*          t_offsets,
+                              float*          peak_to_avg,
+                              uint32_t*       n_indices)
+{
+  float corr_ave  = srslte_vec_acc_ff(corr, p->N_zc) / p->N_zc;
+  float threshold = p->detect_factor * corr_ave;
+
+  // Most of the times there is no preamble, so the peak of the whole correlation rules the root out
+  if (corr[srslte_vec_max_fi(corr, p->N_zc)] <= threshold) {
+    return;
+  }
+
+  uint32_t winsize = 0;
+  if (p->N_cs != 0) {
+    winsize = p->N_cs;
+  } else {
+    winsize = p->N_zc;
+  }
+  uint32_t n_wins = p->N_zc / winsize;
+
+  for (int j = 0; j < n_wins; j++) {
+    uint32_t start = (p->N_zc - (j * p->N_cs)) % p->N_zc;
+    uint32_t end   = start + winsize;
+    if (end > p->deadzone) {
+      end -= p->deadzone;
+    }
+    start += p->deadzone;
+    p->peak_offsets[j] = srslte_vec_max_fi(&corr[start], end - start);
+    p->peak_values[j]  = corr[start + p->peak_offsets[j]];
+  }
+
+  for (int j = 0; j < n_wins; j++) {
+    if (p->peak_values[j] > threshold) {
+      if (indices) {
+        indices[*n_indices] = (root * n_wins) + j;
+      }
+      if (peak_to_avg) {
+        peak_to_avg[*n_indices] = p->peak_values[j] / corr_ave;
+      }
+      if (t_offsets) {
+        float corr = 1.8;
+        if (p->peak_offsets[j] > 30) {
+          corr = 1.9;
+        }
+        if (p->peak_offsets[j] > 250) {
+          corr = 1.91;
+        }
+
+        t_offsets[*n_indices] = corr * p->peak_offsets[j] / (DELTA_F_RA * p->N_zc);
+      }
+      (*n_indices)++;
+    }
+  }
+}
+
 int srslte_prach_detect_offset(srslte_prach_t* p,
                                uint32_t        freq_offset,
                                cf_t*           signal,
@@ -591,6 +682,9 @@ int srslte_prach_detect_offset(srslte_prach_t* p,
       return SRSLTE_ERROR_INVALID_INPUTS;
     }
 
+    struct timeval t[3];
+    gettimeofday(&t[1], NULL);
+
     // FFT incoming signal
     srslte_dft_run(&p->fft, signal, p->signal_fft);
 
@@ -604,72 +698,25 @@ int srslte_prach_detect_offset(srslte_prach_t* p,
 
     memcpy(p->prach_bins, &p->signal_fft[begin], p->N_zc * sizeof(cf_t));
 
-    for (int i = 0; i < p->num_ra_preambles; i++) {
-      cf_t* root_spec = p->dft_seqs[p->root_seqs_idx[i]];
-
-      srslte_vec_prod_conj_ccc(p->prach_bins, root_spec, p->corr_spec, p->N_zc);
-
-      srslte_dft_run(&p->zc_ifft, p->corr_spec, p->corr_spec);
-
-      srslte_vec_abs_square_cf(p->corr_spec, p->corr, p->N_zc);
-
-      float corr_ave = srslte_vec_acc_ff(p->corr, p->N_zc) / p->N_zc;
+    // Correlate the received bins with all the roots, then transform and take the power of all of them at once
+    for (uint32_t i = 0; i < p->num_ra_preambles; i++) {
+      srslte_vec_prod_conj_ccc(
+          p->prach_bins, p->dft_seqs[p->root_seqs_idx[i]], &p->corr_spec[i * SRSLTE_PRACH_CORR_STRIDE], p->N_zc);
+    }
+    srslte_dft_run_guru_c(&p->zc_ifft);
+    srslte_vec_abs_square_cf(p->corr_spec, p->corr, p->num_ra_preambles * SRSLTE_PRACH_CORR_STRIDE);
 
-      uint32_t winsize = 0;
-      if (p->N_cs != 0) {
-        winsize = p->N_cs;
-      } else {
-        winsize = p->N_zc;
-      }
-      uint32_t n_wins = p->N_zc / winsize;
-
-      float max_peak = 0;
-      for (int j = 0; j < n_wins; j++) {
-        uint32_t start = (p->N_zc - (j * p->N_cs)) % p->N_zc;
-        uint32_t end   = start + winsize;
-        if (end > p->deadzone) {
-          end -= p->deadzone;
-        }
-        start += p->deadzone;
-        p->peak_values[j] = 0;
-        for (int k = start; k < end; k++) {
-          if (p->corr[k] > p->peak_values[j]) {
-            p->peak_values[j]  = p->corr[k];
-            p->peak_offsets[j] = k - start;
-            if (p->peak_values[j] > max_peak) {
-              max_peak = p->peak_values[j];
-            }
-          }
-        }
-      }
-      if (max_peak > p->detect_factor * corr_ave) {
-        for (int j = 0; j < n_wins; j++) {
-          if (p->peak_values[j] > p->detect_factor * corr_ave) {
-            // printf("saving prach correlation\n");
-            // memcpy(save_corr, p->corr, p->N_zc*sizeof(float));
-            if (indices) {
-              indices[*n_indices] = (i * n_wins) + j;
-            }
-            if (peak_to_avg) {
-              peak_to_avg[*n_indices] = p->peak_values[j] / corr_ave;
-            }
-            if (t_offsets) {
-              float corr = 1.8;
-              if (p->peak_offsets[j] > 30) {
-                corr = 1.9;
-              }
-              if (p->peak_offsets[j] > 250) {
-                corr = 1.91;
-              }
-
-              t_offsets[*n_indices] = corr * p->peak_offsets[j] / (DELTA_F_RA * p->N_zc);
-            }
-            (*n_indices)++;
-          }
-        }
-      }
+    for (uint32_t i = 0; i < p->num_ra_preambles; i++) {
+      prach_detect_root(p, i, &p->corr[i * SRSLTE_PRACH_CORR_STRIDE], indices, t_offsets, peak_to_avg, n_indices);
     }
 
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    p->detect_latency_us     = t[0].tv_sec * 1e6f + t[0].tv_usec;
+    p->detect_latency_avg_us = SRSLTE_VEC_CMA(p->detect_latency_us, p->detect_latency_avg_us, p->nof_detect);
+    p->detect_latency_max_us = SRSLTE_MAX(p->detect_latency_max_us, p->detect_latency_us);
+    p->nof_detect++;
+
     ret = SRSLTE_SUCCESS;
   }
   return ret;
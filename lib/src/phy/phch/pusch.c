@@ -126,13 +126,7 @@ static int pusch_init(srslte_pusch_t* q, uint32_t max_prb, bool is_ue)
 
     q->is_ue = is_ue;
 
-    q->users = calloc(sizeof(srslte_pusch_user_t*), q->is_ue ? 1 : (1 + SRSLTE_SIRNTI));
-    if (!q->users) {
-      perror("malloc");
-      goto clean;
-    }
-
-    if (srslte_sequence_init(&q->tmp_seq, q->max_re * srslte_mod_bits_x_symbol(SRSLTE_MOD_64QAM))) {
+    if (srslte_sequence_cache_init(&q->seq_cache, q->is_ue ? SRSLTE_PUSCH_SEQ_CACHE_UE : SRSLTE_PUSCH_SEQ_CACHE_ENB)) {
       goto clean;
     }
 
@@ -220,18 +214,7 @@ void srslte_pusch_free(srslte_pusch_t* q)
   }
   srslte_dft_precoding_free(&q->dft_precoding);
 
-  if (q->users) {
-    if (q->is_ue) {
-      srslte_pusch_free_rnti(q, 0);
-    } else {
-      for (int rnti = 0; rnti <= SRSLTE_SIRNTI; rnti++) {
-        srslte_pusch_free_rnti(q, rnti);
-      }
-    }
-    free(q->users);
-  }
-
-  srslte_sequence_free(&q->tmp_seq);
+  srslte_sequence_cache_free(&q->seq_cache);
 
   for (i = 0; i < SRSLTE_MOD_NITEMS; i++) {
     srslte_modem_table_free(&q->mod[i]);
@@ -259,75 +242,31 @@ int srslte_pusch_set_cell(srslte_pusch_t* q, srslte_cell_t cell)
   return ret;
 }
 
-/* Precalculate the PUSCH scramble sequences for a given RNTI. This function takes a while
- * to execute, so shall be called once the final C-RNTI has been allocated for the session.
- * For the connection procedure, use srslte_pusch_encode() functions */
+/* The scrambling sequences are generated on their first use and kept in a cache shared by all RNTIs, so there is no
+ * per-RNTI state besides the UE C-RNTI. The cache is only accessed from the thread that encodes or decodes.
+ */
 int srslte_pusch_set_rnti(srslte_pusch_t* q, uint16_t rnti)
 {
-  uint32_t i;
-
-  uint32_t rnti_idx = q->is_ue ? 0 : rnti;
-
-  if (!q->users[rnti_idx] || q->is_ue) {
-    if (!q->users[rnti_idx]) {
-      q->users[rnti_idx] = calloc(1, sizeof(srslte_pusch_user_t));
-      if (!q->users[rnti_idx]) {
-        perror("calloc");
-        return -1;
-      }
-    }
-    q->users[rnti_idx]->sequence_generated = false;
-    for (i = 0; i < SRSLTE_NOF_SF_X_FRAME; i++) {
-      if (srslte_sequence_pusch(&q->users[rnti_idx]->seq[i],
-                                rnti,
-                                2 * i,
-                                q->cell.id,
-                                q->max_re * srslte_mod_bits_x_symbol(SRSLTE_MOD_64QAM))) {
-        ERROR("Error initializing PUSCH scrambling sequence\n");
-        srslte_pusch_free_rnti(q, rnti);
-        return SRSLTE_ERROR;
-      }
-    }
-    q->ue_rnti                             = rnti;
-    q->users[rnti_idx]->cell_id            = q->cell.id;
-    q->users[rnti_idx]->sequence_generated = true;
-  } else {
-    ERROR("Error generating PUSCH sequence: rnti=0x%x already generated\n", rnti);
+  if (q->is_ue) {
+    q->ue_rnti = rnti;
   }
   return SRSLTE_SUCCESS;
 }
 
 void srslte_pusch_free_rnti(srslte_pusch_t* q, uint16_t rnti)
 {
-
-  uint32_t rnti_idx = q->is_ue ? 0 : rnti;
-
-  if (q->users[rnti_idx]) {
-    for (int i = 0; i < SRSLTE_NOF_SF_X_FRAME; i++) {
-      srslte_sequence_free(&q->users[rnti_idx]->seq[i]);
-    }
-    free(q->users[rnti_idx]);
-    q->users[rnti_idx] = NULL;
-    q->ue_rnti         = 0;
+  if (q->is_ue && q->ue_rnti == rnti) {
+    q->ue_rnti = 0;
   }
 }
 
 static srslte_sequence_t* get_user_sequence(srslte_pusch_t* q, uint16_t rnti, uint32_t sf_idx, uint32_t len)
 {
-  uint32_t rnti_idx = q->is_ue ? 0 : rnti;
-
   if (SRSLTE_RNTI_ISUSER(rnti)) {
-    // The scrambling sequence is pregenerated for all RNTIs in the eNodeB but only for C-RNTI in the UE
-    if (q->users[rnti_idx] && q->users[rnti_idx]->sequence_generated && q->users[rnti_idx]->cell_id == q->cell.id &&
-        (!q->is_ue || q->ue_rnti == rnti)) {
-      return &q->users[rnti_idx]->seq[sf_idx];
-    } else {
-      if (srslte_sequence_pusch(&q->tmp_seq, rnti, 2 * sf_idx, q->cell.id, len)) {
-        ERROR("Error generating temporal scrambling sequence\n");
-        return NULL;
-      }
-      return &q->tmp_seq;
-    }
+    // The whole sequence of the cell is generated, so that it serves any later grant of the RNTI in the subframe
+    uint32_t seed = srslte_sequence_pusch_seed(rnti, 2 * sf_idx, q->cell.id);
+    return srslte_sequence_cache_get(
+        &q->seq_cache, seed, SRSLTE_MAX(len, q->max_re * srslte_mod_bits_x_symbol(SRSLTE_MOD_64QAM)));
   } else {
     ERROR("Invalid RNTI=0x%x\n", rnti);
     return NULL;
@@ -535,13 +474,13 @@ int srslte_pusch_decode(srslte_pusch_t*        q,
 
     // Descrambling
     if (q->llr_is_8bit) {
-      srslte_scrambling_sb_offset(seq, q->q, 0, cfg->grant.tb.nof_bits);
+      srslte_scrambling_bytes_sb(seq, q->q, cfg->grant.tb.nof_bits);
     } else {
-      srslte_scrambling_s_offset(seq, q->q, 0, cfg->grant.tb.nof_bits);
+      srslte_scrambling_bytes_s(seq, q->q, cfg->grant.tb.nof_bits);
     }
 
     // Decode
-    ret      = srslte_ulsch_decode(&q->ul_sch, cfg, q->q, q->g, seq->c, out->data, &out->uci);
+    ret      = srslte_ulsch_decode(&q->ul_sch, cfg, q->q, q->g, seq->c_bytes, out->data, &out->uci);
     out->crc = (ret == 0);
 
     // Accept ACK only if SNR is above threshold
@@ -24,7 +24,9 @@
 #include "srslte/phy/utils/vector.h"
 #include "srslte/srslte.h"
 #include <assert.h>
+#include <errno.h>
 #include <math.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -34,6 +36,11 @@
 
 #define SRSLTE_PDSCH_MAX_TDEC_ITERS 10
 
+/* Adaptive decoding: iterations guaranteed to every code block, and consecutive iterations in which the turbo decoder
+ * does not converge after which a code block with wrong CRC is given up */
+#define SCH_ADAPTIVE_MIN_ITERATIONS 2
+#define SCH_ADAPTIVE_STALLED_ITERATIONS 3
+
 #ifdef LV_HAVE_SSE
 #include <immintrin.h>
 #endif /* LV_HAVE_SSE */
@@ -175,6 +182,14 @@ int srslte_sch_init(srslte_sch_t* q)
     if (!q->ul_interleaver) {
       goto clean;
     }
+    q->rm_scratch = srslte_vec_i16_malloc(SRSLTE_RM_TURBO_RX_SCRATCH_LEN);
+    if (!q->rm_scratch) {
+      goto clean;
+    }
+    q->cb_workers_data = srslte_vec_u8_malloc(SRSLTE_TCOD_MAX_LEN_CB / 8);
+    if (!q->cb_workers_data) {
+      goto clean;
+    }
     if (srslte_uci_cqi_init(&q->uci_cqi)) {
       goto clean;
     }
@@ -204,6 +219,12 @@ void srslte_sch_free(srslte_sch_t* q)
   if (q->ul_interleaver) {
     free(q->ul_interleaver);
   }
+  if (q->rm_scratch) {
+    free(q->rm_scratch);
+  }
+  if (q->cb_workers_data) {
+    free(q->cb_workers_data);
+  }
   srslte_tdec_free(&q->decoder);
   srslte_tcod_free(&q->encoder);
   srslte_uci_cqi_free(&q->uci_cqi);
@@ -215,6 +236,25 @@ void srslte_sch_set_max_noi(srslte_sch_t* q, uint32_t max_iterations)
   q->max_iterations = max_iterations;
 }
 
+/* Enables the adaptive decoding if avg_iterations is not zero. A code block with wrong CRC is given up as soon as the
+ * turbo decoder stops converging, and the code blocks decoded between two srslte_sch_reset_adaptive_budget() share a
+ * budget of avg_iterations per code block, so that the iterations saved in the easy code blocks go to the hard ones. A
+ * code block never runs more than max_iterations. Both are half iterations, like srslte_tdec_iteration()
+ */
+void srslte_sch_set_adaptive_noi(srslte_sch_t* q, uint32_t avg_iterations)
+{
+  q->adaptive_iterations = avg_iterations ? SRSLTE_MAX(avg_iterations, SCH_ADAPTIVE_MIN_ITERATIONS) : 0;
+  srslte_sch_reset_adaptive_budget(q);
+}
+
+/* Starts a new iteration budget of the adaptive decoding. The transport blocks decoded until the next reset, e.g. those
+ * of all the UEs of a subframe, share it, so that the iterations a subframe takes stay bounded */
+void srslte_sch_reset_adaptive_budget(srslte_sch_t* q)
+{
+  q->budget_iterations = 0;
+  q->budget_nof_cb     = 0;
+}
+
 float srslte_sch_last_noi(srslte_sch_t* q)
 {
   return q->avg_iterations;
@@ -351,110 +391,563 @@ static int encode_tb(srslte_sch_t*           q,
   return encode_tb_off(q, soft_buffer, cb_segm, Qm, rv, nof_e_bits, data, e_bits, 0);
 }
 
-bool decode_tb_cb(srslte_sch_t*           q,
-                  srslte_softbuffer_rx_t* softbuffer,
-                  srslte_cbsegm_t*        cb_segm,
-                  uint32_t                Qm,
-                  uint32_t                rv,
-                  uint32_t                nof_e_bits,
-                  void*                   e_bits,
-                  uint8_t*                data)
+/* Adds the code blocks of a transport block that are not decoded yet to the iteration budget, with avg_iterations
+ * each. The iterations left by the transport blocks decoded since the budget was reset go to them too */
+static void cb_budget_add(srslte_sch_t* q, srslte_softbuffer_rx_t* softbuffer, srslte_cbsegm_t* cb_segm)
+{
+  if (!q->adaptive_iterations) {
+    return;
+  }
+  for (uint32_t i = 0; i < cb_segm->C; i++) {
+    if (!softbuffer->cb_crc[i]) {
+      q->budget_nof_cb++;
+      q->budget_iterations += q->adaptive_iterations;
+    }
+  }
+}
+
+/* Starts a code block counted by cb_budget_add(), which is guaranteed SCH_ADAPTIVE_MIN_ITERATIONS of the budget. The
+ * budget is updated atomically because the code block workers decode the code blocks of a transport block in parallel.
+ * The guaranteed iterations are taken before the code block stops counting as not started, so that the concurrent
+ * calls to cb_budget_draw() never see them as free */
+static void cb_budget_start(srslte_sch_t* q)
+{
+  __atomic_sub_fetch(&q->budget_iterations, SCH_ADAPTIVE_MIN_ITERATIONS, __ATOMIC_SEQ_CST);
+  __atomic_sub_fetch(&q->budget_nof_cb, 1, __ATOMIC_SEQ_CST);
+}
+
+/* Stops counting a code block counted by cb_budget_add() that is not decoded because of an error, so that its
+ * guaranteed iterations are left to the other code blocks */
+static void cb_budget_release(srslte_sch_t* q)
+{
+  if (q->adaptive_iterations) {
+    __atomic_sub_fetch(&q->budget_nof_cb, 1, __ATOMIC_SEQ_CST);
+  }
+}
+
+/* Draws one more iteration for a code block that already ran its guaranteed ones, keeping the guaranteed iterations
+ * of the code blocks not started yet. The code blocks running at the same time draw from the budget one by one
+ * instead of reserving it when they start, so that no code block takes the iterations that the others leave */
+static bool cb_budget_draw(srslte_sch_t* q)
 {
+  uint32_t budget = __atomic_load_n(&q->budget_iterations, __ATOMIC_SEQ_CST);
+  do {
+    if (budget <= __atomic_load_n(&q->budget_nof_cb, __ATOMIC_SEQ_CST) * SCH_ADAPTIVE_MIN_ITERATIONS) {
+      return false;
+    }
+  } while (!__atomic_compare_exchange_n(
+      &q->budget_iterations, &budget, budget - 1, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST));
+  return true;
+}
 
+/* Rate dematches and decodes the code block cb_idx, writing the decoded bits, including the code block CRC, in cb_data.
+ * In adaptive decoding the iterations beyond the guaranteed ones are drawn from the budget. Returns the number of turbo decoder iterations or a negative value if there is an error.
+ */
+static int decode_cb(srslte_sch_t*           q,
+                     srslte_tdec_t*          decoder,
+                     int16_t*                rm_scratch,
+                     srslte_crc_t*           crc_tb,
+                     srslte_crc_t*           crc_cb,
+                     srslte_softbuffer_rx_t* softbuffer,
+                     srslte_cbsegm_t*        cb_segm,
+                     uint32_t                Qm,
+                     uint32_t                rv,
+                     uint32_t                nof_e_bits,
+                     void*                   e_bits,
+                     uint32_t                cb_idx,
+                     uint8_t*                cb_data)
+{
   int8_t*  e_bits_b = e_bits;
   int16_t* e_bits_s = e_bits;
 
-  if (cb_segm->C > SRSLTE_MAX_CODEBLOCKS) {
-    ERROR("Error SRSLTE_MAX_CODEBLOCKS=%d\n", SRSLTE_MAX_CODEBLOCKS);
+  uint32_t cb_len     = cb_idx < cb_segm->C1 ? cb_segm->K1 : cb_segm->K2;
+  uint32_t cb_len_idx = cb_idx < cb_segm->C1 ? cb_segm->K1_idx : cb_segm->K2_idx;
+
+  uint32_t rlen  = cb_segm->C == 1 ? cb_len : (cb_len - 24);
+  uint32_t Gp    = nof_e_bits / Qm;
+  uint32_t gamma = cb_segm->C > 0 ? Gp % cb_segm->C : Gp;
+  uint32_t n_e   = Qm * (Gp / cb_segm->C);
+
+  uint32_t rp   = cb_idx * n_e;
+  uint32_t n_e2 = n_e;
+
+  if (cb_idx > cb_segm->C - gamma) {
+    n_e2 = n_e + Qm;
+    rp   = (cb_segm->C - gamma) * n_e + (cb_idx - (cb_segm->C - gamma)) * n_e2;
+  }
+
+  if (srslte_softbuffer_rx_alloc_cb(softbuffer, cb_idx)) {
+    ERROR("Error allocating softbuffer for CB %d\n", cb_idx);
+    cb_budget_release(q);
+    return SRSLTE_ERROR;
+  }
+
+  if (q->llr_is_8bit) {
+    if (srslte_rm_turbo_rx_lut_8bit(&e_bits_b[rp], (int8_t*)softbuffer->buffer_f[cb_idx], n_e2, cb_len_idx, rv, rm_scratch)) {
+      ERROR("Error in rate matching\n");
+      cb_budget_release(q);
+      return SRSLTE_ERROR;
+    }
+  } else {
+    if (srslte_rm_turbo_rx_lut(&e_bits_s[rp], softbuffer->buffer_f[cb_idx], n_e2, cb_len_idx, rv, rm_scratch)) {
+      ERROR("Error in rate matching\n");
+      cb_budget_release(q);
+      return SRSLTE_ERROR;
+    }
+  }
+
+  srslte_tdec_new_cb(decoder, cb_len);
+  if (q->adaptive_iterations) {
+    cb_budget_start(q);
+  }
+
+  // Run iterations and use CRC for early stopping
+  bool     early_stop = false;
+  uint32_t cb_noi     = 0;
+  do {
+    if (q->llr_is_8bit) {
+      srslte_tdec_iteration_8bit(decoder, (int8_t*)softbuffer->buffer_f[cb_idx], cb_data);
+    } else {
+      srslte_tdec_iteration(decoder, softbuffer->buffer_f[cb_idx], cb_data);
+    }
+    cb_noi++;
+
+    uint32_t      len_crc;
+    srslte_crc_t* crc_ptr;
+
+    if (cb_segm->C > 1) {
+      len_crc = cb_len;
+      crc_ptr = crc_cb;
+    } else {
+      len_crc = cb_segm->tbs + 24;
+      crc_ptr = crc_tb;
+    }
+
+    // CRC is OK
+    if (!srslte_crc_checksum_byte(crc_ptr, cb_data, len_crc)) {
+
+      softbuffer->cb_crc[cb_idx] = true;
+      early_stop                 = true;
+
+      // CRC is error and exceeded maximum iterations for this CB.
+      // Early stop the whole transport block.
+    } else if (q->adaptive_iterations &&
+               srslte_tdec_update_stalled(decoder, cb_data) >= SCH_ADAPTIVE_STALLED_ITERATIONS) {
+      // The decoder is not converging, further iterations will not fix the CRC
+      break;
+    }
+
+  } while (cb_noi < q->max_iterations && !early_stop &&
+           (!q->adaptive_iterations || cb_noi < SCH_ADAPTIVE_MIN_ITERATIONS || cb_budget_draw(q)));
+
+  // Return the guaranteed iterations that were not used
+  if (q->adaptive_iterations && cb_noi < SCH_ADAPTIVE_MIN_ITERATIONS) {
+    __atomic_add_fetch(&q->budget_iterations, SCH_ADAPTIVE_MIN_ITERATIONS - cb_noi, __ATOMIC_SEQ_CST);
+  }
+
+  INFO("CB %d: rp=%d, n_e=%d, cb_len=%d, CRC=%s, rlen=%d, iterations=%d/%d\n",
+       cb_idx,
+       rp,
+       n_e2,
+       cb_len,
+       early_stop ? "OK" : "KO",
+       rlen,
+       cb_noi,
+       q->max_iterations);
+
+  return cb_noi;
+}
+
+/* Transport block whose code blocks are decoded across the code block pool. It lives in the stack of the thread that
+ * decodes the transport block, which waits until none of its code blocks is being decoded before returning */
+typedef struct sch_cb_job_s {
+  srslte_sch_t*           sch;
+  srslte_softbuffer_rx_t* softbuffer;
+  srslte_cbsegm_t*        cb_segm;
+  uint32_t                Qm;
+  uint32_t                rv;
+  uint32_t                nof_e_bits;
+  void*                   e_bits;
+  uint8_t*                data;
+
+  /* Guarded by the pool mutex */
+  uint32_t             next_cb_idx; // Next code block to claim
+  uint32_t             nof_running; // Claimed code blocks not finished yet
+  uint32_t             nof_iterations;
+  bool                 error;
+  struct sch_cb_job_s* next; // Next transport block in the pool queue
+} sch_cb_job_t;
+
+/* Code block decoder worker. Each worker holds its own decoder, rate dematching scratch and CRC instances */
+typedef struct {
+  pthread_t pthread;
+  bool      started;
+
+  srslte_tdec_t decoder;
+  int16_t*      rm_scratch;
+  srslte_crc_t  crc_tb;
+  srslte_crc_t  crc_cb;
+
+  /* Decoded code block, including its CRC. Copied to the transport block once the CRC is checked */
+  uint8_t* cb_data;
+} sch_cb_worker_t;
+
+/* Code block decoder threads shared by all the srslte_sch_t of the process, so that the PHY workers decoding
+ * transport blocks at the same time do not start a set of threads each */
+typedef struct {
+  uint32_t         nof_workers;
+  sch_cb_worker_t* workers;
+
+  pthread_mutex_t mutex;
+  pthread_cond_t  cvar_job;  // Signaled when a transport block is queued or the pool stops
+  pthread_cond_t  cvar_done; // Signaled when the last running code block of a transport block finishes
+  sch_cb_job_t*   queue;     // Transport blocks with code blocks left to claim
+  bool            quit;
+} sch_cb_pool_t;
+
+static sch_cb_pool_t* cb_pool = NULL;
+
+static void cb_pool_dequeue(sch_cb_pool_t* pool, sch_cb_job_t* job)
+{
+  sch_cb_job_t** p = &pool->queue;
+  while (*p != NULL && *p != job) {
+    p = &(*p)->next;
+  }
+  if (*p == job) {
+    *p = job->next;
+  }
+  job->next = NULL;
+}
+
+/* Claims the next code block of the transport block and decodes it. It is called and returns with the pool mutex
+ * locked. Returns false if there are no code blocks left to claim
+ */
+static bool cb_job_run_one(sch_cb_pool_t* pool,
+                           sch_cb_job_t*  job,
+                           srslte_tdec_t* decoder,
+                           int16_t*       rm_scratch,
+                           srslte_crc_t*  crc_tb,
+                           srslte_crc_t*  crc_cb,
+                           uint8_t*       cb_data)
+{
+  srslte_cbsegm_t*        cb_segm    = job->cb_segm;
+  srslte_softbuffer_rx_t* softbuffer = job->softbuffer;
+
+  if (job->next_cb_idx >= cb_segm->C) {
     return false;
   }
+  uint32_t cb_idx = job->next_cb_idx++;
+  if (job->next_cb_idx == cb_segm->C) {
+    cb_pool_dequeue(pool, job);
+  }
+  job->nof_running++;
+
+  /* Do not process blocks with CRC Ok */
+  bool decode = !softbuffer->cb_crc[cb_idx];
+  pthread_mutex_unlock(&pool->mutex);
+
+  uint32_t cb_len = cb_idx < cb_segm->C1 ? cb_segm->K1 : cb_segm->K2;
+  uint32_t rlen   = cb_len - 24;
+  int      n      = 0;
+  if (decode) {
+    n = decode_cb(job->sch,
+                  decoder,
+                  rm_scratch,
+                  crc_tb,
+                  crc_cb,
+                  softbuffer,
+                  cb_segm,
+                  job->Qm,
+                  job->rv,
+                  job->nof_e_bits,
+                  job->e_bits,
+                  cb_idx,
+                  cb_data);
+
+    // The code block CRC is not copied, it would overwrite the beginning of the next code block
+    if (n >= 0) {
+      memcpy(&job->data[cb_idx * rlen / 8], cb_data, rlen / 8 * sizeof(uint8_t));
+    }
+  } else {
+    // Copy decoded data from previous transmissions
+    memcpy(&job->data[cb_idx * rlen / 8], softbuffer->data[cb_idx], rlen / 8 * sizeof(uint8_t));
+  }
 
-  q->avg_iterations = 0;
+  pthread_mutex_lock(&pool->mutex);
+  if (n < 0) {
+    job->error = true;
+  } else {
+    job->nof_iterations += n;
+  }
+  job->nof_running--;
+  if (job->nof_running == 0 && job->next_cb_idx >= cb_segm->C) {
+    pthread_cond_broadcast(&pool->cvar_done);
+  }
+  return true;
+}
+
+static void* cb_worker_thread(void* arg)
+{
+  sch_cb_worker_t* w    = (sch_cb_worker_t*)arg;
+  sch_cb_pool_t*   pool = cb_pool;
 
-  for (int cb_idx = 0; cb_idx < cb_segm->C; cb_idx++) {
-    /* Do not process blocks with CRC Ok */
-    if (softbuffer->cb_crc[cb_idx] == false) {
+  pthread_mutex_lock(&pool->mutex);
+  while (!pool->quit) {
+    if (pool->queue == NULL) {
+      pthread_cond_wait(&pool->cvar_job, &pool->mutex);
+    } else {
+      cb_job_run_one(pool, pool->queue, &w->decoder, w->rm_scratch, &w->crc_tb, &w->crc_cb, w->cb_data);
+    }
+  }
+  pthread_mutex_unlock(&pool->mutex);
 
-      uint32_t cb_len     = cb_idx < cb_segm->C1 ? cb_segm->K1 : cb_segm->K2;
-      uint32_t cb_len_idx = cb_idx < cb_segm->C1 ? cb_segm->K1_idx : cb_segm->K2_idx;
+  return NULL;
+}
 
-      uint32_t rlen  = cb_segm->C == 1 ? cb_len : (cb_len - 24);
-      uint32_t Gp    = nof_e_bits / Qm;
-      uint32_t gamma = cb_segm->C > 0 ? Gp % cb_segm->C : Gp;
-      uint32_t n_e   = Qm * (Gp / cb_segm->C);
+/* Creates a worker thread with the real-time priority that srslte common threads give to prio_offset (0 to 4), or with
+ * normal priority. Falls back to normal priority without the privileges for real-time priorities */
+static int cb_worker_create(sch_cb_worker_t* w, int prio_offset)
+{
+  pthread_attr_t     attr;
+  struct sched_param param;
+  bool               rt = prio_offset >= 0 && prio_offset < 5;
+
+  if (rt) {
+    param.sched_priority = 50 - prio_offset;
+    pthread_attr_init(&attr);
+    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+    pthread_attr_setschedparam(&attr, &param);
+  }
+  int err = pthread_create(&w->pthread, rt ? &attr : NULL, cb_worker_thread, (void*)w);
+  if (err == EPERM) {
+    fprintf(stderr, "Warning: Creating code block worker with normal priority, real-time priority not permitted\n");
+    err = pthread_create(&w->pthread, NULL, cb_worker_thread, (void*)w);
+  }
+  if (rt) {
+    pthread_attr_destroy(&attr);
+  }
+  return err ? SRSLTE_ERROR : SRSLTE_SUCCESS;
+}
 
-      uint32_t rp   = cb_idx * n_e;
-      uint32_t n_e2 = n_e;
+void srslte_sch_cb_workers_free()
+{
+  sch_cb_pool_t* pool = cb_pool;
+  if (pool == NULL) {
+    return;
+  }
 
-      if (cb_idx > cb_segm->C - gamma) {
-        n_e2 = n_e + Qm;
-        rp   = (cb_segm->C - gamma) * n_e + (cb_idx - (cb_segm->C - gamma)) * n_e2;
+  /* Stop threads */
+  pthread_mutex_lock(&pool->mutex);
+  pool->quit = true;
+  pthread_cond_broadcast(&pool->cvar_job);
+  pthread_mutex_unlock(&pool->mutex);
+
+  if (pool->workers) {
+    for (uint32_t i = 0; i < pool->nof_workers; i++) {
+      sch_cb_worker_t* w = &pool->workers[i];
+      if (w->started) {
+        pthread_join(w->pthread, NULL);
       }
-
-      if (q->llr_is_8bit) {
-        if (srslte_rm_turbo_rx_lut_8bit(&e_bits_b[rp], (int8_t*)softbuffer->buffer_f[cb_idx], n_e2, cb_len_idx, rv)) {
-          ERROR("Error in rate matching\n");
-          return SRSLTE_ERROR;
-        }
-      } else {
-        if (srslte_rm_turbo_rx_lut(&e_bits_s[rp], softbuffer->buffer_f[cb_idx], n_e2, cb_len_idx, rv)) {
-          ERROR("Error in rate matching\n");
-          return SRSLTE_ERROR;
-        }
+      srslte_tdec_free(&w->decoder);
+      if (w->rm_scratch) {
+        free(w->rm_scratch);
+      }
+      if (w->cb_data) {
+        free(w->cb_data);
       }
+    }
+    free(pool->workers);
+  }
+  pthread_cond_destroy(&pool->cvar_done);
+  pthread_cond_destroy(&pool->cvar_job);
+  pthread_mutex_destroy(&pool->mutex);
+  free(pool);
 
-      srslte_tdec_new_cb(&q->decoder, cb_len);
+  cb_pool = NULL;
+}
 
-      // Run iterations and use CRC for early stopping
-      bool     early_stop = false;
-      uint32_t cb_noi     = 0;
-      do {
-        if (q->llr_is_8bit) {
-          srslte_tdec_iteration_8bit(&q->decoder, (int8_t*)softbuffer->buffer_f[cb_idx], &data[cb_idx * rlen / 8]);
-        } else {
-          srslte_tdec_iteration(&q->decoder, softbuffer->buffer_f[cb_idx], &data[cb_idx * rlen / 8]);
-        }
-        q->avg_iterations++;
-        cb_noi++;
+/* Starts the code block decoder threads shared by the srslte_sch_t that enable them. The threads take the priority
+ * given by prio_offset as srslte common threads do, the PHY workers should give their own. Each transport block is
+ * decoded by the thread decoding it plus the free workers
+ */
+int srslte_sch_cb_workers_init(uint32_t nof_workers, int prio_offset)
+{
+  int ret = SRSLTE_SUCCESS;
 
-        uint32_t      len_crc;
-        srslte_crc_t* crc_ptr;
+  srslte_sch_cb_workers_free();
+  if (nof_workers == 0) {
+    return ret;
+  }
 
-        if (cb_segm->C > 1) {
-          len_crc = cb_len;
-          crc_ptr = &q->crc_cb;
-        } else {
-          len_crc = cb_segm->tbs + 24;
-          crc_ptr = &q->crc_tb;
-        }
+  sch_cb_pool_t* pool = calloc(sizeof(sch_cb_pool_t), 1);
+  if (!pool) {
+    ERROR("Allocating code block workers\n");
+    return SRSLTE_ERROR;
+  }
+  pthread_mutex_init(&pool->mutex, NULL);
+  pthread_cond_init(&pool->cvar_job, NULL);
+  pthread_cond_init(&pool->cvar_done, NULL);
+  cb_pool = pool;
+
+  pool->workers = calloc(sizeof(sch_cb_worker_t), nof_workers);
+  if (!pool->workers) {
+    ERROR("Allocating code block workers\n");
+    ret = SRSLTE_ERROR;
+    goto clean;
+  }
+  pool->nof_workers = nof_workers;
+
+  for (uint32_t i = 0; i < nof_workers; i++) {
+    sch_cb_worker_t* w = &pool->workers[i];
+
+    if (srslte_crc_init(&w->crc_tb, SRSLTE_LTE_CRC24A, 24)) {
+      ERROR("Error initiating CRC\n");
+      ret = SRSLTE_ERROR;
+      goto clean;
+    }
+    if (srslte_crc_init(&w->crc_cb, SRSLTE_LTE_CRC24B, 24)) {
+      ERROR("Error initiating CRC\n");
+      ret = SRSLTE_ERROR;
+      goto clean;
+    }
+    if (srslte_tdec_init(&w->decoder, SRSLTE_TCOD_MAX_LEN_CB)) {
+      ERROR("Error initiating Turbo Decoder\n");
+      ret = SRSLTE_ERROR;
+      goto clean;
+    }
+    w->rm_scratch = srslte_vec_i16_malloc(SRSLTE_RM_TURBO_RX_SCRATCH_LEN);
+    if (!w->rm_scratch) {
+      ret = SRSLTE_ERROR;
+      goto clean;
+    }
+    w->cb_data = srslte_vec_u8_malloc(SRSLTE_TCOD_MAX_LEN_CB / 8);
+    if (!w->cb_data) {
+      ret = SRSLTE_ERROR;
+      goto clean;
+    }
+    if (cb_worker_create(w, prio_offset)) {
+      ERROR("Creating code block worker thread\n");
+      ret = SRSLTE_ERROR;
+      goto clean;
+    }
+    w->started = true;
+  }
 
-        // CRC is OK
-        if (!srslte_crc_checksum_byte(crc_ptr, &data[cb_idx * rlen / 8], len_crc)) {
+clean:
+  if (ret) {
+    srslte_sch_cb_workers_free();
+  }
+  return ret;
+}
 
-          softbuffer->cb_crc[cb_idx] = true;
-          early_stop                 = true;
+void srslte_sch_enable_cb_workers(srslte_sch_t* q, bool enable)
+{
+  q->cb_workers = enable;
+}
 
-          // CRC is error and exceeded maximum iterations for this CB.
-          // Early stop the whole transport block.
-        }
+/* Decodes the code blocks of a segmented transport block across the code block workers and the calling thread. The
+ * decoded transport block, its CRC and the number of iterations do not change, except with adaptive decoding, where
+ * the iterations that a code block can take depend on the code blocks finished before. Returns the total number of
+ * iterations or a negative value if there is an error
+ */
+static int decode_tb_cb_workers(srslte_sch_t*           q,
+                                srslte_softbuffer_rx_t* softbuffer,
+                                srslte_cbsegm_t*        cb_segm,
+                                uint32_t                Qm,
+                                uint32_t                rv,
+                                uint32_t                nof_e_bits,
+                                void*                   e_bits,
+                                uint8_t*                data)
+{
+  sch_cb_pool_t* pool = cb_pool;
+  sch_cb_job_t   job  = {};
+
+  job.sch        = q;
+  job.softbuffer = softbuffer;
+  job.cb_segm    = cb_segm;
+  job.Qm         = Qm;
+  job.rv         = rv;
+  job.nof_e_bits = nof_e_bits;
+  job.e_bits     = e_bits;
+  job.data       = data;
+
+  pthread_mutex_lock(&pool->mutex);
+  sch_cb_job_t** tail = &pool->queue;
+  while (*tail != NULL) {
+    tail = &(*tail)->next;
+  }
+  *tail = &job;
+  pthread_cond_broadcast(&pool->cvar_job);
 
-      } while (cb_noi < q->max_iterations && !early_stop);
+  // The calling thread decodes code blocks too, then joins before the transport block CRC is checked
+  while (cb_job_run_one(pool, &job, &q->decoder, q->rm_scratch, &q->crc_tb, &q->crc_cb, q->cb_workers_data)) {
+  }
+  while (job.nof_running > 0) {
+    pthread_cond_wait(&pool->cvar_done, &pool->mutex);
+  }
+  pthread_mutex_unlock(&pool->mutex);
 
-      INFO("CB %d: rp=%d, n_e=%d, cb_len=%d, CRC=%s, rlen=%d, iterations=%d/%d\n",
-           cb_idx,
-           rp,
-           n_e2,
-           cb_len,
-           early_stop ? "OK" : "KO",
-           rlen,
-           cb_noi,
-           q->max_iterations);
+  return job.error ? SRSLTE_ERROR : (int)job.nof_iterations;
+}
 
-    } else {
-      // Copy decoded data from previous transmissions
+bool decode_tb_cb(srslte_sch_t*           q,
+                  srslte_softbuffer_rx_t* softbuffer,
+                  srslte_cbsegm_t*        cb_segm,
+                  uint32_t                Qm,
+                  uint32_t                rv,
+                  uint32_t                nof_e_bits,
+                  void*                   e_bits,
+                  uint8_t*                data)
+{
+  if (cb_segm->C > SRSLTE_MAX_CODEBLOCKS) {
+    ERROR("Error SRSLTE_MAX_CODEBLOCKS=%d\n", SRSLTE_MAX_CODEBLOCKS);
+    return false;
+  }
+
+  q->avg_iterations = 0;
+  cb_budget_add(q, softbuffer, cb_segm);
+
+  if (q->cb_workers && cb_pool != NULL && cb_segm->C > 1) {
+    int noi = decode_tb_cb_workers(q, softbuffer, cb_segm, Qm, rv, nof_e_bits, e_bits, data);
+    if (noi < 0) {
+      return SRSLTE_ERROR;
+    }
+    q->avg_iterations = noi;
+  } else {
+    for (int cb_idx = 0; cb_idx < cb_segm->C; cb_idx++) {
       uint32_t cb_len = cb_idx < cb_segm->C1 ? cb_segm->K1 : cb_segm->K2;
       uint32_t rlen   = cb_segm->C == 1 ? cb_len : (cb_len - 24);
-      memcpy(&data[cb_idx * rlen / 8], softbuffer->data[cb_idx], rlen / 8 * sizeof(uint8_t));
+
+      /* Do not process blocks with CRC Ok */
+      if (softbuffer->cb_crc[cb_idx] == false) {
+        int noi = decode_cb(q,
+                            &q->decoder,
+                            q->rm_scratch,
+                            &q->crc_tb,
+                            &q->crc_cb,
+                            softbuffer,
+                            cb_segm,
+                            Qm,
+                            rv,
+                            nof_e_bits,
+                            e_bits,
+                            cb_idx,
+                            &data[cb_idx * rlen / 8]);
+        if (noi < 0) {
+          // The code blocks left behind stop counting in the iteration budget too
+          for (int i = cb_idx + 1; i < cb_segm->C; i++) {
+            if (!softbuffer->cb_crc[i]) {
+              cb_budget_release(q);
+            }
+          }
+          return SRSLTE_ERROR;
+        }
+        q->avg_iterations += noi;
+      } else {
+        // Copy decoded data from previous transmissions
+        memcpy(&data[cb_idx * rlen / 8], softbuffer->data[cb_idx], rlen / 8 * sizeof(uint8_t));
+      }
     }
   }
 
@@ -520,6 +1013,11 @@ static int decode_tb(srslte_sch_t*           q,
       return SRSLTE_ERROR_INVALID_INPUTS;
     }
 
+    if (softbuffer->pool && !q->llr_is_8bit) {
+      ERROR("Softbuffers from a pool hold 8-bit soft bits and need the 8-bit decoder\n");
+      return SRSLTE_ERROR_INVALID_INPUTS;
+    }
+
     bool crc_ok = true;
 
     data[cb_segm->tbs / 8 + 0] = 0;
@@ -542,6 +1040,8 @@ static int decode_tb(srslte_sch_t*           q,
 
       if (par_rx == par_tx && par_rx) {
         INFO("TB decoded OK\n");
+        // The transport block is acknowledged, its soft bits will not be combined again
+        srslte_softbuffer_rx_release(softbuffer);
         return SRSLTE_SUCCESS;
       } else {
         INFO("Error in TB parity: par_tx=0x%x, par_rx=0x%x\n", par_tx, par_rx);
@@ -50,6 +50,8 @@ static uint16_t    rnti                         = 1234;
 static uint32_t    nof_rx_antennas              = 1;
 static bool        tb_cw_swap                   = false;
 static bool        enable_coworker              = false;
+static uint32_t    nof_cb_workers               = 0;
+static uint32_t    adaptive_iterations          = 0;
 static uint32_t    pmi                          = 0;
 static char*       input_file                   = NULL;
 static int         M                            = 1;
@@ -76,6 +78,9 @@ void usage(char* prog)
   printf("\t-p pmi (multiplex only)  [Default %d]\n", pmi);
   printf("\t-w Swap Transport Blocks\n");
   printf("\t-j Enable PDSCH decoder coworker\n");
+  printf("\t-W Number of code block decoder workers [Default %d]\n", nof_cb_workers);
+  printf("\t-A Average turbo decoder iterations per code block, enables adaptive decoding [Default %d]\n",
+         adaptive_iterations);
   printf("\t-v [set srslte_verbose to debug, default none]\n");
   printf("\t-q Enable/Disable 256QAM modulation (default %s)\n", enable_256qam ? "enabled" : "disabled");
 }
@@ -83,7 +88,7 @@ void usage(char* prog)
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "fmMcsbrtRFpnqawvXxj")) != -1) {
+  while ((opt = getopt(argc, argv, "fmMcsbrtRFpnqawvXxjWA")) != -1) {
     switch (opt) {
       case 'f':
         input_file = argv[optind];
@@ -136,6 +141,12 @@ void parse_args(int argc, char** argv)
       case 'j':
         enable_coworker = true;
         break;
+      case 'W':
+        nof_cb_workers = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'A':
+        adaptive_iterations = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
       case 'v':
         srslte_verbose++;
         break;
@@ -160,7 +171,8 @@ static int check_softbits(srslte_pdsch_t*     pdsch_enb,
   if (!pdsch_ue->llr_is_8bit && !tb_cw_swap) {
 
     // Generate sequence
-    srslte_sequence_pdsch(&pdsch_ue->tmp_seq,
+    srslte_sequence_t seq = {};
+    srslte_sequence_pdsch(&seq,
                           rnti,
                           pdsch_cfg->grant.tb[tb].cw_idx,
                           2 * (sf_idx % 10),
@@ -168,7 +180,8 @@ static int check_softbits(srslte_pdsch_t*     pdsch_enb,
                           pdsch_cfg->grant.tb[tb].nof_bits);
 
     // Scramble
-    srslte_scrambling_s_offset(&pdsch_ue->tmp_seq, pdsch_ue->e[tb], 0, pdsch_cfg->grant.tb[tb].nof_bits);
+    srslte_scrambling_s_offset(&seq, pdsch_ue->e[tb], 0, pdsch_cfg->grant.tb[tb].nof_bits);
+    srslte_sequence_free(&seq);
 
     int16_t* rx       = pdsch_ue->e[tb];
     uint8_t* rx_bytes = pdsch_ue->e[tb];
@@ -478,6 +491,14 @@ int main(int argc, char** argv)
   if (enable_coworker) {
     srslte_pdsch_enable_coworker(&pdsch_rx);
   }
+  if (nof_cb_workers) {
+    if (srslte_sch_cb_workers_init(nof_cb_workers, -1)) {
+      ERROR("Error starting code block workers\n");
+      goto quit;
+    }
+    srslte_sch_enable_cb_workers(&pdsch_rx.dl_sch, true);
+  }
+  srslte_sch_set_adaptive_noi(&pdsch_rx.dl_sch, adaptive_iterations);
 
   for (uint32_t i = 0; i < SRSLTE_MAX_CODEWORDS; i++) {
     pdsch_cfg.softbuffers.rx[i] = softbuffers_rx[i];
@@ -495,6 +516,7 @@ int main(int argc, char** argv)
     /* Set ACKs to zero, otherwise will not decode if there are positive ACKs*/
     bzero(acks, sizeof(acks));
 
+    srslte_sch_reset_adaptive_budget(&pdsch_rx.dl_sch);
     r = srslte_pdsch_decode(&pdsch_rx, &dl_sf, &pdsch_cfg, &chest_res, rx_slot_symbols, pdsch_res);
   }
   gettimeofday(&t[2], NULL);
@@ -555,6 +577,7 @@ quit:
   srslte_chest_dl_free(&chest);
   srslte_pdsch_free(&pdsch_tx);
   srslte_pdsch_free(&pdsch_rx);
+  srslte_sch_cb_workers_free();
   for (uint32_t i = 0; i < SRSLTE_MAX_CODEWORDS; i++) {
     srslte_softbuffer_tx_free(softbuffers_tx[i]);
     if (softbuffers_tx[i]) {
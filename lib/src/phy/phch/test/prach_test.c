@@ -118,6 +118,11 @@ int main(int argc, char** argv)
       return -1;
   }
 
+  printf("%d roots, detection latency: average %.1f us, max %.1f us\n",
+         prach.num_ra_preambles,
+         prach.detect_latency_avg_us,
+         prach.detect_latency_max_us);
+
   srslte_prach_free(&prach);
 
   printf("Done\n");
@@ -56,6 +56,7 @@ int          freq_hop      = -1;
 int          riv           = -1;
 uint32_t     mcs_idx       = 0;
 bool         enable_64_qam = false;
+uint32_t     nof_workers   = 0;
 
 void usage(char* prog)
 {
@@ -84,6 +85,7 @@ void usage(char* prog)
   printf("\n\tOther parameters:\n");
   printf("\t\t-p enable_64qam [Default %s]\n", enable_64_qam ? "enabled" : "disabled");
   printf("\t\t-s number of subframes [Default %d]\n", subframe);
+  printf("\t\t-W number of code block decoder workers [Default %d]\n", nof_workers);
   printf("\t-v [set srslte_verbose to debug, default none]\n");
 }
 
@@ -139,7 +141,7 @@ void parse_extensive_param(char* param, char* arg)
 void parse_args(int argc, char** argv)
 {
   int opt;
-  while ((opt = getopt(argc, argv, "msLFrncpvf")) != -1) {
+  while ((opt = getopt(argc, argv, "msLFrncpvfW")) != -1) {
     switch (opt) {
       case 'm':
         mcs_idx = (uint32_t)strtol(argv[optind], NULL, 10);
@@ -169,6 +171,9 @@ void parse_args(int argc, char** argv)
         parse_extensive_param(argv[optind], argv[optind + 1]);
         optind++;
         break;
+      case 'W':
+        nof_workers = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
       case 'v':
         srslte_verbose++;
         break;
@@ -241,6 +246,11 @@ int main(int argc, char** argv)
     ERROR("Error creating PUSCH object\n");
     goto quit;
   }
+  if (srslte_sch_cb_workers_init(nof_workers, -1)) {
+    ERROR("Error starting code block workers\n");
+    goto quit;
+  }
+  srslte_sch_enable_cb_workers(&pusch_rx.ul_sch, nof_workers > 0);
 
   uint16_t rnti = 62;
   dci.rnti      = rnti;
@@ -396,6 +406,7 @@ quit:
   srslte_chest_ul_res_free(&chest_res);
   srslte_pusch_free(&pusch_tx);
   srslte_pusch_free(&pusch_rx);
+  srslte_sch_cb_workers_free();
   srslte_softbuffer_tx_free(&softbuffer_tx);
   srslte_softbuffer_rx_free(&softbuffer_rx);
   srslte_random_free(random_h);
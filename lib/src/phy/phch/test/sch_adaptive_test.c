@@ -0,0 +1,263 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srslte/srslte.h"
+#include <srslte/phy/utils/random.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static uint32_t nof_prb        = 100;
+static uint32_t mcs            = 9;
+static uint32_t ue_x_tti       = 4;
+static uint32_t nof_sf         = 50;
+static uint32_t avg_its        = 6;
+static float    noise_std      = 0.7f;
+static uint32_t nof_cb_workers = 0;
+
+typedef struct {
+  uint32_t nof_tb_ok;
+  uint32_t nof_its;
+  uint32_t max_sf_its; // Most iterations taken by a subframe
+} decoder_result_t;
+
+void usage(char* prog)
+{
+  printf("Usage: %s [nmUsAeW]\n", prog);
+  printf("\t-n nof_prb [Default %d]\n", nof_prb);
+  printf("\t-m MCS [Default %d]\n", mcs);
+  printf("\t-U UEs scheduled per subframe [Default %d]\n", ue_x_tti);
+  printf("\t-s number of subframes [Default %d]\n", nof_sf);
+  printf("\t-A Average turbo decoder half iterations per code block of adaptive decoding [Default %d]\n", avg_its);
+  printf("\t-e Noise standard deviation of the first UE, 5%% more for each next UE [Default %.2f]\n", noise_std);
+  printf("\t-W Number of code block decoder workers [Default %d]\n", nof_cb_workers);
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "nmUsAeW")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'm':
+        mcs = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'U':
+        ue_x_tti = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        nof_sf = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'A':
+        avg_its = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'e':
+        noise_std = strtof(argv[optind], NULL);
+        break;
+      case 'W':
+        nof_cb_workers = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+/* Decodes the transport block of a UE and accounts its iterations in the subframe. Returns the iterations */
+static uint32_t decode_ue(srslte_sch_t*           sch,
+                          srslte_softbuffer_rx_t* softbuffer,
+                          srslte_pdsch_cfg_t*     cfg,
+                          int16_t*                llr,
+                          uint8_t*                data_tx,
+                          uint8_t*                data_rx,
+                          uint32_t                nof_cb,
+                          decoder_result_t*       result)
+{
+  srslte_softbuffer_rx_reset_tbs(softbuffer, cfg->grant.tb[0].tbs);
+  cfg->softbuffers.rx[0] = softbuffer;
+
+  int r = srslte_dlsch_decode(sch, cfg, llr, data_rx);
+  if (r == SRSLTE_SUCCESS && memcmp(data_rx, data_tx, cfg->grant.tb[0].tbs / 8) == 0) {
+    result->nof_tb_ok++;
+  }
+
+  // The average is over all the code blocks of the transport block
+  uint32_t its = (uint32_t)roundf(srslte_sch_last_noi(sch) * nof_cb);
+  result->nof_its += its;
+  return its;
+}
+
+int main(int argc, char** argv)
+{
+  int                    ret           = SRSLTE_ERROR;
+  srslte_random_t        random_h      = srslte_random_init(0);
+  srslte_sch_t           sch_tx        = {};
+  srslte_sch_t           sch_rx[2]     = {};
+  srslte_softbuffer_rx_t softbuffer[2] = {};
+  srslte_modem_table_t   modem         = {};
+  srslte_softbuffer_tx_t softbuffer_tx = {};
+  srslte_pdsch_cfg_t     cfg           = {};
+  decoder_result_t       results[2]    = {};
+  srslte_cbsegm_t        cb_segm       = {};
+
+  parse_args(argc, argv);
+
+  // Data in 12 OFDM symbols of every PRB
+  cfg.grant.nof_tb         = 1;
+  cfg.grant.tb[0].mod      = srslte_ra_dl_mod_from_mcs(mcs, false);
+  cfg.grant.tb[0].tbs      = srslte_ra_tbs_from_idx(srslte_ra_tbs_idx_from_mcs(mcs, false, false), nof_prb);
+  cfg.grant.tb[0].rv       = 0;
+  cfg.grant.tb[0].nof_bits = nof_prb * SRSLTE_NRE * 12 * srslte_mod_bits_x_symbol(cfg.grant.tb[0].mod);
+  uint32_t nof_bits        = cfg.grant.tb[0].nof_bits;
+  uint32_t nof_symbols     = nof_bits / srslte_mod_bits_x_symbol(cfg.grant.tb[0].mod);
+
+  uint8_t* data_tx = srslte_vec_u8_malloc(cfg.grant.tb[0].tbs / 8 + 3);
+  uint8_t* data_rx = srslte_vec_u8_malloc(cfg.grant.tb[0].tbs / 8 + 3);
+  uint8_t* e_bits  = srslte_vec_u8_malloc(nof_bits / 8 + 1);
+  cf_t*    symbols = srslte_vec_cf_malloc(nof_symbols);
+  int16_t* llr     = srslte_vec_i16_malloc(nof_bits);
+  if (!data_tx || !data_rx || !e_bits || !symbols || !llr) {
+    perror("malloc");
+    goto clean_exit;
+  }
+
+  if (srslte_sch_init(&sch_tx) || srslte_sch_init(&sch_rx[0]) || srslte_sch_init(&sch_rx[1]) ||
+      srslte_softbuffer_tx_init(&softbuffer_tx, nof_prb) || srslte_softbuffer_rx_init(&softbuffer[0], nof_prb) ||
+      srslte_softbuffer_rx_init(&softbuffer[1], nof_prb) || srslte_modem_table_lte(&modem, cfg.grant.tb[0].mod) ||
+      srslte_cbsegm(&cb_segm, cfg.grant.tb[0].tbs) || srslte_sch_cb_workers_init(nof_cb_workers, -1)) {
+    ERROR("Error initiating SCH\n");
+    goto clean_exit;
+  }
+  srslte_modem_table_bytes(&modem);
+  cfg.softbuffers.tx[0] = &softbuffer_tx;
+
+  // The first decoder runs all the iterations, the second one is adaptive. Like in the eNB, each decodes all the UEs
+  srslte_sch_set_adaptive_noi(&sch_rx[1], avg_its);
+  srslte_sch_enable_cb_workers(&sch_rx[0], nof_cb_workers > 0);
+  srslte_sch_enable_cb_workers(&sch_rx[1], nof_cb_workers > 0);
+
+  printf("%d PRB, TBS=%d bits in %d code blocks, %d UEs per subframe, %d subframes, noise std %.2f\n",
+         nof_prb,
+         cfg.grant.tb[0].tbs,
+         cb_segm.C,
+         ue_x_tti,
+         nof_sf,
+         noise_std);
+
+  for (uint32_t tti = 0; tti < nof_sf; tti++) {
+    uint32_t sf_its[2] = {};
+
+    srslte_sch_reset_adaptive_budget(&sch_rx[1]);
+    for (uint32_t k = 0; k < ue_x_tti; k++) {
+      for (uint32_t i = 0; i < cfg.grant.tb[0].tbs / 8; i++) {
+        data_tx[i] = (uint8_t)srslte_random_uniform_int_dist(random_h, 0, 255);
+      }
+      srslte_softbuffer_tx_reset(&softbuffer_tx);
+      bzero(e_bits, nof_bits / 8 + 1);
+      if (srslte_dlsch_encode(&sch_tx, &cfg, data_tx, e_bits)) {
+        ERROR("Error encoding TB\n");
+        goto clean_exit;
+      }
+      srslte_mod_modulate_bytes(&modem, e_bits, symbols, nof_bits);
+      float ue_noise_std = noise_std * (1.0f + 0.05f * k);
+      srslte_ch_awgn_c(symbols, symbols, ue_noise_std * ue_noise_std, nof_symbols);
+      srslte_demod_soft_demodulate_s(cfg.grant.tb[0].mod, symbols, llr, nof_symbols);
+
+      for (uint32_t d = 0; d < 2; d++) {
+        sf_its[d] += decode_ue(&sch_rx[d], &softbuffer[d], &cfg, llr, data_tx, data_rx, cb_segm.C, &results[d]);
+      }
+    }
+
+    for (uint32_t d = 0; d < 2; d++) {
+      results[d].max_sf_its = SRSLTE_MAX(results[d].max_sf_its, sf_its[d]);
+    }
+  }
+
+  uint32_t nof_tb = nof_sf * ue_x_tti;
+  uint32_t nof_cb = nof_tb * cb_segm.C;
+  printf("%-9s %8s %16s %22s\n", "Decoder", "TB OK", "Half its per CB", "Max half its per SF");
+  const char* decoder_names[2] = {"Full", "Adaptive"};
+  for (uint32_t d = 0; d < 2; d++) {
+    printf("%-9s %4d/%-3d %16.2f %22d\n",
+           decoder_names[d],
+           results[d].nof_tb_ok,
+           nof_tb,
+           (float)results[d].nof_its / nof_cb,
+           results[d].max_sf_its);
+  }
+
+  // The channel must leave code blocks that do not converge, otherwise there is nothing to save
+  if (results[0].nof_tb_ok == nof_tb || results[0].nof_tb_ok == 0) {
+    ERROR("The noise does not make some transport blocks fail\n");
+    goto clean_exit;
+  }
+
+  // The adaptive decoder takes fewer iterations on average and never more than the budget in a subframe
+  if (results[1].nof_its >= results[0].nof_its) {
+    ERROR("Adaptive decoding did not reduce the average iterations\n");
+    goto clean_exit;
+  }
+  if (results[1].max_sf_its > sch_rx[1].adaptive_iterations * ue_x_tti * cb_segm.C) {
+    ERROR("Adaptive decoding exceeded the iterations of a subframe\n");
+    goto clean_exit;
+  }
+
+  // Giving up code blocks that do not converge barely loses transport blocks
+  if (results[1].nof_tb_ok + nof_tb / 20 < results[0].nof_tb_ok) {
+    ERROR("Adaptive decoding lost too many transport blocks\n");
+    goto clean_exit;
+  }
+
+  ret = SRSLTE_SUCCESS;
+
+clean_exit:
+  srslte_sch_free(&sch_tx);
+  srslte_sch_free(&sch_rx[0]);
+  srslte_sch_free(&sch_rx[1]);
+  srslte_sch_cb_workers_free();
+  srslte_softbuffer_tx_free(&softbuffer_tx);
+  srslte_softbuffer_rx_free(&softbuffer[0]);
+  srslte_softbuffer_rx_free(&softbuffer[1]);
+  srslte_modem_table_free(&modem);
+  if (data_tx) {
+    free(data_tx);
+  }
+  if (data_rx) {
+    free(data_rx);
+  }
+  if (e_bits) {
+    free(e_bits);
+  }
+  if (symbols) {
+    free(symbols);
+  }
+  if (llr) {
+    free(llr);
+  }
+  srslte_random_free(random_h);
+
+  printf("%s\n", ret ? "Error" : "Ok");
+  return ret;
+}
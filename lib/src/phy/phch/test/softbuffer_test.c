@@ -0,0 +1,315 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srslte/srslte.h"
+#include <srslte/phy/utils/random.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#define NOF_HARQ 8
+
+static uint32_t nof_ue    = 16;
+static uint32_t nof_prb   = 100;
+static uint32_t mcs       = 28;
+static uint32_t nof_sf    = 200;
+static uint32_t ue_x_tti  = 4;
+static float    noise_std = 0.05f;
+
+typedef struct {
+  double   memory_mb;
+  double   throughput_mbps;
+  uint32_t nof_ack;
+  uint32_t nof_nack;
+} layout_result_t;
+
+void usage(char* prog)
+{
+  printf("Usage: %s [nmusUe]\n", prog);
+  printf("\t-n nof_prb [Default %d]\n", nof_prb);
+  printf("\t-m MCS [Default %d]\n", mcs);
+  printf("\t-u number of UEs [Default %d]\n", nof_ue);
+  printf("\t-s number of subframes [Default %d]\n", nof_sf);
+  printf("\t-U UEs scheduled per subframe [Default %d]\n", ue_x_tti);
+  printf("\t-e Noise standard deviation [Default %.2f]\n", noise_std);
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "nmusUe")) != -1) {
+    switch (opt) {
+      case 'n':
+        nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'm':
+        mcs = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'u':
+        nof_ue = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 's':
+        nof_sf = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'U':
+        ue_x_tti = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'e':
+        noise_std = strtof(argv[optind], NULL);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+}
+
+/* Every UE transmits on the HARQ process of the subframe. Every other new transport block is received with weak soft
+ * bits of random sign in its second half, so that it is NACKed and its soft bits are held until the retransmission */
+static int run_layout(bool                use_pool,
+                      srslte_pdsch_cfg_t* cfg,
+                      void*               llr,
+                      void*               llr_erased,
+                      uint8_t*            data_tx,
+                      uint8_t*            data_rx,
+                      layout_result_t*    result)
+{
+  int                      ret         = SRSLTE_ERROR;
+  uint32_t                 nof_sb      = nof_ue * NOF_HARQ;
+  srslte_softbuffer_rx_t*  softbuffers = calloc(sizeof(srslte_softbuffer_rx_t), nof_sb);
+  bool*                    pending     = calloc(sizeof(bool), nof_sb);
+  srslte_softbuffer_pool_t pool        = {};
+  srslte_sch_t             sch         = {};
+  struct timeval           t[3];
+  uint64_t                 decode_us = 0, decode_bits = 0;
+  uint32_t                 nof_new_tx = 0;
+
+  bzero(result, sizeof(layout_result_t));
+
+  if (!softbuffers || !pending || srslte_sch_init(&sch)) {
+    ERROR("Error initiating SCH\n");
+    goto clean_exit;
+  }
+  sch.llr_is_8bit = use_pool;
+
+  uint32_t max_tbs = (uint32_t)srslte_ra_tbs_from_idx(SRSLTE_RA_NOF_TBS_IDX - 1, nof_prb);
+  uint32_t max_cb  = max_tbs / (SRSLTE_TCOD_MAX_LEN_CB - 24) + 1;
+  if (use_pool && srslte_softbuffer_pool_init(&pool, nof_sb * max_cb)) {
+    ERROR("Error initiating softbuffer pool\n");
+    goto clean_exit;
+  }
+  for (uint32_t i = 0; i < nof_sb; i++) {
+    int err = use_pool ? srslte_softbuffer_rx_init_pool(&softbuffers[i], nof_prb, &pool)
+                       : srslte_softbuffer_rx_init(&softbuffers[i], nof_prb);
+    if (err) {
+      ERROR("Error initiating softbuffer\n");
+      goto clean_exit;
+    }
+  }
+
+  for (uint32_t tti = 0; tti < nof_sf; tti++) {
+    for (uint32_t k = 0; k < ue_x_tti; k++) {
+      uint32_t sb_idx = ((tti * ue_x_tti + k) % nof_ue) * NOF_HARQ + tti % NOF_HARQ;
+      void*    e_bits = llr;
+
+      if (!pending[sb_idx]) {
+        srslte_softbuffer_rx_reset_tbs(&softbuffers[sb_idx], cfg->grant.tb[0].tbs);
+        if (nof_new_tx++ % 2) {
+          e_bits = llr_erased;
+        }
+      }
+
+      cfg->softbuffers.rx[0] = &softbuffers[sb_idx];
+      gettimeofday(&t[1], NULL);
+      int r = srslte_dlsch_decode(&sch, cfg, e_bits, data_rx);
+      gettimeofday(&t[2], NULL);
+      get_time_interval(t);
+      decode_us += t[0].tv_sec * 1000000 + t[0].tv_usec;
+      decode_bits += cfg->grant.tb[0].tbs;
+
+      if (r == SRSLTE_SUCCESS && memcmp(data_rx, data_tx, cfg->grant.tb[0].tbs / 8) == 0) {
+        pending[sb_idx] = false;
+        result->nof_ack++;
+      } else if (e_bits == llr_erased) {
+        pending[sb_idx] = true;
+        result->nof_nack++;
+      } else {
+        ERROR("Error decoding %s transmission (tti=%d, sb=%d)\n", pending[sb_idx] ? "re-" : "first", tti, sb_idx);
+        goto clean_exit;
+      }
+    }
+  }
+
+  if (use_pool) {
+    result->memory_mb = (double)pool.nof_slabs * SOFTBUFFER_SLAB_SIZE / 1e6;
+  } else {
+    result->memory_mb = (double)nof_sb * max_cb * (SOFTBUFFER_SIZE * sizeof(int16_t) + 6144 / 8) / 1e6;
+  }
+  result->throughput_mbps = decode_us ? (double)decode_bits / decode_us : 0;
+  ret                     = SRSLTE_SUCCESS;
+
+clean_exit:
+  if (softbuffers) {
+    for (uint32_t i = 0; i < nof_sb; i++) {
+      srslte_softbuffer_rx_free(&softbuffers[i]);
+    }
+    free(softbuffers);
+  }
+  if (pending) {
+    free(pending);
+  }
+  if (use_pool) {
+    if (ret == SRSLTE_SUCCESS && pool.nof_free != pool.nof_slabs) {
+      ERROR("%d softbuffer slabs were not returned to the pool\n", pool.nof_slabs - pool.nof_free);
+      ret = SRSLTE_ERROR;
+    }
+    srslte_softbuffer_pool_free(&pool);
+  }
+  srslte_sch_free(&sch);
+  return ret;
+}
+
+int main(int argc, char** argv)
+{
+  int                    ret           = SRSLTE_ERROR;
+  srslte_random_t        random_h      = srslte_random_init(0);
+  srslte_sch_t           sch_tx        = {};
+  srslte_modem_table_t   modem         = {};
+  srslte_softbuffer_tx_t softbuffer_tx = {};
+  srslte_pdsch_cfg_t     cfg           = {};
+  layout_result_t        results[2]    = {};
+
+  parse_args(argc, argv);
+
+  // Data in 12 OFDM symbols of every PRB
+  cfg.grant.nof_tb         = 1;
+  cfg.grant.tb[0].mod      = srslte_ra_dl_mod_from_mcs(mcs, false);
+  cfg.grant.tb[0].tbs      = srslte_ra_tbs_from_idx(srslte_ra_tbs_idx_from_mcs(mcs, false, false), nof_prb);
+  cfg.grant.tb[0].rv       = 0;
+  cfg.grant.tb[0].nof_bits = nof_prb * SRSLTE_NRE * 12 * srslte_mod_bits_x_symbol(cfg.grant.tb[0].mod);
+  uint32_t nof_bits        = cfg.grant.tb[0].nof_bits;
+
+  uint8_t* data_tx  = srslte_vec_u8_malloc(cfg.grant.tb[0].tbs / 8 + 3);
+  uint8_t* data_rx  = srslte_vec_u8_malloc(cfg.grant.tb[0].tbs / 8 + 3);
+  uint8_t* e_bits   = srslte_vec_u8_malloc(nof_bits / 8 + 1);
+  cf_t*    symbols  = srslte_vec_cf_malloc(nof_bits / srslte_mod_bits_x_symbol(cfg.grant.tb[0].mod));
+  int16_t* llr_s    = srslte_vec_i16_malloc(nof_bits);
+  int16_t* llr_s_er = srslte_vec_i16_malloc(nof_bits);
+  int8_t*  llr_b    = srslte_vec_i8_malloc(nof_bits);
+  int8_t*  llr_b_er = srslte_vec_i8_malloc(nof_bits);
+  if (!data_tx || !data_rx || !e_bits || !symbols || !llr_s || !llr_s_er || !llr_b || !llr_b_er) {
+    perror("malloc");
+    goto clean_exit;
+  }
+
+  if (srslte_sch_init(&sch_tx) || srslte_softbuffer_tx_init(&softbuffer_tx, nof_prb) ||
+      srslte_modem_table_lte(&modem, cfg.grant.tb[0].mod)) {
+    ERROR("Error initiating SCH\n");
+    goto clean_exit;
+  }
+
+  // Encode one transport block, shared by all the UEs
+  for (uint32_t i = 0; i < cfg.grant.tb[0].tbs / 8; i++) {
+    data_tx[i] = (uint8_t)srslte_random_uniform_int_dist(random_h, 0, 255);
+  }
+  cfg.softbuffers.tx[0] = &softbuffer_tx;
+  bzero(e_bits, nof_bits / 8 + 1);
+  if (srslte_dlsch_encode(&sch_tx, &cfg, data_tx, e_bits)) {
+    ERROR("Error encoding TB\n");
+    goto clean_exit;
+  }
+  uint32_t nof_symbols = nof_bits / srslte_mod_bits_x_symbol(cfg.grant.tb[0].mod);
+  srslte_modem_table_bytes(&modem);
+  srslte_mod_modulate_bytes(&modem, e_bits, symbols, nof_bits);
+  srslte_ch_awgn_c(symbols, symbols, noise_std * noise_std, nof_symbols);
+  srslte_demod_soft_demodulate_s(cfg.grant.tb[0].mod, symbols, llr_s, nof_symbols);
+  srslte_demod_soft_demodulate_b(cfg.grant.tb[0].mod, symbols, llr_b, nof_symbols);
+
+  // The second half of the failed transmissions is received with weak soft bits of random sign
+  memcpy(llr_s_er, llr_s, sizeof(int16_t) * nof_bits);
+  memcpy(llr_b_er, llr_b, sizeof(int8_t) * nof_bits);
+  for (uint32_t i = nof_bits / 2; i < nof_bits; i++) {
+    int sign    = srslte_random_uniform_int_dist(random_h, 0, 1) ? 1 : -1;
+    llr_s_er[i] = (int16_t)(sign * llr_s[i] / 4);
+    llr_b_er[i] = (int8_t)(sign * llr_b[i] / 4);
+  }
+
+  printf("%d UEs x %d HARQ processes, %d PRB, TBS=%d bits, %d UEs per subframe, %d subframes\n",
+         nof_ue,
+         NOF_HARQ,
+         nof_prb,
+         cfg.grant.tb[0].tbs,
+         ue_x_tti,
+         nof_sf);
+
+  if (run_layout(false, &cfg, llr_s, llr_s_er, data_tx, data_rx, &results[0]) ||
+      run_layout(true, &cfg, llr_b, llr_b_er, data_tx, data_rx, &results[1])) {
+    goto clean_exit;
+  }
+
+  const char* layout_names[2] = {"16-bit, allocated at init", "8-bit, pooled"};
+  printf("%-26s %12s %18s %6s %6s\n", "Softbuffer layout", "Memory (MB)", "Throughput (Mbps)", "ACK", "NACK");
+  for (uint32_t i = 0; i < 2; i++) {
+    printf("%-26s %12.2f %18.2f %6d %6d\n",
+           layout_names[i],
+           results[i].memory_mb,
+           results[i].throughput_mbps,
+           results[i].nof_ack,
+           results[i].nof_nack);
+  }
+
+  ret = SRSLTE_SUCCESS;
+
+clean_exit:
+  srslte_sch_free(&sch_tx);
+  srslte_softbuffer_tx_free(&softbuffer_tx);
+  srslte_modem_table_free(&modem);
+  if (data_tx) {
+    free(data_tx);
+  }
+  if (data_rx) {
+    free(data_rx);
+  }
+  if (e_bits) {
+    free(e_bits);
+  }
+  if (symbols) {
+    free(symbols);
+  }
+  if (llr_s) {
+    free(llr_s);
+  }
+  if (llr_s_er) {
+    free(llr_s_er);
+  }
+  if (llr_b) {
+    free(llr_b);
+  }
+  if (llr_b_er) {
+    free(llr_b_er);
+  }
+  srslte_random_free(random_h);
+
+  printf("%s\n", ret ? "Error" : "Ok");
+  return ret;
+}
@@ -786,6 +786,7 @@ int srslte_uci_encode_ack_ri(srslte_pusch_cfg_t* cfg,
 
 /* Decode UCI ACK/RI bits as described in 5.2.2.6 of 36.212
  *  Currently only supporting 1-bit RI
+ *  The scrambling sequence c_seq is packed, MSB first
  */
 int srslte_uci_decode_ack_ri(srslte_pusch_cfg_t* cfg,
                              int16_t*            q_bits,
@@ -829,7 +830,9 @@ int srslte_uci_decode_ack_ri(srslte_pusch_cfg_t* cfg,
       // Remove scrambling of repeated bits
       if (nof_bits == 1) {
         if (acc_idx == 1 && pos > 0) {
-          q = (c_seq[pos] == c_seq[pos - 1]) ? +q : -q;
+          uint8_t c0 = (c_seq[(pos - 1) / 8] >> (7 - (pos - 1) % 8)) & 1U;
+          uint8_t c1 = (c_seq[pos / 8] >> (7 - pos % 8)) & 1U;
+          q          = (c0 == c1) ? +q : -q;
         }
       }
 
@@ -23,6 +23,11 @@
 #include "srslte/phy/utils/bit.h"
 #include "srslte/phy/utils/vector.h"
 #include <assert.h>
+#include <string.h>
+
+#ifdef LV_HAVE_SSE
+#include <immintrin.h>
+#endif /* LV_HAVE_SSE */
 
 void srslte_scrambling_f(srslte_sequence_t* s, float* data)
 {
@@ -81,11 +86,86 @@ void srslte_scrambling_b_offset(srslte_sequence_t* s, uint8_t* data, int offset,
 void srslte_scrambling_bytes(srslte_sequence_t* s, uint8_t* data, int len)
 {
   scrambling_b(s->c_bytes, data, len / 8);
-  // Scramble last bits
+  // Scramble last bits, the ones past the end are cleared
   if (len % 8) {
-    uint8_t tmp_bits[8];
-    srslte_bit_unpack_vector(&data[len / 8], tmp_bits, len % 8);
-    scrambling_b(&s->c[8 * (len / 8)], tmp_bits, len % 8);
-    srslte_bit_pack_vector(tmp_bits, &data[len / 8], len % 8);
+    data[len / 8] = (data[len / 8] ^ s->c_bytes[len / 8]) & (uint8_t)(0xffU << (8 - len % 8));
+  }
+}
+
+void srslte_scrambling_bytes_s(srslte_sequence_t* s, short* data, int len)
+{
+  assert(len <= s->cur_len);
+
+  const uint8_t* c = s->c_bytes;
+  int            i = 0;
+
+#ifdef LV_HAVE_AVX2
+  // Every 16-bit lane tests its bit of the two sequence bytes, MSB first
+  const __m256i bits16 = _mm256_setr_epi16(
+      0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01, 0x8000, 0x4000, 0x2000, 0x1000, 0x800, 0x400, 0x200, 0x100);
+  for (; i < len - 15; i += 16) {
+    uint16_t w = (uint16_t)c[i / 8] | ((uint16_t)c[i / 8 + 1] << 8U);
+    __m256i  m = _mm256_cmpeq_epi16(_mm256_and_si256(_mm256_set1_epi16((short)w), bits16), bits16);
+    __m256i  x = _mm256_loadu_si256((__m256i*)&data[i]);
+    _mm256_storeu_si256((__m256i*)&data[i], _mm256_sub_epi16(_mm256_xor_si256(x, m), m));
+  }
+#endif /* LV_HAVE_AVX2 */
+
+#ifdef LV_HAVE_SSE
+  const __m128i bits8 = _mm_setr_epi16(0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+  for (; i < len - 7; i += 8) {
+    __m128i m = _mm_set1_epi16(c[i / 8]);
+    m         = _mm_cmpeq_epi16(_mm_and_si128(m, bits8), bits8);
+    __m128i x = _mm_loadu_si128((__m128i*)&data[i]);
+    _mm_storeu_si128((__m128i*)&data[i], _mm_sub_epi16(_mm_xor_si128(x, m), m));
+  }
+#endif /* LV_HAVE_SSE */
+
+  for (; i < len; i++) {
+    if ((c[i / 8] >> (7 - i % 8)) & 1U) {
+      data[i] = -data[i];
+    }
+  }
+}
+
+void srslte_scrambling_bytes_sb(srslte_sequence_t* s, int8_t* data, int len)
+{
+  assert(len <= s->cur_len);
+
+  const uint8_t* c = s->c_bytes;
+  int            i = 0;
+
+#ifdef LV_HAVE_AVX2
+  // Every 8-bit lane tests its bit of the four sequence bytes, MSB first
+  const __m256i bits32 = _mm256_set1_epi64x(0x0102040810204080);
+  const __m256i idx32  = _mm256_setr_epi8(
+      0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+  for (; i < len - 31; i += 32) {
+    int32_t w;
+    memcpy(&w, &c[i / 8], sizeof(int32_t));
+
+    // The four bytes are in both halves, as the shuffle does not cross them
+    __m256i m = _mm256_shuffle_epi8(_mm256_set1_epi32(w), idx32);
+    m         = _mm256_cmpeq_epi8(_mm256_and_si256(m, bits32), bits32);
+    __m256i x = _mm256_loadu_si256((__m256i*)&data[i]);
+    _mm256_storeu_si256((__m256i*)&data[i], _mm256_sub_epi8(_mm256_xor_si256(x, m), m));
+  }
+#endif /* LV_HAVE_AVX2 */
+
+#ifdef LV_HAVE_SSE
+  const __m128i bits16 = _mm_set1_epi64x(0x0102040810204080);
+  const __m128i idx16  = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1);
+  for (; i < len - 15; i += 16) {
+    __m128i m = _mm_shuffle_epi8(_mm_set1_epi16((short)((uint16_t)c[i / 8] | ((uint16_t)c[i / 8 + 1] << 8U))), idx16);
+    m         = _mm_cmpeq_epi8(_mm_and_si128(m, bits16), bits16);
+    __m128i x = _mm_loadu_si128((__m128i*)&data[i]);
+    _mm_storeu_si128((__m128i*)&data[i], _mm_sub_epi8(_mm_xor_si128(x, m), m));
+  }
+#endif /* LV_HAVE_SSE */
+
+  for (; i < len; i++) {
+    if ((c[i / 8] >> (7 - i % 8)) & 1U) {
+      data[i] = -data[i];
+    }
   }
 }
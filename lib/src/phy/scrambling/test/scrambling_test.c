@@ -139,6 +139,25 @@ int main(int argc, char** argv)
         exit(-1);
       }
     }
+
+    // Scramble packed bits and compare with the unpacked ones
+    uint8_t* packed_b = srslte_vec_u8_malloc(seq.cur_len / 8 + 1);
+    if (!packed_b) {
+      perror("malloc");
+      exit(-1);
+    }
+    srslte_bit_pack_vector(input_b, packed_b, seq.cur_len);
+    srslte_scrambling_bytes(&seq, packed_b, seq.cur_len);
+    srslte_scrambling_b(&seq, input_b);
+    srslte_bit_unpack_vector(packed_b, scrambled_b, seq.cur_len);
+
+    for (i = 0; i < seq.cur_len; i++) {
+      if (scrambled_b[i] != input_b[i]) {
+        printf("Error in packed %d\n", i);
+        exit(-1);
+      }
+    }
+    free(packed_b);
     free(input_b);
     free(scrambled_b);
   } else {
@@ -247,6 +266,43 @@ int main(int argc, char** argv)
       }
     }
 
+    // Descramble soft bits with the packed sequence and compare with the signed one
+    int16_t* packed_s = srslte_vec_i16_malloc(seq.cur_len);
+    if (!packed_s) {
+      perror("malloc");
+      exit(-1);
+    }
+    input_s = srslte_vec_i16_malloc(seq.cur_len);
+    if (!input_s) {
+      perror("malloc");
+      exit(-1);
+    }
+    for (i = 0; i < seq.cur_len; i++) {
+      input_s[i]     = (int16_t)(rand() % 256 - 128);
+      input_b[i]     = (int8_t)input_s[i];
+      packed_s[i]    = input_s[i];
+      scrambled_b[i] = input_b[i];
+    }
+
+    gettimeofday(&t[1], NULL);
+    srslte_scrambling_bytes_s(&seq, packed_s, seq.cur_len);
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+    printf("Texec packed short=%ld us for %d bits\n", t[0].tv_usec, seq.cur_len);
+
+    srslte_scrambling_bytes_sb(&seq, scrambled_b, seq.cur_len);
+    srslte_scrambling_s(&seq, input_s);
+    srslte_scrambling_sb_offset(&seq, input_b, 0, seq.cur_len);
+
+    for (i = 0; i < seq.cur_len; i++) {
+      if (packed_s[i] != input_s[i] || scrambled_b[i] != input_b[i]) {
+        printf("Error in packed %d\n", i);
+        exit(-1);
+      }
+    }
+
+    free(packed_s);
+    free(input_s);
     free(input_b);
     free(scrambled_b);
   }
@@ -160,6 +160,7 @@ void srslte_ue_dl_free(srslte_ue_dl_t* q)
       srslte_ofdm_rx_free(&q->fft[port]);
     }
     srslte_ofdm_rx_free(&q->fft_mbsfn);
+    srslte_ofdm_group_free(&q->fft_group);
     srslte_chest_dl_free(&q->chest);
     srslte_chest_dl_res_free(&q->chest_res);
     for (int i = 0; i < MI_NOF_REGS; i++) {
@@ -199,11 +200,17 @@ int srslte_ue_dl_set_cell(srslte_ue_dl_t* q, srslte_cell_t cell)
           return SRSLTE_ERROR;
         }
       }
+      srslte_ofdm_t* fft[SRSLTE_MAX_PORTS] = {};
       for (int port = 0; port < q->nof_rx_antennas; port++) {
         if (srslte_ofdm_rx_set_prb(&q->fft[port], q->cell.cp, q->cell.nof_prb)) {
           ERROR("Error resizing FFT\n");
           return SRSLTE_ERROR;
         }
+        fft[port] = &q->fft[port];
+      }
+      if (srslte_ofdm_group_init(&q->fft_group, fft, q->nof_rx_antennas)) {
+        ERROR("Error grouping the FFT of %d antennas\n", q->nof_rx_antennas);
+        return SRSLTE_ERROR;
       }
 
       // In TDD, initialize PDCCH and PHICH for the worst case: max ncces and phich groupds respectively
@@ -273,7 +280,7 @@ void srslte_ue_dl_set_mi_manual(srslte_ue_dl_t* q, uint32_t mi_idx)
   q->mi_manual_index = mi_idx;
 }
 
-/* Precalculate the PDSCH scramble sequences for a given RNTI. This function takes a while
+/* Precalculate the UE-specific search spaces for a given RNTI. This function takes a while
  * to execute, so shall be called once the final C-RNTI has been allocated for the session.
  * For the connection procedure, use srslte_pusch_encode_rnti() or srslte_pusch_decode_rnti() functions
  */
@@ -382,12 +389,10 @@ int srslte_ue_dl_decode_fft_estimate(srslte_ue_dl_t* q, srslte_dl_sf_cfg_t* sf,
 {
   if (q) {
     /* Run FFT for all subframe data */
-    for (int j = 0; j < q->nof_rx_antennas; j++) {
-      if (sf->sf_type == SRSLTE_SF_MBSFN) {
-        srslte_ofdm_rx_sf(&q->fft_mbsfn);
-      } else {
-        srslte_ofdm_rx_sf(&q->fft[j]);
-      }
+    if (sf->sf_type == SRSLTE_SF_MBSFN) {
+      srslte_ofdm_rx_sf(&q->fft_mbsfn);
+    } else {
+      srslte_ofdm_rx_sf_batch(&q->fft_group);
     }
     return estimate_pdcch_pcfich(q, sf, cfg);
   } else {
@@ -440,48 +445,60 @@ static int dci_blind_search(srslte_ue_dl_t*     q,
 {
   uint32_t nof_dci = 0;
   if (rnti) {
+    srslte_dci_msg_t candidates[SRSLTE_PDCCH_MAX_BATCH];
+
     int i = 0;
     while ((dci_cfg->cif_enabled || !nof_dci) && (i < search_space->nof_locations) && (nof_dci < SRSLTE_MAX_DCI_MSG)) {
-      DEBUG("Searching format %s in %d,%d (%d/%d)\n",
-            srslte_dci_format_string(search_space->format),
-            search_space->loc[i].ncce,
-            search_space->loc[i].L,
-            i,
-            search_space->nof_locations);
-
-      dci_msg[nof_dci].location = search_space->loc[i];
-      dci_msg[nof_dci].format   = search_space->format;
-      dci_msg[nof_dci].rnti     = 0;
-      if (srslte_pdcch_decode_msg(&q->pdcch, sf, dci_cfg, &dci_msg[nof_dci])) {
+      /* Decode the next candidates at once, they are checked in order below */
+      uint32_t nof_candidates = SRSLTE_MIN(search_space->nof_locations - i, SRSLTE_PDCCH_MAX_BATCH);
+      for (uint32_t k = 0; k < nof_candidates; k++) {
+        candidates[k].location = search_space->loc[i + k];
+        candidates[k].format   = search_space->format;
+        candidates[k].rnti     = 0;
+        candidates[k].nof_bits = 0;
+      }
+      if (srslte_pdcch_decode_msg_batch(&q->pdcch, sf, dci_cfg, candidates, nof_candidates)) {
         ERROR("Error decoding DCI msg\n");
         return SRSLTE_ERROR;
       }
 
-      if ((dci_msg[nof_dci].rnti == rnti) && (dci_msg[nof_dci].nof_bits > 0)) {
-
-        dci_msg[nof_dci].rnti = rnti;
-        // If searching for Format1A but found Format0 save it for later
-        if (dci_msg[nof_dci].format == SRSLTE_DCI_FORMAT0 && search_space->format == SRSLTE_DCI_FORMAT1A) {
-          /* If there is space for accumulate another UL DCI dci and it was not detected before, then store it */
-          if (q->pending_ul_dci_count < SRSLTE_MAX_CARRIERS &&
-              !find_dci(q->pending_ul_dci_msg, q->pending_ul_dci_count, &dci_msg[nof_dci])) {
-            srslte_dci_msg_t* pending_ul_dci_msg = &q->pending_ul_dci_msg[q->pending_ul_dci_count];
-            pending_ul_dci_msg->format           = dci_msg[nof_dci].format;
-            pending_ul_dci_msg->location         = dci_msg[nof_dci].location;
-            pending_ul_dci_msg->nof_bits         = dci_msg[nof_dci].nof_bits;
-            pending_ul_dci_msg->rnti             = dci_msg[nof_dci].rnti;
-            memcpy(pending_ul_dci_msg->payload, dci_msg[nof_dci].payload, dci_msg[nof_dci].nof_bits);
-            q->pending_ul_dci_count++;
-          }
-          // Else if we found it, save location and keep going if required
-        } else if (dci_msg[nof_dci].format == search_space->format) {
-          /* Check if the DCI is duplicated */
-          if (!find_dci(dci_msg, (uint32_t)nof_dci, &dci_msg[nof_dci])) {
-            nof_dci++;
+      for (uint32_t k = 0; k < nof_candidates && (dci_cfg->cif_enabled || !nof_dci) && (nof_dci < SRSLTE_MAX_DCI_MSG);
+           k++) {
+        DEBUG("Searching format %s in %d,%d (%d/%d)\n",
+              srslte_dci_format_string(search_space->format),
+              search_space->loc[i].ncce,
+              search_space->loc[i].L,
+              i,
+              search_space->nof_locations);
+
+        dci_msg[nof_dci] = candidates[k];
+
+        if ((dci_msg[nof_dci].rnti == rnti) && (dci_msg[nof_dci].nof_bits > 0)) {
+
+          dci_msg[nof_dci].rnti = rnti;
+          // If searching for Format1A but found Format0 save it for later
+          if (dci_msg[nof_dci].format == SRSLTE_DCI_FORMAT0 && search_space->format == SRSLTE_DCI_FORMAT1A) {
+            /* If there is space for accumulate another UL DCI dci and it was not detected before, then store it */
+            if (q->pending_ul_dci_count < SRSLTE_MAX_CARRIERS &&
+                !find_dci(q->pending_ul_dci_msg, q->pending_ul_dci_count, &dci_msg[nof_dci])) {
+              srslte_dci_msg_t* pending_ul_dci_msg = &q->pending_ul_dci_msg[q->pending_ul_dci_count];
+              pending_ul_dci_msg->format           = dci_msg[nof_dci].format;
+              pending_ul_dci_msg->location         = dci_msg[nof_dci].location;
+              pending_ul_dci_msg->nof_bits         = dci_msg[nof_dci].nof_bits;
+              pending_ul_dci_msg->rnti             = dci_msg[nof_dci].rnti;
+              memcpy(pending_ul_dci_msg->payload, dci_msg[nof_dci].payload, dci_msg[nof_dci].nof_bits);
+              q->pending_ul_dci_count++;
+            }
+            // Else if we found it, save location and keep going if required
+          } else if (dci_msg[nof_dci].format == search_space->format) {
+            /* Check if the DCI is duplicated */
+            if (!find_dci(dci_msg, (uint32_t)nof_dci, &dci_msg[nof_dci])) {
+              nof_dci++;
+            }
           }
         }
+        i++;
       }
-      i++;
     }
   } else {
     ERROR("RNTI not specified\n");
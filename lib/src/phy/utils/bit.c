@@ -738,11 +738,33 @@ void srslte_bit_unpack(uint32_t value, uint8_t** bits, int nof_bits)
 
 void srslte_bit_pack_vector(uint8_t* unpacked, uint8_t* packed, int nof_bits)
 {
-  uint32_t i, nbytes;
-  nbytes = nof_bits / 8;
+  uint32_t i = 0, nbytes;
+  nbytes     = nof_bits / 8;
+
+#ifdef LV_HAVE_AVX2
+  // The bytes of every group of 8 bits are reversed so the first bit is the MSB of the mask byte
+  __m256i reverse256 = _mm256_setr_epi8(
+      7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+  for (; i + 4 <= nbytes; i += 4) {
+    __m256i mask = _mm256_cmpgt_epi8(_mm256_loadu_si256((__m256i*)unpacked), _mm256_setzero_si256());
+    unpacked += 32;
+
+    uint32_t word = (uint32_t)_mm256_movemask_epi8(_mm256_shuffle_epi8(mask, reverse256));
+    memcpy(&packed[i], &word, 4);
+  }
+#endif /* LV_HAVE_AVX2 */
 
 #ifdef LV_HAVE_SSE
-  for (i = 0; i < nbytes; i++) {
+  __m128i reverse128 = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+  for (; i + 2 <= nbytes; i += 2) {
+    __m128i mask = _mm_cmpgt_epi8(_mm_loadu_si128((__m128i*)unpacked), _mm_setzero_si128());
+    unpacked += 16;
+
+    uint16_t word = (uint16_t)_mm_movemask_epi8(_mm_shuffle_epi8(mask, reverse128));
+    memcpy(&packed[i], &word, 2);
+  }
+
+  for (; i < nbytes; i++) {
     // Get 8 Bit
     __m64 mask = _mm_cmpgt_pi8(*((__m64*)unpacked), _mm_set1_pi8(0));
     unpacked += 8;
@@ -754,7 +776,7 @@ void srslte_bit_pack_vector(uint8_t* unpacked, uint8_t* packed, int nof_bits)
     packed[i] = (uint8_t)_mm_movemask_pi8(mask);
   }
 #else  /* LV_HAVE_SSE */
-  for (i = 0; i < nbytes; i++) {
+  for (; i < nbytes; i++) {
     packed[i] = srslte_bit_pack(&unpacked, 8);
   }
 #endif /* LV_HAVE_SSE */
@@ -154,6 +154,82 @@ inline float srslte_mat_2x2_cn(cf_t h00, cf_t h01, cf_t h10, cf_t h11)
   return 10.0f * log10f(xmax / xmin);
 }
 
+inline void srslte_mat_4x4_mmse_csi_gen(const cf_t y[4],
+                                        const cf_t h[4][4],
+                                        uint32_t   nof_rxant,
+                                        uint32_t   nof_layers,
+                                        cf_t       x[4],
+                                        float      csi[4],
+                                        float      noise_estimate,
+                                        float      norm)
+{
+  cf_t  z[4], a[4][4], p[4][4], l[4][4], m[4][4];
+  float d[4];
+
+  /* 1. A = H' x H + No (lower triangle) and Z = H' x Y */
+  for (uint32_t i = 0; i < nof_layers; i++) {
+    z[i] = 0;
+    for (uint32_t j = 0; j <= i; j++) {
+      a[i][j] = 0;
+    }
+    for (uint32_t r = 0; r < nof_rxant; r++) {
+      z[i] += conjf(h[r][i]) * y[r];
+      for (uint32_t j = 0; j <= i; j++) {
+        a[i][j] += conjf(h[r][i]) * h[r][j];
+      }
+    }
+  }
+
+  /* 2. A = L x D x L', with P = L x D */
+  for (uint32_t j = 0; j < nof_layers; j++) {
+    d[j] = crealf(a[j][j]) + noise_estimate;
+    for (uint32_t k = 0; k < j; k++) {
+      d[j] -= crealf(p[j][k] * conjf(l[j][k]));
+    }
+    for (uint32_t i = j + 1; i < nof_layers; i++) {
+      p[i][j] = a[i][j];
+      for (uint32_t k = 0; k < j; k++) {
+        p[i][j] -= p[i][k] * conjf(l[j][k]);
+      }
+      l[i][j] = p[i][j] / d[j];
+    }
+  }
+
+  /* 3. M = inv(L), also unit lower triangular */
+  for (uint32_t j = 0; j < nof_layers; j++) {
+    for (uint32_t i = j + 1; i < nof_layers; i++) {
+      m[i][j] = l[i][j];
+      for (uint32_t k = j + 1; k < i; k++) {
+        m[i][j] += l[i][k] * m[k][j];
+      }
+      m[i][j] = -m[i][j];
+    }
+  }
+
+  /* 4. X = norm x inv(A) x Z = norm x M' x inv(D) x M x Z */
+  for (uint32_t i = 0; i < nof_layers; i++) {
+    x[i] = z[i];
+    for (uint32_t j = 0; j < i; j++) {
+      x[i] += m[i][j] * z[j];
+    }
+    x[i] *= norm / d[i];
+  }
+  for (uint32_t i = 0; i < nof_layers; i++) {
+    for (uint32_t j = i + 1; j < nof_layers; j++) {
+      x[i] += conjf(m[j][i]) * x[j];
+    }
+  }
+
+  /* 5. Extract CSI, the reciprocal of the diagonal of norm x inv(A) */
+  for (uint32_t i = 0; i < nof_layers; i++) {
+    float b = 1.0f / d[i];
+    for (uint32_t j = i + 1; j < nof_layers; j++) {
+      b += (crealf(m[j][i]) * crealf(m[j][i]) + cimagf(m[j][i]) * cimagf(m[j][i])) / d[j];
+    }
+    csi[i] = 1.0f / (b * norm);
+  }
+}
+
 #ifdef LV_HAVE_SSE
 #include <smmintrin.h>
 
@@ -0,0 +1,182 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+
+#include "srslte/phy/utils/debug.h"
+#include "srslte/phy/utils/simd_dispatch.h"
+
+#define SIMD_ISA_ENV "SRSLTE_SIMD_ISA"
+
+static const char* simd_isa_names[] = {"generic", "neon", "sse", "avx2", "avx512"};
+
+#define SIMD_ISA_NOF_NAMES (sizeof(simd_isa_names) / sizeof(simd_isa_names[0]))
+
+static pthread_once_t    simd_isa_once       = PTHREAD_ONCE_INIT;
+static pthread_mutex_t   simd_isa_mutex      = PTHREAD_MUTEX_INITIALIZER;
+static bool              simd_isa_selected   = false;
+static bool              simd_isa_overridden = false;
+static bool              simd_isa_limited    = false;
+static srslte_simd_isa_t simd_isa_limit      = SRSLTE_SIMD_ISA_AVX512;
+static srslte_simd_isa_t simd_isa_current    = SRSLTE_SIMD_ISA_GENERIC;
+
+srslte_simd_isa_t srslte_simd_isa_built()
+{
+#if defined(SRSLTE_SIMD_KERNELS_AVX512)
+  return SRSLTE_SIMD_ISA_AVX512;
+#elif defined(SRSLTE_SIMD_KERNELS_AVX2)
+  return SRSLTE_SIMD_ISA_AVX2;
+#elif defined(LV_HAVE_SSE)
+  return SRSLTE_SIMD_ISA_SSE;
+#elif defined(HAVE_NEON)
+  return SRSLTE_SIMD_ISA_NEON;
+#else
+  return SRSLTE_SIMD_ISA_GENERIC;
+#endif
+}
+
+srslte_simd_isa_t srslte_simd_isa_cpu()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_cpu_init();
+  // The AVX512 kernels use byte and word instructions, the AVX2 ones are built with FMA
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+    return SRSLTE_SIMD_ISA_AVX512;
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return SRSLTE_SIMD_ISA_AVX2;
+  }
+  if (__builtin_cpu_supports("sse4.1")) {
+    return SRSLTE_SIMD_ISA_SSE;
+  }
+  return SRSLTE_SIMD_ISA_GENERIC;
+#elif defined(HAVE_NEON)
+  return SRSLTE_SIMD_ISA_NEON;
+#else
+  return SRSLTE_SIMD_ISA_GENERIC;
+#endif
+}
+
+static int simd_isa_parse(const char* name, srslte_simd_isa_t* isa, bool* limited)
+{
+  if (!strcasecmp(name, "auto")) {
+    *limited = false;
+    return SRSLTE_SUCCESS;
+  }
+  for (uint32_t i = 0; i < SIMD_ISA_NOF_NAMES; i++) {
+    if (!strcasecmp(name, simd_isa_names[i])) {
+      *isa     = (srslte_simd_isa_t)i;
+      *limited = true;
+      return SRSLTE_SUCCESS;
+    }
+  }
+  return SRSLTE_ERROR;
+}
+
+static void simd_isa_select()
+{
+  pthread_mutex_lock(&simd_isa_mutex);
+
+  // The environment only applies if srslte_simd_isa_set() has not been called
+  const char* env = getenv(SIMD_ISA_ENV);
+  if (!simd_isa_overridden && env && env[0] != '\0') {
+    if (simd_isa_parse(env, &simd_isa_limit, &simd_isa_limited)) {
+      ERROR("Invalid %s=%s, using the highest instruction set available\n", SIMD_ISA_ENV, env);
+    }
+  }
+
+  srslte_simd_isa_t isa = srslte_simd_isa_built();
+  if (srslte_simd_isa_cpu() < isa) {
+    isa = srslte_simd_isa_cpu();
+  }
+  if (simd_isa_limited && simd_isa_limit < isa) {
+    isa = simd_isa_limit;
+  }
+#ifndef HAVE_NEON
+  // The NEON kernels are not built on x86, use the generic ones instead
+  if (isa == SRSLTE_SIMD_ISA_NEON) {
+    isa = SRSLTE_SIMD_ISA_GENERIC;
+  }
+#endif /* HAVE_NEON */
+#ifdef LV_HAVE_SSE
+  // Other code of the library uses the instruction set it is compiled for, so the kernels do not go below it
+  if (isa < SRSLTE_SIMD_ISA_SSE) {
+    isa = SRSLTE_SIMD_ISA_SSE;
+  }
+#endif /* LV_HAVE_SSE */
+
+  simd_isa_current  = isa;
+  simd_isa_selected = true;
+
+  pthread_mutex_unlock(&simd_isa_mutex);
+
+  INFO("SIMD kernels: %s\n", srslte_simd_isa_string(isa));
+}
+
+srslte_simd_isa_t srslte_simd_isa()
+{
+  pthread_once(&simd_isa_once, simd_isa_select);
+  return simd_isa_current;
+}
+
+int srslte_simd_isa_set(const char* name)
+{
+  int ret = SRSLTE_ERROR;
+
+  if (name == NULL) {
+    return SRSLTE_ERROR_INVALID_INPUTS;
+  }
+
+  pthread_mutex_lock(&simd_isa_mutex);
+  if (simd_isa_selected) {
+    ERROR("The SIMD instruction set can not be changed once selected (%s)\n", srslte_simd_isa_string(simd_isa_current));
+  } else if (simd_isa_parse(name, &simd_isa_limit, &simd_isa_limited)) {
+    ERROR("Invalid SIMD instruction set %s\n", name);
+  } else {
+    simd_isa_overridden = true;
+    ret                 = SRSLTE_SUCCESS;
+  }
+  pthread_mutex_unlock(&simd_isa_mutex);
+
+  return ret;
+}
+
+const char* srslte_simd_isa_string(srslte_simd_isa_t isa)
+{
+  if (isa < SIMD_ISA_NOF_NAMES) {
+    return simd_isa_names[isa];
+  }
+  return "unknown";
+}
+
+int srslte_simd_isa_info(char* str, uint32_t str_len)
+{
+  return snprintf(str,
+                  str_len,
+                  "SIMD kernels: %s (built up to %s, CPU supports %s)",
+                  srslte_simd_isa_string(srslte_simd_isa()),
+                  srslte_simd_isa_string(srslte_simd_isa_built()),
+                  srslte_simd_isa_string(srslte_simd_isa_cpu()));
+}
@@ -152,6 +152,76 @@ static bool test_mmse_solver_gen(void)
   return (error < MAXIMUM_ERROR);
 }
 
+/* Diagonally dominant channel of 4 layers and 4 receive antennas, so the solution does not depend on conditioning */
+static void random_4x4_channel(cf_t h[4][4])
+{
+  for (int r = 0; r < 4; r++) {
+    for (int l = 0; l < 4; l++) {
+      h[r][l] = (r == l ? 2.0f : 0.0f) + RANDOM_CF() * 0.5f;
+    }
+  }
+}
+
+static void random_4x4_signal(cf_t h[4][4], cf_t x_gold[4], cf_t y[4])
+{
+  random_4x4_channel(h);
+  for (int l = 0; l < 4; l++) {
+    x_gold[l] = RANDOM_CF();
+  }
+  for (int r = 0; r < 4; r++) {
+    y[r] = 0;
+    for (int l = 0; l < 4; l++) {
+      y[r] += h[r][l] * x_gold[l];
+    }
+  }
+}
+
+static bool test_mmse_solver_4x4_gen(void)
+{
+  cf_t  x_gold[4], h[4][4], y[4], x[4];
+  float csi[4];
+  float error = 0.0f;
+
+  random_4x4_signal(h, x_gold, y);
+
+  srslte_mat_4x4_mmse_csi_gen(y, h, 4, 4, x, csi, 0.0f, 1.0f);
+
+  for (int l = 0; l < 4; l++) {
+    cf_t cf_error = x[l] - x_gold[l];
+    error += crealf(cf_error) * crealf(cf_error) + cimagf(cf_error) * cimagf(cf_error);
+  }
+
+  return (error < MAXIMUM_ERROR);
+}
+
+/* With noise the solution is biased, check that it solves (H' x H + No) x X / norm = H' x Y */
+static bool test_mmse_solver_4x4_noise_gen(void)
+{
+  const float noise_estimate = 0.3f;
+  const float norm           = 1.5f;
+  cf_t        x_gold[4], h[4][4], y[4], x[4];
+  float       csi[4];
+  float       error = 0.0f;
+
+  random_4x4_signal(h, x_gold, y);
+
+  srslte_mat_4x4_mmse_csi_gen(y, h, 4, 4, x, csi, noise_estimate, norm);
+
+  for (int i = 0; i < 4; i++) {
+    cf_t cf_error = noise_estimate * x[i] / norm;
+    for (int r = 0; r < 4; r++) {
+      cf_t hx = 0;
+      for (int j = 0; j < 4; j++) {
+        hx += h[r][j] * x[j] / norm;
+      }
+      cf_error += conjf(h[r][i]) * (hx - y[r]);
+    }
+    error += crealf(cf_error) * crealf(cf_error) + cimagf(cf_error) * cimagf(cf_error);
+  }
+
+  return (error < MAXIMUM_ERROR);
+}
+
 #if SRSLTE_SIMD_CF_SIZE != 0
 
 static bool test_zf_solver_simd(void)
@@ -248,6 +318,71 @@ static bool test_mmse_solver_simd(void)
   return (error < MAXIMUM_ERROR);
 }
 
+/* Solves SRSLTE_SIMD_CF_SIZE random 4x4 systems with the SIMD kernel and compares every lane with the generic kernel */
+static bool mmse_solver_4x4_simd(float noise_estimate, float norm)
+{
+  cf_t  x_gold[SRSLTE_SIMD_CF_SIZE][4], h[SRSLTE_SIMD_CF_SIZE][4][4], y[SRSLTE_SIMD_CF_SIZE][4];
+  float error = 0.0f;
+
+  for (int i = 0; i < SRSLTE_SIMD_CF_SIZE; i++) {
+    random_4x4_signal(h[i], x_gold[i], y[i]);
+  }
+
+  simd_cf_t _y[4], _h[4][4], _x[4];
+  simd_f_t  _csi[4];
+  for (int r = 0; r < 4; r++) {
+    cf_t y_r[SRSLTE_SIMD_CF_SIZE];
+    for (int i = 0; i < SRSLTE_SIMD_CF_SIZE; i++) {
+      y_r[i] = y[i][r];
+    }
+    _y[r] = srslte_simd_cfi_loadu(y_r);
+    for (int l = 0; l < 4; l++) {
+      cf_t h_rl[SRSLTE_SIMD_CF_SIZE];
+      for (int i = 0; i < SRSLTE_SIMD_CF_SIZE; i++) {
+        h_rl[i] = h[i][r][l];
+      }
+      _h[r][l] = srslte_simd_cfi_loadu(h_rl);
+    }
+  }
+
+  srslte_mat_4x4_mmse_csi_simd(_y, _h, 4, 4, _x, _csi, noise_estimate, norm);
+
+  for (int l = 0; l < 4; l++) {
+    srslte_simd_aligned cf_t x[SRSLTE_SIMD_CF_SIZE];
+    srslte_simd_aligned float csi[SRSLTE_SIMD_F_SIZE];
+    srslte_simd_cfi_store(x, _x[l]);
+    srslte_simd_f_store(csi, _csi[l]);
+
+    for (int i = 0; i < SRSLTE_SIMD_CF_SIZE; i++) {
+      cf_t  x_gen[4];
+      float csi_gen[4];
+      srslte_mat_4x4_mmse_csi_gen(y[i], h[i], 4, 4, x_gen, csi_gen, noise_estimate, norm);
+
+      cf_t cf_error = x[i] - x_gen[l];
+      error += crealf(cf_error) * crealf(cf_error) + cimagf(cf_error) * cimagf(cf_error);
+      error += (csi[i] - csi_gen[l]) * (csi[i] - csi_gen[l]) / (csi_gen[l] * csi_gen[l]);
+
+      /* Without noise the solution is unbiased */
+      if (noise_estimate == 0.0f) {
+        cf_error = x[i] - x_gold[i][l] * norm;
+        error += crealf(cf_error) * crealf(cf_error) + cimagf(cf_error) * cimagf(cf_error);
+      }
+    }
+  }
+
+  return (error < MAXIMUM_ERROR);
+}
+
+static bool test_mmse_solver_4x4_simd(void)
+{
+  return mmse_solver_4x4_simd(0.0f, 1.0f);
+}
+
+static bool test_mmse_solver_4x4_noise_simd(void)
+{
+  return mmse_solver_4x4_simd(0.3f, 1.5f);
+}
+
 #endif /* SRSLTE_SIMD_CF_SIZE != 0 */
 
 static bool test_vec_dot_prod_ccc(void)
@@ -312,9 +447,13 @@ int main(int argc, char** argv)
 
   if (mmse_solver) {
     RUN_TEST(test_mmse_solver_gen);
+    RUN_TEST(test_mmse_solver_4x4_gen);
+    RUN_TEST(test_mmse_solver_4x4_noise_gen);
 
 #if SRSLTE_SIMD_CF_SIZE != 0
     RUN_TEST(test_mmse_solver_simd);
+    RUN_TEST(test_mmse_solver_4x4_simd);
+    RUN_TEST(test_mmse_solver_4x4_noise_simd);
 #endif /* SRSLTE_SIMD_CF_SIZE != 0*/
   }
 
@@ -27,6 +27,11 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef SRSLTE_SIMD_DISPATCH
+/* Built once per instruction set, the functions get its suffix */
+#include "vector_simd_dispatch.h"
+#endif /* SRSLTE_SIMD_DISPATCH */
+
 #include "srslte/phy/utils/simd.h"
 #include "srslte/phy/utils/vector_simd.h"
 
@@ -0,0 +1,159 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <pthread.h>
+
+#include "srslte/phy/utils/simd_dispatch.h"
+#include "srslte/phy/utils/vector_simd.h"
+
+#ifdef SRSLTE_SIMD_DISPATCH
+
+/* Functions of vector_simd.h as F(return type, name, parameters, arguments), or V(name, parameters, arguments) if they
+ * do not return anything */
+#define VEC_SIMD_FUNCTIONS(F, V)                                                                                       \
+  V(srslte_vec_xor_bbb_simd, (const int8_t* x, const int8_t* y, int8_t* z, int len), (x, y, z, len))                   \
+  V(srslte_vec_sum_sss_simd, (const int16_t* x, const int16_t* y, int16_t* z, int len), (x, y, z, len))                \
+  V(srslte_vec_sub_sss_simd, (const int16_t* x, const int16_t* y, int16_t* z, int len), (x, y, z, len))                \
+  V(srslte_vec_sub_bbb_simd, (const int8_t* x, const int8_t* y, int8_t* z, int len), (x, y, z, len))                   \
+  F(float, srslte_vec_acc_ff_simd, (const float* x, int len), (x, len))                                                \
+  F(cf_t, srslte_vec_acc_cc_simd, (const cf_t* x, int len), (x, len))                                                  \
+  V(srslte_vec_add_fff_simd, (const float* x, const float* y, float* z, int len), (x, y, z, len))                      \
+  V(srslte_vec_sub_fff_simd, (const float* x, const float* y, float* z, int len), (x, y, z, len))                      \
+  V(srslte_vec_sc_prod_cfc_simd, (const cf_t* x, const float h, cf_t* y, const int len), (x, h, y, len))               \
+  V(srslte_vec_sc_prod_fff_simd, (const float* x, const float h, float* z, const int len), (x, h, z, len))             \
+  V(srslte_vec_sc_prod_ccc_simd, (const cf_t* x, const cf_t h, cf_t* z, const int len), (x, h, z, len))                \
+  F(int, srslte_vec_sc_prod_ccc_simd2, (const cf_t* x, const cf_t h, cf_t* z, const int len), (x, h, z, len))          \
+  V(srslte_vec_prod_ccc_split_simd,                                                                                    \
+    (const float* a_re, const float* a_im, const float* b_re, const float* b_im,                                       \
+     float* r_re, float* r_im, const int len),                                                                         \
+    (a_re, a_im, b_re, b_im, r_re, r_im, len))                                                                         \
+  V(srslte_vec_prod_sss_simd, (const int16_t* x, const int16_t* y, int16_t* z, const int len), (x, y, z, len))         \
+  V(srslte_vec_neg_sss_simd, (const int16_t* x, const int16_t* y, int16_t* z, const int len), (x, y, z, len))          \
+  V(srslte_vec_neg_bbb_simd, (const int8_t* x, const int8_t* y, int8_t* z, const int len), (x, y, z, len))             \
+  V(srslte_vec_prod_cfc_simd, (const cf_t* x, const float* y, cf_t* z, const int len), (x, y, z, len))                 \
+  V(srslte_vec_prod_fff_simd, (const float* x, const float* y, float* z, const int len), (x, y, z, len))               \
+  V(srslte_vec_prod_ccc_simd, (const cf_t* x, const cf_t* y, cf_t* z, const int len), (x, y, z, len))                  \
+  V(srslte_vec_prod_conj_ccc_simd, (const cf_t* x, const cf_t* y, cf_t* z, const int len), (x, y, z, len))             \
+  V(srslte_vec_div_ccc_simd, (const cf_t* x, const cf_t* y, cf_t* z, const int len), (x, y, z, len))                   \
+  V(srslte_vec_div_cfc_simd, (const cf_t* x, const float* y, cf_t* z, const int len), (x, y, z, len))                  \
+  V(srslte_vec_div_fff_simd, (const float* x, const float* y, float* z, const int len), (x, y, z, len))                \
+  F(cf_t, srslte_vec_dot_prod_conj_ccc_simd, (const cf_t* x, const cf_t* y, const int len), (x, y, len))               \
+  F(cf_t, srslte_vec_dot_prod_ccc_simd, (const cf_t* x, const cf_t* y, const int len), (x, y, len))                    \
+  F(int, srslte_vec_dot_prod_sss_simd, (const int16_t* x, const int16_t* y, const int len), (x, y, len))               \
+  V(srslte_vec_abs_cf_simd, (const cf_t* x, float* z, const int len), (x, z, len))                                     \
+  V(srslte_vec_abs_square_cf_simd, (const cf_t* x, float* z, const int len), (x, z, len))                              \
+  V(srslte_vec_lut_sss_simd, (const short* x, const unsigned short* lut, short* y, const int len), (x, lut, y, len))   \
+  V(srslte_vec_lut_bbb_simd, (const int8_t* x, const unsigned short* lut, int8_t* y, const int len), (x, lut, y, len)) \
+  V(srslte_vec_convert_if_simd, (const int16_t* x, float* z, const float scale, const int len), (x, z, scale, len))    \
+  V(srslte_vec_convert_fi_simd, (const float* x, int16_t* z, const float scale, const int len), (x, z, scale, len))    \
+  V(srslte_vec_convert_fb_simd, (const float* x, int8_t* z, const float scale, const int len), (x, z, scale, len))     \
+  V(srslte_vec_interleave_simd, (const cf_t* x, const cf_t* y, cf_t* z, const int len), (x, y, z, len))                \
+  V(srslte_vec_interleave_add_simd, (const cf_t* x, const cf_t* y, cf_t* z, const int len), (x, y, z, len))            \
+  V(srslte_vec_gen_sine_simd, (cf_t amplitude, float freq, cf_t* z, int len), (amplitude, freq, z, len))               \
+  V(srslte_vec_apply_cfo_simd, (const cf_t* x, float cfo, cf_t* z, int len), (x, cfo, z, len))                         \
+  F(float, srslte_vec_estimate_frequency_simd, (const cf_t* x, int len), (x, len))                                     \
+  F(uint32_t, srslte_vec_max_fi_simd, (const float* x, const int len), (x, len))                                       \
+  F(uint32_t, srslte_vec_max_abs_fi_simd, (const float* x, const int len), (x, len))                                   \
+  F(uint32_t, srslte_vec_max_ci_simd, (const cf_t* x, const int len), (x, len))
+
+#ifdef ENABLE_C16
+#define VEC_SIMD_FUNCTIONS_C16(F, V)                                                                                   \
+  V(srslte_vec_prod_ccc_c16_simd,                                                                                      \
+    (const int16_t* a_re, const int16_t* a_im, const int16_t* b_re, const int16_t* b_im,                               \
+     int16_t* r_re, int16_t* r_im, const int len),                                                                     \
+    (a_re, a_im, b_re, b_im, r_re, r_im, len))                                                                         \
+  F(c16_t, srslte_vec_dot_prod_ccc_c16i_simd, (const c16_t* x, const c16_t* y, const int len), (x, y, len))
+#else /* ENABLE_C16 */
+#define VEC_SIMD_FUNCTIONS_C16(F, V)
+#endif /* ENABLE_C16 */
+
+#define VEC_SIMD_FOREACH(F, V)                                                                                         \
+  VEC_SIMD_FUNCTIONS(F, V)                                                                                             \
+  VEC_SIMD_FUNCTIONS_C16(F, V)
+
+/* Functions built for every instruction set, with its suffix */
+#define VEC_SIMD_PROTOTYPE_F(RET, NAME, PARAMS, ARGS) RET CONCAT2(NAME, VEC_SIMD_SUFFIX) PARAMS;
+#define VEC_SIMD_PROTOTYPE_V(NAME, PARAMS, ARGS) void CONCAT2(NAME, VEC_SIMD_SUFFIX) PARAMS;
+
+/* Table of the functions of an instruction set */
+#define VEC_SIMD_MEMBER_F(RET, NAME, PARAMS, ARGS) RET(*NAME) PARAMS;
+#define VEC_SIMD_MEMBER_V(NAME, PARAMS, ARGS) void(*NAME) PARAMS;
+#define VEC_SIMD_ENTRY_F(RET, NAME, PARAMS, ARGS) .NAME = CONCAT2(NAME, VEC_SIMD_SUFFIX),
+#define VEC_SIMD_ENTRY_V(NAME, PARAMS, ARGS) .NAME = CONCAT2(NAME, VEC_SIMD_SUFFIX),
+
+typedef struct {
+  VEC_SIMD_FOREACH(VEC_SIMD_MEMBER_F, VEC_SIMD_MEMBER_V)
+} vec_simd_table_t;
+
+#define VEC_SIMD_SUFFIX _sse
+VEC_SIMD_FOREACH(VEC_SIMD_PROTOTYPE_F, VEC_SIMD_PROTOTYPE_V)
+static const vec_simd_table_t vec_simd_sse = {VEC_SIMD_FOREACH(VEC_SIMD_ENTRY_F, VEC_SIMD_ENTRY_V)};
+#undef VEC_SIMD_SUFFIX
+
+#ifdef SRSLTE_SIMD_DISPATCH_AVX2
+#define VEC_SIMD_SUFFIX _avx2
+VEC_SIMD_FOREACH(VEC_SIMD_PROTOTYPE_F, VEC_SIMD_PROTOTYPE_V)
+static const vec_simd_table_t vec_simd_avx2 = {VEC_SIMD_FOREACH(VEC_SIMD_ENTRY_F, VEC_SIMD_ENTRY_V)};
+#undef VEC_SIMD_SUFFIX
+#endif /* SRSLTE_SIMD_DISPATCH_AVX2 */
+
+#ifdef SRSLTE_SIMD_DISPATCH_AVX512
+#define VEC_SIMD_SUFFIX _avx512
+VEC_SIMD_FOREACH(VEC_SIMD_PROTOTYPE_F, VEC_SIMD_PROTOTYPE_V)
+static const vec_simd_table_t vec_simd_avx512 = {VEC_SIMD_FOREACH(VEC_SIMD_ENTRY_F, VEC_SIMD_ENTRY_V)};
+#undef VEC_SIMD_SUFFIX
+#endif /* SRSLTE_SIMD_DISPATCH_AVX512 */
+
+static pthread_once_t          vec_simd_once = PTHREAD_ONCE_INIT;
+static const vec_simd_table_t* vec_simd      = &vec_simd_sse;
+
+static void vec_simd_select()
+{
+#ifdef SRSLTE_SIMD_DISPATCH_AVX512
+  if (srslte_simd_isa() >= SRSLTE_SIMD_ISA_AVX512) {
+    vec_simd = &vec_simd_avx512;
+    return;
+  }
+#endif /* SRSLTE_SIMD_DISPATCH_AVX512 */
+#ifdef SRSLTE_SIMD_DISPATCH_AVX2
+  if (srslte_simd_isa() >= SRSLTE_SIMD_ISA_AVX2) {
+    vec_simd = &vec_simd_avx2;
+    return;
+  }
+#endif /* SRSLTE_SIMD_DISPATCH_AVX2 */
+  vec_simd = &vec_simd_sse;
+}
+
+static inline const vec_simd_table_t* vec_simd_table()
+{
+  pthread_once(&vec_simd_once, vec_simd_select);
+  return vec_simd;
+}
+
+/* Functions of vector_simd.h, calling those of the instruction set selected at runtime */
+#define VEC_SIMD_DISPATCH_F(RET, NAME, PARAMS, ARGS)                                                                   \
+  RET NAME PARAMS { return vec_simd_table()->NAME ARGS; }
+#define VEC_SIMD_DISPATCH_V(NAME, PARAMS, ARGS)                                                                        \
+  void NAME PARAMS { vec_simd_table()->NAME ARGS; }
+
+VEC_SIMD_FOREACH(VEC_SIMD_DISPATCH_F, VEC_SIMD_DISPATCH_V)
+
+#endif /* SRSLTE_SIMD_DISPATCH */
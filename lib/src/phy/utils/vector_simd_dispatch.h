@@ -0,0 +1,85 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/* Private header of vector_simd.c. With ENABLE_SIMD_DISPATCH that file is built once per instruction set and every
+ * function gets the suffix of the instruction set it is built for. vector_simd_dispatch.c implements the functions
+ * of vector_simd.h, calling those of the instruction set selected at runtime */
+
+#ifndef SRSLTE_VECTOR_SIMD_DISPATCH_H
+#define SRSLTE_VECTOR_SIMD_DISPATCH_H
+
+#include "srslte/config.h"
+
+#if defined(LV_HAVE_AVX512)
+#define VEC_SIMD_SUFFIX _avx512
+#elif defined(LV_HAVE_AVX2)
+#define VEC_SIMD_SUFFIX _avx2
+#else
+#define VEC_SIMD_SUFFIX _sse
+#endif
+
+#define VEC_SIMD_NAME(NAME) CONCAT2(NAME, VEC_SIMD_SUFFIX)
+
+#define srslte_vec_xor_bbb_simd VEC_SIMD_NAME(srslte_vec_xor_bbb_simd)
+#define srslte_vec_sum_sss_simd VEC_SIMD_NAME(srslte_vec_sum_sss_simd)
+#define srslte_vec_sub_sss_simd VEC_SIMD_NAME(srslte_vec_sub_sss_simd)
+#define srslte_vec_sub_bbb_simd VEC_SIMD_NAME(srslte_vec_sub_bbb_simd)
+#define srslte_vec_acc_ff_simd VEC_SIMD_NAME(srslte_vec_acc_ff_simd)
+#define srslte_vec_acc_cc_simd VEC_SIMD_NAME(srslte_vec_acc_cc_simd)
+#define srslte_vec_add_fff_simd VEC_SIMD_NAME(srslte_vec_add_fff_simd)
+#define srslte_vec_sub_fff_simd VEC_SIMD_NAME(srslte_vec_sub_fff_simd)
+#define srslte_vec_sc_prod_cfc_simd VEC_SIMD_NAME(srslte_vec_sc_prod_cfc_simd)
+#define srslte_vec_sc_prod_fff_simd VEC_SIMD_NAME(srslte_vec_sc_prod_fff_simd)
+#define srslte_vec_sc_prod_ccc_simd VEC_SIMD_NAME(srslte_vec_sc_prod_ccc_simd)
+#define srslte_vec_sc_prod_ccc_simd2 VEC_SIMD_NAME(srslte_vec_sc_prod_ccc_simd2)
+#define srslte_vec_prod_ccc_split_simd VEC_SIMD_NAME(srslte_vec_prod_ccc_split_simd)
+#define srslte_vec_prod_ccc_c16_simd VEC_SIMD_NAME(srslte_vec_prod_ccc_c16_simd)
+#define srslte_vec_prod_sss_simd VEC_SIMD_NAME(srslte_vec_prod_sss_simd)
+#define srslte_vec_neg_sss_simd VEC_SIMD_NAME(srslte_vec_neg_sss_simd)
+#define srslte_vec_neg_bbb_simd VEC_SIMD_NAME(srslte_vec_neg_bbb_simd)
+#define srslte_vec_prod_cfc_simd VEC_SIMD_NAME(srslte_vec_prod_cfc_simd)
+#define srslte_vec_prod_fff_simd VEC_SIMD_NAME(srslte_vec_prod_fff_simd)
+#define srslte_vec_prod_ccc_simd VEC_SIMD_NAME(srslte_vec_prod_ccc_simd)
+#define srslte_vec_prod_conj_ccc_simd VEC_SIMD_NAME(srslte_vec_prod_conj_ccc_simd)
+#define srslte_vec_div_ccc_simd VEC_SIMD_NAME(srslte_vec_div_ccc_simd)
+#define srslte_vec_div_cfc_simd VEC_SIMD_NAME(srslte_vec_div_cfc_simd)
+#define srslte_vec_div_fff_simd VEC_SIMD_NAME(srslte_vec_div_fff_simd)
+#define srslte_vec_dot_prod_conj_ccc_simd VEC_SIMD_NAME(srslte_vec_dot_prod_conj_ccc_simd)
+#define srslte_vec_dot_prod_ccc_simd VEC_SIMD_NAME(srslte_vec_dot_prod_ccc_simd)
+#define srslte_vec_dot_prod_ccc_c16i_simd VEC_SIMD_NAME(srslte_vec_dot_prod_ccc_c16i_simd)
+#define srslte_vec_dot_prod_sss_simd VEC_SIMD_NAME(srslte_vec_dot_prod_sss_simd)
+#define srslte_vec_abs_cf_simd VEC_SIMD_NAME(srslte_vec_abs_cf_simd)
+#define srslte_vec_abs_square_cf_simd VEC_SIMD_NAME(srslte_vec_abs_square_cf_simd)
+#define srslte_vec_lut_sss_simd VEC_SIMD_NAME(srslte_vec_lut_sss_simd)
+#define srslte_vec_lut_bbb_simd VEC_SIMD_NAME(srslte_vec_lut_bbb_simd)
+#define srslte_vec_convert_if_simd VEC_SIMD_NAME(srslte_vec_convert_if_simd)
+#define srslte_vec_convert_fi_simd VEC_SIMD_NAME(srslte_vec_convert_fi_simd)
+#define srslte_vec_convert_fb_simd VEC_SIMD_NAME(srslte_vec_convert_fb_simd)
+#define srslte_vec_interleave_simd VEC_SIMD_NAME(srslte_vec_interleave_simd)
+#define srslte_vec_interleave_add_simd VEC_SIMD_NAME(srslte_vec_interleave_add_simd)
+#define srslte_vec_gen_sine_simd VEC_SIMD_NAME(srslte_vec_gen_sine_simd)
+#define srslte_vec_apply_cfo_simd VEC_SIMD_NAME(srslte_vec_apply_cfo_simd)
+#define srslte_vec_estimate_frequency_simd VEC_SIMD_NAME(srslte_vec_estimate_frequency_simd)
+#define srslte_vec_max_fi_simd VEC_SIMD_NAME(srslte_vec_max_fi_simd)
+#define srslte_vec_max_abs_fi_simd VEC_SIMD_NAME(srslte_vec_max_abs_fi_simd)
+#define srslte_vec_max_ci_simd VEC_SIMD_NAME(srslte_vec_max_ci_simd)
+
+#endif // SRSLTE_VECTOR_SIMD_DISPATCH_H
@@ -0,0 +1,198 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "srslte/srslte.h"
+
+#define MAX_CARRIERS 8
+#define MAX_WORKERS 8
+
+srslte_cell_t cell = {.nof_prb         = 100,
+                      .nof_ports       = 2,
+                      .id              = 1,
+                      .cp              = SRSLTE_CP_NORM,
+                      .phich_resources = SRSLTE_PHICH_R_1,
+                      .phich_length    = SRSLTE_PHICH_NORM};
+
+static uint32_t nof_carriers = 1;
+static uint32_t nof_workers  = 3;
+
+void usage(char* prog)
+{
+  printf("Usage: %s [cpwv]\n", prog);
+  printf("\t-c number of carriers [Default %d]\n", nof_carriers);
+  printf("\t-p cell.nof_prb [Default %d]\n", cell.nof_prb);
+  printf("\t-w number of workers per carrier [Default %d]\n", nof_workers);
+  printf("\t-v [set srslte_verbose to debug, default none]\n");
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "cpwv")) != -1) {
+    switch (opt) {
+      case 'c':
+        nof_carriers = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'p':
+        cell.nof_prb = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'w':
+        nof_workers = (uint32_t)strtol(argv[optind], NULL, 10);
+        break;
+      case 'v':
+        srslte_verbose++;
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+
+  if (nof_carriers == 0 || nof_carriers > MAX_CARRIERS || nof_workers == 0 || nof_workers > MAX_WORKERS) {
+    usage(argv[0]);
+    exit(-1);
+  }
+}
+
+typedef struct {
+  srslte_enb_dl_t enb_dl;
+  srslte_enb_ul_t enb_ul;
+  cf_t*           signal_buffer_tx[SRSLTE_MAX_PORTS];
+  cf_t*           signal_buffer_rx;
+} worker_t;
+
+static worker_t workers[MAX_CARRIERS][MAX_WORKERS] = {};
+
+/* Initialises the PHY of all the workers of a carrier, as the eNb does at startup */
+static int carrier_init(worker_t* w, srslte_cell_t carrier_cell)
+{
+  srslte_refsignal_dmrs_pusch_cfg_t dmrs_pusch_cfg = {};
+  uint32_t                          sf_len         = SRSLTE_SF_LEN_PRB(carrier_cell.nof_prb);
+
+  for (uint32_t i = 0; i < nof_workers; i++) {
+    for (uint32_t p = 0; p < carrier_cell.nof_ports; p++) {
+      w[i].signal_buffer_tx[p] = srslte_vec_cf_malloc(sf_len);
+      if (!w[i].signal_buffer_tx[p]) {
+        ERROR("Error allocating buffer\n");
+        return SRSLTE_ERROR;
+      }
+    }
+    w[i].signal_buffer_rx = srslte_vec_cf_malloc(sf_len);
+    if (!w[i].signal_buffer_rx) {
+      ERROR("Error allocating buffer\n");
+      return SRSLTE_ERROR;
+    }
+
+    if (srslte_enb_dl_init(&w[i].enb_dl, w[i].signal_buffer_tx, carrier_cell.nof_prb)) {
+      ERROR("Error initiating eNb downlink\n");
+      return SRSLTE_ERROR;
+    }
+    if (srslte_enb_dl_set_cell(&w[i].enb_dl, carrier_cell)) {
+      ERROR("Error setting eNb DL cell\n");
+      return SRSLTE_ERROR;
+    }
+    if (srslte_enb_ul_init(&w[i].enb_ul, w[i].signal_buffer_rx, carrier_cell.nof_prb)) {
+      ERROR("Error initiating eNb uplink\n");
+      return SRSLTE_ERROR;
+    }
+    if (srslte_enb_ul_set_cell(&w[i].enb_ul, carrier_cell, &dmrs_pusch_cfg)) {
+      ERROR("Error setting eNb UL cell\n");
+      return SRSLTE_ERROR;
+    }
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
+static void carrier_free(worker_t* w)
+{
+  for (uint32_t i = 0; i < nof_workers; i++) {
+    srslte_enb_dl_free(&w[i].enb_dl);
+    srslte_enb_ul_free(&w[i].enb_ul);
+    for (uint32_t p = 0; p < SRSLTE_MAX_PORTS; p++) {
+      if (w[i].signal_buffer_tx[p]) {
+        free(w[i].signal_buffer_tx[p]);
+      }
+    }
+    if (w[i].signal_buffer_rx) {
+      free(w[i].signal_buffer_rx);
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  struct timeval t[3];
+  int            ret = SRSLTE_ERROR;
+
+  parse_args(argc, argv);
+
+  uint32_t nof_plans_carrier = 0;
+  for (uint32_t cc = 0; cc < nof_carriers; cc++) {
+    srslte_cell_t carrier_cell = cell;
+    carrier_cell.id            = (cell.id + cc) % SRSLTE_NUM_PCI;
+
+    gettimeofday(&t[1], NULL);
+    if (carrier_init(workers[cc], carrier_cell)) {
+      goto quit;
+    }
+    gettimeofday(&t[2], NULL);
+    get_time_interval(t);
+
+    if (cc == 0) {
+      nof_plans_carrier = srslte_dft_nof_shared_plans();
+    }
+
+    printf("Carrier %d: %d workers initialised in %.1f ms, %d shared DFT plans\n",
+           cc,
+           nof_workers,
+           t[0].tv_sec * 1e3 + t[0].tv_usec * 1e-3,
+           srslte_dft_nof_shared_plans());
+  }
+
+  // All the carriers have the same bandwidth, so the additional ones must not create any plan
+  if (srslte_dft_nof_shared_plans() != nof_plans_carrier) {
+    ERROR("Additional carriers created %d DFT plans\n", srslte_dft_nof_shared_plans() - nof_plans_carrier);
+    goto quit;
+  }
+
+  ret = SRSLTE_SUCCESS;
+
+quit:
+  for (uint32_t cc = 0; cc < nof_carriers; cc++) {
+    carrier_free(workers[cc]);
+  }
+
+  // The plans are destroyed with the last object that uses them
+  if (srslte_dft_nof_shared_plans() != 0) {
+    ERROR("%d DFT plans were not released\n", srslte_dft_nof_shared_plans());
+    ret = SRSLTE_ERROR;
+  }
+
+  printf("%s\n", ret ? "Failed" : "Ok");
+
+  return ret;
+}
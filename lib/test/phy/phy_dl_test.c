@@ -259,7 +259,8 @@ check_softbits(srslte_enb_dl_t* enb_dl, srslte_ue_dl_t* ue_dl, srslte_ue_dl_cfg_
   int ret = SRSLTE_SUCCESS;
 
   // Generate sequence
-  srslte_sequence_pdsch(&ue_dl->pdsch.tmp_seq,
+  srslte_sequence_t seq = {};
+  srslte_sequence_pdsch(&seq,
                         rnti,
                         ue_dl_cfg->cfg.pdsch.grant.tb[tb].cw_idx,
                         2 * (sf_idx % 10),
@@ -268,12 +269,11 @@ check_softbits(srslte_enb_dl_t* enb_dl, srslte_ue_dl_t* ue_dl, srslte_ue_dl_cfg_
 
   // Scramble
   if (ue_dl->pdsch.llr_is_8bit) {
-    srslte_scrambling_sb_offset(
-        &ue_dl->pdsch.tmp_seq, ue_dl->pdsch.e[tb], 0, ue_dl_cfg->cfg.pdsch.grant.tb[tb].nof_bits);
+    srslte_scrambling_sb_offset(&seq, ue_dl->pdsch.e[tb], 0, ue_dl_cfg->cfg.pdsch.grant.tb[tb].nof_bits);
   } else {
-    srslte_scrambling_s_offset(
-        &ue_dl->pdsch.tmp_seq, ue_dl->pdsch.e[tb], 0, ue_dl_cfg->cfg.pdsch.grant.tb[tb].nof_bits);
+    srslte_scrambling_s_offset(&seq, ue_dl->pdsch.e[tb], 0, ue_dl_cfg->cfg.pdsch.grant.tb[tb].nof_bits);
   }
+  srslte_sequence_free(&seq);
   int16_t* rx       = ue_dl->pdsch.e[tb];
   uint8_t* rx_bytes = ue_dl->pdsch.e[tb];
   for (int i = 0, k = 0; i < ue_dl_cfg->cfg.pdsch.grant.tb[tb].nof_bits / 8; i++) {
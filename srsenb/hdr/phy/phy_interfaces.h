@@ -38,6 +38,7 @@ struct phy_cell_cfg_t {
   double        ul_freq_hz;
   uint32_t      root_seq_idx;
   uint32_t      num_ra_preambles;
+  uint32_t      rar_window;
 };
 
 typedef std::vector<phy_cell_cfg_t> phy_cell_cfg_list_t;
@@ -48,10 +49,14 @@ struct phy_args_t {
 
   float       max_prach_offset_us = 10;
   int         pusch_max_its       = 10;
+  uint32_t    pusch_adaptive_its  = 0;
   bool        pusch_8bit_decoder  = false;
   float       tx_amplitude        = 1.0f;
   int         nof_phy_threads     = 1;
+  int         nof_prach_threads   = 1;
+  uint32_t    nof_cb_workers      = 0;
   std::string equalizer_mode      = "mmse";
+  std::string simd_isa            = "auto";
   float       estimator_fil_w     = 1.0f;
   bool        pusch_meas_epre     = true;
   bool        pusch_meas_evm      = false;
@@ -40,9 +40,19 @@ struct dl_metrics_t {
   int   n_samples;
 };
 
+// PRACH detection metrics of all the carriers
+
+struct prach_metrics_t {
+  uint32_t nof_opportunities; // Opportunities handed over to the detection threads
+  float    queue_depth;       // Average number of opportunities being detected or waiting to be reported
+  uint32_t max_queue_depth;
+  uint32_t deadline_misses; // Opportunities dropped or reported too late for a RAR in the window
+};
+
 struct phy_metrics_t {
-  dl_metrics_t dl;
-  ul_metrics_t ul;
+  dl_metrics_t    dl;
+  ul_metrics_t    ul;
+  prach_metrics_t prach; // The same for all the users
 };
 
 } // namespace srsenb
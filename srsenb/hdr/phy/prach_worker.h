@@ -19,121 +19,152 @@
  *
  */
 
+
 #ifndef SRSENB_PRACH_WORKER_H
 #define SRSENB_PRACH_WORKER_H
 
+#include "srsenb/hdr/phy/phy_metrics.h"
 #include "srslte/common/block_queue.h"
 #include "srslte/common/buffer_pool.h"
 #include "srslte/common/log.h"
 #include "srslte/common/threads.h"
 #include "srslte/interfaces/enb_interfaces.h"
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
 
 namespace srsenb {
 
-class prach_worker : srslte::thread
+class prach_worker_pool;
+
+/* Samples of a PRACH opportunity that the detector uses and the preambles detected in them */
+class prach_job
 {
 public:
-  prach_worker(uint32_t cc_idx_) : buffer_pool(8), thread("PRACH_WORKER") { cc_idx = cc_idx_; }
-
-  int  init(const srslte_cell_t&      cell_,
-            const srslte_prach_cfg_t& prach_cfg_,
-            stack_interface_phy_lte*  mac,
-            srslte::log*              log_h,
-            int                       priority);
-  int  new_tti(uint32_t tti, cf_t* buffer);
-  void set_max_prach_offset_us(float delay_us);
-  void stop();
-
-private:
-  uint32_t cc_idx             = 0;
-  uint32_t prach_nof_det      = 0;
-  uint32_t prach_indices[165] = {};
-  float    prach_offsets[165] = {};
-  float    prach_p2avg[165]   = {};
-
-  srslte_cell_t      cell      = {};
-  srslte_prach_cfg_t prach_cfg = {};
-  srslte_prach_t     prach     = {};
-
-  const static int sf_buffer_sz = 128 * 1024;
-  class sf_buffer
+  prach_job() = default;
+  void reset()
   {
-  public:
-    sf_buffer() = default;
-    void reset()
-    {
-      nof_samples = 0;
-      tti         = 0;
-    }
-    cf_t     samples[sf_buffer_sz] = {};
-    uint32_t nof_samples           = 0;
-    uint32_t tti                   = 0;
+    nof_samples = 0;
+    tti         = 0;
+    cc_idx      = 0;
+    nof_det     = 0;
+    done        = false;
+  }
+
+  // The detector only reads one PRACH FFT, 24576 samples at most
+  const static int max_samples = 32 * 1024;
+  const static int max_det     = 165;
+
+  cf_t     samples[max_samples] = {};
+  uint32_t nof_samples          = 0;
+  uint32_t tti                  = 0;
+  uint32_t cc_idx               = 0;
+  uint32_t nof_det              = 0;
+  uint32_t indices[max_det]     = {};
+  float    offsets[max_det]     = {};
+  float    p2avg[max_det]       = {};
+  bool     done                 = false;
 #ifdef SRSLTE_BUFFER_POOL_LOG_ENABLED
-    char debug_name[SRSLTE_BUFFER_POOL_LOG_NAME_LEN];
+  char debug_name[SRSLTE_BUFFER_POOL_LOG_NAME_LEN];
 #endif /* SRSLTE_BUFFER_POOL_LOG_ENABLED */
+};
+
+/* PRACH detection thread of the pool. It has a PRACH object for every carrier, so it detects the preambles of any of
+ * them and the opportunities of several carriers, or consecutive ones of the same carrier, are detected in parallel */
+class prach_worker : public srslte::thread
+{
+public:
+  prach_worker(uint32_t id, prach_worker_pool* pool_, srslte::log* log_h_) :
+    thread("PRACH_WORKER" + std::to_string(id)),
+    pool(pool_),
+    log_h(log_h_)
+  {
+  }
+  ~prach_worker();
+
+  int add_carrier(const srslte_cell_t& cell, const srslte_prach_cfg_t& prach_cfg);
+
+private:
+  struct prach_detector {
+    srslte_prach_t prach       = {};
+    uint32_t       freq_offset = 0;
   };
-  srslte::buffer_pool<sf_buffer>  buffer_pool;
-  srslte::block_queue<sf_buffer*> pending_buffers;
 
-  sf_buffer*               current_buffer      = nullptr;
-  srslte::log*             log_h               = nullptr;
-  stack_interface_phy_lte* stack               = nullptr;
-  float                    max_prach_offset_us = 0.0f;
-  bool                     initiated           = false;
-  bool                     running             = false;
-  uint32_t                 nof_sf              = 0;
-  uint32_t                 sf_cnt              = 0;
+  prach_worker_pool*                            pool  = nullptr;
+  srslte::log*                                  log_h = nullptr;
+  std::vector<std::unique_ptr<prach_detector> > detectors;
 
   void run_thread() final;
-  int  run_tti(sf_buffer* b);
+  void detect(prach_job* job);
 };
 
+/* PRACH detection shared by all the carriers. The opportunities are handed over to a pool of detection threads and
+ * their preambles are reported to the stack in the order they were received */
 class prach_worker_pool
 {
-private:
-  std::vector<std::unique_ptr<prach_worker> > prach_vec;
-
 public:
   prach_worker_pool()  = default;
   ~prach_worker_pool() = default;
 
-  void init(uint32_t                  cc_idx,
+  int  init(uint32_t                  cc_idx,
             const srslte_cell_t&      cell_,
             const srslte_prach_cfg_t& prach_cfg_,
-            stack_interface_phy_lte*  mac,
-            srslte::log*              log_h,
-            int                       priority)
-  {
-    // Create PRACH worker if required
-    while (cc_idx >= prach_vec.size()) {
-      prach_vec.push_back(std::unique_ptr<prach_worker>(new prach_worker(prach_vec.size())));
-    }
+            uint32_t                  rar_window,
+            stack_interface_phy_lte*  stack_,
+            srslte::log*              log_h_);
+  int  start(uint32_t nof_workers, int priority);
+  void set_max_prach_offset_us(float delay_us);
+  void stop();
+  int  new_tti(uint32_t cc_idx, uint32_t tti, cf_t* buffer);
+  void get_metrics(prach_metrics_t* metrics);
 
-    prach_vec[cc_idx]->init(cell_, prach_cfg_, mac, log_h, priority);
-  }
+  // Interface of the detection threads
+  prach_job* wait_job();
+  void       job_done(prach_job* job);
 
-  void set_max_prach_offset_us(float delay_us)
+private:
+  /* Copies the samples that the detector uses from the subframes of the PRACH opportunities of a carrier */
+  class prach_carrier
   {
-    for (auto& prach : prach_vec) {
-      prach->set_max_prach_offset_us(delay_us);
-    }
-  }
+  public:
+    srslte_cell_t      cell       = {};
+    srslte_prach_cfg_t prach_cfg  = {};
+    uint32_t           rar_window = 0;
+    uint32_t           nof_sf     = 0; // Subframes of an opportunity
+    uint32_t           offset     = 0; // First sample that the detector uses, after the cyclic prefix
+    uint32_t           len        = 0; // Number of samples that the detector uses
+    uint32_t           sf_cnt     = 0;
+    prach_job*         job        = nullptr;
+
+    bool tti_opportunity(uint32_t tti);
+  };
 
-  void stop()
-  {
-    for (auto& prach : prach_vec) {
-      prach->stop();
-    }
-  }
+  // Opportunities that can be waiting for detection for every carrier
+  const static int nof_jobs_carrier = 8;
 
-  int new_tti(uint32_t cc_idx, uint32_t tti, cf_t* buffer)
-  {
-    int ret = SRSLTE_ERROR;
-    if (cc_idx < prach_vec.size()) {
-      ret = prach_vec[cc_idx]->new_tti(tti, buffer);
-    }
-    return ret;
-  }
+  std::vector<prach_carrier>                       carriers;
+  std::vector<std::unique_ptr<prach_worker> >      workers;
+  std::unique_ptr<srslte::buffer_pool<prach_job> > job_pool;
+  srslte::block_queue<prach_job*>                  pending_jobs;
+
+  // Opportunities handed over and not reported yet, in reception order
+  std::mutex             mutex;
+  std::deque<prach_job*> jobs;
+  prach_metrics_t        metrics   = {};
+  bool                   reporting = false; // A detection thread is reporting the finished opportunities
+
+  // Finished opportunities that the reporting thread takes out of jobs to report them without the mutex
+  std::vector<prach_job*> report_jobs;
+
+  std::atomic<uint32_t>    last_tti            = {0};
+  srslte::log*             log_h               = nullptr;
+  stack_interface_phy_lte* stack               = nullptr;
+  float                    max_prach_offset_us = 50.0f;
+  std::atomic<bool>        running             = {false};
+
+  bool job_report(prach_job* job);
 };
 } // namespace srsenb
 #endif // SRSENB_PRACH_WORKER_H
@@ -81,6 +81,7 @@ public:
   /* Provides cell configuration including SIB periodicity, etc. */
   int  cell_cfg(const std::vector<sched_interface::cell_cfg_t>& cell_cfg) override;
   void reset() override;
+  int  set_sib_len(uint32_t enb_cc_idx, uint32_t sib_idx, uint32_t len) override;
 
   /* Manages UE scheduling context */
   int ue_cfg(uint16_t rnti, sched_interface::ue_cfg_t* cfg) override;
@@ -160,6 +161,9 @@ private:
 
   std::vector<common_buffers_t> common_buffers;
 
+  // Rx code block buffers shared by all the UEs, only used if enabled in the arguments
+  srslte_softbuffer_pool_t rx_softbuffer_pool = {};
+
   const static int           mcch_payload_len                      = 3000; // TODO FIND OUT MAX LENGTH
   int                        current_mcch_length                   = 0;
   uint8_t                    mcch_payload_buffer[mcch_payload_len] = {};
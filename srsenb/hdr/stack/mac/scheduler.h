@@ -131,6 +131,7 @@ public:
   /* Custom functions
    */
   void                                 set_dl_tti_mask(uint8_t* tti_mask, uint32_t nof_sfs) final;
+  int                                  set_sib_len(uint32_t enb_cc_idx, uint32_t sib_idx, uint32_t len);
   void                                 tpc_inc(uint16_t rnti);
   void                                 tpc_dec(uint16_t rnti);
   std::array<int, SRSLTE_MAX_CARRIERS> get_enb_ue_cc_map(uint16_t rnti) final;
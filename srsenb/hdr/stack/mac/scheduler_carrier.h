@@ -41,6 +41,7 @@ public:
   int                    dl_rach_info(dl_sched_rar_info_t rar_info);
 
   // getters
+  const bc_sched* get_bc_sched() const { return bc_sched_ptr.get(); }
   const ra_sched* get_ra_sched() const { return ra_sched_ptr.get(); }
   //! Get a subframe result for a given tti
   const sf_sched_result& get_sf_result(uint32_t tti_rx) const;
@@ -81,10 +82,21 @@ private:
 class bc_sched
 {
 public:
+  //! SI message allocation statistics, accumulated since the last reset
+  struct si_stats_t {
+    uint32_t nof_windows     = 0; ///< SI-windows started
+    uint32_t nof_tx          = 0; ///< transmissions allocated
+    uint32_t nof_alloc_fails = 0; ///< allocation attempts that failed due to lack of PDCCH or RBG space
+    uint32_t nof_missed      = 0; ///< SI-windows that ended before all their transmissions were allocated
+    uint32_t nof_rbgs        = 0; ///< RBGs reserved by the last transmission
+  };
+
   explicit bc_sched(const sched_cell_params_t& cfg_, rrc_interface_mac* rrc_);
   void dl_sched(sf_sched* tti_sched);
   void reset();
 
+  const si_stats_t& get_si_stats(uint32_t sib_idx) const { return si_stats[sib_idx]; }
+
 private:
   struct sched_sib_t {
     bool     is_in_window = false;
@@ -99,8 +111,10 @@ private:
   // args
   const sched_cell_params_t* cc_cfg = nullptr;
   rrc_interface_mac*         rrc    = nullptr;
+  srslte::log_ref            log_h;
 
   std::array<sched_sib_t, sched_interface::MAX_SIBS> pending_sibs;
+  std::array<si_stats_t, sched_interface::MAX_SIBS>  si_stats;
 
   // TTI specific
   uint32_t current_tti   = 0;
@@ -58,6 +58,7 @@ public:
   // convenience getters
   uint32_t prb_to_rbg(uint32_t nof_prbs) const { return (nof_prbs + (P - 1)) / P; }
   uint32_t nof_prb() const { return cfg.cell.nof_prb; }
+  uint32_t get_dl_bc_nof_rbgs(uint32_t req_bytes) const;
 
   uint32_t                                       enb_cc_idx = 0;
   sched_interface::cell_cfg_t                    cfg        = {};
@@ -68,6 +69,7 @@ public:
   std::array<uint32_t, 3>                        nof_cce_table    = {}; ///< map cfix -> nof cces in PDCCH
   uint32_t                                       P                = 0;
   uint32_t                                       nof_rbgs         = 0;
+  std::vector<uint32_t>                          bc_max_tbs_bits; ///< map nof RBGs -> max BC TBS with QPSK (bits)
 };
 
 //! Bitmask used for CCE allocations
@@ -126,6 +128,14 @@ inline uint32_t get_nof_retx(uint32_t rv_idx)
   return nof_retxs[rv_idx % 4];
 }
 
+/**
+ * Find the smallest TBS of a DCI format 1A broadcast allocation (N_PRB1A = 2 or 3) that fits the given payload
+ * @param req_bytes payload length in bytes
+ * @param n_prb1a set to the N_PRB1A column of the selected TBS
+ * @return I_TBS of the selected TBS, or -1 if the payload exceeds the largest format 1A TBS
+ */
+int get_format1a_tbs_idx(uint32_t req_bytes, uint32_t* n_prb1a);
+
 /**
  * Generate possible CCE locations a user can use to allocate DCIs
  * @param regs Regs data for the given cell configuration
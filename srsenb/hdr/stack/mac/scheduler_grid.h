@@ -136,7 +136,7 @@ public:
 
   void            init(const sched_cell_params_t& cell_params_);
   void            new_tti(const tti_params_t& tti_params_);
-  dl_ctrl_alloc_t alloc_dl_ctrl(uint32_t aggr_lvl, alloc_type_t alloc_type);
+  dl_ctrl_alloc_t alloc_dl_ctrl(uint32_t aggr_lvl, uint32_t req_bytes, alloc_type_t alloc_type);
   alloc_outcome_t alloc_dl_data(sched_ue* user, const rbgmask_t& user_mask);
   bool            reserve_dl_rbgs(uint32_t start_rbg, uint32_t end_rbg);
   alloc_outcome_t alloc_ul_data(sched_ue* user, ul_harq_proc::ul_alloc_t alloc, bool needs_pdcch);
@@ -155,7 +155,7 @@ private:
   const sched_cell_params_t* cc_cfg = nullptr;
   srslte::log_ref            log_h;
   uint32_t                   nof_rbgs = 0;
-  uint32_t                   si_n_rbg = 0, rar_n_rbg = 0;
+  uint32_t                   rar_n_rbg = 0;
 
   // tti const
   const tti_params_t* tti_params = nullptr;
@@ -39,16 +39,17 @@ namespace srsenb {
 class ue : public srslte::read_pdu_interface, public srslte::pdu_queue::process_callback, public mac_ta_ue_interface
 {
 public:
-  ue(uint16_t                 rnti,
-     uint32_t                 nof_prb,
-     sched_interface*         sched,
-     rrc_interface_mac*       rrc_,
-     rlc_interface_mac*       rlc,
-     phy_interface_stack_lte* phy_,
-     srslte::log_ref          log_,
-     uint32_t                 nof_cells_,
-     uint32_t                 nof_rx_harq_proc = SRSLTE_FDD_NOF_HARQ,
-     uint32_t                 nof_tx_harq_proc = SRSLTE_FDD_NOF_HARQ * SRSLTE_MAX_TB);
+  ue(uint16_t                  rnti,
+     uint32_t                  nof_prb,
+     sched_interface*          sched,
+     rrc_interface_mac*        rrc_,
+     rlc_interface_mac*        rlc,
+     phy_interface_stack_lte*  phy_,
+     srslte::log_ref           log_,
+     uint32_t                  nof_cells_,
+     uint32_t                  nof_rx_harq_proc    = SRSLTE_FDD_NOF_HARQ,
+     uint32_t                  nof_tx_harq_proc    = SRSLTE_FDD_NOF_HARQ * SRSLTE_MAX_TB,
+     srslte_softbuffer_pool_t* rx_softbuffer_pool_ = nullptr);
   virtual ~ue();
 
   void reset();
@@ -130,6 +131,7 @@ private:
   typedef std::vector<srslte_softbuffer_rx_t>
                                        cc_softbuffer_rx_list_t; ///< List of Rx softbuffers for all HARQ processes of one carrier
   std::vector<cc_softbuffer_rx_list_t> softbuffer_rx;           ///< List of softbuffer lists for Rx
+  srslte_softbuffer_pool_t*            rx_softbuffer_pool = nullptr; ///< Rx code block buffers are taken from it if set
 
   typedef std::vector<uint8_t*> cc_buffer_ptr_t; ///< List of buffer pointers for RX HARQ processes of one carrier
   std::vector<cc_buffer_ptr_t>  pending_buffers; ///< List of buffer pointer list for Rx
@@ -32,6 +32,8 @@
 #include "srslte/common/stack_procedure.h"
 #include "srslte/common/timeout.h"
 #include "srslte/interfaces/enb_interfaces.h"
+#include <array>
+#include <atomic>
 #include <map>
 #include <queue>
 
@@ -73,7 +75,7 @@ public:
   void     upd_user(uint16_t new_rnti, uint16_t old_rnti) override;
   void     set_activity_user(uint16_t rnti) override;
   bool     is_paging_opportunity(uint32_t tti, uint32_t* payload_len) override;
-  uint8_t* read_pdu_bcch_dlsch(const uint8_t cc_idx, const uint32_t sib_index) override;
+  uint8_t* read_pdu_bcch_dlsch(const uint8_t cc_idx, const uint32_t sib_index, const uint32_t tti) override;
 
   // rrc_interface_rlc
   void read_pdu_pcch(uint8_t* payload, uint32_t buffer_size) override;
@@ -88,12 +90,24 @@ public:
   bool release_erabs(uint32_t rnti) override;
   void add_paging_id(uint32_t ueid, const asn1::s1ap::ue_paging_id_c& UEPagingID) override;
   void ho_preparation_complete(uint16_t rnti, bool is_success, srslte::unique_byte_buffer_t rrc_container) override;
+  bool write_replace_warning(const asn1::s1ap::write_replace_warning_request_s& msg,
+                             std::vector<uint32_t>*                              cell_ids) override;
+  bool kill_warning(uint16_t msg_id, uint16_t serial_num, bool kill_all, std::vector<uint32_t>* cell_ids) override;
 
   // rrc_interface_pdcp
   void write_pdu(uint16_t rnti, uint32_t lcid, srslte::unique_byte_buffer_t pdu) override;
 
   uint32_t get_nof_users();
 
+  /**
+   * Replaces the content of warning SIBs (SIB10, SIB11 or SIB12) without restarting the eNB. Only the SI messages
+   * carrying the SIBs are packed again, and the SIB1 systemInfoValueTag is incremented once for all of them.
+   *
+   * @param sibs New SIB10, SIB11 or SIB12. The SIBs must be scheduled in SIB1
+   * @return SRSLTE_SUCCESS if the SIB buffers were swapped. Otherwise, the previous SIBs keep being broadcast
+   */
+  int update_warning_sibs(const std::vector<asn1::rrc::sib_info_item_c>& sibs);
+
   // logging
   typedef enum { Rx = 0, Tx } direction_t;
   template <class T>
@@ -289,12 +303,33 @@ private:
   // state
   std::unique_ptr<freq_res_common_list>          pucch_res_list;
   std::map<uint16_t, std::unique_ptr<ue> >       users; // NOTE: has to have fixed addr
-  std::map<uint32_t, asn1::rrc::paging_record_s> pending_paging;
 
   void     process_release_complete(uint16_t rnti);
   void     process_rl_failure(uint16_t rnti);
   void     rem_user(uint16_t rnti);
   uint32_t generate_sibs();
+  bool     find_sib(asn1::rrc::sib_type_e sib_type, uint32_t* msg_index, uint32_t* sib_pos) const;
+  void     build_si_msg(const cell_info_common& cell_ctxt, uint32_t msg_index, asn1::rrc::bcch_dl_sch_msg_s* msg);
+  int      pack_si_msg(uint32_t                            cc_idx,
+                       uint32_t                            msg_index,
+                       const asn1::rrc::bcch_dl_sch_msg_s& msg,
+                       uint32_t                            max_len = 0);
+  uint32_t max_si_len() const;
+  int      set_cmas_segments(cell_info_common* cell_ctxt, const asn1::rrc::bcch_dl_sch_msg_s& msg, uint32_t sib_pos);
+  int      pack_warning_si_msgs(const std::vector<uint32_t>& msg_idxs, uint32_t cmas_msg_idx, uint32_t cmas_sib_pos);
+  int      add_cmas_alert(const asn1::rrc::sib_info_item_c& sib,
+                          uint16_t                          msg_id,
+                          uint16_t                          serial_num,
+                          uint32_t                          repeat_period,
+                          uint32_t                          nof_broadcasts);
+  void     remove_cmas_alert(uint16_t msg_id);
+  void     get_cell_ids(std::vector<uint32_t>* cell_ids) const;
+  void     cmas_repetition_expired(uint16_t msg_id);
+  void     mute_warning_si(asn1::rrc::sib_type_e sib_type);
+  void     report_warning_tx(uint32_t cc_idx, uint32_t sib_index, uint32_t tti);
+  void     init_paging_calendar();
+  void     fill_warning_ind(asn1::rrc::paging_s* paging_rec) const;
+  void     set_warning_paging(bool restart);
   void     configure_mbsfn_sibs(asn1::rrc::sib_type2_s* sib2, asn1::rrc::sib_type13_r9_s* sib13);
 
   void config_mac();
@@ -334,6 +369,53 @@ private:
   void rem_user_thread(uint16_t rnti);
 
   std::mutex paging_mutex;
+
+  // Paging occasions of the cell, derived from SIB2
+  uint32_t                paging_T          = 0;
+  uint32_t                paging_N          = 0;
+  uint32_t                paging_Ns         = 0;
+  std::array<uint32_t, 4> paging_po_sf      = {}; ///< PO subframe of each i_s
+  uint32_t                paging_po_sf_mask = 0;  ///< Bitmask of the subframes with a PO
+
+  // Pending paging records, bucketed by PO over one paging cycle. Protected by paging_mutex
+  struct pending_paging_t {
+    uint32_t                   ueid;
+    asn1::rrc::paging_record_s record;
+  };
+  std::vector<std::vector<pending_paging_t> > paging_calendar; ///< Indexed by (SFN mod T) * 10 + subframe
+  uint32_t                                    nof_pending_paging = 0;
+
+  // Public warning messages received from the MME, one per warning SIB (SIB10, SIB11 and SIB12)
+  struct warning_msg_t {
+    bool     active     = false;
+    uint16_t msg_id     = 0;
+    uint16_t serial_num = 0;
+  };
+  std::array<warning_msg_t, 3> warning_msgs;
+  bool                         etws_ind = false; ///< ETWS indication in paging messages, protected by paging_mutex
+  bool                         cmas_ind = false; ///< CMAS indication in paging messages, protected by paging_mutex
+
+  // Concurrent CMAS alerts, broadcast in round-robin in the SIB12 segments. Indexed by messageIdentifier
+  struct cmas_alert_t {
+    uint16_t                            serial_num         = 0;
+    uint32_t                            nof_broadcasts_req = 0; ///< Number of broadcasts requested, 0 for unlimited
+    uint32_t                            nof_scheduled      = 0; ///< Number of broadcasts scheduled in the cells
+    bool                                retired            = false;
+    srslte::timer_handler::unique_timer repetition_timer;
+  };
+  std::map<uint16_t, cmas_alert_t> cmas_alerts;
+
+  // Notification of the warning messages in every PO of the cell during one modification period, protected by
+  // paging_mutex
+  srslte::byte_buffer_t warning_paging_buf;                 ///< Pre-packed paging message with only the indications
+  uint32_t              warning_paging_frames_left = 0;     ///< Radio frames left in the notification period
+  uint32_t              warning_paging_sfn         = 1024;  ///< Last radio frame counted
+  bool                  warning_paging_in_frame    = false; ///< The last radio frame counted is in the period
+
+  // Latency from the reception of a warning message until its first SI transmission
+  std::atomic<int64_t>  warning_rx_time_us{0}; ///< Reception time of the last warning, read by the MAC
+  std::atomic<uint32_t> warning_si_mask{0};    ///< Bitmask of SI messages carrying the new warning
+  std::atomic<uint32_t> warning_tx_pending{0}; ///< Bitmask of cells yet to transmit the new warning
 };
 
 } // namespace srsenb
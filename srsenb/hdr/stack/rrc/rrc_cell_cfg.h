@@ -22,8 +22,11 @@
 #ifndef SRSLTE_RRC_CELL_CFG_H
 #define SRSLTE_RRC_CELL_CFG_H
 
+#include "rrc_cmas.h"
 #include "rrc_config.h"
+#include "rrc_si_snapshot.h"
 #include "srslte/common/logmap.h"
+#include <memory>
 
 namespace srsenb {
 
@@ -54,6 +57,25 @@ private:
   std::map<uint32_t, pucch_res_common> pucch_res_list;
 };
 
+/**
+ * Packed SI message that can be replaced at runtime while the MAC keeps reading it. Each payload is published as a new
+ * snapshot. The storage only grows, so a reader still using the previous SI length never reads out of bounds.
+ */
+class si_msg_buffer
+{
+public:
+  void     write(const uint8_t* payload, uint32_t len);
+  uint8_t* read(uint32_t tti) { return snapshot.pin(tti)->buffer.data(); }
+  uint32_t size() const;
+
+private:
+  struct payload_t {
+    std::vector<uint8_t> buffer;
+    uint32_t             len = 0;
+  };
+  si_snapshot<payload_t> snapshot;
+};
+
 /** Storage of cell-specific eNB config and derived params */
 struct cell_info_common {
   uint32_t                           enb_cc_idx = 0;
@@ -61,7 +83,9 @@ struct cell_info_common {
   asn1::rrc::sib_type1_s             sib1;
   asn1::rrc::sib_type2_s             sib2;
   const cell_cfg_t&                  cell_cfg;
-  std::vector<std::vector<uint8_t> > sib_buffer; ///< Packed SIBs for given CC
+  std::vector<si_msg_buffer>         sib_buffer;      ///< Packed SIBs for given CC
+  std::unique_ptr<cmas_segment_ring> cmas_ring;       ///< Pre-packed SIB12 segments, present if SIB12 is scheduled
+  uint32_t                           cmas_si_idx = 0; ///< Index of the SI message carrying SIB12
 
   cell_info_common(uint32_t idx_, const cell_cfg_t& cfg) : enb_cc_idx(idx_), cell_cfg(cfg) {}
 };
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSENB_RRC_CMAS_H
+#define SRSENB_RRC_CMAS_H
+
+#include "rrc_si_snapshot.h"
+#include "srslte/asn1/rrc_asn1.h"
+#include "srslte/common/logmap.h"
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace srsenb {
+
+/**
+ * Stores the SI message carrying SIB12 pre-packed once per CMAS warning segment. The warning message is split in
+ * segments that fit the SI TBS limit and each SI-window picks the next segment of the ring, so no ASN.1 encoding
+ * takes place in the TTI path. Every change of the alerts publishes a new immutable set of segments, so the alerts can
+ * be replaced while the MAC and the PHY are still using the segments read before.
+ *
+ * The ring holds several concurrent alerts, each with its own set of segments. The SI-windows are shared in
+ * round-robin among the alerts with a scheduled broadcast, and among all the alerts when none is scheduled.
+ */
+class cmas_segment_ring
+{
+public:
+  /// Maximum number of segments of a warning message (warningMessageSegmentNumber-r9 is 0..63)
+  const static uint32_t max_nof_segments = 64;
+  /// Maximum number of concurrent alerts
+  const static uint32_t max_nof_alerts = 16;
+
+  explicit cmas_segment_ring(uint32_t si_period_rf_);
+
+  /**
+   * Splits the warning message contained in the SIB12 of the SI message into segments and packs one BCCH-DL-SCH
+   * message per segment. All packed messages are zero-padded to the length of the longest one, so the MAC can keep
+   * a single SI length for the SI message. The buffers are never shorter than the ones they replace.
+   * The warning message replaces all the alerts of the ring.
+   *
+   * @param si_msg SI message carrying the SIB12 with the complete warning message, plus any other SIB of the same SI
+   * @param sib12_pos Position of the SIB12 in the sib_type_and_info list of the SI message
+   * @param max_len Maximum length in bytes of a packed SI message (SI TBS limit)
+   * @param alert_id Identifier of the alert in the ring
+   * @return The number of segments, or SRSLTE_ERROR if the warning message could not be segmented
+   */
+  int set_warning(const asn1::rrc::bcch_dl_sch_msg_s& si_msg,
+                  uint32_t                            sib12_pos,
+                  uint32_t                            max_len,
+                  uint32_t                            alert_id = 0);
+
+  /**
+   * Adds an alert to the ring, or replaces the alert with the same id. Segmented as in set_warning().
+   * @return The number of segments of the alert, or SRSLTE_ERROR
+   */
+  int  add_alert(uint32_t alert_id, const asn1::rrc::bcch_dl_sch_msg_s& si_msg, uint32_t sib12_pos, uint32_t max_len);
+  bool remove_alert(uint32_t alert_id);
+  void clear();
+
+  /**
+   * Schedules one more broadcast of all the segments of an alert. The alerts with a scheduled broadcast take
+   * precedence over the others in the SI-windows.
+   * @return false if the previous broadcast has not completed yet
+   */
+  bool     schedule_broadcast(uint32_t alert_id);
+  uint32_t nof_broadcasts(uint32_t alert_id) const; ///< Number of scheduled broadcasts completed
+  uint32_t nof_alerts() const { return alerts.size(); }
+
+  /**
+   * Returns the packed SI message to transmit in the given TTI. The ring advances once per SI-window, therefore
+   * all the transmissions within a window carry the same segment.
+   */
+  uint8_t* read_pdu(uint32_t tti);
+
+  /// Segments of all the alerts, in the order of the alerts
+  const std::vector<uint8_t>& get_segment(uint32_t idx) const;
+  uint32_t                    nof_segments() const;
+  uint32_t                    payload_len() const { return gen.get()->pdu_len; }
+
+private:
+  /// Transmission state of an alert, shared by the generations of the ring
+  struct alert_state_t {
+    std::atomic<uint32_t> next_segment{0};
+    std::atomic<uint32_t> pending_tx{0}; ///< Segment transmissions left in the scheduled broadcasts
+    std::atomic<uint32_t> nof_tx{0};     ///< Segment transmissions of the scheduled broadcasts
+  };
+  struct alert_t {
+    uint32_t                           id = 0;
+    std::vector<std::vector<uint8_t> > segments;
+    std::shared_ptr<alert_state_t>     state;
+  };
+  struct segment_list_t {
+    std::vector<alert_t> alerts;
+    uint32_t             pdu_len = 0;
+  };
+
+  int  segment_warning(const asn1::rrc::bcch_dl_sch_msg_s& si_msg,
+                       uint32_t                            sib12_pos,
+                       uint32_t                            max_len,
+                       std::vector<std::vector<uint8_t> >* segments);
+  int  pack_si_msg(const asn1::rrc::bcch_dl_sch_msg_s& msg, std::vector<uint8_t>& buffer);
+  void publish();
+
+  srslte::log_ref rrc_log;
+  uint32_t        si_period_rf = 0;
+
+  std::vector<alert_t> alerts; ///< Unpadded alerts, only accessed by the RRC
+
+  si_snapshot<segment_list_t> gen; ///< Padded alerts read by the MAC
+  std::atomic<uint32_t>       current_window{std::numeric_limits<uint32_t>::max()};
+  std::atomic<uint32_t>       current_alert{0};
+  std::atomic<uint32_t>       current_segment{0};
+};
+
+} // namespace srsenb
+
+#endif // SRSENB_RRC_CMAS_H
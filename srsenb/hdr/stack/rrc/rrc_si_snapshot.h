@@ -0,0 +1,66 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSENB_RRC_SI_SNAPSHOT_H
+#define SRSENB_RRC_SI_SNAPSHOT_H
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+namespace srsenb {
+
+/**
+ * Immutable snapshot of SI data that the RRC replaces at runtime while the MAC reads it in the TTI path. Every update
+ * publishes a new snapshot with an atomic store and a published snapshot is never modified again.
+ *
+ * The MAC hands raw pointers into the snapshot to the PHY, which uses them until the subframe is transmitted. Each
+ * read therefore pins the snapshot in the slot of the TTI it is read for. The slot is only overwritten by the read of
+ * a TTI nof_pin_slots later, once the PHY workers are done with the subframe, which releases the snapshot if it was
+ * replaced meanwhile.
+ */
+template <typename T>
+class si_snapshot
+{
+public:
+  /// TTIs a read snapshot is kept alive for, more than the PHY workers can be processing at once
+  const static uint32_t nof_pin_slots = 16;
+
+  void               publish(std::shared_ptr<T> snapshot) { std::atomic_store(&current, std::move(snapshot)); }
+  std::shared_ptr<T> get() const { return std::atomic_load(&current); }
+
+  /// Returns the current snapshot, which stays alive for the PHY processing of the TTI
+  T* pin(uint32_t tti)
+  {
+    std::shared_ptr<T> snapshot = get();
+    T*                 ptr      = snapshot.get();
+    std::atomic_store(&pinned[tti % nof_pin_slots], std::move(snapshot));
+    return ptr;
+  }
+
+private:
+  std::shared_ptr<T>                            current;
+  std::array<std::shared_ptr<T>, nof_pin_slots> pinned;
+};
+
+} // namespace srsenb
+
+#endif // SRSENB_RRC_SI_SNAPSHOT_H
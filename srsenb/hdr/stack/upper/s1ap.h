@@ -141,6 +141,13 @@ private:
   bool handle_erabsetuprequest(const asn1::s1ap::erab_setup_request_s& msg);
   bool handle_uecontextmodifyrequest(const asn1::s1ap::ue_context_mod_request_s& msg);
 
+  // public warning system
+  bool handle_writereplacewarningrequest(const asn1::s1ap::write_replace_warning_request_s& msg);
+  bool handle_killrequest(const asn1::s1ap::kill_request_s& msg);
+  bool is_in_warning_area(const asn1::s1ap::warning_area_list_c& warning_area);
+
+  asn1::s1ap::eutran_cgi_s get_cell_ecgi(uint32_t cell_id) const;
+
   // bool send_ue_capabilities(uint16_t rnti, LIBLTE_RRC_UE_EUTRA_CAPABILITY_STRUCT *caps)
   // handover
   bool handle_hopreparationfailure(const asn1::s1ap::ho_prep_fail_s& msg);
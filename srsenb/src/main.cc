@@ -28,6 +28,7 @@
 #include "srslte/common/config_file.h"
 #include "srslte/common/crash_handler.h"
 #include "srslte/common/signal_handler.h"
+#include "srslte/phy/utils/simd_dispatch.h"
 
 #include <boost/program_options.hpp>
 #include <boost/program_options/parsers.hpp>
@@ -178,13 +179,18 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("expert.metrics_csv_enable",  bpo::value<bool>(&args->general.metrics_csv_enable)->default_value(false), "Write metrics to CSV file")
     ("expert.metrics_csv_filename", bpo::value<string>(&args->general.metrics_csv_filename)->default_value("/tmp/enb_metrics.csv"), "Metrics CSV filename")
     ("expert.pusch_max_its", bpo::value<int>(&args->phy.pusch_max_its)->default_value(8), "Maximum number of turbo decoder iterations")
+    ("expert.pusch_adaptive_its", bpo::value<uint32_t>(&args->phy.pusch_adaptive_its)->default_value(0), "Average number of turbo decoder half iterations per code block of a subframe for adaptive decoding (0 disables it)")
     ("expert.pusch_8bit_decoder", bpo::value<bool>(&args->phy.pusch_8bit_decoder)->default_value(false), "Use 8-bit for LLR representation and turbo decoder trellis computation (Experimental)")
+    ("expert.pusch_softbuffer_pool_size", bpo::value<uint32_t>(&args->stack.mac.rx_softbuffer_pool_size)->default_value(0), "Maximum number of PUSCH code block buffers shared by all UEs, requires the 8-bit decoder (0 allocates them per UE at attach)")
     ("expert.pusch_meas_evm", bpo::value<bool>(&args->phy.pusch_meas_evm)->default_value(false), "Enable/Disable PUSCH EVM measure")
     ("expert.tx_amplitude", bpo::value<float>(&args->phy.tx_amplitude)->default_value(0.6), "Transmit amplitude factor")
     ("expert.nof_phy_threads", bpo::value<int>(&args->phy.nof_phy_threads)->default_value(3), "Number of PHY threads")
+    ("expert.nof_prach_threads", bpo::value<int>(&args->phy.nof_prach_threads)->default_value(1), "Number of PRACH detection threads shared by all the carriers")
+    ("expert.nof_cb_workers", bpo::value<uint32_t>(&args->phy.nof_cb_workers)->default_value(0), "Number of threads decoding PUSCH code blocks for all the PHY threads (0 disables them)")
     ("expert.link_failure_nof_err", bpo::value<int>(&args->stack.mac.link_failure_nof_err)->default_value(100), "Number of PUSCH failures after which a radio-link failure is triggered")
     ("expert.max_prach_offset_us", bpo::value<float>(&args->phy.max_prach_offset_us)->default_value(30), "Maximum allowed RACH offset (in us)")
     ("expert.equalizer_mode", bpo::value<string>(&args->phy.equalizer_mode)->default_value("mmse"), "Equalizer mode")
+    ("expert.simd_isa", bpo::value<string>(&args->phy.simd_isa)->default_value("auto"), "Highest instruction set of the SIMD kernels: auto, sse, avx2 or avx512")
     ("expert.estimator_fil_w", bpo::value<float>(&args->phy.estimator_fil_w)->default_value(0.1), "Chooses the coefficients for the 3-tap channel estimator centered filter.")
     ("expert.rrc_inactivity_timer", bpo::value<uint32_t>(&args->general.rrc_inactivity_timer)->default_value(60000), "Inactivity timer in ms")
     ("expert.print_buffer_state", bpo::value<bool>(&args->general.print_buffer_state)->default_value(false), "Prints on the console the buffer state every 10 seconds")
@@ -276,6 +282,16 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     }
   }
 
+  if (args->stack.mac.rx_softbuffer_pool_size > 0 && !args->phy.pusch_8bit_decoder) {
+    cout << "Warning: expert.pusch_softbuffer_pool_size requires expert.pusch_8bit_decoder. Disabling the pool." << endl;
+    args->stack.mac.rx_softbuffer_pool_size = 0;
+  }
+
+  if (srslte_simd_isa_set(args->phy.simd_isa.c_str()) != SRSLTE_SUCCESS) {
+    cout << "Error parsing expert.simd_isa: " << args->phy.simd_isa << "." << endl;
+    exit(1);
+  }
+
   // Covert eNB Id
   std::size_t pos = {};
   try {
@@ -408,6 +424,10 @@ int main(int argc, char* argv[])
   srslte_debug_handle_crash(argc, argv);
   parse_args(&args, argc, argv);
 
+  char simd_info[128] = {};
+  srslte_simd_isa_info(simd_info, sizeof(simd_info));
+  cout << simd_info << endl << endl;
+
   srslte::logger_stdout logger_stdout;
 
   // Set logger
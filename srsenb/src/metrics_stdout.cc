@@ -83,6 +83,14 @@ void metrics_stdout::set_metrics(const enb_metrics_t& metrics, const uint32_t pe
     printf("RF status: O=%d, U=%d, L=%d\n", metrics.rf.rf_o, metrics.rf.rf_u, metrics.rf.rf_l);
   }
 
+  if (metrics.phy[0].prach.deadline_misses) {
+    printf("PRACH status: late=%d/%d, queue=%.1f (max %d)\n",
+           metrics.phy[0].prach.deadline_misses,
+           metrics.phy[0].prach.nof_opportunities,
+           metrics.phy[0].prach.queue_depth,
+           metrics.phy[0].prach.max_queue_depth);
+  }
+
   if (metrics.stack.rrc.n_ues == 0) {
     return;
   }
@@ -65,13 +65,12 @@ cc_worker::~cc_worker()
   srslte_enb_dl_free(&enb_dl);
   srslte_enb_ul_free(&enb_ul);
 
-  for (int p = 0; p < SRSLTE_MAX_PORTS; p++) {
-    if (signal_buffer_rx[p]) {
-      free(signal_buffer_rx[p]);
-    }
-    if (signal_buffer_tx[p]) {
-      free(signal_buffer_tx[p]);
-    }
+  // All the ports point into the block allocated for the first one
+  if (signal_buffer_rx[0]) {
+    free(signal_buffer_rx[0]);
+  }
+  if (signal_buffer_tx[0]) {
+    free(signal_buffer_tx[0]);
   }
 
   // Delete all users
@@ -93,20 +92,23 @@ void cc_worker::init(phy_common* phy_, srslte::log* log_h_, uint32_t cc_idx_)
   uint32_t      nof_prb = phy_->get_nof_prb(cc_idx);
   uint32_t      sf_len  = SRSLTE_SF_LEN_PRB(nof_prb);
 
-  // Init cell here
-  for (uint32_t p = 0; p < phy->get_nof_ports(cc_idx); p++) {
-    signal_buffer_rx[p] = srslte_vec_cf_malloc(2 * sf_len);
-    if (!signal_buffer_rx[p]) {
-      ERROR("Error allocating memory\n");
-      return;
-    }
-    srslte_vec_cf_zero(signal_buffer_rx[p], 2 * sf_len);
-    signal_buffer_tx[p] = srslte_vec_cf_malloc(2 * sf_len);
-    if (!signal_buffer_tx[p]) {
-      ERROR("Error allocating memory\n");
-      return;
-    }
-    srslte_vec_cf_zero(signal_buffer_tx[p], 2 * sf_len);
+  // Init cell here. The ports share one block at a fixed stride, so the OFDM transforms them with a single plan
+  uint32_t nof_ports = phy->get_nof_ports(cc_idx);
+  signal_buffer_rx[0] = srslte_vec_cf_malloc(2 * sf_len * nof_ports);
+  if (!signal_buffer_rx[0]) {
+    ERROR("Error allocating memory\n");
+    return;
+  }
+  srslte_vec_cf_zero(signal_buffer_rx[0], 2 * sf_len * nof_ports);
+  signal_buffer_tx[0] = srslte_vec_cf_malloc(2 * sf_len * nof_ports);
+  if (!signal_buffer_tx[0]) {
+    ERROR("Error allocating memory\n");
+    return;
+  }
+  srslte_vec_cf_zero(signal_buffer_tx[0], 2 * sf_len * nof_ports);
+  for (uint32_t p = 1; p < nof_ports; p++) {
+    signal_buffer_rx[p] = signal_buffer_rx[0] + 2 * sf_len * p;
+    signal_buffer_tx[p] = signal_buffer_tx[0] + 2 * sf_len * p;
   }
   if (srslte_enb_dl_init(&enb_dl, signal_buffer_tx, nof_prb)) {
     ERROR("Error initiating ENB DL\n");
@@ -150,6 +152,8 @@ void cc_worker::init(phy_common* phy_, srslte::log* log_h_, uint32_t cc_idx_)
     enb_ul.pusch.llr_is_8bit        = true;
     enb_ul.pusch.ul_sch.llr_is_8bit = true;
   }
+  srslte_sch_set_adaptive_noi(&enb_ul.pusch.ul_sch, phy->params.pusch_adaptive_its);
+  srslte_sch_enable_cb_workers(&enb_ul.pusch.ul_sch, phy->params.nof_cb_workers > 0);
   initiated = true;
 
 #ifdef DEBUG_WRITE_FILE
@@ -237,6 +241,9 @@ void cc_worker::work_ul(const srslte_ul_sf_cfg_t& ul_sf_cfg, stack_interface_phy
   // Process UL signal
   srslte_enb_ul_fft(&enb_ul);
 
+  // The PUSCH of all the UEs share the turbo decoder iterations of the subframe
+  srslte_sch_reset_adaptive_budget(&enb_ul.pusch.ul_sch);
+
   // Decode pending UL grants for the tti they were scheduled
   decode_pusch(ul_grants.pusch, ul_grants.nof_grants);
 
@@ -116,18 +116,36 @@ int phy::init(const phy_args_t&            args,
 
   parse_common_config(cfg);
 
+  // Start the code block decoders shared by the PUSCH of all the workers
+  if (srslte_sch_cb_workers_init(args.nof_cb_workers, WORKERS_THREAD_PRIO)) {
+    log_h->error("Error starting %d code block decoder threads\n", args.nof_cb_workers);
+    return SRSLTE_ERROR;
+  }
+
   // Add workers to workers pool and start threads
   for (uint32_t i = 0; i < nof_workers; i++) {
     workers[i].init(&workers_common, log_vec.at(i).get());
     workers_pool.init_worker(i, &workers[i], WORKERS_THREAD_PRIO);
   }
 
-  // For each carrier, initialise PRACH worker
+  // For each carrier, initialise PRACH detection, the workers of the pool detect the preambles of all the carriers
   for (uint32_t cc = 0; cc < cfg.phy_cell_cfg.size(); cc++) {
     prach_cfg.root_seq_idx = cfg.phy_cell_cfg[cc].root_seq_idx;
-    prach.init(cc, cfg.phy_cell_cfg[cc].cell, prach_cfg, stack_, log_vec.at(0).get(), PRACH_WORKER_THREAD_PRIO);
+    if (prach.init(cc,
+                   cfg.phy_cell_cfg[cc].cell,
+                   prach_cfg,
+                   cfg.phy_cell_cfg[cc].rar_window,
+                   stack_,
+                   log_vec.at(0).get())) {
+      log_h->error("Error initiating PRACH for cc=%d\n", cc);
+      return SRSLTE_ERROR;
+    }
   }
   prach.set_max_prach_offset_us(args.max_prach_offset_us);
+  if (prach.start((uint32_t)SRSLTE_MAX(args.nof_prach_threads, 1), PRACH_WORKER_THREAD_PRIO)) {
+    log_h->error("Error starting PRACH workers\n");
+    return SRSLTE_ERROR;
+  }
 
   // Warning this must be initialized after all workers have been added to the pool
   tx_rx.init(radio, &workers_pool, &workers_common, &prach, log_vec.at(0).get(), SF_RECV_THREAD_PRIO);
@@ -144,6 +162,7 @@ void phy::stop()
     workers_common.stop();
     workers_pool.stop();
     prach.stop();
+    srslte_sch_cb_workers_free();
 
     initialized = false;
   }
@@ -216,6 +235,11 @@ void phy::get_metrics(phy_metrics_t metrics[ENB_METRICS_MAX_USERS])
       metrics[j].ul.turbo_iters += metrics_tmp[j].ul.n_samples * metrics_tmp[j].ul.turbo_iters;
     }
   }
+  prach_metrics_t prach_metrics = {};
+  prach.get_metrics(&prach_metrics);
+  for (uint32_t j = 0; j < ENB_METRICS_MAX_USERS; j++) {
+    metrics[j].prach = prach_metrics;
+  }
   for (uint32_t j = 0; j < nof_users; j++) {
     metrics[j].dl.mcs /= metrics[j].dl.n_samples;
     metrics[j].ul.mcs /= metrics[j].ul.n_samples;
@@ -19,145 +19,313 @@
  *
  */
 
+
 #include "srsenb/hdr/phy/prach_worker.h"
 #include "srslte/srslte.h"
 
+// Longest RAR window, used if the carrier does not give one
+#define PRACH_MAX_RAR_WINDOW 10
+
 namespace srsenb {
 
-int prach_worker::init(const srslte_cell_t&      cell_,
-                       const srslte_prach_cfg_t& prach_cfg_,
-                       stack_interface_phy_lte*  stack_,
-                       srslte::log*              log_h_,
-                       int                       priority)
+prach_worker::~prach_worker()
 {
-  log_h     = log_h_;
-  stack     = stack_;
-  prach_cfg = prach_cfg_;
-  cell      = cell_;
+  for (auto& d : detectors) {
+    srslte_prach_free(&d->prach);
+  }
+}
 
-  max_prach_offset_us = 50;
+int prach_worker::add_carrier(const srslte_cell_t& cell, const srslte_prach_cfg_t& prach_cfg)
+{
+  std::unique_ptr<prach_detector> d(new prach_detector);
+  srslte_prach_cfg_t              cfg = prach_cfg;
 
-  if (srslte_prach_init(&prach, srslte_symbol_sz(cell.nof_prb))) {
-    return -1;
+  if (srslte_prach_init(&d->prach, srslte_symbol_sz(cell.nof_prb))) {
+    return SRSLTE_ERROR;
   }
+  d->freq_offset = cfg.freq_offset;
+  detectors.push_back(std::move(d));
 
-  if (srslte_prach_set_cfg(&prach, &prach_cfg, cell.nof_prb)) {
+  if (srslte_prach_set_cfg(&detectors.back()->prach, &cfg, cell.nof_prb)) {
     ERROR("Error initiating PRACH\n");
-    return -1;
+    return SRSLTE_ERROR;
   }
 
-  srslte_prach_set_detect_factor(&prach, 60);
+  srslte_prach_set_detect_factor(&detectors.back()->prach, 60);
 
-  nof_sf = (uint32_t)ceilf(prach.T_tot * 1000);
+  return SRSLTE_SUCCESS;
+}
 
-  start(priority);
-  initiated = true;
+void prach_worker::detect(prach_job* job)
+{
+  prach_detector* d = detectors.at(job->cc_idx).get();
+
+  if (srslte_prach_detect_offset(&d->prach,
+                                 d->freq_offset,
+                                 job->samples,
+                                 job->nof_samples,
+                                 job->indices,
+                                 job->offsets,
+                                 job->p2avg,
+                                 &job->nof_det)) {
+    log_h->error("Error detecting PRACH\n");
+    job->nof_det = 0;
+    return;
+  }
 
-  sf_cnt = 0;
-  return 0;
+  log_h->debug("PRACH: cc=%d, tti=%d, detection latency %.1f us (average %.1f us, max %.1f us)\n",
+               job->cc_idx,
+               job->tti,
+               d->prach.detect_latency_us,
+               d->prach.detect_latency_avg_us,
+               d->prach.detect_latency_max_us);
 }
 
-void prach_worker::stop()
+void prach_worker::run_thread()
 {
-  srslte_prach_free(&prach);
+  while (true) {
+    prach_job* job = pool->wait_job();
+    if (job == nullptr) {
+      break;
+    }
+    detect(job);
+    pool->job_done(job);
+  }
+}
 
-  running      = false;
-  sf_buffer* s = nullptr;
-  pending_buffers.push(s);
-  wait_thread_finish();
+bool prach_worker_pool::prach_carrier::tti_opportunity(uint32_t tti)
+{
+  if (!prach_cfg.tdd_config.configured) {
+    return srslte_prach_tti_opportunity_config_fdd(prach_cfg.config_idx, tti, -1);
+  }
+  return srslte_prach_tti_opportunity_config_tdd(prach_cfg.config_idx, prach_cfg.tdd_config.sf_config, tti, nullptr);
 }
 
-void prach_worker::set_max_prach_offset_us(float delay_us)
+int prach_worker_pool::init(uint32_t                  cc_idx,
+                            const srslte_cell_t&      cell_,
+                            const srslte_prach_cfg_t& prach_cfg_,
+                            uint32_t                  rar_window,
+                            stack_interface_phy_lte*  stack_,
+                            srslte::log*              log_h_)
 {
-  max_prach_offset_us = delay_us;
+  log_h = log_h_;
+  stack = stack_;
+
+  prach_carrier carrier = {};
+  carrier.cell          = cell_;
+  carrier.prach_cfg     = prach_cfg_;
+  carrier.rar_window    = rar_window ? rar_window : PRACH_MAX_RAR_WINDOW;
+
+  // Find the subframes of an opportunity and the samples of the preamble that the detector uses
+  std::unique_ptr<srslte_prach_t> prach(new srslte_prach_t);
+  if (srslte_prach_init(prach.get(), srslte_symbol_sz(cell_.nof_prb))) {
+    return SRSLTE_ERROR;
+  }
+  if (srslte_prach_set_cfg(prach.get(), &carrier.prach_cfg, cell_.nof_prb)) {
+    ERROR("Error initiating PRACH\n");
+    srslte_prach_free(prach.get());
+    return SRSLTE_ERROR;
+  }
+  carrier.nof_sf = (uint32_t)ceilf(prach->T_tot * 1000);
+  carrier.offset = prach->N_cp;
+  carrier.len    = prach->N_ifft_prach;
+  srslte_prach_free(prach.get());
+
+  if (carrier.len > prach_job::max_samples) {
+    ERROR("PRACH: %d samples do not fit in the detection buffers\n", carrier.len);
+    return SRSLTE_ERROR;
+  }
+
+  while (cc_idx >= carriers.size()) {
+    carriers.emplace_back();
+  }
+  carriers[cc_idx] = carrier;
+
+  return SRSLTE_SUCCESS;
 }
 
-int prach_worker::new_tti(uint32_t tti_rx, cf_t* buffer_rx)
+int prach_worker_pool::start(uint32_t nof_workers, int priority)
 {
-  // Save buffer only if it's a PRACH TTI
-  if (srslte_prach_tti_opportunity(&prach, tti_rx, -1) || sf_cnt) {
-    if (sf_cnt == 0) {
-      current_buffer = buffer_pool.allocate();
-      if (!current_buffer) {
-        log_h->warning("PRACH skipping tti=%d due to lack of available buffers\n", tti_rx);
-        return 0;
+  if (carriers.empty() || nof_workers == 0) {
+    ERROR("PRACH: Invalid number of carriers (%zd) or workers (%d)\n", carriers.size(), nof_workers);
+    return SRSLTE_ERROR;
+  }
+
+  job_pool = std::unique_ptr<srslte::buffer_pool<prach_job> >(
+      new srslte::buffer_pool<prach_job>(nof_jobs_carrier * carriers.size()));
+  report_jobs.reserve(nof_jobs_carrier * carriers.size());
+
+  // Every worker detects the preambles of all the carriers
+  for (uint32_t i = 0; i < nof_workers; i++) {
+    std::unique_ptr<prach_worker> w(new prach_worker(i, this, log_h));
+    for (auto& c : carriers) {
+      if (w->add_carrier(c.cell, c.prach_cfg)) {
+        return SRSLTE_ERROR;
       }
     }
-    if (!current_buffer) {
-      log_h->error("PRACH: Expected available current_buffer\n");
-      return -1;
-    }
-    if (current_buffer->nof_samples + SRSLTE_SF_LEN_PRB(cell.nof_prb) < sf_buffer_sz) {
-      memcpy(&current_buffer->samples[sf_cnt * SRSLTE_SF_LEN_PRB(cell.nof_prb)],
-             buffer_rx,
-             sizeof(cf_t) * SRSLTE_SF_LEN_PRB(cell.nof_prb));
-      current_buffer->nof_samples += SRSLTE_SF_LEN_PRB(cell.nof_prb);
-      if (sf_cnt == 0) {
-        current_buffer->tti = tti_rx;
-      }
-    } else {
-      log_h->error("PRACH: Not enough space in current_buffer\n");
-      return -1;
+    workers.push_back(std::move(w));
+  }
+
+  running = true;
+  for (auto& w : workers) {
+    w->start(priority);
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
+void prach_worker_pool::set_max_prach_offset_us(float delay_us)
+{
+  max_prach_offset_us = delay_us;
+}
+
+void prach_worker_pool::stop()
+{
+  if (!running.exchange(false)) {
+    return;
+  }
+
+  for (uint32_t i = 0; i < workers.size(); i++) {
+    prach_job* j = nullptr;
+    pending_jobs.push(j);
+  }
+  for (auto& w : workers) {
+    w->wait_thread_finish();
+  }
+  workers.clear();
+}
+
+int prach_worker_pool::new_tti(uint32_t cc_idx, uint32_t tti, cf_t* buffer)
+{
+  if (cc_idx >= carriers.size() || !running) {
+    return SRSLTE_ERROR;
+  }
+  prach_carrier& c = carriers[cc_idx];
+
+  last_tti = tti;
+
+  // Save samples only in the subframes of the PRACH opportunities
+  if (!c.sf_cnt && !c.tti_opportunity(tti)) {
+    return SRSLTE_SUCCESS;
+  }
+
+  if (c.sf_cnt == 0) {
+    c.job = job_pool->allocate();
+    if (!c.job) {
+      log_h->warning("PRACH skipping tti=%d due to lack of available buffers\n", tti);
+      std::lock_guard<std::mutex> lock(mutex);
+      metrics.deadline_misses++;
+      return SRSLTE_SUCCESS;
     }
-    sf_cnt++;
-    if (sf_cnt == nof_sf) {
-      sf_cnt = 0;
-      pending_buffers.push(current_buffer);
+    c.job->tti    = tti;
+    c.job->cc_idx = cc_idx;
+  }
+
+  // Copy the part of the subframe that the detector uses, the cyclic prefix, the repetitions of the sequence and the
+  // guard time are skipped
+  uint32_t sf_len   = SRSLTE_SF_LEN_PRB(c.cell.nof_prb);
+  uint32_t sf_start = c.sf_cnt * sf_len;
+  uint32_t begin    = SRSLTE_MAX(sf_start, c.offset);
+  uint32_t end      = SRSLTE_MIN(sf_start + sf_len, c.offset + c.len);
+  if (c.job && begin < end) {
+    memcpy(&c.job->samples[begin - c.offset], &buffer[begin - sf_start], sizeof(cf_t) * (end - begin));
+    c.job->nof_samples += end - begin;
+  }
+
+  c.sf_cnt++;
+  if (c.sf_cnt == c.nof_sf) {
+    c.sf_cnt = 0;
+  }
+
+  // The job is handed over as soon as it has all the samples, without waiting for the end of the opportunity
+  if (c.job && c.job->nof_samples == c.len) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      jobs.push_back(c.job);
+      metrics.queue_depth     = SRSLTE_VEC_CMA((float)jobs.size(), metrics.queue_depth, metrics.nof_opportunities);
+      metrics.max_queue_depth = SRSLTE_MAX(metrics.max_queue_depth, (uint32_t)jobs.size());
+      metrics.nof_opportunities++;
     }
+    pending_jobs.push(c.job);
+    c.job = nullptr;
   }
-  return 0;
+
+  return SRSLTE_SUCCESS;
 }
 
-int prach_worker::run_tti(sf_buffer* b)
+prach_job* prach_worker_pool::wait_job()
 {
-  if (srslte_prach_tti_opportunity(&prach, b->tti, -1)) {
-    // Detect possible PRACHs
-    if (srslte_prach_detect_offset(&prach,
-                                   prach_cfg.freq_offset,
-                                   &b->samples[prach.N_cp],
-                                   nof_sf * SRSLTE_SF_LEN_PRB(cell.nof_prb) - prach.N_cp,
-                                   prach_indices,
-                                   prach_offsets,
-                                   prach_p2avg,
-                                   &prach_nof_det)) {
-      log_h->error("Error detecting PRACH\n");
-      return SRSLTE_ERROR;
+  return pending_jobs.wait_pop();
+}
+
+void prach_worker_pool::job_done(prach_job* job)
+{
+  std::unique_lock<std::mutex> lock(mutex);
+
+  job->done = true;
+
+  // The detections are reported in reception order, so they wait for the opportunities received before them. A single
+  // thread reports at a time, the others leave their finished opportunities to it and go back to detection
+  if (reporting) {
+    return;
+  }
+  reporting = true;
+
+  while (!jobs.empty() && jobs.front()->done) {
+    while (!jobs.empty() && jobs.front()->done) {
+      report_jobs.push_back(jobs.front());
+      jobs.pop_front();
     }
 
-    if (prach_nof_det) {
-      for (uint32_t i = 0; i < prach_nof_det; i++) {
-        log_h->info("PRACH: cc=%d, %d/%d, preamble=%d, offset=%.1f us, peak2avg=%.1f, max_offset=%.1f us\n",
-                    cc_idx,
-                    i,
-                    prach_nof_det,
-                    prach_indices[i],
-                    prach_offsets[i] * 1e6,
-                    prach_p2avg[i],
-                    max_prach_offset_us);
-
-        if (prach_offsets[i] * 1e6 < max_prach_offset_us) {
-          stack->rach_detected(b->tti, cc_idx, prach_indices[i], (uint32_t)(prach_offsets[i] * 1e6));
-        }
-      }
+    // The stack is called without the mutex, the detection threads keep handing over finished opportunities meanwhile
+    lock.unlock();
+    uint32_t nof_misses = 0;
+    for (prach_job* j : report_jobs) {
+      nof_misses += job_report(j) ? 1 : 0;
+      j->reset();
+      job_pool->deallocate(j);
     }
+    report_jobs.clear();
+    lock.lock();
+
+    metrics.deadline_misses += nof_misses;
   }
-  return 0;
+
+  reporting = false;
 }
 
-void prach_worker::run_thread()
+/* Reports the preambles of an opportunity to the stack, returns true if it is too late for a RAR in the window */
+bool prach_worker_pool::job_report(prach_job* job)
 {
-  running = true;
-  while (running) {
-    sf_buffer* b = pending_buffers.wait_pop();
-    if (running && b) {
-      int ret = run_tti(b);
-      b->reset();
-      buffer_pool.deallocate(b);
-      if (ret) {
-        running = false;
-      }
+  const prach_carrier& c = carriers[job->cc_idx];
+
+  // The RAR is sent FDD_HARQ_DELAY_UL_MS after the last received TTI, and the RAR window starts 3 subframes after the
+  // PRACH
+  bool late = TTI_SUB(last_tti.load(), job->tti) + FDD_HARQ_DELAY_UL_MS >= 3 + c.rar_window;
+
+  for (uint32_t i = 0; i < job->nof_det; i++) {
+    log_h->info("PRACH: cc=%d, %d/%d, preamble=%d, offset=%.1f us, peak2avg=%.1f, max_offset=%.1f us\n",
+                job->cc_idx,
+                i,
+                job->nof_det,
+                job->indices[i],
+                job->offsets[i] * 1e6,
+                job->p2avg[i],
+                max_prach_offset_us);
+
+    if (job->offsets[i] * 1e6 < max_prach_offset_us) {
+      stack->rach_detected(job->tti, job->cc_idx, job->indices[i], (uint32_t)(job->offsets[i] * 1e6));
     }
   }
+
+  return late;
+}
+
+void prach_worker_pool::get_metrics(prach_metrics_t* metrics_)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  *metrics_ = metrics;
+  metrics   = {};
 }
 
 } // namespace srsenb
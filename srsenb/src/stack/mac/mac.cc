@@ -91,6 +91,15 @@ bool mac::init(const mac_args_t&        args_,
       srslte_softbuffer_tx_init(&cc.rar_softbuffer_tx, args.nof_prb);
     }
 
+    // Init pool of Rx code block buffers
+    if (args.rx_softbuffer_pool_size > 0) {
+      if (srslte_softbuffer_pool_init(&rx_softbuffer_pool, args.rx_softbuffer_pool_size)) {
+        log_h->error("Initiating Rx softbuffer pool\n");
+        return false;
+      }
+      log_h->info("Rx softbuffer pool of up to %d code block buffers\n", args.rx_softbuffer_pool_size);
+    }
+
     reset();
 
     started = true;
@@ -104,6 +113,9 @@ void mac::stop()
   srslte::rwlock_write_guard lock(rwlock);
   if (started) {
     ue_db.clear();
+    if (args.rx_softbuffer_pool_size > 0) {
+      srslte_softbuffer_pool_free(&rx_softbuffer_pool);
+    }
     for (auto& cc : common_buffers) {
       for (int i = 0; i < NOF_BCCH_DLSCH_MSG; i++) {
         srslte_softbuffer_tx_free(&cc.bcch_softbuffer_tx[i]);
@@ -280,6 +292,16 @@ int mac::cell_cfg(const std::vector<sched_interface::cell_cfg_t>& cell_cfg_)
   return scheduler.cell_cfg(cell_config);
 }
 
+int mac::set_sib_len(uint32_t enb_cc_idx, uint32_t sib_idx, uint32_t len)
+{
+  srslte::rwlock_write_guard lock(rwlock);
+  if (enb_cc_idx >= cell_config.size() or sib_idx >= sched_interface::MAX_SIBS) {
+    return SRSLTE_ERROR;
+  }
+  cell_config[enb_cc_idx].sibs[sib_idx].len = len;
+  return scheduler.set_sib_len(enb_cc_idx, sib_idx, len);
+}
+
 void mac::get_metrics(mac_metrics_t metrics[ENB_METRICS_MAX_USERS])
 {
   srslte::rwlock_read_guard lock(rwlock);
@@ -490,7 +512,17 @@ void mac::rach_detected(uint32_t tti, uint32_t enb_cc_idx, uint32_t preamble_idx
   uint16_t rnti = allocate_rnti();
 
   // Create new UE
-  std::unique_ptr<ue> ue_ptr{new ue(rnti, args.nof_prb, &scheduler, rrc_h, rlc_h, phy_h, log_h, cells.size())};
+  std::unique_ptr<ue> ue_ptr{new ue(rnti,
+                                    args.nof_prb,
+                                    &scheduler,
+                                    rrc_h,
+                                    rlc_h,
+                                    phy_h,
+                                    log_h,
+                                    cells.size(),
+                                    SRSLTE_FDD_NOF_HARQ,
+                                    SRSLTE_FDD_NOF_HARQ * SRSLTE_MAX_TB,
+                                    args.rx_softbuffer_pool_size > 0 ? &rx_softbuffer_pool : nullptr)};
 
   // Set PCAP if available
   if (pcap != nullptr) {
@@ -642,7 +674,7 @@ int mac::get_dl_sched(uint32_t tti_tx_dl, dl_sched_list_t& dl_sched_res_list)
       if (sched_result.bc[i].type == sched_interface::dl_sched_bc_t::BCCH) {
         dl_sched_res->pdsch[n].softbuffer_tx[0] =
             &common_buffers[enb_cc_idx].bcch_softbuffer_tx[sched_result.bc[i].index];
-        dl_sched_res->pdsch[n].data[0] = rrc_h->read_pdu_bcch_dlsch(enb_cc_idx, sched_result.bc[i].index);
+        dl_sched_res->pdsch[n].data[0] = rrc_h->read_pdu_bcch_dlsch(enb_cc_idx, sched_result.bc[i].index, tti_tx_dl);
 #ifdef WRITE_SIB_PCAP
         if (pcap) {
           pcap->write_dl_sirnti(dl_sched_res->pdsch[n].data[0], sched_result.bc[i].tbs, true, tti_tx_dl, enb_cc_idx);
@@ -32,6 +32,9 @@
 
 namespace srsenb {
 
+// Max code rate of BC allocations. Kept below the 0.93 limit of TS 36.213 Sec. 7.1.7, so that cell-edge UEs decode SI
+constexpr float max_bc_coderate = 0.75;
+
 namespace sched_utils {
 
 uint32_t tti_subtract(uint32_t tti1, uint32_t tti2)
@@ -126,9 +129,47 @@ bool sched_cell_params_t::set_cfg(uint32_t                             enb_cc_id
   P        = srslte_ra_type0_P(cfg.cell.nof_prb);
   nof_rbgs = srslte::ceil_div(cfg.cell.nof_prb, P);
 
+  // precompute the capacity of BC allocations (QPSK) for each nof RBGs. Computed for highest CFI and for a subframe
+  // without PBCH/PSS/SSS, as SI messages other than SIB1 are not scheduled in subframes #0 and #5
+  srslte_pdsch_grant_t grant = {};
+  srslte_dl_sf_cfg_t   dl_sf = {};
+  dl_sf.cfi                  = sched_cfg->max_nof_ctrl_symbols;
+  dl_sf.tti                  = 1;
+  bc_max_tbs_bits.assign(nof_rbgs + 1, 0);
+  for (uint32_t n = 1; n <= nof_rbgs; ++n) {
+    for (uint32_t prb = (n - 1) * P; prb < SRSLTE_MIN(n * P, cfg.cell.nof_prb); ++prb) {
+      grant.prb_idx[0][prb] = true;
+      grant.prb_idx[1][prb] = true;
+    }
+    uint32_t nof_re    = srslte_ra_dl_grant_nof_re(&cfg.cell, &dl_sf, &grant);
+    bc_max_tbs_bits[n] = (uint32_t)(max_bc_coderate * nof_re * 2) - 24; // QPSK, without the TB CRC
+  }
+
   return true;
 }
 
+/**
+ * Compute the number of RBGs required to transmit a BC/PCCH message without exceeding the max BC code rate. SIB1 and
+ * small SI messages keep the minimum allocation of 4 PRBs
+ * @param req_bytes length of the message in bytes
+ * @return number of RBGs, or 0 if the message does not fit in the cell bandwidth
+ */
+uint32_t sched_cell_params_t::get_dl_bc_nof_rbgs(uint32_t req_bytes) const
+{
+  uint32_t n_prb1a = 2;
+  int      tbs_idx = sched_utils::get_format1a_tbs_idx(req_bytes, &n_prb1a);
+  if (tbs_idx < 0) {
+    return 0;
+  }
+  uint32_t tbs = (uint32_t)srslte_ra_tbs_from_idx((uint32_t)tbs_idx, n_prb1a);
+  for (uint32_t n = srslte::ceil_div(4, P); n <= nof_rbgs; ++n) {
+    if (bc_max_tbs_bits[n] >= tbs) {
+      return n;
+    }
+  }
+  return 0;
+}
+
 /*******************************************************
  *
  * Initialization and sched configuration functions
@@ -341,6 +382,18 @@ void sched::set_dl_tti_mask(uint8_t* tti_mask, uint32_t nof_sfs)
   carrier_schedulers[0]->set_dl_tti_mask(tti_mask, nof_sfs);
 }
 
+//! Updates the SI message length in place, the SI windows in progress are kept
+int sched::set_sib_len(uint32_t enb_cc_idx, uint32_t sib_idx, uint32_t len)
+{
+  std::lock_guard<std::mutex> lock(sched_mutex);
+  if (enb_cc_idx >= sched_cell_params.size() or sib_idx >= MAX_SIBS) {
+    Error("SCHED: Invalid SI message index=%d for enb_cc_idx=%d\n", sib_idx, enb_cc_idx);
+    return SRSLTE_ERROR;
+  }
+  sched_cell_params[enb_cc_idx].cfg.sibs[sib_idx].len = len;
+  return SRSLTE_SUCCESS;
+}
+
 void sched::tpc_inc(uint16_t rnti)
 {
   ue_db_access(rnti, [](sched_ue& ue) { ue.tpc_inc(); }, __PRETTY_FUNCTION__);
@@ -473,6 +526,22 @@ prb_range_t prb_range_t::riv_to_prbs(uint32_t riv, uint32_t nof_prbs, int nof_vr
 
 namespace sched_utils {
 
+int get_format1a_tbs_idx(uint32_t req_bytes, uint32_t* n_prb1a)
+{
+  int tbs = req_bytes * 8;
+  for (int i = 0; i < 27; i++) {
+    if (srslte_ra_tbs_from_idx(i, 2) >= tbs) {
+      *n_prb1a = 2;
+      return i;
+    }
+    if (srslte_ra_tbs_from_idx(i, 3) >= tbs) {
+      *n_prb1a = 3;
+      return i;
+    }
+  }
+  return -1;
+}
+
 void generate_cce_location(srslte_regs_t*   regs_,
                            sched_dci_cce_t* location,
                            uint32_t         cfi,
@@ -30,7 +30,17 @@ namespace srsenb {
  *        Broadcast (SIB+Paging) scheduling
  *******************************************************/
 
-bc_sched::bc_sched(const sched_cell_params_t& cfg_, srsenb::rrc_interface_mac* rrc_) : cc_cfg(&cfg_), rrc(rrc_) {}
+//! Number of transmissions of an SI message (other than SIB1) within its SI-window
+static uint32_t get_nof_si_tx(uint32_t si_window_ms)
+{
+  return SRSLTE_MIN(srslte::ceil_div(si_window_ms, 10), 4);
+}
+
+bc_sched::bc_sched(const sched_cell_params_t& cfg_, srsenb::rrc_interface_mac* rrc_) :
+  cc_cfg(&cfg_),
+  rrc(rrc_),
+  log_h(srslte::logmap::get("MAC"))
+{}
 
 void bc_sched::dl_sched(sf_sched* tti_sched)
 {
@@ -71,11 +81,21 @@ void bc_sched::update_si_windows(sf_sched* tti_sched)
         pending_sibs[i].is_in_window = true;
         pending_sibs[i].window_start = tti_tx_dl;
         pending_sibs[i].n_tx         = 0;
+        si_stats[i].nof_windows++;
       }
     } else {
       if (i > 0) {
         if (srslte_tti_interval(tti_tx_dl, pending_sibs[i].window_start) > cc_cfg->cfg.si_window_ms) {
           // the si window has passed
+          uint32_t nof_tx = get_nof_si_tx(cc_cfg->cfg.si_window_ms);
+          if (pending_sibs[i].n_tx < nof_tx) {
+            si_stats[i].nof_missed++;
+            log_h->warning("SCHED: Only %d/%d transmissions of SI message #%d, len=%d, were allocated in window\n",
+                           pending_sibs[i].n_tx,
+                           nof_tx,
+                           i + 1,
+                           cc_cfg->cfg.sibs[i].len);
+          }
           pending_sibs[i] = {};
         }
       } else {
@@ -95,20 +115,32 @@ void bc_sched::alloc_sibs(sf_sched* tti_sched)
 
   for (uint32_t i = 0; i < pending_sibs.size(); i++) {
     if (cc_cfg->cfg.sibs[i].len > 0 and pending_sibs[i].is_in_window and pending_sibs[i].n_tx < 4) {
-      uint32_t nof_tx = (i > 0) ? SRSLTE_MIN(srslte::ceil_div(cc_cfg->cfg.si_window_ms, 10), 4) : 4;
+      uint32_t nof_tx = (i > 0) ? get_nof_si_tx(cc_cfg->cfg.si_window_ms) : 4;
       uint32_t n_sf   = (tti_sched->get_tti_tx_dl() - pending_sibs[i].window_start);
 
-      // Check if there is any SIB to tx
-      bool sib1_flag = (i == 0) and (current_sfn % 2) == 0 and current_sf_idx == 5;
-      bool other_sibs_flag =
-          (i > 0) and (n_sf >= (cc_cfg->cfg.si_window_ms / nof_tx) * pending_sibs[i].n_tx) and current_sf_idx == 9;
+      // Check if there is any SIB to tx. The transmissions of an SI message are spread evenly over its SI-window. If
+      // one cannot be allocated, it is retried in the next subframe, instead of being postponed to the next SI-window.
+      // Subframes #0 and #5 are avoided, as their PBCH and synchronization signals lower the PDSCH capacity
+      bool sib1_flag       = (i == 0) and (current_sfn % 2) == 0 and current_sf_idx == 5;
+      bool other_sibs_flag = (i > 0) and pending_sibs[i].n_tx < nof_tx and
+                             n_sf >= (cc_cfg->cfg.si_window_ms / nof_tx) * pending_sibs[i].n_tx and
+                             current_sf_idx != 0 and current_sf_idx != 5;
       if (not sib1_flag and not other_sibs_flag) {
         continue;
       }
 
       // Schedule SIB
-      tti_sched->alloc_bc(bc_aggr_level, i, pending_sibs[i].n_tx);
+      if (not tti_sched->alloc_bc(bc_aggr_level, i, pending_sibs[i].n_tx)) {
+        si_stats[i].nof_alloc_fails++;
+        if (i == 0) {
+          // SIB1 has a fixed schedule
+          pending_sibs[i].n_tx++;
+        }
+        continue;
+      }
       pending_sibs[i].n_tx++;
+      si_stats[i].nof_tx++;
+      si_stats[i].nof_rbgs = cc_cfg->get_dl_bc_nof_rbgs(cc_cfg->cfg.sibs[i].len);
     }
   }
 }
@@ -129,6 +161,9 @@ void bc_sched::reset()
   for (auto& sib : pending_sibs) {
     sib = {};
   }
+  for (auto& stats : si_stats) {
+    stats = {};
+  }
 }
 
 /*******************************************************
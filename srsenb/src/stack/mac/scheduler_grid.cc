@@ -328,7 +328,6 @@ void sf_grid_t::init(const sched_cell_params_t& cell_params_)
   cc_cfg    = &cell_params_;
   log_h     = srslte::logmap::get("MAC ");
   nof_rbgs  = cc_cfg->nof_rbgs;
-  si_n_rbg  = srslte::ceil_div(4, cc_cfg->P);
   rar_n_rbg = srslte::ceil_div(3, cc_cfg->P);
 
   dl_mask.resize(nof_rbgs);
@@ -377,17 +376,23 @@ alloc_outcome_t sf_grid_t::alloc_dl(uint32_t aggr_idx, alloc_type_t alloc_type,
 }
 
 //! Allocates CCEs and RBs for control allocs. It allocates RBs in a contiguous manner.
-sf_grid_t::dl_ctrl_alloc_t sf_grid_t::alloc_dl_ctrl(uint32_t aggr_idx, alloc_type_t alloc_type)
+//! BC/PCCH allocations are sized from the message length, so that large SI messages keep a decodable code rate.
+sf_grid_t::dl_ctrl_alloc_t sf_grid_t::alloc_dl_ctrl(uint32_t aggr_idx, uint32_t req_bytes, alloc_type_t alloc_type)
 {
   rbg_range_t range;
   range.rbg_min = nof_rbgs - avail_rbg;
-  range.rbg_max = range.rbg_min + ((alloc_type == alloc_type_t::DL_RAR) ? rar_n_rbg : si_n_rbg);
 
   if (alloc_type != alloc_type_t::DL_RAR and alloc_type != alloc_type_t::DL_BC and
       alloc_type != alloc_type_t::DL_PCCH) {
     log_h->error("SCHED: DL control allocations must be RAR/BC/PDCCH\n");
     return {alloc_outcome_t::ERROR, range};
   }
+  uint32_t nof_ctrl_rbgs = (alloc_type == alloc_type_t::DL_RAR) ? rar_n_rbg : cc_cfg->get_dl_bc_nof_rbgs(req_bytes);
+  if (nof_ctrl_rbgs == 0) {
+    log_h->error("SCHED: BC message with len=%d does not fit in the cell bandwidth\n", req_bytes);
+    return {alloc_outcome_t::ERROR, range};
+  }
+  range.rbg_max = range.rbg_min + nof_ctrl_rbgs;
   // Setup range starting from left
   if (range.rbg_max > nof_rbgs) {
     return {alloc_outcome_t::RB_COLLISION, range};
@@ -525,7 +530,7 @@ sf_sched::ctrl_code_t sf_sched::alloc_dl_ctrl(uint32_t aggr_lvl, uint32_t tbs_by
   }
 
   /* Allocate space in the DL RBG and PDCCH grids */
-  sf_grid_t::dl_ctrl_alloc_t ret = tti_alloc.alloc_dl_ctrl(aggr_lvl, alloc_type);
+  sf_grid_t::dl_ctrl_alloc_t ret = tti_alloc.alloc_dl_ctrl(aggr_lvl, tbs_bytes, alloc_type);
   if (not ret.outcome) {
     return {ret.outcome, ctrl_alloc};
   }
@@ -755,6 +760,7 @@ void sf_sched::set_bc_sched_result(const pdcch_grid_t::alloc_result_t& dci_resul
 
     /* Generate DCI format1A */
     prb_range_t prb_range = prb_range_t::rbgs_to_prbs(bc_alloc.rbg_range, cc_cfg->P);
+    prb_range.prb_max     = SRSLTE_MIN(prb_range.prb_max, cc_cfg->nof_prb()); // the last RBG may be smaller than P
     int         tbs       = generate_format1a(
         prb_range.prb_min, prb_range.nof_prbs(), bc_alloc.req_bytes, bc_alloc.rv, bc_alloc.rnti, &bc->dci);
 
@@ -1026,27 +1032,15 @@ int sf_sched::generate_format1a(uint32_t         rb_start,
                                 srslte_dci_dl_t* dci)
 {
   /* Calculate I_tbs for this TBS */
-  int tbs = tbs_bytes * 8;
-  int i;
-  int mcs = -1;
-  for (i = 0; i < 27; i++) {
-    if (srslte_ra_tbs_from_idx(i, 2) >= tbs) {
-      dci->type2_alloc.n_prb1a = srslte_ra_type2_t::SRSLTE_RA_TYPE2_NPRB1A_2;
-      mcs                      = i;
-      tbs                      = srslte_ra_tbs_from_idx(i, 2);
-      break;
-    }
-    if (srslte_ra_tbs_from_idx(i, 3) >= tbs) {
-      dci->type2_alloc.n_prb1a = srslte_ra_type2_t::SRSLTE_RA_TYPE2_NPRB1A_3;
-      mcs                      = i;
-      tbs                      = srslte_ra_tbs_from_idx(i, 3);
-      break;
-    }
-  }
-  if (i == 28) {
-    Error("Can't allocate Format 1A for TBS=%d\n", tbs);
+  uint32_t n_prb1a = 2;
+  int      mcs     = sched_utils::get_format1a_tbs_idx(tbs_bytes, &n_prb1a);
+  if (mcs < 0) {
+    Error("Can't allocate Format 1A for TBS=%d\n", tbs_bytes * 8);
     return -1;
   }
+  int tbs                  = srslte_ra_tbs_from_idx((uint32_t)mcs, n_prb1a);
+  dci->type2_alloc.n_prb1a = (n_prb1a == 2) ? srslte_ra_type2_t::SRSLTE_RA_TYPE2_NPRB1A_2
+                                            : srslte_ra_type2_t::SRSLTE_RA_TYPE2_NPRB1A_3;
 
   Debug("ra_tbs=%d/%d, tbs_bytes=%d, tbs=%d, mcs=%d\n",
         srslte_ra_tbs_from_idx(mcs, 2),
@@ -30,16 +30,17 @@
 
 namespace srsenb {
 
-ue::ue(uint16_t                 rnti_,
-       uint32_t                 nof_prb_,
-       sched_interface*         sched_,
-       rrc_interface_mac*       rrc_,
-       rlc_interface_mac*       rlc_,
-       phy_interface_stack_lte* phy_,
-       srslte::log_ref          log_,
-       uint32_t                 nof_cells_,
-       uint32_t                 nof_rx_harq_proc_,
-       uint32_t                 nof_tx_harq_proc_) :
+ue::ue(uint16_t                  rnti_,
+       uint32_t                  nof_prb_,
+       sched_interface*          sched_,
+       rrc_interface_mac*        rrc_,
+       rlc_interface_mac*        rlc_,
+       phy_interface_stack_lte*  phy_,
+       srslte::log_ref           log_,
+       uint32_t                  nof_cells_,
+       uint32_t                  nof_rx_harq_proc_,
+       uint32_t                  nof_tx_harq_proc_,
+       srslte_softbuffer_pool_t* rx_softbuffer_pool_) :
   rnti(rnti_),
   nof_prb(nof_prb_),
   sched(sched_),
@@ -53,6 +54,7 @@ ue::ue(uint16_t                 rnti_,
   pdus(128),
   nof_rx_harq_proc(nof_rx_harq_proc_),
   nof_tx_harq_proc(nof_tx_harq_proc_),
+  rx_softbuffer_pool(rx_softbuffer_pool_),
   ta_fsm(this)
 {
   srslte::byte_buffer_pool* pool = srslte::byte_buffer_pool::get_instance();
@@ -78,14 +80,14 @@ ue::ue(uint16_t                 rnti_,
 ue::~ue()
 {
   // Free up all softbuffers for all CCs
-  for (auto cc : softbuffer_rx) {
-    for (auto buffer : cc) {
+  for (auto& cc : softbuffer_rx) {
+    for (auto& buffer : cc) {
       srslte_softbuffer_rx_free(&buffer);
     }
   }
 
-  for (auto cc : softbuffer_tx) {
-    for (auto buffer : cc) {
+  for (auto& cc : softbuffer_tx) {
+    for (auto& buffer : cc) {
       srslte_softbuffer_tx_free(&buffer);
     }
   }
@@ -96,14 +98,14 @@ void ue::reset()
   metrics      = {};
   nof_failures = 0;
 
-  for (auto cc : softbuffer_rx) {
-    for (auto buffer : cc) {
+  for (auto& cc : softbuffer_rx) {
+    for (auto& buffer : cc) {
       srslte_softbuffer_rx_reset(&buffer);
     }
   }
 
-  for (auto cc : softbuffer_tx) {
-    for (auto buffer : cc) {
+  for (auto& cc : softbuffer_tx) {
+    for (auto& buffer : cc) {
       srslte_softbuffer_tx_reset(&buffer);
     }
   }
@@ -124,7 +126,11 @@ uint32_t ue::allocate_cc_buffers(const uint32_t num_cc)
     softbuffer_rx.emplace_back();
     softbuffer_rx.back().resize(nof_rx_harq_proc);
     for (auto& buffer : softbuffer_rx.back()) {
-      srslte_softbuffer_rx_init(&buffer, nof_prb);
+      if (rx_softbuffer_pool != nullptr) {
+        srslte_softbuffer_rx_init_pool(&buffer, nof_prb, rx_softbuffer_pool);
+      } else {
+        srslte_softbuffer_rx_init(&buffer, nof_prb);
+      }
     }
 
     pending_buffers.emplace_back();
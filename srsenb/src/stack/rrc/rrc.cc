@@ -37,10 +37,7 @@ using namespace asn1::rrc;
 
 namespace srsenb {
 
-rrc::rrc() : rrc_log("RRC")
-{
-  pending_paging.clear();
-}
+rrc::rrc() : rrc_log("RRC") {}
 
 rrc::~rrc() {}
 
@@ -77,6 +74,7 @@ void rrc::init(const rrc_cfg_t&       cfg_,
 
   nof_si_messages = generate_sibs();
   config_mac();
+  init_paging_calendar();
   enb_mobility_cfg.reset(new enb_mobility_handler(this));
 
   running = true;
@@ -114,10 +112,22 @@ void rrc::get_metrics(rrc_metrics_t& m)
   to the queue and process later
 *******************************************************************************/
 
-uint8_t* rrc::read_pdu_bcch_dlsch(const uint8_t cc_idx, const uint32_t sib_index)
+uint8_t* rrc::read_pdu_bcch_dlsch(const uint8_t cc_idx, const uint32_t sib_index, const uint32_t tti)
 {
   if (sib_index < ASN1_RRC_MAX_SIB && cc_idx < cell_common_list->nof_cells()) {
-    return &cell_common_list->get_cc_idx(cc_idx)->sib_buffer.at(sib_index)[0];
+    cell_info_common* cell_ctxt = cell_common_list->get_cc_idx(cc_idx);
+    if ((warning_tx_pending.load(std::memory_order_relaxed) & (1u << cc_idx)) > 0 and
+        (warning_si_mask.load() & (1u << sib_index)) > 0) {
+      report_warning_tx(cc_idx, sib_index, tti);
+    }
+    // The SI message carrying SIB12 rotates through the pre-packed CMAS segments, one per SI-window
+    if (cell_ctxt->cmas_ring != nullptr and sib_index == cell_ctxt->cmas_si_idx) {
+      uint8_t* segment = cell_ctxt->cmas_ring->read_pdu(tti);
+      if (segment != nullptr) {
+        return segment;
+      }
+    }
+    return cell_ctxt->sib_buffer.at(sib_index).read(tti);
   }
   return nullptr;
 }
@@ -446,14 +456,50 @@ bool rrc::release_erabs(uint32_t rnti)
   than user map
 *******************************************************************************/
 
-void rrc::add_paging_id(uint32_t ueid, const asn1::s1ap::ue_paging_id_c& ue_paging_id)
+/* Derives the paging frames and occasions of the cell from SIB2 (36.304 Section 7), and sizes the PO calendar to one
+ * paging cycle, as the POs of every UE_ID repeat with period T */
+void rrc::init_paging_calendar()
 {
+  constexpr static int sf_pattern[4][4] = {{9, 4, -1, 0}, {-1, 9, -1, 4}, {-1, -1, -1, 5}, {-1, -1, -1, 9}};
+
+  // Default paging cycle, should get DRX from user
+  paging_T    = cfg.sibs[1].sib2().rr_cfg_common.pcch_cfg.default_paging_cycle.to_number();
+  uint32_t Nb = paging_T * cfg.sibs[1].sib2().rr_cfg_common.pcch_cfg.nb.to_number();
+
+  paging_N  = paging_T < Nb ? paging_T : Nb;
+  paging_Ns = Nb / paging_T > 1 ? Nb / paging_T : 1;
+
+  paging_po_sf_mask = 0;
+  for (uint32_t i_s = 0; i_s < paging_Ns; ++i_s) {
+    int sf_idx = sf_pattern[i_s % 4][(paging_Ns - 1) % 4];
+    if (sf_idx < 0) {
+      rrc_log->error("SF pattern is N/A for Ns=%d, i_s=%d\n", paging_Ns, i_s);
+      continue;
+    }
+    paging_po_sf[i_s] = (uint32_t)sf_idx;
+    paging_po_sf_mask |= 1u << (uint32_t)sf_idx;
+  }
+
   std::lock_guard<std::mutex> lock(paging_mutex);
-  if (pending_paging.count(ueid) > 0) {
-    rrc_log->warning("Received Paging for UEID=%d but not yet transmitted\n", ueid);
-    return;
+  paging_calendar.clear();
+  paging_calendar.resize(paging_T * 10);
+  nof_pending_paging = 0;
+}
+
+static bool is_same_paging_id(const paging_ue_id_c& a, const paging_ue_id_c& b)
+{
+  if (a.type() != b.type()) {
+    return false;
+  }
+  if (a.type().value == paging_ue_id_c::types_opts::s_tmsi) {
+    return a.s_tmsi().mmec == b.s_tmsi().mmec and a.s_tmsi().m_tmsi == b.s_tmsi().m_tmsi;
   }
+  return a.type().value == paging_ue_id_c::types_opts::imsi and a.imsi().size() == b.imsi().size() and
+         std::equal(a.imsi().begin(), a.imsi().end(), b.imsi().begin());
+}
 
+void rrc::add_paging_id(uint32_t ueid, const asn1::s1ap::ue_paging_id_c& ue_paging_id)
+{
   paging_record_s paging_elem;
   if (ue_paging_id.type().value == asn1::s1ap::ue_paging_id_c::types_opts::imsi) {
     paging_elem.ue_id.set_imsi();
@@ -472,105 +518,152 @@ void rrc::add_paging_id(uint32_t ueid, const asn1::s1ap::ue_paging_id_c& ue_pagi
   }
   paging_elem.cn_domain = paging_record_s::cn_domain_e_::ps;
 
-  pending_paging.insert(std::make_pair(ueid, paging_elem));
+  // PF and PO of the UE, i.e. its slot in the calendar
+  ueid %= 1024;
+  uint32_t pf       = (paging_T / paging_N) * (ueid % paging_N);
+  uint32_t i_s      = (ueid / paging_N) % paging_Ns;
+  uint32_t slot_idx = pf * 10 + paging_po_sf[i_s];
+
+  std::lock_guard<std::mutex> lock(paging_mutex);
+  if (slot_idx >= paging_calendar.size()) {
+    rrc_log->error("Received Paging for UEID=%d before the paging configuration\n", ueid);
+    return;
+  }
+  std::vector<pending_paging_t>& slot = paging_calendar[slot_idx];
+  for (const pending_paging_t& p : slot) {
+    if (is_same_paging_id(p.record.ue_id, paging_elem.ue_id)) {
+      rrc_log->warning("Received Paging for UEID=%d but not yet transmitted\n", ueid);
+      return;
+    }
+  }
+  slot.push_back({ueid, std::move(paging_elem)});
+  nof_pending_paging++;
 }
 
 // Described in Section 7 of 36.304
 bool rrc::is_paging_opportunity(uint32_t tti, uint32_t* payload_len)
 {
-  constexpr static int sf_pattern[4][4] = {{9, 4, -1, 0}, {-1, 9, -1, 4}, {-1, -1, -1, 5}, {-1, -1, -1, 9}};
-
-  if (pending_paging.empty()) {
-    return false;
-  }
-
-  asn1::rrc::pcch_msg_s pcch_msg;
-  pcch_msg.msg.set_c1();
-  paging_s* paging_rec = &pcch_msg.msg.c1().paging();
-  paging_v920_ies_s paging_rec_v920; 
-  paging_v890_ies_s paging_rec_v890;
-
-  // Default paging cycle, should get DRX from user
-  uint32_t T  = cfg.sibs[1].sib2().rr_cfg_common.pcch_cfg.default_paging_cycle.to_number();
-  uint32_t Nb = T * cfg.sibs[1].sib2().rr_cfg_common.pcch_cfg.nb.to_number();
-
-  uint32_t N   = T < Nb ? T : Nb;
-  uint32_t Ns  = Nb / T > 1 ? Nb / T : 1;
   uint32_t sfn = tti / 10;
+  uint32_t sf  = tti % 10;
 
-  std::vector<uint32_t> ue_to_remove;
+  std::lock_guard<std::mutex> lock(paging_mutex);
 
-  {
-    std::lock_guard<std::mutex> lock(paging_mutex);
+  // Count the radio frames of the warning notification period. Each carrier calls this function in the same TTI
+  if (sfn != warning_paging_sfn) {
+    warning_paging_sfn      = sfn;
+    warning_paging_in_frame = warning_paging_frames_left > 0;
+    if (warning_paging_in_frame) {
+      warning_paging_frames_left--;
+    }
+  }
 
-    int n = 0;
-    for (auto& item : pending_paging) {
-      if (n >= ASN1_RRC_MAX_PAGE_REC) {
-        break;
+  // The cell paging frames are those of any UE_ID, i.e. SFN mod (T/N) = 0, and the POs are those of any i_s
+  bool warning_po = warning_paging_in_frame and (sfn % (paging_T / paging_N)) == 0 and
+                    ((paging_po_sf_mask >> sf) & 1u) > 0;
+
+  if (nof_pending_paging > 0 and not paging_calendar.empty()) {
+    std::vector<pending_paging_t>& slot = paging_calendar[(sfn % paging_T) * 10 + sf];
+    if (not slot.empty()) {
+      // Records beyond the maximum are left for the next paging cycle
+      uint32_t n = std::min((uint32_t)slot.size(), (uint32_t)ASN1_RRC_MAX_PAGE_REC);
+
+      asn1::rrc::pcch_msg_s pcch_msg;
+      pcch_msg.msg.set_c1();
+      paging_s* paging_rec                   = &pcch_msg.msg.c1().paging();
+      paging_rec->paging_record_list_present = true;
+      paging_rec->paging_record_list.resize(n);
+      for (uint32_t i = 0; i < n; ++i) {
+        paging_rec->paging_record_list[i] = std::move(slot[i].record);
+        rrc_log->info("Assembled paging for ue_id=%d, tti=%d\n", slot[i].ueid, tti);
       }
-      const asn1::rrc::paging_record_s& u    = item.second;
-      uint32_t                          ueid = ((uint32_t)item.first) % 1024;
-      uint32_t                          i_s  = (ueid / N) % Ns;
+      slot.erase(slot.begin(), slot.begin() + n);
+      nof_pending_paging -= n;
 
-      if ((sfn % T) != (T / N) * (ueid % N)) {
-        continue;
-      }
+      // Merge the notification about the public warning messages being broadcast
+      fill_warning_ind(paging_rec);
 
-      int sf_idx = sf_pattern[i_s % 4][(Ns - 1) % 4];
-      if (sf_idx < 0) {
-        rrc_log->error("SF pattern is N/A for Ns=%d, i_s=%d, imsi_decimal=%d\n", Ns, i_s, ueid);
-        continue;
+      byte_buf_paging.clear();
+      asn1::bit_ref bref(byte_buf_paging.msg, byte_buf_paging.get_tailroom());
+      if (pcch_msg.pack(bref) == asn1::SRSASN_ERROR_ENCODE_FAIL) {
+        rrc_log->error("Failed to pack PCCH\n");
+        return false;
       }
+      byte_buf_paging.N_bytes = (uint32_t)bref.distance_bytes();
+      uint32_t N_bits         = (uint32_t)bref.distance();
 
-      if ((uint32_t)sf_idx == (tti % 10)) {
-        paging_rec->paging_record_list_present = true;
-        //add sib10
-        paging_rec->etws_ind_present = true;
-        //add sib 12
-        paging_rec_v920.cmas_ind_r9_present = true;
-        paging_rec_v890.non_crit_ext_present = true;
-        paging_rec_v890.non_crit_ext = paging_rec_v920;
-        paging_rec->non_crit_ext_present = true;
-        paging_rec->non_crit_ext = paging_rec_v890;
-        //sib12 finish
-
-        paging_rec->paging_record_list.push_back(u);
-        ue_to_remove.push_back(ueid);
-        n++;
-        rrc_log->info("Assembled paging for ue_id=%d, tti=%d\n", ueid, tti);
+      if (payload_len) {
+        *payload_len = byte_buf_paging.N_bytes;
       }
-    }
+      rrc_log->info("Assembling PCCH payload with %d UE identities, payload_len=%d bytes, nbits=%d\n",
+                    paging_rec->paging_record_list.size(),
+                    byte_buf_paging.N_bytes,
+                    N_bits);
+      log_rrc_message("PCCH-Message", Tx, &byte_buf_paging, pcch_msg, pcch_msg.msg.c1().type().to_string());
 
-    for (unsigned int i : ue_to_remove) {
-      pending_paging.erase(i);
+      return true;
     }
   }
 
-  if (paging_rec->paging_record_list.size() > 0) {
+  if (warning_po) {
+    // No UE records in this PO. Send the pre-packed warning notification
     byte_buf_paging.clear();
-    asn1::bit_ref bref(byte_buf_paging.msg, byte_buf_paging.get_tailroom());
-    if (pcch_msg.pack(bref) == asn1::SRSASN_ERROR_ENCODE_FAIL) {
-      rrc_log->error("Failed to pack PCCH\n");
-      return false;
-    }
-    byte_buf_paging.N_bytes = (uint32_t)bref.distance_bytes();
-    uint32_t N_bits         = (uint32_t)bref.distance();
-
+    memcpy(byte_buf_paging.msg, warning_paging_buf.msg, warning_paging_buf.N_bytes);
+    byte_buf_paging.N_bytes = warning_paging_buf.N_bytes;
     if (payload_len) {
       *payload_len = byte_buf_paging.N_bytes;
     }
-    rrc_log->info("Assembling PCCH payload with %d UE identities, payload_len=%d bytes, nbits=%d\n",
-                  paging_rec->paging_record_list.size(),
-                  byte_buf_paging.N_bytes,
-                  N_bits);
-    log_rrc_message("PCCH-Message", Tx, &byte_buf_paging, pcch_msg, pcch_msg.msg.c1().type().to_string());
-
+    rrc_log->debug("Assembling PCCH payload with the warning indications, payload_len=%d bytes, tti=%d\n",
+                   byte_buf_paging.N_bytes,
+                   tti);
     return true;
   }
 
   return false;
 }
 
+/* Sets the ETWS and CMAS indications of a paging message. Called with the paging_mutex locked */
+void rrc::fill_warning_ind(asn1::rrc::paging_s* paging_rec) const
+{
+  paging_rec->etws_ind_present = etws_ind;
+  if (cmas_ind) {
+    paging_rec->non_crit_ext_present                          = true;
+    paging_rec->non_crit_ext.non_crit_ext_present             = true;
+    paging_rec->non_crit_ext.non_crit_ext.cmas_ind_r9_present = true;
+  }
+}
+
+/* Pre-packs the paging message that notifies all the UEs about the warning messages being broadcast. If restart is
+ * set, the notification is sent in every paging occasion of the cell during one modification period, so that idle
+ * UEs acquire the warning SIBs (36.331 Section 5.3.2.2). Called with the paging_mutex locked */
+void rrc::set_warning_paging(bool restart)
+{
+  if (not etws_ind and not cmas_ind) {
+    warning_paging_frames_left = 0;
+    return;
+  }
+
+  asn1::rrc::pcch_msg_s pcch_msg;
+  pcch_msg.msg.set_c1();
+  fill_warning_ind(&pcch_msg.msg.c1().paging());
+
+  warning_paging_buf.clear();
+  asn1::bit_ref bref(warning_paging_buf.msg, warning_paging_buf.get_tailroom());
+  if (pcch_msg.pack(bref) == asn1::SRSASN_ERROR_ENCODE_FAIL) {
+    rrc_log->error("Failed to pack PCCH with the warning indications\n");
+    warning_paging_frames_left = 0;
+    return;
+  }
+  warning_paging_buf.N_bytes = (uint32_t)bref.distance_bytes();
+
+  if (restart) {
+    const rr_cfg_common_sib_s& rr_cfg = cfg.sibs[1].sib2().rr_cfg_common;
+    warning_paging_frames_left =
+        rr_cfg.bcch_cfg.mod_period_coeff.to_number() * rr_cfg.pcch_cfg.default_paging_cycle.to_number();
+    rrc_log->info("Notifying the warning messages in all POs during %d radio frames\n", warning_paging_frames_left);
+  }
+  log_rrc_message("PCCH-Message", Tx, &warning_paging_buf, pcch_msg, pcch_msg.msg.c1().type().to_string());
+}
+
 void rrc::read_pdu_pcch(uint8_t* payload, uint32_t buffer_size)
 {
   std::lock_guard<std::mutex> lock(paging_mutex);
@@ -812,64 +905,590 @@ void rrc::config_mac()
 uint32_t rrc::generate_sibs()
 {
   // nof_messages includes SIB2 by default, plus all configured SIBs
-  uint32_t           nof_messages = 1 + cfg.sib1.sched_info_list.size();
-  sched_info_list_l& sched_info   = cfg.sib1.sched_info_list;
+  uint32_t nof_messages = 1 + cfg.sib1.sched_info_list.size();
 
   // Store configs,SIBs in common cell ctxt list
   cell_common_list.reset(new cell_info_common_list{cfg});
 
+  // SI message and position within it of the SIB12, if scheduled
+  uint32_t cmas_msg_idx = 0, cmas_sib_pos = 0;
+  bool     cmas_present = find_sib(sib_type_e::sib_type12_v920, &cmas_msg_idx, &cmas_sib_pos);
+
   // generate and pack into SIB buffers
   for (uint32_t cc_idx = 0; cc_idx < cfg.cell_list.size(); cc_idx++) {
     cell_info_common* cell_ctxt = cell_common_list->get_cc_idx(cc_idx);
+    cell_ctxt->sib_buffer.resize(nof_messages);
+
     // msg is array of SI messages, each SI message msg[i] may contain multiple SIBs
     // all SIBs in a SI message msg[i] share the same periodicity
-    asn1::dyn_array<bcch_dl_sch_msg_s> msg(nof_messages + 1);
+    asn1::dyn_array<bcch_dl_sch_msg_s> msg(nof_messages);
+    for (uint32_t msg_index = 0; msg_index < nof_messages; msg_index++) {
+      build_si_msg(*cell_ctxt, msg_index, &msg[msg_index]);
+      pack_si_msg(cc_idx, msg_index, msg[msg_index]);
+    }
 
-    // Copy SIB1 to first SI message
-    msg[0].msg.set_c1().set_sib_type1() = cell_ctxt->sib1;
+    // Pre-pack one SI message per segment of the CMAS warning message
+    if (cmas_present) {
+      uint32_t period_rf = cfg.sib1.sched_info_list[cmas_msg_idx - 1].si_periodicity.to_number();
+      cell_ctxt->cmas_ring.reset(new cmas_segment_ring{period_rf});
+      cell_ctxt->cmas_si_idx = cmas_msg_idx;
+      if (set_cmas_segments(cell_ctxt, msg[cmas_msg_idx], cmas_sib_pos) != SRSLTE_SUCCESS) {
+        rrc_log->error("Failed to segment CMAS warning message. Broadcasting it in a single SIB12\n");
+      }
+    }
 
-    // Copy rest of SIBs
-    for (uint32_t sched_info_elem = 0; sched_info_elem < nof_messages - 1; sched_info_elem++) {
-      uint32_t msg_index = sched_info_elem + 1; // first msg is SIB1, therefore start with second
+    if (cfg.sibs[6].type() == asn1::rrc::sys_info_r8_ies_s::sib_type_and_info_item_c_::types::sib7) {
+      sib7 = cfg.sibs[6].sib7();
+    }
+  }
 
-      msg[msg_index].msg.set_c1().set_sys_info().crit_exts.set_sys_info_r8();
-      sys_info_r8_ies_s::sib_type_and_info_l_& sib_list =
-          msg[msg_index].msg.c1().sys_info().crit_exts.sys_info_r8().sib_type_and_info;
+  return nof_messages;
+}
 
-      // SIB2 always in second SI message
-      if (msg_index == 1) {
-        sib_info_item_c sibitem;
-        sibitem.set_sib2() = cell_ctxt->sib2;
-        sib_list.push_back(sibitem);
+/* Finds the SI message that carries a SIB, according to the SIB1 scheduling info, and the
+ * position of the SIB within the sib_type_and_info list of that SI message.
+ *
+ * @return false if the SIB is not scheduled
+ */
+bool rrc::find_sib(sib_type_e sib_type, uint32_t* msg_index, uint32_t* sib_pos) const
+{
+  for (uint32_t i = 0; i < cfg.sib1.sched_info_list.size(); ++i) {
+    const sib_map_info_l& map_info = cfg.sib1.sched_info_list[i].sib_map_info;
+    for (uint32_t j = 0; j < map_info.size(); ++j) {
+      if (map_info[j] == sib_type) {
+        *msg_index = i + 1;                // first msg is SIB1
+        *sib_pos   = (i == 0) ? j + 1 : j; // SIB2 always goes first in second SI message
+        return true;
       }
+    }
+  }
+  return false;
+}
 
-      // Add other SIBs to this message, if any
-      for (auto& mapping_enum : sched_info[sched_info_elem].sib_map_info) {
-        sib_list.push_back(cfg.sibs[(int)mapping_enum + 2]);
-      }
+/* Fills the SI message msg_index of a given cell with the currently configured SIBs. The first
+ * message is SIB1 and SIB2 always goes in the second message.
+ */
+void rrc::build_si_msg(const cell_info_common& cell_ctxt, uint32_t msg_index, bcch_dl_sch_msg_s* msg)
+{
+  if (msg_index == 0) {
+    msg->msg.set_c1().set_sib_type1() = cell_ctxt.sib1;
+    return;
+  }
+
+  sys_info_r8_ies_s::sib_type_and_info_l_& sib_list =
+      msg->msg.set_c1().set_sys_info().crit_exts.set_sys_info_r8().sib_type_and_info;
+
+  if (msg_index == 1) {
+    sib_info_item_c sibitem;
+    sibitem.set_sib2() = cell_ctxt.sib2;
+    sib_list.push_back(sibitem);
+  }
+
+  // Add other SIBs to this message, if any
+  for (auto& mapping_enum : cfg.sib1.sched_info_list[msg_index - 1].sib_map_info) {
+    sib_list.push_back(cfg.sibs[(int)mapping_enum + 2]);
+  }
+}
+
+/* Packs a SI message into the SIB buffer of the cell. The previous payload is
+ * swapped out atomically, so the MAC can keep reading the buffer meanwhile.
+ * If max_len is not 0, SI messages longer than max_len bytes are not written.
+ */
+int rrc::pack_si_msg(uint32_t cc_idx, uint32_t msg_index, const bcch_dl_sch_msg_s& msg, uint32_t max_len)
+{
+  srslte::unique_byte_buffer_t sib_buffer = srslte::allocate_unique_buffer(*pool);
+  if (sib_buffer == nullptr) {
+    rrc_log->error("Fatal Error: Couldn't allocate PDU in %s().\n", __FUNCTION__);
+    return SRSLTE_ERROR;
+  }
+  asn1::bit_ref bref(sib_buffer->msg, sib_buffer->get_tailroom());
+  if (msg.pack(bref) == asn1::SRSASN_ERROR_ENCODE_FAIL) {
+    rrc_log->error("Failed to pack SIB message %d\n", msg_index);
+    return SRSLTE_ERROR;
+  }
+  sib_buffer->N_bytes = bref.distance_bytes();
+  if (max_len > 0 and sib_buffer->N_bytes > max_len) {
+    rrc_log->error("SI message %d of %d bytes exceeds the maximum SI message length of %d bytes\n",
+                   msg_index,
+                   sib_buffer->N_bytes,
+                   max_len);
+    return SRSLTE_ERROR;
+  }
+  cell_common_list->get_cc_idx(cc_idx)->sib_buffer.at(msg_index).write(sib_buffer->msg, sib_buffer->N_bytes);
+
+  // Log SIBs in JSON format
+  std::string log_msg("CC" + std::to_string(cc_idx) + " SIB payload");
+  log_rrc_message(log_msg, Tx, sib_buffer.get(), msg, msg.msg.c1().type().to_string());
+
+  return SRSLTE_SUCCESS;
+}
+
+/* SI messages are scheduled with DCI format 1A, whose largest TBS is given by I_TBS=26 and N_PRB_1A=3 */
+uint32_t rrc::max_si_len() const
+{
+  return srslte_ra_tbs_from_idx(26, 3) / 8;
+}
+
+/* Splits the warning message of the SIB12 into the CMAS segment ring of the cell. The SIB
+ * buffer of the SI message is set to the first segment, so that it has the length the MAC
+ * must use to schedule it.
+ */
+int rrc::set_cmas_segments(cell_info_common* cell_ctxt, const bcch_dl_sch_msg_s& msg, uint32_t sib_pos)
+{
+  if (cell_ctxt->cmas_ring->set_warning(msg, sib_pos, max_si_len()) <= 0) {
+    return SRSLTE_ERROR;
+  }
+  const std::vector<uint8_t>& first_segment = cell_ctxt->cmas_ring->get_segment(0);
+  cell_ctxt->sib_buffer.at(cell_ctxt->cmas_si_idx).write(first_segment.data(), cell_ctxt->cmas_ring->payload_len());
+  return SRSLTE_SUCCESS;
+}
+
+/* Replaces warning SIBs at runtime. Only the SI messages carrying them are packed again,
+ * together with SIB1, whose systemInfoValueTag is incremented once for all of them. Each
+ * SI message is published once and the MAC picks them at the next SI-window.
+ */
+int rrc::update_warning_sibs(const std::vector<sib_info_item_c>& sibs)
+{
+  // SI messages to pack again, and position of the SIB12 within its SI message
+  std::vector<sib_type_e> sib_types;
+  std::vector<uint32_t>   msg_idxs;
+  uint32_t                cmas_msg_idx = 0, cmas_sib_pos = 0;
+  for (const sib_info_item_c& sib : sibs) {
+    sib_type_e sib_type;
+    switch (sib.type().value) {
+      case sys_info_r8_ies_s::sib_type_and_info_item_c_::types::sib10:
+        sib_type = sib_type_e::sib_type10;
+        break;
+      case sys_info_r8_ies_s::sib_type_and_info_item_c_::types::sib11:
+        sib_type = sib_type_e::sib_type11;
+        break;
+      case sys_info_r8_ies_s::sib_type_and_info_item_c_::types::sib12_v920:
+        sib_type = sib_type_e::sib_type12_v920;
+        break;
+      default:
+        rrc_log->error("Only SIB10, SIB11 and SIB12 can be updated at runtime (received %s)\n",
+                       sib.type().to_string().c_str());
+        return SRSLTE_ERROR;
     }
 
-    // Pack payload for all messages
-    for (uint32_t msg_index = 0; msg_index < nof_messages; msg_index++) {
-      srslte::unique_byte_buffer_t sib_buffer = srslte::allocate_unique_buffer(*pool);
-      asn1::bit_ref                bref(sib_buffer->msg, sib_buffer->get_tailroom());
-      if (msg[msg_index].pack(bref) == asn1::SRSASN_ERROR_ENCODE_FAIL) {
-        rrc_log->error("Failed to pack SIB message %d\n", msg_index);
+    uint32_t msg_index = 0, sib_pos = 0;
+    if (not find_sib(sib_type, &msg_index, &sib_pos)) {
+      rrc_log->error("Can't update %s, as it is not scheduled in SIB1\n", sib_type.to_string().c_str());
+      return SRSLTE_ERROR;
+    }
+    sib_types.push_back(sib_type);
+    if (sib_type == sib_type_e::sib_type12_v920) {
+      cmas_msg_idx = msg_index;
+      cmas_sib_pos = sib_pos;
+    }
+    if (std::find(msg_idxs.begin(), msg_idxs.end(), msg_index) == msg_idxs.end()) {
+      msg_idxs.push_back(msg_index);
+    }
+  }
+
+  // The previous SIBs are restored if the new ones can't be broadcast
+  std::vector<sib_info_item_c> old_sibs;
+  for (uint32_t i = 0; i < sibs.size(); ++i) {
+    old_sibs.push_back(cfg.sibs[(int)sib_types[i] + 2]);
+    cfg.sibs[(int)sib_types[i] + 2] = sibs[i];
+  }
+  uint32_t old_value_tag      = cfg.sib1.sys_info_value_tag;
+  cfg.sib1.sys_info_value_tag = (old_value_tag + 1) % 32;
+
+  if (pack_warning_si_msgs(msg_idxs, cmas_msg_idx, cmas_sib_pos) != SRSLTE_SUCCESS) {
+    rrc_log->error("Failed to update %zd warning SIBs. Broadcasting the previous ones\n", sibs.size());
+    for (uint32_t i = 0; i < sibs.size(); ++i) {
+      cfg.sibs[(int)sib_types[i] + 2] = old_sibs[i];
+    }
+    cfg.sib1.sys_info_value_tag = old_value_tag;
+    pack_warning_si_msgs(msg_idxs, cmas_msg_idx, cmas_sib_pos);
+    return SRSLTE_ERROR;
+  }
+
+  rrc_log->info("Updated %zd warning SIBs in %zd SI messages. systemInfoValueTag=%d\n",
+                sibs.size(),
+                msg_idxs.size(),
+                cfg.sib1.sys_info_value_tag);
+  return SRSLTE_SUCCESS;
+}
+
+/* Packs the SI messages carrying warning SIBs in all cells, together with SIB1. The SIB12, if any, is split again
+ * in the CMAS segment ring of each cell. The other SI messages are not segmented, so they must fit the SI TBS limit.
+ */
+int rrc::pack_warning_si_msgs(const std::vector<uint32_t>& msg_idxs, uint32_t cmas_msg_idx, uint32_t cmas_sib_pos)
+{
+  for (uint32_t cc_idx = 0; cc_idx < cell_common_list->nof_cells(); cc_idx++) {
+    cell_info_common* cell_ctxt = cell_common_list->get_cc_idx(cc_idx);
+
+    for (uint32_t msg_index : msg_idxs) {
+      bcch_dl_sch_msg_s si_msg;
+      build_si_msg(*cell_ctxt, msg_index, &si_msg);
+      if (msg_index == cmas_msg_idx and cell_ctxt->cmas_ring != nullptr) {
+        if (set_cmas_segments(cell_ctxt, si_msg, cmas_sib_pos) != SRSLTE_SUCCESS) {
+          rrc_log->error("Failed to segment CMAS warning message in CC%d\n", cc_idx);
+          return SRSLTE_ERROR;
+        }
+      } else if (pack_si_msg(cc_idx, msg_index, si_msg, max_si_len()) != SRSLTE_SUCCESS) {
+        return SRSLTE_ERROR;
       }
-      sib_buffer->N_bytes = bref.distance_bytes();
-      cell_ctxt->sib_buffer.emplace_back(sib_buffer->msg, sib_buffer->msg + sib_buffer->N_bytes);
+      mac->set_sib_len(cc_idx, msg_index, cell_ctxt->sib_buffer[msg_index].size());
+    }
+
+    // SIB1 with the new systemInfoValueTag
+    cell_ctxt->sib1.sys_info_value_tag = cfg.sib1.sys_info_value_tag;
+    bcch_dl_sch_msg_s sib1_msg;
+    build_si_msg(*cell_ctxt, 0, &sib1_msg);
+    if (pack_si_msg(cc_idx, 0, sib1_msg) != SRSLTE_SUCCESS) {
+      return SRSLTE_ERROR;
+    }
+  }
+  return SRSLTE_SUCCESS;
+}
+
+bool rrc::write_replace_warning(const asn1::s1ap::write_replace_warning_request_s& msg,
+                                std::vector<uint32_t>*                              cell_ids)
+{
+  const asn1::s1ap::write_replace_warning_request_ies_container& ies = msg.protocol_ies;
+
+  struct timeval rx_time;
+  gettimeofday(&rx_time, nullptr);
+  warning_rx_time_us.store((int64_t)rx_time.tv_sec * 1000000 + rx_time.tv_usec);
+  uint16_t msg_id     = ies.msg_id.value.to_number();
+  uint16_t serial_num = ies.serial_num.value.to_number();
+
+  // ETWS messages use the messageIdentifiers 0x1100-0x1107 (TS 23.041), all the others are handled as CMAS
+  bool is_etws = msg_id >= 0x1100 and msg_id <= 0x1107;
+
+  std::vector<sib_info_item_c> sibs;
+  std::vector<sib_type_e>      sib_types;
+  if (is_etws and ies.warning_type_present) {
+    // ETWS primary notification
+    sibs.emplace_back();
+    sib_types.emplace_back(sib_type_e::sib_type10);
+    sib_type10_s& sib10 = sibs.back().set_sib10();
+    sib10.msg_id.from_number(msg_id);
+    sib10.serial_num.from_number(serial_num);
+    memcpy(sib10.warning_type.data(), ies.warning_type.value.data(), sib10.warning_type.size());
+  }
+  if (is_etws and ies.warning_msg_contents_present) {
+    // ETWS secondary notification, sent in a single segment. Contents exceeding the SI TBS limit are rejected
+    sibs.emplace_back();
+    sib_types.emplace_back(sib_type_e::sib_type11);
+    sib_type11_s& sib11 = sibs.back().set_sib11();
+    sib11.msg_id.from_number(msg_id);
+    sib11.serial_num.from_number(serial_num);
+    sib11.warning_msg_segment_type.value = sib_type11_s::warning_msg_segment_type_opts::last_segment;
+    sib11.warning_msg_segment_num        = 0;
+    sib11.warning_msg_segment.resize(ies.warning_msg_contents.value.size());
+    memcpy(sib11.warning_msg_segment.data(),
+           ies.warning_msg_contents.value.data(),
+           ies.warning_msg_contents.value.size());
+    sib11.data_coding_scheme_present = ies.data_coding_scheme_present;
+    sib11.data_coding_scheme[0]      = ies.data_coding_scheme.value.to_number();
+  }
+  if (not is_etws and ies.warning_msg_contents_present) {
+    // CMAS notification. The complete message is segmented by the CMAS segment ring
+    sibs.emplace_back();
+    sib_types.emplace_back(sib_type_e::sib_type12_v920);
+    sib_type12_r9_s& sib12 = sibs.back().set_sib12_v920();
+    sib12.msg_id_r9.from_number(msg_id);
+    sib12.serial_num_r9.from_number(serial_num);
+    sib12.warning_msg_segment_type_r9.value = sib_type12_r9_s::warning_msg_segment_type_r9_opts::last_segment;
+    sib12.warning_msg_segment_num_r9        = 0;
+    sib12.warning_msg_segment_r9.resize(ies.warning_msg_contents.value.size());
+    memcpy(sib12.warning_msg_segment_r9.data(),
+           ies.warning_msg_contents.value.data(),
+           ies.warning_msg_contents.value.size());
+    sib12.data_coding_scheme_r9_present = ies.data_coding_scheme_present;
+    sib12.data_coding_scheme_r9[0]      = ies.data_coding_scheme.value.to_number();
+  }
+  if (sibs.empty()) {
+    rrc_log->error("WriteReplaceWarningRequest msg_id=0x%x has no content to broadcast\n", msg_id);
+    return false;
+  }
+  auto cmas_it = cmas_alerts.find(msg_id);
+  if (not is_etws and cmas_it != cmas_alerts.end() and not cmas_it->second.retired and
+      cmas_it->second.serial_num == serial_num) {
+    // TS 36.413 Section 8.12.1.2: the same warning message is not broadcast again
+    rrc_log->info("CMAS warning msg_id=0x%x, serial_num=0x%x is already being broadcast\n", msg_id, serial_num);
+    get_cell_ids(cell_ids);
+    return true;
+  }
 
-      // Log SIBs in JSON format
-      std::string log_msg("CC" + std::to_string(cc_idx) + " SIB payload");
-      log_rrc_message(log_msg, Tx, sib_buffer.get(), msg[msg_index], msg[msg_index].msg.c1().type().to_string());
+  if (is_etws) {
+    // The ETWS SIBs and SIB1 are packed and published once
+    if (update_warning_sibs(sibs) != SRSLTE_SUCCESS) {
+      return false;
+    }
+  } else {
+    uint32_t repeat_period  = ies.extended_repeat_period_present ? (uint32_t)ies.extended_repeat_period.value.value
+                                                                 : (uint32_t)ies.repeat_period.value.value;
+    uint32_t nof_broadcasts = ies.numof_broadcast_request.value.value;
+    if (add_cmas_alert(sibs[0], msg_id, serial_num, repeat_period, nof_broadcasts) != SRSLTE_SUCCESS) {
+      return false;
     }
+  }
 
-    if (cfg.sibs[6].type() == asn1::rrc::sys_info_r8_ies_s::sib_type_and_info_item_c_::types::sib7) {
-      sib7 = cfg.sibs[6].sib7();
+  uint32_t si_mask = 0;
+  for (uint32_t i = 0; i < sibs.size(); ++i) {
+    uint32_t msg_index = 0, sib_pos = 0;
+    find_sib(sib_types[i], &msg_index, &sib_pos);
+    si_mask |= 1u << msg_index;
+
+    warning_msg_t& warning = warning_msgs[sib_types[i] - sib_type_e::sib_type10];
+    warning.active         = true;
+    warning.msg_id         = msg_id;
+    warning.serial_num     = serial_num;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(paging_mutex);
+    etws_ind |= is_etws;
+    cmas_ind |= not is_etws;
+    set_warning_paging(true);
+  }
+
+  // Arm the report of the first transmission of the new SI messages
+  warning_si_mask.store(si_mask);
+  warning_tx_pending.store((1u << cell_common_list->nof_cells()) - 1u);
+
+  struct timeval t[3];
+  t[1] = rx_time;
+  gettimeofday(&t[2], nullptr);
+  get_time_interval(t);
+  rrc_log->info("Broadcasting %s warning msg_id=0x%x, serial_num=0x%x in %zd SIBs. SI update took %ld us\n",
+                is_etws ? "ETWS" : "CMAS",
+                msg_id,
+                serial_num,
+                sibs.size(),
+                t[0].tv_sec * 1000000 + t[0].tv_usec);
+  get_cell_ids(cell_ids);
+  return true;
+}
+
+bool rrc::kill_warning(uint16_t msg_id, uint16_t serial_num, bool kill_all, std::vector<uint32_t>* cell_ids)
+{
+  bool found = false;
+  // ETWS messages. The CMAS messages are kept in the alert table
+  for (uint32_t i = 0; i < 2; ++i) {
+    warning_msg_t& warning = warning_msgs[i];
+    if (warning.active and (kill_all or (warning.msg_id == msg_id and warning.serial_num == serial_num))) {
+      warning.active = false;
+      found          = true;
     }
   }
+  std::vector<uint16_t> cmas_kill_list;
+  for (const auto& alert : cmas_alerts) {
+    if (not alert.second.retired and (kill_all or (alert.first == msg_id and alert.second.serial_num == serial_num))) {
+      cmas_kill_list.push_back(alert.first);
+    }
+  }
+  for (uint16_t cmas_msg_id : cmas_kill_list) {
+    remove_cmas_alert(cmas_msg_id);
+    found = true;
+  }
+  if (not found) {
+    rrc_log->warning("Can't stop warning msg_id=0x%x, serial_num=0x%x, as it is not being broadcast\n",
+                     msg_id,
+                     serial_num);
+    return false;
+  }
 
-  return nof_messages;
+  mute_warning_si(sib_type_e::sib_type10);
+  mute_warning_si(sib_type_e::sib_type11);
+  mute_warning_si(sib_type_e::sib_type12_v920);
+
+  {
+    std::lock_guard<std::mutex> lock(paging_mutex);
+    etws_ind = warning_msgs[0].active or warning_msgs[1].active;
+    cmas_ind = warning_msgs[2].active;
+    set_warning_paging(false);
+  }
+  warning_tx_pending.store(0);
+
+  rrc_log->info("Stopped %s warning msg_id=0x%x, serial_num=0x%x\n", kill_all ? "all" : "the", msg_id, serial_num);
+  get_cell_ids(cell_ids);
+  return true;
+}
+
+/* Warning messages are broadcast in all the cells of the eNB */
+void rrc::get_cell_ids(std::vector<uint32_t>* cell_ids) const
+{
+  cell_ids->clear();
+  for (uint32_t cc_idx = 0; cc_idx < cell_common_list->nof_cells(); cc_idx++) {
+    cell_ids->push_back(cfg.cell_list[cc_idx].cell_id);
+  }
+}
+
+/* Adds a CMAS alert to the SIB12 segment ring of every cell, or replaces the alert with the same messageIdentifier,
+ * while the other alerts keep being broadcast. SIB12 changes do not affect systemInfoValueTag (36.331 Section 5.2.1.3),
+ * so SIB1 is left untouched. The repetition timer of the alert schedules one broadcast of all its segments per
+ * repetition period, until the number of broadcasts requested is reached.
+ */
+int rrc::add_cmas_alert(const sib_info_item_c& sib,
+                        uint16_t               msg_id,
+                        uint16_t               serial_num,
+                        uint32_t               repeat_period,
+                        uint32_t               nof_broadcasts)
+{
+  uint32_t msg_index = 0, sib_pos = 0;
+  if (not find_sib(sib_type_e::sib_type12_v920, &msg_index, &sib_pos)) {
+    rrc_log->error("Can't broadcast CMAS warning msg_id=0x%x, as SIB12 is not scheduled in SIB1\n", msg_id);
+    return SRSLTE_ERROR;
+  }
+
+  // Drop the alerts whose broadcast is over
+  for (auto it = cmas_alerts.begin(); it != cmas_alerts.end();) {
+    it = it->second.retired ? cmas_alerts.erase(it) : std::next(it);
+  }
+  if (cmas_alerts.count(msg_id) == 0 and cmas_alerts.size() >= cmas_segment_ring::max_nof_alerts) {
+    rrc_log->warning("Can't broadcast CMAS warning msg_id=0x%x, as %zd alerts are already being broadcast\n",
+                     msg_id,
+                     cmas_alerts.size());
+    return SRSLTE_ERROR;
+  }
+
+  cfg.sibs[(int)sib_type_e::sib_type12_v920 + 2] = sib;
+  for (uint32_t cc_idx = 0; cc_idx < cell_common_list->nof_cells(); cc_idx++) {
+    cell_info_common*  cell_ctxt = cell_common_list->get_cc_idx(cc_idx);
+    cmas_segment_ring* ring      = cell_ctxt->cmas_ring.get();
+
+    bcch_dl_sch_msg_s si_msg;
+    build_si_msg(*cell_ctxt, msg_index, &si_msg);
+    // The first alert replaces the SIB12 of the eNB configuration
+    int nof_segments = cmas_alerts.empty() ? ring->set_warning(si_msg, sib_pos, max_si_len(), msg_id)
+                                           : ring->add_alert(msg_id, si_msg, sib_pos, max_si_len());
+    if (nof_segments <= 0) {
+      return SRSLTE_ERROR;
+    }
+    cell_ctxt->sib_buffer.at(msg_index).write(ring->get_segment(0).data(), ring->payload_len());
+    mac->set_sib_len(cc_idx, msg_index, ring->payload_len());
+    ring->schedule_broadcast(msg_id);
+  }
+
+  cmas_alert_t& alert = cmas_alerts[msg_id];
+  alert.serial_num    = serial_num;
+  // A repetition period of 0 stands for a single broadcast (TS 23.041 Section 9.1.3.4.1)
+  alert.nof_broadcasts_req = repeat_period == 0 ? 1 : nof_broadcasts;
+  alert.nof_scheduled      = 1;
+  alert.retired            = false;
+  if (not alert.repetition_timer.is_valid()) {
+    alert.repetition_timer = timers->get_unique_timer();
+  }
+  // Without repetitions, the timer just polls the completion of the broadcast
+  uint32_t poll_period_ms = cfg.sib1.sched_info_list[msg_index - 1].si_periodicity.to_number() * 10 *
+                            cell_common_list->get_cc_idx(0)->cmas_ring->nof_segments();
+  alert.repetition_timer.set(repeat_period > 0 ? repeat_period * 1000 : poll_period_ms,
+                             [this, msg_id](uint32_t tid) { cmas_repetition_expired(msg_id); });
+  alert.repetition_timer.run();
+
+  rrc_log->info("Broadcasting %zd CMAS alerts. msg_id=0x%x repeated every %d s, %d broadcasts requested\n",
+                cmas_alerts.size(),
+                msg_id,
+                repeat_period,
+                alert.nof_broadcasts_req);
+  return SRSLTE_SUCCESS;
+}
+
+/* Stops the broadcast of a CMAS alert in all the cells. The table entry is only marked as retired, since this may be
+ * called from the callback of its own repetition timer, and it is erased when the next alert is added.
+ */
+void rrc::remove_cmas_alert(uint16_t msg_id)
+{
+  auto it = cmas_alerts.find(msg_id);
+  if (it == cmas_alerts.end() or it->second.retired) {
+    return;
+  }
+  it->second.retired = true;
+  it->second.repetition_timer.stop();
+  for (uint32_t cc_idx = 0; cc_idx < cell_common_list->nof_cells(); cc_idx++) {
+    cell_common_list->get_cc_idx(cc_idx)->cmas_ring->remove_alert(msg_id);
+  }
+
+  warning_msgs[2].active = false;
+  for (const auto& alert : cmas_alerts) {
+    warning_msgs[2].active |= not alert.second.retired;
+  }
+}
+
+/* Called once per repetition period of a CMAS alert. Schedules its next broadcast, or retires the alert once all the
+ * requested broadcasts were transmitted in every cell.
+ */
+void rrc::cmas_repetition_expired(uint16_t msg_id)
+{
+  auto it = cmas_alerts.find(msg_id);
+  if (it == cmas_alerts.end() or it->second.retired) {
+    return;
+  }
+  cmas_alert_t& alert = it->second;
+
+  if (alert.nof_broadcasts_req > 0 and alert.nof_scheduled >= alert.nof_broadcasts_req) {
+    uint32_t nof_completed = std::numeric_limits<uint32_t>::max();
+    for (uint32_t cc_idx = 0; cc_idx < cell_common_list->nof_cells(); cc_idx++) {
+      nof_completed = std::min(nof_completed, cell_common_list->get_cc_idx(cc_idx)->cmas_ring->nof_broadcasts(msg_id));
+    }
+    if (nof_completed < alert.nof_broadcasts_req) {
+      // wait for the last broadcast to complete
+      alert.repetition_timer.run();
+      return;
+    }
+    rrc_log->info("CMAS warning msg_id=0x%x completed %d broadcasts\n", msg_id, nof_completed);
+    remove_cmas_alert(msg_id);
+    if (not warning_msgs[2].active) {
+      mute_warning_si(sib_type_e::sib_type12_v920);
+      std::lock_guard<std::mutex> lock(paging_mutex);
+      cmas_ind = false;
+      set_warning_paging(false);
+    }
+    return;
+  }
+
+  bool in_time = true;
+  for (uint32_t cc_idx = 0; cc_idx < cell_common_list->nof_cells(); cc_idx++) {
+    in_time &= cell_common_list->get_cc_idx(cc_idx)->cmas_ring->schedule_broadcast(msg_id);
+  }
+  alert.nof_scheduled++;
+  if (not in_time) {
+    rrc_log->warning("CMAS warning msg_id=0x%x missed its repetition period, too many concurrent alerts\n", msg_id);
+  }
+  alert.repetition_timer.run();
+}
+
+/* Stops the scheduling of the SI message carrying a warning SIB, unless it still carries other SIBs being broadcast.
+ * The SI message is scheduled again once a new warning is written to it.
+ */
+void rrc::mute_warning_si(sib_type_e sib_type)
+{
+  uint32_t msg_index = 0, sib_pos = 0;
+  if (not find_sib(sib_type, &msg_index, &sib_pos) or msg_index == 1) {
+    // the first SI message carries SIB2
+    return;
+  }
+  for (const sib_type_e& mapped_sib : cfg.sib1.sched_info_list[msg_index - 1].sib_map_info) {
+    if (mapped_sib < sib_type_e::sib_type10 or mapped_sib > sib_type_e::sib_type12_v920 or
+        warning_msgs[mapped_sib.value - sib_type_e::sib_type10].active) {
+      return;
+    }
+  }
+  for (uint32_t cc_idx = 0; cc_idx < cell_common_list->nof_cells(); cc_idx++) {
+    mac->set_sib_len(cc_idx, msg_index, 0);
+  }
+}
+
+/* Called from the MAC when the SI message carrying a new warning is scheduled for the first time in a cell */
+void rrc::report_warning_tx(uint32_t cc_idx, uint32_t sib_index, uint32_t tti)
+{
+  if ((warning_tx_pending.fetch_and(~(1u << cc_idx)) & (1u << cc_idx)) == 0) {
+    return;
+  }
+  struct timeval now;
+  gettimeofday(&now, nullptr);
+  int64_t latency_us = (int64_t)now.tv_sec * 1000000 + now.tv_usec - warning_rx_time_us.load();
+  rrc_log->info("First transmission of warning SI message %d in cc=%d at tti=%d, %ld us after the S1AP request\n",
+                sib_index,
+                cc_idx,
+                tti,
+                (long)latency_us);
 }
 
 void rrc::configure_mbsfn_sibs(sib_type2_s* sib2_, sib_type13_r9_s* sib13_)
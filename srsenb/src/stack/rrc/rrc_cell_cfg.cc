@@ -45,6 +45,24 @@ pucch_res_common* freq_res_common_list::get_earfcn(uint32_t earfcn)
  *    cell ctxt common
  ************************/
 
+void si_msg_buffer::write(const uint8_t* payload, uint32_t len)
+{
+  std::shared_ptr<payload_t> prev = snapshot.get();
+  std::shared_ptr<payload_t> next = std::make_shared<payload_t>();
+  next->buffer.assign(payload, payload + len);
+  if (prev != nullptr) {
+    next->buffer.resize(std::max(next->buffer.size(), prev->buffer.size()), 0);
+  }
+  next->len = len;
+  snapshot.publish(std::move(next));
+}
+
+uint32_t si_msg_buffer::size() const
+{
+  std::shared_ptr<payload_t> current = snapshot.get();
+  return current == nullptr ? 0 : current->len;
+}
+
 cell_info_common_list::cell_info_common_list(const rrc_cfg_t& cfg_) : cfg(cfg_)
 {
   cell_list.reserve(cfg.cell_list.size());
@@ -0,0 +1,285 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/stack/rrc/rrc_cmas.h"
+#include "srslte/common/buffer_pool.h"
+#include "srslte/common/common.h"
+#include <algorithm>
+
+using namespace asn1::rrc;
+
+namespace srsenb {
+
+cmas_segment_ring::cmas_segment_ring(uint32_t si_period_rf_) : rrc_log("RRC"), si_period_rf(si_period_rf_)
+{
+  gen.publish(std::make_shared<segment_list_t>());
+}
+
+int cmas_segment_ring::set_warning(const bcch_dl_sch_msg_s& si_msg,
+                                   uint32_t                 sib12_pos,
+                                   uint32_t                 max_len,
+                                   uint32_t                 alert_id)
+{
+  std::vector<alert_t> old_alerts = std::move(alerts);
+  alerts.clear();
+  int ret = add_alert(alert_id, si_msg, sib12_pos, max_len);
+  if (ret < 0) {
+    alerts = std::move(old_alerts);
+  }
+  return ret;
+}
+
+int cmas_segment_ring::add_alert(uint32_t                 alert_id,
+                                 const bcch_dl_sch_msg_s& si_msg,
+                                 uint32_t                 sib12_pos,
+                                 uint32_t                 max_len)
+{
+  alert_t alert;
+  alert.id    = alert_id;
+  alert.state = std::make_shared<alert_state_t>();
+  if (segment_warning(si_msg, sib12_pos, max_len, &alert.segments) != SRSLTE_SUCCESS) {
+    return SRSLTE_ERROR;
+  }
+  uint32_t nof_alert_segments = alert.segments.size();
+
+  auto it = std::find_if(alerts.begin(), alerts.end(), [alert_id](const alert_t& a) { return a.id == alert_id; });
+  if (it != alerts.end()) {
+    *it = std::move(alert);
+  } else if (alerts.size() < max_nof_alerts) {
+    alerts.push_back(std::move(alert));
+  } else {
+    rrc_log->error("Can't broadcast more than %d CMAS warning messages at once\n", max_nof_alerts);
+    return SRSLTE_ERROR;
+  }
+  publish();
+
+  rrc_log->info("CMAS warning message split in %d SIB12 segments of %d bytes. %zd warning messages in the ring\n",
+                nof_alert_segments,
+                payload_len(),
+                alerts.size());
+  return nof_alert_segments;
+}
+
+bool cmas_segment_ring::remove_alert(uint32_t alert_id)
+{
+  auto it = std::find_if(alerts.begin(), alerts.end(), [alert_id](const alert_t& a) { return a.id == alert_id; });
+  if (it == alerts.end()) {
+    return false;
+  }
+  alerts.erase(it);
+  publish();
+  return true;
+}
+
+void cmas_segment_ring::clear()
+{
+  alerts.clear();
+  publish();
+}
+
+bool cmas_segment_ring::schedule_broadcast(uint32_t alert_id)
+{
+  for (const alert_t& alert : alerts) {
+    if (alert.id == alert_id) {
+      return alert.state->pending_tx.fetch_add(alert.segments.size()) == 0;
+    }
+  }
+  return false;
+}
+
+uint32_t cmas_segment_ring::nof_broadcasts(uint32_t alert_id) const
+{
+  for (const alert_t& alert : alerts) {
+    if (alert.id == alert_id) {
+      return alert.state->nof_tx.load() / alert.segments.size();
+    }
+  }
+  return 0;
+}
+
+/* Splits the warning message of the SIB12 in packed SI messages that fit the SI TBS limit */
+int cmas_segment_ring::segment_warning(const bcch_dl_sch_msg_s&            si_msg,
+                                       uint32_t                            sib12_pos,
+                                       uint32_t                            max_len,
+                                       std::vector<std::vector<uint8_t> >* segments)
+{
+  const sys_info_r8_ies_s::sib_type_and_info_l_& sib_list =
+      si_msg.msg.c1().sys_info().crit_exts.sys_info_r8().sib_type_and_info;
+  if (sib12_pos >= sib_list.size() or
+      sib_list[sib12_pos].type().value != sys_info_r8_ies_s::sib_type_and_info_item_c_::types::sib12_v920) {
+    rrc_log->error("SI message does not carry SIB12 in position %d\n", sib12_pos);
+    return SRSLTE_ERROR;
+  }
+
+  // The full warning message is carried in the warning message segment of the configured SIB12
+  const asn1::dyn_octstring& text = sib_list[sib12_pos].sib12_v920().warning_msg_segment_r9;
+  if (text.size() == 0) {
+    rrc_log->error("SIB12 has an empty warning message\n");
+    return SRSLTE_ERROR;
+  }
+
+  bcch_dl_sch_msg_s seg_msg = si_msg;
+  sib_type12_r9_s&  seg_sib12 =
+      seg_msg.msg.c1().sys_info().crit_exts.sys_info_r8().sib_type_and_info[sib12_pos].sib12_v920();
+
+  segments->clear();
+  uint32_t offset = 0;
+  while (offset < text.size()) {
+    if (segments->size() == max_nof_segments) {
+      rrc_log->error("CMAS warning message of %d bytes does not fit in %d segments\n", text.size(), max_nof_segments);
+      return SRSLTE_ERROR;
+    }
+
+    // Find the largest chunk of the warning message that fits the SI TBS limit
+    uint32_t             chunk = std::min((uint32_t)text.size() - offset, max_len);
+    std::vector<uint8_t> buffer;
+    while (chunk > 0) {
+      seg_sib12.warning_msg_segment_r9.resize(chunk);
+      memcpy(seg_sib12.warning_msg_segment_r9.data(), &text[offset], chunk);
+      seg_sib12.warning_msg_segment_num_r9 = segments->size();
+      // The data coding scheme is only present in the first segment (Cond Segment1 of 36.331)
+      seg_sib12.data_coding_scheme_r9_present = segments->empty();
+      seg_sib12.warning_msg_segment_type_r9.value =
+          (offset + chunk == text.size()) ? sib_type12_r9_s::warning_msg_segment_type_r9_opts::last_segment
+                                          : sib_type12_r9_s::warning_msg_segment_type_r9_opts::not_last_segment;
+      if (pack_si_msg(seg_msg, buffer) != SRSLTE_SUCCESS) {
+        return SRSLTE_ERROR;
+      }
+      if (buffer.size() <= max_len) {
+        break;
+      }
+      // shrink the chunk by the excess bytes, length determinants may need further iterations
+      chunk -= std::min(chunk, (uint32_t)buffer.size() - max_len);
+    }
+    if (chunk == 0) {
+      rrc_log->error("SI message does not have room for a SIB12 segment within %d bytes\n", max_len);
+      return SRSLTE_ERROR;
+    }
+
+    segments->push_back(std::move(buffer));
+    offset += chunk;
+  }
+  return SRSLTE_SUCCESS;
+}
+
+/* Publishes the current alerts in a new generation. The previous one stays alive while the MAC and the PHY use it */
+void cmas_segment_ring::publish()
+{
+  // Pad all segments to the same length, as the MAC schedules the SI message with a fixed length. The storage keeps
+  // room for the previous length, which the MAC may still use until it is reconfigured
+  std::shared_ptr<segment_list_t> old_gen     = gen.get();
+  uint32_t                        max_pdu_len = 0;
+  for (const alert_t& alert : alerts) {
+    for (const std::vector<uint8_t>& seg : alert.segments) {
+      max_pdu_len = std::max(max_pdu_len, (uint32_t)seg.size());
+    }
+  }
+  uint32_t buffer_len = max_pdu_len;
+  if (not old_gen->alerts.empty()) {
+    buffer_len = std::max(buffer_len, (uint32_t)old_gen->alerts[0].segments[0].size());
+  }
+
+  std::shared_ptr<segment_list_t> new_gen = std::make_shared<segment_list_t>();
+  new_gen->alerts                         = alerts;
+  for (alert_t& alert : new_gen->alerts) {
+    for (std::vector<uint8_t>& seg : alert.segments) {
+      seg.resize(buffer_len, 0);
+    }
+  }
+  new_gen->pdu_len = max_pdu_len;
+  current_window.store(std::numeric_limits<uint32_t>::max());
+  current_alert.store(new_gen->alerts.empty() ? 0 : new_gen->alerts.size() - 1);
+  gen.publish(std::move(new_gen));
+}
+
+uint8_t* cmas_segment_ring::read_pdu(uint32_t tti)
+{
+  segment_list_t& gen_tti    = *gen.pin(tti);
+  uint32_t        nof_alerts = gen_tti.alerts.size();
+  if (nof_alerts == 0) {
+    return nullptr;
+  }
+  uint32_t window_idx = (tti / 10) / si_period_rf;
+  if (current_window.exchange(window_idx) != window_idx) {
+    // Pick the next alert with a scheduled broadcast, or just the next alert if none is scheduled
+    uint32_t prev_alert = current_alert.load();
+    uint32_t alert_idx  = (prev_alert + 1) % nof_alerts;
+    for (uint32_t i = 1; i <= nof_alerts; ++i) {
+      if (gen_tti.alerts[(prev_alert + i) % nof_alerts].state->pending_tx.load() > 0) {
+        alert_idx = (prev_alert + i) % nof_alerts;
+        break;
+      }
+    }
+    alert_t& alert = gen_tti.alerts[alert_idx];
+    uint32_t seg   = alert.state->next_segment.load() % alert.segments.size();
+    alert.state->next_segment.store((seg + 1) % alert.segments.size());
+    if (alert.state->pending_tx.load() > 0) {
+      alert.state->pending_tx--;
+      alert.state->nof_tx++;
+    }
+    current_alert.store(alert_idx);
+    current_segment.store(seg);
+  }
+  alert_t& alert = gen_tti.alerts[current_alert.load() % nof_alerts];
+  return alert.segments[current_segment.load() % alert.segments.size()].data();
+}
+
+const std::vector<uint8_t>& cmas_segment_ring::get_segment(uint32_t idx) const
+{
+  // Only the RRC publishes new generations, so the current one outlives the returned reference
+  const segment_list_t& current = *gen.get();
+  for (const alert_t& alert : current.alerts) {
+    if (idx < alert.segments.size()) {
+      return alert.segments[idx];
+    }
+    idx -= alert.segments.size();
+  }
+  return current.alerts.back().segments.back();
+}
+
+uint32_t cmas_segment_ring::nof_segments() const
+{
+  std::shared_ptr<segment_list_t> current  = gen.get();
+  uint32_t                        nof_segs = 0;
+  for (const alert_t& alert : current->alerts) {
+    nof_segs += alert.segments.size();
+  }
+  return nof_segs;
+}
+
+int cmas_segment_ring::pack_si_msg(const bcch_dl_sch_msg_s& msg, std::vector<uint8_t>& buffer)
+{
+  srslte::unique_byte_buffer_t pdu = srslte::allocate_unique_buffer(*srslte::byte_buffer_pool::get_instance());
+  if (pdu == nullptr) {
+    rrc_log->error("Fatal Error: Couldn't allocate buffer for CMAS segment\n");
+    return SRSLTE_ERROR;
+  }
+  asn1::bit_ref bref(pdu->msg, pdu->get_tailroom());
+  if (msg.pack(bref) != asn1::SRSASN_SUCCESS) {
+    rrc_log->error("Failed to pack SIB12 segment\n");
+    return SRSLTE_ERROR;
+  }
+  pdu->N_bytes = bref.distance_bytes();
+  buffer.assign(pdu->msg, pdu->msg + pdu->N_bytes);
+  return SRSLTE_SUCCESS;
+}
+
+} // namespace srsenb
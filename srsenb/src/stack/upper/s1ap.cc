@@ -549,6 +549,10 @@ bool s1ap::handle_initiatingmessage(const init_msg_s& msg)
       return handle_erabsetuprequest(msg.value.erab_setup_request());
     case s1ap_elem_procs_o::init_msg_c::types_opts::ue_context_mod_request:
       return handle_uecontextmodifyrequest(msg.value.ue_context_mod_request());
+    case s1ap_elem_procs_o::init_msg_c::types_opts::write_replace_warning_request:
+      return handle_writereplacewarningrequest(msg.value.write_replace_warning_request());
+    case s1ap_elem_procs_o::init_msg_c::types_opts::kill_request:
+      return handle_killrequest(msg.value.kill_request());
     default:
       s1ap_log->error("Unhandled initiating message: %s\n", msg.value.type().to_string().c_str());
   }
@@ -711,6 +715,124 @@ bool s1ap::handle_uecontextmodifyrequest(const ue_context_mod_request_s& msg)
   return true;
 }
 
+/*******************************************************************************
+/* Public warning system
+********************************************************************************/
+
+bool s1ap::handle_writereplacewarningrequest(const write_replace_warning_request_s& msg)
+{
+  struct timeval t[3];
+  gettimeofday(&t[1], nullptr);
+
+  const write_replace_warning_request_ies_container& ies        = msg.protocol_ies;
+  uint16_t                                           msg_id     = ies.msg_id.value.to_number();
+  uint16_t                                           serial_num = ies.serial_num.value.to_number();
+  s1ap_log->info("Received WriteReplaceWarningRequest msg_id=0x%x, serial_num=0x%x, rx_time=%ld.%06ld\n",
+                 msg_id,
+                 serial_num,
+                 t[1].tv_sec,
+                 t[1].tv_usec);
+
+  bool                  broadcasting = false;
+  std::vector<uint32_t> cell_ids;
+  if (ies.warning_area_list_present and not is_in_warning_area(ies.warning_area_list.value)) {
+    s1ap_log->info("Cell is outside of the warning area of msg_id=0x%x\n", msg_id);
+  } else {
+    broadcasting = rrc->write_replace_warning(msg, &cell_ids);
+  }
+
+  s1ap_pdu_c tx_pdu;
+  tx_pdu.set_successful_outcome().load_info_obj(ASN1_S1AP_ID_WRITE_REPLACE_WARNING);
+  write_replace_warning_resp_ies_container& container =
+      tx_pdu.successful_outcome().value.write_replace_warning_resp().protocol_ies;
+  container.msg_id.value     = ies.msg_id.value;
+  container.serial_num.value = ies.serial_num.value;
+  if (broadcasting) {
+    container.broadcast_completed_area_list_present = true;
+    cell_id_broadcast_l& cells = container.broadcast_completed_area_list.value.set_cell_id_broadcast();
+    cells.resize(cell_ids.size());
+    for (uint32_t i = 0; i < cell_ids.size(); ++i) {
+      cells[i].ecgi = get_cell_ecgi(cell_ids[i]);
+    }
+  }
+  bool ret = sctp_send_s1ap_pdu(tx_pdu, 0, "WriteReplaceWarningResponse");
+
+  gettimeofday(&t[2], nullptr);
+  get_time_interval(t);
+  s1ap_log->info(
+      "WriteReplaceWarningRequest msg_id=0x%x handled in %ld us\n", msg_id, t[0].tv_sec * 1000000 + t[0].tv_usec);
+  return ret;
+}
+
+bool s1ap::handle_killrequest(const kill_request_s& msg)
+{
+  const kill_request_ies_container& ies        = msg.protocol_ies;
+  uint16_t                          msg_id     = ies.msg_id.value.to_number();
+  uint16_t                          serial_num = ies.serial_num.value.to_number();
+  s1ap_log->info("Received KillRequest msg_id=0x%x, serial_num=0x%x\n", msg_id, serial_num);
+
+  bool                  cancelled = false;
+  std::vector<uint32_t> cell_ids;
+  if (ies.warning_area_list_present and not is_in_warning_area(ies.warning_area_list.value)) {
+    s1ap_log->info("Cell is outside of the warning area of msg_id=0x%x\n", msg_id);
+  } else {
+    cancelled = rrc->kill_warning(msg_id, serial_num, ies.kill_all_warning_msgs_present, &cell_ids);
+  }
+
+  s1ap_pdu_c tx_pdu;
+  tx_pdu.set_successful_outcome().load_info_obj(ASN1_S1AP_ID_KILL);
+  kill_resp_ies_container& container = tx_pdu.successful_outcome().value.kill_resp().protocol_ies;
+  container.msg_id.value             = ies.msg_id.value;
+  container.serial_num.value         = ies.serial_num.value;
+  if (cancelled) {
+    container.broadcast_cancelled_area_list_present = true;
+    cell_id_cancelled_l& cells = container.broadcast_cancelled_area_list.value.set_cell_id_cancelled();
+    cells.resize(cell_ids.size());
+    for (uint32_t i = 0; i < cell_ids.size(); ++i) {
+      cells[i].ecgi           = get_cell_ecgi(cell_ids[i]);
+      cells[i].nof_broadcasts = 0; // number of broadcasts not known
+    }
+  }
+  return sctp_send_s1ap_pdu(tx_pdu, 0, "KillResponse");
+}
+
+/**
+ * Builds the ECGI of a cell of the eNB from its 8-bit cell identity
+ */
+eutran_cgi_s s1ap::get_cell_ecgi(uint32_t cell_id) const
+{
+  eutran_cgi_s ecgi = eutran_cgi;
+  ecgi.cell_id.from_number((uint32_t)(args.enb_id << 8) | cell_id);
+  return ecgi;
+}
+
+/**
+ * Checks whether the eNB cell is part of a warning area. Emergency area IDs are not configured in the eNB, thus any
+ * emergency area is considered to contain the cell.
+ */
+bool s1ap::is_in_warning_area(const warning_area_list_c& warning_area)
+{
+  switch (warning_area.type().value) {
+    case warning_area_list_c::types_opts::cell_id_list:
+      for (const eutran_cgi_s& ecgi : warning_area.cell_id_list()) {
+        if (ecgi.plm_nid.to_number() == eutran_cgi.plm_nid.to_number() and
+            ecgi.cell_id.to_number() == eutran_cgi.cell_id.to_number()) {
+          return true;
+        }
+      }
+      return false;
+    case warning_area_list_c::types_opts::tracking_area_listfor_warning:
+      for (const tai_s& item : warning_area.tracking_area_listfor_warning()) {
+        if (item.plm_nid.to_number() == tai.plm_nid.to_number() and item.tac.to_number() == tai.tac.to_number()) {
+          return true;
+        }
+      }
+      return false;
+    default:
+      return true;
+  }
+}
+
 bool s1ap::handle_uectxtreleasecommand(const ue_context_release_cmd_s& msg)
 {
   s1ap_log->info("Received UEContextReleaseCommand\n");
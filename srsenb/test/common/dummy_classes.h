@@ -31,6 +31,7 @@ class mac_dummy : public mac_interface_rrc
 public:
   int  cell_cfg(const std::vector<sched_interface::cell_cfg_t>& cell_cfg) override { return 0; }
   void reset() override {}
+  int  set_sib_len(uint32_t enb_cc_idx, uint32_t sib_idx, uint32_t len) override { return 0; }
   int  ue_cfg(uint16_t rnti, sched_interface::ue_cfg_t* cfg) override { return 0; }
   int  ue_rem(uint16_t rnti) override { return 0; }
   int  ue_set_crnti(uint16_t temp_crnti, uint16_t crnti, sched_interface::ue_cfg_t* cfg) override { return 0; }
@@ -20,6 +20,7 @@
  */
 
 #include "scheduler_test_common.h"
+#include "srsenb/hdr/stack/mac/scheduler_carrier.h"
 #include "srsenb/hdr/stack/mac/scheduler_grid.h"
 #include "srslte/common/test_common.h"
 
@@ -144,6 +145,87 @@ int test_pdcch_one_ue()
   return SRSLTE_SUCCESS;
 }
 
+//! Gives access to the SI allocation stats of the PCell
+class si_sched_tester : public sched
+{
+public:
+  const bc_sched::si_stats_t& get_si_stats(uint32_t sib_idx) const
+  {
+    return carrier_schedulers[PCell_IDX]->get_bc_sched()->get_si_stats(sib_idx);
+  }
+};
+
+int test_large_si_sched()
+{
+  const uint32_t ENB_CC_IDX = 0;
+  // Params
+  uint32_t nof_prb     = 25;
+  uint32_t large_si    = 2;
+  uint32_t large_len   = 200; // e.g. a CMAS SIB12 segment
+  uint32_t nof_periods = 4;
+
+  // Derived
+  sched_interface::cell_cfg_t cell_cfg = generate_default_cell_cfg(nof_prb);
+  cell_cfg.sibs[large_si].len          = large_len;
+  cell_cfg.sibs[large_si].period_rf    = 16;
+  sched_interface::sched_args_t    sched_args{};
+  std::vector<sched_cell_params_t> cell_params(1);
+  TESTASSERT(cell_params[ENB_CC_IDX].set_cfg(ENB_CC_IDX, cell_cfg, sched_args));
+  const sched_cell_params_t& cc_params = cell_params[ENB_CC_IDX];
+
+  // TEST: The BC allocation grows with the SI length. SIB1 keeps its 4 PRBs
+  uint32_t nof_large_rbgs = cc_params.get_dl_bc_nof_rbgs(large_len);
+  TESTASSERT(cc_params.get_dl_bc_nof_rbgs(cell_cfg.sibs[0].len) == srslte::ceil_div(4, cc_params.P));
+  TESTASSERT(nof_large_rbgs > cc_params.get_dl_bc_nof_rbgs(cell_cfg.sibs[1].len));
+  TESTASSERT(nof_large_rbgs < cc_params.nof_rbgs);
+  // TEST: SI messages above the max format 1A TBS are not allocated
+  TESTASSERT(cc_params.get_dl_bc_nof_rbgs(300) == 0);
+
+  si_sched_tester sched;
+  sched.init(nullptr);
+  sched.set_sched_cfg(&sched_args);
+  TESTASSERT(sched.cell_cfg({cell_cfg}) == SRSLTE_SUCCESS);
+
+  uint32_t nof_large_tx = 0;
+  for (uint32_t tti = 0; tti < nof_periods * cell_cfg.sibs[large_si].period_rf * 10; ++tti) {
+    sched_interface::dl_sched_res_t dl_result;
+    TESTASSERT(sched.dl_sched(tti, ENB_CC_IDX, dl_result) == SRSLTE_SUCCESS);
+    for (uint32_t i = 0; i < dl_result.nof_bc_elems; ++i) {
+      const sched_interface::dl_sched_bc_t& bc = dl_result.bc[i];
+      if (bc.type != sched_interface::dl_sched_bc_t::BCCH) {
+        continue;
+      }
+      // TEST: The PRBs of each SI transmission are reserved from the band edge, and sized from the SI length
+      prb_range_t prbs     = prb_range_t::riv_to_prbs(bc.dci.type2_alloc.riv, nof_prb);
+      uint32_t    nof_rbgs = cc_params.get_dl_bc_nof_rbgs(cell_cfg.sibs[bc.index].len);
+      TESTASSERT(bc.tbs >= cell_cfg.sibs[bc.index].len);
+      TESTASSERT(prbs.prb_min == 0);
+      TESTASSERT(prbs.nof_prbs() == SRSLTE_MIN(nof_rbgs * cc_params.P, nof_prb));
+      if (bc.index == large_si) {
+        // TEST: SI messages are not scheduled in the subframes with PBCH/PSS/SSS
+        TESTASSERT(tti % 10 != 0 and tti % 10 != 5);
+        nof_large_tx++;
+      }
+    }
+  }
+
+  // TEST: Every SI-window got all its transmissions
+  const bc_sched::si_stats_t& stats = sched.get_si_stats(large_si);
+  TESTASSERT(stats.nof_windows == nof_periods);
+  TESTASSERT(stats.nof_tx == nof_large_tx);
+  TESTASSERT(stats.nof_tx == stats.nof_windows * 4);
+  TESTASSERT(stats.nof_missed == 0 and stats.nof_alloc_fails == 0);
+  TESTASSERT(stats.nof_rbgs == nof_large_rbgs);
+  srslte::logmap::get("TEST")->info("SI message #%d with len=%d: %d RBGs, %d transmissions in %d SI-windows\n",
+                                    large_si + 1,
+                                    large_len,
+                                    stats.nof_rbgs,
+                                    stats.nof_tx,
+                                    stats.nof_windows);
+
+  return SRSLTE_SUCCESS;
+}
+
 int main()
 {
   srsenb::set_randseed(seed);
@@ -151,5 +233,6 @@ int main()
   srslte::logmap::get("TEST")->set_level(srslte::LOG_LEVEL_INFO);
 
   TESTASSERT(test_pdcch_one_ue() == SRSLTE_SUCCESS);
+  TESTASSERT(test_large_si_sched() == SRSLTE_SUCCESS);
   printf("Success\n");
 }
@@ -0,0 +1,299 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/phy/prach_worker.h"
+#include "srslte/common/log_filter.h"
+#include "srslte/common/test_common.h"
+#include "srslte/srslte.h"
+#include <condition_variable>
+#include <vector>
+
+/*
+ * Drives the PRACH worker pool with a preamble in every opportunity of several carriers. The preambles must be
+ * reported in the order they were received and the metrics must count every opportunity and deadline miss.
+ */
+
+using namespace srsenb;
+
+const uint32_t nof_prb       = 6;
+const uint32_t rar_window    = 10;
+const uint32_t freq_offset   = 0;
+const int      rx_timeout_ms = 5000;
+
+struct rach_t {
+  uint32_t tti;
+  uint32_t cc_idx;
+  uint32_t preamble_idx;
+};
+
+class dummy_stack final : public stack_interface_phy_lte
+{
+public:
+  // While blocked, the preambles are not accepted and the thread reporting them waits
+  void set_blocked(bool blocked_)
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    blocked = blocked_;
+    cvar.notify_all();
+  }
+
+  bool wait_rachs(uint32_t nof_rachs)
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    return cvar.wait_for(lock, std::chrono::milliseconds(rx_timeout_ms), [this, nof_rachs]() {
+      return rachs.size() >= nof_rachs;
+    });
+  }
+
+  std::vector<rach_t> get_rachs()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    return rachs;
+  }
+
+  // Waits for a thread to be reporting a preamble while the stack is blocked
+  bool wait_blocked_report()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    return cvar.wait_for(
+        lock, std::chrono::milliseconds(rx_timeout_ms), [this]() { return nof_blocked_reports > 0; });
+  }
+
+  void rach_detected(uint32_t tti, uint32_t primary_cc_idx, uint32_t preamble_idx, uint32_t time_adv) override
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    nof_blocked_reports++;
+    cvar.notify_all();
+    cvar.wait(lock, [this]() { return not blocked; });
+    nof_blocked_reports--;
+    rachs.push_back({tti, primary_cc_idx, preamble_idx});
+    cvar.notify_all();
+  }
+
+  int  sr_detected(uint32_t tti, uint16_t rnti) override { return 0; }
+  int  ri_info(uint32_t tti, uint16_t rnti, uint32_t cc_idx, uint32_t ri_value) override { return 0; }
+  int  pmi_info(uint32_t tti, uint16_t rnti, uint32_t cc_idx, uint32_t pmi_value) override { return 0; }
+  int  cqi_info(uint32_t tti, uint16_t rnti, uint32_t cc_idx, uint32_t cqi_value) override { return 0; }
+  int  snr_info(uint32_t tti, uint16_t rnti, uint32_t cc_idx, float snr_db) override { return 0; }
+  int  ta_info(uint32_t tti, uint16_t rnti, float ta_us) override { return 0; }
+  int  ack_info(uint32_t tti, uint16_t rnti, uint32_t cc_idx, uint32_t tb_idx, bool ack) override { return 0; }
+  int  crc_info(uint32_t tti, uint16_t rnti, uint32_t cc_idx, uint32_t nof_bytes, bool crc_res) override { return 0; }
+  int  get_dl_sched(uint32_t tti, dl_sched_list_t& dl_sched_res) override { return 0; }
+  int  get_mch_sched(uint32_t tti, bool is_mcch, dl_sched_list_t& dl_sched_res) override { return 0; }
+  int  get_ul_sched(uint32_t tti, ul_sched_list_t& ul_sched_res) override { return 0; }
+  void set_sched_dl_tti_mask(uint8_t* tti_mask, uint32_t nof_sfs) override {}
+  void rl_failure(uint16_t rnti) override {}
+  void rl_ok(uint16_t rnti) override {}
+  void tti_clock() override {}
+
+private:
+  std::mutex              mutex;
+  std::condition_variable cvar;
+  std::vector<rach_t>     rachs;
+  bool                    blocked             = false;
+  uint32_t                nof_blocked_reports = 0;
+};
+
+/* Emulates the subframe workers of the carriers, which hand every received subframe to the pool */
+class prach_test
+{
+public:
+  prach_test(const std::vector<uint32_t>& config_idx, uint32_t nof_threads_) :
+    nof_cc(config_idx.size()),
+    nof_threads(nof_threads_),
+    generators(config_idx.size()),
+    sf_buffer(2 * SRSLTE_SF_LEN_PRB(nof_prb))
+  {
+    log_h.set_level(srslte::LOG_LEVEL_NONE);
+    cell.nof_prb   = nof_prb;
+    cell.nof_ports = 1;
+    cell.cp        = SRSLTE_CP_NORM;
+
+    prach_cfg.resize(nof_cc);
+    for (uint32_t cc = 0; cc < nof_cc; cc++) {
+      prach_cfg[cc].config_idx       = config_idx[cc];
+      prach_cfg[cc].root_seq_idx     = 10 * cc;
+      prach_cfg[cc].zero_corr_zone   = 1;
+      prach_cfg[cc].freq_offset      = freq_offset;
+      prach_cfg[cc].num_ra_preambles = 64;
+    }
+  }
+
+  ~prach_test()
+  {
+    pool.stop();
+    for (auto& g : generators) {
+      srslte_prach_free(&g);
+    }
+  }
+
+  int init()
+  {
+    for (uint32_t cc = 0; cc < nof_cc; cc++) {
+      TESTASSERT(pool.init(cc, cell, prach_cfg[cc], rar_window, &stack, &log_h) == SRSLTE_SUCCESS);
+      TESTASSERT(srslte_prach_init(&generators[cc], srslte_symbol_sz(nof_prb)) == SRSLTE_SUCCESS);
+      TESTASSERT(srslte_prach_set_cfg(&generators[cc], &prach_cfg[cc], nof_prb) == SRSLTE_SUCCESS);
+    }
+    TESTASSERT(pool.start(nof_threads, -1) == SRSLTE_SUCCESS);
+    return SRSLTE_SUCCESS;
+  }
+
+  /* Hands a subframe of every carrier to the pool, with a different preamble in each opportunity. Returns the number
+   * of opportunities */
+  uint32_t new_tti(uint32_t tti)
+  {
+    uint32_t nof_opportunities = 0;
+    for (uint32_t cc = 0; cc < nof_cc; cc++) {
+      bool opportunity = srslte_prach_tti_opportunity_config_fdd(prach_cfg[cc].config_idx, tti, -1);
+
+      // The preamble format 0 of the configurations under test fits in one subframe
+      srslte_vec_cf_zero(sf_buffer.data(), sf_buffer.size());
+      if (opportunity) {
+        uint32_t preamble_idx = (7 * tti + 13 * cc) % 64;
+        srslte_prach_gen(&generators[cc], preamble_idx, freq_offset, sf_buffer.data());
+        sent.push_back({tti, cc, preamble_idx});
+        nof_opportunities++;
+      }
+      pool.new_tti(cc, tti, sf_buffer.data());
+    }
+    return nof_opportunities;
+  }
+
+  const uint32_t      nof_cc;
+  const uint32_t      nof_threads;
+  srslte::log_filter  log_h;
+  dummy_stack         stack;
+  prach_worker_pool   pool;
+  std::vector<rach_t> sent;
+
+private:
+  srslte_cell_t                   cell = {};
+  std::vector<srslte_prach_cfg_t> prach_cfg;
+  std::vector<srslte_prach_t>     generators;
+  std::vector<cf_t>               sf_buffer;
+};
+
+int check_rachs(const std::vector<rach_t>& expected, const std::vector<rach_t>& rachs)
+{
+  TESTASSERT(rachs.size() == expected.size());
+  for (uint32_t i = 0; i < rachs.size(); i++) {
+    TESTASSERT(rachs[i].tti == expected[i].tti);
+    TESTASSERT(rachs[i].cc_idx == expected[i].cc_idx);
+    TESTASSERT(rachs[i].preamble_idx == expected[i].preamble_idx);
+  }
+  return SRSLTE_SUCCESS;
+}
+
+/* The pool keeps up with the opportunities, so every preamble is reported in order and in time */
+int test_in_order(const std::vector<uint32_t>& config_idx, uint32_t nof_threads, uint32_t nof_tti)
+{
+  prach_test t(config_idx, nof_threads);
+  TESTASSERT(t.init() == SRSLTE_SUCCESS);
+
+  // The subframe workers do not get more than one subframe ahead of the reports, far from the end of the RAR window
+  uint32_t nof_reported = 0;
+  for (uint32_t tti = 0; tti < nof_tti; tti++) {
+    uint32_t nof_new = t.new_tti(tti);
+    TESTASSERT(t.stack.wait_rachs(nof_reported));
+    nof_reported += nof_new;
+  }
+  TESTASSERT(t.stack.wait_rachs(nof_reported));
+  t.pool.stop();
+
+  TESTASSERT(check_rachs(t.sent, t.stack.get_rachs()) == SRSLTE_SUCCESS);
+
+  prach_metrics_t metrics = {};
+  t.pool.get_metrics(&metrics);
+  TESTASSERT(metrics.nof_opportunities == t.sent.size());
+  TESTASSERT(metrics.deadline_misses == 0);
+  TESTASSERT(metrics.max_queue_depth >= 1 and metrics.max_queue_depth <= 2 * t.nof_cc);
+  TESTASSERT(metrics.queue_depth > 0.0f and metrics.queue_depth <= metrics.max_queue_depth);
+
+  printf("PRACH configs %d/%d/%d, %d threads: %zd preambles in order, queue depth %.2f (max %d)\n",
+         config_idx[0],
+         config_idx[1],
+         config_idx[2],
+         nof_threads,
+         t.sent.size(),
+         metrics.queue_depth,
+         metrics.max_queue_depth);
+  return SRSLTE_SUCCESS;
+}
+
+/* The stack blocks the reports from the first opportunity on. The subframe workers must not block, the opportunities
+ * beyond the job buffers are dropped and the ones reported late for the RAR window are deadline misses too */
+int test_deadline_misses(uint32_t nof_threads)
+{
+  const std::vector<uint32_t> config_idx = {14, 14, 14};
+  const uint32_t              nof_jobs   = 8 * config_idx.size(); // Opportunities the job buffers hold
+  const uint32_t              nof_tti    = 10;
+
+  prach_test t(config_idx, nof_threads);
+  TESTASSERT(t.init() == SRSLTE_SUCCESS);
+
+  t.stack.set_blocked(true);
+  t.new_tti(0);
+  TESTASSERT(t.stack.wait_blocked_report());
+  for (uint32_t tti = 1; tti < nof_tti; tti++) {
+    t.new_tti(tti);
+  }
+  t.stack.set_blocked(false);
+
+  std::vector<rach_t> expected(t.sent.begin(), t.sent.begin() + nof_jobs);
+  TESTASSERT(t.stack.wait_rachs(nof_jobs));
+  t.pool.stop();
+  TESTASSERT(check_rachs(expected, t.stack.get_rachs()) == SRSLTE_SUCCESS);
+
+  // The first opportunity was checked before blocking, the rest are reported after the last TTI
+  uint32_t nof_late = 0;
+  for (uint32_t i = 1; i < nof_jobs; i++) {
+    nof_late += (TTI_SUB(nof_tti - 1, expected[i].tti) + FDD_HARQ_DELAY_UL_MS >= 3 + rar_window) ? 1 : 0;
+  }
+
+  prach_metrics_t metrics = {};
+  t.pool.get_metrics(&metrics);
+  TESTASSERT(metrics.nof_opportunities == nof_jobs);
+  TESTASSERT(metrics.max_queue_depth >= 1 and metrics.max_queue_depth <= nof_jobs);
+  TESTASSERT(metrics.deadline_misses == t.sent.size() - nof_jobs + nof_late);
+
+  printf("%d threads with a blocked stack: %d opportunities, %d dropped and %d late\n",
+         nof_threads,
+         (uint32_t)t.sent.size(),
+         (uint32_t)t.sent.size() - nof_jobs,
+         nof_late);
+  return SRSLTE_SUCCESS;
+}
+
+int main()
+{
+  // PRACH configuration 3 has an opportunity in subframe 1 of every frame, 14 in every subframe
+  const std::vector<std::vector<uint32_t> > configs = {{3, 3, 3}, {14, 14, 14}, {3, 14, 3}};
+
+  for (uint32_t nof_threads = 1; nof_threads <= 3; nof_threads++) {
+    for (const auto& config_idx : configs) {
+      TESTASSERT(test_in_order(config_idx, nof_threads, 20) == SRSLTE_SUCCESS);
+    }
+    TESTASSERT(test_deadline_misses(nof_threads) == SRSLTE_SUCCESS);
+  }
+
+  printf("Success\n");
+  return SRSLTE_SUCCESS;
+}
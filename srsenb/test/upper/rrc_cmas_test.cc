@@ -0,0 +1,260 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/stack/rrc/rrc_cell_cfg.h"
+#include "srsenb/hdr/stack/rrc/rrc_cmas.h"
+#include "srslte/common/buffer_pool.h"
+#include "srslte/common/test_common.h"
+
+using namespace asn1::rrc;
+
+const static uint32_t si_period_rf = 16;
+const static uint32_t max_si_len   = 277;
+
+void fill_si_msg(bcch_dl_sch_msg_s& msg, uint32_t text_len)
+{
+  sys_info_r8_ies_s::sib_type_and_info_l_& sib_list =
+      msg.msg.set_c1().set_sys_info().crit_exts.set_sys_info_r8().sib_type_and_info;
+
+  sib_list.push_back({});
+  sib_type10_s& sib10 = sib_list.back().set_sib10();
+  sib10.msg_id.from_number(0x1104);
+  sib10.serial_num.from_number(0x3000);
+
+  sib_list.push_back({});
+  sib_type12_r9_s& sib12 = sib_list.back().set_sib12_v920();
+  sib12.msg_id_r9.from_number(0x1112);
+  sib12.serial_num_r9.from_number(0x3000);
+  sib12.data_coding_scheme_r9_present = true;
+  sib12.data_coding_scheme_r9[0]      = 0x48;
+  sib12.warning_msg_segment_r9.resize(text_len);
+  for (uint32_t i = 0; i < text_len; ++i) {
+    sib12.warning_msg_segment_r9[i] = (uint8_t)i;
+  }
+}
+
+int test_cmas_segmentation(uint32_t text_len)
+{
+  bcch_dl_sch_msg_s si_msg;
+  fill_si_msg(si_msg, text_len);
+
+  srsenb::cmas_segment_ring ring{si_period_rf};
+  int                       nof_segments = ring.set_warning(si_msg, 1, max_si_len);
+  TESTASSERT(nof_segments > 0);
+  TESTASSERT(ring.payload_len() <= max_si_len);
+  TESTASSERT((uint32_t)nof_segments >= (text_len + max_si_len - 1) / max_si_len);
+
+  // Reassemble the warning message from the packed segments
+  std::vector<uint8_t> text;
+  for (uint32_t i = 0; i < ring.nof_segments(); ++i) {
+    const std::vector<uint8_t>& pdu = ring.get_segment(i);
+    TESTASSERT(pdu.size() == ring.payload_len());
+
+    bcch_dl_sch_msg_s msg;
+    asn1::cbit_ref    bref(pdu.data(), pdu.size());
+    TESTASSERT(msg.unpack(bref) == asn1::SRSASN_SUCCESS);
+    const sys_info_r8_ies_s::sib_type_and_info_l_& sib_list =
+        msg.msg.c1().sys_info().crit_exts.sys_info_r8().sib_type_and_info;
+    TESTASSERT(sib_list.size() == 2);
+    TESTASSERT(sib_list[0].type().value == sys_info_r8_ies_s::sib_type_and_info_item_c_::types::sib10);
+
+    const sib_type12_r9_s& sib12 = sib_list[1].sib12_v920();
+    TESTASSERT(sib12.msg_id_r9.to_number() == 0x1112);
+    TESTASSERT(sib12.warning_msg_segment_num_r9 == i);
+    // The data coding scheme is only in the first segment
+    TESTASSERT(sib12.data_coding_scheme_r9_present == (i == 0));
+    if (i == 0) {
+      TESTASSERT(sib12.data_coding_scheme_r9[0] == 0x48);
+    }
+    bool is_last = i == ring.nof_segments() - 1;
+    TESTASSERT(is_last == (sib12.warning_msg_segment_type_r9.value ==
+                           sib_type12_r9_s::warning_msg_segment_type_r9_opts::last_segment));
+    const asn1::dyn_octstring& segment = sib12.warning_msg_segment_r9;
+    text.insert(text.end(), segment.data(), segment.data() + segment.size());
+  }
+  TESTASSERT(text.size() == text_len);
+  for (uint32_t i = 0; i < text_len; ++i) {
+    TESTASSERT(text[i] == (uint8_t)i);
+  }
+
+  // The ring must advance once per SI-window and repeat the segment within the window
+  for (uint32_t w = 0; w < 2 * ring.nof_segments(); ++w) {
+    uint32_t tti      = w * si_period_rf * 10;
+    uint8_t* first_tx = ring.read_pdu(tti);
+    TESTASSERT(first_tx == ring.get_segment(w % ring.nof_segments()).data());
+    TESTASSERT(ring.read_pdu(tti + 9) == first_tx);
+  }
+
+  return SRSLTE_SUCCESS;
+}
+
+int test_cmas_replace()
+{
+  bcch_dl_sch_msg_s si_msg;
+  fill_si_msg(si_msg, 1000);
+
+  srsenb::cmas_segment_ring ring{si_period_rf};
+  TESTASSERT(ring.set_warning(si_msg, 1, max_si_len) > 1);
+  uint32_t old_len = ring.payload_len();
+  TESTASSERT(ring.read_pdu(0) == ring.get_segment(0).data());
+
+  // A shorter warning message takes effect immediately, while keeping room for the previous SI length
+  fill_si_msg(si_msg, 50);
+  TESTASSERT(ring.set_warning(si_msg, 1, max_si_len) == 1);
+  TESTASSERT(ring.payload_len() < old_len);
+  TESTASSERT(ring.get_segment(0).size() == old_len);
+  TESTASSERT(ring.read_pdu(0) == ring.get_segment(0).data());
+  TESTASSERT(ring.read_pdu(si_period_rf * 10) == ring.get_segment(0).data());
+
+  return SRSLTE_SUCCESS;
+}
+
+int test_cmas_too_long()
+{
+  bcch_dl_sch_msg_s si_msg;
+  fill_si_msg(si_msg, srsenb::cmas_segment_ring::max_nof_segments * max_si_len);
+
+  srsenb::cmas_segment_ring ring{si_period_rf};
+  TESTASSERT(ring.set_warning(si_msg, 1, max_si_len) == SRSLTE_ERROR);
+  TESTASSERT(ring.set_warning(si_msg, 0, max_si_len) == SRSLTE_ERROR);
+
+  return SRSLTE_SUCCESS;
+}
+
+int test_cmas_multi_alert()
+{
+  bcch_dl_sch_msg_s         si_msg;
+  srsenb::cmas_segment_ring ring{si_period_rf};
+
+  // Alert 1 has 3 segments and alert 2 a single one
+  fill_si_msg(si_msg, 2 * max_si_len + 10);
+  TESTASSERT(ring.add_alert(1, si_msg, 1, max_si_len) == 3);
+  fill_si_msg(si_msg, 20);
+  TESTASSERT(ring.add_alert(2, si_msg, 1, max_si_len) == 1);
+  TESTASSERT(ring.nof_alerts() == 2);
+  TESTASSERT(ring.nof_segments() == 4);
+  // All the segments are padded to the longest one
+  TESTASSERT(ring.get_segment(3).size() == ring.get_segment(0).size());
+
+  // Without scheduled broadcasts, the alerts share the SI-windows in round-robin
+  uint32_t w = 0;
+  TESTASSERT(ring.read_pdu(w++ * si_period_rf * 10) == ring.get_segment(0).data());
+  TESTASSERT(ring.read_pdu(w++ * si_period_rf * 10) == ring.get_segment(3).data());
+  TESTASSERT(ring.read_pdu(w++ * si_period_rf * 10) == ring.get_segment(1).data());
+  TESTASSERT(ring.read_pdu(w++ * si_period_rf * 10) == ring.get_segment(3).data());
+  TESTASSERT(ring.nof_broadcasts(1) == 0);
+
+  // A scheduled broadcast takes all the SI-windows until it completes
+  TESTASSERT(ring.schedule_broadcast(1));
+  TESTASSERT(not ring.schedule_broadcast(1));
+  TESTASSERT(ring.read_pdu(w++ * si_period_rf * 10) == ring.get_segment(2).data());
+  for (uint32_t i = 0; i < 5; ++i) {
+    TESTASSERT(ring.read_pdu(w++ * si_period_rf * 10) == ring.get_segment((i % 3)).data());
+  }
+  TESTASSERT(ring.nof_broadcasts(1) == 2);
+  TESTASSERT(ring.nof_broadcasts(2) == 0);
+
+  // Alerts with scheduled broadcasts alternate
+  TESTASSERT(ring.schedule_broadcast(1));
+  TESTASSERT(ring.schedule_broadcast(2));
+  TESTASSERT(ring.read_pdu(w++ * si_period_rf * 10) == ring.get_segment(3).data());
+  TESTASSERT(ring.read_pdu(w++ * si_period_rf * 10) == ring.get_segment(2).data());
+  TESTASSERT(ring.read_pdu(w++ * si_period_rf * 10) == ring.get_segment(0).data());
+  TESTASSERT(ring.nof_broadcasts(2) == 1);
+
+  // A removed alert stops being broadcast. The buffers keep their length
+  uint32_t buffer_len = ring.get_segment(0).size();
+  TESTASSERT(ring.remove_alert(1));
+  TESTASSERT(not ring.remove_alert(1));
+  TESTASSERT(ring.nof_segments() == 1);
+  TESTASSERT(ring.get_segment(0).size() == buffer_len);
+  TESTASSERT(ring.read_pdu(w++ * si_period_rf * 10) == ring.get_segment(0).data());
+
+  ring.clear();
+  TESTASSERT(ring.read_pdu(w++ * si_period_rf * 10) == nullptr);
+
+  return SRSLTE_SUCCESS;
+}
+
+int test_cmas_publish_while_reading()
+{
+  bcch_dl_sch_msg_s         si_msg;
+  srsenb::cmas_segment_ring ring{si_period_rf};
+
+  fill_si_msg(si_msg, 100);
+  TESTASSERT(ring.add_alert(1, si_msg, 1, max_si_len) == 1);
+  fill_si_msg(si_msg, 200);
+  TESTASSERT(ring.add_alert(2, si_msg, 1, max_si_len) == 1);
+
+  // The PHY keeps transmitting the segment read for a TTI while the alerts are killed one after the other
+  uint8_t*             tx_segment = ring.read_pdu(0);
+  std::vector<uint8_t> tx_copy(tx_segment, tx_segment + ring.payload_len());
+  TESTASSERT(ring.remove_alert(1));
+  TESTASSERT(ring.remove_alert(2));
+  fill_si_msg(si_msg, 300);
+  TESTASSERT(ring.add_alert(3, si_msg, 1, max_si_len) == 2);
+  TESTASSERT(std::equal(tx_copy.begin(), tx_copy.end(), tx_segment));
+  TESTASSERT(ring.read_pdu(si_period_rf * 10) == ring.get_segment(0).data());
+
+  return SRSLTE_SUCCESS;
+}
+
+int test_si_msg_update()
+{
+  std::vector<uint8_t>  payload(100, 0x11);
+  srsenb::si_msg_buffer si_buffer;
+  si_buffer.write(payload.data(), payload.size());
+
+  // The PHY keeps transmitting the payload read for a TTI while the SI message is updated several times
+  uint8_t* tx_payload = si_buffer.read(0);
+  for (uint8_t i = 0; i < 4; ++i) {
+    std::vector<uint8_t> new_payload(50 + i, 0x20 + i);
+    si_buffer.write(new_payload.data(), new_payload.size());
+    TESTASSERT(si_buffer.size() == new_payload.size());
+    TESTASSERT(si_buffer.read(1 + i)[0] == new_payload[0]);
+  }
+  TESTASSERT(std::all_of(tx_payload, tx_payload + payload.size(), [](uint8_t b) { return b == 0x11; }));
+
+  // The new payloads keep room for the previous SI length
+  uint8_t* last_payload = si_buffer.read(srsenb::si_snapshot<int>::nof_pin_slots);
+  TESTASSERT(last_payload[payload.size() - 1] == 0);
+
+  return SRSLTE_SUCCESS;
+}
+
+int main()
+{
+  srslte::logmap::set_default_log_level(srslte::LOG_LEVEL_INFO);
+
+  TESTASSERT(test_cmas_segmentation(100) == SRSLTE_SUCCESS);
+  TESTASSERT(test_cmas_segmentation(max_si_len) == SRSLTE_SUCCESS);
+  TESTASSERT(test_cmas_segmentation(1230) == SRSLTE_SUCCESS);
+  TESTASSERT(test_cmas_replace() == SRSLTE_SUCCESS);
+  TESTASSERT(test_cmas_too_long() == SRSLTE_SUCCESS);
+  TESTASSERT(test_cmas_multi_alert() == SRSLTE_SUCCESS);
+  TESTASSERT(test_cmas_publish_while_reading() == SRSLTE_SUCCESS);
+  TESTASSERT(test_si_msg_update() == SRSLTE_SUCCESS);
+
+  srslte::byte_buffer_pool::get_instance()->cleanup();
+
+  printf("Success\n");
+  return SRSLTE_SUCCESS;
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsenb/hdr/enb.h"
+#include "srsenb/src/enb_cfg_parser.h"
+#include "srslte/common/test_common.h"
+#include "test_helpers.h"
+#include <chrono>
+#include <set>
+
+const static uint32_t nof_pending_pages = 10000;
+
+void fill_paging_id(asn1::s1ap::ue_paging_id_c* ue_paging_id, uint32_t m_tmsi)
+{
+  ue_paging_id->set_s_tmsi();
+  ue_paging_id->s_tmsi().mmec[0] = 0x1a;
+  for (uint32_t i = 0; i < 4; ++i) {
+    ue_paging_id->s_tmsi().m_tmsi[i] = (uint8_t)(m_tmsi >> (8u * (3 - i)));
+  }
+}
+
+int test_paging_calendar()
+{
+  printf("\n===== TEST: test_paging_calendar()  =====\n");
+  srslte::scoped_log<srslte::test_log_filter> rrc_log("RRC ");
+  srslte::timer_handler                       timers;
+
+  srsenb::all_args_t args;
+  rrc_cfg_t          cfg;
+  TESTASSERT(test_helpers::parse_default_cfg(&cfg, args) == SRSLTE_SUCCESS);
+
+  srsenb::rrc                       rrc;
+  mac_dummy                         mac;
+  rlc_dummy                         rlc;
+  test_dummies::pdcp_mobility_dummy pdcp;
+  phy_dummy                         phy;
+  test_dummies::s1ap_mobility_dummy s1ap;
+  gtpu_dummy                        gtpu;
+  rrc_log->set_level(srslte::LOG_LEVEL_NONE);
+  rrc.init(cfg, &phy, &mac, &rlc, &pdcp, &s1ap, &gtpu, &timers);
+
+  uint32_t T = cfg.sibs[1].sib2().rr_cfg_common.pcch_cfg.default_paging_cycle.to_number();
+
+  // Page the UEs. Many share the same UE_ID and thus the same PO
+  asn1::s1ap::ue_paging_id_c ue_paging_id;
+  for (uint32_t i = 0; i < nof_pending_pages; ++i) {
+    fill_paging_id(&ue_paging_id, i);
+    rrc.add_paging_id(i % 1024, ue_paging_id);
+  }
+  // A repeated paging is discarded
+  uint32_t nof_warnings = rrc_log->warn_counter;
+  fill_paging_id(&ue_paging_id, 0);
+  rrc.add_paging_id(0, ue_paging_id);
+  TESTASSERT(rrc_log->warn_counter == nof_warnings + 1);
+
+  // Run until all the UEs are paged. With nB = T (default config), the PF of a UE is SFN mod T = UE_ID mod T
+  std::set<uint32_t>       paged;
+  uint8_t                  payload[SRSLTE_MAX_BUFFER_SIZE_BYTES];
+  std::chrono::nanoseconds tti_time{0}, max_tti_time{0};
+  uint32_t                 nof_tti = 0, nof_po = 0;
+  for (uint32_t tti = 0; paged.size() < nof_pending_pages and tti < 10240 * 4; ++tti, ++nof_tti) {
+    uint32_t payload_len = 0;
+    auto     tic         = std::chrono::high_resolution_clock::now();
+    bool     is_po       = rrc.is_paging_opportunity(tti % 10240, &payload_len);
+    auto     toc         = std::chrono::high_resolution_clock::now();
+    auto     elapsed     = std::chrono::duration_cast<std::chrono::nanoseconds>(toc - tic);
+    tti_time += elapsed;
+    max_tti_time = std::max(max_tti_time, elapsed);
+    if (not is_po) {
+      continue;
+    }
+    nof_po++;
+    TESTASSERT(payload_len > 0 and payload_len <= sizeof(payload));
+    rrc.read_pdu_pcch(payload, sizeof(payload));
+
+    asn1::rrc::pcch_msg_s pcch_msg;
+    asn1::cbit_ref        bref(payload, payload_len);
+    TESTASSERT(pcch_msg.unpack(bref) == asn1::SRSASN_SUCCESS);
+    const asn1::rrc::paging_s& paging = pcch_msg.msg.c1().paging();
+    TESTASSERT(paging.paging_record_list.size() <= ASN1_RRC_MAX_PAGE_REC);
+    TESTASSERT(not paging.etws_ind_present);
+    for (const asn1::rrc::paging_record_s& rec : paging.paging_record_list) {
+      uint32_t m_tmsi = rec.ue_id.s_tmsi().m_tmsi.to_number();
+      // Each UE is paged once, in its own PF
+      TESTASSERT(paged.insert(m_tmsi).second);
+      TESTASSERT(((tti % 10240) / 10) % T == (m_tmsi % 1024) % T);
+    }
+  }
+  TESTASSERT(paged.size() == nof_pending_pages);
+
+  // Nothing left to page
+  for (uint32_t tti = 0; tti < 10240; ++tti) {
+    uint32_t payload_len = 0;
+    TESTASSERT(not rrc.is_paging_opportunity(tti, &payload_len));
+  }
+
+  printf("Paged %d UEs in %d POs over %d TTIs. is_paging_opportunity(): mean=%.2f us, max=%.2f us\n",
+         nof_pending_pages,
+         nof_po,
+         nof_tti,
+         tti_time.count() / 1000.0 / nof_tti,
+         max_tti_time.count() / 1000.0);
+
+  return SRSLTE_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  srslte::logmap::set_default_log_level(srslte::LOG_LEVEL_NONE);
+
+  if (argc < 3) {
+    argparse::usage(argv[0]);
+    return -1;
+  }
+  argparse::parse_args(argc, argv);
+  TESTASSERT(test_paging_calendar() == SRSLTE_SUCCESS);
+
+  printf("\nSuccess\n");
+
+  srslte::byte_buffer_pool::get_instance()->cleanup();
+
+  return SRSLTE_SUCCESS;
+}
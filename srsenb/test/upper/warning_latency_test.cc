@@ -0,0 +1,385 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/*
+ * Warning-to-air latency benchmark. CMAS warning messages are injected into the eNB RRC at random TTIs and the
+ * broadcast is followed TTI by TTI through the eNB MAC scheduler, which picks the SI-windows and paging occasions.
+ * An idle UE checks its own paging occasion and, once notified, decodes the SIB12 segments until the complete
+ * warning message is reassembled. The latency from the injection to the complete message is reported in percentiles
+ * for each combination of SI periodicity, default paging cycle and number of SIB12 segments.
+ */
+
+#include "srsenb/hdr/enb.h"
+#include "srsenb/hdr/stack/mac/scheduler.h"
+#include "srsenb/hdr/stack/rrc/rrc_cmas.h"
+#include "srsenb/src/enb_cfg_parser.h"
+#include "srslte/common/test_common.h"
+#include "srsue/hdr/stack/rrc/rrc_warning.h"
+#include "test_helpers.h"
+#include <algorithm>
+#include <random>
+#include <sstream>
+
+static uint32_t              nof_trials = 20;
+static std::vector<uint32_t> si_periods{8, 32};
+static std::vector<uint32_t> paging_cycles{32, 128};
+static std::vector<uint32_t> nof_segments_list{1, 3};
+static uint32_t              seed = 0;
+
+const static uint16_t cmas_msg_id     = 0x1112;
+const static uint32_t max_trial_ttis  = 120000;
+const static uint32_t max_idle_offset = 20480;
+
+/* MAC stand-in that forwards the SI and cell configuration of the RRC to a real eNB scheduler */
+class mac_sched_dummy : public mac_dummy
+{
+public:
+  explicit mac_sched_dummy(rrc_interface_mac* rrc)
+  {
+    sched.init(rrc);
+    sched.set_sched_cfg(&sched_args);
+  }
+  int cell_cfg(const std::vector<sched_interface::cell_cfg_t>& cell_cfg) override { return sched.cell_cfg(cell_cfg); }
+  int set_sib_len(uint32_t enb_cc_idx, uint32_t sib_idx, uint32_t len) override
+  {
+    return sched.set_sib_len(enb_cc_idx, sib_idx, len);
+  }
+
+  srsenb::sched                 sched;
+  sched_interface::sched_args_t sched_args;
+};
+
+/* Idle UE with a given UE_ID that reads its paging occasion and, once notified, the SIB12 segments */
+struct ue_emulator {
+  uint32_t                       ue_id        = 0;
+  bool                           notified     = false;
+  uint32_t                       notify_tti   = 0;
+  uint32_t                       nof_segments = 0;
+  srsue::warning_msg_reassembler reassembler;
+  std::vector<uint8_t>           contents;
+
+  /* PF and PO of the UE (36.304 Section 7) */
+  bool is_ue_po(uint32_t tti, uint32_t T, uint32_t N, uint32_t Ns) const
+  {
+    constexpr static int sf_pattern[4][4] = {{9, 4, -1, 0}, {-1, 9, -1, 4}, {-1, -1, -1, 5}, {-1, -1, -1, 9}};
+    uint32_t             i_s              = (ue_id / N) % Ns;
+    return (tti / 10) % T == (T / N) * (ue_id % N) and (int)(tti % 10) == sf_pattern[i_s][Ns - 1];
+  }
+
+  void read_pcch(const uint8_t* payload, uint32_t len, uint32_t tti)
+  {
+    asn1::rrc::pcch_msg_s pcch_msg;
+    asn1::cbit_ref        bref(payload, len);
+    if (pcch_msg.unpack(bref) != asn1::SRSASN_SUCCESS or
+        pcch_msg.msg.type().value != asn1::rrc::pcch_msg_type_c::types_opts::c1) {
+      return;
+    }
+    const asn1::rrc::paging_s& paging = pcch_msg.msg.c1().paging();
+    if (not notified and paging.non_crit_ext_present and paging.non_crit_ext.non_crit_ext_present and
+        paging.non_crit_ext.non_crit_ext.cmas_ind_r9_present) {
+      notified   = true;
+      notify_tti = tti;
+    }
+  }
+
+  /* Returns true once the complete warning message is decoded */
+  bool read_bcch(const uint8_t* payload, uint32_t len)
+  {
+    asn1::rrc::bcch_dl_sch_msg_s msg;
+    asn1::cbit_ref               bref(payload, len);
+    if (not notified or msg.unpack(bref) != asn1::SRSASN_SUCCESS or
+        msg.msg.c1().type().value != asn1::rrc::bcch_dl_sch_msg_type_c::c1_c_::types_opts::sys_info) {
+      return false;
+    }
+    for (const asn1::rrc::sib_info_item_c& sib : msg.msg.c1().sys_info().crit_exts.sys_info_r8().sib_type_and_info) {
+      if (sib.type().value != asn1::rrc::sib_info_item_c::types_opts::sib12_v920) {
+        continue;
+      }
+      const asn1::rrc::sib_type12_r9_s& sib12   = sib.sib12_v920();
+      bool                              is_last = sib12.warning_msg_segment_type_r9.value ==
+                         asn1::rrc::sib_type12_r9_s::warning_msg_segment_type_r9_opts::last_segment;
+      if (is_last) {
+        nof_segments = sib12.warning_msg_segment_num_r9 + 1;
+      }
+      if (reassembler.add_segment(sib12.msg_id_r9.to_number(),
+                                  sib12.serial_num_r9.to_number(),
+                                  sib12.warning_msg_segment_num_r9,
+                                  is_last,
+                                  sib12.warning_msg_segment_r9.data(),
+                                  sib12.warning_msg_segment_r9.size(),
+                                  &contents) == srsue::warning_msg_reassembler::result_t::complete) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+void fill_write_replace_warning(asn1::s1ap::write_replace_warning_request_s* msg,
+                                uint16_t                                     serial_num,
+                                uint32_t                                     contents_len)
+{
+  asn1::s1ap::write_replace_warning_request_ies_container& ies = msg->protocol_ies;
+  ies.msg_id.value.from_number(cmas_msg_id);
+  ies.serial_num.value.from_number(serial_num);
+  ies.repeat_period.value           = 1;
+  ies.numof_broadcast_request.value = 0;
+  ies.data_coding_scheme_present    = true;
+  ies.data_coding_scheme.value.from_number(0x01);
+  ies.warning_msg_contents_present = true;
+  ies.warning_msg_contents.value.resize(contents_len);
+  for (uint32_t i = 0; i < contents_len; ++i) {
+    ies.warning_msg_contents.value[i] = (uint8_t)(serial_num + i);
+  }
+}
+
+/* Finds the length of the warning message that fills exactly nof_segments SIB12 segments of the SI message */
+uint32_t get_contents_len(const rrc_cfg_t& cfg, uint32_t nof_segments)
+{
+  uint32_t max_si_len = srslte_ra_tbs_from_idx(26, 3) / 8;
+
+  asn1::rrc::bcch_dl_sch_msg_s                        si_msg;
+  asn1::rrc::sys_info_r8_ies_s::sib_type_and_info_l_& sib_list =
+      si_msg.msg.set_c1().set_sys_info().crit_exts.set_sys_info_r8().sib_type_and_info;
+  sib_list.push_back({});
+  sib_list.back().set_sib2() = cfg.sibs[1].sib2();
+  sib_list.push_back({});
+  asn1::rrc::sib_type12_r9_s& sib12   = sib_list.back().set_sib12_v920();
+  sib12.data_coding_scheme_r9_present = true;
+
+  // Largest segment, with a small margin for the differences of the SIB2 of each cell
+  srsenb::cmas_segment_ring ring{8};
+  uint32_t                  lo = 1, hi = max_si_len;
+  while (lo < hi) {
+    uint32_t mid = (lo + hi + 1) / 2;
+    sib12.warning_msg_segment_r9.resize(mid);
+    if (ring.set_warning(si_msg, 1, max_si_len) == 1) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  return nof_segments * (lo - 4);
+}
+
+struct latency_result_t {
+  std::vector<uint32_t> latency_ms;
+  std::vector<uint32_t> paging_ms;
+  uint32_t              nof_segments = 0;
+  uint32_t              nof_timeouts = 0;
+};
+
+int run_config(uint32_t si_period, uint32_t paging_cycle, uint32_t nof_segments, latency_result_t* result)
+{
+  srslte::timer_handler timers;
+  srsenb::all_args_t    args;
+  rrc_cfg_t             cfg;
+  TESTASSERT(test_helpers::parse_default_cfg(&cfg, args) == SRSLTE_SUCCESS);
+  TESTASSERT(cfg.sib1.sched_info_list.size() > 0);
+  TESTASSERT(asn1::number_to_enum(cfg.sib1.sched_info_list[0].si_periodicity, si_period));
+  asn1::rrc::pcch_cfg_s& pcch_cfg = cfg.sibs[1].sib2().rr_cfg_common.pcch_cfg;
+  TESTASSERT(asn1::number_to_enum(pcch_cfg.default_paging_cycle, paging_cycle));
+
+  srsenb::rrc                       rrc;
+  mac_sched_dummy                   mac{&rrc};
+  rlc_dummy                         rlc;
+  test_dummies::pdcp_mobility_dummy pdcp;
+  phy_dummy                         phy;
+  test_dummies::s1ap_mobility_dummy s1ap;
+  gtpu_dummy                        gtpu;
+  rrc.init(cfg, &phy, &mac, &rlc, &pdcp, &s1ap, &gtpu, &timers);
+
+  uint32_t contents_len = get_contents_len(cfg, nof_segments);
+  uint32_t T            = pcch_cfg.default_paging_cycle.to_number();
+  uint32_t Nb           = T * pcch_cfg.nb.to_number();
+  uint32_t N            = std::min(T, Nb);
+  uint32_t Ns           = std::max(Nb / T, 1u);
+
+  std::mt19937                            rand_gen(seed);
+  std::uniform_int_distribution<uint32_t> idle_dist(0, max_idle_offset);
+  std::uniform_int_distribution<uint32_t> ue_id_dist(0, 1023);
+  uint8_t                                 pcch_payload[SRSLTE_MAX_BUFFER_SIZE_BYTES];
+
+  uint32_t tti = 0;
+  for (uint32_t trial = 0; trial < nof_trials; ++trial) {
+    // Let the cell run for a random time, so that the injection falls at any point of the SI and paging cycles
+    uint32_t nof_idle = idle_dist(rand_gen);
+    for (uint32_t i = 0; i < nof_idle; ++i, ++tti) {
+      sched_interface::dl_sched_res_t sched_result;
+      mac.sched.dl_sched(tti % 10240, 0, sched_result);
+      timers.step_all();
+    }
+
+    ue_emulator ue;
+    ue.ue_id = ue_id_dist(rand_gen);
+
+    asn1::s1ap::write_replace_warning_request_s msg;
+    fill_write_replace_warning(&msg, 0x3000 + trial, contents_len);
+    std::vector<uint32_t> cell_ids;
+    TESTASSERT(rrc.write_replace_warning(msg, &cell_ids));
+    TESTASSERT(cell_ids.size() == 1);
+    uint32_t inject_tti = tti;
+
+    bool complete = false;
+    for (; not complete and tti - inject_tti < max_trial_ttis; ++tti) {
+      uint32_t                        tti_tx_dl = tti % 10240;
+      sched_interface::dl_sched_res_t sched_result;
+      mac.sched.dl_sched(tti_tx_dl, 0, sched_result);
+      for (uint32_t i = 0; i < sched_result.nof_bc_elems and not complete; ++i) {
+        const sched_interface::dl_sched_bc_t& bc = sched_result.bc[i];
+        if (bc.type == sched_interface::dl_sched_bc_t::PCCH) {
+          rrc.read_pdu_pcch(pcch_payload, sizeof(pcch_payload));
+          if (ue.is_ue_po(tti_tx_dl, T, N, Ns)) {
+            ue.read_pcch(pcch_payload, bc.tbs, tti);
+          }
+        } else {
+          uint8_t* payload = rrc.read_pdu_bcch_dlsch(0, bc.index, tti_tx_dl);
+          complete         = payload != nullptr and ue.read_bcch(payload, bc.tbs);
+        }
+      }
+      timers.step_all();
+    }
+
+    if (not complete) {
+      result->nof_timeouts++;
+    } else {
+      const asn1::unbounded_octstring<true>& contents = msg.protocol_ies.warning_msg_contents.value;
+      TESTASSERT(ue.contents.size() == contents.size());
+      TESTASSERT(std::equal(ue.contents.begin(), ue.contents.end(), contents.data()));
+      result->latency_ms.push_back(tti - inject_tti);
+      result->paging_ms.push_back(ue.notify_tti - inject_tti);
+      result->nof_segments = ue.nof_segments;
+    }
+    TESTASSERT(rrc.kill_warning(cmas_msg_id, 0x3000 + trial, false, &cell_ids));
+    TESTASSERT(cell_ids.size() == 1);
+  }
+  rrc.stop();
+  return SRSLTE_SUCCESS;
+}
+
+uint32_t percentile(std::vector<uint32_t> values, uint32_t p)
+{
+  if (values.empty()) {
+    return 0;
+  }
+  std::sort(values.begin(), values.end());
+  return values[std::min((uint32_t)values.size() - 1, (uint32_t)(values.size() * p / 100))];
+}
+
+int test_warning_latency()
+{
+  printf("\n===== TEST: test_warning_latency()  =====\n");
+  printf("Warning-to-air latency over %d trials per configuration, in ms:\n", nof_trials);
+  printf("si_period_rf paging_cycle_rf nof_segs | paging_p50  total_p50  total_p90  total_p99  total_max | timeouts\n");
+
+  for (uint32_t si_period : si_periods) {
+    for (uint32_t paging_cycle : paging_cycles) {
+      for (uint32_t nof_segments : nof_segments_list) {
+        latency_result_t result;
+        TESTASSERT(run_config(si_period, paging_cycle, nof_segments, &result) == SRSLTE_SUCCESS);
+        printf("%12d %15d %8d | %10d %10d %10d %10d %10d | %8d\n",
+               si_period,
+               paging_cycle,
+               result.nof_segments,
+               percentile(result.paging_ms, 50),
+               percentile(result.latency_ms, 50),
+               percentile(result.latency_ms, 90),
+               percentile(result.latency_ms, 99),
+               percentile(result.latency_ms, 100),
+               result.nof_timeouts);
+        TESTASSERT(result.nof_timeouts == 0);
+        TESTASSERT(result.nof_segments == nof_segments);
+      }
+    }
+  }
+  return SRSLTE_SUCCESS;
+}
+
+std::vector<uint32_t> parse_list(const char* str)
+{
+  std::vector<uint32_t> list;
+  std::stringstream     ss(str);
+  std::string           item;
+  while (std::getline(ss, item, ',')) {
+    list.push_back(strtoul(item.c_str(), nullptr, 10));
+  }
+  return list;
+}
+
+void usage(char* prog)
+{
+  printf("Usage: %s -i repository_dir [-n nof_trials] [-s si_periods] [-p paging_cycles] [-k nof_segments] [-r "
+         "seed]\n",
+         prog);
+  printf("\t-n Number of warning messages injected per configuration [Default %d]\n", nof_trials);
+  printf("\t-s Comma-separated SI periodicities of the SI message carrying SIB12, in radio frames [Default 8,32]\n");
+  printf("\t-p Comma-separated default paging cycles, in radio frames [Default 32,128]\n");
+  printf("\t-k Comma-separated number of SIB12 segments of the warning message [Default 1,3]\n");
+  printf("\t-r Random seed [Default %d]\n", seed);
+}
+
+void parse_args(int argc, char** argv)
+{
+  int opt;
+  while ((opt = getopt(argc, argv, "i:n:s:p:k:r:")) != -1) {
+    switch (opt) {
+      case 'i':
+        argparse::repository_dir = optarg;
+        break;
+      case 'n':
+        nof_trials = strtoul(optarg, nullptr, 10);
+        break;
+      case 's':
+        si_periods = parse_list(optarg);
+        break;
+      case 'p':
+        paging_cycles = parse_list(optarg);
+        break;
+      case 'k':
+        nof_segments_list = parse_list(optarg);
+        break;
+      case 'r':
+        seed = strtoul(optarg, nullptr, 10);
+        break;
+      default:
+        usage(argv[0]);
+        exit(-1);
+    }
+  }
+  if (argparse::repository_dir.empty()) {
+    usage(argv[0]);
+    exit(-1);
+  }
+}
+
+int main(int argc, char** argv)
+{
+  srslte::logmap::set_default_log_level(srslte::LOG_LEVEL_NONE);
+
+  parse_args(argc, argv);
+  TESTASSERT(test_warning_latency() == SRSLTE_SUCCESS);
+
+  printf("\nSuccess\n");
+
+  srslte::byte_buffer_pool::get_instance()->cleanup();
+
+  return SRSLTE_SUCCESS;
+}
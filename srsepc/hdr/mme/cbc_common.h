@@ -0,0 +1,132 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ * File:        cbc_common.h
+ * Description: Messages exchanged between the MME and a local Cell Broadcast
+ *              Center (CBC) stand-in. The interface is a simplified SBc-AP
+ *              carried over UDP, used to inject public warning messages.
+ *****************************************************************************/
+
+#ifndef SRSEPC_CBC_COMMON_H
+#define SRSEPC_CBC_COMMON_H
+
+#include <stdint.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "srslte/common/int_helpers.h"
+
+namespace srsepc {
+
+const uint32_t CBC_MAX_CONTENTS_LEN = 1600; ///< Warning Message Contents of up to 15 CBS pages
+const uint32_t CBC_HEADER_LEN       = 31;
+
+enum cbc_msg_type_t {
+  CBC_WRITE_REPLACE_WARNING_REQUEST = 1,
+  CBC_KILL_REQUEST,
+  CBC_WRITE_REPLACE_WARNING_RESPONSE,
+  CBC_KILL_RESPONSE
+};
+
+typedef struct {
+  uint8_t  type;
+  uint16_t msg_id;
+  uint16_t serial_num;
+  uint16_t repeat_period;  // Repetition period in seconds
+  uint16_t nof_broadcasts; // Number of broadcasts requested, 0 for unlimited
+  bool     warning_type_present;
+  uint16_t warning_type;
+  bool     data_coding_scheme_present;
+  uint8_t  data_coding_scheme;
+  bool     kill_all;
+  bool     success;      // Responses only: the eNB broadcasts or cancelled the warning message
+  uint64_t timestamp_us; // Requests: CBC transmission time. Responses: MME reception time
+  uint32_t enb_id;       // Responses only
+  uint32_t latency_us;   // Responses only: time from the S1AP request to the eNB response
+  uint16_t contents_len;
+  uint8_t  contents[CBC_MAX_CONTENTS_LEN];
+} cbc_msg_t;
+
+inline uint64_t cbc_time_now_us()
+{
+  struct timeval t;
+  gettimeofday(&t, NULL);
+  return (uint64_t)t.tv_sec * 1000000 + t.tv_usec;
+}
+
+/* Packs a CBC message in network byte order and returns its length, or 0 if it does not fit the buffer */
+inline uint32_t cbc_pack_msg(const cbc_msg_t& msg, uint8_t* buf, uint32_t max_len)
+{
+  if (msg.contents_len > CBC_MAX_CONTENTS_LEN or CBC_HEADER_LEN + msg.contents_len > max_len) {
+    return 0;
+  }
+  buf[0] = msg.type;
+  srslte::uint16_to_uint8(msg.msg_id, &buf[1]);
+  srslte::uint16_to_uint8(msg.serial_num, &buf[3]);
+  srslte::uint16_to_uint8(msg.repeat_period, &buf[5]);
+  srslte::uint16_to_uint8(msg.nof_broadcasts, &buf[7]);
+  buf[9] = msg.data_coding_scheme;
+  srslte::uint16_to_uint8(msg.warning_type, &buf[10]);
+  buf[12] = (msg.warning_type_present ? 1 : 0) | (msg.data_coding_scheme_present ? 2 : 0) | (msg.kill_all ? 4 : 0) |
+            (msg.success ? 8 : 0);
+  srslte::uint32_to_uint8(msg.timestamp_us >> 32u, &buf[13]);
+  srslte::uint32_to_uint8(msg.timestamp_us & 0xFFFFFFFF, &buf[17]);
+  srslte::uint32_to_uint8(msg.enb_id, &buf[21]);
+  srslte::uint32_to_uint8(msg.latency_us, &buf[25]);
+  srslte::uint16_to_uint8(msg.contents_len, &buf[29]);
+  memcpy(&buf[CBC_HEADER_LEN], msg.contents, msg.contents_len);
+  return CBC_HEADER_LEN + msg.contents_len;
+}
+
+inline bool cbc_unpack_msg(uint8_t* buf, uint32_t len, cbc_msg_t* msg)
+{
+  if (len < CBC_HEADER_LEN) {
+    return false;
+  }
+  uint32_t ts_msb = 0, ts_lsb = 0;
+  msg->type = buf[0];
+  srslte::uint8_to_uint16(&buf[1], &msg->msg_id);
+  srslte::uint8_to_uint16(&buf[3], &msg->serial_num);
+  srslte::uint8_to_uint16(&buf[5], &msg->repeat_period);
+  srslte::uint8_to_uint16(&buf[7], &msg->nof_broadcasts);
+  msg->data_coding_scheme = buf[9];
+  srslte::uint8_to_uint16(&buf[10], &msg->warning_type);
+  msg->warning_type_present       = (buf[12] & 1) > 0;
+  msg->data_coding_scheme_present = (buf[12] & 2) > 0;
+  msg->kill_all                   = (buf[12] & 4) > 0;
+  msg->success                    = (buf[12] & 8) > 0;
+  srslte::uint8_to_uint32(&buf[13], &ts_msb);
+  srslte::uint8_to_uint32(&buf[17], &ts_lsb);
+  msg->timestamp_us = ((uint64_t)ts_msb << 32u) | ts_lsb;
+  srslte::uint8_to_uint32(&buf[21], &msg->enb_id);
+  srslte::uint8_to_uint32(&buf[25], &msg->latency_us);
+  srslte::uint8_to_uint16(&buf[29], &msg->contents_len);
+  if (msg->contents_len > CBC_MAX_CONTENTS_LEN or CBC_HEADER_LEN + msg->contents_len > len) {
+    return false;
+  }
+  memcpy(msg->contents, &buf[CBC_HEADER_LEN], msg->contents_len);
+  return true;
+}
+
+} // namespace srsepc
+
+#endif // SRSEPC_CBC_COMMON_H
@@ -24,9 +24,11 @@
 #include "mme_gtpc.h"
 #include "nas.h"
 #include "s1ap_ctx_mngmt_proc.h"
+#include "s1ap_fanout.h"
 #include "s1ap_mngmt_proc.h"
 #include "s1ap_nas_transport.h"
 #include "s1ap_paging.h"
+#include "s1ap_warning.h"
 #include "srsepc/hdr/hss/hss.h"
 #include "srslte/asn1/gtpc.h"
 #include "srslte/asn1/liblte_mme.h"
@@ -61,13 +63,15 @@ public:
   void stop();
 
   int get_s1_mme();
+  int get_cbc();
 
   void delete_enb_ctx(int32_t assoc_id);
 
   bool s1ap_tx_pdu(const s1ap_pdu_t& pdu, struct sctp_sndrcvinfo* enb_sri);
+  void write_pcap(uint8_t* pdu, uint32_t pdu_len);
   void handle_s1ap_rx_pdu(srslte::byte_buffer_t* pdu, struct sctp_sndrcvinfo* enb_sri);
   void handle_initiating_message(const asn1::s1ap::init_msg_s& msg, struct sctp_sndrcvinfo* enb_sri);
-  void handle_successful_outcome(const asn1::s1ap::successful_outcome_s& msg);
+  void handle_successful_outcome(const asn1::s1ap::successful_outcome_s& msg, struct sctp_sndrcvinfo* enb_sri);
 
   void activate_eps_bearer(uint64_t imsi, uint8_t ebi);
 
@@ -101,6 +105,8 @@ public:
   s1ap_nas_transport*  m_s1ap_nas_transport;
   s1ap_ctx_mngmt_proc* m_s1ap_ctx_mngmt_proc;
   s1ap_paging*         m_s1ap_paging;
+  s1ap_warning*        m_s1ap_warning;
+  s1ap_fanout*         m_s1ap_fanout;
 
   std::map<uint32_t, uint64_t>   m_tmsi_to_imsi;
   std::map<uint16_t, enb_ctx_t*> m_active_enbs;
@@ -42,6 +42,8 @@ typedef struct {
   uint16_t                            mnc;          // BCD-coded with 0xF filler
   uint16_t                            paging_timer; // Paging timer in sec (T3413)
   std::string                         mme_bind_addr;
+  std::string                         cbc_bind_addr; // IP address to listen for CBC requests
+  uint16_t                            cbc_port;      // UDP port to listen for CBC requests, 0 to disable
   std::string                         mme_name;
   std::string                         dns_addr;
   std::string                         mme_apn;
@@ -58,9 +60,9 @@ typedef struct {
   uint16_t                                            mcc, mnc;
   uint32_t                                            plmn;
   uint8_t                                             nof_supported_ta;
-  std::array<uint8_t, MAX_TA>                         tac;
-  std::array<uint16_t, MAX_BPLMN>                     nof_supported_bplmns;
-  std::array<std::array<uint16_t, MAX_BPLMN>, MAX_TA> bplmns;
+  std::array<uint16_t, MAX_TA>                        tac;
+  std::array<uint16_t, MAX_TA>                        nof_supported_bplmns;
+  std::array<std::array<uint32_t, MAX_BPLMN>, MAX_TA> bplmns;
   asn1::s1ap::paging_drx_opts                         drx;
   struct sctp_sndrcvinfo                              sri;
 } enb_ctx_t;
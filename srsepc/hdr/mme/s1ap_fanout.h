@@ -0,0 +1,101 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+#ifndef SRSEPC_S1AP_FANOUT_H
+#define SRSEPC_S1AP_FANOUT_H
+
+#include "s1ap_common.h"
+#include "srslte/asn1/s1ap_asn1.h"
+#include "srslte/common/buffer_pool.h"
+#include "srslte/common/common.h"
+#include "srslte/common/log_filter.h"
+#include "srslte/common/s1ap_pcap.h"
+#include <map>
+#include <netinet/sctp.h>
+#include <sys/socket.h>
+#include <vector>
+
+namespace srsepc {
+
+const uint32_t FANOUT_MAX_BATCH = 64; // Max number of SCTP messages handed to the kernel in one system call
+
+typedef struct {
+  uint32_t enb_id;
+  bool     sent;
+  uint32_t tx_latency_us; // Time from the start of the fan-out until the PDU was handed to SCTP
+} fanout_enb_result_t;
+
+typedef struct {
+  uint32_t                         nof_enbs; // eNBs matching the TAI list
+  uint32_t                         nof_sent;
+  uint32_t                         nof_batches;
+  uint32_t                         encode_us;
+  uint32_t                         total_us;
+  std::vector<fanout_enb_result_t> enbs;
+} fanout_result_t;
+
+/*
+ * Sends one S1AP PDU to many eNBs. The PDU is encoded once and the SCTP sends are batched. The eNBs serving a TAI are
+ * found through an index built when the eNBs are set up, so that paging and warning messages do not scan all the
+ * eNB contexts.
+ *
+ * The fan-out only needs the S1-MME socket, so it can be driven without the rest of the S1AP, e.g. by the fan-out test.
+ */
+class s1ap_fanout
+{
+public:
+  static s1ap_fanout* m_instance;
+  static s1ap_fanout* get_instance(void);
+  static void         cleanup(void);
+  void                init(int s1mme, srslte::log_filter* s1ap_log, srslte::s1ap_pcap* pcap);
+
+  void add_enb(enb_ctx_t* enb_ctx);
+  void remove_enb(enb_ctx_t* enb_ctx);
+
+  bool send_to_all(const asn1::s1ap::s1ap_pdu_c& pdu, fanout_result_t* result);
+  bool send_to_tais(const asn1::s1ap::s1ap_pdu_c& pdu, const std::vector<uint64_t>& tai_list, fanout_result_t* result);
+
+  static uint64_t tai_key(uint32_t plmn, uint16_t tac) { return ((uint64_t)plmn << 16u) | tac; }
+
+private:
+  s1ap_fanout();
+  virtual ~s1ap_fanout();
+
+  bool send(const asn1::s1ap::s1ap_pdu_c& pdu, const std::vector<enb_ctx_t*>& enbs, fanout_result_t* result);
+
+  int                 m_s1mme;
+  srslte::log_filter* m_s1ap_log;
+  srslte::s1ap_pcap*  m_pcap; // NULL if PCAP is disabled
+
+  srslte::byte_buffer_pool* m_pool;
+
+  std::vector<enb_ctx_t*>                      m_all_enbs;
+  std::map<uint64_t, std::vector<enb_ctx_t*> > m_tai_to_enbs;
+
+  // Scratch buffers, reused by every fan-out
+  std::vector<enb_ctx_t*> m_enbs;
+  struct mmsghdr          m_msgs[FANOUT_MAX_BATCH];
+  struct iovec            m_iov;
+  uint8_t                 m_cmsg_buf[FANOUT_MAX_BATCH][CMSG_SPACE(sizeof(struct sctp_sndrcvinfo))];
+};
+
+} // namespace srsepc
+
+#endif // SRSEPC_S1AP_FANOUT_H
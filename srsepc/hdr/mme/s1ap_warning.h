@@ -0,0 +1,100 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+#ifndef SRSEPC_S1AP_WARNING_H
+#define SRSEPC_S1AP_WARNING_H
+
+#include "cbc_common.h"
+#include "s1ap_common.h"
+#include "srslte/asn1/s1ap_asn1.h"
+#include "srslte/common/buffer_pool.h"
+#include "srslte/common/common.h"
+#include "srslte/common/log_filter.h"
+#include <map>
+#include <netinet/in.h>
+
+namespace srsepc {
+
+class s1ap;
+
+/*
+ * Warning Message Transmission procedures (TS 36.413 Section 8.12). Warning messages are received from a local CBC
+ * stand-in, forwarded to all the connected eNBs, and the eNB responses are reported back to the CBC together with
+ * the latency of each hop.
+ */
+class s1ap_warning
+{
+public:
+  static s1ap_warning* m_instance;
+  static s1ap_warning* get_instance(void);
+  static void          cleanup(void);
+  void                 init(void);
+  void                 stop(void);
+
+  int  get_cbc_socket();
+  void handle_cbc_msg(srslte::byte_buffer_t* pdu, const struct sockaddr_in& cbc_addr);
+
+  bool send_write_replace_warning_request(const cbc_msg_t& msg);
+  bool send_kill_request(const cbc_msg_t& msg);
+
+  void handle_write_replace_warning_response(const asn1::s1ap::write_replace_warning_resp_s& msg,
+                                             struct sctp_sndrcvinfo*                         enb_sri);
+  void handle_kill_response(const asn1::s1ap::kill_resp_s& msg, struct sctp_sndrcvinfo* enb_sri);
+
+private:
+  s1ap_warning();
+  virtual ~s1ap_warning();
+
+  int  cbc_listen();
+  bool send_to_all_enbs(const asn1::s1ap::s1ap_pdu_c& tx_pdu, const cbc_msg_t& msg, const char* proc_name);
+  void send_cbc_response(uint8_t                 type,
+                         uint16_t                msg_id,
+                         uint16_t                serial_num,
+                         bool                    success,
+                         struct sctp_sndrcvinfo* enb_sri);
+
+  s1ap*               m_s1ap;
+  srslte::log_filter* m_s1ap_log;
+
+  s1ap_args_t               m_s1ap_args;
+  srslte::byte_buffer_pool* m_pool;
+
+  int                m_cbc;
+  struct sockaddr_in m_cbc_addr; // Address of the last CBC request, where responses are sent
+
+  // Transmission times of the requests forwarded to each eNB, indexed by eNB Id, messageIdentifier and serialNumber.
+  // The entries of the eNBs that never respond expire after the repetition period of the warning, or when it is killed
+  struct tx_time_t {
+    uint64_t tx_us;
+    uint64_t expiry_us;
+  };
+  std::map<uint64_t, tx_time_t> m_tx_time_us;
+  static const uint64_t         min_response_timeout_us = 10000000;
+  static uint64_t               tx_time_key(uint32_t enb_id, uint16_t msg_id, uint16_t serial_num)
+  {
+    return ((uint64_t)enb_id << 32u) | ((uint32_t)msg_id << 16u) | serial_num;
+  }
+  void expire_tx_times(uint64_t now_us);
+  void erase_tx_times(uint16_t msg_id, uint16_t serial_num, bool all);
+};
+
+} // namespace srsepc
+
+#endif // SRSEPC_S1AP_WARNING_H
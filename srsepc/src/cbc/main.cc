@@ -0,0 +1,212 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+/******************************************************************************
+ * File:        main.cc
+ * Description: Local Cell Broadcast Center stand-in. Injects a public warning
+ *              message (ETWS or CMAS) or a kill request into the MME and
+ *              reports the latency of each eNB response.
+ *****************************************************************************/
+
+#include "srsepc/hdr/mme/cbc_common.h"
+#include <arpa/inet.h>
+#include <boost/program_options.hpp>
+#include <inttypes.h>
+#include <iostream>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace srsepc;
+namespace bpo = boost::program_options;
+
+typedef struct {
+  string   mme_addr;
+  uint16_t mme_port;
+  bool     kill;
+  bool     kill_all;
+  uint16_t msg_id;
+  uint16_t serial_num;
+  uint16_t repeat_period;
+  uint16_t nof_broadcasts;
+  uint16_t warning_type;
+  string   text;
+  uint32_t timeout_ms;
+} cbc_args_t;
+
+static const uint32_t CBS_PAGE_LEN       = 82; // CBS-Message-Information-Page length in octets
+static const uint32_t CBS_CHARS_PER_PAGE = 93; // GSM 7-bit characters per page
+static const uint32_t CBS_MAX_PAGES      = 15;
+static const uint8_t  CBS_DCS_GSM7_ENG   = 0x01;
+
+bool parse_args(cbc_args_t* args, int argc, char* argv[])
+{
+  string msg_id, serial_num, warning_type;
+
+  bpo::options_description options("Options");
+  // clang-format off
+  options.add_options()
+      ("help,h", "Produce help message")
+      ("mme_addr",       bpo::value<string>(&args->mme_addr)->default_value("127.0.0.1"),  "IP address of the MME CBC interface")
+      ("mme_port",       bpo::value<uint16_t>(&args->mme_port)->default_value(29168),     "UDP port of the MME CBC interface")
+      ("msg_id",         bpo::value<string>(&msg_id)->default_value("0x1112"),            "Message Identifier. 0x1100-0x1107 are ETWS, others CMAS")
+      ("serial_num",     bpo::value<string>(&serial_num)->default_value("0x3000"),        "Serial Number")
+      ("repeat_period",  bpo::value<uint16_t>(&args->repeat_period)->default_value(10),   "Repetition period in seconds")
+      ("nof_broadcasts", bpo::value<uint16_t>(&args->nof_broadcasts)->default_value(0),   "Number of broadcasts, 0 for unlimited")
+      ("warning_type",   bpo::value<string>(&warning_type)->default_value(""),            "ETWS warning type (2 octets), sent in SIB10")
+      ("text",           bpo::value<string>(&args->text)->default_value(""),              "Warning message text, sent in SIB11 or SIB12")
+      ("kill",           bpo::bool_switch(&args->kill),                                   "Stop the broadcast of the warning message")
+      ("kill_all",       bpo::bool_switch(&args->kill_all),                               "Stop the broadcast of all the warning messages")
+      ("timeout",        bpo::value<uint32_t>(&args->timeout_ms)->default_value(1000),    "Time to wait for the eNB responses in ms")
+      ;
+  // clang-format on
+
+  bpo::variables_map vm;
+  try {
+    bpo::store(bpo::parse_command_line(argc, argv, options), vm);
+    bpo::notify(vm);
+  } catch (bpo::error& e) {
+    cerr << e.what() << endl;
+    return false;
+  }
+  if (vm.count("help")) {
+    cout << "Usage: " << argv[0] << " [options]" << endl << options << endl;
+    return false;
+  }
+
+  args->msg_id       = strtoul(msg_id.c_str(), NULL, 0);
+  args->serial_num   = strtoul(serial_num.c_str(), NULL, 0);
+  args->warning_type = warning_type.empty() ? 0 : strtoul(warning_type.c_str(), NULL, 0);
+  args->kill         = args->kill or args->kill_all;
+  return true;
+}
+
+/* Packs ASCII text in GSM 7-bit default alphabet CBS pages, as the Warning Message Contents IE (TS 23.041
+ * Section 9.4.2.2.5). Characters outside of the common ASCII/GSM subset are not converted. */
+uint32_t pack_cbs_pages(const string& text, uint8_t* contents)
+{
+  uint32_t nof_pages = std::min((uint32_t)(text.size() + CBS_CHARS_PER_PAGE - 1) / CBS_CHARS_PER_PAGE, CBS_MAX_PAGES);
+  nof_pages          = std::max(nof_pages, 1u);
+  contents[0]        = nof_pages;
+  for (uint32_t p = 0; p < nof_pages; ++p) {
+    uint8_t* page = &contents[1 + p * (CBS_PAGE_LEN + 1)];
+    memset(page, 0, CBS_PAGE_LEN);
+    uint32_t nof_chars = std::min((uint32_t)text.size() - std::min((uint32_t)text.size(), p * CBS_CHARS_PER_PAGE),
+                                  CBS_CHARS_PER_PAGE);
+    for (uint32_t c = 0; c < CBS_CHARS_PER_PAGE; ++c) {
+      // Pad the page with carriage returns
+      uint8_t  septet = c < nof_chars ? (text[p * CBS_CHARS_PER_PAGE + c] & 0x7f) : 0x0d;
+      uint32_t bit    = c * 7;
+      page[bit / 8] |= septet << (bit % 8);
+      if (bit % 8 > 1 and bit / 8 + 1 < CBS_PAGE_LEN) {
+        page[bit / 8 + 1] |= septet >> (8 - bit % 8);
+      }
+    }
+    page[CBS_PAGE_LEN] = (nof_chars * 7 + 7) / 8; // CBS-Message-Information-Length
+  }
+  return 1 + nof_pages * (CBS_PAGE_LEN + 1);
+}
+
+int main(int argc, char* argv[])
+{
+  cbc_args_t args = {};
+  if (!parse_args(&args, argc, argv)) {
+    return -1;
+  }
+
+  cbc_msg_t msg  = {};
+  msg.msg_id     = args.msg_id;
+  msg.serial_num = args.serial_num;
+  if (args.kill) {
+    msg.type     = CBC_KILL_REQUEST;
+    msg.kill_all = args.kill_all;
+  } else {
+    msg.type           = CBC_WRITE_REPLACE_WARNING_REQUEST;
+    msg.repeat_period  = args.repeat_period;
+    msg.nof_broadcasts = args.nof_broadcasts;
+    if (args.warning_type != 0) {
+      msg.warning_type_present = true;
+      msg.warning_type         = args.warning_type;
+    }
+    if (not args.text.empty()) {
+      msg.data_coding_scheme_present = true;
+      msg.data_coding_scheme         = CBS_DCS_GSM7_ENG;
+      msg.contents_len               = pack_cbs_pages(args.text, msg.contents);
+    }
+  }
+
+  int sock_fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (sock_fd < 0) {
+    perror("socket");
+    return -1;
+  }
+  struct sockaddr_in mme_addr = {};
+  mme_addr.sin_family         = AF_INET;
+  mme_addr.sin_port           = htons(args.mme_port);
+  if (inet_pton(AF_INET, args.mme_addr.c_str(), &mme_addr.sin_addr) != 1) {
+    cerr << "Invalid MME address " << args.mme_addr << endl;
+    close(sock_fd);
+    return -1;
+  }
+
+  uint8_t buf[CBC_HEADER_LEN + CBC_MAX_CONTENTS_LEN];
+  msg.timestamp_us = cbc_time_now_us();
+  uint32_t len     = cbc_pack_msg(msg, buf, sizeof(buf));
+  if (sendto(sock_fd, buf, len, 0, (struct sockaddr*)&mme_addr, sizeof(mme_addr)) < 0) {
+    perror("sendto");
+    close(sock_fd);
+    return -1;
+  }
+  printf("Sent %s msg_id=0x%x, serial_num=0x%x (%d bytes of contents)\n",
+         args.kill ? "Kill Request" : "Write-Replace Warning Request",
+         msg.msg_id,
+         msg.serial_num,
+         msg.contents_len);
+
+  // Collect the eNB responses relayed by the MME
+  uint32_t      nof_responses = 0;
+  struct pollfd pfd           = {sock_fd, POLLIN, 0};
+  while (poll(&pfd, 1, args.timeout_ms) > 0) {
+    ssize_t n = recv(sock_fd, buf, sizeof(buf), 0);
+    if (n <= 0) {
+      break;
+    }
+    uint64_t  rx_time_us = cbc_time_now_us();
+    cbc_msg_t resp       = {};
+    if (!cbc_unpack_msg(buf, n, &resp)) {
+      continue;
+    }
+    printf("eNB 0x%x: %s msg_id=0x%x. CBC->MME->eNB->MME: %" PRIu64 " us (MME<->eNB: %d us), CBC round trip: %" PRIu64
+           " us\n",
+           resp.enb_id,
+           resp.success ? "accepted" : "rejected",
+           resp.msg_id,
+           resp.timestamp_us - msg.timestamp_us,
+           resp.latency_us,
+           rx_time_us - msg.timestamp_us);
+    nof_responses++;
+  }
+  printf("Received %d eNB responses\n", nof_responses);
+
+  close(sock_fd);
+  return 0;
+}
@@ -76,6 +76,8 @@ void parse_args(all_args_t* args, int argc, char* argv[])
   string   mcc;
   string   mnc;
   string   mme_bind_addr;
+  string   cbc_bind_addr;
+  uint16_t cbc_port = 0;
   string   mme_apn;
   string   encryption_algo;
   string   integrity_algo;
@@ -112,6 +114,8 @@ void parse_args(all_args_t* args, int argc, char* argv[])
     ("mme.encryption_algo", bpo::value<string>(&encryption_algo)->default_value("EEA0"),     "Set preferred encryption algorithm for NAS layer ")
     ("mme.integrity_algo",  bpo::value<string>(&integrity_algo)->default_value("EIA1"),      "Set preferred integrity protection algorithm for NAS")
     ("mme.paging_timer",    bpo::value<uint16_t>(&paging_timer)->default_value(2),           "Set paging timer value in seconds (T3413)")
+    ("mme.cbc_bind_addr",   bpo::value<string>(&cbc_bind_addr)->default_value("127.0.0.1"),  "IP address to listen for Cell Broadcast Center requests")
+    ("mme.cbc_port",        bpo::value<uint16_t>(&cbc_port)->default_value(0),               "UDP port to listen for Cell Broadcast Center requests (0 disables it)")
     ("hss.db_file",         bpo::value<string>(&hss_db_file)->default_value("ue_db.csv"),    ".csv file that stores UE's keys")
     ("spgw.gtpu_bind_addr", bpo::value<string>(&spgw_bind_addr)->default_value("127.0.0.1"), "IP address of SP-GW for the S1-U connection")
     ("spgw.sgi_if_addr",    bpo::value<string>(&sgi_if_addr)->default_value("176.16.0.1"),   "IP address of TUN interface for the SGi connection")
@@ -269,6 +273,8 @@ void parse_args(all_args_t* args, int argc, char* argv[])
   args->mme_args.s1ap_args.dns_addr      = dns_addr;
   args->mme_args.s1ap_args.mme_apn       = mme_apn;
   args->mme_args.s1ap_args.paging_timer  = paging_timer;
+  args->mme_args.s1ap_args.cbc_bind_addr = cbc_bind_addr;
+  args->mme_args.s1ap_args.cbc_port      = cbc_port;
   args->spgw_args.gtpu_bind_addr         = spgw_bind_addr;
   args->spgw_args.sgi_if_addr            = sgi_if_addr;
   args->spgw_args.sgi_if_name            = sgi_if_name;
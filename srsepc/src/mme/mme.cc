@@ -119,9 +119,10 @@ void mme::run_thread()
   // Mark the thread as running
   m_running = true;
 
-  // Get S1-MME and S11 sockets
+  // Get S1-MME, S11 and CBC sockets
   int s1mme = m_s1ap->get_s1_mme();
   int s11   = m_mme_gtpc->get_s11();
+  int cbc   = m_s1ap->get_cbc();
 
   while (m_running) {
     pdu->clear();
@@ -130,6 +131,10 @@ void mme::run_thread()
     FD_ZERO(&m_set);
     FD_SET(s1mme, &m_set);
     FD_SET(s11, &m_set);
+    if (cbc != -1) {
+      FD_SET(cbc, &m_set);
+      max_fd = std::max(max_fd, cbc);
+    }
 
     // Add timers to select
     for (std::vector<mme_timer_t>::iterator it = timers.begin(); it != timers.end(); ++it) {
@@ -173,6 +178,18 @@ void mme::run_thread()
         pdu->N_bytes = recvfrom(s11, pdu->msg, SRSLTE_MAX_BUFFER_SIZE_BYTES, 0, NULL, NULL);
         m_mme_gtpc->handle_s11_pdu(pdu);
       }
+      // Handle CBC
+      if (cbc != -1 && FD_ISSET(cbc, &m_set)) {
+        struct sockaddr_in cbc_addr;
+        socklen_t          cbc_addr_len = sizeof(cbc_addr);
+        rd_sz = recvfrom(cbc, pdu->msg, sz, 0, (struct sockaddr*)&cbc_addr, &cbc_addr_len);
+        if (rd_sz == -1) {
+          m_s1ap_log->error("Error reading from CBC socket: %s\n", strerror(errno));
+        } else {
+          pdu->N_bytes = rd_sz;
+          m_s1ap->m_s1ap_warning->handle_cbc_msg(pdu, cbc_addr);
+        }
+      }
       // Handle NAS Timers
       for (std::vector<mme_timer_t>::iterator it = timers.begin(); it != timers.end();) {
         if (FD_ISSET(it->fd, &m_set)) {
@@ -85,6 +85,8 @@ int s1ap::init(s1ap_args_t s1ap_args, srslte::log_filter* nas_log, srslte::log_f
   m_s1ap_ctx_mngmt_proc->init();
   m_s1ap_paging = s1ap_paging::get_instance(); // Paging
   m_s1ap_paging->init();
+  m_s1ap_warning = s1ap_warning::get_instance(); // Warning message transmission
+  m_s1ap_warning->init();
 
   // Get pointer to GTP-C class
   m_mme_gtpc = mme_gtpc::get_instance();
@@ -96,6 +98,10 @@ int s1ap::init(s1ap_args_t s1ap_args, srslte::log_filter* nas_log, srslte::log_f
   if (m_pcap_enable) {
     m_pcap.open(s1ap_args.pcap_filename.c_str());
   }
+
+  // Transmission of one PDU to many eNBs
+  m_s1ap_fanout = s1ap_fanout::get_instance();
+  m_s1ap_fanout->init(m_s1mme, m_s1ap_log, m_pcap_enable ? &m_pcap : NULL);
   m_s1ap_log->info("S1AP Initialized\n");
   return 0;
 }
@@ -125,6 +131,9 @@ void s1ap::stop()
   s1ap_mngmt_proc::cleanup();
   s1ap_nas_transport::cleanup();
   s1ap_ctx_mngmt_proc::cleanup();
+  m_s1ap_warning->stop();
+  s1ap_warning::cleanup();
+  s1ap_fanout::cleanup();
 
   // PCAP
   if (m_pcap_enable) {
@@ -138,6 +147,11 @@ int s1ap::get_s1_mme()
   return m_s1mme;
 }
 
+int s1ap::get_cbc()
+{
+  return m_s1ap_warning->get_cbc_socket();
+}
+
 uint32_t s1ap::get_next_mme_ue_s1ap_id()
 {
   return m_next_mme_ue_s1ap_id++;
@@ -216,13 +230,18 @@ bool s1ap::s1ap_tx_pdu(const asn1::s1ap::s1ap_pdu_c& pdu, struct sctp_sndrcvinfo
     return false;
   }
 
-  if (m_pcap_enable) {
-    m_pcap.write_s1ap(buf->msg, buf->N_bytes);
-  }
+  write_pcap(buf->msg, buf->N_bytes);
 
   return true;
 }
 
+void s1ap::write_pcap(uint8_t* pdu, uint32_t pdu_len)
+{
+  if (m_pcap_enable) {
+    m_pcap.write_s1ap(pdu, pdu_len);
+  }
+}
+
 void s1ap::handle_s1ap_rx_pdu(srslte::byte_buffer_t* pdu, struct sctp_sndrcvinfo* enb_sri)
 {
   // Save PCAP
@@ -245,7 +264,7 @@ void s1ap::handle_s1ap_rx_pdu(srslte::byte_buffer_t* pdu, struct sctp_sndrcvinfo
       break;
     case s1ap_pdu_t::types_opts::successful_outcome:
       m_s1ap_log->info("Received Succeseful Outcome PDU\n");
-      handle_successful_outcome(rx_pdu.successful_outcome());
+      handle_successful_outcome(rx_pdu.successful_outcome(), enb_sri);
       break;
     case s1ap_pdu_t::types_opts::unsuccessful_outcome:
       m_s1ap_log->info("Received Unsucceseful Outcome PDU\n");
@@ -283,7 +302,7 @@ void s1ap::handle_initiating_message(const asn1::s1ap::init_msg_s& msg, struct s
   }
 }
 
-void s1ap::handle_successful_outcome(const asn1::s1ap::successful_outcome_s& msg)
+void s1ap::handle_successful_outcome(const asn1::s1ap::successful_outcome_s& msg, struct sctp_sndrcvinfo* enb_sri)
 {
   using successful_outcome_type_opts_t = asn1::s1ap::s1ap_elem_procs_o::successful_outcome_c::types_opts;
 
@@ -296,6 +315,14 @@ void s1ap::handle_successful_outcome(const asn1::s1ap::successful_outcome_s& msg
       m_s1ap_log->info("Received UE Context Release Complete\n");
       m_s1ap_ctx_mngmt_proc->handle_ue_context_release_complete(msg.value.ue_context_release_complete());
       break;
+    case successful_outcome_type_opts_t::write_replace_warning_resp:
+      m_s1ap_log->info("Received Write-Replace Warning Response\n");
+      m_s1ap_warning->handle_write_replace_warning_response(msg.value.write_replace_warning_resp(), enb_sri);
+      break;
+    case successful_outcome_type_opts_t::kill_resp:
+      m_s1ap_log->info("Received Kill Response\n");
+      m_s1ap_warning->handle_kill_response(msg.value.kill_resp(), enb_sri);
+      break;
     default:
       m_s1ap_log->error("Unhandled successful outcome message: %s\n", msg.value.type().to_string().c_str());
   }
@@ -311,6 +338,7 @@ void s1ap::add_new_enb_ctx(const enb_ctx_t& enb_ctx, const struct sctp_sndrcvinf
   m_active_enbs.insert(std::pair<uint16_t, enb_ctx_t*>(enb_ptr->enb_id, enb_ptr));
   m_sctp_to_enb_id.insert(std::pair<int32_t, uint16_t>(enb_sri->sinfo_assoc_id, enb_ptr->enb_id));
   m_enb_assoc_to_ue_ids.insert(std::pair<int32_t, std::set<uint32_t> >(enb_sri->sinfo_assoc_id, ue_set));
+  m_s1ap_fanout->add_enb(enb_ptr);
 }
 
 enb_ctx_t* s1ap::find_enb_ctx(uint16_t enb_id)
@@ -341,6 +369,7 @@ void s1ap::delete_enb_ctx(int32_t assoc_id)
   release_ues_ecm_ctx_in_enb(assoc_id);
 
   // Delete eNB
+  m_s1ap_fanout->remove_enb(it_ctx->second);
   delete it_ctx->second;
   m_active_enbs.erase(it_ctx);
   m_sctp_to_enb_id.erase(it_assoc);
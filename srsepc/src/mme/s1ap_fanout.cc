@@ -0,0 +1,212 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+#include "srsepc/hdr/mme/s1ap_fanout.h"
+#include <algorithm>
+#include <chrono>
+
+namespace srsepc {
+
+s1ap_fanout*    s1ap_fanout::m_instance    = NULL;
+pthread_mutex_t s1ap_fanout_instance_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+s1ap_fanout::s1ap_fanout() : m_s1mme(-1), m_s1ap_log(NULL), m_pcap(NULL), m_pool(NULL)
+{
+  return;
+}
+
+s1ap_fanout::~s1ap_fanout()
+{
+  return;
+}
+
+s1ap_fanout* s1ap_fanout::get_instance(void)
+{
+  pthread_mutex_lock(&s1ap_fanout_instance_mutex);
+  if (NULL == m_instance) {
+    m_instance = new s1ap_fanout();
+  }
+  pthread_mutex_unlock(&s1ap_fanout_instance_mutex);
+  return (m_instance);
+}
+
+void s1ap_fanout::cleanup(void)
+{
+  pthread_mutex_lock(&s1ap_fanout_instance_mutex);
+  if (NULL != m_instance) {
+    delete m_instance;
+    m_instance = NULL;
+  }
+  pthread_mutex_unlock(&s1ap_fanout_instance_mutex);
+}
+
+void s1ap_fanout::init(int s1mme, srslte::log_filter* s1ap_log, srslte::s1ap_pcap* pcap)
+{
+  m_s1mme    = s1mme;
+  m_s1ap_log = s1ap_log;
+  m_pcap     = pcap;
+  m_pool     = srslte::byte_buffer_pool::get_instance();
+
+  // Every message of a batch points to the same encoded PDU, and carries the SCTP association of its eNB
+  bzero(m_msgs, sizeof(m_msgs));
+  bzero(m_cmsg_buf, sizeof(m_cmsg_buf));
+  for (uint32_t i = 0; i < FANOUT_MAX_BATCH; i++) {
+    m_msgs[i].msg_hdr.msg_iov        = &m_iov;
+    m_msgs[i].msg_hdr.msg_iovlen     = 1;
+    m_msgs[i].msg_hdr.msg_control    = m_cmsg_buf[i];
+    m_msgs[i].msg_hdr.msg_controllen = sizeof(m_cmsg_buf[i]);
+    struct cmsghdr* cmsg             = CMSG_FIRSTHDR(&m_msgs[i].msg_hdr);
+    cmsg->cmsg_level                 = IPPROTO_SCTP;
+    cmsg->cmsg_type                  = SCTP_SNDRCV;
+    cmsg->cmsg_len                   = CMSG_LEN(sizeof(struct sctp_sndrcvinfo));
+  }
+}
+
+/* Indexes the eNB under every TAI it serves, i.e. each of its TACs combined with each of the broadcasted PLMNs */
+void s1ap_fanout::add_enb(enb_ctx_t* enb_ctx)
+{
+  if (std::find(m_all_enbs.begin(), m_all_enbs.end(), enb_ctx) == m_all_enbs.end()) {
+    m_all_enbs.push_back(enb_ctx);
+  }
+  for (uint32_t i = 0; i < enb_ctx->nof_supported_ta; i++) {
+    for (uint32_t j = 0; j < enb_ctx->nof_supported_bplmns[i]; j++) {
+      std::vector<enb_ctx_t*>& enbs = m_tai_to_enbs[tai_key(enb_ctx->bplmns[i][j], enb_ctx->tac[i])];
+      if (std::find(enbs.begin(), enbs.end(), enb_ctx) == enbs.end()) {
+        enbs.push_back(enb_ctx);
+      }
+    }
+  }
+}
+
+void s1ap_fanout::remove_enb(enb_ctx_t* enb_ctx)
+{
+  m_all_enbs.erase(std::remove(m_all_enbs.begin(), m_all_enbs.end(), enb_ctx), m_all_enbs.end());
+  std::map<uint64_t, std::vector<enb_ctx_t*> >::iterator it = m_tai_to_enbs.begin();
+  while (it != m_tai_to_enbs.end()) {
+    it->second.erase(std::remove(it->second.begin(), it->second.end(), enb_ctx), it->second.end());
+    if (it->second.empty()) {
+      m_tai_to_enbs.erase(it++);
+    } else {
+      it++;
+    }
+  }
+}
+
+bool s1ap_fanout::send_to_all(const asn1::s1ap::s1ap_pdu_c& pdu, fanout_result_t* result)
+{
+  return send(pdu, m_all_enbs, result);
+}
+
+bool s1ap_fanout::send_to_tais(const asn1::s1ap::s1ap_pdu_c& pdu,
+                               const std::vector<uint64_t>&  tai_list,
+                               fanout_result_t*              result)
+{
+  m_enbs.clear();
+  for (uint32_t i = 0; i < tai_list.size(); i++) {
+    std::map<uint64_t, std::vector<enb_ctx_t*> >::iterator it = m_tai_to_enbs.find(tai_list[i]);
+    if (it != m_tai_to_enbs.end()) {
+      m_enbs.insert(m_enbs.end(), it->second.begin(), it->second.end());
+    }
+  }
+  // An eNB serving several TAIs of the list receives the PDU once
+  if (tai_list.size() > 1) {
+    std::sort(m_enbs.begin(), m_enbs.end());
+    m_enbs.erase(std::unique(m_enbs.begin(), m_enbs.end()), m_enbs.end());
+  }
+  return send(pdu, m_enbs, result);
+}
+
+bool s1ap_fanout::send(const asn1::s1ap::s1ap_pdu_c& pdu, const std::vector<enb_ctx_t*>& enbs, fanout_result_t* result)
+{
+  std::chrono::steady_clock::time_point tic        = std::chrono::steady_clock::now();
+  auto                                  elapsed_us = [&tic]() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tic)
+        .count();
+  };
+
+  result->nof_enbs    = enbs.size();
+  result->nof_sent    = 0;
+  result->nof_batches = 0;
+  result->enbs.resize(enbs.size());
+  if (enbs.empty()) {
+    result->encode_us = 0;
+    result->total_us  = 0;
+    return true;
+  }
+
+  // Encode the PDU once for all the eNBs
+  srslte::unique_byte_buffer_t buf = srslte::allocate_unique_buffer(*m_pool);
+  if (buf == nullptr) {
+    m_s1ap_log->error("Fatal Error: Couldn't allocate buffer for S1AP PDU.\n");
+    return false;
+  }
+  asn1::bit_ref bref(buf->msg, buf->get_tailroom());
+  if (pdu.pack(bref) != asn1::SRSASN_SUCCESS) {
+    m_s1ap_log->error("Could not pack S1AP PDU correctly.\n");
+    return false;
+  }
+  buf->N_bytes      = bref.distance_bytes();
+  m_iov.iov_base    = buf->msg;
+  m_iov.iov_len     = buf->N_bytes;
+  result->encode_us = elapsed_us();
+  if (m_pcap != NULL) {
+    m_pcap->write_s1ap(buf->msg, buf->N_bytes);
+  }
+
+  // Hand the PDU to SCTP in batches of up to FANOUT_MAX_BATCH eNBs
+  uint32_t next = 0;
+  while (next < enbs.size()) {
+    uint32_t nof_msgs = std::min((uint32_t)enbs.size() - next, FANOUT_MAX_BATCH);
+    for (uint32_t i = 0; i < nof_msgs; i++) {
+      memcpy(CMSG_DATA(CMSG_FIRSTHDR(&m_msgs[i].msg_hdr)), &enbs[next + i]->sri, sizeof(struct sctp_sndrcvinfo));
+      result->enbs[next + i].enb_id = enbs[next + i]->enb_id;
+      result->enbs[next + i].sent   = false;
+    }
+
+    int      n_sent  = sendmmsg(m_s1mme, m_msgs, nof_msgs, MSG_NOSIGNAL);
+    uint32_t tx_time = elapsed_us();
+    result->nof_batches++;
+    if (n_sent <= 0) {
+      // The first message of the batch failed. Skip its eNB and go on with the others
+      m_s1ap_log->error("Failed to send S1AP PDU. eNB Id: 0x%x. Error: %s\n", enbs[next]->enb_id, strerror(errno));
+      result->enbs[next].tx_latency_us = tx_time;
+      next++;
+      continue;
+    }
+    for (int i = 0; i < n_sent; i++) {
+      result->enbs[next + i].sent          = true;
+      result->enbs[next + i].tx_latency_us = tx_time;
+    }
+    result->nof_sent += n_sent;
+    next += n_sent;
+  }
+  result->total_us = elapsed_us();
+
+  m_s1ap_log->debug("Fan-out of %d byte S1AP PDU to %d/%d eNBs in %d SCTP batches. Encoding: %d us, total: %d us\n",
+                    buf->N_bytes,
+                    result->nof_sent,
+                    result->nof_enbs,
+                    result->nof_batches,
+                    result->encode_us,
+                    result->total_us);
+  return result->nof_sent == result->nof_enbs;
+}
+
+} // namespace srsepc
@@ -151,6 +151,7 @@ bool s1ap_mngmt_proc::unpack_s1_setup_request(const asn1::s1ap::s1_setup_request
     enb_ctx->nof_supported_bplmns[i] = tas.broadcast_plmns.size();
     for (uint16_t j = 0; j < tas.broadcast_plmns.size(); j++) {
       // BPLMNs
+      enb_ctx->bplmns[i][j]                 = 0;
       ((uint8_t*)&enb_ctx->bplmns[i][j])[1] = tas.broadcast_plmns[j][0];
       ((uint8_t*)&enb_ctx->bplmns[i][j])[2] = tas.broadcast_plmns[j][1];
       ((uint8_t*)&enb_ctx->bplmns[i][j])[3] = tas.broadcast_plmns[j][2];
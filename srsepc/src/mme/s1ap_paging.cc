@@ -114,14 +114,19 @@ bool s1ap_paging::send_paging(uint64_t imsi, uint16_t erab_to_setup)
     return false;
   }
 
-  for (std::map<uint16_t, enb_ctx_t*>::iterator it = m_s1ap->m_active_enbs.begin(); it != m_s1ap->m_active_enbs.end();
-       it++) {
-    enb_ctx_t* enb_ctx = it->second;
-    if (!m_s1ap->s1ap_tx_pdu(tx_pdu, &enb_ctx->sri)) {
-      m_s1ap_log->error("Error paging to eNB. eNB Id: 0x%x.\n", enb_ctx->enb_id);
-      return false;
-    }
+  // Page the UE in the eNBs serving its TAI
+  fanout_result_t       result;
+  std::vector<uint64_t> tai_list(1, s1ap_fanout::tai_key(plmn, tac));
+  bool                  ret = m_s1ap->m_s1ap_fanout->send_to_tais(tx_pdu, tai_list, &result);
+  if (result.nof_enbs == 0) {
+    m_s1ap_log->warning("No eNB serves TAC %d. Paging all eNBs\n", tac);
+    ret = m_s1ap->m_s1ap_fanout->send_to_all(tx_pdu, &result);
   }
+  if (!ret) {
+    m_s1ap_log->error("Error paging to eNBs. Sent to %d/%d eNBs\n", result.nof_sent, result.nof_enbs);
+    return false;
+  }
+  m_s1ap_log->info("Paged UE in %d eNBs in %d us\n", result.nof_sent, result.total_us);
 
   return true;
 }
@@ -0,0 +1,318 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+#include "srsepc/hdr/mme/s1ap_warning.h"
+#include "srsepc/hdr/mme/s1ap.h"
+#include "srslte/common/int_helpers.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <inttypes.h> // for printing uint64_t
+
+namespace srsepc {
+
+s1ap_warning*   s1ap_warning::m_instance    = NULL;
+pthread_mutex_t s1ap_warning_instance_mutex = PTHREAD_MUTEX_INITIALIZER;
+const uint64_t  s1ap_warning::min_response_timeout_us;
+
+s1ap_warning::s1ap_warning() : m_cbc(-1)
+{
+  bzero(&m_cbc_addr, sizeof(m_cbc_addr));
+  return;
+}
+
+s1ap_warning::~s1ap_warning()
+{
+  return;
+}
+
+s1ap_warning* s1ap_warning::get_instance(void)
+{
+  pthread_mutex_lock(&s1ap_warning_instance_mutex);
+  if (NULL == m_instance) {
+    m_instance = new s1ap_warning();
+  }
+  pthread_mutex_unlock(&s1ap_warning_instance_mutex);
+  return (m_instance);
+}
+
+void s1ap_warning::cleanup(void)
+{
+  pthread_mutex_lock(&s1ap_warning_instance_mutex);
+  if (NULL != m_instance) {
+    delete m_instance;
+    m_instance = NULL;
+  }
+  pthread_mutex_unlock(&s1ap_warning_instance_mutex);
+}
+
+void s1ap_warning::init(void)
+{
+  m_s1ap      = s1ap::get_instance();
+  m_s1ap_log  = m_s1ap->m_s1ap_log;
+  m_s1ap_args = m_s1ap->m_s1ap_args;
+  m_pool      = srslte::byte_buffer_pool::get_instance();
+
+  if (m_s1ap_args.cbc_port != 0) {
+    m_cbc = cbc_listen();
+  }
+}
+
+void s1ap_warning::stop(void)
+{
+  if (m_cbc != -1) {
+    close(m_cbc);
+    m_cbc = -1;
+  }
+}
+
+int s1ap_warning::get_cbc_socket()
+{
+  return m_cbc;
+}
+
+int s1ap_warning::cbc_listen()
+{
+  int sock_fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (sock_fd == -1) {
+    m_s1ap_log->error("Could not create CBC socket\n");
+    m_s1ap_log->console("Could not create CBC socket\n");
+    return -1;
+  }
+
+  struct sockaddr_in cbc_bind_addr;
+  bzero(&cbc_bind_addr, sizeof(cbc_bind_addr));
+  cbc_bind_addr.sin_family = AF_INET;
+  inet_pton(AF_INET, m_s1ap_args.cbc_bind_addr.c_str(), &(cbc_bind_addr.sin_addr));
+  cbc_bind_addr.sin_port = htons(m_s1ap_args.cbc_port);
+  if (bind(sock_fd, (struct sockaddr*)&cbc_bind_addr, sizeof(cbc_bind_addr)) != 0) {
+    close(sock_fd);
+    m_s1ap_log->error("Error binding CBC socket to %s:%d\n", m_s1ap_args.cbc_bind_addr.c_str(), m_s1ap_args.cbc_port);
+    m_s1ap_log->console("Error binding CBC socket\n");
+    return -1;
+  }
+
+  m_s1ap_log->info("Listening for CBC requests on %s:%d\n", m_s1ap_args.cbc_bind_addr.c_str(), m_s1ap_args.cbc_port);
+  return sock_fd;
+}
+
+void s1ap_warning::handle_cbc_msg(srslte::byte_buffer_t* pdu, const struct sockaddr_in& cbc_addr)
+{
+  uint64_t  rx_time_us = cbc_time_now_us();
+  cbc_msg_t msg        = {};
+  if (!cbc_unpack_msg(pdu->msg, pdu->N_bytes, &msg)) {
+    m_s1ap_log->error("Malformed CBC message of %d bytes\n", pdu->N_bytes);
+    return;
+  }
+  m_cbc_addr = cbc_addr;
+
+  m_s1ap_log->info("Received CBC message type %d, msg_id=0x%x, serial_num=0x%x. CBC to MME latency: %" PRId64 " us\n",
+                   msg.type,
+                   msg.msg_id,
+                   msg.serial_num,
+                   (int64_t)(rx_time_us - msg.timestamp_us));
+
+  switch (msg.type) {
+    case CBC_WRITE_REPLACE_WARNING_REQUEST:
+      send_write_replace_warning_request(msg);
+      break;
+    case CBC_KILL_REQUEST:
+      send_kill_request(msg);
+      break;
+    default:
+      m_s1ap_log->error("Unhandled CBC message type %d\n", msg.type);
+  }
+}
+
+bool s1ap_warning::send_write_replace_warning_request(const cbc_msg_t& msg)
+{
+  m_s1ap_log->info("Sending Write-Replace Warning Request. msg_id=0x%x, serial_num=0x%x\n", msg.msg_id, msg.serial_num);
+
+  s1ap_pdu_t tx_pdu;
+  tx_pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_WRITE_REPLACE_WARNING);
+  asn1::s1ap::write_replace_warning_request_ies_container& req =
+      tx_pdu.init_msg().value.write_replace_warning_request().protocol_ies;
+
+  req.msg_id.value.from_number(msg.msg_id);
+  req.serial_num.value.from_number(msg.serial_num);
+  req.repeat_period.value.value           = msg.repeat_period;
+  req.numof_broadcast_request.value.value = msg.nof_broadcasts;
+  if (msg.warning_type_present) {
+    req.warning_type_present = true;
+    srslte::uint16_to_uint8(msg.warning_type, req.warning_type.value.data());
+  }
+  if (msg.data_coding_scheme_present) {
+    req.data_coding_scheme_present = true;
+    req.data_coding_scheme.value.from_number(msg.data_coding_scheme);
+  }
+  if (msg.contents_len > 0) {
+    req.warning_msg_contents_present = true;
+    req.warning_msg_contents.value.resize(msg.contents_len);
+    memcpy(req.warning_msg_contents.value.data(), msg.contents, msg.contents_len);
+  }
+
+  // The warning area is not signalled, so every eNB broadcasts the warning in all of its cells
+  return send_to_all_enbs(tx_pdu, msg, "Write-Replace Warning Request");
+}
+
+bool s1ap_warning::send_kill_request(const cbc_msg_t& msg)
+{
+  m_s1ap_log->info("Sending Kill Request. msg_id=0x%x, serial_num=0x%x\n", msg.msg_id, msg.serial_num);
+
+  s1ap_pdu_t tx_pdu;
+  tx_pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_KILL);
+  asn1::s1ap::kill_request_ies_container& req = tx_pdu.init_msg().value.kill_request().protocol_ies;
+
+  req.msg_id.value.from_number(msg.msg_id);
+  req.serial_num.value.from_number(msg.serial_num);
+  if (msg.kill_all) {
+    req.kill_all_warning_msgs_present     = true;
+    req.kill_all_warning_msgs.value.value = asn1::s1ap::kill_all_warning_msgs_opts::true_value;
+  }
+
+  // The eNBs that did not answer the Write-Replace Warning Request yet are not waited for anymore
+  erase_tx_times(msg.msg_id, msg.serial_num, msg.kill_all);
+
+  return send_to_all_enbs(tx_pdu, msg, "Kill Request");
+}
+
+/* Sends the request to all the eNBs, and keeps the transmission time to each eNB to compute its response latency */
+bool s1ap_warning::send_to_all_enbs(const s1ap_pdu_t& tx_pdu, const cbc_msg_t& msg, const char* proc_name)
+{
+  fanout_result_t result;
+  uint64_t        tx_start_us = cbc_time_now_us();
+  uint64_t        timeout_us  = std::max((uint64_t)msg.repeat_period * 1000000, min_response_timeout_us);
+  expire_tx_times(tx_start_us);
+  bool ret = m_s1ap->m_s1ap_fanout->send_to_all(tx_pdu, &result);
+  for (uint32_t i = 0; i < result.enbs.size(); i++) {
+    if (!result.enbs[i].sent) {
+      m_s1ap_log->error("Error sending %s to eNB. eNB Id: 0x%x.\n", proc_name, result.enbs[i].enb_id);
+      continue;
+    }
+    tx_time_t& tx_time = m_tx_time_us[tx_time_key(result.enbs[i].enb_id, msg.msg_id, msg.serial_num)];
+    tx_time.tx_us      = tx_start_us + result.enbs[i].tx_latency_us;
+    tx_time.expiry_us  = tx_time.tx_us + timeout_us;
+  }
+  m_s1ap_log->info("Sent %s to %d/%d eNBs in %d us (encoding %d us, %d SCTP batches)\n",
+                   proc_name,
+                   result.nof_sent,
+                   result.nof_enbs,
+                   result.total_us,
+                   result.encode_us,
+                   result.nof_batches);
+  return ret;
+}
+
+void s1ap_warning::handle_write_replace_warning_response(const asn1::s1ap::write_replace_warning_resp_s& msg,
+                                                         struct sctp_sndrcvinfo*                         enb_sri)
+{
+  const asn1::s1ap::write_replace_warning_resp_ies_container& resp = msg.protocol_ies;
+  m_s1ap_log->info("Received Write-Replace Warning Response. msg_id=0x%x, broadcasting=%s\n",
+                   (uint32_t)resp.msg_id.value.to_number(),
+                   resp.broadcast_completed_area_list_present ? "true" : "false");
+  send_cbc_response(CBC_WRITE_REPLACE_WARNING_RESPONSE,
+                    resp.msg_id.value.to_number(),
+                    resp.serial_num.value.to_number(),
+                    resp.broadcast_completed_area_list_present,
+                    enb_sri);
+}
+
+void s1ap_warning::handle_kill_response(const asn1::s1ap::kill_resp_s& msg, struct sctp_sndrcvinfo* enb_sri)
+{
+  const asn1::s1ap::kill_resp_ies_container& resp = msg.protocol_ies;
+  m_s1ap_log->info("Received Kill Response. msg_id=0x%x, cancelled=%s\n",
+                   (uint32_t)resp.msg_id.value.to_number(),
+                   resp.broadcast_cancelled_area_list_present ? "true" : "false");
+  send_cbc_response(CBC_KILL_RESPONSE,
+                    resp.msg_id.value.to_number(),
+                    resp.serial_num.value.to_number(),
+                    resp.broadcast_cancelled_area_list_present,
+                    enb_sri);
+}
+
+/* Reports an eNB response to the CBC, together with the time elapsed since the request was sent to the eNBs */
+void s1ap_warning::send_cbc_response(uint8_t                 type,
+                                     uint16_t                msg_id,
+                                     uint16_t                serial_num,
+                                     bool                    success,
+                                     struct sctp_sndrcvinfo* enb_sri)
+{
+  cbc_msg_t cbc_msg    = {};
+  cbc_msg.type         = type;
+  cbc_msg.msg_id       = msg_id;
+  cbc_msg.serial_num   = serial_num;
+  cbc_msg.success      = success;
+  cbc_msg.timestamp_us = cbc_time_now_us();
+  for (std::map<uint16_t, enb_ctx_t*>::iterator it = m_s1ap->m_active_enbs.begin(); it != m_s1ap->m_active_enbs.end();
+       it++) {
+    if (it->second->sri.sinfo_assoc_id == enb_sri->sinfo_assoc_id) {
+      cbc_msg.enb_id = it->second->enb_id;
+    }
+  }
+
+  std::map<uint64_t, tx_time_t>::iterator it = m_tx_time_us.find(tx_time_key(cbc_msg.enb_id, msg_id, serial_num));
+  if (it != m_tx_time_us.end()) {
+    cbc_msg.latency_us = cbc_msg.timestamp_us - it->second.tx_us;
+    m_tx_time_us.erase(it);
+  }
+  m_s1ap_log->info("eNB 0x%x answered msg_id=0x%x after %d us\n", cbc_msg.enb_id, msg_id, cbc_msg.latency_us);
+
+  if (m_cbc == -1) {
+    return;
+  }
+  srslte::unique_byte_buffer_t buf = srslte::allocate_unique_buffer(*m_pool);
+  if (buf == nullptr) {
+    m_s1ap_log->error("Fatal Error: Couldn't allocate buffer for CBC response.\n");
+    return;
+  }
+  buf->N_bytes = cbc_pack_msg(cbc_msg, buf->msg, buf->get_tailroom());
+  if (sendto(m_cbc, buf->msg, buf->N_bytes, 0, (struct sockaddr*)&m_cbc_addr, sizeof(m_cbc_addr)) < 0) {
+    m_s1ap_log->error("Error sending response to the CBC: %s\n", strerror(errno));
+  }
+}
+
+/* Drops the transmission times of the eNBs that did not respond within the repetition period of the warning */
+void s1ap_warning::expire_tx_times(uint64_t now_us)
+{
+  for (std::map<uint64_t, tx_time_t>::iterator it = m_tx_time_us.begin(); it != m_tx_time_us.end();) {
+    if (it->second.expiry_us <= now_us) {
+      m_s1ap_log->debug("eNB 0x%x did not answer msg_id=0x%x\n",
+                        (uint32_t)(it->first >> 32u),
+                        (uint32_t)(it->first >> 16u) & 0xffffu);
+      m_tx_time_us.erase(it++);
+    } else {
+      it++;
+    }
+  }
+}
+
+/* Drops the transmission times of a warning, or of all the warnings, once it is killed */
+void s1ap_warning::erase_tx_times(uint16_t msg_id, uint16_t serial_num, bool all)
+{
+  uint32_t warning_key = tx_time_key(0, msg_id, serial_num);
+  for (std::map<uint64_t, tx_time_t>::iterator it = m_tx_time_us.begin(); it != m_tx_time_us.end();) {
+    if (all || (uint32_t)it->first == warning_key) {
+      m_tx_time_us.erase(it++);
+    } else {
+      it++;
+    }
+  }
+}
+
+} // namespace srsepc
@@ -0,0 +1,207 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsepc/hdr/mme/s1ap_fanout.h"
+#include "srslte/common/network_utils.h"
+#include "srslte/common/test_common.h"
+#include <poll.h>
+
+using namespace srsepc;
+
+/*
+ * Emulates many eNBs, each of them with its own SCTP association to the S1-MME socket, and fans out a Paging message
+ * to all of them and to the eNBs of one TAI. The fan-out to all the eNBs is timed over several rounds.
+ */
+
+const char*    mme_addr        = "127.0.100.1";
+const int      mme_port        = 36422;
+const uint32_t nof_enbs        = 256;
+const uint32_t nof_tacs        = 4;
+const uint32_t plmn            = 0x00f110;
+const uint32_t nof_rounds      = 100;
+const uint32_t max_fanout_us   = 5000; // Mean time to hand the PDU to SCTP for all the eNBs
+const int      rx_timeout_ms   = 1000;
+const uint32_t NONUE_STREAM_ID = 0;
+
+struct emulated_enbs_t {
+  srslte::socket_handler_t mme_socket;
+  srslte::socket_handler_t enb_sockets[nof_enbs];
+  enb_ctx_t                enb_ctx[nof_enbs];
+};
+
+/* Connects every eNB and learns its association from a first message carrying its index, as the S1 Setup would */
+int setup_enbs(emulated_enbs_t& e)
+{
+  using namespace srslte::net_utils;
+
+  TESTASSERT(sctp_init_server(&e.mme_socket, socket_type::seqpacket, mme_addr, mme_port));
+  struct sctp_event_subscribe evnts;
+  bzero(&evnts, sizeof(evnts));
+  evnts.sctp_data_io_event = 1;
+  TESTASSERT(setsockopt(e.mme_socket.fd(), IPPROTO_SCTP, SCTP_EVENTS, &evnts, sizeof(evnts)) == 0);
+
+  sockaddr_in mme_addr_in = e.mme_socket.get_addr_in();
+  for (uint32_t i = 0; i < nof_enbs; i++) {
+    TESTASSERT(sctp_init_client(&e.enb_sockets[i], socket_type::seqpacket, "127.0.0.1"));
+    TESTASSERT(e.enb_sockets[i].connect_to(mme_addr, mme_port));
+    ssize_t n_sent = sctp_sendmsg(e.enb_sockets[i].fd(),
+                                  &i,
+                                  sizeof(i),
+                                  (struct sockaddr*)&mme_addr_in,
+                                  sizeof(mme_addr_in),
+                                  htonl((uint32_t)ppid_values::S1AP),
+                                  0,
+                                  NONUE_STREAM_ID,
+                                  0,
+                                  0);
+    TESTASSERT(n_sent == sizeof(i));
+  }
+
+  uint32_t nof_setup = 0;
+  while (nof_setup < nof_enbs) {
+    uint32_t               enb_idx = 0;
+    struct sctp_sndrcvinfo sri     = {};
+    int                    flags   = 0;
+    ssize_t n_recv = sctp_recvmsg(e.mme_socket.fd(), &enb_idx, sizeof(enb_idx), NULL, NULL, &sri, &flags);
+    TESTASSERT(n_recv >= 0);
+    if (flags & MSG_NOTIFICATION) {
+      continue;
+    }
+    TESTASSERT(n_recv == sizeof(enb_idx) and enb_idx < nof_enbs);
+
+    enb_ctx_t& ctx              = e.enb_ctx[enb_idx];
+    ctx                         = {};
+    ctx.enb_id                  = enb_idx;
+    ctx.plmn                    = plmn;
+    ctx.nof_supported_ta        = 1;
+    ctx.tac[0]                  = enb_idx % nof_tacs;
+    ctx.nof_supported_bplmns[0] = 1;
+    ctx.bplmns[0][0]            = plmn;
+    ctx.sri                     = sri;
+    ctx.sri.sinfo_stream        = NONUE_STREAM_ID;
+    nof_setup++;
+  }
+  return SRSLTE_SUCCESS;
+}
+
+void make_paging(asn1::s1ap::s1ap_pdu_c& pdu, uint16_t tac)
+{
+  pdu.set_init_msg().load_info_obj(ASN1_S1AP_ID_PAGING);
+  asn1::s1ap::paging_ies_container& paging = pdu.init_msg().value.paging().protocol_ies;
+  paging.ue_id_idx_value.value.from_number(1);
+  paging.ue_paging_id.value.set_s_tmsi();
+  paging.ue_paging_id.value.s_tmsi().mmec.from_number(0x1a);
+  paging.ue_paging_id.value.s_tmsi().m_tmsi.from_number(0x12345678);
+  paging.cn_domain.value = asn1::s1ap::cn_domain_opts::ps;
+  paging.tai_list.value.resize(1);
+  paging.tai_list.value[0].load_info_obj(ASN1_S1AP_ID_TAI_ITEM);
+  paging.tai_list.value[0].value.tai_item().tai.plm_nid.from_number(plmn);
+  paging.tai_list.value[0].value.tai_item().tai.tac.from_number(tac);
+}
+
+/* Checks that exactly the expected eNBs received one PDU */
+int check_rx(emulated_enbs_t& e, const std::vector<bool>& expected)
+{
+  uint8_t buf[1024];
+  for (uint32_t i = 0; i < nof_enbs; i++) {
+    struct pollfd pfd = {e.enb_sockets[i].fd(), POLLIN, 0};
+    int           ret = poll(&pfd, 1, expected[i] ? rx_timeout_ms : 0);
+    if (not expected[i]) {
+      TESTASSERT(ret == 0);
+      continue;
+    }
+    TESTASSERT(ret == 1);
+    TESTASSERT(recv(e.enb_sockets[i].fd(), buf, sizeof(buf), 0) > 0);
+  }
+  return SRSLTE_SUCCESS;
+}
+
+int test_fanout(emulated_enbs_t& e)
+{
+  s1ap_fanout* fanout = s1ap_fanout::get_instance();
+  for (uint32_t i = 0; i < nof_enbs; i++) {
+    fanout->add_enb(&e.enb_ctx[i]);
+  }
+
+  // Send to all the eNBs
+  asn1::s1ap::s1ap_pdu_c pdu;
+  fanout_result_t        result;
+  uint64_t               sum_us = 0, max_us = 0;
+  make_paging(pdu, 0);
+  for (uint32_t r = 0; r < nof_rounds; r++) {
+    TESTASSERT(fanout->send_to_all(pdu, &result));
+    TESTASSERT(result.nof_enbs == nof_enbs and result.nof_sent == nof_enbs);
+    TESTASSERT(result.nof_batches == (nof_enbs + FANOUT_MAX_BATCH - 1) / FANOUT_MAX_BATCH);
+    TESTASSERT(result.enbs.size() == nof_enbs);
+    for (uint32_t i = 0; i < nof_enbs; i++) {
+      TESTASSERT(result.enbs[i].sent);
+      TESTASSERT(result.enbs[i].tx_latency_us <= result.total_us);
+    }
+    TESTASSERT(check_rx(e, std::vector<bool>(nof_enbs, true)) == SRSLTE_SUCCESS);
+    sum_us += result.total_us;
+    max_us = std::max(max_us, (uint64_t)result.total_us);
+  }
+  printf("Fan-out to %d eNBs: mean %.1f us, max %d us\n", nof_enbs, (float)sum_us / nof_rounds, (uint32_t)max_us);
+  TESTASSERT(sum_us / nof_rounds < max_fanout_us);
+
+  // Send to the eNBs serving one TAI
+  const uint16_t        tac = 1;
+  std::vector<uint64_t> tai_list(1, s1ap_fanout::tai_key(plmn, tac));
+  std::vector<bool>     expected(nof_enbs);
+  make_paging(pdu, tac);
+  TESTASSERT(fanout->send_to_tais(pdu, tai_list, &result));
+  TESTASSERT(result.nof_enbs == nof_enbs / nof_tacs and result.nof_sent == result.nof_enbs);
+  for (uint32_t i = 0; i < nof_enbs; i++) {
+    expected[i] = e.enb_ctx[i].tac[0] == tac;
+  }
+  TESTASSERT(check_rx(e, expected) == SRSLTE_SUCCESS);
+
+  // A removed eNB does not receive the PDU anymore
+  fanout->remove_enb(&e.enb_ctx[tac]);
+  expected[tac] = false;
+  TESTASSERT(fanout->send_to_tais(pdu, tai_list, &result));
+  TESTASSERT(result.nof_enbs == nof_enbs / nof_tacs - 1);
+  TESTASSERT(check_rx(e, expected) == SRSLTE_SUCCESS);
+  TESTASSERT(fanout->send_to_all(pdu, &result));
+  TESTASSERT(result.nof_enbs == nof_enbs - 1);
+  std::vector<bool> all_but_removed(nof_enbs, true);
+  all_but_removed[tac] = false;
+  TESTASSERT(check_rx(e, all_but_removed) == SRSLTE_SUCCESS);
+
+  return SRSLTE_SUCCESS;
+}
+
+int main()
+{
+  srslte::log_filter s1ap_log("S1AP");
+  s1ap_log.set_level(srslte::LOG_LEVEL_INFO);
+  srslte::byte_buffer_pool::get_instance();
+
+  std::unique_ptr<emulated_enbs_t> enbs(new emulated_enbs_t);
+  TESTASSERT(setup_enbs(*enbs) == SRSLTE_SUCCESS);
+  s1ap_fanout::get_instance()->init(enbs->mme_socket.fd(), &s1ap_log, NULL);
+  TESTASSERT(test_fanout(*enbs) == SRSLTE_SUCCESS);
+
+  s1ap_fanout::cleanup();
+  srslte::byte_buffer_pool::cleanup();
+  printf("Success\n");
+  return SRSLTE_SUCCESS;
+}
@@ -24,6 +24,7 @@
 
 #include "rrc_common.h"
 #include "rrc_metrics.h"
+#include "rrc_warning.h"
 #include "srslte/asn1/rrc_asn1.h"
 #include "srslte/asn1/rrc_asn1_utils.h"
 #include "srslte/common/bcd_helpers.h"
@@ -526,6 +527,7 @@ private:
   class go_idle_proc;
   class cell_reselection_proc;
   class connection_reest_proc;
+  class warning_acquire_proc;
   srslte::proc_t<cell_search_proc, phy_interface_rrc_lte::cell_search_ret_t> cell_searcher;
   srslte::proc_t<si_acquire_proc>                                            si_acquirer;
   srslte::proc_t<serving_cell_config_proc>                                   serv_cell_cfg;
@@ -536,6 +538,7 @@ private:
   srslte::proc_t<plmn_search_proc>                                           plmn_searcher;
   srslte::proc_t<cell_reselection_proc>                                      cell_reselector;
   srslte::proc_t<connection_reest_proc>                                      connection_reest;
+  srslte::proc_t<warning_acquire_proc>                                       warning_acquirer;
 
   srslte::proc_manager_list_t callback_list;
 
@@ -599,6 +602,13 @@ private:
   void handle_sib2();
   void handle_sib3();
   void handle_sib13();
+  void handle_warning_sib(const asn1::rrc::sib_info_item_c& sib, uint32_t* received_sibs, uint32_t* complete_sibs);
+
+  // Public warning messages (ETWS and CMAS)
+  std::array<warning_msg_reassembler, 3> warning_rx; ///< SIB10, SIB11 and SIB12 messages received
+  srslte::tti_point                      warning_paging_tti;
+  bool                                   warning_paging_rx = false;
+  srslte::timer_handler::unique_timer    warning_ind_timer; ///< Running while the warning indications are ignored
 
   void     handle_con_setup(asn1::rrc::rrc_conn_setup_s* setup);
   void     handle_con_reest(asn1::rrc::rrc_conn_reest_s* setup);
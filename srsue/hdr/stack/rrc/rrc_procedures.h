@@ -109,6 +109,50 @@ private:
   uint32_t                            sib_index = 0;
 };
 
+/*
+ * Acquires SIB10, SIB11 and SIB12 after a paging message with the ETWS or CMAS indication. Only the SI windows of
+ * the SI messages carrying the warning SIBs are searched, until every warning SIB has a complete message.
+ */
+class rrc::warning_acquire_proc
+{
+public:
+  const static int WARNING_SEARCH_TIMEOUT_MS = 10000;
+  const static int SI_ACQ_BUSY_RETRY_MS      = 10;
+  struct warning_timer_expired {
+    uint32_t timer_id;
+  };
+  struct warning_sib_received_ev {
+    uint32_t sib_mask;      ///< Bitmask of the warning SIB indexes carried by the SI message
+    uint32_t complete_mask; ///< Bitmask of the SIBs carrying a complete message, or one already received
+  };
+
+  explicit warning_acquire_proc(rrc* parent_);
+  srslte::proc_outcome_t init(bool etws_ind, bool cmas_ind);
+  srslte::proc_outcome_t step() { return srslte::proc_outcome_t::yield; }
+  static const char*     name() { return "Warning Acquire"; }
+  srslte::proc_outcome_t react(warning_timer_expired ev);
+  srslte::proc_outcome_t react(warning_sib_received_ev ev);
+  void                   then(const srslte::proc_state_t& result);
+
+private:
+  void start_next_window();
+
+  // conts
+  rrc*            rrc_ptr;
+  srslte::log_ref log_h;
+
+  // state
+  struct si_sched_t {
+    uint32_t sib_index;
+    uint32_t period;
+    uint32_t sched_index;
+  };
+  srslte::timer_handler::unique_timer acq_timeout, window_timer;
+  std::vector<si_sched_t>             si_msgs;           ///< SI messages carrying the warning SIBs
+  uint32_t                            pending_sibs  = 0; ///< Bitmask of the SIB indexes yet to be acquired
+  uint32_t                            received_sibs = 0; ///< Bitmask of the SIB indexes received at least once
+};
+
 class rrc::serving_cell_config_proc
 {
 public:
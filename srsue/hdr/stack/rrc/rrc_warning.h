@@ -0,0 +1,78 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#ifndef SRSUE_RRC_WARNING_H
+#define SRSUE_RRC_WARNING_H
+
+#include <chrono>
+#include <map>
+#include <stdint.h>
+#include <vector>
+
+namespace srsue {
+
+/**
+ * Reassembles the public warning messages (ETWS secondary notifications and CMAS notifications) broadcast in
+ * segments in SIB11 and SIB12. Segments are keyed by messageIdentifier and serialNumber (36.331 Section 5.2.1.4/5).
+ * A message is reported once. Further broadcasts with the same identifiers are discarded, until the message is
+ * replaced by a new serialNumber, it is not received for the expiry time or the reassembler is reset.
+ */
+class warning_msg_reassembler
+{
+public:
+  typedef std::chrono::steady_clock clock;
+
+  const static uint32_t MAX_NOF_SEGMENTS = 64;
+
+  enum class result_t { incomplete, complete, already_received, invalid };
+
+  /// The UE discards the duplicates of a warning message for 3 hours (TS 23.041)
+  explicit warning_msg_reassembler(clock::duration expiry_ = std::chrono::hours(3)) : expiry(expiry_) {}
+
+  result_t add_segment(uint16_t              msg_id,
+                       uint16_t              serial_num,
+                       uint32_t              segment_num,
+                       bool                  is_last,
+                       const uint8_t*        data,
+                       uint32_t              len,
+                       std::vector<uint8_t>* contents,
+                       clock::time_point     now = clock::now());
+  void     reset();
+  uint32_t nof_pending() const { return pending.size(); }
+  uint32_t nof_completed() const { return completed.size(); }
+
+private:
+  struct pending_msg_t {
+    std::vector<std::vector<uint8_t> > segments;
+    std::vector<bool>                  received;
+    int32_t                            last_segment = -1;
+  };
+
+  static uint32_t get_key(uint16_t msg_id, uint16_t serial_num) { return ((uint32_t)msg_id << 16u) | serial_num; }
+
+  clock::duration                       expiry;
+  std::map<uint32_t, pending_msg_t>     pending;
+  std::map<uint32_t, clock::time_point> completed; ///< Time of the last reception of each reported message
+};
+
+} // namespace srsue
+
+#endif // SRSUE_RRC_WARNING_H
@@ -123,6 +123,7 @@ public:
   void      start_cell_search() final;
   void      start_cell_select(const phy_interface_rrc_lte::phy_cell_t* cell) final;
   tti_point get_current_tti() final { return current_tti; }
+  void      warning_msg_received(const rrc_warning_msg_t& msg) final;
 
   // Task Handling interface
   srslte::timer_handler::unique_timer    get_unique_timer() final { return timers.get_unique_timer(); }
@@ -264,6 +264,10 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
      bpo::value<int>(&args->phy.nof_phy_threads)->default_value(3),
      "Number of PHY threads")
 
+    ("phy.nof_cb_workers",
+     bpo::value<uint32_t>(&args->phy.nof_cb_workers)->default_value(0),
+     "Number of threads decoding PDSCH code blocks for all the PHY threads (0 disables them)")
+
     ("phy.equalizer_mode",
      bpo::value<string>(&args->phy.equalizer_mode)->default_value("mmse"),
      "Equalizer mode")
@@ -375,6 +379,10 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
      bpo::value<uint32_t>(&args->phy.nof_out_of_sync_events)->default_value(20),
      "Number of PHY out-sync events before sending an out-sync event to RRC")
 
+    ("phy.simd_isa",
+     bpo::value<string>(&args->phy.simd_isa)->default_value("auto"),
+     "Highest instruction set of the SIMD kernels: auto, sse, avx2 or avx512")
+
     // UE simulation args
     ("sim.airplane_t_on_ms",
      bpo::value<int>(&args->stack.nas.sim.airplane_t_on_ms)->default_value(-1),
@@ -478,6 +486,11 @@ static int parse_args(all_args_t* args, int argc, char* argv[])
     args->stack.usim.using_op = vm.count("usim.op");
   }
 
+  if (srslte_simd_isa_set(args->phy.simd_isa.c_str()) != SRSLTE_SUCCESS) {
+    cout << "Error parsing phy.simd_isa: " << args->phy.simd_isa << "." << endl;
+    return SRSLTE_ERROR;
+  }
+
   // Apply all_level to any unset layers
   if (vm.count("log.all_level")) {
     if (!vm.count("log.rf_level")) {
@@ -590,6 +603,10 @@ int main(int argc, char* argv[])
     return SRSLTE_ERROR;
   };
 
+  char simd_info[128] = {};
+  srslte_simd_isa_info(simd_info, sizeof(simd_info));
+  cout << simd_info << endl;
+
   // Setup logging
   srslte::logger_stdout logger_stdout;
   srslte::logger*       logger = nullptr;
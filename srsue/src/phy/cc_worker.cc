@@ -56,17 +56,21 @@ cc_worker::cc_worker(uint32_t cc_idx_, uint32_t max_prb, srsue::phy_common* phy_
 
   signal_buffer_max_samples = 3 * SRSLTE_SF_LEN_PRB(max_prb);
 
-  for (uint32_t i = 0; i < phy->args->nof_rx_ant; i++) {
-    signal_buffer_rx[i] = srslte_vec_cf_malloc(signal_buffer_max_samples);
-    if (!signal_buffer_rx[i]) {
-      Error("Allocating memory\n");
-      return;
-    }
-    signal_buffer_tx[i] = srslte_vec_cf_malloc(signal_buffer_max_samples);
-    if (!signal_buffer_tx[i]) {
-      Error("Allocating memory\n");
-      return;
-    }
+  // The antennas share one block at a fixed stride, so the OFDM transforms them with a single plan
+  uint32_t nof_ant    = phy->args->nof_rx_ant;
+  signal_buffer_rx[0] = srslte_vec_cf_malloc(signal_buffer_max_samples * nof_ant);
+  if (!signal_buffer_rx[0]) {
+    Error("Allocating memory\n");
+    return;
+  }
+  signal_buffer_tx[0] = srslte_vec_cf_malloc(signal_buffer_max_samples * nof_ant);
+  if (!signal_buffer_tx[0]) {
+    Error("Allocating memory\n");
+    return;
+  }
+  for (uint32_t i = 1; i < nof_ant; i++) {
+    signal_buffer_rx[i] = signal_buffer_rx[0] + signal_buffer_max_samples * i;
+    signal_buffer_tx[i] = signal_buffer_tx[0] + signal_buffer_max_samples * i;
   }
 
   if (srslte_ue_dl_init(&ue_dl, signal_buffer_rx, max_prb, phy->args->nof_rx_ant)) {
@@ -99,17 +103,17 @@ cc_worker::cc_worker(uint32_t cc_idx_, uint32_t max_prb, srsue::phy_common* phy_
     ue_dl.pdsch.llr_is_8bit        = true;
     ue_dl.pdsch.dl_sch.llr_is_8bit = true;
   }
+  srslte_sch_enable_cb_workers(&ue_dl.pdsch.dl_sch, phy->args->nof_cb_workers > 0);
 }
 
 cc_worker::~cc_worker()
 {
-  for (uint32_t i = 0; i < phy->args->nof_rx_ant; i++) {
-    if (signal_buffer_tx[i]) {
-      free(signal_buffer_tx[i]);
-    }
-    if (signal_buffer_rx[i]) {
-      free(signal_buffer_rx[i]);
-    }
+  // All the antennas point into the block allocated for the first one
+  if (signal_buffer_tx[0]) {
+    free(signal_buffer_tx[0]);
+  }
+  if (signal_buffer_rx[0]) {
+    free(signal_buffer_rx[0]);
   }
   srslte_ue_dl_free(&ue_dl);
   srslte_ue_ul_free(&ue_ul);
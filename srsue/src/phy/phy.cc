@@ -182,6 +182,11 @@ void phy::run_thread()
   prach_buffer.init(SRSLTE_MAX_PRB, log_h);
   common.init(&args, (srslte::log*)log_vec[0].get(), radio, stack);
 
+  // Start the code block decoders shared by the PDSCH of all the workers
+  if (srslte_sch_cb_workers_init(args.nof_cb_workers, WORKERS_THREAD_PRIO)) {
+    log_h->error("Error starting %d code block decoder threads\n", args.nof_cb_workers);
+  }
+
   // Add workers to workers pool and start threads
   for (uint32_t i = 0; i < nof_workers; i++) {
     auto w = std::unique_ptr<sf_worker>(new sf_worker(
@@ -229,6 +234,7 @@ void phy::stop()
     sfsync.stop();
     workers_pool.stop();
     prach_buffer.stop();
+    srslte_sch_cb_workers_free();
 
     is_configured = false;
   }
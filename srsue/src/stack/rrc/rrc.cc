@@ -99,6 +99,7 @@ rrc::rrc(stack_interface_rrc* stack_) :
   plmn_searcher(this),
   cell_reselector(this),
   connection_reest(this),
+  warning_acquirer(this),
   serving_cell(unique_cell_t(new cell_t()))
 {
   measurements = std::unique_ptr<rrc_meas>(new rrc_meas());
@@ -161,6 +162,8 @@ void rrc::init(phy_interface_rrc_lte* phy_,
   t311 = stack->get_unique_timer();
   t304 = stack->get_unique_timer();
 
+  warning_ind_timer = stack->get_unique_timer();
+
   ue_identity_configured = false;
 
   transaction_id = 0;
@@ -1500,6 +1503,7 @@ void rrc::parse_pdu_bcch_dlsch(unique_byte_buffer_t pdu)
   } else {
     sys_info_r8_ies_s::sib_type_and_info_l_& sib_list =
         dlsch_msg.msg.c1().sys_info().crit_exts.sys_info_r8().sib_type_and_info;
+    uint32_t warning_sibs = 0, complete_warning_sibs = 0;
     for (uint32_t i = 0; i < sib_list.size(); ++i) {
       rrc_log->info("Processing SIB%d (%d/%d)\n", sib_list[i].type().to_number(), i, sib_list.size());
       switch (sib_list[i].type().value) {
@@ -1524,10 +1528,19 @@ void rrc::parse_pdu_bcch_dlsch(unique_byte_buffer_t pdu)
           }
           handle_sib13();
           break;
+        case sib_info_item_c::types::sib10:
+        case sib_info_item_c::types::sib11:
+        case sib_info_item_c::types::sib12_v920:
+          handle_warning_sib(sib_list[i], &warning_sibs, &complete_warning_sibs);
+          break;
         default:
           rrc_log->warning("SIB%d is not supported\n", sib_list[i].type().to_number());
       }
     }
+    // The warning SIBs of a SI message share its SI window, which the acquisition moves past only once
+    if (warning_sibs != 0) {
+      warning_acquirer.trigger(warning_acquire_proc::warning_sib_received_ev{warning_sibs, complete_warning_sibs});
+    }
   }
 }
 
@@ -1673,6 +1686,79 @@ void rrc::write_pdu_pcch(unique_byte_buffer_t pdu)
   cmd_q.push(std::move(msg));
 }
 
+/* Reports the warning messages of SIB10 (ETWS primary notification), and reassembles the segmented ones of SIB11
+ * (ETWS secondary notification) and SIB12 (CMAS notification) before reporting them. The SIB index is set in the
+ * received_sibs bitmask, and also in complete_sibs if it carries a complete message or one already received */
+void rrc::handle_warning_sib(const sib_info_item_c& sib, uint32_t* received_sibs, uint32_t* complete_sibs)
+{
+  rrc_warning_msg_t                 msg = {};
+  warning_msg_reassembler::result_t ret = warning_msg_reassembler::result_t::invalid;
+  uint32_t                          sib_index;
+  switch (sib.type().value) {
+    case sib_info_item_c::types::sib10: {
+      const sib_type10_s& sib10 = sib.sib10();
+      sib_index                 = 9;
+      msg.type                  = rrc_warning_msg_t::type_t::etws_primary;
+      msg.msg_id                = sib10.msg_id.to_number();
+      msg.serial_num            = sib10.serial_num.to_number();
+      msg.warning_type          = ((uint16_t)sib10.warning_type[0] << 8u) | sib10.warning_type[1];
+      ret = warning_rx[0].add_segment(msg.msg_id, msg.serial_num, 0, true, nullptr, 0, &msg.contents);
+    } break;
+    case sib_info_item_c::types::sib11: {
+      const sib_type11_s& sib11 = sib.sib11();
+      sib_index                 = 10;
+      msg.type                  = rrc_warning_msg_t::type_t::etws_secondary;
+      msg.msg_id                = sib11.msg_id.to_number();
+      msg.serial_num            = sib11.serial_num.to_number();
+      msg.data_coding_scheme    = sib11.data_coding_scheme_present ? sib11.data_coding_scheme[0] : 0;
+      ret                       = warning_rx[1].add_segment(
+          msg.msg_id,
+          msg.serial_num,
+          sib11.warning_msg_segment_num,
+          sib11.warning_msg_segment_type.value == sib_type11_s::warning_msg_segment_type_opts::last_segment,
+          sib11.warning_msg_segment.data(),
+          sib11.warning_msg_segment.size(),
+          &msg.contents);
+    } break;
+    case sib_info_item_c::types::sib12_v920: {
+      const sib_type12_r9_s& sib12 = sib.sib12_v920();
+      sib_index                    = 11;
+      msg.type                     = rrc_warning_msg_t::type_t::cmas;
+      msg.msg_id                   = sib12.msg_id_r9.to_number();
+      msg.serial_num               = sib12.serial_num_r9.to_number();
+      msg.data_coding_scheme       = sib12.data_coding_scheme_r9_present ? sib12.data_coding_scheme_r9[0] : 0;
+      ret                          = warning_rx[2].add_segment(
+          msg.msg_id,
+          msg.serial_num,
+          sib12.warning_msg_segment_num_r9,
+          sib12.warning_msg_segment_type_r9.value == sib_type12_r9_s::warning_msg_segment_type_r9_opts::last_segment,
+          sib12.warning_msg_segment_r9.data(),
+          sib12.warning_msg_segment_r9.size(),
+          &msg.contents);
+    } break;
+    default:
+      return;
+  }
+
+  if (ret == warning_msg_reassembler::result_t::invalid) {
+    rrc_log->warning("Discarding invalid SIB%d segment of msg_id=0x%x\n", sib_index + 1, msg.msg_id);
+    return;
+  }
+  if (ret == warning_msg_reassembler::result_t::complete) {
+    msg.latency_ms = warning_paging_rx ? stack->get_current_tti() - warning_paging_tti : -1;
+    rrc_log->info("Received SIB%d msg_id=0x%x, serial_num=0x%x with %zd bytes\n",
+                  sib_index + 1,
+                  msg.msg_id,
+                  msg.serial_num,
+                  msg.contents.size());
+    stack->warning_msg_received(msg);
+  }
+  *received_sibs |= 1u << sib_index;
+  if (ret != warning_msg_reassembler::result_t::incomplete) {
+    *complete_sibs |= 1u << sib_index;
+  }
+}
+
 void rrc::paging_completed(bool outcome)
 {
   pcch_processor.trigger(process_pcch_proc::paging_complete{outcome});
@@ -1694,12 +1780,27 @@ void rrc::process_pcch(unique_byte_buffer_t pdu)
 
   log_rrc_message("PCCH", Rx, pdu.get(), pcch_msg, pcch_msg.msg.c1().type().to_string());
 
+  paging_s* paging = &pcch_msg.msg.c1().paging();
+
+  // Acquire the warning SIBs, unless they were already acquired in this modification period
+  bool etws_ind = paging->etws_ind_present;
+  bool cmas_ind = paging->non_crit_ext_present and paging->non_crit_ext.non_crit_ext_present and
+                  paging->non_crit_ext.non_crit_ext.cmas_ind_r9_present;
+  if ((etws_ind or cmas_ind) and warning_acquirer.is_idle() and not warning_ind_timer.is_running()) {
+    warning_paging_tti = stack->get_current_tti();
+    warning_paging_rx  = true;
+    if (warning_acquirer.launch(etws_ind, cmas_ind)) {
+      callback_list.add_proc(warning_acquirer);
+    } else {
+      rrc_log->error("Failed to launch the warning SIBs acquisition procedure\n");
+    }
+  }
+
   if (not ue_identity_configured) {
     rrc_log->warning("Received paging message but no ue-Identity is configured\n");
     return;
   }
 
-  paging_s* paging = &pcch_msg.msg.c1().paging();
   if (paging->paging_record_list.size() > ASN1_RRC_MAX_PAGE_REC) {
     paging->paging_record_list.resize(ASN1_RRC_MAX_PAGE_REC);
   }
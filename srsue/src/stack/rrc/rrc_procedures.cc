@@ -21,7 +21,9 @@
 
 #include "srsue/hdr/stack/rrc/rrc_procedures.h"
 #include "srslte/common/tti_point.h"
+#include <algorithm>
 #include <inttypes.h> // for printing uint64_t
+#include <limits>
 
 #define Error(fmt, ...) rrc_ptr->rrc_log->error("Proc \"%s\" - " fmt, name(), ##__VA_ARGS__)
 #define Warning(fmt, ...) rrc_ptr->rrc_log->warning("Proc \"%s\" - " fmt, name(), ##__VA_ARGS__)
@@ -359,6 +361,164 @@ proc_outcome_t rrc::si_acquire_proc::react(si_acq_timer_expired ev)
   return proc_outcome_t::error;
 }
 
+/**************************************
+ *    Warning SIBs Acquire Procedure
+ *************************************/
+
+rrc::warning_acquire_proc::warning_acquire_proc(rrc* parent_) :
+  rrc_ptr(parent_),
+  log_h(srslte::logmap::get("RRC")),
+  acq_timeout(rrc_ptr->stack->get_unique_timer()),
+  window_timer(rrc_ptr->stack->get_unique_timer())
+{
+  // NOTE: The standard does not specify this timeout
+  acq_timeout.set(WARNING_SEARCH_TIMEOUT_MS,
+                  [this](uint32_t tid) { rrc_ptr->warning_acquirer.trigger(warning_timer_expired{tid}); });
+  // Sets the callback. The duration will change for every SI window
+  window_timer.set(1, [this](uint32_t tid) { rrc_ptr->warning_acquirer.trigger(warning_timer_expired{tid}); });
+}
+
+proc_outcome_t rrc::warning_acquire_proc::init(bool etws_ind, bool cmas_ind)
+{
+  if (not rrc_ptr->serving_cell->has_sib1()) {
+    Error("Trying to acquire the warning SIBs but SIB1 not received yet\n");
+    return proc_outcome_t::error;
+  }
+
+  std::vector<uint32_t> sib_indexes;
+  if (etws_ind) {
+    sib_indexes.push_back(9);  // SIB10
+    sib_indexes.push_back(10); // SIB11
+  }
+  if (cmas_ind) {
+    sib_indexes.push_back(11); // SIB12
+  }
+
+  // Find the SI messages carrying the warning SIBs
+  si_msgs.clear();
+  pending_sibs  = 0;
+  received_sibs = 0;
+  for (uint32_t sib_index : sib_indexes) {
+    auto ret = compute_si_periodicity_and_idx(sib_index, rrc_ptr->serving_cell->sib1ptr());
+    if (ret.second < 0) {
+      Info("SIB%d is not scheduled in SIB1\n", sib_index + 1);
+      continue;
+    }
+    pending_sibs |= 1u << sib_index;
+    uint32_t sched_index = ret.second;
+    if (std::none_of(si_msgs.begin(), si_msgs.end(), [sched_index](const si_sched_t& si) {
+          return si.sched_index == sched_index;
+        })) {
+      si_msgs.push_back({sib_index, ret.first, sched_index});
+    }
+  }
+  if (si_msgs.empty()) {
+    Warning("Received a warning indication but no warning SIB is scheduled\n");
+    return proc_outcome_t::error;
+  }
+  Info("Starting acquisition of the warning SIBs in %zd SI messages\n", si_msgs.size());
+
+  start_next_window();
+  acq_timeout.run();
+
+  return proc_outcome_t::yield;
+}
+
+/*
+ * Instructs the MAC to search for the earliest SI window of the SI messages carrying warning SIBs. The window timer
+ * moves to the next window if nothing is received in this one
+ */
+void rrc::warning_acquire_proc::start_next_window()
+{
+  if (not rrc_ptr->si_acquirer.is_idle()) {
+    // The MAC searches one SI window at a time. Wait until the ongoing SI acquisition finishes
+    window_timer.set(SI_ACQ_BUSY_RETRY_MS);
+    window_timer.run();
+    return;
+  }
+
+  const asn1::rrc::sib_type1_s* sib1         = rrc_ptr->serving_cell->sib1ptr();
+  tti_point                     tti          = rrc_ptr->stack->get_current_tti();
+  uint32_t                      si_win_start = 0, si_win_len = 0, sched_index = 0;
+  int                           tics_until_si_win_start = std::numeric_limits<int>::max();
+  for (const si_sched_t& si : si_msgs) {
+    auto ret  = compute_si_window(tti.to_uint(), si.sib_index, si.sched_index, si.period, sib1);
+    int  tics = tti_point{ret.first} - tti;
+    if (tics >= 0 and tics < tics_until_si_win_start) {
+      tics_until_si_win_start = tics;
+      si_win_start            = ret.first;
+      si_win_len              = ret.second;
+      sched_index             = si.sched_index;
+    }
+  }
+  if (tics_until_si_win_start == std::numeric_limits<int>::max()) {
+    Error("The SI Window start was incorrectly calculated. tti=%d\n", tti.to_uint());
+    return;
+  }
+  rrc_ptr->mac->bcch_start_rx(si_win_start, si_win_len);
+
+  window_timer.set(tics_until_si_win_start + si_win_len);
+  window_timer.run();
+
+  Debug("Instructed MAC to search for the warning SIBs, win_start=%d, win_len=%d, sched_index=%d\n",
+        si_win_start,
+        si_win_len,
+        sched_index);
+}
+
+proc_outcome_t rrc::warning_acquire_proc::react(warning_sib_received_ev ev)
+{
+  received_sibs |= ev.sib_mask;
+  pending_sibs &= ~ev.complete_mask;
+  if (pending_sibs == 0) {
+    return proc_outcome_t::success;
+  }
+  // The MAC stopped the SI search after the reception. Move on to the next window
+  start_next_window();
+  return proc_outcome_t::yield;
+}
+
+proc_outcome_t rrc::warning_acquire_proc::react(warning_timer_expired ev)
+{
+  if (ev.timer_id == window_timer.id()) {
+    start_next_window();
+    return proc_outcome_t::yield;
+  }
+  if (ev.timer_id == acq_timeout.id()) {
+    Warning("Timeout while acquiring the warning SIBs\n");
+  } else {
+    Error("Unrecognized timer id\n");
+  }
+  return proc_outcome_t::error;
+}
+
+void rrc::warning_acquire_proc::then(const srslte::proc_state_t& result)
+{
+  window_timer.stop();
+  acq_timeout.stop();
+  if (rrc_ptr->si_acquirer.is_idle()) {
+    rrc_ptr->mac->bcch_stop_rx();
+  }
+
+  if (result.is_success() and rrc_ptr->serving_cell->has_sib2()) {
+    Info("Warning SIBs acquired successfully\n");
+    // Further warning indications of this modification period refer to the messages already acquired
+    const asn1::rrc::rr_cfg_common_sib_s& rr_cfg = rrc_ptr->serving_cell->sib2ptr()->rr_cfg_common;
+    rrc_ptr->warning_ind_timer.set(10 * rr_cfg.bcch_cfg.mod_period_coeff.to_number() *
+                                   rr_cfg.pcch_cfg.default_paging_cycle.to_number());
+    rrc_ptr->warning_ind_timer.run();
+  } else if (not result.is_success()) {
+    Warning("Failed to acquire the warning SIBs\n");
+    // A warning SIB that is indicated but never transmitted was killed. Its messages are reported again if resumed
+    for (uint32_t sib_index = 9; sib_index <= 11; ++sib_index) {
+      if ((pending_sibs & ~received_sibs & (1u << sib_index)) > 0) {
+        Info("SIB%d is no longer broadcast. Forgetting its warning messages\n", sib_index + 1);
+        rrc_ptr->warning_rx[sib_index - 9].reset();
+      }
+    }
+  }
+}
+
 /**************************************
  *    Serving Cell Config Procedure
  *************************************/
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srsue/hdr/stack/rrc/rrc_warning.h"
+#include <algorithm>
+#include <iterator>
+
+namespace srsue {
+
+/*
+ * Stores a segment of a warning message. When all the segments up to the last one are received, the complete
+ * message is written to contents and complete is returned
+ */
+warning_msg_reassembler::result_t warning_msg_reassembler::add_segment(uint16_t              msg_id,
+                                                                       uint16_t              serial_num,
+                                                                       uint32_t              segment_num,
+                                                                       bool                  is_last,
+                                                                       const uint8_t*        data,
+                                                                       uint32_t              len,
+                                                                       std::vector<uint8_t>* contents,
+                                                                       clock::time_point     now)
+{
+  // Forget the messages that were not received for the expiry time, they are no longer broadcast
+  for (auto it = completed.begin(); it != completed.end();) {
+    it = (now - it->second > expiry) ? completed.erase(it) : std::next(it);
+  }
+
+  uint32_t key           = get_key(msg_id, serial_num);
+  auto     completed_msg = completed.find(key);
+  if (completed_msg != completed.end()) {
+    completed_msg->second = now;
+    return result_t::already_received;
+  }
+  if (segment_num >= MAX_NOF_SEGMENTS) {
+    return result_t::invalid;
+  }
+
+  pending_msg_t& msg = pending[key];
+  if (is_last) {
+    if (msg.last_segment >= 0 and (uint32_t)msg.last_segment != segment_num) {
+      // The message changed without a new serial number. Start over
+      msg = {};
+    }
+    msg.last_segment = segment_num;
+  }
+  if (segment_num >= msg.segments.size()) {
+    msg.segments.resize(segment_num + 1);
+    msg.received.resize(segment_num + 1, false);
+  }
+  if (not msg.received[segment_num]) {
+    msg.segments[segment_num].assign(data, data + len);
+    msg.received[segment_num] = true;
+  }
+
+  if (msg.last_segment < 0 or
+      not std::all_of(msg.received.begin(), msg.received.begin() + msg.last_segment + 1, [](bool r) { return r; })) {
+    return result_t::incomplete;
+  }
+
+  contents->clear();
+  for (int32_t i = 0; i <= msg.last_segment; ++i) {
+    contents->insert(contents->end(), msg.segments[i].begin(), msg.segments[i].end());
+  }
+  pending.erase(key);
+
+  // The new serial number replaces the previous message with the same messageIdentifier
+  for (auto it = completed.begin(); it != completed.end();) {
+    it = (it->first >> 16u) == msg_id ? completed.erase(it) : std::next(it);
+  }
+  completed[key] = now;
+  return result_t::complete;
+}
+
+void warning_msg_reassembler::reset()
+{
+  pending.clear();
+  completed.clear();
+}
+
+} // namespace srsue
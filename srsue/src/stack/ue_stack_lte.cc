@@ -367,4 +367,27 @@ void ue_stack_lte::start_cell_select(const phy_interface_rrc_lte::phy_cell_t* ph
   });
 }
 
+void ue_stack_lte::warning_msg_received(const rrc_warning_msg_t& msg)
+{
+  const char* type_str = msg.type == rrc_warning_msg_t::type_t::etws_primary
+                             ? "ETWS primary notification"
+                             : (msg.type == rrc_warning_msg_t::type_t::etws_secondary ? "ETWS secondary notification"
+                                                                                      : "CMAS notification");
+  stack_log->console("Received %s msg_id=0x%x, serial_num=0x%x, %zd bytes. Latency since paging: %d ms\n",
+                     type_str,
+                     msg.msg_id,
+                     msg.serial_num,
+                     msg.contents.size(),
+                     msg.latency_ms);
+  stack_log->info_hex(msg.contents.data(),
+                      msg.contents.size(),
+                      "%s msg_id=0x%x, serial_num=0x%x, warning_type=0x%x, dcs=0x%x, latency=%d ms\n",
+                      type_str,
+                      msg.msg_id,
+                      msg.serial_num,
+                      msg.warning_type,
+                      msg.data_coding_scheme,
+                      msg.latency_ms);
+}
+
 } // namespace srsue
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2013-2020 Software Radio Systems Limited
+ *
+ * This file is part of srsLTE.
+ *
+ * srsLTE is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * srsLTE is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * A copy of the GNU Affero General Public License can be found in
+ * the LICENSE file in the top-level directory of this distribution
+ * and at http://www.gnu.org/licenses/.
+ *
+ */
+
+#include "srslte/common/test_common.h"
+#include "srsue/hdr/stack/rrc/rrc_warning.h"
+
+using namespace srsue;
+
+typedef warning_msg_reassembler::result_t result_t;
+
+int test_reassembly_out_of_order()
+{
+  warning_msg_reassembler reassembler;
+  std::vector<uint8_t>    contents;
+  uint8_t                 segments[3][4] = {{0, 1, 2, 3}, {4, 5, 6, 7}, {8, 9, 10, 11}};
+
+  // The last segment is received first
+  TESTASSERT(reassembler.add_segment(0x1112, 0x3000, 2, true, segments[2], 4, &contents) == result_t::incomplete);
+  TESTASSERT(reassembler.add_segment(0x1112, 0x3000, 0, false, segments[0], 4, &contents) == result_t::incomplete);
+  // Repetitions of a segment are ignored
+  TESTASSERT(reassembler.add_segment(0x1112, 0x3000, 0, false, segments[0], 4, &contents) == result_t::incomplete);
+  // Segments of another message are kept apart
+  TESTASSERT(reassembler.add_segment(0x1113, 0x3000, 1, false, segments[1], 4, &contents) == result_t::incomplete);
+  TESTASSERT(reassembler.nof_pending() == 2);
+
+  TESTASSERT(reassembler.add_segment(0x1112, 0x3000, 1, false, segments[1], 4, &contents) == result_t::complete);
+  TESTASSERT(contents.size() == 12);
+  for (uint32_t i = 0; i < contents.size(); ++i) {
+    TESTASSERT(contents[i] == i);
+  }
+  TESTASSERT(reassembler.nof_pending() == 1);
+
+  // The message is reported once
+  TESTASSERT(reassembler.add_segment(0x1112, 0x3000, 0, false, segments[0], 4, &contents) ==
+             result_t::already_received);
+  // A new serial number is a new message
+  TESTASSERT(reassembler.add_segment(0x1112, 0x3010, 0, true, segments[0], 4, &contents) == result_t::complete);
+  TESTASSERT(contents.size() == 4);
+
+  return SRSLTE_SUCCESS;
+}
+
+int test_reassembly_invalid()
+{
+  warning_msg_reassembler reassembler;
+  std::vector<uint8_t>    contents;
+  uint8_t                 segment[4] = {};
+
+  TESTASSERT(reassembler.add_segment(0x1112, 0x3000, warning_msg_reassembler::MAX_NOF_SEGMENTS, true, segment, 4,
+                                     &contents) == result_t::invalid);
+
+  // The last segment number changes without a new serial number. The message is reassembled again
+  TESTASSERT(reassembler.add_segment(0x1112, 0x3000, 1, true, segment, 4, &contents) == result_t::incomplete);
+  TESTASSERT(reassembler.add_segment(0x1112, 0x3000, 2, true, segment, 4, &contents) == result_t::incomplete);
+  TESTASSERT(reassembler.add_segment(0x1112, 0x3000, 1, false, segment, 4, &contents) == result_t::incomplete);
+  TESTASSERT(reassembler.add_segment(0x1112, 0x3000, 0, false, segment, 4, &contents) == result_t::complete);
+  TESTASSERT(contents.size() == 12);
+
+  reassembler.reset();
+  TESTASSERT(reassembler.add_segment(0x1112, 0x3000, 0, true, segment, 4, &contents) == result_t::complete);
+
+  return SRSLTE_SUCCESS;
+}
+
+int test_completed_eviction()
+{
+  warning_msg_reassembler                    reassembler{std::chrono::minutes(1)};
+  std::vector<uint8_t>                       contents;
+  uint8_t                                    segment[4] = {};
+  warning_msg_reassembler::clock::time_point t          = warning_msg_reassembler::clock::now();
+
+  TESTASSERT(reassembler.add_segment(0x1112, 0x3000, 0, true, segment, 4, &contents, t) == result_t::complete);
+  TESTASSERT(reassembler.add_segment(0x1113, 0x3000, 0, true, segment, 4, &contents, t) == result_t::complete);
+  TESTASSERT(reassembler.nof_completed() == 2);
+
+  // A new serial number replaces the message with the same messageIdentifier
+  TESTASSERT(reassembler.add_segment(0x1112, 0x3010, 0, true, segment, 4, &contents, t) == result_t::complete);
+  TESTASSERT(reassembler.nof_completed() == 2);
+
+  // Receiving a message again keeps it, while the messages no longer broadcast expire
+  t += std::chrono::seconds(40);
+  TESTASSERT(reassembler.add_segment(0x1112, 0x3010, 0, true, segment, 4, &contents, t) ==
+             result_t::already_received);
+  t += std::chrono::seconds(40);
+  TESTASSERT(reassembler.add_segment(0x1112, 0x3010, 0, true, segment, 4, &contents, t) ==
+             result_t::already_received);
+  TESTASSERT(reassembler.nof_completed() == 1);
+  TESTASSERT(reassembler.add_segment(0x1113, 0x3000, 0, true, segment, 4, &contents, t) == result_t::complete);
+
+  reassembler.reset();
+  TESTASSERT(reassembler.nof_completed() == 0);
+
+  return SRSLTE_SUCCESS;
+}
+
+int main()
+{
+  TESTASSERT(test_reassembly_out_of_order() == SRSLTE_SUCCESS);
+  TESTASSERT(test_reassembly_invalid() == SRSLTE_SUCCESS);
+  TESTASSERT(test_completed_eviction() == SRSLTE_SUCCESS);
+  printf("Success\n");
+  return SRSLTE_SUCCESS;
+}